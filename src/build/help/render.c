@@ -271,7 +271,7 @@ bldHlpRenderHelpAutoCCmp(const BldCfg bldCfg, const BldHlp bldHlp)
     IoRead *const source = ioBufferReadNewOpen(packBuf);
     IoWrite *const destination = ioBufferWriteNew(result);
 
-    ioFilterGroupAdd(ioWriteFilterGroup(destination), bz2CompressNew(9, false));
+    ioFilterGroupAdd(ioWriteFilterGroup(destination), bz2CompressNew(9, false, 0));
     ioWriteOpen(destination);
 
     // Copy data from source to destination
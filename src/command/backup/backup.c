@@ -10,6 +10,7 @@ Backup Command
 
 #include "command/archive/find.h"
 #include "command/backup/backup.h"
+#include "command/backup/blockIndex.h"
 #include "command/backup/common.h"
 #include "command/backup/file.h"
 #include "command/backup/protocol.h"
@@ -20,7 +21,9 @@ Backup Command
 #include "common/compress/helper.h"
 #include "common/crypto/cipherBlock.h"
 #include "common/debug.h"
+#include "common/io/bufferRead.h"
 #include "common/io/filter/size.h"
+#include "common/io/io.h"
 #include "common/log.h"
 #include "common/regExp.h"
 #include "common/time.h"
@@ -35,6 +38,7 @@ Backup Command
 #include "info/manifest.h"
 #include "postgres/interface.h"
 #include "postgres/version.h"
+#include "postgres/walSummary.h"
 #include "protocol/helper.h"
 #include "protocol/parallel.h"
 #include "storage/helper.h"
@@ -265,6 +269,28 @@ backupInit(const InfoBackup *const infoBackup)
         cfgOptionSet(cfgOptChecksumPage, cfgSourceParam, BOOL_FALSE_VAR);
     }
 
+    // Page lsns can only be trusted when hint bit updates are WAL-logged. Otherwise hint bits may be set without updating the page
+    // lsn, so a changed page could appear unchanged.
+    if (cfgOptionTest(cfgOptRepoBlockLsn) && cfgOptionBool(cfgOptRepoBlockLsn) && pgControl.pageChecksumVersion == 0 &&
+        !pgControl.walLogHints)
+    {
+        LOG_WARN_FMT(
+            "%s option requires checksums or wal_log_hints to be enabled on the cluster, resetting to false",
+            cfgOptionIdxName(cfgOptRepoBlockLsn, cfgOptionIdxDefault(cfgOptRepoBlockLsn)));
+        cfgOptionSet(cfgOptRepoBlockLsn, cfgSourceParam, BOOL_FALSE_VAR);
+    }
+
+    // WAL summaries are only available on PostgreSQL >= 17 and the backup start LSN is required to find them
+    if (cfgOptionBool(cfgOptWalSummary) && (!cfgOptionBool(cfgOptOnline) || result->version < PG_VERSION_17))
+    {
+        LOG_WARN(CFGOPT_WAL_SUMMARY " option requires an online backup of " PG_NAME " >= 17, resetting to false");
+        cfgOptionSet(cfgOptWalSummary, cfgSourceParam, BOOL_FALSE_VAR);
+    }
+
+    // Only zst can compress a single file with multiple threads
+    if (cfgOptionUInt(cfgOptCompressThread) > 1 && compressTypeEnum(cfgOptionStrId(cfgOptCompressType)) != compressTypeZst)
+        THROW(OptionInvalidError, CFGOPT_COMPRESS_THREAD " option is only valid when " CFGOPT_COMPRESS_TYPE "=zst");
+
     // Get archive info
     if (cfgOptionBool(cfgOptArchiveCheck))
     {
@@ -583,7 +609,7 @@ backupBuildIncrPrior(const InfoBackup *const infoBackup)
             // If there is a prior backup then check that options for the new backup are compatible
             if (backupLabelPrior != NULL)
             {
-                result = manifestLoadFile(
+                result = manifestLoadFileP(
                     storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabelPrior)),
                     cfgOptionStrId(cfgOptRepoCipherType), infoPgCipherPass(infoBackupPg(infoBackup)));
                 const ManifestData *const manifestPriorData = manifestData(result);
@@ -655,18 +681,95 @@ backupBuildIncrPrior(const InfoBackup *const infoBackup)
     FUNCTION_LOG_RETURN(MANIFEST, result);
 }
 
+/***********************************************************************************************************************************
+Load the WAL summaries that cover the WAL generated between the start of the prior backup and the start of this backup. If the
+summaries do not cover the range then NULL is returned immediately and files are checked as usual, rather than delaying the backup
+while waiting for the WAL summarizer to catch up (it may also be disabled).
+***********************************************************************************************************************************/
+static WalSummary *
+backupWalSummary(
+    const BackupData *const backupData, const Manifest *const manifestPrior, const String *const lsnStart,
+    const String *const archiveStart)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
+        FUNCTION_LOG_PARAM(MANIFEST, manifestPrior);
+        FUNCTION_LOG_PARAM(STRING, lsnStart);
+        FUNCTION_LOG_PARAM(STRING, archiveStart);
+    FUNCTION_LOG_END();
+
+    ASSERT(backupData != NULL);
+    ASSERT(manifestPrior != NULL);
+
+    WalSummary *result = NULL;
+    const ManifestData *const manifestPriorData = manifestData(manifestPrior);
+
+    // Summaries can only be used when delta is disabled and the prior backup was online (so the start lsn is known) and started on
+    // the same timeline
+    if (cfgOptionBool(cfgOptWalSummary) && !cfgOptionBool(cfgOptDelta) && manifestPriorData->lsnStart != NULL &&
+        cvtZSubNToUIntBase(strZ(manifestPriorData->archiveStart), 0, 8, 16) == cvtZSubNToUIntBase(strZ(archiveStart), 0, 8, 16))
+    {
+        ASSERT(lsnStart != NULL);
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const unsigned int timeline = cvtZSubNToUIntBase(strZ(archiveStart), 0, 8, 16);
+            const String *const path = strNewFmt("%s/" PG_PATH_WAL_SUMMARY, strZ(pgWalPath(backupData->version)));
+            const StringList *const fileList = walSummaryFileList(
+                storageListP(backupData->storagePrimary, path, .expression = STRDEF(WAL_SUMMARY_REGEXP)), timeline,
+                pgLsnFromStr(manifestPriorData->lsnStart), pgLsnFromStr(lsnStart));
+
+            if (fileList == NULL)
+            {
+                LOG_WARN_FMT(
+                    "WAL summaries do not cover lsn %s to %s, unable to skip unmodified files\n"
+                    "HINT: is summarize_wal enabled?",
+                    strZ(manifestPriorData->lsnStart), strZ(lsnStart));
+            }
+            else
+            {
+                MEM_CONTEXT_PRIOR_BEGIN()
+                {
+                    result = walSummaryNew(backupData->pageSize);
+                }
+                MEM_CONTEXT_PRIOR_END();
+
+                for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+                {
+                    walSummaryRead(
+                        result,
+                        storageReadIo(
+                            storageNewReadP(
+                                backupData->storagePrimary, strNewFmt("%s/%s", strZ(path), strZ(strLstGet(fileList, fileIdx))))));
+                }
+
+                LOG_DETAIL_FMT(
+                    "loaded %u WAL summaries covering lsn %s to %s", strLstSize(fileList), strZ(manifestPriorData->lsnStart),
+                    strZ(lsnStart));
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(WAL_SUMMARY, result);
+}
+
 static bool
 backupBuildIncr(
-    const InfoBackup *const infoBackup, Manifest *const manifest, Manifest *const manifestPrior, const String *const archiveStart)
+    const InfoBackup *const infoBackup, const BackupData *const backupData, Manifest *const manifest, Manifest *const manifestPrior,
+    const String *const lsnStart, const String *const archiveStart)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
+        FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
         FUNCTION_LOG_PARAM(MANIFEST, manifestPrior);
+        FUNCTION_LOG_PARAM(STRING, lsnStart);
         FUNCTION_LOG_PARAM(STRING, archiveStart);
     FUNCTION_LOG_END();
 
     ASSERT(infoBackup != NULL);
+    ASSERT(backupData != NULL);
     ASSERT(manifest != NULL);
 
     bool result = false;
@@ -679,8 +782,10 @@ backupBuildIncr(
             // Move the manifest to this context so it will be freed when we are done
             manifestMove(manifestPrior, MEM_CONTEXT_TEMP());
 
-            // Build incremental manifest
-            manifestBuildIncr(manifest, manifestPrior, (BackupType)cfgOptionStrId(cfgOptType), archiveStart);
+            // Build incremental manifest using WAL summaries when available
+            manifestBuildIncr(
+                manifest, manifestPrior, (BackupType)cfgOptionStrId(cfgOptType), archiveStart,
+                backupWalSummary(backupData, manifestPrior, lsnStart, archiveStart));
 
             // Set the cipher subpass from prior manifest since we want a single subpass for the entire backup set
             manifestCipherSubPassSet(manifest, manifestCipherSubPass(manifestPrior));
@@ -694,6 +799,241 @@ backupBuildIncr(
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+/***********************************************************************************************************************************
+Get the start lsn of each backup referenced by the manifest. Pages with an lsn before the start lsn of the backup that stored the
+prior map have not changed since the map was written (see BlockIncr). Offline backups do not have a start lsn so they are skipped.
+***********************************************************************************************************************************/
+static KeyValue *
+backupBlockIncrLsn(const InfoBackup *const infoBackup, const Manifest *const manifest)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+    FUNCTION_LOG_END();
+
+    ASSERT(infoBackup != NULL);
+    ASSERT(manifest != NULL);
+
+    KeyValue *const result = kvNew();
+    const StringList *const referenceList = manifestReferenceList(manifest);
+
+    for (unsigned int referenceIdx = 0; referenceIdx < strLstSize(referenceList); referenceIdx++)
+    {
+        const String *const reference = strLstGet(referenceList, referenceIdx);
+
+        if (infoBackupLabelExists(infoBackup, reference))
+        {
+            const String *const lsnStart = infoBackupDataByLabel(infoBackup, reference)->backupLsnStart;
+
+            if (lsnStart != NULL)
+                kvPut(result, VARSTR(reference), VARUINT64(pgLsnFromStr(lsnStart)));
+        }
+    }
+
+    FUNCTION_LOG_RETURN(KEY_VALUE, result);
+}
+
+/***********************************************************************************************************************************
+Manifest journal. Saving the full manifest copy during processing is expensive for large manifests since the entire copy must be
+written each time. Instead, files updated during processing are periodically written to the journal as small, sequentially numbered
+segments that are replayed on top of the manifest copy when the backup is resumed. Each save of the manifest copy makes the journal
+redundant so the segments are removed.
+***********************************************************************************************************************************/
+#define BACKUP_MANIFEST_JOURNAL_FILE                                BACKUP_MANIFEST_FILE ".journal"
+#define BACKUP_MANIFEST_JOURNAL_REGEXP                              "^backup\\.manifest\\.journal\\.[0-9]{8}$"
+
+// List journal segments in the order they were written
+static StringList *
+backupManifestJournalList(const Manifest *const manifest)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+
+    StringList *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        result = strLstSort(
+            storageListP(
+                storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(manifestData(manifest)->backupLabel)),
+                .expression = STRDEF(BACKUP_MANIFEST_JOURNAL_REGEXP)),
+            sortOrderAsc);
+
+        strLstMove(result, memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STRING_LIST, result);
+}
+
+// Write updated files to the next journal segment. Nothing is written when there are no updated files.
+static void
+backupManifestJournalWrite(
+    const Manifest *const manifest, const StringList *const fileList, unsigned int *const segment,
+    const String *const cipherPassBackup)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileList);
+        FUNCTION_LOG_PARAM_P(UINT, segment);
+        FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+    ASSERT(fileList != NULL);
+    ASSERT(segment != NULL);
+
+    if (!strLstEmpty(fileList))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            (*segment)++;
+
+            // Open segment for write
+            IoWrite *const write = storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(),
+                    strNewFmt(
+                        STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_JOURNAL_FILE ".%08u",
+                        strZ(manifestData(manifest)->backupLabel), *segment)));
+
+            // Add encryption filter if required
+            cipherBlockFilterGroupAdd(
+                ioWriteFilterGroup(write), cfgOptionStrId(cfgOptRepoCipherType), cipherModeEncrypt, cipherPassBackup);
+
+            ioWriteOpen(write);
+
+            // Write the fields updated by backupJobResult() for each file
+            PackWrite *const pack = pckWriteNewIo(write);
+
+            for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+            {
+                const ManifestFile file = manifestFileFind(manifest, strLstGet(fileList, fileIdx));
+
+                pckWriteObjBeginP(pack);
+                pckWriteStrP(pack, file.name);
+                pckWriteU64P(pack, file.size);
+                pckWriteU64P(pack, file.sizeRepo);
+                pckWriteBinP(pack, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE));
+                pckWriteBinP(pack, file.checksumRepoSha1 == NULL ? NULL : BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE));
+                pckWriteBoolP(pack, file.checksumPageError);
+                pckWriteStrP(pack, file.checksumPageErrorList);
+                pckWriteBoolP(pack, file.compressNone);
+                pckWriteU64P(pack, file.bundleId);
+                pckWriteU64P(pack, file.bundleOffset);
+                pckWriteU64P(pack, file.blockIncrMapSize);
+                pckWriteObjEndP(pack);
+            }
+
+            pckWriteEndP(pack);
+            ioWriteClose(write);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Replay journal segments in order on top of the manifest copy
+static void
+backupManifestJournalReplay(Manifest *const manifest, const String *const cipherPassBackup)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const backupPath = strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(manifestData(manifest)->backupLabel));
+        const StringList *const segmentList = backupManifestJournalList(manifest);
+
+        for (unsigned int segmentIdx = 0; segmentIdx < strLstSize(segmentList); segmentIdx++)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                // Open segment for read
+                IoRead *const read = storageReadIo(
+                    storageNewReadP(storageRepo(), strNewFmt("%s/%s", strZ(backupPath), strZ(strLstGet(segmentList, segmentIdx)))));
+
+                // Add decryption filter if required
+                cipherBlockFilterGroupAdd(
+                    ioReadFilterGroup(read), cfgOptionStrId(cfgOptRepoCipherType), cipherModeDecrypt, cipherPassBackup);
+
+                ioReadOpen(read);
+
+                // Update files in the manifest
+                PackRead *const pack = pckReadNewIo(read);
+
+                MEM_CONTEXT_TEMP_RESET_BEGIN()
+                {
+                    while (!pckReadNullP(pack))
+                    {
+                        pckReadObjBeginP(pack);
+
+                        ManifestFile file = manifestFileFind(manifest, pckReadStrP(pack));
+                        file.size = pckReadU64P(pack);
+                        file.sizeRepo = pckReadU64P(pack);
+                        file.checksumSha1 = bufPtrConst(pckReadBinP(pack));
+
+                        const Buffer *const checksumRepoSha1 = pckReadBinP(pack);
+
+                        file.checksumRepoSha1 = checksumRepoSha1 == NULL ? NULL : bufPtrConst(checksumRepoSha1);
+                        file.reference = NULL;
+                        file.checksumPageError = pckReadBoolP(pack);
+                        file.checksumPageErrorList = pckReadStrP(pack);
+                        file.compressNone = pckReadBoolP(pack);
+                        file.bundleId = pckReadU64P(pack);
+                        file.bundleOffset = pckReadU64P(pack);
+                        file.blockIncrMapSize = pckReadU64P(pack);
+
+                        pckReadObjEndP(pack);
+                        manifestFileUpdate(manifest, &file);
+
+                        // Reset the memory context occasionally so file data does not accumulate
+                        MEM_CONTEXT_TEMP_RESET(1000);
+                    }
+                }
+                MEM_CONTEXT_TEMP_END();
+
+                pckReadEndP(pack);
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Remove journal segments
+static void
+backupManifestJournalRemove(const Manifest *const manifest)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const backupPath = strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(manifestData(manifest)->backupLabel));
+        const StringList *const segmentList = backupManifestJournalList(manifest);
+
+        for (unsigned int segmentIdx = 0; segmentIdx < strLstSize(segmentList); segmentIdx++)
+            storageRemoveP(storageRepoWrite(), strNewFmt("%s/%s", strZ(backupPath), strZ(strLstGet(segmentList, segmentIdx))));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Check for a backup that can be resumed and merge into the manifest if found
 ***********************************************************************************************************************************/
@@ -724,10 +1064,14 @@ backupResumeClean(
         {
             const StorageInfo info = storageItrNext(storageItr);
 
-            // Skip backup.manifest.copy -- it must be preserved to allow resume again if this process throws an error before
-            // writing the manifest for the first time
-            if (manifestParentName == NULL && strEqZ(info.name, BACKUP_MANIFEST_FILE INFO_COPY_EXT))
+            // Skip backup.manifest.copy and the journal -- they must be preserved to allow resume again if this process throws an
+            // error before writing the manifest for the first time
+            if (manifestParentName == NULL &&
+                (strEqZ(info.name, BACKUP_MANIFEST_FILE INFO_COPY_EXT) ||
+                 strBeginsWithZ(info.name, BACKUP_MANIFEST_JOURNAL_FILE ".")))
+            {
                 continue;
+            }
 
             // Build the name used to lookup files in the manifest
             const String *manifestName =
@@ -913,7 +1257,7 @@ backupResumeFind(const Manifest *const manifest, const String *const cipherPassB
                         {
                             TRY_BEGIN()
                             {
-                                manifestResume = manifestLoadFile(
+                                manifestResume = manifestLoadFileP(
                                     storageRepo(), manifestFile, cfgOptionStrId(cfgOptRepoCipherType), cipherPassBackup);
                             }
                             CATCH_ANY()
@@ -922,6 +1266,21 @@ backupResumeFind(const Manifest *const manifest, const String *const cipherPassB
                             }
                             TRY_END();
 
+                            // Replay the journal to recover files completed after the manifest copy was saved
+                            if (manifestResume != NULL)
+                            {
+                                TRY_BEGIN()
+                                {
+                                    backupManifestJournalReplay(manifestResume, cipherPassBackup);
+                                }
+                                CATCH_ANY()
+                                {
+                                    reason = strNewFmt("unable to replay %s journal", strZ(manifestFile));
+                                    manifestResume = NULL;
+                                }
+                                TRY_END();
+                            }
+
                             if (manifestResume != NULL)
                             {
                                 const ManifestData *manifestResumeData = manifestData(manifestResume);
@@ -1139,6 +1498,273 @@ backupStart(const BackupData *const backupData)
     FUNCTION_LOG_RETURN_STRUCT(result);
 }
 
+/***********************************************************************************************************************************
+List database paths in parallel before the manifest is built. Database paths contain nearly all the files in a cluster so listing
+them is most of the cost of the build, especially when there are millions of relations or the storage is on the network. The
+manifest build uses these lists instead of iterating the paths itself so the manifest is identical to a sequential build.
+
+Each result is limited to the buffer the local allocates for it (buffer-size) so a local does not need to buffer the listing of a
+large path in a single result. An entry in a database path packs to less than BACKUP_BUILD_PATH_ENTRY_SIZE bytes (a short numeric
+name, the owner, and fixed-size fields) so the size is converted to a limit on entries that the local can apply before it gets
+detail for an entry.
+
+The local lists the names in a path once and keeps them until the path is complete, so a path with more entries than fit in a result
+must be continued on the same local. Since the next job for a local is requested before the prior result has been processed, a local
+that is listing a path is always asked to continue it. The local returns an empty result if the path was already complete.
+***********************************************************************************************************************************/
+#define BACKUP_BUILD_PATH_ENTRY_SIZE                                64
+#define BACKUP_BUILD_PATH_RESULT_MAX                                ((unsigned int)(ioBufferSize() / BACKUP_BUILD_PATH_ENTRY_SIZE))
+
+// Client is not listing a path
+#define BACKUP_BUILD_PATH_CLIENT_NONE                               UINT_MAX
+
+typedef struct BackupBuildPathJob
+{
+    const String *path;                                             // Path to list
+    StorageList *list;                                              // Path contents
+} BackupBuildPathJob;
+
+typedef struct BackupBuildPathJobData
+{
+    const List *jobList;                                            // Paths to list
+    unsigned int jobIdx;                                            // Next path to list
+    unsigned int *clientJobIdx;                                     // Path each client is listing
+    unsigned int resultMax;                                         // Maximum entries in each result
+} BackupBuildPathJobData;
+
+static ProtocolParallelJob *
+backupBuildPathJobCallback(void *const data, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    ProtocolParallelJob *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Continue the path the client is listing or else start listing the next path
+        BackupBuildPathJobData *const jobData = data;
+        unsigned int jobIdx = jobData->clientJobIdx[clientIdx];
+        const bool next = jobIdx != BACKUP_BUILD_PATH_CLIENT_NONE;
+
+        if (!next && jobData->jobIdx < lstSize(jobData->jobList))
+        {
+            jobIdx = jobData->jobIdx;
+            jobData->clientJobIdx[clientIdx] = jobIdx;
+            jobData->jobIdx++;
+        }
+
+        if (jobIdx != BACKUP_BUILD_PATH_CLIENT_NONE)
+        {
+            const BackupBuildPathJob *const job = lstGet(jobData->jobList, jobIdx);
+
+            PackWrite *const param = protocolPackNew();
+
+            pckWriteStrP(param, job->path);
+            pckWriteBoolP(param, next);
+            pckWriteU32P(param, jobData->resultMax);
+
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = protocolParallelJobNew(VARUINT(jobIdx), PROTOCOL_COMMAND_BACKUP_PATH_LIST, param);
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
+}
+
+static List *
+backupBuildPathList(
+    const BackupData *const backupData, const unsigned int pgVersion, const unsigned int pgCatalogVersion,
+    const unsigned int resultMax)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
+        FUNCTION_LOG_PARAM(UINT, pgVersion);
+        FUNCTION_LOG_PARAM(UINT, pgCatalogVersion);
+        FUNCTION_LOG_PARAM(UINT, resultMax);
+    FUNCTION_LOG_END();
+
+    ASSERT(backupData != NULL);
+    ASSERT(resultMax > 0);
+
+    List *result = NULL;
+
+    // The manifest is built from the primary so the paths can only be listed in parallel when all processes run on the primary,
+    // i.e. not when backing up from a standby
+    if (cfgOptionUInt(cfgOptProcessMax) > 1 && backupData->storageStandby == NULL)
+    {
+        result = lstNewP(sizeof(ManifestBuildPath), .comparator = lstComparatorStr);
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Find the database paths in the base path and in each tablespace. Links and paths that the manifest build will reject
+            // are skipped here so the build can report the error.
+            const Storage *const storagePg = backupData->storagePrimary;
+            const String *const tablespaceId = pgTablespaceId(pgVersion, pgCatalogVersion);
+            StringList *const dbParentList = strLstNew();
+            StringList *const pathList = strLstNew();
+
+            strLstAddZ(dbParentList, PG_PATH_BASE);
+            strLstAddZ(pathList, PG_PATH_GLOBAL);
+
+            StorageIterator *const tablespaceItr = storageNewItrP(storagePg, STRDEF(PG_PATH_PGTBLSPC), .sortOrder = sortOrderAsc);
+
+            while (storageItrMore(tablespaceItr))
+            {
+                const StorageInfo info = storageItrNext(tablespaceItr);
+
+                if (info.type == storageTypeLink)
+                {
+                    const String *const linkPath = strNewFmt(PG_PATH_PGTBLSPC "/%s", strZ(info.name));
+                    const StorageInfo linkInfo = storageInfoP(storagePg, linkPath, .followLink = true, .ignoreMissing = true);
+
+                    if (linkInfo.exists && linkInfo.type == storageTypePath)
+                        strLstAddFmt(dbParentList, "%s/%s", strZ(linkPath), strZ(tablespaceId));
+                }
+            }
+
+            for (unsigned int dbParentIdx = 0; dbParentIdx < strLstSize(dbParentList); dbParentIdx++)
+            {
+                const String *const dbParent = strLstGet(dbParentList, dbParentIdx);
+                StorageIterator *const dbItr = storageNewItrP(storagePg, dbParent, .sortOrder = sortOrderAsc);
+
+                while (storageItrMore(dbItr))
+                {
+                    const StorageInfo info = storageItrNext(dbItr);
+
+                    if (info.type == storageTypePath)
+                        strLstAddFmt(pathList, "%s/%s", strZ(dbParent), strZ(info.name));
+                }
+            }
+
+            // Create a list for each path to hold its contents
+            List *const jobList = lstNewP(sizeof(BackupBuildPathJob));
+
+            for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+            {
+                const String *const path = strLstGet(pathList, pathIdx);
+
+                MEM_CONTEXT_OBJ_BEGIN(result)
+                {
+                    const ManifestBuildPath buildPath =
+                    {
+                        .path = storagePathP(storagePg, path),
+                        .list = storageLstNew(storageInfoLevelDetail),
+                    };
+
+                    lstAdd(result, &buildPath);
+                    lstAdd(jobList, &(BackupBuildPathJob){.path = path, .list = buildPath.list});
+                }
+                MEM_CONTEXT_OBJ_END();
+            }
+
+            // List the database paths in parallel
+            const unsigned int processMax = cfgOptionUInt(cfgOptProcessMax);
+            BackupBuildPathJobData jobData =
+            {
+                .jobList = jobList,
+                .clientJobIdx = memNew(processMax * sizeof(unsigned int)),
+                .resultMax = resultMax,
+            };
+
+            for (unsigned int clientIdx = 0; clientIdx < processMax; clientIdx++)
+                jobData.clientJobIdx[clientIdx] = BACKUP_BUILD_PATH_CLIENT_NONE;
+
+            ProtocolParallel *const parallelExec = protocolParallelNew(
+                cfgOptionUInt64(cfgOptProtocolTimeout) / 2, backupBuildPathJobCallback, &jobData);
+
+            for (unsigned int processIdx = 1; processIdx <= processMax; processIdx++)
+            {
+                protocolParallelClientAdd(
+                    parallelExec, protocolLocalGet(protocolStorageTypePg, backupData->pgIdxPrimary, processIdx));
+            }
+
+            do
+            {
+                const unsigned int completed = protocolParallelProcess(parallelExec);
+
+                for (unsigned int completedIdx = 0; completedIdx < completed; completedIdx++)
+                {
+                    ProtocolParallelJob *const parallelJob = protocolParallelResult(parallelExec);
+
+                    // Error if the path could not be listed
+                    if (protocolParallelJobErrorCode(parallelJob) != 0)
+                    {
+                        THROW_CODE(
+                            protocolParallelJobErrorCode(parallelJob), strZ(protocolParallelJobErrorMessage(parallelJob)));
+                    }
+
+                    // Append the result to the path contents. Results are sorted the same way as the storage iterator and each
+                    // result continues after the prior result so the contents remain sorted.
+                    const unsigned int jobIdx = varUInt(protocolParallelJobKey(parallelJob));
+                    const BackupBuildPathJob *const job = lstGet(jobList, jobIdx);
+                    PackRead *const jobResult = protocolParallelJobResult(parallelJob);
+
+                    pckReadArrayBeginP(jobResult);
+
+                    MEM_CONTEXT_TEMP_RESET_BEGIN()
+                    {
+                        while (pckReadNext(jobResult))
+                        {
+                            pckReadObjBeginP(jobResult);
+
+                            StorageInfo info = {.exists = true, .level = storageInfoLevelDetail};
+
+                            info.name = pckReadStrP(jobResult);
+                            info.type = (StorageType)pckReadU32P(jobResult);
+                            info.timeModified = pckReadTimeP(jobResult);
+                            info.size = pckReadU64P(jobResult);
+                            info.mode = pckReadModeP(jobResult);
+                            info.userId = pckReadU32P(jobResult);
+                            info.user = pckReadStrP(jobResult);
+                            info.groupId = pckReadU32P(jobResult);
+                            info.group = pckReadStrP(jobResult);
+                            info.linkDestination = pckReadStrP(jobResult);
+
+                            storageLstAdd(job->list, &info);
+                            pckReadObjEndP(jobResult);
+
+                            // Reset the memory context occasionally so we don't use too much memory or slow down processing
+                            MEM_CONTEXT_TEMP_RESET(1000);
+                        }
+                    }
+                    MEM_CONTEXT_TEMP_END();
+
+                    pckReadArrayEndP(jobResult);
+
+                    // If the path is complete then the client can start listing another path. The client may already be listing
+                    // another path if it was asked to continue this path before the result was processed.
+                    if (!pckReadBoolP(jobResult))
+                    {
+                        const unsigned int clientIdx = protocolParallelJobProcessId(parallelJob) - 1;
+
+                        if (jobData.clientJobIdx[clientIdx] == jobIdx)
+                            jobData.clientJobIdx[clientIdx] = BACKUP_BUILD_PATH_CLIENT_NONE;
+                    }
+
+                    protocolParallelJobFree(parallelJob);
+                }
+            }
+            while (!protocolParallelDone(parallelExec));
+
+            protocolParallelFree(parallelExec);
+
+            lstSort(result, sortOrderAsc);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
 /***********************************************************************************************************************************
 Stop the backup
 ***********************************************************************************************************************************/
@@ -1393,14 +2019,16 @@ Log the results of a job and throw errors
 static void
 backupJobResult(
     Manifest *const manifest, const String *const host, const Storage *const storagePg, StringList *const fileRemove,
-    ProtocolParallelJob *const job, const bool bundle, const PgPageSize pageSize, const uint64_t sizeTotal,
-    uint64_t *const sizeProgress, unsigned int *const currentPercentComplete)
+    StringList *const journal, BlockIndex *const blockIndex, ProtocolParallelJob *const job, const bool bundle,
+    const PgPageSize pageSize, const uint64_t sizeTotal, uint64_t *const sizeProgress, unsigned int *const currentPercentComplete)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
         FUNCTION_LOG_PARAM(STRING, host);
         FUNCTION_LOG_PARAM(STORAGE, storagePg);
         FUNCTION_LOG_PARAM(STRING_LIST, fileRemove);
+        FUNCTION_LOG_PARAM(STRING_LIST, journal);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, blockIndex);
         FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL_JOB, job);
         FUNCTION_LOG_PARAM(BOOL, bundle);
         FUNCTION_LOG_PARAM(ENUM, pageSize);
@@ -1434,9 +2062,11 @@ backupJobResult(
                 const uint64_t bundleOffset = pckReadU64P(jobResult);
                 const uint64_t blockIncrMapSize = pckReadU64P(jobResult);
                 const uint64_t repoSize = pckReadU64P(jobResult);
+                const bool compressNone = pckReadBoolP(jobResult);
                 const Buffer *const copyChecksum = pckReadBinP(jobResult);
                 const Buffer *const repoChecksum = pckReadBinP(jobResult);
                 PackRead *const checksumPageResult = pckReadPackReadP(jobResult);
+                const Buffer *const blockIncrIndex = pckReadBinP(jobResult);
 
                 // Increment backup copy progress. Use the original size since the size may have changed during the copy but for the
                 // purpose of reporting progress we need to increment by the original size used to generate the total size.
@@ -1587,12 +2217,26 @@ backupJobResult(
                     file.checksumPageError = checksumPageError;
                     file.checksumPageErrorList =
                         checksumPageErrorList != NULL ? jsonFromVar(varNewVarLst(checksumPageErrorList)) : NULL;
+                    file.compressNone = compressNone;
                     // Truncated file is not put in bundle
                     file.bundleId = copyResult != backupCopyResultTruncate ? bundleId : 0;
                     file.bundleOffset = bundleOffset;
                     file.blockIncrMapSize = blockIncrMapSize;
 
                     manifestFileUpdate(manifest, &file);
+
+                    // Add the file to the journal so the update is preserved for resume
+                    if (journal != NULL)
+                        strLstAdd(journal, file.name);
+
+                    // Add new blocks stored by the current backup to the block index
+                    if (blockIncrIndex != NULL)
+                    {
+                        ASSERT(blockIndex != NULL);
+
+                        blockIndexRead(
+                            blockIndex, ioBufferReadNewOpen(blockIncrIndex), strLstSize(manifestReferenceList(manifest)) - 1);
+                    }
                 }
             }
 
@@ -1618,8 +2262,9 @@ backupJobResult(
 }
 
 /***********************************************************************************************************************************
-Save a copy of the backup manifest during processing to preserve checksums for a possible resume. Only save the final copy when
-resume is disabled since an incremental copy will not be used in a future backup unless resume is enabled beforehand.
+Save a copy of the backup manifest to preserve checksums for a possible resume. Only save the final copy when resume is disabled
+since an incremental copy will not be used in a future backup unless resume is enabled beforehand. The journal is removed once the
+copy has been saved since the copy contains all the updates in the journal.
 ***********************************************************************************************************************************/
 static void
 backupManifestSaveCopy(Manifest *const manifest, const String *const cipherPassBackup, const bool final)
@@ -1651,6 +2296,10 @@ backupManifestSaveCopy(Manifest *const manifest, const String *const cipherPassB
             manifestSave(manifest, write);
         }
         MEM_CONTEXT_TEMP_END();
+
+        // Remove the journal when resume is enabled since it may have been written during processing
+        if (cfgOptionBool(cfgOptResume))
+            backupManifestJournalRemove(manifest);
     }
 
     FUNCTION_LOG_RETURN_VOID();
@@ -1694,6 +2343,8 @@ typedef struct BackupJobData
     const PgPageSize pageSize;                                      // Page size
     const CompressType compressType;                                // Backup compression type
     const int compressLevel;                                        // Compress level if backup is compressed
+    const unsigned int compressThread;                              // Threads used to compress a single file
+    const bool compressAdaptive;                                    // Store incompressible files without compression?
     const bool delta;                                               // Is this a checksum delta backup?
     const bool bundle;                                              // Bundle files?
     uint64_t bundleSize;                                            // Target bundle size
@@ -1701,10 +2352,179 @@ typedef struct BackupJobData
     uint64_t bundleId;                                              // Bundle id
     const bool blockIncr;                                           // Block incremental?
     size_t blockIncrSizeSuper;                                      // Super block size
+    bool blockIncrCdc;                                              // Content-defined chunking?
+    BlockIndex *blockIndex;                                         // Blocks stored by the current backup (NULL if disabled)
+    const String *blockIndexPath;                                   // Path where block index map files are written
+    StringList *blockIndexFileList;                                 // Block index map files used by local processes
+    List *blockIndexRunList;                                        // Map files with blocks stored by the current backup
+    unsigned int blockIndexFileNo;                                  // Last block index map file no
+    RegExp *blockIncrLsnExp;                                        // Identify files with page lsns (NULL if lsn check disabled)
+    KeyValue *blockIncrLsnKv;                                       // Start lsn of each referenced backup
 
     List *queueList;                                                // List of processing queues
 } BackupJobData;
 
+/***********************************************************************************************************************************
+Share the block index with local processes
+
+Local processes map the block index from files written by the main process (see BlockIndex) so the index is stored once no matter
+how many processes are running. Blocks stored by the current backup are written to a new file each time a job is created. To keep
+the number of files small a new file is merged with prior files that have no more blocks than it does, so each block is written to a
+file a number of times that is logarithmic in the number of blocks stored.
+***********************************************************************************************************************************/
+typedef struct BackupBlockIndexRun
+{
+    String *file;                                                   // Map file
+    unsigned int itemTotal;                                         // Items in the file
+} BackupBlockIndexRun;
+
+// Write items to a map file
+static void
+backupBlockIndexMapWrite(BackupJobData *const jobData, const BlockIndex *const blockIndex, const String *const file)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, blockIndex);
+        FUNCTION_LOG_PARAM(STRING, file);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(blockIndex != NULL);
+    ASSERT(file != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StorageWrite *const write = storageNewWriteP(storageLocalWrite(), file);
+
+        ioWriteOpen(storageWriteIo(write));
+        blockIndexMapWrite(blockIndex, storageWriteIo(write));
+        ioWriteClose(storageWriteIo(write));
+
+        strLstAdd(jobData->blockIndexFileList, file);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Load the block index from the backups referenced by the current backup and write it to a map file
+static void
+backupBlockIndexPrior(BackupJobData *const jobData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const StringList *const referenceList = manifestReferenceList(jobData->manifest);
+        BlockIndex *const blockIndex = blockIndexNew();
+
+        // Read the index from each backup that has one. The current backup is always last and will not have an index yet.
+        for (unsigned int referenceIdx = 0; referenceIdx < strLstSize(referenceList) - 1; referenceIdx++)
+        {
+            StorageRead *const read = storageNewReadP(
+                storageRepo(),
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/" BLOCK_INDEX_FILE, strZ(strLstGet(referenceList, referenceIdx))),
+                .ignoreMissing = true);
+
+            if (jobData->cipherType != cipherTypeNone)
+            {
+                ioFilterGroupAdd(
+                    ioReadFilterGroup(storageReadIo(read)),
+                    cipherBlockNewP(cipherModeDecrypt, jobData->cipherType, BUFSTR(jobData->cipherSubPass)));
+            }
+
+            if (ioReadOpen(storageReadIo(read)))
+            {
+                blockIndexRead(blockIndex, storageReadIo(read), referenceIdx);
+                ioReadClose(storageReadIo(read));
+            }
+        }
+
+        // Write the map file
+        if (blockIndexSize(blockIndex) > 0)
+        {
+            blockIndexSort(blockIndex);
+            backupBlockIndexMapWrite(jobData, blockIndex, strNewFmt("%s/prior", strZ(jobData->blockIndexPath)));
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Write blocks stored by the current backup since the last call to a map file
+static void
+backupBlockIndexPublish(BackupJobData *const jobData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(jobData->blockIndex != NULL);
+
+    // Get the items that have not been written
+    unsigned int itemBegin = 0;
+
+    for (unsigned int runIdx = 0; runIdx < lstSize(jobData->blockIndexRunList); runIdx++)
+        itemBegin += ((const BackupBlockIndexRun *)lstGet(jobData->blockIndexRunList, runIdx))->itemTotal;
+
+    if (blockIndexSize(jobData->blockIndex) > itemBegin)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Merge with prior runs that are not larger
+            StringList *const fileRemoveList = strLstNew();
+
+            while (!lstEmpty(jobData->blockIndexRunList))
+            {
+                const BackupBlockIndexRun *const run = lstGet(jobData->blockIndexRunList, lstSize(jobData->blockIndexRunList) - 1);
+
+                if (run->itemTotal > blockIndexSize(jobData->blockIndex) - itemBegin)
+                    break;
+
+                itemBegin -= run->itemTotal;
+                strLstAdd(fileRemoveList, run->file);
+                strLstRemove(jobData->blockIndexFileList, run->file);
+                strFree(run->file);
+                lstRemoveLast(jobData->blockIndexRunList);
+            }
+
+            // Write the run
+            BlockIndex *const blockIndex = blockIndexNew();
+
+            for (unsigned int itemIdx = itemBegin; itemIdx < blockIndexSize(jobData->blockIndex); itemIdx++)
+                blockIndexAdd(blockIndex, blockIndexGet(jobData->blockIndex, itemIdx));
+
+            blockIndexSort(blockIndex);
+
+            MEM_CONTEXT_OBJ_BEGIN(jobData->blockIndexRunList)
+            {
+                const BackupBlockIndexRun run =
+                {
+                    .file = strNewFmt("%s/%u", strZ(jobData->blockIndexPath), ++jobData->blockIndexFileNo),
+                    .itemTotal = blockIndexSize(jobData->blockIndex) - itemBegin,
+                };
+
+                backupBlockIndexMapWrite(jobData, blockIndex, run.file);
+                lstAdd(jobData->blockIndexRunList, &run);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            // Remove merged files. Local processes that still have them mapped are not affected.
+            for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileRemoveList); fileIdx++)
+                storageRemoveP(storageLocalWrite(), strLstGet(fileRemoveList, fileIdx), .errorOnMissing = true);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 // Identify files that must be copied from the primary
 static bool
 backupProcessFilePrimary(RegExp *const standbyExp, const String *const name)
@@ -1737,9 +2557,11 @@ backupProcessQueueComparator(const void *const item1, const void *const item2)
     ASSERT(item1 != NULL);
     ASSERT(item2 != NULL);
 
-    // Unpack files
-    const ManifestFile file1 = manifestFileUnpack(backupProcessQueueComparatorManifest, *(const ManifestFilePack *const *)item1);
-    const ManifestFile file2 = manifestFileUnpack(backupProcessQueueComparatorManifest, *(const ManifestFilePack *const *)item2);
+    // Unpack files (names are compared in packed format)
+    const ManifestFilePack *const filePack1 = *(const ManifestFilePack *const *)item1;
+    const ManifestFilePack *const filePack2 = *(const ManifestFilePack *const *)item2;
+    const ManifestFile file1 = manifestFileUnpackP(backupProcessQueueComparatorManifest, filePack1, .noName = true);
+    const ManifestFile file2 = manifestFileUnpackP(backupProcessQueueComparatorManifest, filePack2, .noName = true);
 
     // If the size differs then that's enough to determine order
     if (!backupProcessQueueComparatorBundle || file1.size > backupProcessQueueComparatorBundleLimit ||
@@ -1761,7 +2583,7 @@ backupProcessQueueComparator(const void *const item1, const void *const item2)
     }
 
     // If size/time is the same then use name to generate a deterministic ordering (names must be unique)
-    FUNCTION_TEST_RETURN(INT, strCmp(file1.name, file2.name));
+    FUNCTION_TEST_RETURN(INT, manifestFilePackNameCmp(filePack1, filePack2));
 }
 
 // Helper to generate the backup queues
@@ -1816,8 +2638,9 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
 
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
         {
+            // Get the name separately since it is borrowed from the manifest and this context cannot be reset
             const ManifestFilePack *const filePack = manifestFilePackGet(manifest, fileIdx);
-            const ManifestFile file = manifestFileUnpack(manifest, filePack);
+            const ManifestFile file = manifestFileUnpackP(manifest, filePack, .noName = true);
 
             // Only process files that need to be copied
             if (!file.copy)
@@ -1826,18 +2649,21 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
                 if (file.size == 0 && jobData->bundle)
                 {
                     LOG_DETAIL_FMT(
-                        "store zero-length file %s", strZ(storagePathP(backupData->storagePrimary, manifestPathPg(file.name))));
+                        "store zero-length file %s",
+                        strZ(storagePathP(backupData->storagePrimary, manifestPathPg(manifestFileNameGet(manifest, fileIdx)))));
                 }
 
                 continue;
             }
 
+            const String *const fileName = manifestFileNameGet(manifest, fileIdx);
+
             // Is pg_control in the backup?
-            if (strEq(file.name, STRDEF(MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL)))
+            if (strEq(fileName, STRDEF(MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL)))
                 pgControlFound = true;
 
             // Files that must be copied from the primary are always put in queue 0 when backup from standby
-            if (jobData->backupStandby && backupProcessFilePrimary(jobData->standbyExp, file.name))
+            if (jobData->backupStandby && backupProcessFilePrimary(jobData->standbyExp, fileName))
             {
                 lstAdd(*(List **)lstGet(jobData->queueList, 0), &filePack);
             }
@@ -1851,7 +2677,7 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
                 {
                     CHECK(AssertError, targetIdx < strLstSize(targetList), "backup target not found");
 
-                    if (strBeginsWith(file.name, strLstGet(targetList, targetIdx)))
+                    if (strBeginsWith(fileName, strLstGet(targetList, targetIdx)))
                         break;
 
                     targetIdx++;
@@ -1960,15 +2786,19 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 
             while (fileIdx < lstSize(queue))
             {
-                const ManifestFile file = manifestFileUnpack(jobData->manifest, *(ManifestFilePack **)lstGet(queue, fileIdx));
+                const ManifestFilePack *const filePack = *(ManifestFilePack **)lstGet(queue, fileIdx);
 
-                // Continue if the next file would make the bundle too large. There may be a smaller one that will fit.
-                if (fileTotal > 0 && fileSize + file.size >= jobData->bundleSize)
+                // Continue if the next file would make the bundle too large. There may be a smaller one that will fit. The name is
+                // not needed for this check so skip building it.
+                if (fileTotal > 0 &&
+                    fileSize + manifestFileUnpackP(jobData->manifest, filePack, .noName = true).size >= jobData->bundleSize)
                 {
                     fileIdx++;
                     continue;
                 }
 
+                const ManifestFile file = manifestFileUnpackP(jobData->manifest, filePack);
+
                 // Is this file a block incremental?
                 const bool blockIncr = jobData->blockIncr && file.blockIncrSize > 0;
 
@@ -2003,10 +2833,21 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 
                     pckWriteU32P(param, jobData->compressType);
                     pckWriteI32P(param, jobData->compressLevel);
+                    pckWriteU32P(param, jobData->compressThread);
+
+                    // Adaptive compression is only used for bundled files since the name of a non-bundled repo file includes
+                    // the compression extension
+                    pckWriteBoolP(param, jobData->compressAdaptive && bundle);
                     pckWriteU64P(param, jobData->cipherSubPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc);
                     pckWriteStrP(param, jobData->cipherSubPass);
                     pckWriteU32P(param, jobData->pageSize);
                     pckWriteStrP(param, cfgOptionStrNull(cfgOptPgVersionForce));
+
+                    // Share blocks stored since the last job
+                    if (jobData->blockIndex != NULL)
+                        backupBlockIndexPublish(jobData);
+
+                    pckWriteStrLstP(param, jobData->blockIndexFileList);
                 }
 
                 pckWriteStrP(param, manifestPathPg(file.name));
@@ -2025,6 +2866,7 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
                     pckWriteU64P(param, file.blockIncrSize);
                     pckWriteU64P(param, file.blockIncrChecksumSize);
                     pckWriteU64P(param, jobData->blockIncrSizeSuper);
+                    pckWriteBoolP(param, jobData->blockIncrCdc);
 
                     if (file.blockIncrMapSize != 0 && !file.resume)
                     {
@@ -2034,6 +2876,13 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
                                 file.reference, .manifestName = file.name, .bundleId = file.bundleId, .blockIncr = true));
                         pckWriteU64P(param, file.bundleOffset + file.sizeRepo - file.blockIncrMapSize);
                         pckWriteU64P(param, file.blockIncrMapSize);
+
+                        // Provide the start lsn of the backup that stored the prior map so unchanged pages can be detected
+                        const Variant *const lsn =
+                            jobData->blockIncrLsnExp != NULL && regExpMatch(jobData->blockIncrLsnExp, file.name) ?
+                                kvGet(jobData->blockIncrLsnKv, VARSTR(file.reference)) : NULL;
+
+                        pckWriteU64P(param, lsn != NULL ? varUInt64(lsn) : 0);
                     }
                     else
                         pckWriteNullP(param);
@@ -2086,10 +2935,13 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 }
 
 static void
-backupProcess(const BackupData *const backupData, Manifest *const manifest, const String *const cipherPassBackup)
+backupProcess(
+    const BackupData *const backupData, const InfoBackup *const infoBackup, Manifest *const manifest,
+    const String *const cipherPassBackup)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
         FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
     FUNCTION_LOG_END();
@@ -2114,6 +2966,9 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
             .backupStandby = backupData->dbStandby != NULL,
             .compressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType)),
             .compressLevel = cfgOptionInt(cfgOptCompressLevel),
+            .compressThread = cfgOptionUInt(cfgOptCompressThread),
+            .compressAdaptive =
+                cfgOptionBool(cfgOptCompressAdaptive) && compressTypeEnum(cfgOptionStrId(cfgOptCompressType)) != compressTypeNone,
             .cipherType = cfgOptionStrId(cfgOptRepoCipherType),
             .cipherSubPass = manifestCipherSubPass(manifest),
             .pageSize = backupData->pageSize,
@@ -2142,6 +2997,36 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
             jobData.blockIncrSizeSuper =
                 backupType == backupTypeFull ?
                     (size_t)cfgOptionUInt64(cfgOptRepoBlockSizeSuperFull) : (size_t)cfgOptionUInt64(cfgOptRepoBlockSizeSuper);
+            jobData.blockIncrCdc = cfgOptionBool(cfgOptRepoBlockCdc);
+
+            // Blocks are indexed by bundle id. Block incremental depends on bundling so it is always enabled here.
+            if (cfgOptionBool(cfgOptRepoBlockDedup))
+            {
+                ASSERT(jobData.bundle);
+
+                jobData.blockIndex = blockIndexNew();
+                jobData.blockIndexPath = strNewFmt(
+                    "%s/%s-backup-block", strZ(cfgOptionStr(cfgOptLockPath)), strZ(cfgOptionStr(cfgOptStanza)));
+                jobData.blockIndexFileList = strLstNew();
+                jobData.blockIndexRunList = lstNewP(sizeof(BackupBlockIndexRun));
+
+                // Remove map files left by a prior backup that did not complete
+                storagePathRemoveP(storageLocalWrite(), jobData.blockIndexPath, .recurse = true);
+
+                backupBlockIndexPrior(&jobData);
+            }
+
+            // Prior maps are only available for diff/incr backups. Page lsns are only checked in the main fork of relation files.
+            // The free space map is not WAL-logged and visibilitymap_clear() clears bits without updating the page lsn, so a
+            // changed visibility map page may have an lsn before the prior backup.
+            if (cfgOptionBool(cfgOptRepoBlockLsn) && backupType != backupTypeFull)
+            {
+                jobData.blockIncrLsnExp = regExpNew(
+                    STRDEF(
+                        "^(" MANIFEST_TARGET_PGDATA "/(" PG_PATH_BASE "/[0-9]+|" PG_PATH_GLOBAL ")|" MANIFEST_TARGET_PGTBLSPC
+                        "/[0-9]+/[^/]+/[0-9]+)/[0-9]+(\\.[0-9]+){0,1}$"));
+                jobData.blockIncrLsnKv = backupBlockIncrLsn(infoBackup, manifest);
+            }
         }
 
         // If this is a full backup or hard-linked and paths are supported then create all paths explicitly so that empty paths will
@@ -2202,7 +3087,15 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         // Maintain a list of files that need to be removed from the manifest when the backup is complete
         StringList *const fileRemove = strLstNew();
 
-        // Determine how often the manifest will be saved (every one percent or threshold size, whichever is greater)
+        // Maintain a list of files updated since the last journal write when resume is enabled. The journal of a resumed backup was
+        // replayed into the manifest and removed when the manifest copy was saved before processing, so segments are numbered from
+        // the start again. A segment left behind would be replayed out of order with the new segments.
+        StringList *journal = cfgOptionBool(cfgOptResume) ? strLstNew() : NULL;
+        unsigned int journalSegment = 0;
+
+        ASSERT(journal == NULL || strLstEmpty(backupManifestJournalList(manifest)));
+
+        // Determine how often the journal will be saved (every one percent or threshold size, whichever is greater)
         uint64_t manifestSaveLast = 0;
         uint64_t manifestSaveSize = sizeTotal / 100;
 
@@ -2232,7 +3125,8 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
                         manifest,
                         backupStandby && protocolParallelJobProcessId(job) > 1 ? backupData->hostStandby : backupData->hostPrimary,
                         protocolParallelJobProcessId(job) > 1 ? storagePgIdx(pgIdx) : backupData->storagePrimary,
-                        fileRemove, job, jobData.bundle, jobData.pageSize, sizeTotal, &sizeProgress, &currentPercentComplete);
+                        fileRemove, journal, jobData.blockIndex, job, jobData.bundle, jobData.pageSize, sizeTotal, &sizeProgress,
+                        &currentPercentComplete);
                 }
 
                 // A keep-alive is required here for the remote holding open the backup connection
@@ -2241,10 +3135,21 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
                 // Check that the clusters are alive and correctly configured during the backup
                 backupDbPing(backupData, false);
 
-                // Save the manifest periodically to preserve checksums for resume
+                // Save updated files to the journal periodically to preserve checksums for resume
                 if (sizeProgress - manifestSaveLast >= manifestSaveSize)
                 {
-                    backupManifestSaveCopy(manifest, cipherPassBackup, false);
+                    if (journal != NULL)
+                    {
+                        backupManifestJournalWrite(manifest, journal, &journalSegment, cipherPassBackup);
+                        strLstFree(journal);
+
+                        MEM_CONTEXT_PRIOR_BEGIN()
+                        {
+                            journal = strLstNew();
+                        }
+                        MEM_CONTEXT_PRIOR_END();
+                    }
+
                     manifestSaveLast = sizeProgress;
                 }
 
@@ -2255,6 +3160,10 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         }
         MEM_CONTEXT_TEMP_END();
 
+        // Save remaining updated files to the journal in case there is an error before the manifest is saved
+        if (journal != NULL)
+            backupManifestJournalWrite(manifest, journal, &journalSegment, cipherPassBackup);
+
 #ifdef DEBUG
         // Ensure that all processing queues are empty
         for (unsigned int queueIdx = 0; queueIdx < lstSize(jobData.queueList); queueIdx++)
@@ -2266,36 +3175,65 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         for (unsigned int fileRemoveIdx = 0; fileRemoveIdx < strLstSize(fileRemove); fileRemoveIdx++)
             manifestFileRemove(manifest, strLstGet(fileRemove, fileRemoveIdx));
 
+        // Write the block index so blocks stored by this backup can be used by later backups
+        if (jobData.blockIndex != NULL && blockIndexSize(jobData.blockIndex) > 0)
+        {
+            StorageWrite *const write = storageNewWriteP(
+                storageRepoWrite(), strNewFmt("%s/" BLOCK_INDEX_FILE, strZ(backupPathExp)));
+
+            if (jobData.cipherType != cipherTypeNone)
+            {
+                ioFilterGroupAdd(
+                    ioWriteFilterGroup(storageWriteIo(write)),
+                    cipherBlockNewP(cipherModeEncrypt, jobData.cipherType, BUFSTR(jobData.cipherSubPass)));
+            }
+
+            ioWriteOpen(storageWriteIo(write));
+            blockIndexWrite(jobData.blockIndex, storageWriteIo(write));
+            ioWriteClose(storageWriteIo(write));
+        }
+
+        // Remove block index map files
+        if (jobData.blockIndex != NULL)
+            storagePathRemoveP(storageLocalWrite(), jobData.blockIndexPath, .recurse = true);
+
         // Log references or create hardlinks for all files
         const char *const compressExt = strZ(compressExtStr(jobData.compressType));
 
-        for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
         {
-            const ManifestFile file = manifestFile(manifest, fileIdx);
-
-            // If the file has a reference, then it was not copied since it can be retrieved from the referenced backup. However,
-            // if hardlinking is enabled the link will need to be created.
-            if (file.reference != NULL)
+            for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
             {
-                // If hardlinking is enabled then create a hardlink for files that have not changed since the last backup
-                if (hardLink)
+                const ManifestFile file = manifestFile(manifest, fileIdx);
+
+                // If the file has a reference, then it was not copied since it can be retrieved from the referenced backup.
+                // However, if hardlinking is enabled the link will need to be created.
+                if (file.reference != NULL)
                 {
-                    LOG_DETAIL_FMT("hardlink %s to %s", strZ(file.name), strZ(file.reference));
+                    // If hardlinking is enabled then create a hardlink for files that have not changed since the last backup
+                    if (hardLink)
+                    {
+                        LOG_DETAIL_FMT("hardlink %s to %s", strZ(file.name), strZ(file.reference));
 
-                    const String *const linkName = storagePathP(
-                        storageRepo(), strNewFmt("%s/%s%s", strZ(backupPathExp), strZ(file.name), compressExt));
-                    const String *const linkDestination = storagePathP(
-                        storageRepo(),
-                        strNewFmt(STORAGE_REPO_BACKUP "/%s/%s%s", strZ(file.reference), strZ(file.name), compressExt));
+                        const String *const linkName = storagePathP(
+                            storageRepo(), strNewFmt("%s/%s%s", strZ(backupPathExp), strZ(file.name), compressExt));
+                        const String *const linkDestination = storagePathP(
+                            storageRepo(),
+                            strNewFmt(STORAGE_REPO_BACKUP "/%s/%s%s", strZ(file.reference), strZ(file.name), compressExt));
 
-                    storageLinkCreateP(storageRepoWrite(), linkDestination, linkName, .linkType = storageLinkHard);
+                        storageLinkCreateP(storageRepoWrite(), linkDestination, linkName, .linkType = storageLinkHard);
+                    }
+                    // Else log the reference. With delta, it is possible that references may have been removed if a file needed
+                    // to be recopied.
+                    else
+                        LOG_DETAIL_FMT("reference %s to %s", strZ(file.name), strZ(file.reference));
                 }
-                // Else log the reference. With delta, it is possible that references may have been removed if a file needed to be
-                // recopied.
-                else
-                    LOG_DETAIL_FMT("reference %s to %s", strZ(file.name), strZ(file.reference));
+
+                // Reset the memory context occasionally so file names do not accumulate
+                MEM_CONTEXT_TEMP_RESET(1000);
             }
         }
+        MEM_CONTEXT_TEMP_END();
 
         // Sync backup paths if required
         if (storageFeature(storageRepoWrite(), storageFeaturePathSync))
@@ -2320,12 +3258,11 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
 Check and copy WAL segments required to make the backup consistent
 ***********************************************************************************************************************************/
 static void
-backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manifest, const String *const cipherPassBackup)
+backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manifest)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
-        FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
     FUNCTION_LOG_END();
 
     ASSERT(manifest != NULL);
@@ -2345,9 +3282,6 @@ backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manif
                 strZ(pgLsnToWalSegment(backupData->timeline, lsnStart, backupData->walSegmentSize)),
                 strZ(pgLsnToWalSegment(backupData->timeline, lsnStop, backupData->walSegmentSize)));
 
-            // Save the backup manifest before getting archive logs in case of failure
-            backupManifestSaveCopy(manifest, cipherPassBackup, false);
-
             // Use base path to set ownership and mode
             const ManifestPath *const basePath = manifestPathFind(manifest, MANIFEST_TARGET_PGDATA_STR);
 
@@ -2475,6 +3409,18 @@ backupComplete(InfoBackup *const infoBackup, Manifest *const manifest)
             storageNewWriteP(
                 storageRepoWrite(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel))));
 
+        // Save the binary manifest. This must happen after the text manifest is saved since the binary manifest will only be loaded
+        // when the text manifest exists.
+        IoWrite *const manifestPackWrite = storageWriteIo(
+            storageNewWriteP(
+                storageRepoWrite(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_PACK_FILE, strZ(backupLabel))));
+
+        cipherBlockFilterGroupAdd(
+            ioWriteFilterGroup(manifestPackWrite), cfgOptionStrId(cfgOptRepoCipherType), cipherModeEncrypt,
+            infoPgCipherPass(infoBackupPg(infoBackup)));
+
+        manifestSavePack(manifest, manifestPackWrite);
+
         // Copy a compressed version of the manifest to history. If the repo is encrypted then the passphrase to open the manifest
         // is required. We can't just do a straight copy since the destination needs to be compressed and that must happen before
         // encryption in order to be efficient. Compression will always be gz for compatibility and since it is always available.
@@ -2577,7 +3523,8 @@ cmdBackup(void)
         Manifest *const manifest = manifestNewBuild(
             backupData->storagePrimary, infoPg.version, infoPg.catalogVersion, timestampStart, cfgOptionBool(cfgOptOnline),
             cfgOptionBool(cfgOptChecksumPage), cfgOptionBool(cfgOptRepoBundle), cfgOptionBool(cfgOptRepoBlock), &blockIncrMap,
-            strLstNewVarLst(cfgOptionLst(cfgOptExclude)), backupStartResult.tablespaceList);
+            strLstNewVarLst(cfgOptionLst(cfgOptExclude)), backupStartResult.tablespaceList,
+            backupBuildPathList(backupData, infoPg.version, infoPg.catalogVersion, BACKUP_BUILD_PATH_RESULT_MAX));
 
         // Validate the manifest using the copy start time
         manifestBuildValidate(
@@ -2585,8 +3532,11 @@ cmdBackup(void)
             compressTypeEnum(cfgOptionStrId(cfgOptCompressType)));
 
         // Build an incremental backup if type is not full (manifestPrior will be freed in this call)
-        if (!backupBuildIncr(infoBackup, manifest, manifestPrior, backupStartResult.walSegmentName))
+        if (!backupBuildIncr(
+                infoBackup, backupData, manifest, manifestPrior, backupStartResult.lsn, backupStartResult.walSegmentName))
+        {
             manifestCipherSubPassSet(manifest, cipherPassGen(cfgOptionStrId(cfgOptRepoCipherType)));
+        }
 
         // Set delta if it is not already set and the manifest requires it
         if (!cfgOptionBool(cfgOptDelta) && varBool(manifestData(manifest)->backupOptionDelta))
@@ -2605,7 +3555,7 @@ cmdBackup(void)
         backupManifestSaveCopy(manifest, cipherPassBackup, false);
 
         // Process the backup manifest
-        backupProcess(backupData, manifest, cipherPassBackup);
+        backupProcess(backupData, infoBackup, manifest, cipherPassBackup);
 
         // Check that the clusters are alive and correctly configured after the backup
         backupDbPing(backupData, true);
@@ -2633,7 +3583,7 @@ cmdBackup(void)
         dbFree(backupData->dbPrimary);
 
         // Check and copy WAL segments required to make the backup consistent
-        backupArchiveCheckCopy(backupData, manifest, cipherPassBackup);
+        backupArchiveCheckCopy(backupData, manifest);
 
         // The primary protocol connection won't be used anymore so free it. This needs to happen after backupArchiveCheckCopy() so
         // the backup lock is held on the remote which allows conditional archiving based on the backup lock. Any further access to
@@ -17,6 +17,7 @@ Block Incremental Filter
 #include "common/log.h"
 #include "common/type/object.h"
 #include "common/type/pack.h"
+#include "postgres/interface/static.vendor.h"
 
 /***********************************************************************************************************************************
 Object type
@@ -38,6 +39,14 @@ typedef struct BlockIncr
     size_t checksumSize;                                            // Checksum size
     Buffer *block;                                                  // Block buffer
 
+    bool cdc;                                                       // Content-defined chunking?
+    size_t blockSizeMin;                                            // Minimum block size for content-defined chunking
+    size_t blockSizeMax;                                            // Maximum block size for content-defined chunking
+    uint64_t chunkMaskSmall;                                        // Boundary mask used before the block size is reached
+    uint64_t chunkMaskLarge;                                        // Boundary mask used after the block size is reached
+    uint64_t chunkHash;                                             // Rolling hash of the current block
+    bool chunkEnd;                                                  // Has the end of the current block been found?
+
     Buffer *blockOut;                                               // Block output buffer
     IoWrite *blockOutWrite;                                         // Write to the block block buffer
     List *blockOutList;                                             // List of block map items that need an updated size
@@ -45,6 +54,11 @@ typedef struct BlockIncr
     size_t blockOutOffset;                                          // Block output offset (already copied to output buffer)
 
     const BlockMap *blockMapPrior;                                  // Prior block map
+    uint64_t blockMapPriorLsn;                                      // Start lsn of backup that stored prior map (0 if no lsn check)
+    size_t pageSize;                                                // Page size for lsn check
+    List *blockMapPriorSort;                                        // Prior block map items sorted by checksum (content-defined)
+    const BlockIndex *blockIndex;                                   // Block index (NULL if not enabled)
+    List *referenceList;                                            // Last block used for each reference/bundle
     BlockMap *blockMapOut;                                          // Output block map
     uint64_t blockMapOutSize;                                       // Output block map size (if any)
     bool blockMapWrite;                                             // Write block map (at least one new/changed block)
@@ -68,6 +82,303 @@ blockIncrToLog(const BlockIncr *const this, StringStatic *const debugLog)
 #define FUNCTION_LOG_BLOCK_INCR_FORMAT(value, buffer, bufferSize)                                                                  \
     FUNCTION_LOG_OBJECT_FORMAT(value, blockIncrToLog, buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Find the end of the current block for content-defined chunking
+
+A gear rolling hash (as used by FastCDC) is calculated over the block and the block ends when the masked bits of the hash are all
+zero. Since each byte shifts the hash left by one bit the high bits depend on the last 64 bytes, so boundaries are determined by the
+content near them rather than by the position in the file. An insertion or deletion only changes the blocks around it and the
+blocks after it are found again in the prior block map.
+
+To keep block sizes close to the requested block size the boundary is harder to find before the block size is reached and easier
+after (normalized chunking). Blocks are never smaller than blockSizeMin (except at the end of the file) or larger than blockSizeMax.
+
+The gear table is generated on first use from a fixed seed. It must never change since blocks would no longer match the blocks in
+prior block maps.
+***********************************************************************************************************************************/
+static uint64_t blockIncrGear[256];
+static bool blockIncrGearInit = false;
+
+static size_t
+blockIncrChunk(BlockIncr *const this, const uint8_t *const data, const size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INCR, this);
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->cdc);
+    ASSERT(!this->chunkEnd);
+    ASSERT(data != NULL);
+
+    size_t blockUsed = bufUsed(this->block);
+    uint64_t hash = this->chunkHash;
+    size_t result = 0;
+
+    while (result < size)
+    {
+        hash = (hash << 1) + blockIncrGear[data[result]];
+        result++;
+        blockUsed++;
+
+        if (blockUsed >= this->blockSizeMin &&
+            (blockUsed == this->blockSizeMax ||
+             (hash & (blockUsed < this->blockSize ? this->chunkMaskSmall : this->chunkMaskLarge)) == 0))
+        {
+            this->chunkEnd = true;
+            break;
+        }
+    }
+
+    this->chunkHash = hash;
+
+    FUNCTION_TEST_RETURN(SIZE, result);
+}
+
+/***********************************************************************************************************************************
+Check that a block follows the last block used from the same reference
+
+When blocks are matched by checksum rather than by position a match is only used when it follows the last block used from the same
+reference and bundle so blocks from each reference stay in the order they are stored. This is required to encode the block map and
+allows restore to read each super block sequentially. Matches that would go backward (e.g. duplicated or reordered data) are stored
+again.
+***********************************************************************************************************************************/
+typedef struct BlockIncrReference
+{
+    unsigned int reference;                                         // Reference
+    uint64_t bundleId;                                              // Bundle id
+    uint64_t offset;                                                // Offset of last super block used
+    uint64_t block;                                                 // Last block used in the super block
+} BlockIncrReference;
+
+static int
+blockIncrReferenceComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const BlockIncrReference *const reference1 = item1;
+    const BlockIncrReference *const reference2 = item2;
+    int result = LST_COMPARATOR_CMP(reference1->reference, reference2->reference);
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(reference1->bundleId, reference2->bundleId);
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+static bool
+blockIncrReferenceNext(BlockIncr *const this, const BlockMapItem *const blockMapItem)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INCR, this);
+        FUNCTION_TEST_PARAM_P(VOID, blockMapItem);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->referenceList != NULL);
+    ASSERT(blockMapItem != NULL);
+
+    BlockIncrReference *const reference = lstFind(
+        this->referenceList, &(BlockIncrReference){.reference = blockMapItem->reference, .bundleId = blockMapItem->bundleId});
+
+    if (reference == NULL)
+    {
+        lstAdd(
+            this->referenceList,
+            &(BlockIncrReference){
+                .reference = blockMapItem->reference, .bundleId = blockMapItem->bundleId, .offset = blockMapItem->offset,
+                .block = blockMapItem->block});
+
+        FUNCTION_TEST_RETURN(BOOL, true);
+    }
+
+    if (blockMapItem->offset > reference->offset ||
+        (blockMapItem->offset == reference->offset && blockMapItem->block > reference->block))
+    {
+        reference->offset = blockMapItem->offset;
+        reference->block = blockMapItem->block;
+
+        FUNCTION_TEST_RETURN(BOOL, true);
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, false);
+}
+
+/***********************************************************************************************************************************
+Find a block in the prior map for content-defined chunking
+***********************************************************************************************************************************/
+static int
+blockIncrPriorComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const BlockMapItem *const blockMapItem1 = *(const BlockMapItem *const *)item1;
+    const BlockMapItem *const blockMapItem2 = *(const BlockMapItem *const *)item2;
+    int result = memcmp(blockMapItem1->checksum, blockMapItem2->checksum, sizeof(blockMapItem1->checksum));
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(blockMapItem1->reference, blockMapItem2->reference);
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(blockMapItem1->bundleId, blockMapItem2->bundleId);
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(blockMapItem1->offset, blockMapItem2->offset);
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(blockMapItem1->block, blockMapItem2->block);
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+static const BlockMapItem *
+blockIncrFindPrior(BlockIncr *const this, const Buffer *const checksum)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INCR, this);
+        FUNCTION_TEST_PARAM(BUFFER, checksum);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->blockMapPriorSort != NULL);
+    ASSERT(checksum != NULL);
+
+    // Checksums are zero-padded in the map so pad the checksum to find
+    uint8_t checksumFind[XX_HASH_SIZE_MAX] = {0};
+    memcpy(checksumFind, bufPtrConst(checksum), bufUsed(checksum));
+
+    // Find the first block with the checksum
+    unsigned int blockIdx = 0;
+    unsigned int blockIdxMax = lstSize(this->blockMapPriorSort);
+
+    while (blockIdx < blockIdxMax)
+    {
+        const unsigned int blockIdxMid = (blockIdx + blockIdxMax) / 2;
+
+        const BlockMapItem *const blockMapItem = *(const BlockMapItem **)lstGet(this->blockMapPriorSort, blockIdxMid);
+
+        if (memcmp(blockMapItem->checksum, checksumFind, XX_HASH_SIZE_MAX) < 0)
+            blockIdx = blockIdxMid + 1;
+        else
+            blockIdxMax = blockIdxMid;
+    }
+
+    // Find the first block with the checksum that follows the last block used from the same reference
+    const BlockMapItem *result = NULL;
+
+    for (; blockIdx < lstSize(this->blockMapPriorSort); blockIdx++)
+    {
+        const BlockMapItem *const blockMapItem = *(const BlockMapItem **)lstGet(this->blockMapPriorSort, blockIdx);
+
+        if (memcmp(blockMapItem->checksum, checksumFind, XX_HASH_SIZE_MAX) != 0)
+            break;
+
+        if (blockIncrReferenceNext(this, blockMapItem))
+        {
+            result = blockMapItem;
+            break;
+        }
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_CONST_P(BlockMapItem, result);
+}
+
+/***********************************************************************************************************************************
+Find a block in the block index
+
+The block must have been stored with the same block size and type (fixed or variable size) since restore locates blocks in the super
+block based on these. Blocks stored by the current backup can only be used by files in other bundles since blocks are read from a
+bundle in order on restore, and not at all by files that are not bundled since bundles are removed when the backup is resumed.
+***********************************************************************************************************************************/
+static bool
+blockIncrFindIndexCallback(void *const data, const BlockIndexItem *const blockIndexItem)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM_P(VOID, blockIndexItem);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+    ASSERT(blockIndexItem != NULL);
+
+    BlockIncr *const this = data;
+
+    FUNCTION_TEST_RETURN(
+        BOOL,
+        (blockIndexItem->blockMapItem.reference != this->reference ||
+         (this->bundleId != 0 && blockIndexItem->blockMapItem.bundleId != this->bundleId)) &&
+        blockIndexItem->blockSize == this->blockSize && (blockIndexItem->blockMapItem.blockSize != 0) == this->cdc &&
+        blockIncrReferenceNext(this, &blockIndexItem->blockMapItem));
+}
+
+static const BlockMapItem *
+blockIncrFindIndex(BlockIncr *const this, const Buffer *const checksum)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INCR, this);
+        FUNCTION_TEST_PARAM(BUFFER, checksum);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->blockIndex != NULL);
+    ASSERT(checksum != NULL);
+    ASSERT(bufUsed(checksum) == XX_HASH_SIZE_MAX);
+
+    const BlockIndexItem *const blockIndexItem = blockIndexFind(
+        this->blockIndex, bufPtrConst(checksum), blockIncrFindIndexCallback, this);
+
+    FUNCTION_TEST_RETURN_TYPE_CONST_P(BlockMapItem, blockIndexItem != NULL ? &blockIndexItem->blockMapItem : NULL);
+}
+
+/***********************************************************************************************************************************
+Check that every page in the block has a valid lsn before the prior backup started
+
+The page header is checked in the same way as PostgreSQL checks it before reading a page. Pages that fail the check (including new
+and zero pages) or that have no lsn cannot be proven unchanged so the block must be hashed.
+***********************************************************************************************************************************/
+static bool
+blockIncrPageLsnBefore(const BlockIncr *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INCR, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->blockMapPriorLsn != 0);
+    ASSERT(bufUsed(this->block) == this->blockSize);
+    ASSERT(this->blockSize % this->pageSize == 0);
+
+    for (size_t pageOffset = 0; pageOffset < this->blockSize; pageOffset += this->pageSize)
+    {
+        const PageHeaderData *const pageHeader = (const PageHeaderData *)(bufPtrConst(this->block) + pageOffset);
+        const uint64_t pageLsn = (uint64_t)pageHeader->pd_lsn.xlogid << 32 | pageHeader->pd_lsn.xrecoff;
+
+        if (pageLsn == 0 || pageLsn >= this->blockMapPriorLsn ||
+            (size_t)(pageHeader->pd_pagesize_version & 0xFF00) != this->pageSize ||
+            pageHeader->pd_lower < offsetof(PageHeaderData, pd_linp) || pageHeader->pd_lower > pageHeader->pd_upper ||
+            pageHeader->pd_upper > pageHeader->pd_special || pageHeader->pd_special > this->pageSize)
+        {
+            FUNCTION_TEST_RETURN(BOOL, false);
+        }
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, true);
+}
+
 /***********************************************************************************************************************************
 Generate block incremental
 ***********************************************************************************************************************************/
@@ -94,8 +405,15 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         // If not done and not flushing out then get more block data
         if (!this->done && this->blockOutOffset == 0)
         {
+            // Get the amount of input that can be copied to the block. For content-defined chunking this is up to the end of the
+            // block (if found).
+            const size_t blockRemains =
+                this->cdc ?
+                    blockIncrChunk(this, bufPtrConst(input) + this->inputOffset, bufUsed(input) - this->inputOffset) :
+                    bufRemains(this->block);
+
             // If all input can be copied
-            if (bufUsed(input) - this->inputOffset <= bufRemains(this->block))
+            if (bufUsed(input) - this->inputOffset <= blockRemains)
             {
                 bufCatSub(this->block, input, this->inputOffset, bufUsed(input) - this->inputOffset);
                 this->inputOffset = 0;
@@ -106,10 +424,8 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
             // Else only part of the input can be copied
             else
             {
-                const size_t copySize = bufRemains(this->block);
-
-                bufCatSub(this->block, input, this->inputOffset, copySize);
-                this->inputOffset += copySize;
+                bufCatSub(this->block, input, this->inputOffset, blockRemains);
+                this->inputOffset += blockRemains;
 
                 // The same input will be needed again to copy the rest
                 this->inputSame = true;
@@ -117,20 +433,90 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         }
 
         // If done with a partial block or block is full
-        if ((this->done && bufUsed(this->block) > 0) || bufUsed(this->block) == this->blockSize)
+        if ((this->done && bufUsed(this->block) > 0) || (this->cdc ? this->chunkEnd : bufUsed(this->block) == this->blockSize))
         {
             MEM_CONTEXT_TEMP_BEGIN()
             {
-                // Get block checksum
-                const Buffer *const checksum = xxHashOne(this->checksumSize, this->block);
+                // Is the block all zeroes? Full size zero blocks are stored in the map only since they can be generated on restore.
+                // Zero blocks are not elided for content-defined chunking since their position in the file is not fixed.
+                const bool zero =
+                    !this->cdc && bufUsed(this->block) == this->blockSize && bufPtrConst(this->block)[0] == 0 &&
+                    memcmp(bufPtrConst(this->block), bufPtrConst(this->block) + 1, this->blockSize - 1) == 0;
+
+                // Can the block be shown to be unchanged since the prior map was stored by checking page lsns?
+                const bool lsnBefore =
+                    !zero && this->blockMapPriorLsn != 0 && bufUsed(this->block) == this->blockSize &&
+                    this->blockNo < blockMapSize(this->blockMapPrior) && !blockMapGet(this->blockMapPrior, this->blockNo)->zero &&
+                    blockIncrPageLsnBefore(this);
+
+                // Get block checksum unless the block is zero or unchanged. The checksum of a zero block is not stored in the map
+                // so it is not needed. The full checksum is required to find the block in the index but the map only stores
+                // checksumSize bytes.
+                const size_t checksumFullSize = this->blockIndex != NULL ? XX_HASH_SIZE_MAX : this->checksumSize;
+                const Buffer *checksumFull = zero || lsnBefore ? NULL : xxHashOne(checksumFullSize, this->block);
+
+                // Does the block exist in the input map? For content-defined chunking the block may be anywhere in the prior map
+                // but for fixed size blocks it must be in the same position.
+                const BlockMapItem *blockMapItemIn = NULL;
+
+                if (zero)
+                {
+                    // The map must be written if the block was not zero in the prior map
+                    if (this->blockMapPrior == NULL || this->blockNo >= blockMapSize(this->blockMapPrior) ||
+                        !blockMapGet(this->blockMapPrior, this->blockNo)->zero)
+                    {
+                        this->blockMapWrite = true;
+                    }
+                }
+                else if (this->cdc)
+                {
+                    if (this->blockMapPrior != NULL)
+                    {
+                        blockMapItemIn = blockIncrFindPrior(this, BUF(bufPtrConst(checksumFull), this->checksumSize));
 
-                // Does the block exist in the input map?
-                const BlockMapItem *const blockMapItemIn =
-                    this->blockMapPrior != NULL && this->blockNo < blockMapSize(this->blockMapPrior) ?
-                        blockMapGet(this->blockMapPrior, this->blockNo) : NULL;
+                        // The map must be written if the block has moved
+                        if (blockMapItemIn != NULL &&
+                            (this->blockNo >= blockMapSize(this->blockMapPrior) ||
+                             blockMapItemIn != blockMapGet(this->blockMapPrior, this->blockNo)))
+                        {
+                            this->blockMapWrite = true;
+                        }
+                    }
+                }
+                else if (this->blockMapPrior != NULL && this->blockNo < blockMapSize(this->blockMapPrior))
+                {
+                    blockMapItemIn = blockMapGet(this->blockMapPrior, this->blockNo);
 
-                // If the block is new or has changed then write it
-                if (blockMapItemIn == NULL || memcmp(blockMapItemIn->checksum, bufPtrConst(checksum), this->checksumSize) != 0)
+                    // When the index is enabled other blocks may have been used from the same reference
+                    if (blockMapItemIn->zero ||
+                        (!lsnBefore && memcmp(blockMapItemIn->checksum, bufPtrConst(checksumFull), this->checksumSize) != 0) ||
+                        (this->blockIndex != NULL && !blockIncrReferenceNext(this, blockMapItemIn)))
+                    {
+                        blockMapItemIn = NULL;
+                    }
+                }
+
+                // If the prior block cannot be used after all then the checksum is required
+                if (!zero && blockMapItemIn == NULL && checksumFull == NULL)
+                    checksumFull = xxHashOne(checksumFullSize, this->block);
+
+                // Else check the index. The map must be written since the block has moved.
+                if (!zero && blockMapItemIn == NULL && this->blockIndex != NULL)
+                {
+                    blockMapItemIn = blockIncrFindIndex(this, checksumFull);
+
+                    if (blockMapItemIn != NULL)
+                        this->blockMapWrite = true;
+                }
+
+                // If the block is zero then add it to the map without writing it
+                if (zero)
+                {
+                    blockMapAdd(this->blockMapOut, &(BlockMapItem){.zero = true});
+                    bufUsedZero(this->block);
+                }
+                // Else if the block is new or has changed then write it
+                else if (blockMapItemIn == NULL)
                 {
                     // Begin the super block
                     if (this->blockOutWrite == NULL)
@@ -159,12 +545,7 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
                         ioWriteOpen(this->blockOutWrite);
                     }
 
-                    // Copy block data through the filters
-                    ioCopyP(ioBufferReadNewOpen(this->block), this->blockOutWrite);
-                    this->blockOutSize += bufUsed(this->block);
-                    bufUsedZero(this->block);
-
-                    // Write to block map
+                    // Write to block map. Offset and size within the super block are only stored for content-defined chunking.
                     BlockMapItem blockMapItem =
                     {
                         .reference = this->reference,
@@ -172,9 +553,16 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
                         .bundleId = this->bundleId,
                         .offset = this->blockOffset,
                         .block = this->superBlockNo,
+                        .blockOffset = this->cdc ? this->blockOutSize : 0,
+                        .blockSize = this->cdc ? bufUsed(this->block) : 0,
                     };
 
-                    memcpy(blockMapItem.checksum, bufPtrConst(checksum), bufUsed(checksum));
+                    // Copy block data through the filters
+                    ioCopyP(ioBufferReadNewOpen(this->block), this->blockOutWrite);
+                    this->blockOutSize += bufUsed(this->block);
+                    bufUsedZero(this->block);
+
+                    memcpy(blockMapItem.checksum, bufPtrConst(checksumFull), bufUsed(checksumFull));
 
                     const unsigned int blockMapItemIdx = blockMapSize(this->blockMapOut);
                     blockMapAdd(this->blockMapOut, &blockMapItem);
@@ -190,6 +578,9 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
                     bufUsedZero(this->block);
                 }
 
+                // Start a new block
+                this->chunkEnd = false;
+                this->chunkHash = 0;
                 this->blockNo++;
             }
             MEM_CONTEXT_TEMP_END();
@@ -235,7 +626,7 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         // Write the block map if done processing and there are new/changed blocks or block list has been truncated
         if (this->done && this->blockOutOffset == 0 &&
             (this->blockMapWrite ||
-             (this->blockMapPrior != NULL && blockMapSize(this->blockMapOut) < blockMapSize(this->blockMapPrior))))
+             (this->blockMapPrior != NULL && blockMapSize(this->blockMapOut) != blockMapSize(this->blockMapPrior))))
         {
             MEM_CONTEXT_TEMP_BEGIN()
             {
@@ -293,7 +684,7 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
 }
 
 /***********************************************************************************************************************************
-The result is the size of the block map
+The result is the size of the block map and the new blocks to add to the block index (when enabled)
 ***********************************************************************************************************************************/
 static Pack *
 blockIncrResult(THIS_VOID)
@@ -313,6 +704,33 @@ blockIncrResult(THIS_VOID)
         PackWrite *const packWrite = pckWriteNewP();
 
         pckWriteU64P(packWrite, this->blockMapOutSize);
+
+        // Return new blocks stored in a bundle. Blocks that are not in a bundle cannot be indexed since the repo file name is not
+        // known.
+        if (this->blockIndex != NULL && this->bundleId != 0)
+        {
+            BlockIndex *const blockIndex = blockIndexNew();
+
+            for (unsigned int blockMapIdx = 0; blockMapIdx < blockMapSize(this->blockMapOut); blockMapIdx++)
+            {
+                const BlockMapItem *const blockMapItem = blockMapGet(this->blockMapOut, blockMapIdx);
+
+                if (!blockMapItem->zero && blockMapItem->reference == this->reference)
+                    blockIndexAdd(blockIndex, &(BlockIndexItem){.blockSize = this->blockSize, .blockMapItem = *blockMapItem});
+            }
+
+            if (blockIndexSize(blockIndex) > 0)
+            {
+                Buffer *const blockIndexOut = bufNew(0);
+                IoWrite *const write = ioBufferWriteNewOpen(blockIndexOut);
+
+                blockIndexWrite(blockIndex, write);
+                ioWriteClose(write);
+
+                pckWriteBinP(packWrite, blockIndexOut);
+            }
+        }
+
         pckWriteEndP(packWrite);
 
         result = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -359,22 +777,28 @@ blockIncrInputSame(const THIS_VOID)
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
 blockIncrNew(
-    const uint64_t superBlockSize, const size_t blockSize, const size_t checksumSize, const unsigned int reference,
-    const uint64_t bundleId, const uint64_t bundleOffset, const Buffer *const blockMapPrior, const IoFilter *const compress,
-    const IoFilter *const encrypt)
+    const uint64_t superBlockSize, const size_t blockSize, const size_t checksumSize, const bool cdc, const unsigned int reference,
+    const uint64_t bundleId, const uint64_t bundleOffset, const Buffer *const blockMapPrior, const uint64_t blockMapPriorLsn,
+    const size_t pageSize, const BlockIndex *const blockIndex, const IoFilter *const compress, const IoFilter *const encrypt)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(UINT64, superBlockSize);
         FUNCTION_LOG_PARAM(SIZE, blockSize);
         FUNCTION_LOG_PARAM(SIZE, checksumSize);
+        FUNCTION_LOG_PARAM(BOOL, cdc);
         FUNCTION_LOG_PARAM(UINT, reference);
         FUNCTION_LOG_PARAM(UINT64, bundleId);
         FUNCTION_LOG_PARAM(UINT64, bundleOffset);
         FUNCTION_LOG_PARAM(BUFFER, blockMapPrior);
+        FUNCTION_LOG_PARAM(UINT64, blockMapPriorLsn);
+        FUNCTION_LOG_PARAM(SIZE, pageSize);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, blockIndex);
         FUNCTION_LOG_PARAM(IO_FILTER, compress);
         FUNCTION_LOG_PARAM(IO_FILTER, encrypt);
     FUNCTION_LOG_END();
 
+    ASSERT(blockMapPriorLsn == 0 || pageSize != 0);
+
     OBJ_NEW_BEGIN(BlockIncr, .childQty = MEM_CONTEXT_QTY_MAX)
     {
         *this = (BlockIncr)
@@ -385,11 +809,44 @@ blockIncrNew(
             .reference = reference,
             .bundleId = bundleId,
             .blockOffset = bundleOffset,
-            .block = bufNew(blockSize),
+            .block = bufNew(cdc ? BLOCK_INCR_CDC_SIZE_MAX(blockSize) : blockSize),
             .blockOut = bufNew(0),
             .blockMapOut = blockMapNew(),
+            .blockIndex = blockIndex,
+            .cdc = cdc,
         };
 
+        // Set block size limits and boundary masks for content-defined chunking. The masks are based on the number of bits in the
+        // block size so the average block size will be close to the block size.
+        if (cdc)
+        {
+            ASSERT(blockSize > 1);
+
+            const unsigned int blockSizeBits =
+                (unsigned int)(sizeof(unsigned long) * 8 - 1) - (unsigned int)__builtin_clzl((unsigned long)blockSize);
+
+            this->blockSizeMin = BLOCK_INCR_CDC_SIZE_MIN(blockSize);
+            this->blockSizeMax = BLOCK_INCR_CDC_SIZE_MAX(blockSize);
+            this->chunkMaskSmall = ~(UINT64_MAX >> (blockSizeBits + 1));
+            this->chunkMaskLarge = ~(UINT64_MAX >> (blockSizeBits - 1));
+
+            if (!blockIncrGearInit)
+            {
+                uint64_t seed = 0x7062676261636b72;                 // Arbitrary fixed seed
+
+                for (unsigned int gearIdx = 0; gearIdx < LENGTH_OF(blockIncrGear); gearIdx++)
+                {
+                    // splitmix64
+                    uint64_t value = (seed += 0x9e3779b97f4a7c15);
+                    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+                    value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+                    blockIncrGear[gearIdx] = value ^ (value >> 31);
+                }
+
+                blockIncrGearInit = true;
+            }
+        }
+
         // Duplicate compress filter
         if (compress != NULL)
         {
@@ -410,12 +867,45 @@ blockIncrNew(
 
                 MEM_CONTEXT_PRIOR_BEGIN()
                 {
-                    this->blockMapPrior = blockMapNewRead(read, blockSize, checksumSize);
+                    BlockMap *const blockMapPriorRead = blockMapNewRead(read, blockSize, checksumSize);
+
+                    // The prior map can only be used when the block type (fixed or variable size) has not changed. Otherwise all
+                    // blocks will be stored again.
+                    if (blockMapVariable(blockMapPriorRead) == cdc)
+                        this->blockMapPrior = blockMapPriorRead;
+                    else
+                        blockMapFree(blockMapPriorRead);
                 }
                 MEM_CONTEXT_PRIOR_END();
             }
             MEM_CONTEXT_TEMP_END();
+
+            // Check page lsns when the block size is a multiple of the page size. Blocks must be in the same position as the prior
+            // map so this only works for fixed size blocks.
+            if (blockMapPriorLsn != 0 && !cdc && this->blockMapPrior != NULL && blockSize % pageSize == 0)
+            {
+                this->blockMapPriorLsn = blockMapPriorLsn;
+                this->pageSize = pageSize;
+            }
+
+            // Sort the prior map by checksum so blocks can be found anywhere in the map
+            if (cdc && this->blockMapPrior != NULL)
+            {
+                this->blockMapPriorSort = lstNewP(sizeof(BlockMapItem *), .comparator = blockIncrPriorComparator);
+
+                for (unsigned int blockMapIdx = 0; blockMapIdx < blockMapSize(this->blockMapPrior); blockMapIdx++)
+                {
+                    const BlockMapItem *const blockMapItem = blockMapGet(this->blockMapPrior, blockMapIdx);
+                    lstAdd(this->blockMapPriorSort, &blockMapItem);
+                }
+
+                lstSort(this->blockMapPriorSort, sortOrderAsc);
+            }
         }
+
+        // Track the last block used for each reference when blocks are not only matched by position
+        if ((cdc && this->blockMapPrior != NULL) || blockIndex != NULL)
+            this->referenceList = lstNewP(sizeof(BlockIncrReference), .comparator = blockIncrReferenceComparator);
     }
     OBJ_NEW_END();
 
@@ -429,10 +919,14 @@ blockIncrNew(
         pckWriteU64P(packWrite, this->superBlockSize);
         pckWriteU64P(packWrite, blockSize);
         pckWriteU64P(packWrite, checksumSize);
+        pckWriteBoolP(packWrite, cdc);
         pckWriteU32P(packWrite, reference);
         pckWriteU64P(packWrite, bundleId);
         pckWriteU64P(packWrite, bundleOffset);
         pckWriteBinP(packWrite, blockMapPrior);
+        pckWriteU64P(packWrite, blockMapPriorLsn);
+        pckWriteU64P(packWrite, pageSize);
+        pckWriteBoolP(packWrite, blockIndex != NULL);
         pckWritePackP(packWrite, this->compressParam);
 
         if (this->compressParam != NULL)
@@ -464,10 +958,26 @@ blockIncrNewPack(const Pack *const paramList)
         const uint64_t superBlockSize = pckReadU64P(paramListPack);
         const size_t blockSize = (size_t)pckReadU64P(paramListPack);
         const size_t checksumSize = (size_t)pckReadU64P(paramListPack);
+        const bool cdc = pckReadBoolP(paramListPack);
         const unsigned int reference = pckReadU32P(paramListPack);
         const uint64_t bundleId = pckReadU64P(paramListPack);
         const uint64_t bundleOffset = pckReadU64P(paramListPack);
         const Buffer *blockMapPrior = pckReadBinP(paramListPack);
+        const uint64_t blockMapPriorLsn = pckReadU64P(paramListPack);
+        const size_t pageSize = (size_t)pckReadU64P(paramListPack);
+
+        // The block index is not passed so use an empty index to return new blocks. It must be created in the prior context since
+        // the filter references it.
+        const BlockIndex *blockIndex = NULL;
+
+        if (pckReadBoolP(paramListPack))
+        {
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                blockIndex = blockIndexNew();
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
 
         // Create compress filter
         const Pack *const compressParam = pckReadPackP(paramListPack);
@@ -485,7 +995,8 @@ blockIncrNewPack(const Pack *const paramList)
 
         result = ioFilterMove(
             blockIncrNew(
-                superBlockSize, blockSize, checksumSize, reference, bundleId, bundleOffset, blockMapPrior, compress, encrypt),
+                superBlockSize, blockSize, checksumSize, cdc, reference, bundleId, bundleOffset, blockMapPrior, blockMapPriorLsn,
+                pageSize, blockIndex, compress, encrypt),
             memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
@@ -17,6 +17,25 @@ backup. However, the block map may reference super block lists (or parts thereof
 
 The block incremental should be read using BlockDelta since reconstructing the delta is quite involved.
 
+Blocks are fixed size by default so an insertion or deletion changes all the blocks that follow it. When content-defined chunking
+(cdc) is enabled block boundaries are found with a rolling hash so blocks are variable size and are matched against the prior map by
+checksum rather than position. The block size is then the average block size and blocks will be between BLOCK_INCR_CDC_SIZE_MIN()
+and BLOCK_INCR_CDC_SIZE_MAX().
+
+When a block index is provided (see BlockIndex) blocks that are not found in the prior map are also looked up in the index so a
+block stored for any file in a referenced backup can be used. The full 128-bit xxHash is used to find blocks in the index since a
+match on checksumSize bytes is only likely to be correct for the same file. When the index is enabled the filter also returns the
+new blocks stored in bundles so they can be added to the index for the current backup. The index is not passed to remotes so only
+new blocks are returned when the filter runs remotely.
+
+When the start lsn of the backup that stored the prior map is provided, each page in a fixed size block is checked before the block
+is hashed. If every page has a valid header and an lsn before the prior backup started then the block has not been changed since it
+was stored and the prior block is used without calculating the checksum. PostgreSQL must write WAL before a page change can reach
+disk so any change after the prior backup started will have a later lsn. Hint bit updates are the exception unless checksums or
+wal_log_hints are enabled, so the caller must only provide the lsn when one of them is. Blocks with pages that are new, zero, or
+have an invalid header are hashed as usual. Only the main fork of relation files should be checked since other files do not have
+page lsns and the visibility map may be changed without updating the page lsn.
+
 The xxHash algorithm is used to determine which blocks have changed. A 128-bit xxHash is generated and then checksumSize bytes are
 used from the hash depending on the size of the block. xxHash claims to have excellent dispersion characteristics, which has been
 verified by testing with SMHasher and a custom test suite. xxHash-32 is used for up to 4MiB content blocks in lz4 and the lower
@@ -28,6 +47,7 @@ SHA1 file checksum. This will fail the backup, which is not ideal, but better th
 #ifndef COMMAND_BACKUP_BLOCK_INCR_H
 #define COMMAND_BACKUP_BLOCK_INCR_H
 
+#include "command/backup/blockIndex.h"
 #include "common/io/filter/filter.h"
 
 /***********************************************************************************************************************************
@@ -35,12 +55,19 @@ Filter type constant
 ***********************************************************************************************************************************/
 #define BLOCK_INCR_FILTER_TYPE                                      STRID5("blk-incr", 0x90dc9dad820)
 
+/***********************************************************************************************************************************
+Minimum and maximum block size for content-defined chunking
+***********************************************************************************************************************************/
+#define BLOCK_INCR_CDC_SIZE_MIN(blockSize)                          ((blockSize) / 4)
+#define BLOCK_INCR_CDC_SIZE_MAX(blockSize)                          ((blockSize) * 4)
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN IoFilter *blockIncrNew(
-    uint64_t superBlockSize, size_t blockSize, size_t checksumSize, unsigned int reference, uint64_t bundleId,
-    uint64_t bundleOffset, const Buffer *blockMapPrior, const IoFilter *compress, const IoFilter *encrypt);
+    uint64_t superBlockSize, size_t blockSize, size_t checksumSize, bool cdc, unsigned int reference, uint64_t bundleId,
+    uint64_t bundleOffset, const Buffer *blockMapPrior, uint64_t blockMapPriorLsn, size_t pageSize, const BlockIndex *blockIndex,
+    const IoFilter *compress, const IoFilter *encrypt);
 FN_EXTERN IoFilter *blockIncrNewPack(const Pack *paramList);
 
 #endif
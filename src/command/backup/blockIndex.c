@@ -0,0 +1,423 @@
+/***********************************************************************************************************************************
+Block Incremental Index
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "command/backup/blockIndex.h"
+#include "common/debug.h"
+#include "common/log.h"
+
+/***********************************************************************************************************************************
+Index version
+***********************************************************************************************************************************/
+#define BLOCK_INDEX_VERSION                                         0
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct BlockIndex
+{
+    BlockIndexPub pub;                                              // Publicly accessible variables
+    List *mapList;                                                  // Mapped files
+};
+
+typedef struct BlockIndexMap
+{
+    String *file;                                                   // File name
+    BlockIndexItem *itemList;                                       // Sorted items in the mapped file (read-only)
+    size_t itemTotal;                                               // Total items
+} BlockIndexMap;
+
+/***********************************************************************************************************************************
+Checksum comparator
+***********************************************************************************************************************************/
+static int
+lstComparatorBlockIndexItem(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    FUNCTION_TEST_RETURN(
+        INT,
+        memcmp(
+            ((const BlockIndexItem *)item1)->blockMapItem.checksum, ((const BlockIndexItem *)item2)->blockMapItem.checksum,
+            XX_HASH_SIZE_MAX));
+}
+
+/***********************************************************************************************************************************
+Unmap a file
+***********************************************************************************************************************************/
+static void
+blockIndexMapFree(BlockIndexMap *const map)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, map);
+    FUNCTION_TEST_END();
+
+    ASSERT(map != NULL);
+
+    THROW_ON_SYS_ERROR_FMT(
+        munmap(map->itemList, map->itemTotal * sizeof(BlockIndexItem)) == -1, FileCloseError,
+        "unable to unmap block index '%s'", strZ(map->file));
+
+    strFree(map->file);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Unmap all files when the index is freed
+***********************************************************************************************************************************/
+static void
+blockIndexFreeResource(THIS_VOID)
+{
+    THIS(BlockIndex);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    for (unsigned int mapIdx = 0; mapIdx < lstSize(this->mapList); mapIdx++)
+        blockIndexMapFree(lstGet(this->mapList, mapIdx));
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN BlockIndex *
+blockIndexNew(void)
+{
+    FUNCTION_TEST_VOID();
+
+    OBJ_NEW_BEGIN(BlockIndex, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
+    {
+        *this = (BlockIndex)
+        {
+            .pub =
+            {
+                .itemList = lstNewP(sizeof(BlockIndexItem), .comparator = lstComparatorBlockIndexItem),
+            },
+            .mapList = lstNewP(sizeof(BlockIndexMap), .comparator = lstComparatorStr),
+        };
+
+        memContextCallbackSet(objMemContext(this), blockIndexFreeResource, this);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_TEST_RETURN(BLOCK_INDEX, this);
+}
+
+/***********************************************************************************************************************************
+Find the first item with the checksum in a sorted array. Returns itemTotal when the checksum is not found.
+***********************************************************************************************************************************/
+static size_t
+blockIndexFindItem(const BlockIndexItem *const itemList, const size_t itemTotal, const uint8_t *const checksum)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, itemList);
+        FUNCTION_TEST_PARAM(SIZE, itemTotal);
+        FUNCTION_TEST_PARAM_P(VOID, checksum);
+    FUNCTION_TEST_END();
+
+    ASSERT(itemList != NULL || itemTotal == 0);
+    ASSERT(checksum != NULL);
+
+    size_t result = 0;
+    size_t itemIdxMax = itemTotal;
+
+    while (result < itemIdxMax)
+    {
+        const size_t itemIdxMid = (result + itemIdxMax) / 2;
+
+        if (memcmp(itemList[itemIdxMid].blockMapItem.checksum, checksum, XX_HASH_SIZE_MAX) < 0)
+            result = itemIdxMid + 1;
+        else
+            itemIdxMax = itemIdxMid;
+    }
+
+    // Return total when not found
+    if (result < itemTotal && memcmp(itemList[result].blockMapItem.checksum, checksum, XX_HASH_SIZE_MAX) != 0)
+        result = itemTotal;
+
+    FUNCTION_TEST_RETURN(SIZE, result);
+}
+
+/***********************************************************************************************************************************
+Find the first item with the checksum in a sorted array for which the callback returns true
+***********************************************************************************************************************************/
+static const BlockIndexItem *
+blockIndexFindCallback(
+    const BlockIndexItem *const itemList, const size_t itemTotal, const uint8_t *const checksum,
+    BlockIndexFindCallback *const callback, void *const callbackData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, itemList);
+        FUNCTION_TEST_PARAM(SIZE, itemTotal);
+        FUNCTION_TEST_PARAM_P(VOID, checksum);
+        FUNCTION_TEST_PARAM(FUNCTIONP, callback);
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+    FUNCTION_TEST_END();
+
+    ASSERT(checksum != NULL);
+    ASSERT(callback != NULL);
+
+    for (size_t itemIdx = blockIndexFindItem(itemList, itemTotal, checksum); itemIdx < itemTotal; itemIdx++)
+    {
+        if (memcmp(itemList[itemIdx].blockMapItem.checksum, checksum, XX_HASH_SIZE_MAX) != 0)
+            break;
+
+        if (callback(callbackData, &itemList[itemIdx]))
+            FUNCTION_TEST_RETURN_TYPE_CONST_P(BlockIndexItem, &itemList[itemIdx]);
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_CONST_P(BlockIndexItem, NULL);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN const BlockIndexItem *
+blockIndexFind(
+    const BlockIndex *const this, const uint8_t *const checksum, BlockIndexFindCallback *const callback, void *const callbackData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INDEX, this);
+        FUNCTION_TEST_PARAM_P(VOID, checksum);
+        FUNCTION_TEST_PARAM(FUNCTIONP, callback);
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(checksum != NULL);
+    ASSERT(callback != NULL);
+
+    const BlockIndexItem *result = NULL;
+
+    if (!lstEmpty(this->pub.itemList))
+        result = blockIndexFindCallback(lstGet(this->pub.itemList, 0), lstSize(this->pub.itemList), checksum, callback, callbackData);
+
+    for (unsigned int mapIdx = 0; result == NULL && mapIdx < lstSize(this->mapList); mapIdx++)
+    {
+        const BlockIndexMap *const map = lstGet(this->mapList, mapIdx);
+
+        result = blockIndexFindCallback(map->itemList, map->itemTotal, checksum, callback, callbackData);
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_CONST_P(BlockIndexItem, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+blockIndexMapSet(BlockIndex *const this, const StringList *const fileList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, this);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileList);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(fileList != NULL);
+
+    // Unmap files that are no longer in the list
+    for (unsigned int mapIdx = lstSize(this->mapList); mapIdx > 0; mapIdx--)
+    {
+        BlockIndexMap *const map = lstGet(this->mapList, mapIdx - 1);
+
+        if (!strLstExists(fileList, map->file))
+        {
+            blockIndexMapFree(map);
+            lstRemoveIdx(this->mapList, mapIdx - 1);
+        }
+    }
+
+    // Map files that are not already mapped
+    for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+    {
+        const String *const file = strLstGet(fileList, fileIdx);
+
+        if (lstFind(this->mapList, &file) != NULL)
+            continue;
+
+        // Open the file. It is not an error if the file is missing since it may have been merged into another file.
+        const int fd = open(strZ(file), O_RDONLY, 0);
+
+        if (fd == -1)
+        {
+            if (errno == ENOENT)
+                continue;
+
+            THROW_SYS_ERROR_FMT(FileOpenError, "unable to open block index '%s'", strZ(file));
+        }
+
+        // Map the file. The descriptor is not needed once the file is mapped.
+        TRY_BEGIN()
+        {
+            struct stat statFile;
+
+            THROW_ON_SYS_ERROR_FMT(fstat(fd, &statFile) == -1, FileReadError, "unable to stat block index '%s'", strZ(file));
+            CHECK_FMT(
+                FormatError, (size_t)statFile.st_size % sizeof(BlockIndexItem) == 0, "block index '%s' has invalid size %" PRIu64,
+                strZ(file), (uint64_t)statFile.st_size);
+
+            void *const itemList = mmap(NULL, (size_t)statFile.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+            THROW_ON_SYS_ERROR_FMT(itemList == MAP_FAILED, FileReadError, "unable to map block index '%s'", strZ(file));
+
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                const BlockIndexMap map =
+                {
+                    .file = strDup(file),
+                    .itemList = itemList,
+                    .itemTotal = (size_t)statFile.st_size / sizeof(BlockIndexItem),
+                };
+
+                lstAdd(this->mapList, &map);
+            }
+            MEM_CONTEXT_OBJ_END();
+        }
+        FINALLY()
+        {
+            close(fd);
+        }
+        TRY_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN uint64_t
+blockIndexMapSize(const BlockIndex *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INDEX, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    uint64_t result = 0;
+
+    for (unsigned int mapIdx = 0; mapIdx < lstSize(this->mapList); mapIdx++)
+        result += ((const BlockIndexMap *)lstGet(this->mapList, mapIdx))->itemTotal;
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+blockIndexMapWrite(const BlockIndex *const this, IoWrite *const write)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!lstEmpty(this->pub.itemList));
+    ASSERT(write != NULL);
+
+    ioWrite(write, BUF(lstGet(this->pub.itemList, 0), lstSize(this->pub.itemList) * sizeof(BlockIndexItem)));
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+blockIndexRead(BlockIndex *const this, IoRead *const read, const unsigned int reference)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, this);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+        FUNCTION_LOG_PARAM(UINT, reference);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(read != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        CHECK(FormatError, ioReadVarIntU64(read) == BLOCK_INDEX_VERSION, "block index version must be zero");
+
+        const uint64_t total = ioReadVarIntU64(read);
+        Buffer *const checksum = bufNew(XX_HASH_SIZE_MAX);
+
+        for (uint64_t indexIdx = 0; indexIdx < total; indexIdx++)
+        {
+            BlockIndexItem item = {.blockMapItem = {.reference = reference}};
+
+            bufUsedZero(checksum);
+            ioRead(read, checksum);
+            memcpy(item.blockMapItem.checksum, bufPtr(checksum), XX_HASH_SIZE_MAX);
+
+            const uint64_t blockSizeEncoded = ioReadVarIntU64(read);
+            item.blockSize = (size_t)(blockSizeEncoded >> 1);
+
+            item.blockMapItem.bundleId = ioReadVarIntU64(read);
+            item.blockMapItem.offset = ioReadVarIntU64(read);
+            item.blockMapItem.size = ioReadVarIntU64(read);
+            item.blockMapItem.superBlockSize = ioReadVarIntU64(read);
+            item.blockMapItem.block = ioReadVarIntU64(read);
+
+            if (blockSizeEncoded & 1)
+            {
+                item.blockMapItem.blockOffset = ioReadVarIntU64(read);
+                item.blockMapItem.blockSize = ioReadVarIntU64(read);
+            }
+
+            blockIndexAdd(this, &item);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+blockIndexWrite(const BlockIndex *const this, IoWrite *const write)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(write != NULL);
+
+    ioWriteVarIntU64(write, BLOCK_INDEX_VERSION);
+    ioWriteVarIntU64(write, blockIndexSize(this));
+
+    for (unsigned int indexIdx = 0; indexIdx < blockIndexSize(this); indexIdx++)
+    {
+        const BlockIndexItem *const item = blockIndexGet(this, indexIdx);
+        const bool variable = item->blockMapItem.blockSize != 0;
+
+        ioWrite(write, BUF(item->blockMapItem.checksum, XX_HASH_SIZE_MAX));
+        ioWriteVarIntU64(write, (uint64_t)item->blockSize << 1 | (variable ? 1 : 0));
+        ioWriteVarIntU64(write, item->blockMapItem.bundleId);
+        ioWriteVarIntU64(write, item->blockMapItem.offset);
+        ioWriteVarIntU64(write, item->blockMapItem.size);
+        ioWriteVarIntU64(write, item->blockMapItem.superBlockSize);
+        ioWriteVarIntU64(write, item->blockMapItem.block);
+
+        if (variable)
+        {
+            ioWriteVarIntU64(write, item->blockMapItem.blockOffset);
+            ioWriteVarIntU64(write, item->blockMapItem.blockSize);
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
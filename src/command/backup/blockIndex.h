@@ -0,0 +1,138 @@
+/***********************************************************************************************************************************
+Block Incremental Index
+
+The block incremental index stores the location of blocks by checksum so blocks stored in any backup referenced by the current
+backup, or stored earlier in the current backup, can be used by the block incremental filter, not just blocks in the prior map of the
+same file. Each backup stores an index of the blocks it added to bundles. Blocks are only indexed when they are stored in a bundle
+since the repository path of a block in a non-bundled file depends on the name of the file. Lookups are limited to the backups in the
+reference list of the current backup, which is recorded as the backup reference list in backup.info, so expire always removes a
+backup together with every backup that may use its blocks.
+
+The main process loads the indexes of the referenced backups once and shares them, and the blocks stored by the current backup as
+they are added, with local processes in map files. A map file is a sorted array of BlockIndexItem that local processes map into
+memory read-only so the index is not loaded by each local process. Map files are only valid for the build that wrote them and are
+never stored in the repository.
+
+The index stored in the repository is a varint-128 encoded version and total followed by the blocks. Each block is stored as:
+
+  - Full (XX_HASH_SIZE_MAX) checksum.
+
+  - Varint-128 encoded block size shifted left by one with the low bit set when the blocks are variable size.
+
+  - Varint-128 encoded bundle id, offset, size, and super block size of the super block and the block no in the super block.
+
+  - Varint-128 encoded block offset and block size in the super block (variable blocks only).
+***********************************************************************************************************************************/
+#ifndef COMMAND_BACKUP_BLOCKINDEX_H
+#define COMMAND_BACKUP_BLOCKINDEX_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct BlockIndex BlockIndex;
+
+#include "command/backup/blockMap.h"
+#include "common/io/read.h"
+#include "common/io/write.h"
+#include "common/type/list.h"
+#include "common/type/object.h"
+#include "common/type/stringList.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define BLOCK_INDEX_FILE                                            "backup.block"
+
+typedef struct BlockIndexItem
+{
+    size_t blockSize;                                               // Block size used to store the block
+    BlockMapItem blockMapItem;                                      // Block map item with full checksum
+} BlockIndexItem;
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+// Create empty block index
+FN_EXTERN BlockIndex *blockIndexNew(void);
+
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+typedef struct BlockIndexPub
+{
+    List *itemList;                                                 // Items added to the index
+} BlockIndexPub;
+
+// Get a block index item
+FN_INLINE_ALWAYS const BlockIndexItem *
+blockIndexGet(const BlockIndex *const this, const unsigned int indexIdx)
+{
+    return (const BlockIndexItem *)lstGet(THIS_PUB(BlockIndex)->itemList, indexIdx);
+}
+
+// Block index size (excluding map files)
+FN_INLINE_ALWAYS unsigned int
+blockIndexSize(const BlockIndex *const this)
+{
+    return lstSize(THIS_PUB(BlockIndex)->itemList);
+}
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Add a block index item
+FN_INLINE_ALWAYS BlockIndexItem *
+blockIndexAdd(BlockIndex *const this, const BlockIndexItem *const item)
+{
+    ASSERT_INLINE(item != NULL);
+    return (BlockIndexItem *)lstAdd(THIS_PUB(BlockIndex)->itemList, item);
+}
+
+// Find the first item with the checksum in the sorted items and then in each map file for which the callback returns true. Returns
+// NULL when no item is found.
+typedef bool BlockIndexFindCallback(void *data, const BlockIndexItem *item);
+
+FN_EXTERN const BlockIndexItem *blockIndexFind(
+    const BlockIndex *this, const uint8_t *checksum, BlockIndexFindCallback *callback, void *callbackData);
+
+// Map the files in the list, which must have been written by blockIndexMapWrite(), and unmap files that are no longer in the list.
+// Files that do not exist are skipped since the main process may have replaced them.
+FN_EXTERN void blockIndexMapSet(BlockIndex *this, const StringList *fileList);
+
+// Total items in map files
+FN_EXTERN uint64_t blockIndexMapSize(const BlockIndex *this);
+
+// Write sorted items to a map file
+FN_EXTERN void blockIndexMapWrite(const BlockIndex *this, IoWrite *write);
+
+// Read items from IO and add them to the index with the specified reference
+FN_EXTERN void blockIndexRead(BlockIndex *this, IoRead *read, unsigned int reference);
+
+// Sort by checksum so items can be found
+FN_INLINE_ALWAYS void
+blockIndexSort(BlockIndex *const this)
+{
+    lstSort(THIS_PUB(BlockIndex)->itemList, sortOrderAsc);
+}
+
+// Write index to IO
+FN_EXTERN void blockIndexWrite(const BlockIndex *this, IoWrite *write);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+blockIndexFree(BlockIndex *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_BLOCK_INDEX_TYPE                                                                                              \
+    BlockIndex *
+#define FUNCTION_LOG_BLOCK_INDEX_FORMAT(value, buffer, bufferSize)                                                                 \
+    objNameToLog(value, "BlockIndex", buffer, bufferSize)
+
+#endif
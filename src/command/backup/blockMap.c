@@ -3,7 +3,13 @@ Block Incremental Map
 
 The block map is stored as a flag and a series of reference, super block, and block info:
 
-- Varint-128 flag that contains the version and info about the map (e.g. are the super blocks and blocks equal size).
+- Varint-128 flag that contains the version and info about the map (e.g. are the blocks variable size). The version flag is set
+  whenever any other flag is set. Versions that predate the other flags require the version flag to be zero, so they refuse maps
+  they cannot read rather than restoring the wrong data.
+
+- List of zero block runs when the map contains blocks that are all zeroes. Zero blocks are not stored in a super block so they
+  have no reference and are encoded as a Varint-128 run total followed by the Varint-128 encoded start of each run (as the delta
+  from the end of the prior run) and the run size minus one. When all blocks are zero no references are stored.
 
 - List of references:
 
@@ -13,6 +19,10 @@ The block map is stored as a flag and a series of reference, super block, and bl
     newer super block. The continuation allows the prior super block values for the reference to be used without encoding them
     again.
 
+  - Varint-128 encoded bundle id when a reference has blocks in more than one bundle. In this case the bundle id is always stored
+    and each reference/bundle id pair is treated as a separate reference. This happens when blocks are found in the block index
+    (see BlockIndex), which may contain blocks stored in any bundle of the backup.
+
   - List of super blocks:
 
     - Varint-128 encoded super block size. The very first size in the map will be encoded directly and subsequent sizes will be
@@ -23,9 +33,20 @@ The block map is stored as a flag and a series of reference, super block, and bl
       - Varint-128 encoded block number if super block size does not equal block size. If they are equal then there is one block per
         super block so no reason to encode the block number.
 
+      - Varint-128 encoded offset of the first block in the super block when blocks are variable size. The blocks that follow are
+        contiguous so their offsets can be calculated from the sizes.
+
       - Checksum.
 
+      - Varint-128 encoded block size when blocks are variable size.
+
 References, super blocks, and blocks are encoded with a bit that indicates when the last one has been reached.
+
+Variable size blocks are created by content-defined chunking (see BlockIncr filter). Since the number of blocks in a super block
+cannot be calculated from the super block size the block total is always stored for variable size blocks.
+
+Zero blocks are only stored for fixed size blocks since their position in the map determines their position in the file. The
+checksum of a zero block is not stored since it can be calculated from the block size.
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
@@ -50,9 +71,20 @@ References, super blocks, and blocks are encoded with a bit that indicates when
 
 typedef enum
 {
-    blockMapFlagVersion = 0,                                        // Version (currently always 0)
+    blockMapFlagVersion = 0,                                        // Version (set when any other flag is set)
+    blockMapFlagVariable = 1,                                       // Blocks are variable size
+    blockMapFlagBundle = 2,                                         // References may have blocks in more than one bundle
+    blockMapFlagZero = 3,                                           // Zero block runs are stored
+    blockMapFlagZeroAll = 4,                                        // All blocks are zero so no references are stored
 } BlockMapFlag;
 
+// Run of contiguous zero blocks
+typedef struct BlockMapZero
+{
+    unsigned int block;                                             // First block in the run
+    unsigned int size;                                              // Blocks in the run
+} BlockMapZero;
+
 // Stores current information about a reference to avoid needed to encode it again
 typedef struct BlockMapReference
 {
@@ -76,12 +108,50 @@ lstComparatorBlockMapReference(const void *const blockMapRef1, const void *const
     ASSERT(blockMapRef1 != NULL);
     ASSERT(blockMapRef2 != NULL);
 
-    const unsigned int reference1 = ((const BlockMapReference *)blockMapRef1)->reference;
-    const unsigned int reference2 = ((const BlockMapReference *)blockMapRef2)->reference;
+    const BlockMapReference *const reference1 = blockMapRef1;
+    const BlockMapReference *const reference2 = blockMapRef2;
+    int result = LST_COMPARATOR_CMP(reference1->reference, reference2->reference);
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(reference1->bundleId, reference2->bundleId);
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Add zero blocks that precede the next block to be added to the map
+***********************************************************************************************************************************/
+static void
+blockMapAddZero(BlockMap *const this, const List *const zeroList, unsigned int *const zeroIdx, const BlockMapItem *const zeroItem)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_MAP, this);
+        FUNCTION_TEST_PARAM(LIST, zeroList);
+        FUNCTION_TEST_PARAM_P(UINT, zeroIdx);
+        FUNCTION_TEST_PARAM_P(VOID, zeroItem);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(zeroIdx != NULL);
+    ASSERT(zeroItem != NULL);
+
+    while (zeroList != NULL && *zeroIdx < lstSize(zeroList))
+    {
+        const BlockMapZero *const zero = lstGet(zeroList, *zeroIdx);
+
+        if (zero->block != blockMapSize(this))
+            break;
+
+        for (unsigned int blockIdx = 0; blockIdx < zero->size; blockIdx++)
+            blockMapAdd(this, zeroItem);
+
+        (*zeroIdx)++;
+    }
 
-    FUNCTION_TEST_RETURN(INT, LST_COMPARATOR_CMP(reference1, reference2));
+    FUNCTION_TEST_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
 FN_EXTERN BlockMap *
 blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksumSize)
 {
@@ -89,23 +159,70 @@ blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksum
         FUNCTION_LOG_PARAM(IO_READ, map);
     FUNCTION_LOG_END();
 
-    // Read flags. Currently the version flag must always be zero. This may be used in the future to indicate if the map version
-    // has changed.
-    CHECK(FormatError, (ioReadVarIntU64(map) & (1 << blockMapFlagVersion)) == 0, "block map version must be zero");
+    // Read flags. The version flag must be set when any other flag is set.
+    const uint64_t flag = ioReadVarIntU64(map);
+    CHECK(FormatError, flag == 0 || (flag & (1 << blockMapFlagVersion)) != 0, "block map version must be set for flags");
+
+    const bool variable = flag & (1 << blockMapFlagVariable);
+    const bool bundle = flag & (1 << blockMapFlagBundle);
+    const bool zeroAll = flag & (1 << blockMapFlagZeroAll);
 
-    // Read all references in packed format
+    // Read zero block runs
     BlockMap *const this = blockMapNew();
-    List *const refList = lstNewP(sizeof(BlockMapReference), .comparator = lstComparatorBlockMapReference);
+    List *zeroList = NULL;
+    unsigned int zeroIdx = 0;
+    BlockMapItem zeroItem = {.zero = true};
+
+    if (flag & (1 << blockMapFlagZero))
+    {
+        const unsigned int zeroTotal = (unsigned int)ioReadVarIntU64(map);
+        unsigned int zeroBlock = 0;
+
+        zeroList = lstNewP(sizeof(BlockMapZero));
+
+        for (unsigned int zeroListIdx = 0; zeroListIdx < zeroTotal; zeroListIdx++)
+        {
+            BlockMapZero zero = {.block = zeroBlock + (unsigned int)ioReadVarIntU64(map)};
+            zero.size = (unsigned int)ioReadVarIntU64(map) + 1;
+
+            lstAdd(zeroList, &zero);
+            zeroBlock = zero.block + zero.size;
+        }
+
+        // Calculate the checksum of a zero block
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            Buffer *const zeroBlock = bufNew(blockSize);
+
+            memset(bufPtr(zeroBlock), 0, blockSize);
+            bufUsedSet(zeroBlock, blockSize);
+
+            const Buffer *const zeroChecksum = xxHashOne(checksumSize, zeroBlock);
+            memcpy(zeroItem.checksum, bufPtrConst(zeroChecksum), bufUsed(zeroChecksum));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    // Read all references in packed format. Reference/bundle id pairs are only distinct when the bundle id is stored for every
+    // reference, otherwise each reference has a single bundle id.
+    List *const refList = lstNewP(
+        sizeof(BlockMapReference), .comparator = bundle ? lstComparatorBlockMapReference : lstComparatorUInt);
     Buffer *const checksum = bufNew(checksumSize);
     int64_t sizeLast = 0;
     bool referenceContinue = false;
 
-    do
+    while (!zeroAll)
     {
         // Read reference
         const uint64_t referenceEncoded = ioReadVarIntU64(map);
         BlockMapItem blockMapItem = {.reference = (unsigned int)(referenceEncoded >> BLOCK_MAP_REFERENCE_SHIFT)};
-        BlockMapReference *referenceData = lstFind(refList, &(BlockMapReference){.reference = blockMapItem.reference});
+
+        // Read bundle id when it is stored for every reference
+        if (bundle)
+            blockMapItem.bundleId = ioReadVarIntU64(map);
+
+        BlockMapReference *referenceData = lstFind(
+            refList, &(BlockMapReference){.reference = blockMapItem.reference, .bundleId = blockMapItem.bundleId});
 
         // If this is the first time this reference has been read
         if (referenceData == NULL)
@@ -226,6 +343,10 @@ blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksum
             else
                 blockTotal = blockMapItem.superBlockSize / blockSize + (blockMapItem.superBlockSize % blockSize == 0 ? 0 : 1);
 
+            // Read offset of the first block when blocks are variable size
+            if (variable)
+                blockMapItem.blockOffset = ioReadVarIntU64(map);
+
             // Read checksums
             for (uint64_t blockIdx = 0; blockIdx < blockTotal; blockIdx++)
             {
@@ -237,7 +358,17 @@ blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksum
                 ioRead(map, checksum);
                 memcpy(blockMapItem.checksum, bufPtr(checksum), bufUsed(checksum));
 
-                // Add to block list
+                // Read size and calculate offset of the next block when blocks are variable size
+                if (variable)
+                {
+                    if (blockIdx != 0)
+                        blockMapItem.blockOffset += blockMapItem.blockSize;
+
+                    blockMapItem.blockSize = ioReadVarIntU64(map);
+                }
+
+                // Add to block list after any zero blocks that precede it
+                blockMapAddZero(this, zeroList, &zeroIdx, &zeroItem);
                 lstAdd((List *)this, &blockMapItem);
             }
 
@@ -257,14 +388,40 @@ blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksum
         if (referenceEncoded & BLOCK_MAP_FLAG_LAST)
             break;
     }
-    while (true);
 
+    // Add zero blocks at the end of the map
+    blockMapAddZero(this, zeroList, &zeroIdx, &zeroItem);
+    CHECK(FormatError, zeroList == NULL || zeroIdx == lstSize(zeroList), "block map zero runs are out of order");
+
+    lstFree(zeroList);
     lstFree(refList);
     bufFree(checksum);
 
     FUNCTION_LOG_RETURN(BLOCK_MAP, this);
 }
 
+/***********************************************************************************************************************************
+Write reference followed by the bundle id when it is stored for every reference
+***********************************************************************************************************************************/
+static void
+blockMapWriteReference(
+    IoWrite *const output, const uint64_t referenceEncoded, const BlockMapItem *const reference, const bool bundle)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_WRITE, output);
+        FUNCTION_TEST_PARAM(UINT64, referenceEncoded);
+        FUNCTION_TEST_PARAM_P(VOID, reference);
+        FUNCTION_TEST_PARAM(BOOL, bundle);
+    FUNCTION_TEST_END();
+
+    ioWriteVarIntU64(output, referenceEncoded | reference->reference << BLOCK_MAP_REFERENCE_SHIFT);
+
+    if (bundle)
+        ioWriteVarIntU64(output, reference->bundleId);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t blockSize, const size_t checksumSize)
@@ -281,49 +438,144 @@ blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t bl
     ASSERT(blockSize > 0);
     ASSERT(output != NULL);
 
-    // Write flags
-    ioWriteVarIntU64(output, 0);
+    // Build zero block runs and a map without zero blocks since zero blocks are not stored in a super block
+    BlockMap *mapNoZero = NULL;
+    List *zeroList = NULL;
+
+    for (unsigned int blockMapIdx = 0; blockMapIdx < blockMapSize(this); blockMapIdx++)
+    {
+        const BlockMapItem *const blockMapItem = blockMapGet(this, blockMapIdx);
+
+        if (blockMapItem->zero)
+        {
+            // Create the run list and copy non-zero blocks found so far into the new map
+            if (zeroList == NULL)
+            {
+                zeroList = lstNewP(sizeof(BlockMapZero));
+                mapNoZero = blockMapNew();
+
+                for (unsigned int blockMapCopyIdx = 0; blockMapCopyIdx < blockMapIdx; blockMapCopyIdx++)
+                    blockMapAdd(mapNoZero, blockMapGet(this, blockMapCopyIdx));
+            }
+
+            // Extend the current run or start a new one
+            BlockMapZero *const zeroLast = lstEmpty(zeroList) ? NULL : lstGetLast(zeroList);
+
+            if (zeroLast != NULL && zeroLast->block + zeroLast->size == blockMapIdx)
+                zeroLast->size++;
+            else
+                lstAdd(zeroList, &(BlockMapZero){.block = blockMapIdx, .size = 1});
+        }
+        else if (zeroList != NULL)
+            blockMapAdd(mapNoZero, blockMapItem);
+    }
+
+    const BlockMap *const map = mapNoZero != NULL ? mapNoZero : this;
+
+    // Determine if any reference has blocks in more than one bundle
+    const bool variable = blockMapVariable(map);
+    bool bundle = false;
+
+    ASSERT(!variable || zeroList == NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        List *const bundleList = lstNewP(sizeof(BlockMapReference), .comparator = lstComparatorUInt);
+
+        for (unsigned int blockMapIdx = 0; blockMapIdx < blockMapSize(map); blockMapIdx++)
+        {
+            const BlockMapItem *const blockMapItem = blockMapGet(map, blockMapIdx);
+            const BlockMapReference *const bundleData = lstFind(
+                bundleList, &(BlockMapReference){.reference = blockMapItem->reference});
+
+            if (bundleData == NULL)
+                lstAdd(bundleList, &(BlockMapReference){.reference = blockMapItem->reference, .bundleId = blockMapItem->bundleId});
+            else if (bundleData->bundleId != blockMapItem->bundleId)
+            {
+                bundle = true;
+                break;
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    // Write flags. Set the version flag when any other flag is set so versions that do not understand the flags refuse the map.
+    uint64_t flag =
+        (variable ? 1 << blockMapFlagVariable : 0) | (bundle ? 1 << blockMapFlagBundle : 0) |
+        (zeroList != NULL ? 1 << blockMapFlagZero : 0) | (blockMapSize(map) == 0 ? 1 << blockMapFlagZeroAll : 0);
+
+    if (flag != 0)
+        flag |= 1 << blockMapFlagVersion;
+
+    ioWriteVarIntU64(output, flag);
+
+    // Write zero block runs
+    if (zeroList != NULL)
+    {
+        unsigned int zeroBlock = 0;
+
+        ioWriteVarIntU64(output, lstSize(zeroList));
+
+        for (unsigned int zeroIdx = 0; zeroIdx < lstSize(zeroList); zeroIdx++)
+        {
+            const BlockMapZero *const zero = lstGet(zeroList, zeroIdx);
+
+            ioWriteVarIntU64(output, zero->block - zeroBlock);
+            ioWriteVarIntU64(output, zero->size - 1);
+
+            zeroBlock = zero->block + zero->size;
+        }
+    }
 
     // Write all references in packed format
-    List *const refList = lstNewP(sizeof(BlockMapReference), .comparator = lstComparatorBlockMapReference);
+    List *const refList = lstNewP(
+        sizeof(BlockMapReference), .comparator = bundle ? lstComparatorBlockMapReference : lstComparatorUInt);
     unsigned int referenceIdx = 0;
     int64_t sizeLast = 0;
     bool referenceContinue = false;
 
-    while (referenceIdx < blockMapSize(this))
+    while (referenceIdx < blockMapSize(map))
     {
-        const BlockMapItem *const reference = blockMapGet(this, referenceIdx);
+        const BlockMapItem *const reference = blockMapGet(map, referenceIdx);
         unsigned int superBlockIdx = referenceIdx;
         unsigned int blockIdx = referenceIdx;
 
         // Determine if this is the last reference
         uint64_t referenceEncoded = BLOCK_MAP_FLAG_LAST;
 
-        for (referenceIdx++; referenceIdx < blockMapSize(this); referenceIdx++)
+        for (referenceIdx++; referenceIdx < blockMapSize(map); referenceIdx++)
         {
-            if (reference->reference != blockMapGet(this, referenceIdx)->reference)
+            const BlockMapItem *const block = blockMapGet(map, referenceIdx);
+            const BlockMapItem *const blockPrior = blockMapGet(map, referenceIdx - 1);
+
+            // The reference also ends when blocks are skipped in the super block or a super block is skipped. This can happen when
+            // blocks are variable size since they are matched by checksum rather than position.
+            if (reference->reference != block->reference || reference->bundleId != block->bundleId ||
+                (block->offset == blockPrior->offset && block->block != blockPrior->block + 1) ||
+                (block->offset != blockPrior->offset && block->offset != blockPrior->offset + blockPrior->size))
             {
                 referenceEncoded = 0;
                 break;
             }
 
-            ASSERT(reference->offset <= blockMapGet(this, referenceIdx)->offset);
+            ASSERT(reference->offset <= block->offset);
         }
 
         // If this is the first time this reference has been written
-        BlockMapReference *referenceData = lstFind(refList, &(BlockMapReference){.reference = reference->reference});
+        BlockMapReference *referenceData = lstFind(
+            refList, &(BlockMapReference){.reference = reference->reference, .bundleId = reference->bundleId});
 
         if (referenceData == NULL)
         {
             // Add bundle id and offset flags
-            if (reference->bundleId > 0)
+            if (!bundle && reference->bundleId > 0)
                 referenceEncoded |= BLOCK_MAP_FLAG_BUNDLE_ID;
 
             if (reference->offset > 0)
                 referenceEncoded |= BLOCK_MAP_FLAG_OFFSET;
 
             // Write the references
-            ioWriteVarIntU64(output, referenceEncoded | reference->reference << BLOCK_MAP_REFERENCE_SHIFT);
+            blockMapWriteReference(output, referenceEncoded, reference, bundle);
 
             // Write bundle id and offset
             if (referenceEncoded & BLOCK_MAP_FLAG_BUNDLE_ID)
@@ -367,7 +619,7 @@ blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t bl
                 if (reference->offset > referenceData->offset + referenceData->size)
                     referenceEncoded |= BLOCK_MAP_FLAG_OFFSET;
 
-                ioWriteVarIntU64(output, referenceEncoded | reference->reference << BLOCK_MAP_REFERENCE_SHIFT);
+                blockMapWriteReference(output, referenceEncoded, reference, bundle);
 
                 if (referenceEncoded & BLOCK_MAP_FLAG_OFFSET)
                     ioWriteVarIntU64(output, reference->offset - (referenceData->offset + referenceData->size));
@@ -380,14 +632,14 @@ blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t bl
         // Write all super blocks in the current reference in packed format
         while (superBlockIdx < referenceIdx)
         {
-            const BlockMapItem *const superBlock = blockMapGet(this, superBlockIdx);
+            const BlockMapItem *const superBlock = blockMapGet(map, superBlockIdx);
 
             // Determine if this is the last super block in the reference
             uint64_t superBlockEncoded = BLOCK_MAP_FLAG_LAST;
 
             for (superBlockIdx++; superBlockIdx < referenceIdx; superBlockIdx++)
             {
-                if (superBlock->offset != blockMapGet(this, superBlockIdx)->offset)
+                if (superBlock->offset != blockMapGet(map, superBlockIdx)->offset)
                 {
                     superBlockEncoded = 0;
                     break;
@@ -398,7 +650,7 @@ blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t bl
             const unsigned int blockTotal = superBlockIdx - blockIdx;
             ASSERT(blockTotal > 0);
 
-            if (referenceContinue || superBlock->block != 0 ||
+            if (variable || referenceContinue || superBlock->block != 0 ||
                 blockTotal != superBlock->superBlockSize / blockSize + (superBlock->superBlockSize % blockSize == 0 ? 0 : 1))
             {
                 superBlockEncoded |= BLOCK_MAP_FLAG_SUPER_BLOCK_TOTAL_OFFSET;
@@ -412,7 +664,7 @@ blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t bl
                 if (superBlockEncoded & BLOCK_MAP_FLAG_LAST)
                     referenceEncoded |= BLOCK_MAP_FLAG_CONTINUE_LAST;
 
-                ioWriteVarIntU64(output, referenceEncoded | reference->reference << BLOCK_MAP_REFERENCE_SHIFT);
+                blockMapWriteReference(output, referenceEncoded, reference, bundle);
                 referenceContinue = false;
             }
             // Else write the super block size for the reference
@@ -480,19 +732,38 @@ blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t bl
             // Increment reference block by number of blocks written
             referenceData->block += blockTotal;
 
+            // Write offset of the first block when blocks are variable size
+            if (variable)
+                ioWriteVarIntU64(output, superBlock->blockOffset);
+
             // Write checksums
             for (; blockIdx < superBlockIdx; blockIdx++)
             {
+                const BlockMapItem *const block = blockMapGet(map, blockIdx);
+
+                ASSERT(superBlock == block || (blockIdx > 0 && (block->block == blockMapGet(map, blockIdx - 1)->block + 1)));
                 ASSERT(
-                    superBlock == blockMapGet(this, blockIdx) ||
-                    (blockIdx > 0 && (blockMapGet(this, blockIdx)->block == blockMapGet(this, blockIdx - 1)->block + 1)));
+                    superBlock == block || !variable ||
+                    block->blockOffset ==
+                        blockMapGet(map, blockIdx - 1)->blockOffset + blockMapGet(map, blockIdx - 1)->blockSize);
+
+                ioWrite(output, BUF(block->checksum, checksumSize));
 
-                ioWrite(output, BUF(blockMapGet(this, blockIdx)->checksum, checksumSize));
+                // Write block size when blocks are variable size
+                if (variable)
+                {
+                    ASSERT(block->blockSize > 0);
+                    ioWriteVarIntU64(output, block->blockSize);
+                }
             }
         }
     }
 
     lstFree(refList);
 
+    // Free the zero block runs and the map without zero blocks
+    lstFree(zeroList);
+    blockMapFree(mapNoZero);
+
     FUNCTION_LOG_RETURN_VOID();
 }
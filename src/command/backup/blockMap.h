@@ -25,7 +25,10 @@ typedef struct BlockMapItem
     uint64_t offset;                                                // Offset of super block into the bundle
     uint64_t size;                                                  // Stored super block size (with compression, etc.)
     uint64_t block;                                                 // Block no inside of super block
+    uint64_t blockOffset;                                           // Block offset inside of super block (variable blocks only)
+    uint64_t blockSize;                                             // Block size (variable blocks only)
     uint8_t checksum[XX_HASH_SIZE_MAX];                             // Checksum of the block
+    bool zero;                                                      // Block is all zeroes and is not stored (fixed blocks only)
 } BlockMapItem;
 
 /***********************************************************************************************************************************
@@ -72,6 +75,13 @@ blockMapSize(const BlockMap *const this)
     return lstSize((const List *const)this);
 }
 
+// Are the blocks variable size? Blocks in a map are either all fixed size or all variable size.
+FN_INLINE_ALWAYS bool
+blockMapVariable(const BlockMap *const this)
+{
+    return blockMapSize(this) > 0 && blockMapGet(this, 0)->blockSize != 0;
+}
+
 /***********************************************************************************************************************************
 Destructor
 ***********************************************************************************************************************************/
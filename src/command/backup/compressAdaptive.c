@@ -0,0 +1,257 @@
+/***********************************************************************************************************************************
+Adaptive Compress Filter
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "command/backup/compressAdaptive.h"
+#include "common/debug.h"
+#include "common/io/bufferRead.h"
+#include "common/io/filter/filter.h"
+#include "common/io/filter/size.h"
+#include "common/io/io.h"
+#include "common/log.h"
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct CompressAdaptive
+{
+    CompressType type;                                              // Compress type
+    int level;                                                      // Compress level
+    bool raw;                                                       // Omit headers, checksum, etc. when possible
+    unsigned int thread;                                            // Threads to use for compression
+
+    bool decided;                                                   // Has compressibility been determined?
+    IoFilter *compress;                                             // Compress filter (NULL when passing input through)
+
+    size_t inputOffset;                                             // Offset in input when passing input through
+    bool inputSame;                                                 // Is the same input required again?
+} CompressAdaptive;
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+static void
+compressAdaptiveToLog(const CompressAdaptive *const this, StringStatic *const debugLog)
+{
+    strStcFmt(
+        debugLog, "{decided: %s, compress: %s, inputSame: %s}", cvtBoolToConstZ(this->decided),
+        cvtBoolToConstZ(this->compress != NULL), cvtBoolToConstZ(this->inputSame));
+}
+
+#define FUNCTION_LOG_COMPRESS_ADAPTIVE_TYPE                                                                                        \
+    CompressAdaptive *
+#define FUNCTION_LOG_COMPRESS_ADAPTIVE_FORMAT(value, buffer, bufferSize)                                                           \
+    FUNCTION_LOG_OBJECT_FORMAT(value, compressAdaptiveToLog, buffer, bufferSize)
+
+/***********************************************************************************************************************************
+Decide on compression using the first input and then compress or pass through
+***********************************************************************************************************************************/
+static void
+compressAdaptiveProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
+{
+    THIS(CompressAdaptive);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(COMPRESS_ADAPTIVE, this);
+        FUNCTION_LOG_PARAM(BUFFER, input);
+        FUNCTION_LOG_PARAM(BUFFER, output);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(output != NULL);
+
+    // Estimate compressibility by compressing the first input. Empty files are compressed so they follow the usual path.
+    if (!this->decided)
+    {
+        bool compressible = true;
+
+        if (input != NULL)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                IoRead *const read = ioBufferReadNew(input);
+                ioFilterGroupAdd(ioReadFilterGroup(read), compressFilterP(this->type, this->level, .raw = true));
+                ioFilterGroupAdd(ioReadFilterGroup(read), ioSizeNew());
+                ioReadDrain(read);
+
+                compressible =
+                    pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE)) * 100 <
+                        bufUsed(input) * COMPRESS_ADAPTIVE_RATIO_MAX;
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+
+        if (compressible)
+        {
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->compress = compressFilterP(this->type, this->level, .raw = this->raw, .thread = this->thread);
+            }
+            MEM_CONTEXT_OBJ_END();
+        }
+
+        this->decided = true;
+    }
+
+    // Compress input
+    if (this->compress != NULL)
+    {
+        ioFilterProcessInOut(this->compress, input, output);
+    }
+    // Else pass input through as much as will fit in the output. There is nothing to flush so input is never NULL here.
+    else
+    {
+        ASSERT(input != NULL);
+
+        size_t copySize = bufUsed(input) - this->inputOffset;
+
+        if (copySize > bufRemains(output))
+            copySize = bufRemains(output);
+
+        bufCatSub(output, input, this->inputOffset, copySize);
+        this->inputOffset += copySize;
+
+        this->inputSame = this->inputOffset < bufUsed(input);
+
+        if (!this->inputSame)
+            this->inputOffset = 0;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is the filter done?
+***********************************************************************************************************************************/
+static bool
+compressAdaptiveDone(const THIS_VOID)
+{
+    THIS(const CompressAdaptive);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(COMPRESS_ADAPTIVE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->compress != NULL ? ioFilterDone(this->compress) : this->decided);
+}
+
+/***********************************************************************************************************************************
+Is the same input required again?
+***********************************************************************************************************************************/
+static bool
+compressAdaptiveInputSame(const THIS_VOID)
+{
+    THIS(const CompressAdaptive);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(COMPRESS_ADAPTIVE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->compress != NULL ? ioFilterInputSame(this->compress) : this->inputSame);
+}
+
+/***********************************************************************************************************************************
+Return true when the input was compressed
+***********************************************************************************************************************************/
+static Pack *
+compressAdaptiveResult(THIS_VOID)
+{
+    THIS(CompressAdaptive);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(COMPRESS_ADAPTIVE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->decided);
+
+    Pack *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const packWrite = pckWriteNewP();
+
+        pckWriteBoolP(packWrite, this->compress != NULL, .defaultWrite = true);
+        pckWriteEndP(packWrite);
+
+        result = pckMove(pckWriteResult(packWrite), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN IoFilter *
+compressAdaptiveNew(const CompressType type, const int level, const bool raw, const unsigned int thread)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ENUM, type);
+        FUNCTION_LOG_PARAM(INT, level);
+        FUNCTION_LOG_PARAM(BOOL, raw);
+        FUNCTION_LOG_PARAM(UINT, thread);
+    FUNCTION_LOG_END();
+
+    ASSERT(type != compressTypeNone);
+
+    OBJ_NEW_BEGIN(CompressAdaptive, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (CompressAdaptive)
+        {
+            .type = type,
+            .level = level,
+            .raw = raw,
+            .thread = thread,
+        };
+    }
+    OBJ_NEW_END();
+
+    // Create param list
+    Pack *paramList;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const packWrite = pckWriteNewP();
+
+        pckWriteU32P(packWrite, type);
+        pckWriteI32P(packWrite, level);
+        pckWriteBoolP(packWrite, raw);
+        pckWriteU32P(packWrite, thread);
+        pckWriteEndP(packWrite);
+
+        paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(
+        IO_FILTER,
+        ioFilterNewP(
+            COMPRESS_ADAPTIVE_FILTER_TYPE, this, paramList, .done = compressAdaptiveDone, .inOut = compressAdaptiveProcess,
+            .inputSame = compressAdaptiveInputSame, .result = compressAdaptiveResult));
+}
+
+FN_EXTERN IoFilter *
+compressAdaptiveNewPack(const Pack *const paramList)
+{
+    IoFilter *result;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackRead *const paramListPack = pckReadNew(paramList);
+        const CompressType type = (CompressType)pckReadU32P(paramListPack);
+        const int level = pckReadI32P(paramListPack);
+        const bool raw = pckReadBoolP(paramListPack);
+        const unsigned int thread = pckReadU32P(paramListPack);
+
+        result = ioFilterMove(compressAdaptiveNew(type, level, raw, thread), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    return result;
+}
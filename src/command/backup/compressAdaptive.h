@@ -0,0 +1,30 @@
+/***********************************************************************************************************************************
+Adaptive Compress Filter
+
+Compress a file only when it is compressible. The first buffer of input is compressed separately to estimate compressibility and the
+file is then either compressed with the specified type and level or passed through unmodified. This allows the decision to be made
+in the copy pipeline without reading the file twice. The filter returns true when the file was compressed.
+***********************************************************************************************************************************/
+#ifndef COMMAND_BACKUP_COMPRESS_ADAPTIVE_H
+#define COMMAND_BACKUP_COMPRESS_ADAPTIVE_H
+
+#include "common/compress/helper.h"
+#include "common/io/filter/filter.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define COMPRESS_ADAPTIVE_FILTER_TYPE                               STRID5("cmp-adapt", 0x1480481dc1a30)
+
+/***********************************************************************************************************************************
+Files that do not compress to less than this percentage of their original size are passed through without compression
+***********************************************************************************************************************************/
+#define COMPRESS_ADAPTIVE_RATIO_MAX                                 98
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+FN_EXTERN IoFilter *compressAdaptiveNew(CompressType type, int level, bool raw, unsigned int thread);
+FN_EXTERN IoFilter *compressAdaptiveNewPack(const Pack *paramList);
+
+#endif
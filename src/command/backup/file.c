@@ -6,6 +6,7 @@ Backup File
 #include <string.h>
 
 #include "command/backup/blockIncr.h"
+#include "command/backup/compressAdaptive.h"
 #include "command/backup/file.h"
 #include "command/backup/pageChecksum.h"
 #include "common/crypto/cipherBlock.h"
@@ -40,7 +41,8 @@ segmentNumber(const String *const pgFile)
 FN_EXTERN List *
 backupFile(
     const String *const repoFile, const uint64_t bundleId, const bool bundleRaw, const unsigned int blockIncrReference,
-    const CompressType repoFileCompressType, const int repoFileCompressLevel, const CipherType cipherType,
+    const BlockIndex *const blockIncrIndex, const CompressType repoFileCompressType, const int repoFileCompressLevel,
+    const unsigned int repoFileCompressThread, const bool compressAdaptive, const CipherType cipherType,
     const String *const cipherPass, const String *const pgVersionForce, const PgPageSize pageSize, const List *const fileList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
@@ -48,8 +50,11 @@ backupFile(
         FUNCTION_LOG_PARAM(UINT64, bundleId);                       // Bundle id (0 if none)
         FUNCTION_LOG_PARAM(BOOL, bundleRaw);                        // Raw compress/encrypt format in bundles?
         FUNCTION_LOG_PARAM(UINT, blockIncrReference);               // Block incremental reference to use in map
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, blockIncrIndex);            // Block index (NULL if not enabled)
         FUNCTION_LOG_PARAM(ENUM, repoFileCompressType);             // Compress type for repo file
         FUNCTION_LOG_PARAM(INT, repoFileCompressLevel);             // Compression level for repo file
+        FUNCTION_LOG_PARAM(UINT, repoFileCompressThread);           // Compression threads for repo file
+        FUNCTION_LOG_PARAM(BOOL, compressAdaptive);                 // Store incompressible files without compression?
         FUNCTION_LOG_PARAM(STRING_ID, cipherType);                  // Encryption type
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to access the repo file if encrypted
         FUNCTION_LOG_PARAM(ENUM, pageSize);                         // Page size
@@ -61,6 +66,7 @@ backupFile(
     ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
     ASSERT(fileList != NULL && !lstEmpty(fileList));
     ASSERT(pgPageSizeValid(pageSize));
+    ASSERT(!compressAdaptive || (bundleId != 0 && repoFileCompressType != compressTypeNone));
 
     // Backup file results
     List *const result = lstNewP(sizeof(BackupFileResult));
@@ -199,9 +205,10 @@ backupFile(
                     // replayed from WAL during recovery. pg_control requires special handling since it needs to be retried on crc
                     // validation failure.
                     bool repoChecksum = false;
+                    const bool pgControl = strEqZ(file->pgFile, PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL);
                     IoRead *readIo;
 
-                    if (strEqZ(file->pgFile, PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL))
+                    if (pgControl)
                         readIo = ioBufferReadNew(pgControlBufferFromFile(storagePg(), pgVersionForce));
                     else
                     {
@@ -224,12 +231,25 @@ backupFile(
                                 file->pgFilePageHeaderCheck, storagePathP(storagePg(), file->pgFile)));
                     }
 
-                    // Compress filter
-                    IoFilter *const compress =
-                        repoFileCompressType != compressTypeNone ?
-                            compressFilterP(
-                                repoFileCompressType, repoFileCompressLevel, .raw = bundleRaw || file->blockIncrSize != 0) :
-                            NULL;
+                    // Store the file without compression when adaptive compression estimates from the first buffer that it is
+                    // incompressible. Block incremental is excluded because each super block is compressed separately.
+                    const bool adaptive = compressAdaptive && file->blockIncrSize == 0 && !pgControl;
+
+                    // Compress filter. Threads are only used when the entire file is compressed as a single stream since block
+                    // incremental compresses each super block separately and they are too small to benefit.
+                    IoFilter *compress = NULL;
+
+                    if (adaptive)
+                    {
+                        compress = compressAdaptiveNew(
+                            repoFileCompressType, repoFileCompressLevel, bundleRaw, repoFileCompressThread);
+                    }
+                    else if (repoFileCompressType != compressTypeNone)
+                    {
+                        compress = compressFilterP(
+                            repoFileCompressType, repoFileCompressLevel, .raw = bundleRaw || file->blockIncrSize != 0,
+                            .thread = file->blockIncrSize == 0 ? repoFileCompressThread : 0);
+                    }
 
                     // Encrypt filter
                     IoFilter *const encrypt =
@@ -265,8 +285,9 @@ backupFile(
                         ioFilterGroupAdd(
                             ioReadFilterGroup(readIo),
                             blockIncrNew(
-                                file->blockIncrSuperSize, file->blockIncrSize, file->blockIncrChecksumSize, blockIncrReference,
-                                bundleId, bundleOffset, blockMap, compress, encrypt));
+                                file->blockIncrSuperSize, file->blockIncrSize, file->blockIncrChecksumSize, file->blockIncrCdc,
+                                blockIncrReference, bundleId, bundleOffset, blockMap, file->blockIncrMapPriorLsn, pageSize,
+                                blockIncrIndex, compress, encrypt));
 
                         repoChecksum = true;
                     }
@@ -399,6 +420,13 @@ backupFile(
                                 fileResult->repoSize = pckReadU64P(
                                     ioFilterGroupResultP(ioReadFilterGroup(readIo), SIZE_FILTER_TYPE, .idx = 1));
 
+                                // Was the file stored without compression?
+                                if (adaptive)
+                                {
+                                    fileResult->compressNone = !pckReadBoolP(
+                                        ioFilterGroupResultP(ioReadFilterGroup(readIo), COMPRESS_ADAPTIVE_FILTER_TYPE));
+                                }
+
                                 // Get results of page checksum validation
                                 if (file->pgFileChecksumPage)
                                 {
@@ -409,8 +437,11 @@ backupFile(
                                 // Get results of block incremental
                                 if (file->blockIncrSize != 0)
                                 {
-                                    fileResult->blockIncrMapSize = pckReadU64P(
-                                        ioFilterGroupResultP(ioReadFilterGroup(readIo), BLOCK_INCR_FILTER_TYPE));
+                                    PackRead *const blockIncrResult = ioFilterGroupResultP(
+                                        ioReadFilterGroup(readIo), BLOCK_INCR_FILTER_TYPE);
+
+                                    fileResult->blockIncrMapSize = pckReadU64P(blockIncrResult);
+                                    fileResult->blockIncrIndex = pckReadBinP(blockIncrResult);
 
                                     // There must be a map because the file should have changed or shrunk
                                     ASSERT(fileResult->blockIncrMapSize > 0);
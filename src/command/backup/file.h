@@ -4,6 +4,7 @@ Backup File
 #ifndef COMMAND_BACKUP_FILE_H
 #define COMMAND_BACKUP_FILE_H
 
+#include "command/backup/blockIndex.h"
 #include "common/compress/helper.h"
 #include "common/crypto/common.h"
 #include "common/type/keyValue.h"
@@ -39,9 +40,11 @@ typedef struct BackupFile
     size_t blockIncrSize;                                           // Perform block incremental on this file?
     size_t blockIncrChecksumSize;                                   // Block checksum size
     uint64_t blockIncrSuperSize;                                    // Size of the super block
+    bool blockIncrCdc;                                              // Use content-defined chunking for blocks?
     const String *blockIncrMapPriorFile;                            // File containing prior block incremental map (NULL if none)
     uint64_t blockIncrMapPriorOffset;                               // Offset of prior block incremental map
     uint64_t blockIncrMapPriorSize;                                 // Size of prior block incremental map
+    uint64_t blockIncrMapPriorLsn;                                  // Start lsn of backup that stored prior map (0 if no lsn check)
     const String *manifestFile;                                     // Repo file
     const Buffer *repoFileChecksum;                                 // Expected repo file checksum
     uint64_t repoFileSize;                                          // Expected repo file size
@@ -59,13 +62,15 @@ typedef struct BackupFileResult
     const Buffer *repoChecksum;                                     // Checksum of repo file (including compression, etc.)
     uint64_t bundleOffset;                                          // Offset in bundle if any
     uint64_t repoSize;
+    bool compressNone;                                              // Stored without compression (incompressible)
     uint64_t blockIncrMapSize;                                      // Size of block incremental map (0 if no map)
+    const Buffer *blockIncrIndex;                                   // New blocks to add to the block index (NULL if none)
     Pack *pageChecksumResult;
 } BackupFileResult;
 
 FN_EXTERN List *backupFile(
-    const String *repoFile, uint64_t bundleId, bool bundleRaw, unsigned int blockIncrReference, CompressType repoFileCompressType,
-    int repoFileCompressLevel, CipherType cipherType, const String *cipherPass, const String *pgVersionForce, PgPageSize pageSize,
-    const List *fileList);
+    const String *repoFile, uint64_t bundleId, bool bundleRaw, unsigned int blockIncrReference, const BlockIndex *blockIncrIndex,
+    CompressType repoFileCompressType, int repoFileCompressLevel, unsigned int repoFileCompressThread, bool compressAdaptive,
+    CipherType cipherType, const String *cipherPass, const String *pgVersionForce, PgPageSize pageSize, const List *fileList);
 
 #endif
@@ -3,6 +3,7 @@ Backup Protocol Handler
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include "command/backup/blockIndex.h"
 #include "command/backup/file.h"
 #include "command/backup/protocol.h"
 #include "common/crypto/hash.h"
@@ -14,6 +15,72 @@ Backup Protocol Handler
 #include "config/config.h"
 #include "storage/helper.h"
 
+/***********************************************************************************************************************************
+Local variables
+***********************************************************************************************************************************/
+static struct BackupProtocolLocal
+{
+    MemContext *memContext;                                         // Mem context
+    BlockIndex *blockIndex;                                         // Block index
+    String *pathListPath;                                           // Path being listed (NULL when no path is being listed)
+    StringList *pathListName;                                       // Sorted names in the path being listed
+    unsigned int pathListNameIdx;                                   // Next name to get detail for
+} backupProtocolLocal;
+
+/***********************************************************************************************************************************
+Initialize mem context
+***********************************************************************************************************************************/
+static void
+backupProtocolLocalInit(void)
+{
+    FUNCTION_TEST_VOID();
+
+    if (backupProtocolLocal.memContext == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            MEM_CONTEXT_NEW_BEGIN(BackupProtocol, .childQty = MEM_CONTEXT_QTY_MAX)
+            {
+                backupProtocolLocal.memContext = MEM_CONTEXT_NEW();
+            }
+            MEM_CONTEXT_NEW_END();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Map the block index files written by the main process. The index is kept between jobs so only files that are new to this process are
+mapped.
+***********************************************************************************************************************************/
+static const BlockIndex *
+backupFileBlockIndex(const StringList *const fileList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileList);
+    FUNCTION_LOG_END();
+
+    ASSERT(fileList != NULL);
+
+    // Initialize index
+    if (backupProtocolLocal.blockIndex == NULL)
+    {
+        backupProtocolLocalInit();
+
+        MEM_CONTEXT_BEGIN(backupProtocolLocal.memContext)
+        {
+            backupProtocolLocal.blockIndex = blockIndexNew();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    blockIndexMapSet(backupProtocolLocal.blockIndex, fileList);
+
+    FUNCTION_LOG_RETURN_CONST(BLOCK_INDEX, backupProtocolLocal.blockIndex);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN ProtocolServerResult *
 backupFileProtocol(PackRead *const param)
@@ -35,10 +102,13 @@ backupFileProtocol(PackRead *const param)
         const unsigned int blockIncrReference = (unsigned int)pckReadU64P(param);
         const CompressType repoFileCompressType = (CompressType)pckReadU32P(param);
         const int repoFileCompressLevel = pckReadI32P(param);
+        const unsigned int repoFileCompressThread = pckReadU32P(param);
+        const bool compressAdaptive = pckReadBoolP(param);
         const CipherType cipherType = (CipherType)pckReadU64P(param);
         const String *const cipherPass = pckReadStrP(param);
         const PgPageSize pageSize = pckReadU32P(param);
         const String *const pgVersionForce = pckReadStrP(param);
+        const StringList *const blockIncrIndexFileList = pckReadStrLstP(param);
 
         // Build the file list
         List *const fileList = lstNewP(sizeof(BackupFile));
@@ -60,12 +130,14 @@ backupFileProtocol(PackRead *const param)
             {
                 file.blockIncrChecksumSize = (size_t)pckReadU64P(param);
                 file.blockIncrSuperSize = pckReadU64P(param);
+                file.blockIncrCdc = pckReadBoolP(param);
                 file.blockIncrMapPriorFile = pckReadStrP(param);
 
                 if (file.blockIncrMapPriorFile != NULL)
                 {
                     file.blockIncrMapPriorOffset = pckReadU64P(param);
                     file.blockIncrMapPriorSize = pckReadU64P(param);
+                    file.blockIncrMapPriorLsn = pckReadU64P(param);
                 }
             }
 
@@ -80,7 +152,9 @@ backupFileProtocol(PackRead *const param)
 
         // Backup file
         const List *const resultList = backupFile(
-            repoFile, bundleId, bundleRaw, blockIncrReference, repoFileCompressType, repoFileCompressLevel, cipherType, cipherPass,
+            repoFile, bundleId, bundleRaw, blockIncrReference,
+            blockIncrIndexFileList != NULL ? backupFileBlockIndex(blockIncrIndexFileList) : NULL,
+            repoFileCompressType, repoFileCompressLevel, repoFileCompressThread, compressAdaptive, cipherType, cipherPass,
             pgVersionForce, pageSize, fileList);
 
         // Return result
@@ -101,12 +175,123 @@ backupFileProtocol(PackRead *const param)
             pckWriteU64P(data, fileResult->bundleOffset);
             pckWriteU64P(data, fileResult->blockIncrMapSize);
             pckWriteU64P(data, fileResult->repoSize);
+            pckWriteBoolP(data, fileResult->compressNone);
             pckWriteBinP(data, fileResult->copyChecksum);
             pckWriteBinP(data, fileResult->repoChecksum);
             pckWritePackP(data, fileResult->pageChecksumResult);
+            pckWriteBinP(data, fileResult->blockIncrIndex);
         }
     }
     MEM_CONTEXT_TEMP_END();
 
     FUNCTION_LOG_RETURN(PROTOCOL_SERVER_RESULT, result);
 }
+
+/**********************************************************************************************************************************/
+FN_EXTERN ProtocolServerResult *
+backupPathListProtocol(PackRead *const param)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(PACK_READ, param);
+    FUNCTION_LOG_END();
+
+    ASSERT(param != NULL);
+
+    ProtocolServerResult *const result = protocolServerResultNewP(.extra = ioBufferSize());
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const path = pckReadStrP(param);
+        const bool next = pckReadBoolP(param);
+        const unsigned int limit = pckReadU32P(param);
+
+        // List the names in the path when the listing starts. A missing path is returned as empty, which is what the manifest
+        // build would see. The names are sorted and kept so later results can continue where the prior result stopped without
+        // listing the path again.
+        if (!next)
+        {
+            ASSERT(backupProtocolLocal.pathListPath == NULL);
+
+            StringList *const nameList = strLstNew();
+            StorageIterator *const storageItr = storageNewItrP(
+                storagePg(), path, .level = storageInfoLevelExists, .sortOrder = sortOrderAsc);
+
+            while (storageItrMore(storageItr))
+                strLstAdd(nameList, storageItrNext(storageItr).name);
+
+            backupProtocolLocalInit();
+
+            MEM_CONTEXT_BEGIN(backupProtocolLocal.memContext)
+            {
+                backupProtocolLocal.pathListPath = strDup(path);
+                backupProtocolLocal.pathListName = strLstMove(nameList, backupProtocolLocal.memContext);
+                backupProtocolLocal.pathListNameIdx = 0;
+            }
+            MEM_CONTEXT_END();
+        }
+
+        // Get detail for at most limit entries so large paths are split across results. If the path was completed by the prior
+        // result then there is nothing to return.
+        StringList *const nameList = backupProtocolLocal.pathListName;
+        PackWrite *const data = protocolServerResultData(result);
+        unsigned int total = 0;
+
+        ASSERT(nameList == NULL || strEq(path, backupProtocolLocal.pathListPath));
+
+        pckWriteArrayBeginP(data);
+
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        {
+            while (nameList != NULL && total < limit && backupProtocolLocal.pathListNameIdx < strLstSize(nameList))
+            {
+                const String *const name = strLstGet(nameList, backupProtocolLocal.pathListNameIdx);
+                backupProtocolLocal.pathListNameIdx++;
+
+                // Get detail for the entry. Skip the entry if it was removed after the path was listed.
+                const StorageInfo info = storageInfoP(
+                    storagePg(), strNewFmt("%s/%s", strZ(path), strZ(name)), .level = storageInfoLevelDetail,
+                    .ignoreMissing = true);
+
+                if (info.exists)
+                {
+                    pckWriteObjBeginP(data);
+                    pckWriteStrP(data, name);
+                    pckWriteU32P(data, info.type);
+                    pckWriteTimeP(data, info.timeModified);
+                    pckWriteU64P(data, info.size);
+                    pckWriteModeP(data, info.mode);
+                    pckWriteU32P(data, info.userId);
+                    pckWriteStrP(data, info.user);
+                    pckWriteU32P(data, info.groupId);
+                    pckWriteStrP(data, info.group);
+                    pckWriteStrP(data, info.linkDestination);
+                    pckWriteObjEndP(data);
+                    total++;
+                }
+
+                // Reset the memory context occasionally so we don't use too much memory or slow down processing
+                MEM_CONTEXT_TEMP_RESET(1000);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        pckWriteArrayEndP(data);
+
+        // Are there more entries to list? If not then free the names.
+        const bool more = nameList != NULL && backupProtocolLocal.pathListNameIdx < strLstSize(nameList);
+
+        if (!more && nameList != NULL)
+        {
+            strFree(backupProtocolLocal.pathListPath);
+            strLstFree(nameList);
+
+            backupProtocolLocal.pathListPath = NULL;
+            backupProtocolLocal.pathListName = NULL;
+        }
+
+        pckWriteBoolP(data, more);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(PROTOCOL_SERVER_RESULT, result);
+}
@@ -12,13 +12,16 @@ Functions
 ***********************************************************************************************************************************/
 // Process protocol requests
 FN_EXTERN ProtocolServerResult *backupFileProtocol(PackRead *param);
+FN_EXTERN ProtocolServerResult *backupPathListProtocol(PackRead *param);
 
 /***********************************************************************************************************************************
 Protocol commands for ProtocolServerHandler arrays passed to protocolServerProcess()
 ***********************************************************************************************************************************/
 #define PROTOCOL_COMMAND_BACKUP_FILE                                STRID5("bp-f", 0x36e020)
+#define PROTOCOL_COMMAND_BACKUP_PATH_LIST                           STRID5("bp-l", 0x66e020)
 
 #define PROTOCOL_SERVER_HANDLER_BACKUP_LIST                                                                                        \
-    {.command = PROTOCOL_COMMAND_BACKUP_FILE, .process = backupFileProtocol},
+    {.command = PROTOCOL_COMMAND_BACKUP_FILE, .process = backupFileProtocol},                                                      \
+    {.command = PROTOCOL_COMMAND_BACKUP_PATH_LIST, .process = backupPathListProtocol},
 
 #endif
@@ -847,7 +847,7 @@ removeExpiredBackup(const InfoBackup *const infoBackup, const String *const adho
                 // Else it may be related to the adhoc backup so check if its ancestor still exists
                 else
                 {
-                    const Manifest *const manifestResume = manifestLoadFile(
+                    const Manifest *const manifestResume = manifestLoadFileP(
                         storageRepoIdx(repoIdx), manifestFileName, cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx),
                         infoPgCipherPass(infoBackupPg(infoBackup)));
 
@@ -609,10 +609,11 @@ backupListAdd(
 
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(repoData->manifest); fileIdx++)
         {
-            const ManifestFile file = manifestFile(repoData->manifest, fileIdx);
+            const ManifestFile file = manifestFileUnpackP(
+                repoData->manifest, manifestFilePackGet(repoData->manifest, fileIdx), .noName = true);
 
             if (file.checksumPageError)
-                varLstAdd(checksumPageErrorList, varNewStr(manifestPathPg(file.name)));
+                varLstAdd(checksumPageErrorList, varNewStr(manifestPathPg(manifestFileNameGet(repoData->manifest, fileIdx))));
         }
 
         if (!varLstEmpty(checksumPageErrorList))
@@ -1344,10 +1345,11 @@ infoUpdateStanza(
                 // If a specific backup exists on this repo then attempt to load the manifest
                 if (backupLabel != NULL)
                 {
-                    stanzaRepo->repoList[repoIdx].manifest = manifestLoadFile(
+                    stanzaRepo->repoList[repoIdx].manifest = manifestLoadFileP(
                         storage, strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel)),
                         stanzaRepo->repoList[repoIdx].cipher,
-                        infoPgCipherPass(infoBackupPg(stanzaRepo->repoList[repoIdx].backupInfo)));
+                        infoPgCipherPass(infoBackupPg(stanzaRepo->repoList[repoIdx].backupInfo)),
+                        .skip = manifestSectionLink | manifestSectionPath);
                 }
 
                 // If there is a valid backup lock for this stanza then backup/expire must be running
@@ -81,11 +81,13 @@ cmdManifestBlockDelta(
             const BlockMapItem *const blockMapItem = blockMapGet(blockMap, blockMapIdx);
 
             // The block must be updated if it is beyond the blocks that exist in the block checksum list or when the checksum
-            // stored in the repository is different from the block checksum list
-            if (blockMapIdx >= blockChecksumSize ||
-                !bufEq(
-                    BUF(blockMapItem->checksum, checksumSize),
-                    BUF(bufPtrConst(blockChecksum) + blockMapIdx * checksumSize, checksumSize)))
+            // stored in the repository is different from the block checksum list. Zero blocks are not stored so there is nothing
+            // to read.
+            if (!blockMapItem->zero &&
+                (blockMapIdx >= blockChecksumSize ||
+                 !bufEq(
+                     BUF(blockMapItem->checksum, checksumSize),
+                     BUF(bufPtrConst(blockChecksum) + blockMapIdx * checksumSize, checksumSize))))
             {
                 const unsigned int reference = blockMapItem->reference;
                 ManifestBlockDeltaReference *const referenceData = lstFind(referenceList, &reference);
@@ -445,7 +447,7 @@ cmdManifestRender(void)
         const CipherType cipherType = cipherPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc;
 
         // Load manifest
-        const Manifest *const manifest = manifestLoadFile(
+        const Manifest *const manifest = manifestLoadFileP(
             storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(cfgOptionStr(cfgOptSet))),
             cipherType, cipherPass);
 
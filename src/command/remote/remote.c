@@ -6,6 +6,7 @@ Remote Command
 #include <string.h>
 
 #include "command/backup/blockIncr.h"
+#include "command/backup/compressAdaptive.h"
 #include "command/backup/pageChecksum.h"
 #include "command/control/common.h"
 #include "command/lock.h"
@@ -44,6 +45,7 @@ static const StorageRemoteFilterHandler storageRemoteFilterHandler[] =
     {.type = BLOCK_CHECKSUM_FILTER_TYPE, .handlerParam = blockChecksumNewPack},
     {.type = BLOCK_INCR_FILTER_TYPE, .handlerParam = blockIncrNewPack},
     {.type = CIPHER_BLOCK_FILTER_TYPE, .handlerParam = cipherBlockNewPack},
+    {.type = COMPRESS_ADAPTIVE_FILTER_TYPE, .handlerParam = compressAdaptiveNewPack},
     {.type = CRYPTO_HASH_FILTER_TYPE, .handlerParam = cryptoHashNewPack},
     {.type = PAGE_CHECKSUM_FILTER_TYPE, .handlerParam = pageChecksumNewPack},
     {.type = SINK_FILTER_TYPE, .handlerNoParam = ioSinkNew},
@@ -118,14 +118,15 @@ storageGetProcess(IoWrite *const destination)
                                 // Find the manifest passphrase
                                 if (!strEq(strLstGet(filePathSplitLst, 2), STRDEF(BACKUP_PATH_HISTORY)) &&
                                     !strEndsWithZ(file, BACKUP_MANIFEST_FILE) &&
-                                    !strEndsWithZ(file, BACKUP_MANIFEST_FILE INFO_COPY_EXT))
+                                    !strEndsWithZ(file, BACKUP_MANIFEST_FILE INFO_COPY_EXT) &&
+                                    !strEndsWithZ(file, BACKUP_MANIFEST_PACK_FILE))
                                 {
-                                    const Manifest *const manifest = manifestLoadFile(
+                                    const Manifest *const manifest = manifestLoadFileP(
                                         storageRepo(),
                                         strNewFmt(
                                             STORAGE_PATH_BACKUP "/%s/%s/%s", strZ(stanza), strZ(strLstGet(filePathSplitLst, 2)),
                                             BACKUP_MANIFEST_FILE),
-                                        repoCipherType, cipherPass);
+                                        repoCipherType, cipherPass, .skip = manifestSectionList);
                                     cipherPass = manifestCipherSubPass(manifest);
                                 }
                             }
@@ -7,6 +7,7 @@ Block Restore
 #include "command/restore/blockDelta.h"
 #include "common/crypto/cipherBlock.h"
 #include "common/debug.h"
+#include "common/io/io.h"
 #include "common/io/limitRead.h"
 #include "common/log.h"
 
@@ -17,6 +18,7 @@ typedef struct BlockDeltaSuperBlock
 {
     uint64_t superBlockSize;                                        // Super block size
     uint64_t size;                                                  // Stored size of superblock (with compression, etc.)
+    uint64_t gap;                                                   // Bytes to skip before the super block
     List *blockList;                                                // Block list
 } BlockDeltaSuperBlock;
 
@@ -24,6 +26,8 @@ typedef struct BlockDeltaBlock
 {
     uint64_t no;                                                    // Block number in the super block
     uint64_t offset;                                                // Offset into original file
+    uint64_t blockOffset;                                           // Offset into super block (variable blocks only)
+    uint64_t size;                                                  // Block size (variable blocks only)
     uint8_t checksum[XX_HASH_SIZE_MAX];                             // Checksum of the block
 } BlockDeltaBlock;
 
@@ -32,6 +36,7 @@ struct BlockDelta
     BlockDeltaPub pub;                                              // Publicly accessible variables
     size_t blockSize;                                               // Block size
     size_t checksumSize;                                            // Checksum size
+    bool variable;                                                  // Are blocks variable size?
     CipherType cipherType;                                          // Cipher type
     String *cipherPass;                                             // Cipher passphrase
     CompressType compressType;                                      // Compress type
@@ -43,6 +48,7 @@ struct BlockDelta
     unsigned int blockIdx;                                          // Current block index
     unsigned int blockTotal;                                        // Block total for super block
     unsigned int blockFindIdx;                                      // Index of the block to find in the super block
+    uint64_t superBlockOffset;                                      // Current offset in the super block (variable blocks only)
 
     BlockDeltaWrite write;                                          // Block/offset to be returned for write
 };
@@ -51,13 +57,44 @@ struct BlockDelta
 typedef struct BlockDeltaReference
 {
     unsigned int reference;                                         // Reference
+    uint64_t bundleId;                                              // Bundle id
     List *blockList;                                                // List of blocks in the block map for the reference
 } BlockDeltaReference;
 
+// Reference comparator. A reference may have blocks in more than one bundle so each bundle is treated as a separate reference.
+static int
+lstComparatorBlockDeltaReference(const void *const reference1, const void *const reference2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, reference1);
+        FUNCTION_TEST_PARAM_P(VOID, reference2);
+    FUNCTION_TEST_END();
+
+    ASSERT(reference1 != NULL);
+    ASSERT(reference2 != NULL);
+
+    int result = LST_COMPARATOR_CMP(
+        ((const BlockDeltaReference *)reference1)->reference, ((const BlockDeltaReference *)reference2)->reference);
+
+    if (result == 0)
+    {
+        result = LST_COMPARATOR_CMP(
+            ((const BlockDeltaReference *)reference1)->bundleId, ((const BlockDeltaReference *)reference2)->bundleId);
+    }
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+typedef struct BlockDeltaReferenceBlock
+{
+    unsigned int blockMapIdx;                                       // Index of the block in the block map
+    uint64_t offset;                                                // Offset into original file
+} BlockDeltaReferenceBlock;
+
 FN_EXTERN BlockDelta *
 blockDeltaNew(
     const BlockMap *const blockMap, const size_t blockSize, const size_t checksumSize, const Buffer *const blockChecksum,
-    const CipherType cipherType, const String *const cipherPass, const CompressType compressType)
+    const CipherType cipherType, const String *const cipherPass, const CompressType compressType, const uint64_t readGapMax)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(BLOCK_MAP, blockMap);
@@ -67,12 +104,15 @@ blockDeltaNew(
         FUNCTION_TEST_PARAM(STRING_ID, cipherType);
         FUNCTION_TEST_PARAM(STRING, cipherPass);
         FUNCTION_TEST_PARAM(ENUM, compressType);
+        FUNCTION_TEST_PARAM(UINT64, readGapMax);
     FUNCTION_TEST_END();
 
     ASSERT(blockMap != NULL);
     ASSERT(blockSize > 0);
     ASSERT(cipherType == cipherTypeNone || cipherPass != NULL);
 
+    const bool variable = blockMapVariable(blockMap);
+
     OBJ_NEW_BEGIN(BlockDelta, .childQty = MEM_CONTEXT_QTY_MAX)
     {
         *this = (BlockDelta)
@@ -80,28 +120,36 @@ blockDeltaNew(
             .pub =
             {
                 .readList = lstNewP(sizeof(BlockDeltaRead)),
+                .zeroList = lstNewP(sizeof(uint64_t)),
             },
             .blockSize = blockSize,
             .checksumSize = checksumSize,
+            .variable = variable,
             .cipherType = cipherType,
             .cipherPass = strDup(cipherPass),
             .compressType = compressType,
             .write =
             {
-                .block = bufNew(blockSize),
+                .block = bufNew(variable ? BLOCK_INCR_CDC_SIZE_MAX(blockSize) : blockSize),
             }
         };
 
         MEM_CONTEXT_TEMP_BEGIN()
         {
-            // Build list of references and for each reference the list of blocks for that reference
+            // Build list of references and for each reference the list of blocks for that reference. The block checksum list is
+            // calculated with fixed size blocks so it cannot be compared when blocks are variable size and all blocks are restored.
             const unsigned int blockChecksumSize =
-                blockChecksum == NULL ? 0 : (unsigned int)(bufUsed(blockChecksum) / this->checksumSize);
-            List *const referenceList = lstNewP(sizeof(BlockDeltaReference), .comparator = lstComparatorUInt);
+                blockChecksum == NULL || variable ? 0 : (unsigned int)(bufUsed(blockChecksum) / this->checksumSize);
+            List *const referenceList = lstNewP(sizeof(BlockDeltaReference), .comparator = lstComparatorBlockDeltaReference);
+            uint64_t offset = 0;
 
             for (unsigned int blockMapIdx = 0; blockMapIdx < blockMapSize(blockMap); blockMapIdx++)
             {
                 const BlockMapItem *const blockMapItem = blockMapGet(blockMap, blockMapIdx);
+                const BlockDeltaReferenceBlock block = {.blockMapIdx = blockMapIdx, .offset = offset};
+
+                // Calculate offset of the next block
+                offset += variable ? blockMapItem->blockSize : blockSize;
 
                 // The block must be updated if it is beyond the blocks that exist in the block checksum list or when the checksum
                 // stored in the repository is different from the block checksum list
@@ -110,20 +158,30 @@ blockDeltaNew(
                         BUF(blockMapItem->checksum, this->checksumSize),
                         BUF(bufPtrConst(blockChecksum) + blockMapIdx * this->checksumSize, this->checksumSize)))
                 {
-                    const unsigned int reference = blockMapItem->reference;
-                    BlockDeltaReference *const referenceData = lstFind(referenceList, &reference);
+                    // Zero blocks are not stored so they are written without a read
+                    if (blockMapItem->zero)
+                    {
+                        lstAdd(this->pub.zeroList, &block.offset);
+                        continue;
+                    }
+
+                    BlockDeltaReference *const referenceData = lstFind(
+                        referenceList,
+                        &(BlockDeltaReference){.reference = blockMapItem->reference, .bundleId = blockMapItem->bundleId});
 
                     // If the reference has not been added
                     if (referenceData == NULL)
                     {
                         const BlockDeltaReference *const referenceData = lstAdd(
                             referenceList,
-                            &(BlockDeltaReference){.reference = reference, .blockList = lstNewP(sizeof(unsigned int))});
-                        lstAdd(referenceData->blockList, &blockMapIdx);
+                            &(BlockDeltaReference){
+                                .reference = blockMapItem->reference, .bundleId = blockMapItem->bundleId,
+                                .blockList = lstNewP(sizeof(BlockDeltaReferenceBlock))});
+                        lstAdd(referenceData->blockList, &block);
                     }
                     // Else add the new block
                     else
-                        lstAdd(referenceData->blockList, &blockMapIdx);
+                        lstAdd(referenceData->blockList, &block);
                 }
             }
 
@@ -140,13 +198,16 @@ blockDeltaNew(
 
                 for (unsigned int blockIdx = 0; blockIdx < lstSize(referenceData->blockList); blockIdx++)
                 {
-                    const unsigned int blockMapIdx = *(unsigned int *)lstGet(referenceData->blockList, blockIdx);
-                    const BlockMapItem *const blockMapItem = blockMapGet(blockMap, blockMapIdx);
+                    const BlockDeltaReferenceBlock *const block = lstGet(referenceData->blockList, blockIdx);
+                    const BlockMapItem *const blockMapItem = blockMapGet(blockMap, block->blockMapIdx);
+
+                    // Add read when it has changed. Super blocks that are not adjacent are still added to the current read when
+                    // they follow it and the gap is small enough, since skipping a few bytes is cheaper than a new read.
+                    const uint64_t readEnd = blockMapItemPrior == NULL ? 0 : blockMapItemPrior->offset + blockMapItemPrior->size;
 
-                    // Add read when it has changed
                     if (blockMapItemPrior == NULL ||
                         (blockMapItemPrior->offset != blockMapItem->offset &&
-                         blockMapItemPrior->offset + blockMapItemPrior->size != blockMapItem->offset))
+                         (blockMapItem->offset < readEnd || blockMapItem->offset - readEnd > readGapMax)))
                     {
                         MEM_CONTEXT_OBJ_BEGIN(this->pub.readList)
                         {
@@ -172,11 +233,12 @@ blockDeltaNew(
                             {
                                 .superBlockSize = blockMapItem->superBlockSize,
                                 .size = blockMapItem->size,
+                                .gap = blockMapItem->offset - (blockDeltaRead->offset + blockDeltaRead->size),
                                 .blockList = lstNewP(sizeof(BlockDeltaBlock)),
                             };
 
                             blockDeltaSuperBlock = lstAdd(blockDeltaRead->superBlockList, &blockDeltaSuperBlockNew);
-                            blockDeltaRead->size += blockMapItem->size;
+                            blockDeltaRead->size += blockDeltaSuperBlockNew.gap + blockMapItem->size;
                         }
                         MEM_CONTEXT_OBJ_END();
                     }
@@ -185,7 +247,9 @@ blockDeltaNew(
                     BlockDeltaBlock blockDeltaBlockNew =
                     {
                         .no = blockMapItem->block,
-                        .offset = blockMapIdx * blockSize,
+                        .offset = block->offset,
+                        .blockOffset = blockMapItem->blockOffset,
+                        .size = blockMapItem->blockSize,
                     };
 
                     memcpy(blockDeltaBlockNew.checksum, blockMapItem->checksum, SIZE_OF_STRUCT_MEMBER(BlockDeltaBlock, checksum));
@@ -231,6 +295,15 @@ blockDeltaNext(BlockDelta *const this, const BlockDeltaRead *const readDelta, Io
             ioReadFree(this->limitRead);
             this->superBlockData = lstGet(readDelta->superBlockList, this->superBlockIdx);
 
+            // Skip the gap left by super blocks that are not required
+            if (this->superBlockData->gap != 0)
+            {
+                IoRead *const gapRead = ioLimitReadNew(readIo, this->superBlockData->gap);
+
+                ioReadDrain(gapRead);
+                ioReadFree(gapRead);
+            }
+
             MEM_CONTEXT_OBJ_BEGIN(this)
             {
                 this->limitRead = ioLimitReadNew(readIo, this->superBlockData->size);
@@ -249,26 +322,51 @@ blockDeltaNext(BlockDelta *const this, const BlockDeltaRead *const readDelta, Io
 
             ioReadOpen(this->limitRead);
 
-            // Set block info
+            // Set block info. Variable size blocks are read directly so only the required blocks are counted.
             this->blockIdx = 0;
             this->blockFindIdx = 0;
+            this->superBlockOffset = 0;
             this->blockTotal =
-                (unsigned int)(this->superBlockData->superBlockSize / this->blockSize) +
-                (this->superBlockData->superBlockSize % this->blockSize == 0 ? 0 : 1);
+                this->variable ?
+                    lstSize(this->superBlockData->blockList) :
+                    (unsigned int)(this->superBlockData->superBlockSize / this->blockSize) +
+                        (this->superBlockData->superBlockSize % this->blockSize == 0 ? 0 : 1);
             this->blockData = lstGet(this->superBlockData->blockList, this->blockFindIdx);
         }
 
         // Find required blocks in the super block
         while (this->blockIdx < this->blockTotal)
         {
-            // Clear buffer and read block
+            // Clear buffer
             bufUsedZero(this->write.block);
             bufLimitClear(this->write.block);
 
-            ioRead(this->limitRead, this->write.block);
+            // Skip to the block and read it when blocks are variable size
+            if (this->variable)
+            {
+                while (this->superBlockOffset < this->blockData->blockOffset)
+                {
+                    const uint64_t skipSize = this->blockData->blockOffset - this->superBlockOffset;
+
+                    bufLimitSet(
+                        this->write.block, skipSize < bufSize(this->write.block) ? (size_t)skipSize : bufSize(this->write.block));
+
+                    const size_t skipRead = ioRead(this->limitRead, this->write.block);
+                    CHECK(FormatError, skipRead > 0, "unexpected eof in super block");
+
+                    this->superBlockOffset += skipRead;
+                    bufUsedZero(this->write.block);
+                }
+
+                bufLimitSet(this->write.block, (size_t)this->blockData->size);
+                this->superBlockOffset += ioRead(this->limitRead, this->write.block);
+            }
+            // Else read the next block
+            else
+                ioRead(this->limitRead, this->write.block);
 
             // If the block matches the block we are expecting
-            if (this->blockIdx == this->blockData->no)
+            if (this->variable || this->blockIdx == this->blockData->no)
             {
                 ASSERT(result == NULL);
 
@@ -295,8 +393,9 @@ blockDeltaNext(BlockDelta *const this, const BlockDeltaRead *const readDelta, Io
 
         // Check that no bytes remain to be written. It is possible that some bytes remain in the super block, however, since we may
         // have gotten all the bytes we needed but just missed reading something important, e.g. an end of file marker. If we do not
-        // read the remaining bytes then the next read will start too early.
-        ioReadFlushP(this->limitRead, .errorOnBytes = true);
+        // read the remaining bytes then the next read will start too early. Variable size blocks that are not required are not read
+        // so bytes are expected to remain.
+        ioReadFlushP(this->limitRead, .errorOnBytes = !this->variable);
 
         this->superBlockData = NULL;
         this->superBlockIdx++;
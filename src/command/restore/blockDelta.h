@@ -3,6 +3,12 @@ Block Restore
 
 Calculate and return the blocks required to restore a file using an optional block checksum list. The block checksum list is
 optional because the file to restore may not exist so all the blocks will need to be restored.
+
+Super blocks from the same reference/bundle are combined into a single read when they are adjacent or separated by a gap no
+larger than readGapMax. The gap is read and discarded.
+
+Zero blocks are not stored in the repository so no read is required. The offsets of zero blocks to be written are returned in a
+separate list.
 ***********************************************************************************************************************************/
 #ifndef COMMAND_BACKUP_BLOCKDELTA_H
 #define COMMAND_BACKUP_BLOCKDELTA_H
@@ -38,7 +44,7 @@ Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN BlockDelta *blockDeltaNew(
     const BlockMap *blockMap, size_t blockSize, size_t checksumSize, const Buffer *blockChecksum, CipherType cipherType,
-    const String *cipherPass, const CompressType compressType);
+    const String *cipherPass, CompressType compressType, uint64_t readGapMax);
 
 /***********************************************************************************************************************************
 Functions
@@ -52,6 +58,7 @@ Getters/Setters
 typedef struct BlockDeltaPub
 {
     List *readList;                                                 // Read list
+    List *zeroList;                                                 // Offsets of zero blocks to write
 } BlockDeltaPub;
 
 // Get read info
@@ -68,6 +75,20 @@ blockDeltaReadSize(const BlockDelta *const this)
     return lstSize(THIS_PUB(BlockDelta)->readList);
 }
 
+// Get zero block offset. Zero blocks are always the full block size.
+FN_INLINE_ALWAYS uint64_t
+blockDeltaZeroGet(const BlockDelta *const this, const unsigned int zeroIdx)
+{
+    return *(uint64_t *)lstGet(THIS_PUB(BlockDelta)->zeroList, zeroIdx);
+}
+
+// Zero block list size
+FN_INLINE_ALWAYS unsigned int
+blockDeltaZeroSize(const BlockDelta *const this)
+{
+    return lstSize(THIS_PUB(BlockDelta)->zeroList);
+}
+
 /***********************************************************************************************************************************
 Destructor
 ***********************************************************************************************************************************/
@@ -29,8 +29,8 @@ Restore File
 FN_EXTERN List *
 restoreFile(
     const String *const repoFile, const unsigned int repoIdx, const CompressType repoFileCompressType, const time_t copyTimeBegin,
-    const bool delta, const bool deltaForce, const bool bundleRaw, const String *const cipherPass,
-    const StringList *const referenceList, List *const fileList)
+    const bool delta, const bool deltaForce, const bool bundleRaw, const StringId allocate, const uint64_t readGapMax,
+    const String *const cipherPass, const StringList *const referenceList, List *const fileList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, repoFile);
@@ -40,6 +40,8 @@ restoreFile(
         FUNCTION_LOG_PARAM(BOOL, delta);
         FUNCTION_LOG_PARAM(BOOL, deltaForce);
         FUNCTION_LOG_PARAM(BOOL, bundleRaw);
+        FUNCTION_LOG_PARAM(STRING_ID, allocate);
+        FUNCTION_LOG_PARAM(UINT64, readGapMax);
         FUNCTION_TEST_PARAM(STRING, cipherPass);
         FUNCTION_LOG_PARAM(STRING_LIST, referenceList);             // List of references (for block incremental)
         FUNCTION_LOG_PARAM(LIST, fileList);                         // List of files to restore
@@ -218,6 +220,7 @@ restoreFile(
 
         // Copy files from repository to database
         StorageRead *repoFileRead = NULL;
+        uint64_t repoFileOffset = 0;
         uint64_t repoFileLimit = 0;
 
         for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
@@ -239,9 +242,11 @@ restoreFile(
                         if (file->limit != NULL)
                         {
                             ASSERT(varUInt64(file->limit) != 0);
+                            repoFileOffset = file->offset;
                             repoFileLimit = varUInt64(file->limit);
 
-                            // Determine how many files can be copied with one read
+                            // Determine how many files can be copied with one read. Files that are not being copied are skipped and
+                            // the gap they leave is read and discarded as long as it is not too large.
                             for (unsigned int fileNextIdx = fileIdx + 1; fileNextIdx < lstSize(fileList); fileNextIdx++)
                             {
                                 // Only files that are being copied are considered
@@ -249,16 +254,14 @@ restoreFile(
                                 {
                                     const RestoreFile *const fileNext = lstGet(fileList, fileNextIdx);
                                     ASSERT(fileNext->limit != NULL && varUInt64(fileNext->limit) != 0);
+                                    ASSERT(fileNext->offset >= file->offset + repoFileLimit);
 
-                                    // Break if the offset is not the first file's offset + limit of all additional files so far
-                                    if (fileNext->offset != file->offset + repoFileLimit)
+                                    // Break if the gap between the end of the read and the file is too large
+                                    if (fileNext->offset - (file->offset + repoFileLimit) > readGapMax)
                                         break;
 
-                                    repoFileLimit += varUInt64(fileNext->limit);
+                                    repoFileLimit = fileNext->offset + varUInt64(fileNext->limit) - file->offset;
                                 }
-                                // Else if the file was not copied then there is a gap so break
-                                else
-                                    break;
                             }
                         }
 
@@ -276,11 +279,23 @@ restoreFile(
                         MEM_CONTEXT_PRIOR_END();
                     }
 
-                    // Create pg file
+                    // Discard the gap left by files that were not copied since the last file copied from this read
+                    if (repoFileLimit != 0 && file->offset > repoFileOffset)
+                    {
+                        const uint64_t repoFileGap = file->offset - repoFileOffset;
+
+                        ioReadDrain(ioLimitReadNew(storageReadIo(repoFileRead), repoFileGap));
+                        repoFileLimit -= repoFileGap;
+                    }
+
+                    // Create pg file. Block incremental files are not written sparse because blocks are written at arbitrary
+                    // offsets in the file.
                     StorageWrite *const pgFileWrite = storageNewWriteP(
                         storagePgWrite(), file->name, .modeFile = file->mode, .user = file->user, .group = file->group,
                         .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncPath = true,
-                        .noTruncate = file->blockChecksum != NULL);
+                        .noTruncate = file->blockChecksum != NULL,
+                        .sparse = allocate == CFGOPTVAL_ALLOCATE_SPARSE && file->blockIncrMapSize == 0,
+                        .preallocate = allocate == CFGOPTVAL_ALLOCATE_FULL ? file->size : 0);
 
                     // If block incremental file
                     const Buffer *checksum = NULL;
@@ -311,7 +326,8 @@ restoreFile(
                         // Apply delta to file
                         BlockDelta *const blockDelta = blockDeltaNew(
                             blockMap, file->blockIncrSize, file->blockIncrChecksumSize, file->blockChecksum,
-                            cipherPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc, cipherPass, repoFileCompressType);
+                            cipherPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc, cipherPass, repoFileCompressType,
+                            readGapMax);
 
                         for (unsigned int readIdx = 0; readIdx < blockDeltaReadSize(blockDelta); readIdx++)
                         {
@@ -352,6 +368,44 @@ restoreFile(
                             storageReadFree(superBlockRead);
                         }
 
+                        // Write zero blocks, which are not stored in the repository. When the file is new and sparse allocation is
+                        // requested the zero blocks are left as holes but the file must still be extended in case the last block
+                        // is zero.
+                        if (blockDeltaZeroSize(blockDelta) > 0)
+                        {
+                            fileResult->blockIncrDeltaSize += (uint64_t)blockDeltaZeroSize(blockDelta) * file->blockIncrSize;
+
+                            if (allocate == CFGOPTVAL_ALLOCATE_SPARSE && file->blockChecksum == NULL)
+                            {
+                                THROW_ON_SYS_ERROR_FMT(
+                                    ftruncate(ioWriteFd(storageWriteIo(pgFileWrite)), (off_t)file->size) == -1, FileWriteError,
+                                    "unable to truncate '%s'", strZ(file->name));
+                            }
+                            else
+                            {
+                                Buffer *const zeroBlock = bufNew(file->blockIncrSize);
+
+                                memset(bufPtr(zeroBlock), 0, bufSize(zeroBlock));
+                                bufUsedSet(zeroBlock, bufSize(zeroBlock));
+
+                                for (unsigned int zeroIdx = 0; zeroIdx < blockDeltaZeroSize(blockDelta); zeroIdx++)
+                                {
+                                    const uint64_t zeroOffset = blockDeltaZeroGet(blockDelta, zeroIdx);
+
+                                    // Zero blocks are always full size since a partial block at the end of the file is never elided
+                                    ASSERT(zeroOffset + file->blockIncrSize <= file->size);
+
+                                    THROW_ON_SYS_ERROR_FMT(
+                                        lseek(ioWriteFd(storageWriteIo(pgFileWrite)), (off_t)zeroOffset, SEEK_SET) == -1,
+                                        FileOpenError, STORAGE_ERROR_READ_SEEK, zeroOffset,
+                                        strZ(storagePathP(storagePg(), file->name)));
+
+                                    ioWrite(storageWriteIo(pgFileWrite), zeroBlock);
+                                    ioWriteFlush(storageWriteIo(pgFileWrite));
+                                }
+                            }
+                        }
+
                         // Close the file to complete the update
                         ioWriteClose(storageWriteIo(pgFileWrite));
 
@@ -379,7 +433,7 @@ restoreFile(
                         }
 
                         // Add decompression filter
-                        if (repoFileCompressType != compressTypeNone)
+                        if (repoFileCompressType != compressTypeNone && !file->compressNone)
                             ioFilterGroupAdd(filterGroup, decompressFilterP(repoFileCompressType, .raw = bundleRaw));
 
                         // Add sha1 filter
@@ -399,7 +453,10 @@ restoreFile(
 
                     // If more than one file is being copied from a single read then decrement the limit
                     if (repoFileLimit != 0)
+                    {
+                        repoFileOffset = file->offset + varUInt64(file->limit);
                         repoFileLimit -= varUInt64(file->limit);
+                    }
 
                     // Free the repo file when there are no more files to copy from it
                     if (repoFileLimit == 0)
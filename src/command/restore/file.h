@@ -33,6 +33,7 @@ typedef struct RestoreFile
     const String *group;                                            // Original group
     uint64_t offset;                                                // Offset into repo file where pg file is located
     const Variant *limit;                                           // Limit for read in the repo file
+    bool compressNone;                                              // Stored in the repo without compression?
     uint64_t blockIncrMapSize;                                      // Block incremental map size (0 if not incremental)
     size_t blockIncrSize;                                           // Block incremental size (when map size > 0)
     size_t blockIncrChecksumSize;                                   // Checksum size (when map size > 0)
@@ -49,6 +50,7 @@ typedef struct RestoreFileResult
 
 FN_EXTERN List *restoreFile(
     const String *repoFile, unsigned int repoIdx, CompressType repoFileCompressType, time_t copyTimeBegin, bool delta,
-    bool deltaForce, bool bundleRaw, const String *cipherPass, const StringList *referenceList, List *fileList);
+    bool deltaForce, bool bundleRaw, StringId allocate, uint64_t readGapMax, const String *cipherPass,
+    const StringList *referenceList, List *fileList);
 
 #endif
@@ -34,6 +34,8 @@ restoreFileProtocol(PackRead *const param)
         const bool delta = pckReadBoolP(param);
         const bool deltaForce = pckReadBoolP(param);
         const bool bundleRaw = pckReadBoolP(param);
+        const StringId allocate = pckReadStrIdP(param);
+        const uint64_t readGapMax = pckReadU64P(param);
         const String *const cipherPass = pckReadStrP(param);
         const StringList *const referenceList = pckReadStrLstP(param);
 
@@ -57,6 +59,8 @@ restoreFileProtocol(PackRead *const param)
                 file.limit = varNewUInt64(pckReadU64P(param));
             }
 
+            file.compressNone = pckReadBoolP(param);
+
             // Block incremental
             file.blockIncrMapSize = pckReadU64P(param);
 
@@ -73,8 +77,8 @@ restoreFileProtocol(PackRead *const param)
 
         // Restore files
         const List *const resultList = restoreFile(
-            repoFile, repoIdx, repoFileCompressType, copyTimeBegin, delta, deltaForce, bundleRaw, cipherPass, referenceList,
-            fileList);
+            repoFile, repoIdx, repoFileCompressType, copyTimeBegin, delta, deltaForce, bundleRaw, allocate, readGapMax,
+            cipherPass, referenceList, fileList);
 
         // Return result
         PackWrite *const data = protocolServerResultData(result);
@@ -1862,9 +1862,11 @@ restoreProcessQueueComparator(const void *const item1, const void *const item2)
     ASSERT(item1 != NULL);
     ASSERT(item2 != NULL);
 
-    // Unpack files
-    const ManifestFile file1 = manifestFileUnpack(restoreProcessQueueComparatorManifest, *(const ManifestFilePack *const *)item1);
-    const ManifestFile file2 = manifestFileUnpack(restoreProcessQueueComparatorManifest, *(const ManifestFilePack *const *)item2);
+    // Unpack files (names are compared in packed format)
+    const ManifestFilePack *const filePack1 = *(const ManifestFilePack *const *)item1;
+    const ManifestFilePack *const filePack2 = *(const ManifestFilePack *const *)item2;
+    const ManifestFile file1 = manifestFileUnpackP(restoreProcessQueueComparatorManifest, filePack1, .noName = true);
+    const ManifestFile file2 = manifestFileUnpackP(restoreProcessQueueComparatorManifest, filePack2, .noName = true);
 
     // Zero length files should be ordered at the end
     if (file1.size == 0)
@@ -1891,8 +1893,8 @@ restoreProcessQueueComparator(const void *const item1, const void *const item2)
             FUNCTION_TEST_RETURN(INT, 1);
 
         // If size is the same then use name to generate a deterministic ordering (names must be unique)
-        ASSERT(!strEq(file1.name, file2.name));
-        FUNCTION_TEST_RETURN(INT, strCmp(file1.name, file2.name));
+        ASSERT(manifestFilePackNameCmp(filePack1, filePack2) != 0);
+        FUNCTION_TEST_RETURN(INT, manifestFilePackNameCmp(filePack1, filePack2));
     }
 
     // If the reference differs that is enough to determine order
@@ -1965,8 +1967,10 @@ restoreProcessQueue(const Manifest *const manifest, List **const queueList)
         // Now put all files into the processing queues
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
         {
+            // Get the name separately since it is borrowed from the manifest and this context cannot be reset
             const ManifestFilePack *const filePack = manifestFilePackGet(manifest, fileIdx);
-            const ManifestFile file = manifestFileUnpack(manifest, filePack);
+            const ManifestFile file = manifestFileUnpackP(manifest, filePack, .noName = true);
+            const String *const fileName = manifestFileNameGet(manifest, fileIdx);
 
             // Find the target that contains this file
             unsigned int targetIdx = 0;
@@ -1976,7 +1980,7 @@ restoreProcessQueue(const Manifest *const manifest, List **const queueList)
                 // A target should always be found
                 CHECK(FormatError, targetIdx < strLstSize(targetList), "backup target not found");
 
-                if (strBeginsWith(file.name, strLstGet(targetList, targetIdx)))
+                if (strBeginsWith(fileName, strLstGet(targetList, targetIdx)))
                     break;
 
                 targetIdx++;
@@ -2229,7 +2233,7 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
 
             while (!lstEmpty(queue))
             {
-                const ManifestFile file = manifestFileUnpack(jobData->manifest, *(ManifestFilePack **)lstGet(queue, 0));
+                const ManifestFile file = manifestFileUnpackP(jobData->manifest, *(ManifestFilePack **)lstGet(queue, 0));
 
                 // Break if bundled files have already been added and 1) the bundleId has changed or 2) the reference has changed
                 if (fileAdded && (bundleId != file.bundleId || !strEq(reference, file.reference)))
@@ -2261,6 +2265,8 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta));
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta) && cfgOptionBool(cfgOptForce));
                     pckWriteBoolP(param, file.bundleId != 0 && manifestData(jobData->manifest)->bundleRaw);
+                    pckWriteStrIdP(param, cfgOptionStrId(cfgOptAllocate));
+                    pckWriteU64P(param, cfgOptionUInt64(cfgOptReadGapMax));
                     pckWriteStrP(param, jobData->cipherSubPass);
                     pckWriteStrLstP(param, manifestReferenceList(jobData->manifest));
 
@@ -2294,6 +2300,9 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
                 else
                     pckWriteBoolP(param, false);
 
+                // Was the file stored without compression?
+                pckWriteBoolP(param, file.compressNone);
+
                 // Block incremental
                 pckWriteU64P(param, file.blockIncrMapSize);
 
@@ -2363,7 +2372,7 @@ cmdRestore(void)
         // Load manifest
         RestoreJobData jobData = {.repoIdx = backupData.repoIdx};
 
-        jobData.manifest = manifestLoadFile(
+        jobData.manifest = manifestLoadFileP(
             storageRepoIdx(backupData.repoIdx),
             strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupData.backupSet)), backupData.repoCipherType,
             backupData.backupCipherPass);
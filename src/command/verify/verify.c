@@ -660,7 +660,7 @@ verifyBackupSet(VerifyJobData *const jobData, const String *const backupLabel)
     {
         TRY_BEGIN()
         {
-            const Manifest *const manifest = manifestLoadFile(
+            const Manifest *const manifest = manifestLoadFileP(
                 storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel)),
                 cfgOptionStrId(cfgOptRepoCipherType), jobData->manifestCipherPass);
 
@@ -669,7 +669,7 @@ verifyBackupSet(VerifyJobData *const jobData, const String *const backupLabel)
 
             for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
             {
-                const ManifestFile file = manifestFile(manifest, fileIdx);
+                const ManifestFile file = manifestFileUnpackP(manifest, manifestFilePackGet(manifest, fileIdx), .noName = true);
 
                 if (file.blockIncrMapSize != 0)
                 {
@@ -1119,7 +1119,7 @@ verifyBackup(VerifyJobData *const jobData)
                             // Else use the file checksum, which may require additional filters, e.g. decompression
                             else
                             {
-                                pckWriteU32P(param, manifestData(jobData->manifest)->backupOptionCompressType);
+                                pckWriteU32P(param, manifestFileCompressType(jobData->manifest, &fileData));
                                 pckWriteBinP(param, BUF(fileData.checksumSha1, HASH_TYPE_SHA1_SIZE));
                                 pckWriteU64P(param, fileData.size);
                                 pckWriteStrP(param, jobData->backupCipherPass);
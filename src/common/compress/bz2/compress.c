@@ -161,11 +161,12 @@ bz2CompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
-bz2CompressNew(const int level, const bool raw)
+bz2CompressNew(const int level, const bool raw, const unsigned int thread)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(INT, level);
         (void)raw;                                                  // Raw unsupported
+        (void)thread;                                               // Thread unsupported
     FUNCTION_LOG_END();
 
     ASSERT(level >= BZ2_COMPRESS_LEVEL_MIN && level <= BZ2_COMPRESS_LEVEL_MAX);
@@ -188,6 +189,6 @@ bz2CompressNew(const int level, const bool raw)
     FUNCTION_LOG_RETURN(
         IO_FILTER,
         ioFilterNewP(
-            BZ2_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw), .done = bz2CompressDone, .inOut = bz2CompressProcess,
-            .inputSame = bz2CompressInputSame));
+            BZ2_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw, thread), .done = bz2CompressDone,
+            .inOut = bz2CompressProcess, .inputSame = bz2CompressInputSame));
 }
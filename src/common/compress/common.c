@@ -8,11 +8,12 @@ Compression Common
 
 /**********************************************************************************************************************************/
 FN_EXTERN Pack *
-compressParamList(const int level, const bool raw)
+compressParamList(const int level, const bool raw, const unsigned int thread)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_LOG_PARAM(INT, level);
         FUNCTION_TEST_PARAM(BOOL, raw);
+        FUNCTION_TEST_PARAM(UINT, thread);
     FUNCTION_TEST_END();
 
     Pack *result;
@@ -23,6 +24,7 @@ compressParamList(const int level, const bool raw)
 
         pckWriteI32P(packWrite, level);
         pckWriteBoolP(packWrite, raw);
+        pckWriteU32P(packWrite, thread);
         pckWriteEndP(packWrite);
 
         result = pckMove(pckWriteResult(packWrite), memContextPrior());
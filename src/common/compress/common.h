@@ -10,7 +10,7 @@ Compression Common
 Functions
 ***********************************************************************************************************************************/
 // Build compress param list
-FN_EXTERN Pack *compressParamList(int level, bool raw);
+FN_EXTERN Pack *compressParamList(int level, bool raw, unsigned int thread);
 
 // Build decompress param list
 FN_EXTERN Pack *decompressParamList(bool raw);
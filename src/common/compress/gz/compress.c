@@ -165,11 +165,12 @@ gzCompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
-gzCompressNew(const int level, const bool raw)
+gzCompressNew(const int level, const bool raw, const unsigned int thread)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(INT, level);
         FUNCTION_LOG_PARAM(BOOL, raw);
+        (void)thread;                                               // Thread unsupported
     FUNCTION_LOG_END();
 
     ASSERT(level >= GZ_COMPRESS_LEVEL_MIN && level <= GZ_COMPRESS_LEVEL_MAX);
@@ -192,6 +193,6 @@ gzCompressNew(const int level, const bool raw)
     FUNCTION_LOG_RETURN(
         IO_FILTER,
         ioFilterNewP(
-            GZ_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw), .done = gzCompressDone, .inOut = gzCompressProcess,
-            .inputSame = gzCompressInputSame));
+            GZ_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw, thread), .done = gzCompressDone,
+            .inOut = gzCompressProcess, .inputSame = gzCompressInputSame));
 }
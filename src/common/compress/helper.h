@@ -54,6 +54,7 @@ typedef struct CompressFilterParam
 {
     VAR_PARAM_HEADER;
     bool raw;                                                       // Omit headers, checksum, etc. when possible
+    unsigned int thread;                                            // Threads to use for compression when supported (0/1 = none)
 } CompressFilterParam;
 
 #define compressFilterP(type, level, ...)                                                                                          \
@@ -242,11 +242,12 @@ lz4CompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
-lz4CompressNew(const int level, const bool raw)
+lz4CompressNew(const int level, const bool raw, const unsigned int thread)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(INT, level);
         FUNCTION_LOG_PARAM(BOOL, raw);
+        (void)thread;                                               // Thread unsupported
     FUNCTION_LOG_END();
 
     ASSERT(level >= LZ4_COMPRESS_LEVEL_MIN && level <= LZ4_COMPRESS_LEVEL_MAX);
@@ -275,6 +276,6 @@ lz4CompressNew(const int level, const bool raw)
     FUNCTION_LOG_RETURN(
         IO_FILTER,
         ioFilterNewP(
-            LZ4_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw), .done = lz4CompressDone, .inOut = lz4CompressProcess,
-            .inputSame = lz4CompressInputSame));
+            LZ4_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw, thread), .done = lz4CompressDone,
+            .inOut = lz4CompressProcess, .inputSame = lz4CompressInputSame));
 }
@@ -23,6 +23,7 @@ typedef struct ZstCompress
 {
     ZSTD_CStream *context;                                          // Compression context
     int level;                                                      // Compression level
+    unsigned int thread;                                            // Worker threads (0 when compressing in the calling thread)
     IoFilter *filter;                                               // Filter interface
 
     bool inputSame;                                                 // Is the same input required on the next process call?
@@ -37,8 +38,8 @@ static void
 zstCompressToLog(const ZstCompress *const this, StringStatic *const debugLog)
 {
     strStcFmt(
-        debugLog, "{level: %d, inputSame: %s, inputOffset: %zu, flushing: %s}", this->level, cvtBoolToConstZ(this->inputSame),
-        this->inputOffset, cvtBoolToConstZ(this->flushing));
+        debugLog, "{level: %d, thread: %u, inputSame: %s, inputOffset: %zu, flushing: %s}", this->level, this->thread,
+        cvtBoolToConstZ(this->inputSame), this->inputOffset, cvtBoolToConstZ(this->flushing));
 }
 
 #define FUNCTION_LOG_ZST_COMPRESS_TYPE                                                                                             \
@@ -104,8 +105,14 @@ zstCompressProcess(THIS_VOID, const Buffer *const uncompressed, Buffer *const co
             .size = bufUsed(uncompressed) - this->inputOffset,
         };
 
-        // Perform compression
-        zstError(ZSTD_compressStream(this->context, &out, &in));
+        // Perform compression. With worker threads a call accepts at most one job of input and only flushes the output that is
+        // ready, so it may return with input remaining and space in the output buffer. Keep going until either the input is
+        // consumed or the output is full. This does not spin since a call that does not accept input waits for output.
+        do
+        {
+            zstError(ZSTD_compressStream(this->context, &out, &in));
+        }
+        while (this->thread > 0 && in.pos < in.size && out.pos < out.size);
 
         // If the input buffer was not entirely consumed then set inputSame and store the offset where processing will restart
         if (in.pos < in.size)
@@ -165,11 +172,12 @@ zstCompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
-zstCompressNew(const int level, const bool raw)
+zstCompressNew(const int level, const bool raw, const unsigned int thread)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(INT, level);
         (void)raw;                                                  // Raw unsupported
+        FUNCTION_LOG_PARAM(UINT, thread);
     FUNCTION_LOG_END();
 
     ASSERT(level >= ZST_COMPRESS_LEVEL_MIN && level <= ZST_COMPRESS_LEVEL_MAX);
@@ -187,14 +195,27 @@ zstCompressNew(const int level, const bool raw)
 
         // Initialize context
         zstError(ZSTD_initCStream(this->context, this->level));
+
+#if ZSTD_VERSION_NUMBER >= 10400
+        // Split the input into jobs that are compressed concurrently by worker threads. The output is still a single frame so it
+        // can be decompressed normally. The number of workers is limited by the library, which will not allow any workers when it
+        // was built without thread support.
+        if (thread > 1)
+        {
+            const unsigned int threadMax = (unsigned int)ZSTD_cParam_getBounds(ZSTD_c_nbWorkers).upperBound;
+
+            this->thread = thread > threadMax ? threadMax : thread;
+            zstError(ZSTD_CCtx_setParameter(this->context, ZSTD_c_nbWorkers, (int)this->thread));
+        }
+#endif
     }
     OBJ_NEW_END();
 
     FUNCTION_LOG_RETURN(
         IO_FILTER,
         ioFilterNewP(
-            ZST_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw), .done = zstCompressDone, .inOut = zstCompressProcess,
-            .inputSame = zstCompressInputSame));
+            ZST_COMPRESS_FILTER_TYPE, this, compressParamList(level, raw, thread), .done = zstCompressDone,
+            .inOut = zstCompressProcess, .inputSame = zstCompressInputSame));
 }
 
 #endif // HAVE_LIBZST
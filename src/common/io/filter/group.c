@@ -179,6 +179,18 @@ ioFilterGroupOpen(IoFilterGroup *const this)
         if (ioFilterGroupSize(this) == 0 ||
             !ioFilterOutput((ioFilterGroupGet(this, ioFilterGroupSize(this) - 1))->filter))
         {
+            // If no filter produces output then the input is passed through unmodified
+            this->pub.passThrough = true;
+
+            for (unsigned int filterIdx = 0; filterIdx < ioFilterGroupSize(this); filterIdx++)
+            {
+                if (ioFilterOutput(ioFilterGroupGet(this, filterIdx)->filter))
+                {
+                    this->pub.passThrough = false;
+                    break;
+                }
+            }
+
             ioFilterGroupAdd(this, ioBufferNew());
         }
 
@@ -225,6 +237,59 @@ ioFilterGroupOpen(IoFilterGroup *const this)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Process a run of consecutive input filters starting at filterIdx and return the index of the last filter in the run
+
+Input filters do not produce output so consecutive input filters all see the same input buffer. Rather than have each filter walk
+the entire buffer in turn, the buffer is split into chunks small enough to stay in cache and each chunk is passed to every filter in
+the run before moving on to the next chunk. The chunk size is a multiple of all supported page sizes so filters that expect
+page-aligned input will see the same alignment as they would with the full buffer.
+***********************************************************************************************************************************/
+#define IO_FILTER_GROUP_CHUNK_SIZE                                  ((size_t)64 * 1024)
+
+static unsigned int
+ioFilterGroupProcessIn(IoFilterGroup *const this, const unsigned int filterIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_FILTER_GROUP, this);
+        FUNCTION_TEST_PARAM(UINT, filterIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!ioFilterOutput(ioFilterGroupGet(this, filterIdx)->filter));
+
+    const Buffer *const input = *ioFilterGroupGet(this, filterIdx)->input;
+
+    // Find the end of the run. The last filter in the group always produces output so the run cannot extend past it.
+    unsigned int filterEndIdx = filterIdx + 1;
+
+    while (!ioFilterOutput(ioFilterGroupGet(this, filterEndIdx)->filter))
+        filterEndIdx++;
+
+    // Process the input in chunks when there is more than one filter and more than one chunk
+    if (input != NULL && filterEndIdx - filterIdx > 1 && bufUsed(input) > IO_FILTER_GROUP_CHUNK_SIZE)
+    {
+        for (size_t chunkIdx = 0; chunkIdx < bufUsed(input); chunkIdx += IO_FILTER_GROUP_CHUNK_SIZE)
+        {
+            const size_t chunkSize =
+                bufUsed(input) - chunkIdx < IO_FILTER_GROUP_CHUNK_SIZE ? bufUsed(input) - chunkIdx : IO_FILTER_GROUP_CHUNK_SIZE;
+            const Buffer *const chunk = BUF(bufPtrConst(input) + chunkIdx, chunkSize);
+
+            for (unsigned int runIdx = filterIdx; runIdx < filterEndIdx; runIdx++)
+                ioFilterProcessIn(ioFilterGroupGet(this, runIdx)->filter, chunk);
+        }
+    }
+    // Else process the entire input (or flush) with each filter. Filters in the run always see the same input so they will all be
+    // done or not done together.
+    else
+    {
+        for (unsigned int runIdx = filterIdx; runIdx < filterEndIdx; runIdx++)
+            ioFilterProcessIn(ioFilterGroupGet(this, runIdx)->filter, input);
+    }
+
+    FUNCTION_TEST_RETURN(UINT, filterEndIdx - 1);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 ioFilterGroupProcess(IoFilterGroup *const this, const Buffer *const input, Buffer *const output)
@@ -314,7 +379,7 @@ ioFilterGroupProcess(IoFilterGroup *const this, const Buffer *const input, Buffe
                 }
                 // Else the filter does not produce output
                 else
-                    ioFilterProcessIn(filterData->filter, *filterData->input);
+                    filterIdx = ioFilterGroupProcessIn(this, filterIdx);
             }
 
             // If the filter is done and has no more output then null the output buffer. Downstream filters have a pointer to this
@@ -351,6 +416,30 @@ ioFilterGroupProcess(IoFilterGroup *const this, const Buffer *const input, Buffe
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN void
+ioFilterGroupProcessPassThrough(IoFilterGroup *const this, const Buffer *const input)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_FILTER_GROUP, this);
+        FUNCTION_LOG_PARAM(BUFFER, input);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->pub.opened && !this->pub.closed);
+    ASSERT(this->pub.passThrough && !this->pub.inputSame);
+    ASSERT(input != NULL && !bufEmpty(input));
+    ASSERT(!this->flushing);
+
+    this->input = input;
+
+    // The last filter is the buffer filter added on open so only the input filters before it need to see the input
+    if (ioFilterGroupSize(this) > 1)
+        ioFilterGroupProcessIn(this, 0);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 ioFilterGroupClose(IoFilterGroup *this)
@@ -34,6 +34,7 @@ typedef struct IoFilterGroupPub
     List *filterList;                                               // List of filters to apply
     bool inputSame;                                                 // Same input required again?
     bool done;                                                      // Is processing done?
+    bool passThrough;                                               // Do the filters pass the input through unmodified?
 
 #ifdef DEBUG
     bool opened;                                                    // Has the filter set been opened?
@@ -58,6 +59,16 @@ ioFilterGroupInputSame(const IoFilterGroup *const this)
     return THIS_PUB(IoFilterGroup)->inputSame;
 }
 
+// Do the filters pass the input through unmodified? This is true when no filter produces output, i.e. the filters only observe the
+// input (e.g. to calculate a hash or size). In this case the input does not need to be copied to an output buffer and can be
+// processed with ioFilterGroupProcessPassThrough() instead.
+FN_INLINE_ALWAYS bool
+ioFilterGroupPassThrough(const IoFilterGroup *const this)
+{
+    ASSERT_INLINE(THIS_PUB(IoFilterGroup)->opened && !THIS_PUB(IoFilterGroup)->closed);
+    return THIS_PUB(IoFilterGroup)->passThrough;
+}
+
 // Get all filters and their parameters so they can be passed to a remote
 FN_EXTERN Pack *ioFilterGroupParamAll(const IoFilterGroup *this);
 
@@ -107,6 +118,10 @@ FN_EXTERN void ioFilterGroupOpen(IoFilterGroup *this);
 // Process filters
 FN_EXTERN void ioFilterGroupProcess(IoFilterGroup *this, const Buffer *input, Buffer *output);
 
+// Process filters in place when the group is pass-through. The caller is responsible for moving the input to its destination, which
+// avoids copying it to an output buffer. Flushing must still be done with ioFilterGroupProcess().
+FN_EXTERN void ioFilterGroupProcessPassThrough(IoFilterGroup *this, const Buffer *input);
+
 // Close filter group and gather results
 FN_EXTERN void ioFilterGroupClose(IoFilterGroup *this);
 
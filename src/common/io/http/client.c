@@ -15,8 +15,10 @@ Statistics constants
 ***********************************************************************************************************************************/
 STRING_EXTERN(HTTP_STAT_CLIENT_STR,                                 HTTP_STAT_CLIENT);
 STRING_EXTERN(HTTP_STAT_CLOSE_STR,                                  HTTP_STAT_CLOSE);
+STRING_EXTERN(HTTP_STAT_EVICT_STR,                                  HTTP_STAT_EVICT);
 STRING_EXTERN(HTTP_STAT_REQUEST_STR,                                HTTP_STAT_REQUEST);
 STRING_EXTERN(HTTP_STAT_RETRY_STR,                                  HTTP_STAT_RETRY);
+STRING_EXTERN(HTTP_STAT_REUSE_STR,                                  HTTP_STAT_REUSE);
 STRING_EXTERN(HTTP_STAT_SESSION_STR,                                HTTP_STAT_SESSION);
 
 /***********************************************************************************************************************************
@@ -26,10 +28,34 @@ struct HttpClient
 {
     HttpClientPub pub;                                              // Publicly accessible variables
     IoClient *ioClient;                                             // Io client (e.g. TLS or socket client)
+    unsigned int sessionMax;                                        // Maximum sessions kept for reuse (0 for no limit)
+    TimeMSec sessionIdle;                                           // Close sessions idle longer than this (0 to never close)
 
-    List *sessionReuseList;                                         // List of HTTP sessions that can be reused
+    List *sessionReuseList;                                         // List of HTTP sessions that can be reused (oldest first)
 };
 
+// Session that can be reused
+typedef struct HttpClientSession
+{
+    HttpSession *session;                                           // Session
+    TimeMSec time;                                                  // Time the session was returned for reuse
+} HttpClientSession;
+
+/***********************************************************************************************************************************
+Mem context and local variables
+***********************************************************************************************************************************/
+typedef struct HttpClientShared
+{
+    const String *key;                                              // Key that identifies the endpoint and settings
+    HttpClient *client;                                             // Client shared by all callers with the same key
+} HttpClientShared;
+
+static struct HttpClientLocal
+{
+    MemContext *memContext;                                         // Mem context for shared clients
+    List *sharedList;                                               // List of shared clients
+} httpClientLocal;
+
 /**********************************************************************************************************************************/
 FN_EXTERN HttpClient *
 httpClientNew(IoClient *const ioClient, const TimeMSec timeout)
@@ -50,7 +76,7 @@ httpClientNew(IoClient *const ioClient, const TimeMSec timeout)
                 .timeout = timeout,
             },
             .ioClient = ioClient,
-            .sessionReuseList = lstNewP(sizeof(HttpSession *)),
+            .sessionReuseList = lstNewP(sizeof(HttpClientSession)),
         };
 
         statInc(HTTP_STAT_CLIENT_STR);
@@ -60,6 +86,86 @@ httpClientNew(IoClient *const ioClient, const TimeMSec timeout)
     FUNCTION_LOG_RETURN(HTTP_CLIENT, this);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN HttpClient *
+httpClientShared(const String *const key, IoClient *const ioClient, const TimeMSec timeout, const HttpClientSharedParam param)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, key);
+        FUNCTION_LOG_PARAM(IO_CLIENT, ioClient);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+        FUNCTION_LOG_PARAM(UINT, param.sessionMax);
+    FUNCTION_LOG_END();
+
+    ASSERT(key != NULL);
+    ASSERT(ioClient != NULL);
+
+    // Allocate a mem context to hold shared clients
+    if (httpClientLocal.memContext == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            MEM_CONTEXT_NEW_BEGIN(HttpClientShared, .childQty = MEM_CONTEXT_QTY_MAX)
+            {
+                httpClientLocal.memContext = MEM_CONTEXT_NEW();
+                httpClientLocal.sharedList = lstNewP(sizeof(HttpClientShared), .comparator = lstComparatorStr);
+            }
+            MEM_CONTEXT_NEW_END();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    // Find the shared client or create it when missing. The client is never freed so it outlives any session it creates.
+    HttpClientShared *shared = lstFind(httpClientLocal.sharedList, &key);
+
+    if (shared == NULL)
+    {
+        MEM_CONTEXT_BEGIN(lstMemContext(httpClientLocal.sharedList))
+        {
+            HttpClient *const client = httpClientNew(ioClientMove(ioClient, memContextCurrent()), timeout);
+
+            // Sessions idle for longer than the timeout are likely to have been closed by the server
+            client->sessionIdle = timeout;
+
+            shared = lstAdd(httpClientLocal.sharedList, &(HttpClientShared){.key = strDup(key), .client = client});
+        }
+        MEM_CONTEXT_END();
+    }
+    // Else the client is not needed
+    else
+        ioClientFree(ioClient);
+
+    // Keep enough sessions for the caller that needs the most
+    if (shared->client->sessionMax < param.sessionMax)
+        shared->client->sessionMax = param.sessionMax;
+
+    FUNCTION_LOG_RETURN(HTTP_CLIENT, shared->client);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+httpClientSharedClose(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    if (httpClientLocal.memContext != NULL)
+    {
+        for (unsigned int sharedIdx = 0; sharedIdx < lstSize(httpClientLocal.sharedList); sharedIdx++)
+        {
+            const HttpClientShared *const shared = lstGet(httpClientLocal.sharedList, sharedIdx);
+            List *const sessionReuseList = shared->client->sessionReuseList;
+
+            while (!lstEmpty(sessionReuseList))
+            {
+                httpSessionFree(((HttpClientSession *)lstGet(sessionReuseList, 0))->session);
+                lstRemoveIdx(sessionReuseList, 0);
+            }
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN HttpSession *
 httpClientOpen(HttpClient *const this)
@@ -72,15 +178,32 @@ httpClientOpen(HttpClient *const this)
 
     HttpSession *result = NULL;
 
+    // Close sessions that have been idle too long rather than sending a request that is likely to fail and be retried
+    if (this->sessionIdle != 0)
+    {
+        const TimeMSec timeBegin = timeMSec();
+
+        while (
+            !lstEmpty(this->sessionReuseList) &&
+            timeBegin - ((HttpClientSession *)lstGet(this->sessionReuseList, 0))->time >= this->sessionIdle)
+        {
+            httpSessionFree(((HttpClientSession *)lstGet(this->sessionReuseList, 0))->session);
+            lstRemoveIdx(this->sessionReuseList, 0);
+
+            statInc(HTTP_STAT_EVICT_STR);
+        }
+    }
+
     // Check if there is a reusable session
     if (!lstEmpty(this->sessionReuseList))
     {
         // Remove session from reusable list
-        result = *(HttpSession **)lstGet(this->sessionReuseList, 0);
+        result = ((HttpClientSession *)lstGet(this->sessionReuseList, 0))->session;
         lstRemoveIdx(this->sessionReuseList, 0);
 
         // Move session to the calling context
         httpSessionMove(result, memContextCurrent());
+        statInc(HTTP_STAT_REUSE_STR);
     }
     // Else create a new session
     else
@@ -104,8 +227,18 @@ httpClientReuse(HttpClient *const this, HttpSession *const session)
     ASSERT(this != NULL);
     ASSERT(session != NULL);
 
-    httpSessionMove(session, lstMemContext(this->sessionReuseList));
-    lstAdd(this->sessionReuseList, &session);
+    // Close the session when the maximum sessions are already being kept for reuse
+    if (this->sessionMax != 0 && lstSize(this->sessionReuseList) >= this->sessionMax)
+    {
+        httpSessionFree(session);
+        statInc(HTTP_STAT_EVICT_STR);
+    }
+    // Else keep the session for reuse
+    else
+    {
+        httpSessionMove(session, lstMemContext(this->sessionReuseList));
+        lstAdd(this->sessionReuseList, &(HttpClientSession){.session = session, .time = timeMSec()});
+    }
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -8,6 +8,10 @@ automatically retried when the connection has been closed by the server. Any 5xx
 
 Only the HTTPS protocol is currently supported.
 
+Clients returned by httpClientShared() are kept for the life of the process and shared by all callers that connect to the same
+endpoint with the same settings, so connections are reused across objects (e.g. the read and write storage for a repository) rather
+than being opened by each object.
+
 IMPORTANT NOTE: HttpClient should have a longer lifetime than any active HttpSession objects. This does not apply to HttpSession
 objects that are freed, i.e. if an error occurs it does not matter in what order HttpClient and HttpSession objects are destroyed,
 or HttpSession objects that have been returned to the client with httpClientReuse(). The danger is when an active HttpResponse
@@ -32,10 +36,14 @@ Statistics constants
 STRING_DECLARE(HTTP_STAT_CLIENT_STR);
 #define HTTP_STAT_CLOSE                                             "http.close"        // Closes forced by server
 STRING_DECLARE(HTTP_STAT_CLOSE_STR);
+#define HTTP_STAT_EVICT                                             "http.evict"        // Idle sessions closed by client
+STRING_DECLARE(HTTP_STAT_EVICT_STR);
 #define HTTP_STAT_REQUEST                                           "http.request"      // Requests (i.e. calls to httpRequestNew())
 STRING_DECLARE(HTTP_STAT_REQUEST_STR);
 #define HTTP_STAT_RETRY                                             "http.retry"        // Request retries
 STRING_DECLARE(HTTP_STAT_RETRY_STR);
+#define HTTP_STAT_REUSE                                             "http.reuse"        // Sessions reused
+STRING_DECLARE(HTTP_STAT_REUSE_STR);
 #define HTTP_STAT_SESSION                                           "http.session"      // Sessions created
 STRING_DECLARE(HTTP_STAT_SESSION_STR);
 
@@ -44,6 +52,20 @@ Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN HttpClient *httpClientNew(IoClient *ioClient, TimeMSec timeout);
 
+// Get the shared client for the key, creating it with the io client provided when it does not exist. The io client is freed when
+// the shared client already exists. The key must identify everything that affects the connection, e.g. host, port, and TLS
+// settings. Sessions that are idle longer than the timeout are closed rather than reused.
+typedef struct HttpClientSharedParam
+{
+    VAR_PARAM_HEADER;
+    unsigned int sessionMax;                                        // Maximum sessions kept for reuse
+} HttpClientSharedParam;
+
+#define httpClientSharedP(key, ioClient, timeout, ...)                                                                             \
+    httpClientShared(key, ioClient, timeout, (HttpClientSharedParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+FN_EXTERN HttpClient *httpClientShared(const String *key, IoClient *ioClient, TimeMSec timeout, HttpClientSharedParam param);
+
 /***********************************************************************************************************************************
 Getters/Setters
 ***********************************************************************************************************************************/
@@ -67,6 +89,9 @@ FN_EXTERN HttpSession *httpClientOpen(HttpClient *this);
 // Request/response finished cleanly so session can be reused
 FN_EXTERN void httpClientReuse(HttpClient *this, HttpSession *session);
 
+// Close the sessions kept for reuse by shared clients
+FN_EXTERN void httpClientSharedClose(void);
+
 /***********************************************************************************************************************************
 Macros for function logging
 ***********************************************************************************************************************************/
@@ -0,0 +1,173 @@
+/***********************************************************************************************************************************
+HTTP Read-Ahead
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "common/debug.h"
+#include "common/io/http/readAhead.h"
+#include "common/log.h"
+#include "common/type/list.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct HttpReadAhead
+{
+    HttpReadAheadPub pub;                                           // Publicly accessible variables
+    HttpReadAheadNewParam param;                                    // Driver and callbacks
+    size_t rangeSize;                                               // Size of each range
+    unsigned int rangeMax;                                          // Maximum ranges in progress (including the current range)
+    uint64_t rangeOffset;                                           // Offset of the next range to request
+    uint64_t rangeEnd;                                              // Offset where the content ends
+    List *requestList;                                              // Ranges requested but not yet being read (oldest first)
+    HttpResponse *response;                                         // Response for the range currently being read
+    uint64_t responseRemains;                                       // Content remaining in the range currently being read
+};
+
+// Range that has been requested
+typedef struct HttpReadAheadRange
+{
+    HttpRequest *request;                                           // Request for the range
+    uint64_t size;                                                  // Size of the range
+} HttpReadAheadRange;
+
+/***********************************************************************************************************************************
+Request ranges until the maximum are in progress or all ranges have been requested
+***********************************************************************************************************************************/
+static void
+httpReadAheadRequest(HttpReadAhead *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_READ_AHEAD, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    while (lstSize(this->requestList) + (this->response == NULL ? 0 : 1) < this->rangeMax && this->rangeOffset < this->rangeEnd)
+    {
+        HttpReadAheadRange range =
+        {
+            .size = this->rangeEnd - this->rangeOffset < this->rangeSize ? this->rangeEnd - this->rangeOffset : this->rangeSize,
+        };
+
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            range.request = this->param.request(this->param.driver, this->rangeOffset, range.size);
+        }
+        MEM_CONTEXT_OBJ_END();
+
+        lstAdd(this->requestList, &range);
+        this->rangeOffset += range.size;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN HttpReadAhead *
+httpReadAheadNew(
+    HttpResponse *const response, const uint64_t offset, const uint64_t size, const size_t rangeSize, const unsigned int rangeMax,
+    const HttpReadAheadNewParam param)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(HTTP_RESPONSE, response);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(UINT64, size);
+        FUNCTION_LOG_PARAM(SIZE, rangeSize);
+        FUNCTION_LOG_PARAM(UINT, rangeMax);
+        FUNCTION_LOG_PARAM_P(VOID, param.driver);
+        FUNCTION_LOG_PARAM(FUNCTIONP, param.request);
+        FUNCTION_LOG_PARAM(FUNCTIONP, param.response);
+    FUNCTION_LOG_END();
+
+    ASSERT(response != NULL);
+    ASSERT(size > 0);
+    ASSERT(rangeSize > 0);
+    ASSERT(rangeMax > 0);
+    ASSERT(param.request != NULL);
+    ASSERT(param.response != NULL);
+
+    OBJ_NEW_BEGIN(HttpReadAhead, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (HttpReadAhead)
+        {
+            .param = param,
+            .rangeSize = rangeSize,
+            .rangeMax = rangeMax,
+            .rangeEnd = offset + size,
+            .requestList = lstNewP(sizeof(HttpReadAheadRange)),
+            .response = httpResponseMove(response, objMemContext(this)),
+            .responseRemains = size < rangeSize ? size : rangeSize,
+        };
+
+        this->rangeOffset = offset + this->responseRemains;
+    }
+    OBJ_NEW_END();
+
+    // The first range is read from the response provided so request the ranges that follow it
+    httpReadAheadRequest(this);
+
+    FUNCTION_LOG_RETURN(HTTP_READ_AHEAD, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN size_t
+httpReadAhead(HttpReadAhead *const this, Buffer *const buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_READ_AHEAD, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(buffer != NULL);
+
+    const size_t bufferRemains = bufRemains(buffer);
+
+    while (!this->pub.eof && !bufFull(buffer))
+    {
+        // Get the response for the oldest range when there is no range being read
+        if (this->response == NULL)
+        {
+            const HttpReadAheadRange *const range = lstGet(this->requestList, 0);
+
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->response = this->param.response(this->param.driver, range->request);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            this->responseRemains = range->size;
+
+            httpRequestFree(range->request);
+            lstRemoveIdx(this->requestList, 0);
+        }
+
+        // Read no more than the content remaining in the range. The response may contain more content than the range (see header
+        // for details) so reading past the range must be prevented.
+        const size_t bufferSize = bufSize(buffer);
+
+        if (bufRemains(buffer) > this->responseRemains)
+            bufLimitSet(buffer, bufUsed(buffer) + (size_t)this->responseRemains);
+
+        IoRead *const read = httpResponseIoRead(this->response);
+        this->responseRemains -= ioRead(read, buffer);
+        bufLimitSet(buffer, bufferSize);
+
+        if (this->responseRemains != 0 && ioReadEof(read))
+            THROW(FormatError, "unexpected eof in range response");
+
+        // When the range is done free the response so the connection can be used to request another range. If the response has
+        // content remaining after the range then the connection will be closed rather than reused.
+        if (this->responseRemains == 0)
+        {
+            httpResponseFree(this->response);
+            this->response = NULL;
+
+            httpReadAheadRequest(this);
+            this->pub.eof = lstEmpty(this->requestList);
+        }
+    }
+
+    FUNCTION_LOG_RETURN(SIZE, bufferRemains - bufRemains(buffer));
+}
@@ -0,0 +1,86 @@
+/***********************************************************************************************************************************
+HTTP Read-Ahead
+
+Read a large object as a series of byte ranges that are requested ahead of the reader on separate connections. The responses are
+returned in order so the object can be read as a single stream and filters (e.g. decompression, decryption) are not affected.
+
+The response for the first range is provided by the caller so errors such as a missing object can be handled in the usual way. If
+the first response contains more than the first range (e.g. the object size was not known when the request was made) then only the
+first range is used. The rest of the content is discarded and the connection is closed if the content has not been read completely.
+
+Ranges are requested with separate requests so the object could be replaced between them. The driver should make the range requests
+conditional on the version read by the first request (e.g. If-Match with the ETag) and error in the response callback when the
+condition fails.
+***********************************************************************************************************************************/
+#ifndef COMMON_IO_HTTP_READAHEAD_H
+#define COMMON_IO_HTTP_READAHEAD_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct HttpReadAhead HttpReadAhead;
+
+#include "common/io/http/request.h"
+#include "common/io/http/response.h"
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+typedef struct HttpReadAheadNewParam
+{
+    VAR_PARAM_HEADER;
+    void *driver;                                                   // Driver passed to the callbacks
+
+    // Send a request for a range of the object
+    HttpRequest *(*request)(void *driver, uint64_t offset, uint64_t size);
+
+    // Get the response for a range request. The callback is responsible for throwing an error when the response is not valid.
+    HttpResponse *(*response)(void *driver, HttpRequest *request);
+} HttpReadAheadNewParam;
+
+#define httpReadAheadNewP(response, offset, size, rangeSize, rangeMax, ...)                                                        \
+    httpReadAheadNew(response, offset, size, rangeSize, rangeMax, (HttpReadAheadNewParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+FN_EXTERN HttpReadAhead *httpReadAheadNew(
+    HttpResponse *response, uint64_t offset, uint64_t size, size_t rangeSize, unsigned int rangeMax, HttpReadAheadNewParam param);
+
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+typedef struct HttpReadAheadPub
+{
+    bool eof;                                                       // Has all the content been read?
+} HttpReadAheadPub;
+
+// Has all the content been read?
+FN_INLINE_ALWAYS bool
+httpReadAheadEof(const HttpReadAhead *const this)
+{
+    return THIS_PUB(HttpReadAhead)->eof;
+}
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Read content into the buffer until it is full or all content has been read
+FN_EXTERN size_t httpReadAhead(HttpReadAhead *this, Buffer *buffer);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+httpReadAheadFree(HttpReadAhead *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_HTTP_READ_AHEAD_TYPE                                                                                          \
+    HttpReadAhead *
+#define FUNCTION_LOG_HTTP_READ_AHEAD_FORMAT(value, buffer, bufferSize)                                                             \
+    objNameToLog(value, "HttpReadAhead", buffer, bufferSize)
+
+#endif
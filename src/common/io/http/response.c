@@ -451,6 +451,19 @@ httpResponseContent(HttpResponse *const this)
     FUNCTION_TEST_RETURN(BUFFER, this->content);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN uint64_t
+httpResponseContentSize(const HttpResponse *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(HTTP_RESPONSE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(UINT64, this->contentChunked ? 0 : this->contentSize);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN HttpResponseMulti *
 httpResponseMultiNew(const Buffer *const content, const String *const contentType)
@@ -24,6 +24,7 @@ HTTP Response Constants
 #define HTTP_RESPONSE_CODE_PERMANENT_REDIRECT                       308
 #define HTTP_RESPONSE_CODE_FORBIDDEN                                403
 #define HTTP_RESPONSE_CODE_NOT_FOUND                                404
+#define HTTP_RESPONSE_CODE_PRECONDITION_FAILED                      412
 
 // 2xx indicates success
 #define HTTP_RESPONSE_CODE_CLASS_OK                                 2
@@ -96,6 +97,9 @@ httpResponseCodeRetry(const HttpResponse *const this)
 // Fetch all response content. Content will be cached so it can be retrieved again without additional cost.
 FN_EXTERN const Buffer *httpResponseContent(HttpResponse *this);
 
+// Size of the response content from the content-length header. Zero is returned when the size is not known, e.g. chunked content.
+FN_EXTERN uint64_t httpResponseContentSize(const HttpResponse *this);
+
 // Move to a new parent mem context
 FN_INLINE_ALWAYS HttpResponse *
 httpResponseMove(HttpResponse *const this, MemContext *const parentNew)
@@ -119,6 +119,25 @@ ioReadInternal(IoRead *const this, Buffer *const buffer, const bool block)
         {
             ioFilterGroupProcess(this->pub.filterGroup, this->input, buffer);
         }
+        // Else read directly into the output buffer when the filter group does not modify the input. The filters can observe the
+        // data in place so there is no need to read into the input buffer and copy it to the output buffer. Drivers may depend on
+        // the size of the buffer they are given, e.g. to read ahead to the end of HTTP content, and may set and clear limits on it,
+        // so only do this when the output buffer is empty, unlimited, and the same size as the input buffer.
+        else if (
+            this->input != NULL && !ioReadEofDriver(this) && ioFilterGroupPassThrough(this->pub.filterGroup) && bufEmpty(buffer) &&
+            bufSize(buffer) == bufSizeAlloc(buffer) && bufSize(buffer) == bufSize(this->input))
+        {
+            ioReadInterface(this)->read(ioReadDriver(this), buffer, block);
+
+            if (!bufEmpty(buffer))
+            {
+                ioFilterGroupProcessPassThrough(this->pub.filterGroup, buffer);
+
+                // Stop if not blocking -- we don't need to fill the buffer as long as we got some data
+                if (!block)
+                    break;
+            }
+        }
         // Else new input can be accepted
         else
         {
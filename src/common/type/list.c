@@ -17,7 +17,6 @@ struct List
 {
     ListPub pub;                                                    // Publicly accessible variables
     unsigned int listSizeMax;
-    SortOrder sortOrder;
     uint8_t *listAlloc;                                             // Pointer to memory allocated for the list
     ListComparator *comparator;
 };
@@ -38,8 +37,8 @@ lstNew(const size_t itemSize, const ListParam param)
             .pub =
             {
                 .itemSize = itemSize,
+                .sortOrder = param.sortOrder,
             },
-            .sortOrder = param.sortOrder,
             .comparator = param.comparator,
         };
     }
@@ -202,9 +201,9 @@ lstFind(const List *const this, const void *const item)
 
     if (this->pub.list != NULL)
     {
-        if (this->sortOrder == sortOrderAsc)
+        if (this->pub.sortOrder == sortOrderAsc)
             FUNCTION_TEST_RETURN_P(VOID, bsearch(item, this->pub.list, lstSize(this), this->pub.itemSize, this->comparator));
-        else if (this->sortOrder == sortOrderDesc)
+        else if (this->pub.sortOrder == sortOrderDesc)
         {
             // Assign the list for the descending comparator to use
             comparatorDescList = this;
@@ -331,7 +330,7 @@ lstInsert(List *const this, const unsigned int listIdx, const void *const item)
         memmove(this->pub.list + ((listIdx + 1) * this->pub.itemSize), itemPtr, (lstSize(this) - listIdx) * this->pub.itemSize);
 
     // Copy item into the list
-    this->sortOrder = sortOrderNone;
+    this->pub.sortOrder = sortOrderNone;
     memcpy(itemPtr, item, this->pub.itemSize);
     this->pub.listSize++;
 
@@ -440,7 +439,7 @@ lstSort(List *const this, const SortOrder sortOrder)
         }
     }
 
-    this->sortOrder = sortOrder;
+    this->pub.sortOrder = sortOrder;
 
     FUNCTION_TEST_RETURN(LIST, this);
 }
@@ -457,7 +456,7 @@ lstComparatorSet(List *const this, ListComparator *const comparator)
     ASSERT(this != NULL);
 
     this->comparator = comparator;
-    this->sortOrder = sortOrderNone;
+    this->pub.sortOrder = sortOrderNone;
 
     FUNCTION_TEST_RETURN(LIST, this);
 }
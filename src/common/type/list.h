@@ -82,6 +82,7 @@ typedef struct ListPub
     unsigned int listSize;                                          // List size
     size_t itemSize;                                                // Size of item stored in the list
     uint8_t *list;                                                  // Pointer to the current start of the list
+    SortOrder sortOrder;                                            // Current sort order
 } ListPub;
 
 // Set a new comparator
@@ -108,6 +109,15 @@ lstEmpty(const List *const this)
     return lstSize(this) == 0;
 }
 
+// Current sort order. Adding items or setting a new comparator resets the sort order to none. This allows a caller that compares
+// items without building a search key, e.g. manifest file names in packed form, to use a binary search or merge only when the list is
+// known to be sorted and to skip sorting a list that is already sorted.
+FN_INLINE_ALWAYS SortOrder
+lstSortOrder(const List *const this)
+{
+    return THIS_PUB(List)->sortOrder;
+}
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
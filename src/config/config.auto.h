@@ -43,6 +43,7 @@ Option group constants
 /***********************************************************************************************************************************
 Option constants
 ***********************************************************************************************************************************/
+#define CFGOPT_ALLOCATE                                             "allocate"
 #define CFGOPT_ANNOTATION                                           "annotation"
 #define CFGOPT_ARCHIVE_ASYNC                                        "archive-async"
 #define CFGOPT_ARCHIVE_CHECK                                        "archive-check"
@@ -62,8 +63,10 @@ Option constants
 #define CFGOPT_CMD                                                  "cmd"
 #define CFGOPT_CMD_SSH                                              "cmd-ssh"
 #define CFGOPT_COMPRESS                                             "compress"
+#define CFGOPT_COMPRESS_ADAPTIVE                                    "compress-adaptive"
 #define CFGOPT_COMPRESS_LEVEL                                       "compress-level"
 #define CFGOPT_COMPRESS_LEVEL_NETWORK                               "compress-level-network"
+#define CFGOPT_COMPRESS_THREAD                                      "compress-thread"
 #define CFGOPT_COMPRESS_TYPE                                        "compress-type"
 #define CFGOPT_CONFIG                                               "config"
 #define CFGOPT_CONFIG_INCLUDE_PATH                                  "config-include-path"
@@ -97,6 +100,7 @@ Option constants
 #define CFGOPT_NEUTRAL_UMASK                                        "neutral-umask"
 #define CFGOPT_ONLINE                                               "online"
 #define CFGOPT_OUTPUT                                               "output"
+#define CFGOPT_PAGE_CACHE_DROP                                      "page-cache-drop"
 #define CFGOPT_PAGE_HEADER_CHECK                                    "page-header-check"
 #define CFGOPT_PG                                                   "pg"
 #define CFGOPT_PG_VERSION_FORCE                                     "pg-version-force"
@@ -104,6 +108,8 @@ Option constants
 #define CFGOPT_PROCESS_MAX                                          "process-max"
 #define CFGOPT_PROTOCOL_TIMEOUT                                     "protocol-timeout"
 #define CFGOPT_RAW                                                  "raw"
+#define CFGOPT_READ_AHEAD                                           "read-ahead"
+#define CFGOPT_READ_GAP_MAX                                         "read-gap-max"
 #define CFGOPT_RECOVERY_OPTION                                      "recovery-option"
 #define CFGOPT_RECURSE                                              "recurse"
 #define CFGOPT_REFERENCE                                            "reference"
@@ -138,12 +144,21 @@ Option constants
 #define CFGOPT_TYPE                                                 "type"
 #define CFGOPT_VERBOSE                                              "verbose"
 #define CFGOPT_VERSION                                              "version"
+#define CFGOPT_WAL_SUMMARY                                          "wal-summary"
+#define CFGOPT_WRITE_QUEUE                                          "write-queue"
 
-#define CFG_OPTION_TOTAL                                            186
+#define CFG_OPTION_TOTAL                                            200
 
 /***********************************************************************************************************************************
 Option value constants
 ***********************************************************************************************************************************/
+#define CFGOPTVAL_ALLOCATE_FULL                                     STRID5("full", 0x632a60)
+#define CFGOPTVAL_ALLOCATE_FULL_Z                                   "full"
+#define CFGOPTVAL_ALLOCATE_NORMAL                                   STRID5("normal", 0x1816c9ee0)
+#define CFGOPTVAL_ALLOCATE_NORMAL_Z                                 "normal"
+#define CFGOPTVAL_ALLOCATE_SPARSE                                   STRID5("sparse", 0xb3906130)
+#define CFGOPTVAL_ALLOCATE_SPARSE_Z                                 "sparse"
+
 #define CFGOPTVAL_ARCHIVE_MODE_OFF                                  STRID5("off", 0x18cf0)
 #define CFGOPTVAL_ARCHIVE_MODE_OFF_Z                                "off"
 #define CFGOPTVAL_ARCHIVE_MODE_PRESERVE                             STRID5("preserve", 0x2da45996500)
@@ -394,6 +409,7 @@ Option enum
 ***********************************************************************************************************************************/
 typedef enum
 {
+    cfgOptAllocate,
     cfgOptAnnotation,
     cfgOptArchiveAsync,
     cfgOptArchiveCheck,
@@ -413,8 +429,10 @@ typedef enum
     cfgOptCmd,
     cfgOptCmdSsh,
     cfgOptCompress,
+    cfgOptCompressAdaptive,
     cfgOptCompressLevel,
     cfgOptCompressLevelNetwork,
+    cfgOptCompressThread,
     cfgOptCompressType,
     cfgOptConfig,
     cfgOptConfigIncludePath,
@@ -448,6 +466,7 @@ typedef enum
     cfgOptNeutralUmask,
     cfgOptOnline,
     cfgOptOutput,
+    cfgOptPageCacheDrop,
     cfgOptPageHeaderCheck,
     cfgOptPg,
     cfgOptPgDatabase,
@@ -473,6 +492,8 @@ typedef enum
     cfgOptProcessMax,
     cfgOptProtocolTimeout,
     cfgOptRaw,
+    cfgOptReadAhead,
+    cfgOptReadGapMax,
     cfgOptRecoveryOption,
     cfgOptRecurse,
     cfgOptReference,
@@ -486,7 +507,10 @@ typedef enum
     cfgOptRepoAzureUriStyle,
     cfgOptRepoBlock,
     cfgOptRepoBlockAgeMap,
+    cfgOptRepoBlockCdc,
     cfgOptRepoBlockChecksumSizeMap,
+    cfgOptRepoBlockDedup,
+    cfgOptRepoBlockLsn,
     cfgOptRepoBlockSizeMap,
     cfgOptRepoBlockSizeSuper,
     cfgOptRepoBlockSizeSuperFull,
@@ -545,9 +569,12 @@ typedef enum
     cfgOptRepoSftpPublicKeyFile,
     cfgOptRepoStorageCaFile,
     cfgOptRepoStorageCaPath,
+    cfgOptRepoStorageDownloadChunkMax,
+    cfgOptRepoStorageDownloadChunkSize,
     cfgOptRepoStorageHost,
     cfgOptRepoStoragePort,
     cfgOptRepoStorageTag,
+    cfgOptRepoStorageUploadChunkMax,
     cfgOptRepoStorageUploadChunkSize,
     cfgOptRepoStorageVerifyTls,
     cfgOptRepoTargetTime,
@@ -580,6 +607,8 @@ typedef enum
     cfgOptType,
     cfgOptVerbose,
     cfgOptVersion,
+    cfgOptWalSummary,
+    cfgOptWriteQueue,
 } ConfigOption;
 
 #endif
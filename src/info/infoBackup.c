@@ -429,7 +429,7 @@ infoBackupDataAdd(InfoBackup *const this, const Manifest *const manifest)
 
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
         {
-            const ManifestFile file = manifestFile(manifest, fileIdx);
+            const ManifestFile file = manifestFileUnpackP(manifest, manifestFilePackGet(manifest, fileIdx), .noName = true);
 
             backupSize += file.size;
             backupRepoSize += file.sizeRepo > 0 ? file.sizeRepo : file.size;
@@ -655,7 +655,18 @@ infoBackupDataDependentList(const InfoBackup *const this, const String *const ba
             const InfoBackupData backupData = infoBackupData(this, backupLabelIdx);
 
             // If the backupPrior is in the dependency chain add the label to the list
-            if (backupData.backupPrior != NULL && strLstExists(result, backupData.backupPrior))
+            bool dependent = backupData.backupPrior != NULL && strLstExists(result, backupData.backupPrior);
+
+            // Files and blocks (see BlockIndex) may be stored in any referenced backup so a backup that references a backup in the
+            // dependency chain is also dependent
+            for (unsigned int referenceIdx = 0;
+                 !dependent && backupData.backupReference != NULL && referenceIdx < strLstSize(backupData.backupReference);
+                 referenceIdx++)
+            {
+                dependent = strLstExists(result, strLstGet(backupData.backupReference, referenceIdx));
+            }
+
+            if (dependent)
                 strLstAdd(result, backupData.backupLabel);
         }
     }
@@ -833,7 +844,7 @@ infoBackupLoadFileReconstruct(
                 if (storageExistsP(storage, manifestFileName))
                 {
                     bool found = false;
-                    const Manifest *const manifest = manifestLoadFile(
+                    const Manifest *const manifest = manifestLoadFileP(
                         storage, manifestFileName, cipherType, infoPgCipherPass(infoBackupPg(infoBackup)));
                     const ManifestData *const manData = manifestData(manifest);
 
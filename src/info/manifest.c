@@ -15,6 +15,7 @@ Backup Manifest Handler
 #include "common/type/list.h"
 #include "info/manifest.h"
 #include "postgres/interface.h"
+#include "postgres/interface/crc32.h"
 #include "postgres/version.h"
 #include "storage/storage.h"
 #include "version.h"
@@ -27,6 +28,9 @@ STRING_EXTERN(BACKUP_MANIFEST_FILE_STR,                             BACKUP_MANIF
 STRING_EXTERN(MANIFEST_TARGET_PGDATA_STR,                           MANIFEST_TARGET_PGDATA);
 STRING_EXTERN(MANIFEST_TARGET_PGTBLSPC_STR,                         MANIFEST_TARGET_PGTBLSPC);
 
+// Placeholder for the file user/group defaults until the real defaults are known. This is not a valid name for a user or group.
+STRING_STATIC(MANIFEST_OWNER_DEFAULT_STR,                           "@");
+
 // All block incremental sizes must be divisible by this factor
 #define BLOCK_INCR_SIZE_FACTOR                                      8192
 
@@ -37,6 +41,9 @@ struct Manifest
 {
     ManifestPub pub;                                                // Publicly accessible variables
     StringList *ownerList;                                          // List of users/groups
+    List *filePathList;                                             // Sorted list of paths referenced by file packs
+    const String *filePathLast;                                     // Last file path cached
+    String *fileName;                                               // Buffer for the name returned by manifestFileNameGet()
 
     const String *fileUserDefault;                                  // Default file user name
     const String *fileGroupDefault;                                 // Default file group name
@@ -94,6 +101,170 @@ manifestDbAdd(Manifest *const this, const ManifestDb *const db)
 // Base time used as a delta to reduce the size of packed timestamps. This will be set on the first call to manifestFilePack().
 static time_t manifestPackBaseTime = -1;
 
+// Most files share a path with many other files so the path is stored once in the manifest and only the leaf name is stored in the
+// pack. The packed data follows the zero-terminated leaf name.
+struct ManifestFilePack
+{
+    const String *path;                                             // Path from the path list (NULL when the name has no path)
+    char leaf[];                                                    // Leaf name
+};
+
+// Find a path in the sorted path list. If the path is not found then the index where it should be inserted is returned.
+static unsigned int
+manifestFilePathIdx(const List *const pathList, const char *const path, const size_t pathSize, bool *const found)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LIST, pathList);
+        FUNCTION_TEST_PARAM_P(VOID, path);
+        FUNCTION_TEST_PARAM(SIZE, pathSize);
+        FUNCTION_TEST_PARAM_P(VOID, found);
+    FUNCTION_TEST_END();
+
+    ASSERT(pathList != NULL);
+    ASSERT(path != NULL);
+    ASSERT(found != NULL);
+
+    unsigned int low = 0;
+    unsigned int high = lstSize(pathList);
+
+    *found = false;
+
+    while (low < high)
+    {
+        const unsigned int middle = low + (high - low) / 2;
+        const String *const pathMiddle = *(const String **)lstGet(pathList, middle);
+        int compare = memcmp(strZ(pathMiddle), path, strSize(pathMiddle) < pathSize ? strSize(pathMiddle) : pathSize);
+
+        if (compare == 0)
+            compare = LST_COMPARATOR_CMP(strSize(pathMiddle), pathSize);
+
+        if (compare < 0)
+            low = middle + 1;
+        else if (compare > 0)
+            high = middle;
+        else
+        {
+            *found = true;
+            FUNCTION_TEST_RETURN(UINT, middle);
+        }
+    }
+
+    FUNCTION_TEST_RETURN(UINT, low);
+}
+
+// Add path to the path list if it is not there already and return the pointer
+static const String *
+manifestFilePathCache(Manifest *const this, const char *const path, const size_t pathSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM_P(VOID, path);
+        FUNCTION_TEST_PARAM(SIZE, pathSize);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
+
+    // Files are usually added in path order so check the last path first
+    if (this->filePathLast == NULL || strSize(this->filePathLast) != pathSize ||
+        memcmp(strZ(this->filePathLast), path, pathSize) != 0)
+    {
+        bool found;
+        const unsigned int pathIdx = manifestFilePathIdx(this->filePathList, path, pathSize, &found);
+
+        if (!found)
+        {
+            MEM_CONTEXT_BEGIN(lstMemContext(this->filePathList))
+            {
+                const String *const pathNew = strNewZN(path, pathSize);
+                lstInsert(this->filePathList, pathIdx, &pathNew);
+            }
+            MEM_CONTEXT_END();
+        }
+
+        this->filePathLast = *(const String **)lstGet(this->filePathList, pathIdx);
+    }
+
+    FUNCTION_TEST_RETURN_CONST(STRING, this->filePathLast);
+}
+
+// Compare names split into path and leaf. The result is the same as comparing the full names.
+static int
+manifestFileNameCmp(const String *path1, const char *const leaf1, const String *path2, const char *const leaf2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, path1);
+        FUNCTION_TEST_PARAM(STRINGZ, leaf1);
+        FUNCTION_TEST_PARAM(STRING, path2);
+        FUNCTION_TEST_PARAM(STRINGZ, leaf2);
+    FUNCTION_TEST_END();
+
+    ASSERT(leaf1 != NULL);
+    ASSERT(leaf2 != NULL);
+
+    // Paths are unique in the path list so only the leaves need to be compared when the paths are the same
+    if (path1 == path2)
+        FUNCTION_TEST_RETURN(INT, strcmp(leaf1, leaf2));
+
+    const char *name1 = path1 == NULL ? leaf1 : strZ(path1);
+    const char *name2 = path2 == NULL ? leaf2 : strZ(path2);
+
+    while (true)
+    {
+        unsigned char chr1 = (unsigned char)*name1++;
+        unsigned char chr2 = (unsigned char)*name2++;
+
+        // At the end of the path continue with the separator and then the leaf
+        if (chr1 == '\0' && path1 != NULL)
+        {
+            chr1 = '/';
+            name1 = leaf1;
+            path1 = NULL;
+        }
+
+        if (chr2 == '\0' && path2 != NULL)
+        {
+            chr2 = '/';
+            name2 = leaf2;
+            path2 = NULL;
+        }
+
+        // Names can only be equal here when comparing files from different manifests
+        if (chr1 != chr2 || chr1 == '\0')
+            FUNCTION_TEST_RETURN(INT, LST_COMPARATOR_CMP(chr1, chr2));
+    }
+}
+
+FN_EXTERN int
+manifestFilePackNameCmp(const ManifestFilePack *const filePack1, const ManifestFilePack *const filePack2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, filePack1);
+        FUNCTION_TEST_PARAM_P(VOID, filePack2);
+    FUNCTION_TEST_END();
+
+    ASSERT(filePack1 != NULL);
+    ASSERT(filePack2 != NULL);
+
+    FUNCTION_TEST_RETURN(INT, manifestFileNameCmp(filePack1->path, filePack1->leaf, filePack2->path, filePack2->leaf));
+}
+
+// Comparator for the file list
+static int
+manifestFilePackComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    FUNCTION_TEST_RETURN(
+        INT, manifestFilePackNameCmp(*(const ManifestFilePack *const *)item1, *(const ManifestFilePack *const *)item2));
+}
+
 // Flags used to reduce the size of packed data. They should be ordered from most to least likely and can be reordered at will.
 typedef enum
 {
@@ -108,6 +279,7 @@ typedef enum
     manifestFilePackFlagChecksumPage,
     manifestFilePackFlagChecksumPageError,
     manifestFilePackFlagChecksumPageErrorList,
+    manifestFilePackFlagCompressNone,
     manifestFilePackFlagSizeOriginal,
     manifestFilePackFlagMode,
     manifestFilePackFlagUser,
@@ -118,7 +290,7 @@ typedef enum
 
 // Pack file into a compact format to save memory
 static ManifestFilePack *
-manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
+manifestFilePack(Manifest *const manifest, const ManifestFile *const file)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(MANIFEST, manifest);
@@ -158,6 +330,9 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
     if (file->checksumPageErrorList != NULL)
         flag |= 1 << manifestFilePackFlagChecksumPageErrorList;
 
+    if (file->compressNone)
+        flag |= 1 << manifestFilePackFlagCompressNone;
+
     if (file->reference != NULL)
         flag |= 1 << manifestFilePackFlagReference;
 
@@ -252,20 +427,31 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
         cvtUInt64ToVarInt128(file->blockIncrMapSize, buffer, &bufferPos, sizeof(buffer));
     }
 
+    // Split the name into path and leaf
+    const char *const name = strZ(file->name);
+    const char *leaf = strrchr(name, '/');
+    const String *path = NULL;
+
+    if (leaf != NULL)
+    {
+        path = manifestFilePathCache(manifest, name, (size_t)(leaf - name));
+        leaf++;
+    }
+    else
+        leaf = name;
+
     // Allocate memory for the file pack
-    const size_t nameSize = strSize(file->name) + 1;
+    const size_t leafSize = strlen(leaf) + 1;
+    size_t resultPos = sizeof(ManifestFilePack) + leafSize;
 
     uint8_t *const result = memNew(
-        sizeof(StringPub) + nameSize + bufferPos +
+        resultPos + bufferPos +
         (file->checksumPageErrorList != NULL ?
-             ALIGN_OFFSET(StringPub, nameSize + bufferPos) + sizeof(StringPub) + strSize(file->checksumPageErrorList) + 1 : 0));
+             ALIGN_OFFSET(StringPub, resultPos + bufferPos) + sizeof(StringPub) + strSize(file->checksumPageErrorList) + 1 : 0));
 
-    // Create string object for the file name
-    *(StringPub *)result = (StringPub){.size = (unsigned int)strSize(file->name), .buffer = (char *)result + sizeof(StringPub)};
-    size_t resultPos = sizeof(StringPub);
-
-    memcpy(result + resultPos, (const uint8_t *)strZ(file->name), nameSize);
-    resultPos += nameSize;
+    // Copy path and leaf
+    ((ManifestFilePack *)result)->path = path;
+    memcpy(((ManifestFilePack *)result)->leaf, leaf, leafSize);
 
     // Copy pack data
     memcpy(result + resultPos, buffer, bufferPos);
@@ -273,7 +459,7 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
     // Create string object for the checksum error list
     if (file->checksumPageErrorList != NULL)
     {
-        resultPos += bufferPos + ALIGN_OFFSET(StringPub, nameSize + bufferPos);
+        resultPos += bufferPos + ALIGN_OFFSET(StringPub, resultPos + bufferPos);
 
         *(StringPub *)(result + resultPos) = (StringPub)
         {
@@ -289,22 +475,31 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
 }
 
 FN_EXTERN ManifestFile
-manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const filePack)
+manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const filePack, const ManifestFileUnpackParam param)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(MANIFEST, manifest);
         FUNCTION_TEST_PARAM_P(VOID, filePack);
+        FUNCTION_TEST_PARAM(BOOL, param.noName);
     FUNCTION_TEST_END();
 
+    FUNCTION_AUDIT_STRUCT();
+
     ASSERT(filePack != NULL);
     ASSERT(manifestPackBaseTime != -1);
 
     ManifestFile result = {0};
-    size_t bufferPos = 0;
+    const size_t leafSize = strlen(filePack->leaf);
+    size_t bufferPos = sizeof(ManifestFilePack) + leafSize + 1;
 
     // Name
-    result.name = (const String *)filePack;
-    bufferPos += sizeof(StringPub) + strSize(result.name) + 1;
+    if (!param.noName)
+    {
+        if (filePack->path == NULL)
+            result.name = strNewZN(filePack->leaf, leafSize);
+        else
+            result.name = strCatZN(strCatChr(strCat(strNew(), filePack->path), '/'), filePack->leaf, leafSize);
+    }
 
     // Flags
     const uint64_t flag = cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos, UINT_MAX);
@@ -312,6 +507,7 @@ manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const
     result.copy = (flag >> manifestFilePackFlagCopy) & 1;
     result.delta = (flag >> manifestFilePackFlagDelta) & 1;
     result.resume = (flag >> manifestFilePackFlagResume) & 1;
+    result.compressNone = (flag >> manifestFilePackFlagCompressNone) & 1;
 
     // Size
     result.size = cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos, UINT_MAX);
@@ -553,13 +749,15 @@ manifestNewInternal(void)
         {
             .memContext = memContextCurrent(),
             .dbList = lstNewP(sizeof(ManifestDb), .comparator = lstComparatorStr),
-            .fileList = lstNewP(sizeof(ManifestFilePack *), .comparator = lstComparatorStr),
+            .fileList = lstNewP(sizeof(ManifestFilePack *), .comparator = manifestFilePackComparator),
             .linkList = lstNewP(sizeof(ManifestLink), .comparator = lstComparatorStr),
             .pathList = lstNewP(sizeof(ManifestPath), .comparator = lstComparatorStr),
             .targetList = lstNewP(sizeof(ManifestTarget), .comparator = lstComparatorStr),
             .referenceList = strLstNew(),
         },
         .ownerList = strLstNew(),
+        .filePathList = lstNewP(sizeof(String *)),
+        .fileName = strNew(),
     };
 
     FUNCTION_TEST_RETURN(MANIFEST, this);
@@ -786,6 +984,7 @@ typedef struct ManifestBuildData
     StringList *excludeContent;                                     // Exclude contents of directories
     StringList *excludeSingle;                                      // Exclude a single file/link/path
     const ManifestBlockIncrMap *blockIncrMap;                       // Block incremental maps
+    List *buildPathList;                                            // Path contents listed before the build
 } ManifestBuildData;
 
 // Calculate block incremental size for a file. The block size is based on the size and age of the file. Larger files get larger
@@ -986,13 +1185,21 @@ manifestBuildInfo(
             // Recurse into the path
             const String *const pgPathSub = strNewFmt("%s/%s", strZ(pgPath), strZ(info->name));
             const bool dbPathSub = regExpMatch(buildData->dbPathExp, manifestName);
-            StorageIterator *const storageItr = storageNewItrP(buildData->storagePg, pgPathSub, .sortOrder = sortOrderAsc);
+
+            // Use the path contents if they were listed before the build, else iterate the path. The list is sorted the same way as
+            // the iterator so the manifest is identical either way.
+            ManifestBuildPath *const buildPath =
+                buildData->buildPathList != NULL ? lstFind(buildData->buildPathList, &pgPathSub) : NULL;
+            StorageIterator *const storageItr =
+                buildPath == NULL ? storageNewItrP(buildData->storagePg, pgPathSub, .sortOrder = sortOrderAsc) : NULL;
+            unsigned int listIdx = 0;
 
             MEM_CONTEXT_TEMP_RESET_BEGIN()
             {
-                while (storageItrMore(storageItr))
+                while (buildPath != NULL ? listIdx < storageLstSize(buildPath->list) : storageItrMore(storageItr))
                 {
-                    const StorageInfo info = storageItrNext(storageItr);
+                    const StorageInfo info =
+                        buildPath != NULL ? storageLstGet(buildPath->list, listIdx++) : storageItrNext(storageItr);
 
                     manifestBuildInfo(buildData, manifestName, pgPathSub, dbPathSub, &info);
 
@@ -1002,6 +1209,13 @@ manifestBuildInfo(
             }
             MEM_CONTEXT_TEMP_END();
 
+            // Free the path contents since each path is only visited once
+            if (buildPath != NULL)
+            {
+                storageLstFree(buildPath->list);
+                buildPath->list = NULL;
+            }
+
             break;
         }
 
@@ -1288,7 +1502,7 @@ FN_EXTERN Manifest *
 manifestNewBuild(
     const Storage *const storagePg, const unsigned int pgVersion, const unsigned int pgCatalogVersion, const time_t timestampStart,
     const bool online, const bool checksumPage, const bool bundle, const bool blockIncr, const ManifestBlockIncrMap *blockIncrMap,
-    const StringList *const excludeList, const Pack *const tablespaceList)
+    const StringList *const excludeList, const Pack *const tablespaceList, List *const buildPathList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STORAGE, storagePg);
@@ -1302,6 +1516,7 @@ manifestNewBuild(
         FUNCTION_LOG_PARAM(VOID, blockIncrMap);
         FUNCTION_LOG_PARAM(STRING_LIST, excludeList);
         FUNCTION_LOG_PARAM(PACK, tablespaceList);
+        FUNCTION_LOG_PARAM(LIST, buildPathList);
     FUNCTION_LOG_END();
 
     ASSERT(storagePg != NULL);
@@ -1340,6 +1555,7 @@ manifestNewBuild(
                 .linkCheck = &linkCheck,
                 .manifestWalName = strNewFmt(MANIFEST_TARGET_PGDATA "/%s", strZ(pgWalPath(pgVersion))),
                 .blockIncrMap = blockIncrMap,
+                .buildPathList = buildPathList,
             };
 
             // Build expressions to identify databases paths and temp relations
@@ -1439,7 +1655,7 @@ manifestNewBuild(
             // Remove unlogged relations from the manifest. This can't be done during the initial build because of the requirement
             // to check for _init files which will sort after the vast majority of the relation files. We could check storage for
             // each _init file but that would be expensive.
-            // -------------------------------------------------------------------------------------------------------------------------
+            // ---------------------------------------------------------------------------------------------------------------------
             RegExp *relationExp = regExpNew(strNewFmt("^" DB_PATH_EXP "/" RELATION_EXP "$", strZ(buildData.tablespaceId)));
             unsigned int fileIdx = 0;
             char lastRelationFileId[21] = "";                   // Large enough for a 64-bit unsigned integer
@@ -1547,7 +1763,7 @@ manifestBuildValidate(Manifest *const this, const bool delta, const time_t copyS
     // Check the manifest for timestamp anomalies that require a delta backup (if delta is not already specified)
     if (!varBool(this->pub.data.backupOptionDelta))
     {
-        MEM_CONTEXT_TEMP_BEGIN()
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
         {
             for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(this); fileIdx++)
             {
@@ -1564,6 +1780,9 @@ manifestBuildValidate(Manifest *const this, const bool delta, const time_t copyS
                     this->pub.data.backupOptionDelta = BOOL_TRUE_VAR;
                     break;
                 }
+
+                // Reset the memory context occasionally so file names do not accumulate
+                MEM_CONTEXT_TEMP_RESET(1000);
             }
         }
         MEM_CONTEXT_TEMP_END();
@@ -1572,6 +1791,66 @@ manifestBuildValidate(Manifest *const this, const bool delta, const time_t copyS
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Merge the file list with the file list of a prior manifest. Both lists are sorted by name so the prior file (if any) is found by
+advancing through the prior list while iterating the current list in order. Names are compared in packed form so neither file needs
+to be unpacked to find a match.
+***********************************************************************************************************************************/
+// Sort the file lists if they are not already sorted
+static void
+manifestFileMergeSort(const Manifest *const this, const Manifest *const manifestPrior)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(MANIFEST, manifestPrior);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(manifestPrior != NULL);
+
+    if (lstSortOrder(this->pub.fileList) != sortOrderAsc)
+        lstSort(this->pub.fileList, sortOrderAsc);
+
+    if (lstSortOrder(manifestPrior->pub.fileList) != sortOrderAsc)
+        lstSort(manifestPrior->pub.fileList, sortOrderAsc);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Find the prior file matching a file. Files must be passed in list order and filePriorIdx must start at zero.
+static const ManifestFilePack *
+manifestFileMergeFind(
+    const Manifest *const manifestPrior, unsigned int *const filePriorIdx, const ManifestFilePack *const filePack)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, manifestPrior);
+        FUNCTION_TEST_PARAM_P(UINT, filePriorIdx);
+        FUNCTION_TEST_PARAM_P(VOID, filePack);
+    FUNCTION_TEST_END();
+
+    ASSERT(manifestPrior != NULL);
+    ASSERT(filePriorIdx != NULL);
+    ASSERT(filePack != NULL);
+
+    // Skip prior files that sort before the file
+    while (*filePriorIdx < lstSize(manifestPrior->pub.fileList))
+    {
+        const ManifestFilePack *const filePackPrior = *(ManifestFilePack **)lstGet(manifestPrior->pub.fileList, *filePriorIdx);
+        const int compare = manifestFilePackNameCmp(filePackPrior, filePack);
+
+        if (compare == 0)
+            FUNCTION_TEST_RETURN_TYPE_P(const ManifestFilePack, filePackPrior);
+
+        // Prior file sorts after the file so the file is not in the prior list
+        if (compare > 0)
+            break;
+
+        (*filePriorIdx)++;
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_P(const ManifestFilePack, NULL);
+}
+
 /**********************************************************************************************************************************/
 static void
 manifestDeltaCheck(Manifest *const this, const Manifest *const manifestPrior)
@@ -1581,19 +1860,24 @@ manifestDeltaCheck(Manifest *const this, const Manifest *const manifestPrior)
         FUNCTION_LOG_PARAM(MANIFEST, manifestPrior);
     FUNCTION_LOG_END();
 
-    MEM_CONTEXT_TEMP_BEGIN()
+    MEM_CONTEXT_TEMP_RESET_BEGIN()
     {
         // Check for anomalies between manifests if delta is not already enabled
         if (!varBool(this->pub.data.backupOptionDelta))
         {
+            manifestFileMergeSort(this, manifestPrior);
+            unsigned int filePriorIdx = 0;
+
             for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(this); fileIdx++)
             {
-                const ManifestFile file = manifestFile(this, fileIdx);
+                const ManifestFilePack *const filePack = *(ManifestFilePack **)lstGet(this->pub.fileList, fileIdx);
+                const ManifestFilePack *const filePackPrior = manifestFileMergeFind(manifestPrior, &filePriorIdx, filePack);
 
                 // If file was found in prior manifest then perform checks
-                if (manifestFileExists(manifestPrior, file.name))
+                if (filePackPrior != NULL)
                 {
-                    const ManifestFile filePrior = manifestFileFind(manifestPrior, file.name);
+                    const ManifestFile file = manifestFileUnpackP(this, filePack);
+                    const ManifestFile filePrior = manifestFileUnpackP(manifestPrior, filePackPrior, .noName = true);
 
                     // Check for timestamp earlier than the prior backup
                     if (file.timestamp < filePrior.timestamp)
@@ -1619,6 +1903,9 @@ manifestDeltaCheck(Manifest *const this, const Manifest *const manifestPrior)
                         break;
                     }
                 }
+
+                // Reset the memory context occasionally so file names do not accumulate
+                MEM_CONTEXT_TEMP_RESET(1000);
             }
         }
     }
@@ -1630,13 +1917,15 @@ manifestDeltaCheck(Manifest *const this, const Manifest *const manifestPrior)
 /**********************************************************************************************************************************/
 FN_EXTERN void
 manifestBuildIncr(
-    Manifest *const this, const Manifest *const manifestPrior, const BackupType type, const String *const archiveStart)
+    Manifest *const this, const Manifest *const manifestPrior, const BackupType type, const String *const archiveStart,
+    const WalSummary *const walSummary)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(MANIFEST, this);
         FUNCTION_LOG_PARAM(MANIFEST, manifestPrior);
         FUNCTION_LOG_PARAM(STRING_ID, type);
         FUNCTION_LOG_PARAM(STRING, archiveStart);
+        FUNCTION_LOG_PARAM(WAL_SUMMARY, walSummary);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -1661,7 +1950,7 @@ manifestBuildIncr(
     }
     MEM_CONTEXT_END();
 
-    MEM_CONTEXT_TEMP_BEGIN()
+    MEM_CONTEXT_TEMP_RESET_BEGIN()
     {
         // Enable delta if timelines differ
         if (archiveStart != NULL && manifestData(manifestPrior)->archiveStop != NULL &&
@@ -1690,15 +1979,25 @@ manifestBuildIncr(
         // Find files to (possibly) reference in the prior manifest
         const bool delta = varBool(this->pub.data.backupOptionDelta);
 
+        manifestFileMergeSort(this, manifestPrior);
+        unsigned int filePriorIdx = 0;
+
         for (unsigned int fileIdx = 0; fileIdx < lstSize(this->pub.fileList); fileIdx++)
         {
-            ManifestFile file = manifestFile(this, fileIdx);
+            ManifestFilePack **const filePack = lstGet(this->pub.fileList, fileIdx);
+            const ManifestFilePack *const filePackPrior = manifestFileMergeFind(manifestPrior, &filePriorIdx, *filePack);
 
-            // Check if a prior file exists for files that will be copied (i.e. not zero-length files when bundling). If a prior
-            // file does exist it may be possible to reference it instead of copying the file.
-            if (file.copy && manifestFileExists(manifestPrior, file.name))
+            // Skip files that do not exist in the prior manifest
+            if (filePackPrior == NULL)
+                continue;
+
+            ManifestFile file = manifestFileUnpackP(this, *filePack);
+
+            // Check the prior file for files that will be copied (i.e. not zero-length files when bundling). It may be possible to
+            // reference the prior file instead of copying the file.
+            if (file.copy)
             {
-                const ManifestFile filePrior = manifestFileFind(manifestPrior, file.name);
+                const ManifestFile filePrior = manifestFileUnpackP(manifestPrior, filePackPrior, .noName = true);
 
                 // If file size is equal to prior size then the file can be referenced instead of copied if it has not changed (this
                 // must be determined during the backup).
@@ -1726,6 +2025,17 @@ manifestBuildIncr(
                 // If delta is disabled and size/timestamp are equal then the file is not copied
                 if (!file.delta && fileSizeEqual && file.timestamp == filePrior.timestamp)
                     file.copy = false;
+                // Else if delta is disabled, size is equal, and the WAL summary shows that the relation file has not been modified
+                // since the prior backup then the file is not copied
+                else if (
+                    !file.delta && fileSizeEqual && walSummary != NULL &&
+                    !walSummaryModified(
+                        walSummary,
+                        strBeginsWithZ(file.name, MANIFEST_TARGET_PGDATA "/") ?
+                            strSub(file.name, sizeof(MANIFEST_TARGET_PGDATA)) : file.name))
+                {
+                    file.copy = false;
+                }
 
                 ASSERT(file.copy || !file.delta);
                 ASSERT(file.copy || fileSizeEqual);
@@ -1744,6 +2054,7 @@ manifestBuildIncr(
                     file.checksumPage = filePrior.checksumPage;
                     file.checksumPageError = filePrior.checksumPageError;
                     file.checksumPageErrorList = filePrior.checksumPageErrorList;
+                    file.compressNone = filePrior.compressNone;
                     file.bundleId = filePrior.bundleId;
                     file.bundleOffset = filePrior.bundleOffset;
                     file.blockIncrSize = filePrior.blockIncrSize;
@@ -1763,8 +2074,11 @@ manifestBuildIncr(
                         (file.blockIncrSize > 0 && file.blockIncrChecksumSize > 0 && file.blockIncrMapSize > 0));
                 }
 
-                manifestFileUpdate(this, &file);
+                manifestFilePackUpdate(this, filePack, &file);
             }
+
+            // Reset the memory context occasionally so file names do not accumulate
+            MEM_CONTEXT_TEMP_RESET(1000);
         }
     }
     MEM_CONTEXT_TEMP_END();
@@ -1915,6 +2229,7 @@ manifestBuildComplete(
 #define MANIFEST_KEY_CHECKSUM_REPO                                  STRID5("rck", 0x2c720)
 #define MANIFEST_KEY_CHECKSUM_PAGE                                  "checksum-page"
 #define MANIFEST_KEY_CHECKSUM_PAGE_ERROR                            "checksum-page-error"
+#define MANIFEST_KEY_COMPRESS                                       STRID5("cmp", 0x41a30)
 #define MANIFEST_KEY_DB_CATALOG_VERSION                             "db-catalog-version"
 #define MANIFEST_KEY_DB_ID                                          "db-id"
 #define MANIFEST_KEY_DB_LAST_SYSTEM_ID                              "db-last-system-id"
@@ -2082,6 +2397,10 @@ manifestLoadCallback(void *const callbackData, const String *const section, cons
                 file.checksumPageErrorList = jsonFromVar(jsonReadVar(json));
         }
 
+        // Compression is only recorded when the file was stored without compression
+        if (jsonReadKeyExpectStrId(json, MANIFEST_KEY_COMPRESS))
+            file.compressNone = !jsonReadBool(json);
+
         // Group
         if (jsonReadKeyExpectZ(json, MANIFEST_KEY_GROUP))
             file.group = manifestOwnerGet(jsonReadVar(json));
@@ -2431,7 +2750,7 @@ manifestNewLoad(IoRead *const read)
 
         // Set file defaults that will be updated when we know what the real defaults are. These need to be set to values that are
         // not valid for actual names or modes.
-        this->fileUserDefault = STRDEF("@");
+        this->fileUserDefault = MANIFEST_OWNER_DEFAULT_STR;
         this->fileGroupDefault = this->fileUserDefault;
         this->fileModeDefault = (mode_t)-1;
 
@@ -2829,6 +3148,9 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
                         jsonWriteJson(jsonWriteKeyZ(json, MANIFEST_KEY_CHECKSUM_PAGE_ERROR), file.checksumPageErrorList);
                 }
 
+                if (file.compressNone)
+                    jsonWriteBool(jsonWriteKeyStrId(json, MANIFEST_KEY_COMPRESS), false);
+
                 if (!varEq(manifestOwnerVar(file.group), saveData->groupDefault))
                     jsonWriteVar(jsonWriteKeyZ(json, MANIFEST_KEY_GROUP), manifestOwnerVar(file.group));
 
@@ -2995,6 +3317,595 @@ manifestSave(Manifest *const this, IoWrite *const write)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Binary manifest
+
+The binary manifest is a pack that starts with the format version, followed by a pack and CRC-32C checksum for each section. The
+file list is stored last as an array of chunks (each with its own checksum) so it never needs to be buffered in full and it can be
+skipped by not reading the remainder of the file. Defaults are stored as they are in memory so the manifest loaded from the binary
+format is exactly the same as the manifest that was saved.
+***********************************************************************************************************************************/
+#define MANIFEST_PACK_FORMAT                                        1
+
+// Number of files in each file list chunk
+#define MANIFEST_PACK_FILE_CHUNK                                    4096
+
+typedef enum
+{
+    manifestPackIdFormat = 1,
+    manifestPackIdData,
+    manifestPackIdDataChecksum,
+    manifestPackIdTarget,
+    manifestPackIdTargetChecksum,
+    manifestPackIdDb,
+    manifestPackIdDbChecksum,
+    manifestPackIdLink,
+    manifestPackIdLinkChecksum,
+    manifestPackIdPath,
+    manifestPackIdPathChecksum,
+    manifestPackIdFile,
+} ManifestPackId;
+
+// Owners are stored as an index into the owner list. Zero is NULL so the index is offset by one.
+static uint32_t
+manifestPackOwner(const Manifest *const this, const String *const owner)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, owner);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(UINT32, owner == NULL ? 0 : strLstFindIdxP(this->ownerList, owner, .required = true) + 1);
+}
+
+static const String *
+manifestPackOwnerGet(const Manifest *const this, const uint32_t ownerIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(UINT32, ownerIdx);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN_CONST(STRING, ownerIdx == 0 ? NULL : strLstGet(this->ownerList, ownerIdx - 1));
+}
+
+// Optional options are stored as NULL when they are not set
+static void
+manifestSavePackOption(PackWrite *const pack, const Variant *const value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_WRITE, pack);
+        FUNCTION_TEST_PARAM(VARIANT, value);
+    FUNCTION_TEST_END();
+
+    if (value == NULL)
+        pckWriteNullP(pack);
+    else if (varType(value) == varTypeBool)
+        pckWriteBoolP(pack, varBool(value), .defaultWrite = true);
+    else
+        pckWriteU32P(pack, varUIntForce(value), .defaultWrite = true);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static const Variant *
+manifestLoadPackOption(PackRead *const pack, const VariantType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_READ, pack);
+        FUNCTION_TEST_PARAM(ENUM, type);
+    FUNCTION_TEST_END();
+
+    if (pckReadNullP(pack))
+        FUNCTION_TEST_RETURN_CONST(VARIANT, NULL);
+
+    FUNCTION_TEST_RETURN_CONST(VARIANT, type == varTypeBool ? varNewBool(pckReadBoolP(pack)) : varNewUInt(pckReadU32P(pack)));
+}
+
+// Write a section followed by its checksum
+static void
+manifestSavePackSection(PackWrite *const pack, PackWrite *const section)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_WRITE, pack);
+        FUNCTION_TEST_PARAM(PACK_WRITE, section);
+    FUNCTION_TEST_END();
+
+    const Buffer *const buffer = pckToBuf(pckWriteResult(pckWriteEndP(section)));
+
+    pckWritePackP(pack, pckWriteResult(section));
+    pckWriteU32P(pack, crc32cOne(bufPtrConst(buffer), bufUsed(buffer)), .defaultWrite = true);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Read a section and verify its checksum
+static PackRead *
+manifestLoadPackSection(PackRead *const pack, const unsigned int id, const char *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_READ, pack);
+        FUNCTION_TEST_PARAM(UINT, id);
+        FUNCTION_TEST_PARAM(STRINGZ, name);
+    FUNCTION_TEST_END();
+
+    Pack *const section = pckReadPackP(pack, .id = id);
+
+    if (section == NULL)
+        THROW_FMT(FormatError, "binary manifest section '%s' is missing", name);
+
+    const uint32_t checksum = pckReadU32P(pack);
+    const uint32_t checksumActual = crc32cOne(bufPtrConst(pckToBuf(section)), bufUsed(pckToBuf(section)));
+
+    if (checksumActual != checksum)
+    {
+        THROW_FMT(
+            ChecksumError, "binary manifest section '%s' checksum 0x%08x does not match expected 0x%08x", name, checksumActual,
+            checksum);
+    }
+
+    PackRead *const result = pckReadNew(section);
+    pckMove(section, objMemContext(result));
+
+    FUNCTION_TEST_RETURN(PACK_READ, result);
+}
+
+FN_EXTERN void
+manifestSavePack(Manifest *const this, IoWrite *const write)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(write != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Files can be added from outside the manifest so make sure they are sorted
+        lstSort(this->pub.fileList, sortOrderAsc);
+
+        ioWriteOpen(write);
+
+        PackWrite *const pack = pckWriteNewIo(write);
+        pckWriteU32P(pack, MANIFEST_PACK_FORMAT);
+
+        // Data
+        // -------------------------------------------------------------------------------------------------------------------------
+        const ManifestData *const data = &this->pub.data;
+        PackWrite *section = pckWriteNewP();
+
+        pckWriteStrP(section, data->backrestVersion);
+        pckWriteStrP(section, manifestCipherSubPass(this));
+        pckWriteStrP(section, data->backupLabel);
+        pckWriteStrP(section, data->backupLabelPrior);
+        pckWriteTimeP(section, data->backupTimestampCopyStart);
+        pckWriteTimeP(section, data->backupTimestampStart);
+        pckWriteTimeP(section, data->backupTimestampStop);
+        pckWriteStrIdP(section, data->backupType);
+        pckWriteBoolP(section, data->bundle);
+        pckWriteBoolP(section, data->bundleRaw);
+        pckWriteBoolP(section, data->blockIncr);
+        pckWriteStrP(section, data->archiveStart);
+        pckWriteStrP(section, data->archiveStop);
+        pckWriteStrP(section, data->lsnStart);
+        pckWriteStrP(section, data->lsnStop);
+        pckWriteU32P(section, data->pgId);
+        pckWriteU32P(section, data->pgVersion);
+        pckWriteU64P(section, data->pgSystemId);
+        pckWriteU32P(section, data->pgCatalogVersion);
+        pckWriteStrP(section, data->annotation == NULL ? NULL : jsonFromVar(data->annotation));
+        pckWriteBoolP(section, data->backupOptionArchiveCheck);
+        pckWriteBoolP(section, data->backupOptionArchiveCopy);
+        manifestSavePackOption(section, data->backupOptionStandby);
+        manifestSavePackOption(section, data->backupOptionBufferSize);
+        manifestSavePackOption(section, data->backupOptionChecksumPage);
+        pckWriteStrIdP(section, strIdFromStr(compressTypeStr(data->backupOptionCompressType)));
+        manifestSavePackOption(section, data->backupOptionCompressLevel);
+        manifestSavePackOption(section, data->backupOptionCompressLevelNetwork);
+        manifestSavePackOption(section, data->backupOptionDelta);
+        pckWriteBoolP(section, data->backupOptionHardLink);
+        pckWriteBoolP(section, data->backupOptionOnline);
+        manifestSavePackOption(section, data->backupOptionProcessMax);
+        pckWriteStrLstP(section, this->pub.referenceList);
+        pckWriteStrLstP(section, this->ownerList);
+        pckWriteStrP(section, this->fileUserDefault);
+        pckWriteStrP(section, this->fileGroupDefault);
+        pckWriteModeP(section, this->fileModeDefault);
+
+        manifestSavePackSection(pack, section);
+
+        // Targets
+        // -------------------------------------------------------------------------------------------------------------------------
+        section = pckWriteNewP();
+
+        for (unsigned int targetIdx = 0; targetIdx < manifestTargetTotal(this); targetIdx++)
+        {
+            const ManifestTarget *const target = manifestTarget(this, targetIdx);
+
+            pckWriteObjBeginP(section);
+            pckWriteStrP(section, target->name);
+            pckWriteBoolP(section, target->type == manifestTargetTypeLink);
+            pckWriteStrP(section, target->path);
+            pckWriteStrP(section, target->file);
+            pckWriteU32P(section, target->tablespaceId);
+            pckWriteStrP(section, target->tablespaceName);
+            pckWriteObjEndP(section);
+        }
+
+        manifestSavePackSection(pack, section);
+
+        // Databases
+        // -------------------------------------------------------------------------------------------------------------------------
+        section = pckWriteNewP();
+
+        for (unsigned int dbIdx = 0; dbIdx < manifestDbTotal(this); dbIdx++)
+        {
+            const ManifestDb *const db = manifestDb(this, dbIdx);
+
+            pckWriteObjBeginP(section);
+            pckWriteStrP(section, db->name);
+            pckWriteU32P(section, db->id);
+            pckWriteU32P(section, db->lastSystemId);
+            pckWriteObjEndP(section);
+        }
+
+        manifestSavePackSection(pack, section);
+
+        // Links
+        // -------------------------------------------------------------------------------------------------------------------------
+        section = pckWriteNewP();
+
+        for (unsigned int linkIdx = 0; linkIdx < manifestLinkTotal(this); linkIdx++)
+        {
+            const ManifestLink *const link = manifestLink(this, linkIdx);
+
+            pckWriteObjBeginP(section);
+            pckWriteStrP(section, link->name);
+            pckWriteStrP(section, link->destination);
+            pckWriteU32P(section, manifestPackOwner(this, link->user));
+            pckWriteU32P(section, manifestPackOwner(this, link->group));
+            pckWriteObjEndP(section);
+        }
+
+        manifestSavePackSection(pack, section);
+
+        // Paths
+        // -------------------------------------------------------------------------------------------------------------------------
+        section = pckWriteNewP();
+
+        for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(this); pathIdx++)
+        {
+            const ManifestPath *const path = manifestPath(this, pathIdx);
+
+            pckWriteObjBeginP(section);
+            pckWriteStrP(section, path->name);
+            pckWriteModeP(section, path->mode);
+            pckWriteU32P(section, manifestPackOwner(this, path->user));
+            pckWriteU32P(section, manifestPackOwner(this, path->group));
+            pckWriteObjEndP(section);
+        }
+
+        manifestSavePackSection(pack, section);
+
+        // Files
+        // -------------------------------------------------------------------------------------------------------------------------
+        pckWriteArrayBeginP(pack);
+
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        {
+            section = NULL;
+
+            for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(this); fileIdx++)
+            {
+                const ManifestFile file = manifestFile(this, fileIdx);
+
+                if (section == NULL)
+                    section = pckWriteNewP();
+
+                pckWriteObjBeginP(section);
+                pckWriteStrP(section, file.name);
+                pckWriteU64P(section, file.size);
+                pckWriteU64P(section, file.sizeOriginal, .defaultValue = file.size);
+                pckWriteU64P(section, file.sizeRepo, .defaultValue = file.size);
+                pckWriteTimeP(section, file.timestamp);
+                pckWriteModeP(section, file.mode, .defaultValue = this->fileModeDefault);
+
+                // Owners are NULL when they match the default
+                if (strEq(file.user, this->fileUserDefault))
+                    pckWriteNullP(section);
+                else
+                    pckWriteU32P(section, manifestPackOwner(this, file.user), .defaultWrite = true);
+
+                if (strEq(file.group, this->fileGroupDefault))
+                    pckWriteNullP(section);
+                else
+                    pckWriteU32P(section, manifestPackOwner(this, file.group), .defaultWrite = true);
+
+                pckWriteBinP(section, file.checksumSha1 == NULL ? NULL : BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE));
+                pckWriteBinP(section, file.checksumRepoSha1 == NULL ? NULL : BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE));
+                pckWriteBoolP(section, file.checksumPage);
+                pckWriteBoolP(section, file.checksumPageError);
+                pckWriteStrP(section, file.checksumPageErrorList);
+                pckWriteBoolP(section, file.compressNone);
+                pckWriteU32P(
+                    section,
+                    file.reference == NULL ? 0 : strLstFindIdxP(this->pub.referenceList, file.reference, .required = true) + 1);
+                pckWriteU64P(section, file.bundleId);
+                pckWriteU64P(section, file.bundleOffset);
+                pckWriteU64P(section, file.blockIncrSize);
+                pckWriteU64P(section, file.blockIncrChecksumSize);
+                pckWriteU64P(section, file.blockIncrMapSize);
+                pckWriteObjEndP(section);
+
+                // Write the chunk when it is full or this is the last file
+                if ((fileIdx + 1) % MANIFEST_PACK_FILE_CHUNK == 0 || fileIdx + 1 == manifestFileTotal(this))
+                {
+                    manifestSavePackSection(pack, section);
+                    section = NULL;
+
+                    MEM_CONTEXT_TEMP_RESET(1);
+                }
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        pckWriteArrayEndP(pack);
+        pckWriteEndP(pack);
+
+        ioWriteClose(write);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+FN_EXTERN Manifest *
+manifestNewLoadPack(IoRead *const read, const unsigned int skip)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+        FUNCTION_LOG_PARAM(UINT, skip);
+    FUNCTION_LOG_END();
+
+    ASSERT(read != NULL);
+
+    Manifest *this = NULL;
+
+    if (ioReadOpen(read))
+    {
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            this = manifestNewInternal();
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                PackRead *const pack = pckReadNewIo(read);
+                const unsigned int format = pckReadU32P(pack);
+
+                if (format != MANIFEST_PACK_FORMAT)
+                    THROW_FMT(FormatError, "expected binary manifest format %d but found %u", MANIFEST_PACK_FORMAT, format);
+
+                // Data
+                // -----------------------------------------------------------------------------------------------------------------
+                PackRead *section = manifestLoadPackSection(pack, manifestPackIdData, "data");
+
+                MEM_CONTEXT_OBJ_BEGIN(this)
+                {
+                    ManifestData *const data = &this->pub.data;
+
+                    data->backrestVersion = pckReadStrP(section);
+                    this->pub.info = infoNew(pckReadStrP(section));
+                    data->backupLabel = pckReadStrP(section);
+                    data->backupLabelPrior = pckReadStrP(section);
+                    data->backupTimestampCopyStart = pckReadTimeP(section);
+                    data->backupTimestampStart = pckReadTimeP(section);
+                    data->backupTimestampStop = pckReadTimeP(section);
+                    data->backupType = (BackupType)pckReadStrIdP(section);
+                    data->bundle = pckReadBoolP(section);
+                    data->bundleRaw = pckReadBoolP(section);
+                    data->blockIncr = pckReadBoolP(section);
+                    data->archiveStart = pckReadStrP(section);
+                    data->archiveStop = pckReadStrP(section);
+                    data->lsnStart = pckReadStrP(section);
+                    data->lsnStop = pckReadStrP(section);
+                    data->pgId = pckReadU32P(section);
+                    data->pgVersion = pckReadU32P(section);
+                    data->pgSystemId = pckReadU64P(section);
+                    data->pgCatalogVersion = pckReadU32P(section);
+
+                    const String *const annotation = pckReadStrP(section);
+
+                    if (annotation != NULL)
+                        data->annotation = jsonToVar(annotation);
+
+                    data->backupOptionArchiveCheck = pckReadBoolP(section);
+                    data->backupOptionArchiveCopy = pckReadBoolP(section);
+                    data->backupOptionStandby = manifestLoadPackOption(section, varTypeBool);
+                    data->backupOptionBufferSize = manifestLoadPackOption(section, varTypeUInt);
+                    data->backupOptionChecksumPage = manifestLoadPackOption(section, varTypeBool);
+                    data->backupOptionCompressType = compressTypeEnum(pckReadStrIdP(section));
+                    data->backupOptionCompressLevel = manifestLoadPackOption(section, varTypeUInt);
+                    data->backupOptionCompressLevelNetwork = manifestLoadPackOption(section, varTypeUInt);
+                    data->backupOptionDelta = manifestLoadPackOption(section, varTypeBool);
+                    data->backupOptionHardLink = pckReadBoolP(section);
+                    data->backupOptionOnline = pckReadBoolP(section);
+                    data->backupOptionProcessMax = manifestLoadPackOption(section, varTypeUInt);
+                    this->pub.referenceList = pckReadStrLstP(section);
+                    this->ownerList = pckReadStrLstP(section);
+                    this->fileUserDefault = pckReadStrP(section);
+                    this->fileGroupDefault = pckReadStrP(section);
+                    this->fileModeDefault = pckReadModeP(section);
+                }
+                MEM_CONTEXT_OBJ_END();
+
+                // Targets
+                // -----------------------------------------------------------------------------------------------------------------
+                section = manifestLoadPackSection(pack, manifestPackIdTarget, "target");
+
+                while (!pckReadNullP(section))
+                {
+                    pckReadObjBeginP(section);
+
+                    ManifestTarget target = {.name = pckReadStrP(section)};
+
+                    target.type = pckReadBoolP(section) ? manifestTargetTypeLink : manifestTargetTypePath;
+                    target.path = pckReadStrP(section);
+                    target.file = pckReadStrP(section);
+                    target.tablespaceId = pckReadU32P(section);
+                    target.tablespaceName = pckReadStrP(section);
+
+                    pckReadObjEndP(section);
+                    manifestTargetAdd(this, &target);
+                }
+
+                // Databases
+                // -----------------------------------------------------------------------------------------------------------------
+                if (!(skip & manifestSectionDb))
+                {
+                    section = manifestLoadPackSection(pack, manifestPackIdDb, "db");
+
+                    while (!pckReadNullP(section))
+                    {
+                        pckReadObjBeginP(section);
+
+                        ManifestDb db = {.name = pckReadStrP(section)};
+
+                        db.id = pckReadU32P(section);
+                        db.lastSystemId = pckReadU32P(section);
+
+                        pckReadObjEndP(section);
+                        manifestDbAdd(this, &db);
+                    }
+                }
+
+                // Links
+                // -----------------------------------------------------------------------------------------------------------------
+                if (!(skip & manifestSectionLink))
+                {
+                    section = manifestLoadPackSection(pack, manifestPackIdLink, "link");
+
+                    while (!pckReadNullP(section))
+                    {
+                        pckReadObjBeginP(section);
+
+                        ManifestLink link = {.name = pckReadStrP(section)};
+
+                        link.destination = pckReadStrP(section);
+                        link.user = manifestPackOwnerGet(this, pckReadU32P(section));
+                        link.group = manifestPackOwnerGet(this, pckReadU32P(section));
+
+                        pckReadObjEndP(section);
+                        manifestLinkAdd(this, &link);
+                    }
+                }
+
+                // Paths
+                // -----------------------------------------------------------------------------------------------------------------
+                if (!(skip & manifestSectionPath))
+                {
+                    section = manifestLoadPackSection(pack, manifestPackIdPath, "path");
+
+                    while (!pckReadNullP(section))
+                    {
+                        pckReadObjBeginP(section);
+
+                        ManifestPath path = {.name = pckReadStrP(section)};
+
+                        path.mode = pckReadModeP(section);
+                        path.user = manifestPackOwnerGet(this, pckReadU32P(section));
+                        path.group = manifestPackOwnerGet(this, pckReadU32P(section));
+
+                        pckReadObjEndP(section);
+                        manifestPathAdd(this, &path);
+                    }
+                }
+
+                // Files. When files are skipped the remainder of the file does not need to be read.
+                // -----------------------------------------------------------------------------------------------------------------
+                if (!(skip & manifestSectionFile))
+                {
+                    pckReadArrayBeginP(pack, .id = manifestPackIdFile);
+
+                    MEM_CONTEXT_TEMP_RESET_BEGIN()
+                    {
+                        while (!pckReadNullP(pack))
+                        {
+                            section = manifestLoadPackSection(pack, 0, "file");
+
+                            while (!pckReadNullP(section))
+                            {
+                                pckReadObjBeginP(section);
+
+                                ManifestFile file = {.name = pckReadStrP(section)};
+
+                                file.size = pckReadU64P(section);
+                                file.sizeOriginal = pckReadU64P(section, .defaultValue = file.size);
+                                file.sizeRepo = pckReadU64P(section, .defaultValue = file.size);
+                                file.timestamp = pckReadTimeP(section);
+                                file.mode = pckReadModeP(section, .defaultValue = this->fileModeDefault);
+                                file.user =
+                                    pckReadNullP(section) ?
+                                        this->fileUserDefault : manifestPackOwnerGet(this, pckReadU32P(section));
+                                file.group =
+                                    pckReadNullP(section) ?
+                                        this->fileGroupDefault : manifestPackOwnerGet(this, pckReadU32P(section));
+
+                                const Buffer *const checksumSha1 = pckReadBinP(section);
+                                const Buffer *const checksumRepoSha1 = pckReadBinP(section);
+
+                                file.checksumSha1 = checksumSha1 == NULL ? NULL : bufPtrConst(checksumSha1);
+                                file.checksumRepoSha1 = checksumRepoSha1 == NULL ? NULL : bufPtrConst(checksumRepoSha1);
+                                file.checksumPage = pckReadBoolP(section);
+                                file.checksumPageError = pckReadBoolP(section);
+                                file.checksumPageErrorList = pckReadStrP(section);
+                                file.compressNone = pckReadBoolP(section);
+
+                                const uint32_t referenceIdx = pckReadU32P(section);
+
+                                if (referenceIdx != 0)
+                                    file.reference = strLstGet(this->pub.referenceList, referenceIdx - 1);
+
+                                file.bundleId = pckReadU64P(section);
+                                file.bundleOffset = pckReadU64P(section);
+                                file.blockIncrSize = (size_t)pckReadU64P(section);
+                                file.blockIncrChecksumSize = (size_t)pckReadU64P(section);
+                                file.blockIncrMapSize = pckReadU64P(section);
+
+                                pckReadObjEndP(section);
+                                manifestFileAdd(this, &file);
+                            }
+
+                            MEM_CONTEXT_TEMP_RESET(1);
+                        }
+                    }
+                    MEM_CONTEXT_TEMP_END();
+
+                    pckReadArrayEndP(pack);
+                    pckReadEndP(pack);
+                }
+            }
+            MEM_CONTEXT_TEMP_END();
+
+            // Sort the lists the same as when loading the text manifest
+            lstSort(this->pub.dbList, sortOrderAsc);
+            lstSort(this->pub.fileList, sortOrderAsc);
+            lstSort(this->pub.linkList, sortOrderAsc);
+            lstSort(this->pub.pathList, sortOrderAsc);
+            lstSort(this->pub.targetList, sortOrderAsc);
+
+            // Make sure the base path exists
+            manifestTargetBase(this);
+        }
+        OBJ_NEW_END();
+
+        ioReadClose(read);
+    }
+
+    FUNCTION_LOG_RETURN(MANIFEST, this);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 manifestValidate(Manifest *const this, const bool strict)
@@ -3013,11 +3924,12 @@ manifestValidate(Manifest *const this, const bool strict)
         // Validate files
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(this); fileIdx++)
         {
-            const ManifestFile file = manifestFile(this, fileIdx);
+            // The name is only needed for errors so do not build it here
+            const ManifestFile file = manifestFileUnpackP(this, manifestFilePackGet(this, fileIdx), .noName = true);
 
             // All files must have a checksum
             if (file.checksumSha1 == NULL)
-                strCatFmt(error, "\nmissing checksum for file '%s'", strZ(file.name));
+                strCatFmt(error, "\nmissing checksum for file '%s'", strZ(manifestFileNameGet(this, fileIdx)));
 
             // These are strict checks to be performed only after a backup and before the final manifest save
             if (strict)
@@ -3027,12 +3939,13 @@ manifestValidate(Manifest *const this, const bool strict)
                 {
                     strCatFmt(
                         error, "\ninvalid checksum '%s' for zero size file '%s'",
-                        strZ(strNewEncode(encodingHex, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE))), strZ(file.name));
+                        strZ(strNewEncode(encodingHex, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE))),
+                        strZ(manifestFileNameGet(this, fileIdx)));
                 }
 
                 // Non-zero size files must have non-zero repo size
                 if (file.sizeRepo == 0 && file.size != 0)
-                    strCatFmt(error, "\nrepo size must be > 0 for file '%s'", strZ(file.name));
+                    strCatFmt(error, "\nrepo size must be > 0 for file '%s'", strZ(manifestFileNameGet(this, fileIdx)));
             }
         }
 
@@ -3048,6 +3961,93 @@ manifestValidate(Manifest *const this, const bool strict)
 /***********************************************************************************************************************************
 File functions and getters/setters
 ***********************************************************************************************************************************/
+FN_EXTERN const String *
+manifestFileNameGet(const Manifest *const this, const unsigned int fileIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(UINT, fileIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    const ManifestFilePack *const filePack = manifestFilePackGet(this, fileIdx);
+
+    strTrunc(this->fileName);
+
+    if (filePack->path != NULL)
+        strCatChr(strCat(this->fileName, filePack->path), '/');
+
+    FUNCTION_TEST_RETURN_CONST(STRING, strCatZ(this->fileName, filePack->leaf));
+}
+
+// Find file pack by name. NULL is returned when the file is not found.
+static ManifestFilePack **
+manifestFilePackFindDefault(const Manifest *const this, const String *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+
+    // Split the name into path and leaf. If the path is not in the path list then the file does not exist.
+    const char *leaf = strrchr(strZ(name), '/');
+    const String *path = NULL;
+
+    if (leaf != NULL)
+    {
+        bool found;
+        const unsigned int pathIdx = manifestFilePathIdx(this->filePathList, strZ(name), (size_t)(leaf - strZ(name)), &found);
+
+        if (!found)
+            FUNCTION_TEST_RETURN_TYPE_PP(ManifestFilePack, NULL);
+
+        path = *(const String **)lstGet(this->filePathList, pathIdx);
+        leaf++;
+    }
+    else
+        leaf = strZ(name);
+
+    // Compare directly against the path and leaf stored in each pack so no search key needs to be built
+    const List *const fileList = this->pub.fileList;
+
+    if (lstSortOrder(fileList) == sortOrderAsc)
+    {
+        unsigned int low = 0;
+        unsigned int high = lstSize(fileList);
+
+        while (low < high)
+        {
+            const unsigned int middle = low + (high - low) / 2;
+            ManifestFilePack **const filePack = lstGet(fileList, middle);
+            const int compare = manifestFileNameCmp((*filePack)->path, (*filePack)->leaf, path, leaf);
+
+            if (compare < 0)
+                low = middle + 1;
+            else if (compare > 0)
+                high = middle;
+            else
+                FUNCTION_TEST_RETURN_TYPE_PP(ManifestFilePack, filePack);
+        }
+    }
+    // Else fall back on an iterative search
+    else
+    {
+        for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
+        {
+            ManifestFilePack **const filePack = lstGet(fileList, fileIdx);
+
+            if (manifestFileNameCmp((*filePack)->path, (*filePack)->leaf, path, leaf) == 0)
+                FUNCTION_TEST_RETURN_TYPE_PP(ManifestFilePack, filePack);
+        }
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_PP(ManifestFilePack, NULL);
+}
+
 static ManifestFilePack **
 manifestFilePackFindInternal(const Manifest *const this, const String *const name)
 {
@@ -3059,7 +4059,7 @@ manifestFilePackFindInternal(const Manifest *const this, const String *const nam
     ASSERT(this != NULL);
     ASSERT(name != NULL);
 
-    ManifestFilePack **const filePack = lstFind(this->pub.fileList, &name);
+    ManifestFilePack **const filePack = manifestFilePackFindDefault(this, name);
 
     if (filePack == NULL)
         THROW_FMT(AssertError, "unable to find '%s' in manifest file list", strZ(name));
@@ -3081,6 +4081,20 @@ manifestFilePackFind(const Manifest *const this, const String *const name)
     FUNCTION_TEST_RETURN_TYPE_P(ManifestFilePack, *manifestFilePackFindInternal(this, name));
 }
 
+FN_EXTERN bool
+manifestFileExists(const Manifest *const this, const String *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, manifestFilePackFindDefault(this, name) != NULL);
+}
+
 FN_EXTERN void
 manifestFileRemove(const Manifest *const this, const String *const name)
 {
@@ -3092,9 +4106,13 @@ manifestFileRemove(const Manifest *const this, const String *const name)
     ASSERT(this != NULL);
     ASSERT(name != NULL);
 
-    if (!lstRemove(this->pub.fileList, &name))
+    ManifestFilePack **const filePack = manifestFilePackFindDefault(this, name);
+
+    if (filePack == NULL)
         THROW_FMT(AssertError, "unable to remove '%s' from manifest file list", strZ(name));
 
+    lstRemoveIdx(this->pub.fileList, lstIdx(this->pub.fileList, filePack));
+
     FUNCTION_TEST_RETURN_VOID();
 }
 
@@ -3413,15 +4431,62 @@ manifestLoadFileCallback(void *const data, const unsigned int try)
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+// Load the binary manifest. NULL is returned when it is missing or invalid so the text manifest can be loaded instead.
+static Manifest *
+manifestLoadFilePack(
+    const Storage *const storage, const String *const fileName, const CipherType cipherType, const String *const cipherPass,
+    const unsigned int skip)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, fileName);
+        FUNCTION_LOG_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(STRING, cipherPass);
+        FUNCTION_LOG_PARAM(UINT, skip);
+    FUNCTION_LOG_END();
+
+    Manifest *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const fileNamePack = strNewFmt("%s" BACKUP_MANIFEST_PACK_EXT, strZ(fileName));
+
+        TRY_BEGIN()
+        {
+            IoRead *const read = storageReadIo(storageNewReadP(storage, fileNamePack, .ignoreMissing = true));
+            cipherBlockFilterGroupAdd(ioReadFilterGroup(read), cipherType, cipherModeDecrypt, cipherPass);
+
+            Manifest *const manifest = manifestNewLoadPack(read, skip);
+
+            // The binary manifest is only valid when the text manifest exists. If the text manifest has been removed (e.g. to make
+            // the backup resumable) then the copy must be loaded instead.
+            if (manifest != NULL && storageExistsP(storage, fileName))
+                result = manifestMove(manifest, memContextPrior());
+        }
+        CATCH_ANY()
+        {
+            LOG_WARN_FMT(
+                "unable to load binary manifest '%s', loading text manifest instead: [%s] %s",
+                strZ(storagePathP(storage, fileNamePack)), errorTypeName(errorType()), errorMessage());
+        }
+        TRY_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(MANIFEST, result);
+}
+
 FN_EXTERN Manifest *
 manifestLoadFile(
-    const Storage *const storage, const String *const fileName, const CipherType cipherType, const String *const cipherPass)
+    const Storage *const storage, const String *const fileName, const CipherType cipherType, const String *const cipherPass,
+    const ManifestLoadFileParam param)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STORAGE, storage);
         FUNCTION_LOG_PARAM(STRING, fileName);
         FUNCTION_LOG_PARAM(STRING_ID, cipherType);
         FUNCTION_TEST_PARAM(STRING, cipherPass);
+        FUNCTION_LOG_PARAM(UINT, param.skip);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -3437,15 +4502,22 @@ manifestLoadFile(
         .cipherPass = cipherPass,
     };
 
-    MEM_CONTEXT_TEMP_BEGIN()
+    // Load the binary manifest if possible since it is faster and sections can be skipped
+    data.manifest = manifestLoadFilePack(storage, fileName, cipherType, cipherPass, param.skip);
+
+    // Else load the text manifest
+    if (data.manifest == NULL)
     {
-        const char *const fileNamePath = strZ(storagePathP(storage, fileName));
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const char *const fileNamePath = strZ(storagePathP(storage, fileName));
 
-        infoLoad(
-            strNewFmt("unable to load backup manifest file '%s' or '%s" INFO_COPY_EXT "'", fileNamePath, fileNamePath),
-            manifestLoadFileCallback, &data);
+            infoLoad(
+                strNewFmt("unable to load backup manifest file '%s' or '%s" INFO_COPY_EXT "'", fileNamePath, fileNamePath),
+                manifestLoadFileCallback, &data);
+        }
+        MEM_CONTEXT_TEMP_END();
     }
-    MEM_CONTEXT_TEMP_END();
 
     FUNCTION_LOG_RETURN(MANIFEST, data.manifest);
 }
@@ -6,6 +6,12 @@ timestamps, etc. A list of databases is also included for selective restore.
 
 The purpose of the manifest is to allow the restore command to confidently reconstruct the PostgreSQL data directory and ensure that
 nothing is missing or corrupt. It is also useful for reporting, e.g. size of backup, backup time, etc.
+
+When a backup completes a binary copy of the manifest is also saved next to the text manifest. The binary format is built on the
+pack type so it can be loaded without parsing text. It is divided into sections (each with a CRC-32C checksum) so the database,
+link, path, and file lists can be skipped by commands that do not need them. The text manifest remains authoritative -- the binary
+manifest is only loaded when the text manifest also exists and the text manifest is loaded instead when the binary manifest is
+missing or invalid.
 ***********************************************************************************************************************************/
 #ifndef INFO_MANIFEST_H
 #define INFO_MANIFEST_H
@@ -18,6 +24,8 @@ Constants
 #define BACKUP_MANIFEST_EXT                                         ".manifest"
 #define BACKUP_MANIFEST_FILE                                        "backup" BACKUP_MANIFEST_EXT
 STRING_DECLARE(BACKUP_MANIFEST_FILE_STR);
+#define BACKUP_MANIFEST_PACK_EXT                                    ".pack"
+#define BACKUP_MANIFEST_PACK_FILE                                   BACKUP_MANIFEST_FILE BACKUP_MANIFEST_PACK_EXT
 
 #define MANIFEST_PATH_BUNDLE                                        "bundle"
 STRING_DECLARE(MANIFEST_PATH_BUNDLE_STR);
@@ -43,6 +51,8 @@ typedef struct Manifest Manifest;
 #include "common/type/variant.h"
 #include "info/info.h"
 #include "info/infoBackup.h"
+#include "postgres/walSummary.h"
+#include "storage/list.h"
 #include "storage/storage.h"
 
 /***********************************************************************************************************************************
@@ -142,6 +152,7 @@ typedef struct ManifestFile
     bool resume : 1;                                                // Is the file being resumed (backup only)?
     bool checksumPage : 1;                                          // Does this file have page checksums?
     bool checksumPageError : 1;                                     // Is there an error in the page checksum?
+    bool compressNone : 1;                                          // Stored without compression (compress-adaptive)?
     mode_t mode;                                                    // File mode
     const uint8_t *checksumSha1;                                    // SHA1 checksum
     const uint8_t *checksumRepoSha1;                                // SHA1 checksum as stored in repo (including compression, etc.)
@@ -208,6 +219,29 @@ typedef struct ManifestTarget
     const String *tablespaceName;                                   // Name of the tablespace
 } ManifestTarget;
 
+/***********************************************************************************************************************************
+Path contents listed before the build, e.g. by local processes in parallel. Each list must contain the same info that a storage
+iterator on the path would return. The build iterates paths that are not in the list as usual. Each list is freed as soon as the
+build has used it so all the listings are not held until the build is complete.
+***********************************************************************************************************************************/
+typedef struct ManifestBuildPath
+{
+    const String *path;                                             // Absolute path (must be first member in struct)
+    StorageList *list;                                              // Path contents (NULL once used by the build)
+} ManifestBuildPath;
+
+/***********************************************************************************************************************************
+Binary manifest sections that can be skipped during load. The manifest data and targets are always loaded.
+***********************************************************************************************************************************/
+typedef enum
+{
+    manifestSectionDb = 1 << 0,                                     // Database list
+    manifestSectionFile = 1 << 1,                                   // File list
+    manifestSectionLink = 1 << 2,                                   // Link list
+    manifestSectionPath = 1 << 3,                                   // Path list
+    manifestSectionList = manifestSectionDb | manifestSectionFile | manifestSectionLink | manifestSectionPath,
+} ManifestSection;
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
@@ -215,11 +249,15 @@ Constructors
 FN_EXTERN Manifest *manifestNewBuild(
     const Storage *storagePg, unsigned int pgVersion, unsigned int pgCatalogVersion, time_t timestampStart, bool online,
     bool checksumPage, bool bundle, bool blockIncr, const ManifestBlockIncrMap *blockIncrMap, const StringList *excludeList,
-    const Pack *tablespaceList);
+    const Pack *tablespaceList, List *buildPathList);
 
 // Load a manifest from IO
 FN_EXTERN Manifest *manifestNewLoad(IoRead *read);
 
+// Load a binary manifest from IO. Lists in skipped sections (see ManifestSection) will be empty. Returns NULL if the read cannot be
+// opened, e.g. the file is missing and ignoreMissing was specified.
+FN_EXTERN Manifest *manifestNewLoadPack(IoRead *read, unsigned int skip);
+
 /***********************************************************************************************************************************
 Getters/Setters
 ***********************************************************************************************************************************/
@@ -256,6 +294,13 @@ manifestData(const Manifest *const this)
     return &(THIS_PUB(Manifest)->data);
 }
 
+// Get the compression type used to store a file in the repo
+FN_INLINE_ALWAYS CompressType
+manifestFileCompressType(const Manifest *const this, const ManifestFile *const file)
+{
+    return file->compressNone ? compressTypeNone : manifestData(this)->backupOptionCompressType;
+}
+
 // Get reference list
 FN_INLINE_ALWAYS const StringList *
 manifestReferenceList(const Manifest *const this)
@@ -272,8 +317,10 @@ Build functions
 // Validate the timestamps in the manifest given a copy start time, i.e. all times should be <= the copy start time
 FN_EXTERN void manifestBuildValidate(Manifest *this, bool delta, time_t copyStart, CompressType compressType);
 
-// Create a diff/incr backup by comparing to a previous backup manifest
-FN_EXTERN void manifestBuildIncr(Manifest *this, const Manifest *prior, BackupType type, const String *archiveStart);
+// Create a diff/incr backup by comparing to a previous backup manifest. If a WAL summary covering the WAL since the prior backup is
+// provided then relation files it reports as unmodified are referenced to the prior backup.
+FN_EXTERN void manifestBuildIncr(
+    Manifest *this, const Manifest *prior, BackupType type, const String *archiveStart, const WalSummary *walSummary);
 
 // Set remaining values before the final save
 FN_EXTERN void manifestBuildComplete(
@@ -298,6 +345,9 @@ manifestMove(Manifest *const this, MemContext *const parentNew)
 // Manifest save
 FN_EXTERN void manifestSave(Manifest *this, IoWrite *write);
 
+// Save manifest in binary format. Backup-only file flags (copy, delta, resume) are not saved, the same as the text manifest.
+FN_EXTERN void manifestSavePack(Manifest *this, IoWrite *write);
+
 // Validate a completed manifest. Use strict mode only when saving the manifest after a backup.
 FN_EXTERN void manifestValidate(Manifest *this, bool strict);
 
@@ -329,8 +379,22 @@ File functions and getters/setters
 ***********************************************************************************************************************************/
 typedef struct ManifestFilePack ManifestFilePack;
 
-// Unpack file pack returned by manifestFilePackGet()
-FN_EXTERN ManifestFile manifestFileUnpack(const Manifest *manifest, const ManifestFilePack *filePack);
+// Unpack file pack returned by manifestFilePackGet(). The name is built from the path and leaf stored in the pack so it is
+// allocated in the current memory context unless noName is set.
+typedef struct ManifestFileUnpackParam
+{
+    VAR_PARAM_HEADER;
+    bool noName;                                                    // Do not build the name (for comparators)
+} ManifestFileUnpackParam;
+
+#define manifestFileUnpackP(manifest, filePack, ...)                                                                               \
+    manifestFileUnpack(manifest, filePack, (ManifestFileUnpackParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+FN_EXTERN ManifestFile manifestFileUnpack(
+    const Manifest *manifest, const ManifestFilePack *filePack, ManifestFileUnpackParam param);
+
+// Compare file pack names
+FN_EXTERN int manifestFilePackNameCmp(const ManifestFilePack *filePack1, const ManifestFilePack *filePack2);
 
 // Get file in pack format by index
 FN_INLINE_ALWAYS const ManifestFilePack *
@@ -339,18 +403,14 @@ manifestFilePackGet(const Manifest *const this, const unsigned int fileIdx)
     return *(ManifestFilePack **)lstGet(THIS_PUB(Manifest)->fileList, fileIdx);
 }
 
-// Get file name
-FN_INLINE_ALWAYS const String *
-manifestFileNameGet(const Manifest *const this, const unsigned int fileIdx)
-{
-    return (const String *)manifestFilePackGet(this, fileIdx);
-}
+// Get file name. The name is built in a buffer owned by the manifest so it is only valid until the next call.
+FN_EXTERN const String *manifestFileNameGet(const Manifest *this, unsigned int fileIdx);
 
 // Get file by index
 FN_INLINE_ALWAYS ManifestFile
 manifestFile(const Manifest *const this, const unsigned int fileIdx)
 {
-    return manifestFileUnpack(this, manifestFilePackGet(this, fileIdx));
+    return manifestFileUnpackP(this, manifestFilePackGet(this, fileIdx));
 }
 
 // Add a file
@@ -364,16 +424,16 @@ FN_INLINE_ALWAYS ManifestFile
 manifestFileFind(const Manifest *const this, const String *const name)
 {
     ASSERT_INLINE(name != NULL);
-    return manifestFileUnpack(this, manifestFilePackFind(this, name));
+
+    // The name found is equal to the name searched for so there is no need to build it from the pack
+    ManifestFile result = manifestFileUnpackP(this, manifestFilePackFind(this, name), .noName = true);
+    result.name = name;
+
+    return result;
 }
 
 // Does the file exist?
-FN_INLINE_ALWAYS bool
-manifestFileExists(const Manifest *const this, const String *const name)
-{
-    ASSERT_INLINE(name != NULL);
-    return lstFindDefault(THIS_PUB(Manifest)->fileList, &name, NULL) != NULL;
-}
+FN_EXTERN bool manifestFileExists(const Manifest *this, const String *name);
 
 FN_EXTERN void manifestFileRemove(const Manifest *this, const String *name);
 
@@ -496,9 +556,19 @@ manifestFree(Manifest *const this)
 /***********************************************************************************************************************************
 Helper functions
 ***********************************************************************************************************************************/
-// Load backup manifest
+// Load backup manifest. The binary manifest is loaded when it exists (see header) and skip determines which of its sections are
+// loaded. All sections are loaded when the text manifest is loaded.
+typedef struct ManifestLoadFileParam
+{
+    VAR_PARAM_HEADER;
+    unsigned int skip;                                              // Binary manifest sections to skip (see ManifestSection)
+} ManifestLoadFileParam;
+
+#define manifestLoadFileP(storage, fileName, cipherType, cipherPass, ...)                                                          \
+    manifestLoadFile(storage, fileName, cipherType, cipherPass, (ManifestLoadFileParam){VAR_PARAM_INIT, __VA_ARGS__})
+
 FN_EXTERN Manifest *manifestLoadFile(
-    const Storage *storage, const String *fileName, CipherType cipherType, const String *cipherPass);
+    const Storage *storage, const String *fileName, CipherType cipherType, const String *cipherPass, ManifestLoadFileParam param);
 
 /***********************************************************************************************************************************
 Macros for function logging
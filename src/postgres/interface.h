@@ -107,6 +107,7 @@ typedef struct PgControl
     unsigned int walSegmentSize;
 
     unsigned int pageChecksumVersion;                               // Page checksum version (0 if no checksum, 1 if checksum)
+    bool walLogHints;                                               // Are hint bit updates WAL-logged (wal_log_hints)?
 } PgControl;
 
 /***********************************************************************************************************************************
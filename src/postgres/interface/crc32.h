@@ -1,7 +1,7 @@
 /***********************************************************************************************************************************
 CRC-32 Calculation
 
-CRC-32 and CRC-32C calculations required to validate the integrity of pg_control.
+CRC-32 and CRC-32C calculations required to validate the integrity of pg_control and other PostgreSQL data.
 ***********************************************************************************************************************************/
 #ifndef POSTGRES_INTERFACE_CRC32_H
 #define POSTGRES_INTERFACE_CRC32_H
@@ -9,10 +9,19 @@ CRC-32 and CRC-32C calculations required to validate the integrity of pg_control
 #include <inttypes.h>
 #include <stddef.h>
 
+/***********************************************************************************************************************************
+Initial CRC-32C value. The CRC must also be xor'd with this value when all data has been processed.
+***********************************************************************************************************************************/
+#define CRC32C_INIT                                                 0xffffffff
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
 // Generate CRC-32C checksum
 FN_EXTERN uint32_t crc32cOne(const uint8_t *data, size_t size);
 
+// Update a CRC-32C that has not been finalized. Start with CRC32C_INIT and xor the result with CRC32C_INIT when all data has been
+// processed.
+FN_EXTERN uint32_t crc32cUpdate(uint32_t crc, const uint8_t *data, size_t size);
+
 #endif
@@ -7,6 +7,10 @@ Adapted from PostgreSQL src/include/storage/checksum_impl.h.
 
 #include <string.h>
 
+#ifdef HAVE_CPU_X86_SIMD
+#include <immintrin.h>
+#endif
+
 #include "postgres/interface/static.vendor.h"
 
 /***********************************************************************************************************************************
@@ -26,12 +30,21 @@ Page checksum calculation
         checksum = tmp * FNV_PRIME ^ (tmp >> 17);                                                                                  \
     } while (0)
 
+// Initial partial checksums
+static const uint32_t pgPageChecksumBase[PARALLEL_SUM] =
+{
+    0x5b1f36e9, 0xb8525960, 0x02ab50aa, 0x1de66d2a, 0x79ff467a, 0x9bb9f8a3, 0x217e7cd2, 0x83e13d2c,
+    0xf8d4474f, 0xe39eb970, 0x42c6ae16, 0x993216fa, 0x7b093b5d, 0x98daff3c, 0xf718902a, 0x0b1c9cdb,
+    0xe58f764b, 0x187636bc, 0x5d7b3bb1, 0xe73de7de, 0x92bec979, 0xcca6c0b2, 0x304a0979, 0x85aa43d4,
+    0x783125bb, 0x6ca8eaa2, 0xe407eac6, 0x4b5cfc3e, 0x9fbf8c76, 0x15ca20be, 0xf2ca9fd3, 0x959bd756,
+};
+
 // Main calculation loop
 #define CHECKSUM_CASE(pageSize)                                                                                                    \
     case pageSize:                                                                                                                 \
         for (uint32_t i = 0; i < (uint32) (pageSize / (sizeof(uint32) * PARALLEL_SUM)); i++)                                       \
             for (uint32_t j = 0; j < PARALLEL_SUM; j++)                                                                            \
-                CHECKSUM_ROUND(sums[j], ((PgPageChecksum##pageSize *)page)->data[i][j]);                                           \
+                CHECKSUM_ROUND(sums[j], ((const PgPageChecksum##pageSize *)page)->data[i][j]);                                     \
                                                                                                                                    \
         break;
 
@@ -52,29 +65,28 @@ CHECKSUM_UNION(pgPageSize8);
 CHECKSUM_UNION(pgPageSize16);
 CHECKSUM_UNION(pgPageSize32);
 
-/**********************************************************************************************************************************/
-FN_EXTERN uint16_t
-pgPageChecksum(uint8_t *const page, const uint32_t blockNo, const PgPageSize pageSize)
+/***********************************************************************************************************************************
+Checksum kernels
+
+Each kernel calculates the folded checksum of a page (before the block number is mixed in) and must produce the same result as the
+scalar kernel. The SIMD kernels calculate the partial checksums in vector registers, which is possible because the algorithm was
+designed to calculate PARALLEL_SUM independent checksums. The kernel is selected at runtime based on the features reported by the
+CPU so the binary can still be run on CPUs that do not support the instructions.
+***********************************************************************************************************************************/
+typedef uint32_t PgPageChecksumKernel(const uint8_t *page, PgPageSize pageSize);
+
+// Portable kernel
+static uint32_t
+pgPageChecksumScalar(const uint8_t *const page, const PgPageSize pageSize)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM_P(BYTEDATA, page);
-        FUNCTION_TEST_PARAM(UINT, blockNo);
         FUNCTION_TEST_PARAM(ENUM, pageSize);
     FUNCTION_TEST_END();
 
-    // Save pd_checksum and temporarily set it to zero, so that the checksum calculation isn't affected by the old checksum stored
-    // on the page. Restore it after, because actually updating the checksum is NOT part of the API of this function.
-    const uint16_t checksumPrior = ((PageHeaderData *)page)->pd_checksum;
-    ((PageHeaderData *)page)->pd_checksum = 0;
-
     // Initialize partial checksums to their corresponding offsets
-    uint32_t sums[PARALLEL_SUM] =
-    {
-        0x5b1f36e9, 0xb8525960, 0x02ab50aa, 0x1de66d2a, 0x79ff467a, 0x9bb9f8a3, 0x217e7cd2, 0x83e13d2c,
-        0xf8d4474f, 0xe39eb970, 0x42c6ae16, 0x993216fa, 0x7b093b5d, 0x98daff3c, 0xf718902a, 0x0b1c9cdb,
-        0xe58f764b, 0x187636bc, 0x5d7b3bb1, 0xe73de7de, 0x92bec979, 0xcca6c0b2, 0x304a0979, 0x85aa43d4,
-        0x783125bb, 0x6ca8eaa2, 0xe407eac6, 0x4b5cfc3e, 0x9fbf8c76, 0x15ca20be, 0xf2ca9fd3, 0x959bd756,
-    };
+    uint32_t sums[PARALLEL_SUM];
+    memcpy(sums, pgPageChecksumBase, sizeof(sums));
 
     // Main checksum calculation
     switch (pageSize)
@@ -101,6 +113,171 @@ pgPageChecksum(uint8_t *const page, const uint32_t blockNo, const PgPageSize pag
     for (uint32_t i = 0; i < PARALLEL_SUM; i++)
         result ^= sums[i];
 
+    FUNCTION_TEST_RETURN(UINT32, result);
+}
+
+#ifdef HAVE_CPU_X86_SIMD
+
+// Calculate one round of the checksum on a vector of partial checksums
+#define CHECKSUM_ROUND_SSE41(checksum, value)                                                                                      \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        const __m128i tmp = _mm_xor_si128(checksum, value);                                                                        \
+        checksum = _mm_xor_si128(_mm_mullo_epi32(tmp, prime), _mm_srli_epi32(tmp, 17));                                            \
+    } while (0)
+
+#define CHECKSUM_ROUND_AVX2(checksum, value)                                                                                       \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        const __m256i tmp = _mm256_xor_si256(checksum, value);                                                                     \
+        checksum = _mm256_xor_si256(_mm256_mullo_epi32(tmp, prime), _mm256_srli_epi32(tmp, 17));                                   \
+    } while (0)
+
+// Partial checksums per register and registers required for all partial checksums
+#define CHECKSUM_SSE41_LANE                                         (sizeof(__m128i) / sizeof(uint32_t))
+#define CHECKSUM_SSE41_REG                                          (PARALLEL_SUM / CHECKSUM_SSE41_LANE)
+#define CHECKSUM_AVX2_LANE                                          (sizeof(__m256i) / sizeof(uint32_t))
+#define CHECKSUM_AVX2_REG                                           (PARALLEL_SUM / CHECKSUM_AVX2_LANE)
+
+// SSE4.1 kernel (four partial checksums per register)
+static __attribute__((target("sse4.1"))) uint32_t
+pgPageChecksumSse41(const uint8_t *const page, const PgPageSize pageSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(BYTEDATA, page);
+        FUNCTION_TEST_PARAM(ENUM, pageSize);
+    FUNCTION_TEST_END();
+
+    pgPageSizeCheck(pageSize);
+
+    const __m128i prime = _mm_set1_epi32(FNV_PRIME);
+    __m128i sums[CHECKSUM_SSE41_REG];
+
+    for (unsigned int regIdx = 0; regIdx < CHECKSUM_SSE41_REG; regIdx++)
+        sums[regIdx] = _mm_loadu_si128((const __m128i *)pgPageChecksumBase + regIdx);
+
+    // Main checksum calculation
+    const __m128i *const data = (const __m128i *)page;
+    const unsigned int rowTotal = pageSize / (sizeof(uint32_t) * PARALLEL_SUM);
+
+    for (unsigned int rowIdx = 0; rowIdx < rowTotal; rowIdx++)
+        for (unsigned int regIdx = 0; regIdx < CHECKSUM_SSE41_REG; regIdx++)
+            CHECKSUM_ROUND_SSE41(sums[regIdx], _mm_loadu_si128(data + rowIdx * CHECKSUM_SSE41_REG + regIdx));
+
+    // Add in two rounds of zeroes for additional mixing
+    for (unsigned int i = 0; i < 2; i++)
+        for (unsigned int regIdx = 0; regIdx < CHECKSUM_SSE41_REG; regIdx++)
+            CHECKSUM_ROUND_SSE41(sums[regIdx], _mm_setzero_si128());
+
+    // Xor fold partial checksums together
+    __m128i fold = sums[0];
+
+    for (unsigned int regIdx = 1; regIdx < CHECKSUM_SSE41_REG; regIdx++)
+        fold = _mm_xor_si128(fold, sums[regIdx]);
+
+    uint32_t lane[CHECKSUM_SSE41_LANE];
+    _mm_storeu_si128((__m128i *)lane, fold);
+
+    FUNCTION_TEST_RETURN(UINT32, lane[0] ^ lane[1] ^ lane[2] ^ lane[3]);
+}
+
+// AVX2 kernel (eight partial checksums per register)
+static __attribute__((target("avx2"))) uint32_t
+pgPageChecksumAvx2(const uint8_t *const page, const PgPageSize pageSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(BYTEDATA, page);
+        FUNCTION_TEST_PARAM(ENUM, pageSize);
+    FUNCTION_TEST_END();
+
+    pgPageSizeCheck(pageSize);
+
+    const __m256i prime = _mm256_set1_epi32(FNV_PRIME);
+    __m256i sums[CHECKSUM_AVX2_REG];
+
+    for (unsigned int regIdx = 0; regIdx < CHECKSUM_AVX2_REG; regIdx++)
+        sums[regIdx] = _mm256_loadu_si256((const __m256i *)pgPageChecksumBase + regIdx);
+
+    // Main checksum calculation
+    const __m256i *const data = (const __m256i *)page;
+    const unsigned int rowTotal = pageSize / (sizeof(uint32_t) * PARALLEL_SUM);
+
+    for (unsigned int rowIdx = 0; rowIdx < rowTotal; rowIdx++)
+        for (unsigned int regIdx = 0; regIdx < CHECKSUM_AVX2_REG; regIdx++)
+            CHECKSUM_ROUND_AVX2(sums[regIdx], _mm256_loadu_si256(data + rowIdx * CHECKSUM_AVX2_REG + regIdx));
+
+    // Add in two rounds of zeroes for additional mixing
+    for (unsigned int i = 0; i < 2; i++)
+        for (unsigned int regIdx = 0; regIdx < CHECKSUM_AVX2_REG; regIdx++)
+            CHECKSUM_ROUND_AVX2(sums[regIdx], _mm256_setzero_si256());
+
+    // Xor fold partial checksums together
+    __m256i fold = sums[0];
+
+    for (unsigned int regIdx = 1; regIdx < CHECKSUM_AVX2_REG; regIdx++)
+        fold = _mm256_xor_si256(fold, sums[regIdx]);
+
+    uint32_t lane[CHECKSUM_AVX2_LANE];
+    _mm256_storeu_si256((__m256i *)lane, fold);
+
+    FUNCTION_TEST_RETURN(UINT32, lane[0] ^ lane[1] ^ lane[2] ^ lane[3] ^ lane[4] ^ lane[5] ^ lane[6] ^ lane[7]);
+}
+
+#endif // HAVE_CPU_X86_SIMD
+
+// Select the fastest kernel supported by the CPU
+static PgPageChecksumKernel *
+pgPageChecksumKernelSelect(const bool avx2, const bool sse41)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BOOL, avx2);
+        FUNCTION_TEST_PARAM(BOOL, sse41);
+    FUNCTION_TEST_END();
+
+    PgPageChecksumKernel *result = pgPageChecksumScalar;
+
+#ifdef HAVE_CPU_X86_SIMD
+    if (avx2)
+        result = pgPageChecksumAvx2;
+    else if (sse41)
+        result = pgPageChecksumSse41;
+#endif
+
+    FUNCTION_TEST_RETURN_TYPE_P(PgPageChecksumKernel, result);
+}
+
+// Kernel selected for this CPU
+static PgPageChecksumKernel *pgPageChecksumKernel = NULL;
+
+/**********************************************************************************************************************************/
+FN_EXTERN uint16_t
+pgPageChecksum(uint8_t *const page, const uint32_t blockNo, const PgPageSize pageSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(BYTEDATA, page);
+        FUNCTION_TEST_PARAM(UINT, blockNo);
+        FUNCTION_TEST_PARAM(ENUM, pageSize);
+    FUNCTION_TEST_END();
+
+    // Select the kernel on first use
+    if (pgPageChecksumKernel == NULL)
+    {
+#ifdef HAVE_CPU_X86_SIMD
+        __builtin_cpu_init();
+        pgPageChecksumKernel = pgPageChecksumKernelSelect(__builtin_cpu_supports("avx2"), __builtin_cpu_supports("sse4.1"));
+#else
+        pgPageChecksumKernel = pgPageChecksumKernelSelect(false, false);
+#endif
+    }
+
+    // Save pd_checksum and temporarily set it to zero, so that the checksum calculation isn't affected by the old checksum stored
+    // on the page. Restore it after, because actually updating the checksum is NOT part of the API of this function.
+    const uint16_t checksumPrior = ((PageHeaderData *)page)->pd_checksum;
+    ((PageHeaderData *)page)->pd_checksum = 0;
+
+    // Main checksum calculation
+    uint32 result = pgPageChecksumKernel(page, pageSize);
+
     // Restore prior checksum
     ((PageHeaderData *)page)->pd_checksum = checksumPrior;
 
@@ -71,6 +71,7 @@ Read the version specific pg_control into a general data structure
             .pageSize = ((const ControlFileData *)controlFile)->blcksz,                                                            \
             .walSegmentSize = ((const ControlFileData *)controlFile)->xlog_seg_size,                                               \
             .pageChecksumVersion = ((const ControlFileData *)controlFile)->data_checksum_version,                                  \
+            .walLogHints = ((const ControlFileData *)controlFile)->wal_log_hints,                                                  \
         };                                                                                                                         \
     }
 
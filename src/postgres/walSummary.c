@@ -0,0 +1,477 @@
+/***********************************************************************************************************************************
+PostgreSQL WAL Summary
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <string.h>
+
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/regExp.h"
+#include "common/type/convert.h"
+#include "common/type/list.h"
+#include "postgres/interface.h"
+#include "postgres/interface/crc32.h"
+#include "postgres/walSummary.h"
+
+/***********************************************************************************************************************************
+Summary file format constants (see blkreftable.c in PostgreSQL)
+***********************************************************************************************************************************/
+#define WAL_SUMMARY_MAGIC                                           0x652b137b
+
+// Maximum entries in a chunk. A chunk with this many entries is stored as a bitmap, otherwise as an array of block offsets.
+#define WAL_SUMMARY_CHUNK_ENTRY_MAX                                 4096
+
+// Blocks covered by each chunk
+#define WAL_SUMMARY_CHUNK_BLOCK                                     65536
+
+// Limit block when the relation fork was not created or truncated
+#define WAL_SUMMARY_LIMIT_BLOCK_NONE                                0xFFFFFFFF
+
+// Tablespace oids for the global and base directories
+#define WAL_SUMMARY_OID_TABLESPACE_DEFAULT                          1663
+#define WAL_SUMMARY_OID_TABLESPACE_GLOBAL                           1664
+
+// Fork numbers that are checked. The free space map (1) is not fully WAL-logged and the init fork (3) is always copied.
+#define WAL_SUMMARY_FORK_MAIN                                       0
+#define WAL_SUMMARY_FORK_VM                                         2
+
+/***********************************************************************************************************************************
+Serialized entry. Each entry is followed by the entry count for each chunk (uint16) and then the entries for each chunk (uint16).
+The list of entries is terminated by an entry that is all zeroes.
+***********************************************************************************************************************************/
+typedef struct WalSummaryEntry
+{
+    uint32_t spcOid;                                                // Tablespace oid
+    uint32_t dbOid;                                                 // Database oid
+    uint32_t relNumber;                                             // Relation file number
+    int32_t forkNum;                                                // Fork number
+    uint32_t limitBlock;                                            // Limit block when created/truncated
+    uint32_t chunkTotal;                                            // Total chunks
+} WalSummaryEntry;
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct WalSummaryRelation
+{
+    uint32_t spcOid;                                                // Tablespace oid
+    uint32_t dbOid;                                                 // Database oid
+    uint32_t relNumber;                                             // Relation file number
+    int32_t forkNum;                                                // Fork number
+} WalSummaryRelation;
+
+typedef struct WalSummaryFork
+{
+    WalSummaryRelation relation;                                    // Relation fork (must be first for the comparator)
+    uint32_t segmentLimit;                                          // Segments at or after the limit have been modified
+} WalSummaryFork;
+
+typedef struct WalSummarySegment
+{
+    WalSummaryRelation relation;                                    // Relation fork
+    uint32_t segment;                                               // Modified segment
+} WalSummarySegment;
+
+struct WalSummary
+{
+    uint32_t segmentBlock;                                          // Blocks per relation segment
+    List *forkList;                                                 // Modified relation forks
+    List *segmentList;                                              // Modified relation segments
+    RegExp *relationExp;                                            // Relation file expression
+};
+
+/***********************************************************************************************************************************
+Relation and segment comparators
+***********************************************************************************************************************************/
+static int
+lstComparatorWalSummaryRelation(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const WalSummaryRelation *const relation1 = item1;
+    const WalSummaryRelation *const relation2 = item2;
+
+    if (relation1->spcOid != relation2->spcOid)
+        FUNCTION_TEST_RETURN(INT, relation1->spcOid < relation2->spcOid ? -1 : 1);
+
+    if (relation1->dbOid != relation2->dbOid)
+        FUNCTION_TEST_RETURN(INT, relation1->dbOid < relation2->dbOid ? -1 : 1);
+
+    if (relation1->relNumber != relation2->relNumber)
+        FUNCTION_TEST_RETURN(INT, relation1->relNumber < relation2->relNumber ? -1 : 1);
+
+    FUNCTION_TEST_RETURN(INT, relation1->forkNum - relation2->forkNum);
+}
+
+static int
+lstComparatorWalSummarySegment(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const WalSummarySegment *const segment1 = item1;
+    const WalSummarySegment *const segment2 = item2;
+    const int result = lstComparatorWalSummaryRelation(&segment1->relation, &segment2->relation);
+
+    if (result != 0 || segment1->segment == segment2->segment)
+        FUNCTION_TEST_RETURN(INT, result);
+
+    FUNCTION_TEST_RETURN(INT, segment1->segment < segment2->segment ? -1 : 1);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN WalSummary *
+walSummaryNew(const PgPageSize pageSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, pageSize);
+    FUNCTION_TEST_END();
+
+    ASSERT(pgPageSizeValid(pageSize));
+
+    OBJ_NEW_BEGIN(WalSummary, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (WalSummary)
+        {
+            .segmentBlock = PG_SEGMENT_SIZE_DEFAULT / pageSize,
+            .forkList = lstNewP(sizeof(WalSummaryFork), .sortOrder = sortOrderAsc, .comparator = lstComparatorWalSummaryRelation),
+            .segmentList = lstNewP(
+                sizeof(WalSummarySegment), .sortOrder = sortOrderAsc, .comparator = lstComparatorWalSummarySegment),
+            .relationExp = regExpNew(
+                STRDEF(
+                    "^(" PG_PATH_GLOBAL "|" PG_PATH_BASE "/[0-9]+|" PG_PATH_PGTBLSPC "/[0-9]+/[^/]+/[0-9]+)/[0-9]+(_vm){0,1}"
+                    "(\\.[0-9]+){0,1}$")),
+        };
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_TEST_RETURN(WAL_SUMMARY, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN StringList *
+walSummaryFileList(const StringList *const fileList, const uint32_t timeline, const uint64_t lsnBegin, const uint64_t lsnEnd)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileList);
+        FUNCTION_LOG_PARAM(UINT, timeline);
+        FUNCTION_LOG_PARAM(UINT64, lsnBegin);
+        FUNCTION_LOG_PARAM(UINT64, lsnEnd);
+    FUNCTION_LOG_END();
+
+    ASSERT(fileList != NULL);
+    ASSERT(lsnBegin <= lsnEnd);
+
+    StringList *result = strLstNew();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Repeatedly select the summary that starts at or before the covered LSN and extends coverage the furthest. Summaries
+        // usually abut so this will normally select each summary in the range once.
+        uint64_t lsnCovered = lsnBegin;
+
+        while (lsnCovered < lsnEnd)
+        {
+            const String *fileSelect = NULL;
+            uint64_t lsnSelect = lsnCovered;
+
+            for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+            {
+                const String *const file = strLstGet(fileList, fileIdx);
+
+                if (cvtZSubNToUIntBase(strZ(file), 0, 8, 16) == timeline)
+                {
+                    const uint64_t lsnStart = cvtZSubNToUInt64Base(strZ(file), 8, 16, 16);
+                    const uint64_t lsnStop = cvtZSubNToUInt64Base(strZ(file), 24, 16, 16);
+
+                    if (lsnStart <= lsnCovered && lsnStop > lsnSelect)
+                    {
+                        fileSelect = file;
+                        lsnSelect = lsnStop;
+                    }
+                }
+            }
+
+            // Stop when there is a gap in coverage
+            if (fileSelect == NULL)
+            {
+                strLstFree(result);
+                result = NULL;
+                break;
+            }
+
+            strLstAdd(result, fileSelect);
+            lsnCovered = lsnSelect;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STRING_LIST, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+walSummaryModified(const WalSummary *const this, const String *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(WAL_SUMMARY, this);
+        FUNCTION_TEST_PARAM(STRING, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(file != NULL);
+
+    bool result = true;
+
+    if (regExpMatch(this->relationExp, file))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const StringList *const pathList = strLstNewSplitZ(file, "/");
+            WalSummaryRelation relation = {.spcOid = WAL_SUMMARY_OID_TABLESPACE_GLOBAL};
+
+            // Get tablespace/database
+            if (strEqZ(strLstGet(pathList, 0), PG_PATH_BASE))
+            {
+                relation.spcOid = WAL_SUMMARY_OID_TABLESPACE_DEFAULT;
+                relation.dbOid = cvtZToUInt(strZ(strLstGet(pathList, 1)));
+            }
+            else if (strEqZ(strLstGet(pathList, 0), PG_PATH_PGTBLSPC))
+            {
+                relation.spcOid = cvtZToUInt(strZ(strLstGet(pathList, 1)));
+                relation.dbOid = cvtZToUInt(strZ(strLstGet(pathList, 3)));
+            }
+
+            // Get relation number and fork with the segment number removed
+            const StringList *const segmentPart = strLstNewSplitZ(strLstGet(pathList, strLstSize(pathList) - 1), ".");
+            const StringList *const relationPart = strLstNewSplitZ(strLstGet(segmentPart, 0), "_");
+
+            relation.relNumber = cvtZToUInt(strZ(strLstGet(relationPart, 0)));
+            relation.forkNum = strLstSize(relationPart) == 1 ? WAL_SUMMARY_FORK_MAIN : WAL_SUMMARY_FORK_VM;
+
+            // A relation fork that is not in any summary has not been modified. Otherwise the segment has been modified when it is
+            // at or after the limit or when any of its blocks have been modified.
+            const WalSummaryFork *const fork = lstFind(this->forkList, &relation);
+
+            if (fork == NULL)
+                result = false;
+            else
+            {
+                const uint32_t segment = strLstSize(segmentPart) == 1 ? 0 : cvtZToUInt(strZ(strLstGet(segmentPart, 1)));
+
+                result =
+                    segment >= fork->segmentLimit ||
+                    lstExists(this->segmentList, &(WalSummarySegment){.relation = relation, .segment = segment});
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+/**********************************************************************************************************************************/
+// Read from the summary file and update the crc
+static void
+walSummaryReadBuffer(IoRead *const read, Buffer *const buffer, const size_t size, uint32_t *const crc)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, read);
+        FUNCTION_TEST_PARAM(BUFFER, buffer);
+        FUNCTION_TEST_PARAM(SIZE, size);
+        FUNCTION_TEST_PARAM_P(UINT32, crc);
+    FUNCTION_TEST_END();
+
+    ASSERT(read != NULL);
+    ASSERT(buffer != NULL);
+    ASSERT(size <= bufSizeAlloc(buffer));
+
+    bufUsedZero(buffer);
+    bufLimitSet(buffer, size);
+
+    if (size > 0)
+        ioReadSmall(read, buffer);
+
+    CHECK(FormatError, bufUsed(buffer) == size, "unexpected eof in WAL summary");
+
+    if (crc != NULL)
+        *crc = crc32cUpdate(*crc, bufPtrConst(buffer), size);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+FN_EXTERN void
+walSummaryRead(WalSummary *const this, IoRead *const read)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(WAL_SUMMARY, this);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(read != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        Buffer *const buffer = bufNew(WAL_SUMMARY_CHUNK_ENTRY_MAX * sizeof(uint16_t));
+        uint32_t crc = CRC32C_INIT;
+
+        ioReadOpen(read);
+
+        // Check magic
+        uint32_t magic;
+
+        walSummaryReadBuffer(read, buffer, sizeof(magic), &crc);
+        memcpy(&magic, bufPtrConst(buffer), sizeof(magic));
+
+        if (magic != WAL_SUMMARY_MAGIC)
+            THROW_FMT(FormatError, "WAL summary magic 0x%08x is invalid", magic);
+
+        // Read entries until the terminating entry
+        static const WalSummaryEntry entryZero = {0};
+        Buffer *const chunkSizeBuffer = bufNew(0);
+
+        while (true)
+        {
+            WalSummaryEntry entry;
+
+            walSummaryReadBuffer(read, buffer, sizeof(entry), &crc);
+            memcpy(&entry, bufPtrConst(buffer), sizeof(entry));
+
+            if (memcmp(&entry, &entryZero, sizeof(entry)) == 0)
+                break;
+
+            // Segments at or after the segment containing the limit block have been modified. A limit block of zero means the
+            // relation fork was created so all segments have been modified.
+            const WalSummaryRelation relation =
+            {
+                .spcOid = entry.spcOid, .dbOid = entry.dbOid, .relNumber = entry.relNumber, .forkNum = entry.forkNum
+            };
+
+            lstAdd(
+                this->forkList,
+                &(WalSummaryFork){
+                    .relation = relation,
+                    .segmentLimit = entry.limitBlock == WAL_SUMMARY_LIMIT_BLOCK_NONE ?
+                        UINT32_MAX : entry.limitBlock / this->segmentBlock});
+
+            // Add the segments containing the modified blocks in each chunk. A full chunk is a bitmap with one bit per block,
+            // otherwise the chunk is an array of block offsets.
+            if (entry.chunkTotal > 0)
+            {
+                bufResize(chunkSizeBuffer, entry.chunkTotal * sizeof(uint16_t));
+                walSummaryReadBuffer(read, chunkSizeBuffer, entry.chunkTotal * sizeof(uint16_t), &crc);
+
+                uint32_t segmentLast = UINT32_MAX;
+
+                for (uint32_t chunkIdx = 0; chunkIdx < entry.chunkTotal; chunkIdx++)
+                {
+                    uint16_t chunkSize;
+                    memcpy(&chunkSize, bufPtrConst(chunkSizeBuffer) + chunkIdx * sizeof(uint16_t), sizeof(chunkSize));
+
+                    if (chunkSize > WAL_SUMMARY_CHUNK_ENTRY_MAX)
+                        THROW_FMT(FormatError, "WAL summary chunk size %u is invalid", chunkSize);
+
+                    walSummaryReadBuffer(read, buffer, chunkSize * sizeof(uint16_t), &crc);
+
+                    const uint32_t chunkBlock = chunkIdx * WAL_SUMMARY_CHUNK_BLOCK;
+                    const uint16_t *const chunk = (const uint16_t *)bufPtrConst(buffer);
+
+                    for (uint16_t chunkEntryIdx = 0; chunkEntryIdx < chunkSize; chunkEntryIdx++)
+                    {
+                        uint32_t block;
+
+                        // A bitmap word covers 16 blocks, which will never span segments, so only check that some bit is set
+                        if (chunkSize == WAL_SUMMARY_CHUNK_ENTRY_MAX)
+                        {
+                            if (chunk[chunkEntryIdx] == 0)
+                                continue;
+
+                            block = chunkBlock + chunkEntryIdx * 16;
+                        }
+                        else
+                            block = chunkBlock + chunk[chunkEntryIdx];
+
+                        // Offsets are usually ordered so skip the segment when it was just added. Duplicates are removed later.
+                        const uint32_t segment = block / this->segmentBlock;
+
+                        if (segment != segmentLast)
+                        {
+                            lstAdd(this->segmentList, &(WalSummarySegment){.relation = relation, .segment = segment});
+                            segmentLast = segment;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Check crc
+        uint32_t crcFile;
+
+        walSummaryReadBuffer(read, buffer, sizeof(crcFile), NULL);
+        memcpy(&crcFile, bufPtrConst(buffer), sizeof(crcFile));
+
+        if (crcFile != (crc ^ CRC32C_INIT))
+            THROW_FMT(FormatError, "WAL summary crc 0x%08x does not match expected 0x%08x", crcFile, crc ^ CRC32C_INIT);
+
+        ioReadClose(read);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    // Sort so relations and segments can be found and remove duplicates added by summaries that overlap. The lowest segment limit
+    // is kept for each relation fork.
+    lstSort(this->forkList, sortOrderAsc);
+    lstSort(this->segmentList, sortOrderAsc);
+
+    unsigned int keepIdx = 0;
+
+    for (unsigned int forkIdx = 1; forkIdx < lstSize(this->forkList); forkIdx++)
+    {
+        WalSummaryFork *const forkKeep = lstGet(this->forkList, keepIdx);
+        const WalSummaryFork *const fork = lstGet(this->forkList, forkIdx);
+
+        if (lstComparatorWalSummaryRelation(forkKeep, fork) == 0)
+        {
+            if (fork->segmentLimit < forkKeep->segmentLimit)
+                forkKeep->segmentLimit = fork->segmentLimit;
+        }
+        else
+        {
+            keepIdx++;
+            *(WalSummaryFork *)lstGet(this->forkList, keepIdx) = *fork;
+        }
+    }
+
+    while (lstSize(this->forkList) > keepIdx + 1)
+        lstRemoveLast(this->forkList);
+
+    keepIdx = 0;
+
+    for (unsigned int segmentIdx = 1; segmentIdx < lstSize(this->segmentList); segmentIdx++)
+    {
+        const WalSummarySegment *const segment = lstGet(this->segmentList, segmentIdx);
+
+        if (lstComparatorWalSummarySegment(lstGet(this->segmentList, keepIdx), segment) != 0)
+        {
+            keepIdx++;
+            *(WalSummarySegment *)lstGet(this->segmentList, keepIdx) = *segment;
+        }
+    }
+
+    while (lstSize(this->segmentList) > keepIdx + 1)
+        lstRemoveLast(this->segmentList);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,70 @@
+/***********************************************************************************************************************************
+PostgreSQL WAL Summary
+
+The WAL summarizer (PostgreSQL >= 17) writes a summary file to pg_wal/summaries for each range of WAL that it processes. Each
+summary is a block reference table that records the relation forks (and blocks) modified in the range, along with a limit block
+when the relation fork was created or truncated. Summary files are named with the timeline and the start/end LSN of the range
+(end is exclusive) in hex, e.g. 0000000100000000010000280000000001000128.summary.
+
+A relation fork that does not appear in any summary covering a range of WAL was not modified by WAL replay in that range. For a
+relation fork that does appear, the modified blocks and the limit block are used to find the relation segments (files) that were
+modified. Tracking stops at the segment since a file that has been modified must be read in full to calculate the file checksum.
+The free space map is not fully WAL-logged so it is always reported as modified.
+***********************************************************************************************************************************/
+#ifndef POSTGRES_WALSUMMARY_H
+#define POSTGRES_WALSUMMARY_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct WalSummary WalSummary;
+
+#include "common/io/read.h"
+#include "common/type/object.h"
+#include "common/type/stringList.h"
+#include "postgres/interface.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define PG_PATH_WAL_SUMMARY                                         "summaries"
+#define WAL_SUMMARY_REGEXP                                          "^[0-9A-F]{40}\\.summary$"
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+// Create an empty summary. The page size is required to map blocks to relation segments.
+FN_EXTERN WalSummary *walSummaryNew(PgPageSize pageSize);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Select summary files on the timeline that cover the range from lsnBegin (inclusive) to lsnEnd (exclusive). Returns NULL if the
+// summary files do not cover the entire range.
+FN_EXTERN StringList *walSummaryFileList(const StringList *fileList, uint32_t timeline, uint64_t lsnBegin, uint64_t lsnEnd);
+
+// Has the relation segment file (path relative to the data directory) been modified? Files that are not relation files, or are
+// forks that are not fully WAL-logged, are always reported as modified.
+FN_EXTERN bool walSummaryModified(const WalSummary *this, const String *file);
+
+// Read a summary file and add the relation forks and segments it contains
+FN_EXTERN void walSummaryRead(WalSummary *this, IoRead *read);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+walSummaryFree(WalSummary *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_WAL_SUMMARY_TYPE                                                                                              \
+    WalSummary *
+#define FUNCTION_LOG_WAL_SUMMARY_FORMAT(value, buffer, bufferSize)                                                                 \
+    objNameToLog(value, "WalSummary", buffer, bufferSize)
+
+#endif
@@ -5,6 +5,7 @@ Azure Storage Read
 
 #include "common/debug.h"
 #include "common/io/http/client.h"
+#include "common/io/http/readAhead.h"
 #include "common/log.h"
 #include "common/type/object.h"
 #include "storage/azure/read.h"
@@ -22,8 +23,12 @@ typedef struct StorageReadAzure
 {
     StorageReadInterface interface;                                 // Interface
     StorageAzure *storage;                                          // Storage that created this object
+    size_t rangeSize;                                               // Range size for read-ahead
+    unsigned int rangeMax;                                          // Maximum concurrent ranges for read-ahead
 
     HttpResponse *httpResponse;                                     // HTTP response
+    HttpReadAhead *readAhead;                                       // Read-ahead when the file is read in ranges
+    const String *eTag;                                             // ETag read by the first request (pins ranges)
 } StorageReadAzure;
 
 /***********************************************************************************************************************************
@@ -34,6 +39,79 @@ Macros for function logging
 #define FUNCTION_LOG_STORAGE_READ_AZURE_FORMAT(value, buffer, bufferSize)                                                          \
     objNameToLog(value, "StorageReadAzure", buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Request a range of the file
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadAzureRequest(StorageReadAzure *const this, const uint64_t offset, const Variant *const limit)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_AZURE, this);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    HttpRequest *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), offset, limit);
+
+        if (this->eTag != NULL)
+            httpHeaderAdd(header, HTTP_HEADER_IF_MATCH_STR, this->eTag);
+
+        result = httpRequestMove(
+            storageAzureRequestAsyncP(
+                this->storage, HTTP_VERB_GET_STR, .path = this->interface.name,
+                .query =
+                    this->interface.version ?
+                        httpQueryPut(httpQueryNewP(), AZURE_QUERY_VERSION_ID_STR, this->interface.versionId) : NULL,
+                .header = header),
+            memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
+}
+
+/***********************************************************************************************************************************
+Read-ahead callbacks
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadAzureRangeRequest(void *const driver, const uint64_t offset, const uint64_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_READ_AZURE, driver);
+        FUNCTION_TEST_PARAM(UINT64, offset);
+        FUNCTION_TEST_PARAM(UINT64, size);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(HTTP_REQUEST, storageReadAzureRequest(driver, offset, VARUINT64(size)));
+}
+
+static HttpResponse *
+storageReadAzureRangeResponse(void *const driver, HttpRequest *const request)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_READ_AZURE, driver);
+        FUNCTION_TEST_PARAM(HTTP_REQUEST, request);
+    FUNCTION_TEST_END();
+
+    StorageReadAzure *const this = driver;
+    HttpResponse *const result = httpRequestResponse(request, false);
+
+    // Error when the object was replaced after the first request since the ranges would not be from the same object
+    if (httpResponseCode(result) == HTTP_RESPONSE_CODE_PRECONDITION_FAILED)
+        THROW_FMT(FileReadError, STORAGE_ERROR_READ_CHANGED, strZ(this->interface.name));
+
+    if (!httpResponseCodeOk(result))
+        httpRequestError(request, result);
+
+    FUNCTION_TEST_RETURN(HTTP_RESPONSE, result);
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -54,21 +132,46 @@ storageReadAzureOpen(THIS_VOID)
     // Read if not versioned or if versionId is not null
     if (!this->interface.version || this->interface.versionId != NULL)
     {
+        // When the size is known and read-ahead will be used only request the first range
+        const Variant *limit = this->interface.limit;
+
+        if (this->rangeMax > 1 && limit != NULL && varUInt64(limit) > this->rangeSize)
+            limit = VARUINT64(this->rangeSize);
+
         // Request the file
+        HttpRequest *const request = storageReadAzureRequest(this, this->interface.offset, limit);
+
         MEM_CONTEXT_OBJ_BEGIN(this)
         {
-            this->httpResponse = storageAzureRequestP(
-                this->storage, HTTP_VERB_GET_STR, .path = this->interface.name,
-                .query =
-                    this->interface.version ?
-                        httpQueryPut(httpQueryNewP(), AZURE_QUERY_VERSION_ID_STR, this->interface.versionId) : NULL,
-                .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
-                .allowMissing = true, .contentIo = true);
+            this->httpResponse = storageAzureResponseP(request, .allowMissing = true, .contentIo = true);
         }
         MEM_CONTEXT_OBJ_END();
 
+        httpRequestFree(request);
+
         if (httpResponseCodeOk(this->httpResponse))
         {
+            // Read the rest of the file in ranges when it is larger than a single range. The size of the content is used when the
+            // limit is not known.
+            const uint64_t size =
+                this->interface.limit != NULL ? varUInt64(this->interface.limit) : httpResponseContentSize(this->httpResponse);
+
+            if (this->rangeMax > 1 && size > this->rangeSize)
+            {
+                MEM_CONTEXT_OBJ_BEGIN(this)
+                {
+                    // Pin range requests to the version of the object read by the first request
+                    this->eTag = strDup(httpHeaderGet(httpResponseHeader(this->httpResponse), HTTP_HEADER_ETAG_STR));
+
+                    this->readAhead = httpReadAheadNewP(
+                        this->httpResponse, this->interface.offset, size, this->rangeSize, this->rangeMax, .driver = this,
+                        .request = storageReadAzureRangeRequest, .response = storageReadAzureRangeResponse);
+                }
+                MEM_CONTEXT_OBJ_END();
+
+                this->httpResponse = NULL;
+            }
+
             result = true;
         }
         // Else error unless ignore missing
@@ -93,11 +196,12 @@ storageReadAzure(THIS_VOID, Buffer *const buffer, const bool block)
         FUNCTION_LOG_PARAM(BOOL, block);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && (this->httpResponse != NULL || this->readAhead != NULL));
     ASSERT(buffer != NULL && !bufFull(buffer));
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(
+        SIZE,
+        this->readAhead != NULL ? httpReadAhead(this->readAhead, buffer) : ioRead(httpResponseIoRead(this->httpResponse), buffer));
 }
 
 /***********************************************************************************************************************************
@@ -112,17 +216,18 @@ storageReadAzureEof(THIS_VOID)
         FUNCTION_TEST_PARAM(STORAGE_READ_AZURE, this);
     FUNCTION_TEST_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && (this->httpResponse != NULL || this->readAhead != NULL));
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
+    FUNCTION_TEST_RETURN(
+        BOOL, this->readAhead != NULL ? httpReadAheadEof(this->readAhead) : ioReadEof(httpResponseIoRead(this->httpResponse)));
 }
 
 /**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadAzureNew(
     StorageAzure *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset,
-    const Variant *const limit, const bool version, const String *const versionId)
+    const Variant *const limit, const bool version, const String *const versionId, const size_t rangeSize,
+    const unsigned int rangeMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_AZURE, storage);
@@ -132,16 +237,22 @@ storageReadAzureNew(
         FUNCTION_LOG_PARAM(VARIANT, limit);
         FUNCTION_LOG_PARAM(BOOL, version);
         FUNCTION_LOG_PARAM(STRING, versionId);
+        FUNCTION_LOG_PARAM(SIZE, rangeSize);
+        FUNCTION_LOG_PARAM(UINT, rangeMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
+    ASSERT(rangeSize > 0);
+    ASSERT(rangeMax > 0);
 
     OBJ_NEW_BEGIN(StorageReadAzure, .childQty = MEM_CONTEXT_QTY_MAX)
     {
         *this = (StorageReadAzure)
         {
             .storage = storage,
+            .rangeSize = rangeSize,
+            .rangeMax = rangeMax,
 
             .interface = (StorageReadInterface)
             {
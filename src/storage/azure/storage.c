@@ -70,6 +70,9 @@ struct StorageAzure
     const HttpQuery *sasKey;                                        // SAS key
     const String *host;                                             // Host name
     size_t blockSize;                                               // Block size for multi-block upload
+    unsigned int blockMax;                                          // Maximum concurrent block uploads per file
+    size_t rangeSize;                                               // Range size for read-ahead
+    unsigned int rangeMax;                                          // Maximum concurrent ranges per file for read-ahead
     const String *tag;                                              // Tags to be applied to objects
     const String *pathPrefix;                                       // Account/container prefix
 
@@ -148,6 +151,7 @@ storageAzureAuth(
             const String *const contentLength = httpHeaderGet(httpHeader, HTTP_HEADER_CONTENT_LENGTH_STR);
             const String *const contentMd5 = httpHeaderGet(httpHeader, HTTP_HEADER_CONTENT_MD5_STR);
             const String *const range = httpHeaderGet(httpHeader, HTTP_HEADER_RANGE_STR);
+            const String *const ifMatch = httpHeaderGet(httpHeader, HTTP_HEADER_IF_MATCH_STR);
 
             const String *const stringToSign = strNewFmt(
                 "%s\n"                                                  // verb
@@ -158,7 +162,7 @@ storageAzureAuth(
                 "\n"                                                    // content-type
                 "%s\n"                                                  // date
                 "\n"                                                    // If-Modified-Since
-                "\n"                                                    // If-Match
+                "%s\n"                                                  // If-Match
                 "\n"                                                    // If-None-Match
                 "\n"                                                    // If-Unmodified-Since
                 "%s\n"                                                  // range
@@ -166,8 +170,8 @@ storageAzureAuth(
                 "/%s%s"                                                 // Canonicalized account/path
                 "%s",                                                   // Canonicalized query
                 strZ(verb), strEq(contentLength, ZERO_STR) ? "" : strZ(contentLength), contentMd5 == NULL ? "" : strZ(contentMd5),
-                strZ(dateTime), range == NULL ? "" : strZ(range), strZ(headerCanonical), strZ(this->account), strZ(path),
-                strZ(queryCanonical));
+                strZ(dateTime), ifMatch == NULL ? "" : strZ(ifMatch), range == NULL ? "" : strZ(range), strZ(headerCanonical),
+                strZ(this->account), strZ(path), strZ(queryCanonical));
 
             // Generate authorization header
             httpHeaderPut(
@@ -623,7 +627,9 @@ storageAzureNewRead(THIS_VOID, const String *const file, const bool ignoreMissin
     ASSERT(file != NULL);
 
     FUNCTION_LOG_RETURN(
-        STORAGE_READ, storageReadAzureNew(this, file, ignoreMissing, param.offset, param.limit, param.version, param.versionId));
+        STORAGE_READ,
+        storageReadAzureNew(
+            this, file, ignoreMissing, param.offset, param.limit, param.version, param.versionId, this->rangeSize, this->rangeMax));
 }
 
 /**********************************************************************************************************************************/
@@ -646,7 +652,7 @@ storageAzureNewWrite(THIS_VOID, const String *const file, const StorageInterface
     ASSERT(param.group == NULL);
     ASSERT(param.timeModified == 0);
 
-    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteAzureNew(this, file, this->fileId++, this->blockSize));
+    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteAzureNew(this, file, this->fileId++, this->blockSize, this->blockMax));
 }
 
 /**********************************************************************************************************************************/
@@ -766,8 +772,9 @@ FN_EXTERN Storage *
 storageAzureNew(
     const String *const path, const bool write, const time_t targetTime, StoragePathExpressionCallback pathExpressionFunction,
     const String *const container, const String *const account, const StorageAzureKeyType keyType, const String *const key,
-    const size_t blockSize, const KeyValue *const tag, const String *const endpoint, const StorageAzureUriStyle uriStyle,
-    const unsigned int port, const TimeMSec timeout, const bool verifyPeer, const String *const caFile, const String *const caPath)
+    const size_t blockSize, const unsigned int blockMax, const size_t rangeSize, const unsigned int rangeMax,
+    const KeyValue *const tag, const String *const endpoint, const StorageAzureUriStyle uriStyle, const unsigned int port,
+    const TimeMSec timeout, const bool verifyPeer, const String *const caFile, const String *const caPath)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -779,6 +786,9 @@ storageAzureNew(
         FUNCTION_LOG_PARAM(STRING_ID, keyType);
         FUNCTION_TEST_PARAM(STRING, key);
         FUNCTION_LOG_PARAM(SIZE, blockSize);
+        FUNCTION_LOG_PARAM(UINT, blockMax);
+        FUNCTION_LOG_PARAM(SIZE, rangeSize);
+        FUNCTION_LOG_PARAM(UINT, rangeMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, endpoint);
         FUNCTION_LOG_PARAM(ENUM, uriStyle);
@@ -795,6 +805,9 @@ storageAzureNew(
     ASSERT(endpoint != NULL);
     ASSERT(key != NULL);
     ASSERT(blockSize != 0);
+    ASSERT(blockMax != 0);
+    ASSERT(rangeSize != 0);
+    ASSERT(rangeMax != 0);
 
     OBJ_NEW_BEGIN(StorageAzure, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -804,6 +817,9 @@ storageAzureNew(
             .container = strDup(container),
             .account = strDup(account),
             .blockSize = blockSize,
+            .blockMax = blockMax,
+            .rangeSize = rangeSize,
+            .rangeMax = rangeMax,
             .host = uriStyle == storageAzureUriStyleHost ? strNewFmt("%s.%s", strZ(account), strZ(endpoint)) : strDup(endpoint),
             .pathPrefix =
                 uriStyle == storageAzureUriStyleHost ?
@@ -824,12 +840,15 @@ storageAzureNew(
         else
             this->sasKey = httpQueryNewStr(key);
 
-        // Create the http client used to service requests
-        this->httpClient = httpClientNew(
+        // Get the shared http client used to service requests. Keep enough sessions for concurrent uploads and downloads.
+        this->httpClient = httpClientSharedP(
+            strNewFmt(
+                "%s:%u:%s:%s:%s:%" PRIu64, strZ(this->host), port, cvtBoolToConstZ(verifyPeer), strZNull(caFile), strZNull(caPath),
+                timeout),
             tlsClientNewP(
                 sckClientNew(this->host, port, timeout, timeout), this->host, timeout, timeout, verifyPeer, .caFile = caFile,
                 .caPath = caPath),
-            timeout);
+            timeout, .sessionMax = blockMax + rangeMax);
 
         // Create list of redacted headers
         this->headerRedactList = strLstNew();
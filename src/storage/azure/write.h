@@ -10,6 +10,7 @@ Azure Storage File Write
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-FN_EXTERN StorageWrite *storageWriteAzureNew(StorageAzure *storage, const String *name, uint64_t fileId, size_t blockSize);
+FN_EXTERN StorageWrite *storageWriteAzureNew(
+    StorageAzure *storage, const String *name, uint64_t fileId, size_t blockSize, unsigned int blockMax);
 
 #endif
@@ -5,6 +5,7 @@ GCS Storage Read
 
 #include "common/debug.h"
 #include "common/io/http/client.h"
+#include "common/io/http/readAhead.h"
 #include "common/io/read.h"
 #include "common/log.h"
 #include "common/type/object.h"
@@ -15,6 +16,12 @@ GCS Storage Read
 GCS query tokens
 ***********************************************************************************************************************************/
 STRING_STATIC(GCS_QUERY_ALT_STR,                                    "alt");
+STRING_STATIC(GCS_QUERY_IF_GENERATION_MATCH_STR,                    "ifGenerationMatch");
+
+/***********************************************************************************************************************************
+GCS headers
+***********************************************************************************************************************************/
+STRING_STATIC(GCS_HEADER_GENERATION_STR,                            "x-goog-generation");
 
 /***********************************************************************************************************************************
 Object type
@@ -23,8 +30,12 @@ typedef struct StorageReadGcs
 {
     StorageReadInterface interface;                                 // Interface
     StorageGcs *storage;                                            // Storage that created this object
+    size_t rangeSize;                                               // Range size for read-ahead
+    unsigned int rangeMax;                                          // Maximum concurrent ranges for read-ahead
 
     HttpResponse *httpResponse;                                     // HTTP response
+    HttpReadAhead *readAhead;                                       // Read-ahead when the file is read in ranges
+    const String *generation;                                       // Generation read by the first request (pins ranges)
 } StorageReadGcs;
 
 /***********************************************************************************************************************************
@@ -35,6 +46,79 @@ Macros for function logging
 #define FUNCTION_LOG_STORAGE_READ_GCS_FORMAT(value, buffer, bufferSize)                                                            \
     objNameToLog(value, "StorageReadGcs", buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Request a range of the file
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadGcsRequest(StorageReadGcs *const this, const uint64_t offset, const Variant *const limit)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_GCS, this);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    HttpRequest *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        HttpQuery *const query = httpQueryAdd(httpQueryNewP(), GCS_QUERY_ALT_STR, GCS_QUERY_MEDIA_STR);
+
+        if (this->interface.versionId)
+            httpQueryAdd(query, varStr(GCS_JSON_GENERATION_VAR), this->interface.versionId);
+
+        if (this->generation != NULL)
+            httpQueryAdd(query, GCS_QUERY_IF_GENERATION_MATCH_STR, this->generation);
+
+        result = httpRequestMove(
+            storageGcsRequestAsyncP(
+                this->storage, HTTP_VERB_GET_STR, .object = this->interface.name,
+                .header = httpHeaderPutRange(httpHeaderNew(NULL), offset, limit), .query = query),
+            memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
+}
+
+/***********************************************************************************************************************************
+Read-ahead callbacks
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadGcsRangeRequest(void *const driver, const uint64_t offset, const uint64_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_READ_GCS, driver);
+        FUNCTION_TEST_PARAM(UINT64, offset);
+        FUNCTION_TEST_PARAM(UINT64, size);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(HTTP_REQUEST, storageReadGcsRequest(driver, offset, VARUINT64(size)));
+}
+
+static HttpResponse *
+storageReadGcsRangeResponse(void *const driver, HttpRequest *const request)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_READ_GCS, driver);
+        FUNCTION_TEST_PARAM(HTTP_REQUEST, request);
+    FUNCTION_TEST_END();
+
+    StorageReadGcs *const this = driver;
+    HttpResponse *const result = httpRequestResponse(request, false);
+
+    // Error when the object was replaced after the first request since the ranges would not be from the same object
+    if (httpResponseCode(result) == HTTP_RESPONSE_CODE_PRECONDITION_FAILED)
+        THROW_FMT(FileReadError, STORAGE_ERROR_READ_CHANGED, strZ(this->interface.name));
+
+    if (!httpResponseCodeOk(result))
+        httpRequestError(request, result);
+
+    FUNCTION_TEST_RETURN(HTTP_RESPONSE, result);
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -55,23 +139,46 @@ storageReadGcsOpen(THIS_VOID)
     // Read if not versioned or if versionId is not null
     if (!this->interface.version || this->interface.versionId != NULL)
     {
+        // When the size is known and read-ahead will be used only request the first range
+        const Variant *limit = this->interface.limit;
+
+        if (this->rangeMax > 1 && limit != NULL && varUInt64(limit) > this->rangeSize)
+            limit = VARUINT64(this->rangeSize);
+
         // Request the file
+        HttpRequest *const request = storageReadGcsRequest(this, this->interface.offset, limit);
+
         MEM_CONTEXT_OBJ_BEGIN(this)
         {
-            HttpQuery *const query = httpQueryAdd(httpQueryNewP(), GCS_QUERY_ALT_STR, GCS_QUERY_MEDIA_STR);
-
-            if (this->interface.versionId)
-                httpQueryAdd(query, varStr(GCS_JSON_GENERATION_VAR), this->interface.versionId);
-
-            this->httpResponse = storageGcsRequestP(
-                this->storage, HTTP_VERB_GET_STR, .object = this->interface.name,
-                .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
-                .allowMissing = true, .contentIo = true, .query = query);
+            this->httpResponse = storageGcsResponseP(request, .allowMissing = true, .contentIo = true);
         }
         MEM_CONTEXT_OBJ_END();
 
+        httpRequestFree(request);
+
         if (httpResponseCodeOk(this->httpResponse))
         {
+            // Read the rest of the file in ranges when it is larger than a single range. The size of the content is used when the
+            // limit is not known.
+            const uint64_t size =
+                this->interface.limit != NULL ? varUInt64(this->interface.limit) : httpResponseContentSize(this->httpResponse);
+
+            if (this->rangeMax > 1 && size > this->rangeSize)
+            {
+                MEM_CONTEXT_OBJ_BEGIN(this)
+                {
+                    // Pin range requests to the generation of the object read by the first request
+                    this->generation = strDup(httpHeaderGet(httpResponseHeader(this->httpResponse), GCS_HEADER_GENERATION_STR));
+
+                    this->readAhead = httpReadAheadNewP(
+                        this->httpResponse, this->interface.offset, size, this->rangeSize, this->rangeMax, .driver = this,
+                        .request = storageReadGcsRangeRequest, .response = storageReadGcsRangeResponse);
+                }
+                MEM_CONTEXT_OBJ_END();
+
+                this->httpResponse = NULL;
+            }
+
             result = true;
         }
         // Else error unless ignore missing
@@ -96,11 +203,12 @@ storageReadGcs(THIS_VOID, Buffer *const buffer, const bool block)
         FUNCTION_LOG_PARAM(BOOL, block);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && (this->httpResponse != NULL || this->readAhead != NULL));
     ASSERT(buffer != NULL && !bufFull(buffer));
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(
+        SIZE,
+        this->readAhead != NULL ? httpReadAhead(this->readAhead, buffer) : ioRead(httpResponseIoRead(this->httpResponse), buffer));
 }
 
 /***********************************************************************************************************************************
@@ -115,17 +223,18 @@ storageReadGcsEof(THIS_VOID)
         FUNCTION_TEST_PARAM(STORAGE_READ_GCS, this);
     FUNCTION_TEST_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && (this->httpResponse != NULL || this->readAhead != NULL));
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
+    FUNCTION_TEST_RETURN(
+        BOOL, this->readAhead != NULL ? httpReadAheadEof(this->readAhead) : ioReadEof(httpResponseIoRead(this->httpResponse)));
 }
 
 /**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadGcsNew(
     StorageGcs *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset,
-    const Variant *const limit, const bool version, const String *const versionId)
+    const Variant *const limit, const bool version, const String *const versionId, const size_t rangeSize,
+    const unsigned int rangeMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_GCS, storage);
@@ -135,16 +244,22 @@ storageReadGcsNew(
         FUNCTION_LOG_PARAM(VARIANT, limit);
         FUNCTION_LOG_PARAM(BOOL, version);
         FUNCTION_LOG_PARAM(STRING, versionId);
+        FUNCTION_LOG_PARAM(SIZE, rangeSize);
+        FUNCTION_LOG_PARAM(UINT, rangeMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
+    ASSERT(rangeSize > 0);
+    ASSERT(rangeMax > 0);
 
     OBJ_NEW_BEGIN(StorageReadGcs, .childQty = MEM_CONTEXT_QTY_MAX)
     {
         *this = (StorageReadGcs)
         {
             .storage = storage,
+            .rangeSize = rangeSize,
+            .rangeMax = rangeMax,
 
             .interface = (StorageReadInterface)
             {
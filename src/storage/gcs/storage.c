@@ -97,6 +97,8 @@ struct StorageGcs
     const String *bucket;                                           // Bucket to store data in
     const String *endpoint;                                         // Endpoint
     size_t chunkSize;                                               // Block size for resumable upload
+    size_t rangeSize;                                               // Range size for read-ahead
+    unsigned int rangeMax;                                          // Maximum concurrent ranges per file for read-ahead
     unsigned int deleteMax;                                         // Maximum objects that can be deleted in one request
     const Buffer *tag;                                              // Tags to be applied to objects
     const String *userProject;                                      // Project ID
@@ -941,7 +943,9 @@ storageGcsNewRead(THIS_VOID, const String *const file, const bool ignoreMissing,
     ASSERT(file != NULL);
 
     FUNCTION_LOG_RETURN(
-        STORAGE_READ, storageReadGcsNew(this, file, ignoreMissing, param.offset, param.limit, param.version, param.versionId));
+        STORAGE_READ,
+        storageReadGcsNew(
+            this, file, ignoreMissing, param.offset, param.limit, param.version, param.versionId, this->rangeSize, this->rangeMax));
 }
 
 /**********************************************************************************************************************************/
@@ -1187,8 +1191,9 @@ FN_EXTERN Storage *
 storageGcsNew(
     const String *const path, const bool write, const time_t targetTime, StoragePathExpressionCallback pathExpressionFunction,
     const String *const bucket, const StorageGcsKeyType keyType, const String *const key, const size_t chunkSize,
-    const KeyValue *const tag, const String *const endpoint, const TimeMSec timeout, const bool verifyPeer,
-    const String *const caFile, const String *const caPath, const String *const userProject)
+    const size_t rangeSize, const unsigned int rangeMax, const KeyValue *const tag, const String *const endpoint,
+    const TimeMSec timeout, const bool verifyPeer, const String *const caFile, const String *const caPath,
+    const String *const userProject)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -1199,6 +1204,8 @@ storageGcsNew(
         FUNCTION_LOG_PARAM(STRING_ID, keyType);
         FUNCTION_TEST_PARAM(STRING, key);
         FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(SIZE, rangeSize);
+        FUNCTION_LOG_PARAM(UINT, rangeMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, endpoint);
         FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
@@ -1212,6 +1219,8 @@ storageGcsNew(
     ASSERT(bucket != NULL);
     ASSERT(keyType == storageGcsKeyTypeAuto || key != NULL);
     ASSERT(chunkSize != 0);
+    ASSERT(rangeSize != 0);
+    ASSERT(rangeMax != 0);
 
     OBJ_NEW_BEGIN(StorageGcs, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -1222,6 +1231,8 @@ storageGcsNew(
             .bucket = strDup(bucket),
             .keyType = keyType,
             .chunkSize = chunkSize,
+            .rangeSize = rangeSize,
+            .rangeMax = rangeMax,
             .deleteMax = STORAGE_GCS_DELETE_MAX,
             .userProject = strDup(userProject),
         };
@@ -1296,12 +1307,15 @@ storageGcsNew(
         const HttpUrl *const url = httpUrlNewParseP(endpoint, .type = httpProtocolTypeHttps);
         this->endpoint = httpUrlHost(url);
 
-        // Create the http client used to service requests
-        this->httpClient = httpClientNew(
+        // Get the shared http client used to service requests. Keep enough sessions for concurrent uploads and downloads.
+        this->httpClient = httpClientSharedP(
+            strNewFmt(
+                "%s:%u:%s:%s:%s:%" PRIu64, strZ(this->endpoint), httpUrlPort(url), cvtBoolToConstZ(verifyPeer), strZNull(caFile),
+                strZNull(caPath), timeout),
             tlsClientNewP(
                 sckClientNew(this->endpoint, httpUrlPort(url), timeout, timeout), this->endpoint, timeout, timeout, verifyPeer,
                 .caFile = caFile, .caPath = caPath),
-            timeout);
+            timeout, .sessionMax = rangeMax + 1);
 
         // Create list of redacted headers
         this->headerRedactList = strLstNew();
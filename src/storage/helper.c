@@ -6,6 +6,7 @@ Storage Helper
 #include <string.h>
 
 #include "common/debug.h"
+#include "common/io/http/client.h"
 #include "common/io/io.h"
 #include "common/memContext.h"
 #include "common/regExp.h"
@@ -198,7 +199,13 @@ storagePgGet(const unsigned int pgIdx, const bool write)
     }
     // Use Posix storage
     else
-        result = storagePosixNewP(cfgOptionIdxStr(cfgOptPgPath, pgIdx), .write = write);
+    {
+        result = storagePosixNewP(
+            cfgOptionIdxStr(cfgOptPgPath, pgIdx), .write = write,
+            .pageCacheDrop = cfgOptionValid(cfgOptPageCacheDrop) && cfgOptionBool(cfgOptPageCacheDrop),
+            .readAhead = cfgOptionValid(cfgOptReadAhead) ? cfgOptionUInt(cfgOptReadAhead) : 0,
+            .writeQueue = cfgOptionValid(cfgOptWriteQueue) ? cfgOptionUInt(cfgOptWriteQueue) : 0);
+    }
 
     FUNCTION_TEST_RETURN(STORAGE, result);
 }
@@ -391,7 +398,8 @@ storageRepoGet(const unsigned int repoIdx, const bool write)
             CHECK(AssertError, type == STORAGE_POSIX_TYPE, "invalid storage type");
 
             result = storagePosixNewP(
-                cfgOptionIdxStr(cfgOptRepoPath, repoIdx), .write = write, .pathExpressionFunction = storageRepoPathExpression);
+                cfgOptionIdxStr(cfgOptRepoPath, repoIdx), .write = write, .pathExpressionFunction = storageRepoPathExpression,
+                .readAhead = cfgOptionValid(cfgOptReadAhead) ? cfgOptionUInt(cfgOptReadAhead) : 0);
         }
     }
 
@@ -589,6 +597,9 @@ storageHelperFree(void)
     if (storageHelper.memContext != NULL)
         memContextFree(storageHelper.memContext);
 
+    // Close idle connections held by shared HTTP clients since the repositories may be different after the config is reloaded
+    httpClientSharedClose();
+
     storageHelper = (struct StorageHelperLocal){.memContext = NULL, .helperList = storageHelper.helperList};
 
     FUNCTION_TEST_RETURN_VOID();
@@ -4,6 +4,8 @@ Posix Storage Read
 #include "build.auto.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "common/debug.h"
@@ -24,6 +26,16 @@ typedef struct StorageReadPosix
     int fd;                                                         // File descriptor
     uint64_t current;                                               // Current bytes read from file
     uint64_t limit;                                                 // Limit bytes to be read from file (UINT64_MAX for no limit)
+    bool pageCacheDrop;                                             // Drop pages from the page cache after they are read
+    unsigned char *residentList;                                    // Pages resident in the page cache (two windows)
+    uint64_t residentBegin;                                         // File offset of the first page in the resident list
+    uint64_t residentEnd;                                           // File offset where residency checking ends
+    size_t residentWindow;                                          // Pages in each residency window
+    size_t residentTotal;                                           // Pages in the resident list
+    size_t residentDrop;                                            // Next page in the resident list to consider for drop
+    size_t pageSize;                                                // Page size used by the page cache
+    unsigned int readAhead;                                         // Buffers to read ahead
+    uint64_t readAheadCurrent;                                      // Bytes the kernel has been advised to read ahead
     bool eof;
 } StorageReadPosix;
 
@@ -55,6 +67,169 @@ storageReadPosixFreeResource(THIS_VOID)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Page cache residency. Only pages that were not resident in the page cache before they were read are dropped after they are read, so
+pages PostgreSQL is actively using stay in the cache. Residency is checked a window at a time and the window after the one being
+read is always checked before reading into it, so pages brought into the cache by read-ahead are not mistaken for resident pages.
+The window is large compared to the kernel read-ahead but small enough that the address space and list needed are bounded no matter
+how much is read.
+***********************************************************************************************************************************/
+#if defined(POSIX_FADV_DONTNEED) && defined(HAVE_MINCORE)
+
+#define STORAGE_POSIX_RESIDENT_WINDOW                               (16 * 1024 * 1024)
+
+// Check residency for the window starting at the specified page in the resident list
+static void
+storageReadPosixResidentWindow(StorageReadPosix *const this, const size_t pageIdx)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+        FUNCTION_LOG_PARAM(SIZE, pageIdx);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->fd != -1);
+    ASSERT(pageIdx == this->residentTotal);
+
+    // Residency can only be checked for the part of the range that existed in the file when it was opened
+    const uint64_t windowBegin = this->residentBegin + pageIdx * this->pageSize;
+
+    if (windowBegin < this->residentEnd)
+    {
+        size_t windowSize = this->residentWindow * this->pageSize;
+
+        if (windowBegin + windowSize > this->residentEnd)
+            windowSize = (size_t)(this->residentEnd - windowBegin);
+
+        void *const map = mmap(NULL, windowSize, PROT_READ, MAP_SHARED, this->fd, (off_t)windowBegin);
+
+        if (map != MAP_FAILED)                                      // {uncoverable_branch - mmap() does not fail for regular files}
+        {
+            // The vector is unsigned char * on Linux but char * on BSD so pass it as void *
+            void *const residentVector = this->residentList + pageIdx;
+
+            if (mincore(map, windowSize, residentVector) == 0)     // {uncoverable_branch - mincore() does not fail}
+                this->residentTotal = pageIdx + (windowSize + this->pageSize - 1) / this->pageSize;
+
+            munmap(map, windowSize);
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Check residency for the first two windows of the range to be read
+static void
+storageReadPosixResident(StorageReadPosix *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->fd != -1);
+
+    // If the file cannot be checked then residency is unknown and no pages will be dropped
+    struct stat statFile;
+
+    if (fstat(this->fd, &statFile) == 0)                            // {uncoverable_branch - fstat() does not fail on an open file}
+    {
+        // Residency can only be checked for the part of the range that exists in the file
+        this->residentEnd = (uint64_t)statFile.st_size;
+
+        if (this->limit != UINT64_MAX && this->interface.offset + this->limit < this->residentEnd)
+            this->residentEnd = this->interface.offset + this->limit;
+
+        if (this->residentEnd > this->interface.offset)
+        {
+            this->pageSize = (size_t)sysconf(_SC_PAGESIZE);
+            this->residentBegin = this->interface.offset / this->pageSize * this->pageSize;
+
+            if (this->residentWindow == 0)
+                this->residentWindow = STORAGE_POSIX_RESIDENT_WINDOW / this->pageSize;
+
+            MEM_CONTEXT_BEGIN(objMemContext(this))
+            {
+                this->residentList = memNew(this->residentWindow * 2);
+            }
+            MEM_CONTEXT_END();
+
+            storageReadPosixResidentWindow(this, 0);
+
+            if (this->residentTotal == this->residentWindow)
+                storageReadPosixResidentWindow(this, this->residentWindow);
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Drop pages that have been read and were not resident before they were read
+static void
+storageReadPosixDrop(StorageReadPosix *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->fd != -1);
+
+    const uint64_t readEnd = this->interface.offset + this->current;
+
+    while (true)
+    {
+        // Only drop pages that have been read completely unless the end of the read has been reached
+        size_t dropEnd = (size_t)((readEnd - this->residentBegin) / this->pageSize);
+
+        if (this->eof && (readEnd - this->residentBegin) % this->pageSize != 0)
+            dropEnd++;
+
+        if (dropEnd > this->residentTotal)
+            dropEnd = this->residentTotal;
+
+        // Drop each run of pages that were not resident. This is only advice so errors are ignored.
+        size_t pageIdx = this->residentDrop;
+
+        while (pageIdx < dropEnd)
+        {
+            // Skip pages that were resident
+            if (this->residentList[pageIdx] & 1)
+                pageIdx++;
+            // Else find the end of the run and drop it
+            else
+            {
+                const size_t dropBegin = pageIdx;
+
+                while (pageIdx < dropEnd && !(this->residentList[pageIdx] & 1))
+                    pageIdx++;
+
+                posix_fadvise(
+                    this->fd, (off_t)(this->residentBegin + dropBegin * this->pageSize),
+                    (off_t)((pageIdx - dropBegin) * this->pageSize), POSIX_FADV_DONTNEED);
+            }
+        }
+
+        this->residentDrop = dropEnd;
+
+        // Stop when the read is still in the first window or there is nothing left to check after the second window
+        if (this->residentDrop < this->residentWindow || this->residentTotal < this->residentWindow * 2)
+            break;
+
+        // Else the second window becomes the first and the window after it is checked before it is read
+        memcpy(this->residentList, this->residentList + this->residentWindow, this->residentWindow);
+        this->residentBegin += this->residentWindow * this->pageSize;
+        this->residentDrop -= this->residentWindow;
+        this->residentTotal = this->residentWindow;
+
+        storageReadPosixResidentWindow(this, this->residentWindow);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // POSIX_FADV_DONTNEED && HAVE_MINCORE
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -97,6 +272,19 @@ storageReadPosixOpen(THIS_VOID)
                 lseek(this->fd, (off_t)this->interface.offset, SEEK_SET) == -1, FileOpenError, STORAGE_ERROR_READ_SEEK,
                 this->interface.offset, strZ(this->interface.name));
         }
+
+        // Advise the kernel that the file will be read sequentially so read-ahead can be more aggressive. This is only advice so
+        // errors are ignored.
+#ifdef POSIX_FADV_SEQUENTIAL
+        if (this->pageCacheDrop)
+            posix_fadvise(this->fd, (off_t)this->interface.offset, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        // Check which pages are resident before anything is read
+#if defined(POSIX_FADV_DONTNEED) && defined(HAVE_MINCORE)
+        if (this->pageCacheDrop)
+            storageReadPosixResident(this);
+#endif
     }
 
     FUNCTION_LOG_RETURN(BOOL, this->fd != -1);
@@ -130,6 +318,31 @@ storageReadPosix(THIS_VOID, Buffer *const buffer, const bool block)
         if (this->current + expectedBytes > this->limit)
             expectedBytes = (size_t)(this->limit - this->current);
 
+        // Advise the kernel to start reading the buffers after this one so several reads are in flight while the current buffer is
+        // being processed. Only buffers that have not already been advised are included so usually this is a single buffer per
+        // read. This is only advice so errors are ignored.
+#ifdef POSIX_FADV_WILLNEED
+        if (this->readAhead > 0)
+        {
+            uint64_t readAheadBegin = this->current + bufRemains(buffer);
+            uint64_t readAheadEnd = this->current + bufRemains(buffer) * (this->readAhead + 1);
+
+            if (readAheadBegin < this->readAheadCurrent)
+                readAheadBegin = this->readAheadCurrent;
+
+            if (readAheadEnd > this->limit)
+                readAheadEnd = this->limit;
+
+            if (readAheadEnd > readAheadBegin)
+            {
+                posix_fadvise(
+                    this->fd, (off_t)(this->interface.offset + readAheadBegin), (off_t)(readAheadEnd - readAheadBegin),
+                    POSIX_FADV_WILLNEED);
+                this->readAheadCurrent = readAheadEnd;
+            }
+        }
+#endif
+
         // Read from file
         actualBytes = read(this->fd, bufRemainsPtr(buffer), expectedBytes);
 
@@ -145,6 +358,12 @@ storageReadPosix(THIS_VOID, Buffer *const buffer, const bool block)
         // not concerned with files that are growing. Just read up to the point where the file is being extended.
         if ((size_t)actualBytes != expectedBytes || this->current == this->limit)
             this->eof = true;
+
+        // Drop pages that were just read so reading a large amount of data does not evict more useful pages from the page cache
+#if defined(POSIX_FADV_DONTNEED) && defined(HAVE_MINCORE)
+        if (this->residentTotal > 0)
+            storageReadPosixDrop(this);
+#endif
     }
 
     FUNCTION_LOG_RETURN(SIZE, (size_t)actualBytes);
@@ -209,18 +428,20 @@ storageReadPosixFd(const THIS_VOID)
 FN_EXTERN StorageRead *
 storageReadPosixNew(
     StoragePosix *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset,
-    const Variant *const limit)
+    const Variant *const limit, const bool pageCacheDrop, const unsigned int readAhead)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
         FUNCTION_LOG_PARAM(UINT64, offset);
         FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(BOOL, pageCacheDrop);
+        FUNCTION_LOG_PARAM(UINT, readAhead);
     FUNCTION_LOG_END();
 
     ASSERT(name != NULL);
 
-    OBJ_NEW_BEGIN(StorageReadPosix, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
+    OBJ_NEW_BEGIN(StorageReadPosix, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = 1, .callbackQty = 1)
     {
         *this = (StorageReadPosix)
         {
@@ -231,6 +452,8 @@ storageReadPosixNew(
             // that no files will be > UINT64_MAX in size. This is a copy of the interface limit but it simplifies the code during
             // read so it seems worthwhile.
             .limit = limit == NULL ? UINT64_MAX : varUInt64(limit),
+            .pageCacheDrop = pageCacheDrop,
+            .readAhead = readAhead,
 
             .interface = (StorageReadInterface)
             {
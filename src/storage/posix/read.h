@@ -11,6 +11,7 @@ Posix Storage Read
 Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN StorageRead *storageReadPosixNew(
-    StoragePosix *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit);
+    StoragePosix *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit, bool pageCacheDrop,
+    unsigned int readAhead);
 
 #endif
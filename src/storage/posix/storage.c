@@ -33,6 +33,9 @@ Object type
 struct StoragePosix
 {
     STORAGE_COMMON_MEMBER;
+    bool pageCacheDrop;                                             // Drop pages from the page cache after they are read
+    unsigned int readAhead;                                         // Buffers to read ahead
+    unsigned int writeQueue;                                        // Writes to queue
 };
 
 /**********************************************************************************************************************************/
@@ -360,7 +363,9 @@ storagePosixNewRead(THIS_VOID, const String *const file, const bool ignoreMissin
     ASSERT(!param.version);
     ASSERT(param.versionId == NULL);
 
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadPosixNew(this, file, ignoreMissing, param.offset, param.limit));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadPosixNew(this, file, ignoreMissing, param.offset, param.limit, this->pageCacheDrop, this->readAhead));
 }
 
 /**********************************************************************************************************************************/
@@ -382,6 +387,8 @@ storagePosixNewWrite(THIS_VOID, const String *const file, const StorageInterface
         FUNCTION_LOG_PARAM(BOOL, param.syncPath);
         FUNCTION_LOG_PARAM(BOOL, param.atomic);
         FUNCTION_LOG_PARAM(BOOL, param.truncate);
+        FUNCTION_LOG_PARAM(BOOL, param.sparse);
+        FUNCTION_LOG_PARAM(UINT64, param.preallocate);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -391,7 +398,8 @@ storagePosixNewWrite(THIS_VOID, const String *const file, const StorageInterface
         STORAGE_WRITE,
         storageWritePosixNew(
             this, file, param.modeFile, param.modePath, param.user, param.group, param.timeModified, param.createPath,
-            param.syncFile, this->interface.pathSync != NULL ? param.syncPath : false, param.atomic, param.truncate));
+            param.syncFile, this->interface.pathSync != NULL ? param.syncPath : false, param.atomic, param.truncate, param.sparse,
+            param.preallocate, this->writeQueue));
 }
 
 /**********************************************************************************************************************************/
@@ -594,7 +602,8 @@ static const StorageInterface storageInterfacePosix =
 FN_EXTERN Storage *
 storagePosixNewInternal(
     const StringId type, const String *const path, const mode_t modeFile, const mode_t modePath, const bool write,
-    StoragePathExpressionCallback pathExpressionFunction, const bool pathSync)
+    StoragePathExpressionCallback pathExpressionFunction, const bool pathSync, const bool pageCacheDrop,
+    const unsigned int readAhead, const unsigned int writeQueue)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING_ID, type);
@@ -604,6 +613,9 @@ storagePosixNewInternal(
         FUNCTION_LOG_PARAM(BOOL, write);
         FUNCTION_LOG_PARAM(FUNCTIONP, pathExpressionFunction);
         FUNCTION_LOG_PARAM(BOOL, pathSync);
+        FUNCTION_LOG_PARAM(BOOL, pageCacheDrop);
+        FUNCTION_LOG_PARAM(UINT, readAhead);
+        FUNCTION_LOG_PARAM(UINT, writeQueue);
     FUNCTION_LOG_END();
 
     ASSERT(type != 0);
@@ -620,6 +632,9 @@ storagePosixNewInternal(
         *this = (StoragePosix)
         {
             .interface = storageInterfacePosix,
+            .pageCacheDrop = pageCacheDrop,
+            .readAhead = readAhead,
+            .writeQueue = writeQueue,
         };
 
         // Disable path sync when not supported
@@ -647,11 +662,15 @@ storagePosixNew(const String *const path, const StoragePosixNewParam param)
         FUNCTION_LOG_PARAM(MODE, param.modePath);
         FUNCTION_LOG_PARAM(BOOL, param.write);
         FUNCTION_LOG_PARAM(FUNCTIONP, param.pathExpressionFunction);
+        FUNCTION_LOG_PARAM(BOOL, param.pageCacheDrop);
+        FUNCTION_LOG_PARAM(UINT, param.readAhead);
+        FUNCTION_LOG_PARAM(UINT, param.writeQueue);
     FUNCTION_LOG_END();
 
     FUNCTION_LOG_RETURN(
         STORAGE,
         storagePosixNewInternal(
             STORAGE_POSIX_TYPE, path, param.modeFile == 0 ? STORAGE_MODE_FILE_DEFAULT : param.modeFile,
-            param.modePath == 0 ? STORAGE_MODE_PATH_DEFAULT : param.modePath, param.write, param.pathExpressionFunction, true));
+            param.modePath == 0 ? STORAGE_MODE_PATH_DEFAULT : param.modePath, param.write, param.pathExpressionFunction, true,
+            param.pageCacheDrop, param.readAhead, param.writeQueue));
 }
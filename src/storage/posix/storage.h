@@ -21,6 +21,9 @@ typedef struct StoragePosixNewParam
     mode_t modeFile;
     mode_t modePath;
     StoragePathExpressionCallback *pathExpressionFunction;
+    bool pageCacheDrop;
+    unsigned int readAhead;
+    unsigned int writeQueue;
 } StoragePosixNewParam;
 
 #define storagePosixNewP(path, ...)                                                                                                \
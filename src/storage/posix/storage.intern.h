@@ -16,7 +16,8 @@ Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN Storage *storagePosixNewInternal(
     StringId type, const String *path, mode_t modeFile, mode_t modePath, bool write,
-    StoragePathExpressionCallback pathExpressionFunction, bool pathSync);
+    StoragePathExpressionCallback pathExpressionFunction, bool pathSync, bool pageCacheDrop, unsigned int readAhead,
+    unsigned int writeQueue);
 
 /***********************************************************************************************************************************
 Macros for function logging
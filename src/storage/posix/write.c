@@ -5,9 +5,16 @@ Posix Storage File write
 
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <utime.h>
 
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 #include "common/debug.h"
 #include "common/io/write.h"
 #include "common/log.h"
@@ -16,6 +23,59 @@ Posix Storage File write
 #include "storage/posix/write.h"
 #include "storage/write.h"
 
+/***********************************************************************************************************************************
+Size of the blocks checked for zeroes when writing sparse files. This matches the most common file system block size since smaller
+holes would not save any space.
+***********************************************************************************************************************************/
+#define STORAGE_POSIX_SPARSE_SIZE                                   4096
+
+/***********************************************************************************************************************************
+Queue for asynchronous writes using io_uring. Each write is copied into a slot since the caller reuses the buffer as soon as the
+write returns. The file sync is queued behind the writes so all of them complete with a single wait on close.
+***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+// Kernel features required by the queue. IORING_OP_WRITE was added in the same release as this feature so it detects support.
+#define STORAGE_POSIX_QUEUE_FEATURE                                 IORING_FEAT_RW_CUR_POS
+
+// User data that identifies the file sync completion. All other completions are writes identified by their slot index.
+#define STORAGE_POSIX_QUEUE_SYNC                                    UINT64_MAX
+
+typedef struct StorageWritePosixQueueSlot
+{
+    Buffer *buffer;                                                 // Data being written
+    uint64_t offset;                                                // Offset of the data in the file
+} StorageWritePosixQueueSlot;
+
+typedef struct StorageWritePosixQueue
+{
+    int fd;                                                         // io_uring file descriptor
+    unsigned int inFlight;                                          // Requests submitted and not yet completed
+    struct io_sqring_offsets sqOffset;                              // Submission ring member offsets
+    struct io_cqring_offsets cqOffset;                              // Completion ring member offsets
+
+    void *sqRing;                                                   // Submission ring mapping
+    size_t sqRingSize;                                              // Submission ring mapping size
+    unsigned int *sqTail;                                           // Submission ring tail
+    const unsigned int *sqMask;                                     // Submission ring mask
+    unsigned int *sqArray;                                          // Submission ring array of entry indexes
+    struct io_uring_sqe *sqeList;                                   // Submission entries
+    size_t sqeListSize;                                             // Submission entries mapping size
+
+    void *cqRing;                                                   // Completion ring mapping
+    size_t cqRingSize;                                              // Completion ring mapping size
+    unsigned int *cqHead;                                           // Completion ring head
+    const unsigned int *cqTail;                                     // Completion ring tail
+    const unsigned int *cqMask;                                     // Completion ring mask
+    const struct io_uring_cqe *cqeList;                             // Completion entries
+
+    StorageWritePosixQueueSlot *slotList;                           // Slots for data being written
+    unsigned int *slotFreeList;                                     // Indexes of free slots
+    unsigned int slotFreeTotal;                                     // Total free slots
+} StorageWritePosixQueue;
+
+#endif // HAVE_IO_URING
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -27,6 +87,15 @@ typedef struct StorageWritePosix
     const String *nameTmp;
     const String *path;
     int fd;                                                         // File descriptor
+    bool sparse;                                                    // Skip blocks of zeroes to create a sparse file
+    uint64_t preallocate;                                           // Size to preallocate (0 for none)
+    unsigned int writeQueue;                                        // Writes to queue (0 to write synchronously)
+    uint64_t size;                                                  // Size written, including holes
+    bool hole;                                                      // Did the file end with a hole? (sparse only)
+
+#ifdef HAVE_IO_URING
+    StorageWritePosixQueue *queue;                                  // Queue for asynchronous writes (NULL when not used)
+#endif
 } StorageWritePosix;
 
 /***********************************************************************************************************************************
@@ -44,6 +113,251 @@ Since open is called more than once use constants to make sure these parameters
 ***********************************************************************************************************************************/
 #define FILE_OPEN_PURPOSE                                           "write"
 
+/***********************************************************************************************************************************
+Queue functions
+***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+// Free the queue. Requests still in flight are waited for so the kernel is no longer using the slots when they are freed. Errors
+// are ignored since the file is being abandoned and munmap() fails harmlessly for rings that were not mapped.
+static void
+storageWritePosixQueueFree(StorageWritePosixQueue *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    if (this->inFlight > 0)
+        syscall(__NR_io_uring_enter, this->fd, 0, this->inFlight, IORING_ENTER_GETEVENTS, NULL, 0);
+
+    munmap(this->sqRing, this->sqRingSize);
+    munmap(this->sqeList, this->sqeListSize);
+    munmap(this->cqRing, this->cqRingSize);
+    close(this->fd);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Create the queue. NULL is returned when io_uring or the required features are not available so the caller can write
+// synchronously. The rings are mapped by storageWritePosixQueueMap() after the caller has stored the queue so it will be freed on
+// error.
+static StorageWritePosixQueue *
+storageWritePosixQueueNew(const unsigned int depth, const uint32_t featureRequired)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT, depth);
+        FUNCTION_TEST_PARAM(UINT, featureRequired);
+    FUNCTION_TEST_END();
+
+    ASSERT(depth > 0);
+
+    // Create the ring with an extra entry for the file sync
+    struct io_uring_params param = {0};
+    const int fd = (int)syscall(__NR_io_uring_setup, depth + 1, &param);
+
+    if (fd == -1)
+        FUNCTION_TEST_RETURN_TYPE_P(StorageWritePosixQueue, NULL);
+
+    if ((param.features & featureRequired) != featureRequired)
+    {
+        THROW_ON_SYS_ERROR(close(fd) == -1, FileCloseError, "unable to close io_uring");
+        FUNCTION_TEST_RETURN_TYPE_P(StorageWritePosixQueue, NULL);
+    }
+
+    OBJ_NEW_BEGIN(StorageWritePosixQueue, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (StorageWritePosixQueue)
+        {
+            .fd = fd,
+            .sqOffset = param.sq_off,
+            .cqOffset = param.cq_off,
+            .sqRing = MAP_FAILED,
+            .sqRingSize = param.sq_off.array + param.sq_entries * sizeof(unsigned int),
+            .sqeList = MAP_FAILED,
+            .sqeListSize = param.sq_entries * sizeof(struct io_uring_sqe),
+            .cqRing = MAP_FAILED,
+            .cqRingSize = param.cq_off.cqes + param.cq_entries * sizeof(struct io_uring_cqe),
+            .slotList = memNew(depth * sizeof(StorageWritePosixQueueSlot)),
+            .slotFreeList = memNew(depth * sizeof(unsigned int)),
+            .slotFreeTotal = depth,
+        };
+
+        for (unsigned int slotIdx = 0; slotIdx < depth; slotIdx++)
+        {
+            this->slotList[slotIdx] = (StorageWritePosixQueueSlot){.buffer = bufNew(0)};
+            this->slotFreeList[slotIdx] = slotIdx;
+        }
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_TEST_RETURN_TYPE_P(StorageWritePosixQueue, this);
+}
+
+// Map the rings
+static void
+storageWritePosixQueueMap(StorageWritePosixQueue *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    this->sqRing = mmap(NULL, this->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, IORING_OFF_SQ_RING);
+    THROW_ON_SYS_ERROR(this->sqRing == MAP_FAILED, FileOpenError, "unable to map io_uring submission ring");
+
+    this->sqeList = mmap(NULL, this->sqeListSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, IORING_OFF_SQES);
+    THROW_ON_SYS_ERROR(this->sqeList == MAP_FAILED, FileOpenError, "unable to map io_uring submission entries");
+
+    this->cqRing = mmap(NULL, this->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, IORING_OFF_CQ_RING);
+    THROW_ON_SYS_ERROR(this->cqRing == MAP_FAILED, FileOpenError, "unable to map io_uring completion ring");
+
+    // Get pointers to the ring members
+    unsigned char *const sqRing = this->sqRing;
+    unsigned char *const cqRing = this->cqRing;
+
+    this->sqTail = (unsigned int *)(sqRing + this->sqOffset.tail);
+    this->sqMask = (const unsigned int *)(sqRing + this->sqOffset.ring_mask);
+    this->sqArray = (unsigned int *)(sqRing + this->sqOffset.array);
+    this->cqHead = (unsigned int *)(cqRing + this->cqOffset.head);
+    this->cqTail = (const unsigned int *)(cqRing + this->cqOffset.tail);
+    this->cqMask = (const unsigned int *)(cqRing + this->cqOffset.ring_mask);
+    this->cqeList = (const struct io_uring_cqe *)(cqRing + this->cqOffset.cqes);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Add a request to the submission ring. The request is not submitted until storageWritePosixQueueEnter() is called.
+static void
+storageWritePosixQueueAdd(
+    StorageWritePosixQueue *const this, const uint8_t opcode, const uint8_t flags, const int fd, const void *const data,
+    const size_t size, const uint64_t offset, const uint64_t userData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, this);
+        FUNCTION_TEST_PARAM(UINT, opcode);
+        FUNCTION_TEST_PARAM(UINT, flags);
+        FUNCTION_TEST_PARAM(INT, fd);
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(SIZE, size);
+        FUNCTION_TEST_PARAM(UINT64, offset);
+        FUNCTION_TEST_PARAM(UINT64, userData);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    // The ring is drained on every enter so the tail is always free
+    const unsigned int tail = *this->sqTail;
+    const unsigned int sqeIdx = tail & *this->sqMask;
+
+    this->sqeList[sqeIdx] = (struct io_uring_sqe)
+    {
+        .opcode = opcode,
+        .flags = flags,
+        .fd = fd,
+        .off = offset,
+        .addr = (uint64_t)(uintptr_t)data,
+        .len = (uint32_t)size,
+        .user_data = userData,
+    };
+
+    this->sqArray[sqeIdx] = sqeIdx;
+
+    // Make the entry visible to the kernel before the tail is updated
+    __atomic_store_n(this->sqTail, tail + 1, __ATOMIC_RELEASE);
+    this->inFlight++;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Submit requests added to the submission ring and wait for the required number of completions
+static void
+storageWritePosixQueueEnter(
+    StorageWritePosixQueue *const this, const unsigned int submitTotal, const unsigned int waitTotal, const String *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, this);
+        FUNCTION_TEST_PARAM(UINT, submitTotal);
+        FUNCTION_TEST_PARAM(UINT, waitTotal);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+
+    THROW_ON_SYS_ERROR_FMT(
+        syscall(__NR_io_uring_enter, this->fd, submitTotal, waitTotal, IORING_ENTER_GETEVENTS, NULL, 0) == -1, FileWriteError,
+        "unable to queue write for '%s'", strZ(name));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Process completions. Writes that failed or were short are finished synchronously so the error reported, if any, is the same as
+// when writing synchronously.
+static void
+storageWritePosixQueueComplete(StorageWritePosixQueue *const this, const int fd, const String *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, this);
+        FUNCTION_TEST_PARAM(INT, fd);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+
+    unsigned int head = *this->cqHead;
+
+    while (head != __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE))
+    {
+        const struct io_uring_cqe *const cqe = &this->cqeList[head & *this->cqMask];
+
+        // Release the completion before processing since processing may throw an error
+        const uint64_t userData = cqe->user_data;
+        const int result = cqe->res;
+
+        head++;
+        __atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+        this->inFlight--;
+
+        // Report file sync errors. Sync is never retried since the kernel may have already discarded the pages that failed.
+        if (userData == STORAGE_POSIX_QUEUE_SYNC)
+        {
+            if (result < 0)
+            {
+                errno = -result;
+                THROW_SYS_ERROR_FMT(FileSyncError, STORAGE_ERROR_WRITE_SYNC, strZ(name));
+            }
+        }
+        // Else finish the write if required and free the slot
+        else
+        {
+            const StorageWritePosixQueueSlot *const slot = &this->slotList[userData];
+            const size_t writeSize = result < 0 ? 0 : (size_t)result;
+
+            if (writeSize != bufUsed(slot->buffer))
+            {
+                const size_t remainSize = bufUsed(slot->buffer) - writeSize;
+
+                if (pwrite(fd, bufPtrConst(slot->buffer) + writeSize, remainSize, (off_t)(slot->offset + writeSize)) !=
+                        (ssize_t)remainSize)
+                {
+                    THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(name));
+                }
+            }
+
+            this->slotFreeList[this->slotFreeTotal] = (unsigned int)userData;
+            this->slotFreeTotal++;
+        }
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+#endif // HAVE_IO_URING
+
 /***********************************************************************************************************************************
 Close file descriptor
 ***********************************************************************************************************************************/
@@ -58,6 +372,12 @@ storageWritePosixFreeResource(THIS_VOID)
 
     ASSERT(this != NULL);
 
+#ifdef HAVE_IO_URING
+    // Free the queue first since the kernel may still be reading from the slots and writing to the file
+    if (this->queue != NULL)
+        storageWritePosixQueueFree(this->queue);
+#endif
+
     THROW_ON_SYS_ERROR_FMT(close(this->fd) == -1, FileCloseError, STORAGE_ERROR_WRITE_CLOSE, strZ(this->nameTmp));
 
     FUNCTION_LOG_RETURN_VOID();
@@ -117,6 +437,14 @@ storageWritePosixOpen(THIS_VOID)
     // Set free callback to ensure the file descriptor is freed
     memContextCallbackSet(objMemContext(this), storageWritePosixFreeResource, this);
 
+    // Preallocate space for the file
+    if (this->preallocate != 0)
+    {
+        THROW_ON_SYS_ERROR_FMT(
+            (errno = posix_fallocate(this->fd, 0, (off_t)this->preallocate)) != 0, FileWriteError,
+            "unable to preallocate %" PRIu64 " bytes for '%s'", this->preallocate, strZ(this->nameTmp));
+    }
+
     // Update user/group owner
     if (this->interface.user != NULL || this->interface.group != NULL)
     {
@@ -172,8 +500,88 @@ storageWritePosix(THIS_VOID, const Buffer *const buffer)
     ASSERT(this->fd != -1);
 
     // Write the data
-    if (write(this->fd, bufPtrConst(buffer), bufUsed(buffer)) != (ssize_t)bufUsed(buffer))
-        THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+    if (!this->sparse)
+    {
+#ifdef HAVE_IO_URING
+        // Create the queue on the second write since a file that fits in a single buffer would not benefit from queuing
+        if (this->writeQueue > 0 && this->queue == NULL && this->size > 0)
+        {
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->queue = storageWritePosixQueueNew(this->writeQueue, STORAGE_POSIX_QUEUE_FEATURE);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            // Write synchronously when io_uring is not available
+            if (this->queue == NULL)
+                this->writeQueue = 0;
+            else
+                storageWritePosixQueueMap(this->queue);
+        }
+
+        // Queue the write
+        if (this->queue != NULL)
+        {
+            StorageWritePosixQueue *const queue = this->queue;
+
+            // Wait for a write to complete when all slots are in use. Completions are only processed here and on close so errors
+            // are reported late, but no later than the close.
+            if (queue->slotFreeTotal == 0)
+            {
+                storageWritePosixQueueEnter(queue, 0, 1, this->nameTmp);
+                storageWritePosixQueueComplete(queue, this->fd, this->nameTmp);
+            }
+
+            // Copy the data into a free slot and submit the write
+            queue->slotFreeTotal--;
+
+            const unsigned int slotIdx = queue->slotFreeList[queue->slotFreeTotal];
+            StorageWritePosixQueueSlot *const slot = &queue->slotList[slotIdx];
+
+            bufUsedZero(slot->buffer);
+            bufCat(slot->buffer, buffer);
+            slot->offset = this->size;
+
+            storageWritePosixQueueAdd(
+                queue, IORING_OP_WRITE, 0, this->fd, bufPtrConst(slot->buffer), bufUsed(slot->buffer), slot->offset, slotIdx);
+            storageWritePosixQueueEnter(queue, 1, 0, this->nameTmp);
+        }
+        else
+#endif
+        if (write(this->fd, bufPtrConst(buffer), bufUsed(buffer)) != (ssize_t)bufUsed(buffer))
+            THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+
+        this->size += bufUsed(buffer);
+    }
+    // Else write blocks that contain data and seek past blocks of zeroes to leave holes. Blocks are aligned to the file rather than
+    // the buffer so holes line up with file system blocks.
+    else
+    {
+        size_t bufferIdx = 0;
+
+        while (bufferIdx < bufUsed(buffer))
+        {
+            const unsigned char *const block = bufPtrConst(buffer) + bufferIdx;
+            const size_t blockAlign = (size_t)(STORAGE_POSIX_SPARSE_SIZE - this->size % STORAGE_POSIX_SPARSE_SIZE);
+            const size_t blockSize = blockAlign < bufUsed(buffer) - bufferIdx ? blockAlign : bufUsed(buffer) - bufferIdx;
+
+            // If the block is all zeroes then seek past it
+            this->hole = block[0] == 0 && memcmp(block, block + 1, blockSize - 1) == 0;
+
+            if (this->hole)
+            {
+                THROW_ON_SYS_ERROR_FMT(
+                    lseek(this->fd, (off_t)blockSize, SEEK_CUR) == -1, FileWriteError, "unable to seek '%s'",
+                    strZ(this->nameTmp));
+            }
+            // Else write the block
+            else if (write(this->fd, block, blockSize) != (ssize_t)blockSize)
+                THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+
+            this->size += blockSize;
+            bufferIdx += blockSize;
+        }
+    }
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -195,8 +603,41 @@ storageWritePosixClose(THIS_VOID)
     // Close if the file has not already been closed
     if (this->fd != -1)
     {
+        // Set the file size when it ends with a hole since seeking does not extend the file
+        if (this->hole)
+        {
+            THROW_ON_SYS_ERROR_FMT(
+                ftruncate(this->fd, (off_t)this->size) == -1, FileWriteError, "unable to truncate '%s'", strZ(this->nameTmp));
+        }
+
+        bool syncFile = this->interface.syncFile;
+
+#ifdef HAVE_IO_URING
+        // Queue the file sync behind the writes and wait for all of them to complete
+        if (this->queue != NULL)
+        {
+            StorageWritePosixQueue *const queue = this->queue;
+            unsigned int submitTotal = 0;
+
+            if (syncFile)
+            {
+                storageWritePosixQueueAdd(
+                    queue, IORING_OP_FSYNC, IOSQE_IO_DRAIN, this->fd, NULL, 0, 0, STORAGE_POSIX_QUEUE_SYNC);
+                submitTotal = 1;
+                syncFile = false;
+            }
+
+            storageWritePosixQueueEnter(queue, submitTotal, queue->inFlight, this->nameTmp);
+            storageWritePosixQueueComplete(queue, this->fd, this->nameTmp);
+
+            storageWritePosixQueueFree(queue);
+            objFree(queue);
+            this->queue = NULL;
+        }
+#endif
+
         // Sync the file
-        if (this->interface.syncFile)
+        if (syncFile)
             THROW_ON_SYS_ERROR_FMT(fsync(this->fd) == -1, FileSyncError, STORAGE_ERROR_WRITE_SYNC, strZ(this->nameTmp));
 
         // Close the file
@@ -251,7 +692,7 @@ FN_EXTERN StorageWrite *
 storageWritePosixNew(
     StoragePosix *const storage, const String *const name, const mode_t modeFile, const mode_t modePath, const String *const user,
     const String *const group, const time_t timeModified, const bool createPath, const bool syncFile, const bool syncPath,
-    const bool atomic, const bool truncate)
+    const bool atomic, const bool truncate, const bool sparse, const uint64_t preallocate, const unsigned int writeQueue)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_POSIX, storage);
@@ -266,12 +707,16 @@ storageWritePosixNew(
         FUNCTION_LOG_PARAM(BOOL, syncPath);
         FUNCTION_LOG_PARAM(BOOL, atomic);
         FUNCTION_LOG_PARAM(BOOL, truncate);
+        FUNCTION_LOG_PARAM(BOOL, sparse);
+        FUNCTION_LOG_PARAM(UINT64, preallocate);
+        FUNCTION_LOG_PARAM(UINT, writeQueue);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
     ASSERT(modeFile != 0);
     ASSERT(modePath != 0);
+    ASSERT(!sparse || truncate);
 
     OBJ_NEW_BEGIN(StorageWritePosix, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
     {
@@ -280,6 +725,9 @@ storageWritePosixNew(
             .storage = storage,
             .path = strPath(name),
             .fd = -1,
+            .sparse = sparse,
+            .preallocate = preallocate,
+            .writeQueue = writeQueue,
 
             .interface = (StorageWriteInterface)
             {
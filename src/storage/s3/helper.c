@@ -89,9 +89,12 @@ storageS3Helper(const unsigned int repoIdx, const bool write, StoragePathExpress
                 cfgOptionIdxStrNull(cfgOptRepoS3Token, repoIdx), cfgOptionIdxStrNull(cfgOptRepoS3KmsKeyId, repoIdx),
                 cfgOptionIdxStrNull(cfgOptRepoS3SseCustomerKey, repoIdx), role, webIdTokenFile,
                 (size_t)cfgOptionIdxUInt64(cfgOptRepoStorageUploadChunkSize, repoIdx),
-                cfgOptionIdxKvNull(cfgOptRepoStorageTag, repoIdx), host, port, ioTimeoutMs(),
-                cfgOptionIdxBool(cfgOptRepoStorageVerifyTls, repoIdx), cfgOptionIdxStrNull(cfgOptRepoStorageCaFile, repoIdx),
-                cfgOptionIdxStrNull(cfgOptRepoStorageCaPath, repoIdx), cfgOptionIdxBool(cfgOptRepoS3RequesterPays, repoIdx));
+                cfgOptionIdxUInt(cfgOptRepoStorageUploadChunkMax, repoIdx),
+                (size_t)cfgOptionIdxUInt64(cfgOptRepoStorageDownloadChunkSize, repoIdx),
+                cfgOptionIdxUInt(cfgOptRepoStorageDownloadChunkMax, repoIdx), cfgOptionIdxKvNull(cfgOptRepoStorageTag, repoIdx),
+                host, port, ioTimeoutMs(), cfgOptionIdxBool(cfgOptRepoStorageVerifyTls, repoIdx),
+                cfgOptionIdxStrNull(cfgOptRepoStorageCaFile, repoIdx), cfgOptionIdxStrNull(cfgOptRepoStorageCaPath, repoIdx),
+                cfgOptionIdxBool(cfgOptRepoS3RequesterPays, repoIdx));
         }
         MEM_CONTEXT_PRIOR_END();
     }
@@ -7,6 +7,7 @@ Based on the documentation at https://cloud.google.com/storage/docs/json_api/v1/
 
 #include "common/debug.h"
 #include "common/io/http/client.h"
+#include "common/io/http/readAhead.h"
 #include "common/log.h"
 #include "common/type/object.h"
 #include "storage/read.h"
@@ -22,8 +23,12 @@ typedef struct StorageReadS3
 {
     StorageReadInterface interface;                                 // Interface
     StorageS3 *storage;                                             // Storage that created this object
+    size_t rangeSize;                                               // Range size for read-ahead
+    unsigned int rangeMax;                                          // Maximum concurrent ranges for read-ahead
 
     HttpResponse *httpResponse;                                     // HTTP response
+    HttpReadAhead *readAhead;                                       // Read-ahead when the file is read in ranges
+    const String *eTag;                                             // ETag read by the first request (pins ranges)
 } StorageReadS3;
 
 /***********************************************************************************************************************************
@@ -34,6 +39,79 @@ Macros for function logging
 #define FUNCTION_LOG_STORAGE_READ_S3_FORMAT(value, buffer, bufferSize)                                                             \
     objNameToLog(value, "StorageReadS3", buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Request a range of the file
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadS3Request(StorageReadS3 *const this, const uint64_t offset, const Variant *const limit)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_S3, this);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    HttpRequest *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), offset, limit);
+
+        if (this->eTag != NULL)
+            httpHeaderAdd(header, HTTP_HEADER_IF_MATCH_STR, this->eTag);
+
+        result = httpRequestMove(
+            storageS3RequestAsyncP(
+                this->storage, HTTP_VERB_GET_STR, this->interface.name, .header = header,
+                .query =
+                    this->interface.versionId == NULL
+                        ? NULL : httpQueryPut(httpQueryNewP(), STRDEF("versionId"), this->interface.versionId),
+                .sseC = true),
+            memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
+}
+
+/***********************************************************************************************************************************
+Read-ahead callbacks
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadS3RangeRequest(void *const driver, const uint64_t offset, const uint64_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_READ_S3, driver);
+        FUNCTION_TEST_PARAM(UINT64, offset);
+        FUNCTION_TEST_PARAM(UINT64, size);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(HTTP_REQUEST, storageReadS3Request(driver, offset, VARUINT64(size)));
+}
+
+static HttpResponse *
+storageReadS3RangeResponse(void *const driver, HttpRequest *const request)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_READ_S3, driver);
+        FUNCTION_TEST_PARAM(HTTP_REQUEST, request);
+    FUNCTION_TEST_END();
+
+    StorageReadS3 *const this = driver;
+    HttpResponse *const result = httpRequestResponse(request, false);
+
+    // Error when the object was replaced after the first request since the ranges would not be from the same object
+    if (httpResponseCode(result) == HTTP_RESPONSE_CODE_PRECONDITION_FAILED)
+        THROW_FMT(FileReadError, STORAGE_ERROR_READ_CHANGED, strZ(this->interface.name));
+
+    if (!httpResponseCodeOk(result))
+        httpRequestError(request, result);
+
+    FUNCTION_TEST_RETURN(HTTP_RESPONSE, result);
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -54,21 +132,46 @@ storageReadS3Open(THIS_VOID)
     // Read if not versioned or if versionId is not null
     if (!this->interface.version || this->interface.versionId != NULL)
     {
+        // When the size is known and read-ahead will be used only request the first range
+        const Variant *limit = this->interface.limit;
+
+        if (this->rangeMax > 1 && limit != NULL && varUInt64(limit) > this->rangeSize)
+            limit = VARUINT64(this->rangeSize);
+
         // Request the file
+        HttpRequest *const request = storageReadS3Request(this, this->interface.offset, limit);
+
         MEM_CONTEXT_OBJ_BEGIN(this)
         {
-            this->httpResponse = storageS3RequestP(
-                this->storage, HTTP_VERB_GET_STR, this->interface.name,
-                .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
-                .query =
-                    this->interface.versionId == NULL
-                        ? NULL : httpQueryPut(httpQueryNewP(), STRDEF("versionId"), this->interface.versionId),
-                .allowMissing = true, .contentIo = true, .sseC = true);
+            this->httpResponse = storageS3ResponseP(request, .allowMissing = true, .contentIo = true);
         }
         MEM_CONTEXT_OBJ_END();
 
+        httpRequestFree(request);
+
         if (httpResponseCodeOk(this->httpResponse))
         {
+            // Read the rest of the file in ranges when it is larger than a single range. The size of the content is used when the
+            // limit is not known.
+            const uint64_t size =
+                this->interface.limit != NULL ? varUInt64(this->interface.limit) : httpResponseContentSize(this->httpResponse);
+
+            if (this->rangeMax > 1 && size > this->rangeSize)
+            {
+                MEM_CONTEXT_OBJ_BEGIN(this)
+                {
+                    // Pin range requests to the version of the object read by the first request
+                    this->eTag = strDup(httpHeaderGet(httpResponseHeader(this->httpResponse), HTTP_HEADER_ETAG_STR));
+
+                    this->readAhead = httpReadAheadNewP(
+                        this->httpResponse, this->interface.offset, size, this->rangeSize, this->rangeMax, .driver = this,
+                        .request = storageReadS3RangeRequest, .response = storageReadS3RangeResponse);
+                }
+                MEM_CONTEXT_OBJ_END();
+
+                this->httpResponse = NULL;
+            }
+
             result = true;
         }
         // Else error unless ignore missing
@@ -93,11 +196,12 @@ storageReadS3(THIS_VOID, Buffer *const buffer, const bool block)
         FUNCTION_LOG_PARAM(BOOL, block);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && (this->httpResponse != NULL || this->readAhead != NULL));
     ASSERT(buffer != NULL && !bufFull(buffer));
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(
+        SIZE,
+        this->readAhead != NULL ? httpReadAhead(this->readAhead, buffer) : ioRead(httpResponseIoRead(this->httpResponse), buffer));
 }
 
 /***********************************************************************************************************************************
@@ -112,17 +216,17 @@ storageReadS3Eof(THIS_VOID)
         FUNCTION_TEST_PARAM(STORAGE_READ_S3, this);
     FUNCTION_TEST_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && (this->httpResponse != NULL || this->readAhead != NULL));
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
+    FUNCTION_TEST_RETURN(
+        BOOL, this->readAhead != NULL ? httpReadAheadEof(this->readAhead) : ioReadEof(httpResponseIoRead(this->httpResponse)));
 }
 
 /**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadS3New(
     StorageS3 *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset, const Variant *const limit,
-    const bool version, const String *const versionId)
+    const bool version, const String *const versionId, const size_t rangeSize, const unsigned int rangeMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_S3, storage);
@@ -132,17 +236,23 @@ storageReadS3New(
         FUNCTION_LOG_PARAM(VARIANT, limit);
         FUNCTION_LOG_PARAM(BOOL, version);
         FUNCTION_LOG_PARAM(STRING, versionId);
+        FUNCTION_LOG_PARAM(SIZE, rangeSize);
+        FUNCTION_LOG_PARAM(UINT, rangeMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
     ASSERT(limit == NULL || varUInt64(limit) > 0);
+    ASSERT(rangeSize > 0);
+    ASSERT(rangeMax > 0);
 
     OBJ_NEW_BEGIN(StorageReadS3, .childQty = MEM_CONTEXT_QTY_MAX)
     {
         *this = (StorageReadS3)
         {
             .storage = storage,
+            .rangeSize = rangeSize,
+            .rangeMax = rangeMax,
 
             .interface = (StorageReadInterface)
             {
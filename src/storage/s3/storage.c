@@ -108,6 +108,9 @@ struct StorageS3
     const String *sseCustomerKey;                                   // Base64 of SSE-C encryption key
     const String *sseCustomerKeyMd5;                                // Base64 of MD5 of SSE-C key
     size_t partSize;                                                // Part size for multi-part upload
+    unsigned int partMax;                                           // Maximum concurrent part uploads per file
+    size_t rangeSize;                                               // Range size for read-ahead
+    unsigned int rangeMax;                                          // Maximum concurrent ranges per file for read-ahead
     const String *tag;                                              // Tags to be applied to objects
     unsigned int deleteMax;                                         // Maximum objects that can be deleted in one request
     StorageS3UriStyle uriStyle;                                     // Path or host style URIs
@@ -956,7 +959,9 @@ storageS3NewRead(THIS_VOID, const String *const file, const bool ignoreMissing,
     ASSERT(file != NULL);
 
     FUNCTION_LOG_RETURN(
-        STORAGE_READ, storageReadS3New(this, file, ignoreMissing, param.offset, param.limit, param.version, param.versionId));
+        STORAGE_READ,
+        storageReadS3New(
+            this, file, ignoreMissing, param.offset, param.limit, param.version, param.versionId, this->rangeSize, this->rangeMax));
 }
 
 /**********************************************************************************************************************************/
@@ -979,7 +984,7 @@ storageS3NewWrite(THIS_VOID, const String *const file, const StorageInterfaceNew
     ASSERT(param.group == NULL);
     ASSERT(param.timeModified == 0);
 
-    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteS3New(this, file, this->partSize));
+    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteS3New(this, file, this->partSize, this->partMax));
 }
 
 /**********************************************************************************************************************************/
@@ -1184,9 +1189,9 @@ storageS3New(
     const String *const bucket, const String *const endPoint, const StorageS3UriStyle uriStyle, const String *const region,
     const StorageS3KeyType keyType, const String *const accessKey, const String *const secretAccessKey,
     const String *const securityToken, const String *const kmsKeyId, const String *sseCustomerKey, const String *const credRole,
-    const String *const webIdTokenFile, const size_t partSize, const KeyValue *const tag, const String *host,
-    const unsigned int port, const TimeMSec timeout, const bool verifyPeer, const String *const caFile, const String *const caPath,
-    const bool requesterPays)
+    const String *const webIdTokenFile, const size_t partSize, const unsigned int partMax, const size_t rangeSize,
+    const unsigned int rangeMax, const KeyValue *const tag, const String *host, const unsigned int port, const TimeMSec timeout,
+    const bool verifyPeer, const String *const caFile, const String *const caPath, const bool requesterPays)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -1206,6 +1211,9 @@ storageS3New(
         FUNCTION_TEST_PARAM(STRING, credRole);
         FUNCTION_TEST_PARAM(STRING, webIdTokenFile);
         FUNCTION_LOG_PARAM(SIZE, partSize);
+        FUNCTION_LOG_PARAM(UINT, partMax);
+        FUNCTION_LOG_PARAM(SIZE, rangeSize);
+        FUNCTION_LOG_PARAM(UINT, rangeMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, host);
         FUNCTION_LOG_PARAM(UINT, port);
@@ -1220,6 +1228,9 @@ storageS3New(
     ASSERT(endPoint != NULL);
     ASSERT(region != NULL);
     ASSERT(partSize != 0);
+    ASSERT(partMax != 0);
+    ASSERT(rangeSize != 0);
+    ASSERT(rangeMax != 0);
 
     OBJ_NEW_BEGIN(StorageS3, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -1233,6 +1244,9 @@ storageS3New(
             .requesterPays = requesterPays,
             .sseCustomerKey = strDup(sseCustomerKey),
             .partSize = partSize,
+            .partMax = partMax,
+            .rangeSize = rangeSize,
+            .rangeMax = rangeMax,
             .deleteMax = STORAGE_S3_DELETE_MAX,
             .uriStyle = uriStyle,
             .bucketEndpoint =
@@ -1250,14 +1264,17 @@ storageS3New(
             httpQueryFree(query);
         }
 
-        // Create the HTTP client used to service requests
+        // Get the shared HTTP client used to service requests. Keep enough sessions for concurrent uploads and downloads.
         if (host == NULL)
             host = this->bucketEndpoint;
 
-        this->httpClient = httpClientNew(
+        this->httpClient = httpClientSharedP(
+            strNewFmt(
+                "%s:%u:%s:%s:%s:%" PRIu64, strZ(host), port, cvtBoolToConstZ(verifyPeer), strZNull(caFile), strZNull(caPath),
+                timeout),
             tlsClientNewP(
                 sckClientNew(host, port, timeout, timeout), host, timeout, timeout, verifyPeer, .caFile = caFile, .caPath = caPath),
-            timeout);
+            timeout, .sessionMax = partMax + rangeMax);
 
         // Initialize authentication
         switch (this->keyType)
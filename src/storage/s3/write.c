@@ -34,8 +34,9 @@ typedef struct StorageWriteS3
     StorageWriteInterface interface;                                // Interface
     StorageS3 *storage;                                             // Storage that created this object
 
-    HttpRequest *request;                                           // Async request
+    List *requestList;                                              // Async part requests in flight (oldest first)
     size_t partSize;
+    unsigned int partMax;                                           // Maximum part requests in flight
     Buffer *partBuffer;
     const String *uploadId;
     StringList *uploadPartList;
@@ -75,7 +76,8 @@ storageWriteS3Open(THIS_VOID)
 }
 
 /***********************************************************************************************************************************
-Flush bytes to upload part
+Flush bytes to upload part. Up to partMax parts may be in flight, each on a separate connection from the HTTP client. Responses are
+processed in the order the requests were sent so part ids are stored in part number order.
 ***********************************************************************************************************************************/
 static void
 storageWriteS3Part(StorageWriteS3 *const this)
@@ -85,19 +87,18 @@ storageWriteS3Part(StorageWriteS3 *const this)
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
+    ASSERT(!lstEmpty(this->requestList));
 
-    // If there is an outstanding async request then wait for the response and store the part id
-    if (this->request != NULL)
-    {
-        HttpResponse *const response = storageS3ResponseP(this->request);
+    // Wait for the response to the oldest async request and store the part id
+    HttpRequest *const request = *(HttpRequest **)lstGet(this->requestList, 0);
+    HttpResponse *const response = storageS3ResponseP(request);
 
-        strLstAdd(this->uploadPartList, httpHeaderGet(httpResponseHeader(response), HTTP_HEADER_ETAG_STR));
-        ASSERT(strLstGet(this->uploadPartList, strLstSize(this->uploadPartList) - 1) != NULL);
+    strLstAdd(this->uploadPartList, httpHeaderGet(httpResponseHeader(response), HTTP_HEADER_ETAG_STR));
+    ASSERT(strLstGet(this->uploadPartList, strLstSize(this->uploadPartList) - 1) != NULL);
 
-        httpResponseFree(response);
-        httpRequestFree(this->request);
-        this->request = NULL;
-    }
+    httpResponseFree(response);
+    httpRequestFree(request);
+    lstRemoveIdx(this->requestList, 0);
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -115,8 +116,9 @@ storageWriteS3PartAsync(StorageWriteS3 *const this)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        // Complete prior async request, if any
-        storageWriteS3Part(this);
+        // Complete the oldest async request when the maximum are in flight
+        if (lstSize(this->requestList) == this->partMax)
+            storageWriteS3Part(this);
 
         // Get the upload id if we have not already
         if (this->uploadId == NULL)
@@ -142,12 +144,16 @@ storageWriteS3PartAsync(StorageWriteS3 *const this)
         // Upload the part async
         HttpQuery *const query = httpQueryNewP();
         httpQueryAdd(query, S3_QUERY_UPLOAD_ID_STR, this->uploadId);
-        httpQueryAdd(query, S3_QUERY_PART_NUMBER_STR, strNewFmt("%u", strLstSize(this->uploadPartList) + 1));
+        httpQueryAdd(
+            query, S3_QUERY_PART_NUMBER_STR,
+            strNewFmt("%u", strLstSize(this->uploadPartList) + lstSize(this->requestList) + 1));
 
         MEM_CONTEXT_OBJ_BEGIN(this)
         {
-            this->request = storageS3RequestAsyncP(
+            HttpRequest *const request = storageS3RequestAsyncP(
                 this->storage, HTTP_VERB_PUT_STR, this->interface.name, .query = query, .content = this->partBuffer, .sseC = true);
+
+            lstAdd(this->requestList, &request);
         }
         MEM_CONTEXT_OBJ_END();
     }
@@ -224,8 +230,9 @@ storageWriteS3Close(THIS_VOID)
                 if (!bufEmpty(this->partBuffer))
                     storageWriteS3PartAsync(this);
 
-                // Complete prior async request, if any
-                storageWriteS3Part(this);
+                // Complete async requests
+                while (!lstEmpty(this->requestList))
+                    storageWriteS3Part(this);
 
                 // Generate the xml part list
                 XmlDocument *const partList = xmlDocumentNew(S3_XML_TAG_COMPLETE_MULTIPART_UPLOAD_STR);
@@ -270,22 +277,27 @@ storageWriteS3Close(THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN StorageWrite *
-storageWriteS3New(StorageS3 *const storage, const String *const name, const size_t partSize)
+storageWriteS3New(StorageS3 *const storage, const String *const name, const size_t partSize, const unsigned int partMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_S3, storage);
         FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(SIZE, partSize);
+        FUNCTION_LOG_PARAM(UINT, partMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
+    ASSERT(partMax > 0);
 
     OBJ_NEW_BEGIN(StorageWriteS3, .childQty = MEM_CONTEXT_QTY_MAX)
     {
         *this = (StorageWriteS3)
         {
             .storage = storage,
+            .requestList = lstNewP(sizeof(HttpRequest *)),
             .partSize = partSize,
+            .partMax = partMax,
 
             .interface = (StorageWriteInterface)
             {
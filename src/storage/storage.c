@@ -555,12 +555,16 @@ storageNewWrite(const Storage *const this, const String *const fileExp, const St
         FUNCTION_LOG_PARAM(BOOL, param.noAtomic);
         FUNCTION_LOG_PARAM(BOOL, param.noTruncate);
         FUNCTION_LOG_PARAM(BOOL, param.compressible);
+        FUNCTION_LOG_PARAM(BOOL, param.sparse);
+        FUNCTION_LOG_PARAM(UINT64, param.preallocate);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
     ASSERT(this->write);
     // noTruncate does not work with atomic writes because a new file is always created for atomic writes
     ASSERT(!param.noTruncate || param.noAtomic);
+    // Sparse files are written by skipping blocks of zeroes so the file must be empty when the write begins
+    ASSERT(!param.sparse || !param.noTruncate);
 
     StorageWrite *result;
 
@@ -572,7 +576,7 @@ storageNewWrite(const Storage *const this, const String *const fileExp, const St
                 .modePath = param.modePath != 0 ? param.modePath : this->modePath, .user = param.user, .group = param.group,
                 .timeModified = param.timeModified, .createPath = !param.noCreatePath, .syncFile = !param.noSyncFile,
                 .syncPath = !param.noSyncPath, .atomic = !param.noAtomic, .truncate = !param.noTruncate,
-                .compressible = param.compressible),
+                .compressible = param.compressible, .sparse = param.sparse, .preallocate = param.preallocate),
             memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
@@ -180,6 +180,13 @@ typedef struct StorageNewWriteParam
     bool noTruncate;
 
     bool compressible;
+
+    // Skip writing blocks of zeroes so the file is created sparse. Only valid when the file is truncated and written sequentially.
+    bool sparse;
+
+    // Preallocate space for the file so it is not fragmented or sparse (0 for no preallocation)
+    uint64_t preallocate;
+
     mode_t modeFile;
     mode_t modePath;
     time_t timeModified;
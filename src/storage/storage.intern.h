@@ -31,6 +31,7 @@ Error messages
 #define STORAGE_ERROR_READ_CLOSE                                    "unable to close file '%s' after read"
 #define STORAGE_ERROR_READ_OPEN                                     "unable to open file '%s' for read"
 #define STORAGE_ERROR_READ_MISSING                                  "unable to open missing file '%s' for read"
+#define STORAGE_ERROR_READ_CHANGED                                  "unable to read file '%s' because it changed during read"
 #define STORAGE_ERROR_READ_SEEK                                     "unable to seek to %" PRIu64 " in file '%s'"
 
 #define STORAGE_ERROR_INFO                                          "unable to get info for path/file '%s'"
@@ -168,6 +169,12 @@ typedef struct StorageInterfaceNewWriteParam
 
     // Is the file compressible? This is used when the file must be moved across a network and temporary compression is helpful.
     bool compressible;
+
+    // Skip writing blocks of zeroes so the file is created sparse. Storage that does not support sparse files may ignore this.
+    bool sparse;
+
+    // Preallocate space for the file. Storage that does not support preallocation may ignore this.
+    uint64_t preallocate;
 } StorageInterfaceNewWriteParam;
 
 typedef StorageWrite *StorageInterfaceNewWrite(void *thisVoid, const String *file, StorageInterfaceNewWriteParam param);
@@ -4,6 +4,7 @@ Harness for Testing Block Deltas
 #include "build.auto.h"
 
 #include "command/restore/blockDelta.h"
+#include "common/io/bufferRead.h"
 
 #include "common/harnessBlockIncr.h"
 #include "common/harnessDebug.h"
@@ -27,7 +28,8 @@ hrnBlockDeltaRender(const BlockMap *const blockMap, const size_t blockSize, cons
     ASSERT(blockSize > 0);
 
     String *const result = strNew();
-    BlockDelta *const blockDelta = blockDeltaNew(blockMap, blockSize, checksumSize, NULL, cipherTypeNone, NULL, compressTypeNone);
+    BlockDelta *const blockDelta = blockDeltaNew(
+        blockMap, blockSize, checksumSize, NULL, cipherTypeNone, NULL, compressTypeNone, 0);
 
     for (unsigned int readIdx = 0; readIdx < blockDeltaReadSize(blockDelta); readIdx++)
     {
@@ -48,10 +50,114 @@ hrnBlockDeltaRender(const BlockMap *const blockMap, const size_t blockSize, cons
             {
                 const BlockDeltaBlock *const block = lstGet(superBlock->blockList, blockIdx);
 
-                strCatFmt(result, "    block {no: %" PRIu64 ", offset: %" PRIu64 "}\n", block->no, block->offset);
+                strCatFmt(result, "    block {no: %" PRIu64 ", offset: %" PRIu64, block->no, block->offset);
+
+                if (block->size != 0)
+                    strCatFmt(result, ", blockOffset: %" PRIu64 ", size: %" PRIu64, block->blockOffset, block->size);
+
+                strCatZ(result, "}\n");
             }
         }
     }
 
+    for (unsigned int zeroIdx = 0; zeroIdx < blockDeltaZeroSize(blockDelta); zeroIdx++)
+        strCatFmt(result, "zero {offset: %" PRIu64 "}\n", blockDeltaZeroGet(blockDelta, zeroIdx));
+
+    FUNCTION_HARNESS_RETURN(STRING, result);
+}
+
+/**********************************************************************************************************************************/
+Buffer *
+hrnBlockDeltaRestore(
+    const BlockMap *const blockMap, const size_t blockSize, const size_t checksumSize, const Buffer *const *const repoList)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(BLOCK_MAP, blockMap);
+        FUNCTION_HARNESS_PARAM(SIZE, blockSize);
+        FUNCTION_HARNESS_PARAM(SIZE, checksumSize);
+        FUNCTION_HARNESS_PARAM_P(VOID, repoList);
+    FUNCTION_HARNESS_END();
+
+    ASSERT(blockMap != NULL);
+    ASSERT(blockSize > 0);
+    ASSERT(repoList != NULL);
+
+    Buffer *const result = bufNew(0);
+    BlockDelta *const blockDelta = blockDeltaNew(
+        blockMap, blockSize, checksumSize, NULL, cipherTypeNone, NULL, compressTypeNone, 0);
+
+    for (unsigned int readIdx = 0; readIdx < blockDeltaReadSize(blockDelta); readIdx++)
+    {
+        const BlockDeltaRead *const read = blockDeltaReadGet(blockDelta, readIdx);
+        IoRead *const readIo = ioBufferReadNewOpen(
+            BUF(bufPtrConst(repoList[read->reference]) + read->offset, (size_t)read->size));
+        const BlockDeltaWrite *write = blockDeltaNext(blockDelta, read, readIo);
+
+        while (write != NULL)
+        {
+            const size_t size = (size_t)write->offset + bufUsed(write->block);
+
+            if (size > bufSize(result))
+                bufResize(result, size);
+
+            if (size > bufUsed(result))
+                bufUsedSet(result, size);
+
+            memcpy(bufPtr(result) + write->offset, bufPtrConst(write->block), bufUsed(write->block));
+
+            write = blockDeltaNext(blockDelta, read, readIo);
+        }
+    }
+
+    for (unsigned int zeroIdx = 0; zeroIdx < blockDeltaZeroSize(blockDelta); zeroIdx++)
+    {
+        const size_t offset = (size_t)blockDeltaZeroGet(blockDelta, zeroIdx);
+
+        if (offset + blockSize > bufSize(result))
+            bufResize(result, offset + blockSize);
+
+        if (offset + blockSize > bufUsed(result))
+            bufUsedSet(result, offset + blockSize);
+
+        memset(bufPtr(result) + offset, 0, blockSize);
+    }
+
+    FUNCTION_HARNESS_RETURN(BUFFER, result);
+}
+
+/**********************************************************************************************************************************/
+String *
+hrnBlockIndexRender(const BlockIndex *const blockIndex)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(BLOCK_INDEX, blockIndex);
+    FUNCTION_HARNESS_END();
+
+    ASSERT(blockIndex != NULL);
+
+    String *const result = strNew();
+
+    for (unsigned int indexIdx = 0; indexIdx < blockIndexSize(blockIndex); indexIdx++)
+    {
+        const BlockIndexItem *const item = blockIndexGet(blockIndex, indexIdx);
+
+        strCatFmt(
+            result,
+            "{checksum: %s, blockSize: %zu, reference: %u, bundleId: %" PRIu64 ", offset: %" PRIu64 ", size: %" PRIu64
+            ", superBlockSize: %" PRIu64 ", block: %" PRIu64,
+            strZ(strNewEncode(encodingHex, BUF(item->blockMapItem.checksum, 4))), item->blockSize,
+            item->blockMapItem.reference, item->blockMapItem.bundleId, item->blockMapItem.offset, item->blockMapItem.size,
+            item->blockMapItem.superBlockSize, item->blockMapItem.block);
+
+        if (item->blockMapItem.blockSize != 0)
+        {
+            strCatFmt(
+                result, "}\n  variable {blockOffset: %" PRIu64 ", blockSize: %" PRIu64, item->blockMapItem.blockOffset,
+                item->blockMapItem.blockSize);
+        }
+
+        strCatZ(result, "}\n");
+    }
+
     FUNCTION_HARNESS_RETURN(STRING, result);
 }
@@ -4,6 +4,7 @@ Harness for Testing Block Deltas
 #ifndef TEST_COMMON_HARNESS_BLOCK_DELTA_H
 #define TEST_COMMON_HARNESS_BLOCK_DELTA_H
 
+#include "command/backup/blockIndex.h"
 #include "command/backup/blockMap.h"
 
 /***********************************************************************************************************************************
@@ -12,4 +13,11 @@ Functions
 // Render the block delta as text for testing
 String *hrnBlockDeltaRender(const BlockMap *blockMap, size_t blockSize, size_t checksumSize);
 
+// Restore a file from the block delta. The repository list contains the super block list for each reference (without compression or
+// encryption) indexed by reference.
+Buffer *hrnBlockDeltaRestore(const BlockMap *blockMap, size_t blockSize, size_t checksumSize, const Buffer *const *repoList);
+
+// Render the block index as text for testing. Only the first four bytes of the checksum are rendered.
+String *hrnBlockIndexRender(const BlockIndex *blockIndex);
+
 #endif
@@ -54,6 +54,7 @@ Create a pg_control file
             .blcksz = pgControl.pageSize,                                                                                          \
             .xlog_seg_size = pgControl.walSegmentSize,                                                                             \
             .data_checksum_version = pgControl.pageChecksumVersion,                                                                \
+            .wal_log_hints = pgControl.walLogHints,                                                                                \
         };                                                                                                                         \
                                                                                                                                    \
         ((ControlFileData *)buffer)->crc = crc == 0 ? crc32cOne(buffer, offsetof(ControlFileData, crc)) : crc;                     \
@@ -36,6 +36,7 @@ typedef enum
     hrnServerCmdDone,
     hrnServerCmdExpect,
     hrnServerCmdReply,
+    hrnServerCmdSession,
     hrnServerCmdSleep,
 } HrnServerCmd;
 
@@ -43,6 +44,7 @@ typedef enum
 Constants
 ***********************************************************************************************************************************/
 #define HRN_SERVER_HOST                                             "tls.test.pgbackrest.org"
+#define HRN_SERVER_SESSION_MAX                                      4
 
 /***********************************************************************************************************************************
 Local data
@@ -221,6 +223,21 @@ hrnServerScriptReplyZ(IoWrite *write, const char *data)
     FUNCTION_HARNESS_RETURN_VOID();
 }
 
+void
+hrnServerScriptSession(IoWrite *write, unsigned int sessionIdx)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(IO_WRITE, write);
+        FUNCTION_HARNESS_PARAM(UINT, sessionIdx);
+    FUNCTION_HARNESS_END();
+
+    ASSERT(sessionIdx < HRN_SERVER_SESSION_MAX);
+
+    hrnServerScriptCommand(write, hrnServerCmdSession, VARUINT(sessionIdx));
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
+
 void
 hrnServerScriptSleep(IoWrite *write, TimeMSec sleepMs)
 {
@@ -273,7 +290,8 @@ hrnServerRun(IoRead *const read, const HrnServerProtocol protocol, const unsigne
     IoServer *socketServer = sckServerNew(param.address == NULL ? STRDEF("127.0.0.1") : param.address, port, 5000);
 
     // Loop until no more commands
-    IoSession *serverSession = NULL;
+    IoSession *serverSessionList[HRN_SERVER_SESSION_MAX] = {NULL};
+    unsigned int serverSessionIdx = 0;
     bool done = false;
 
     do
@@ -288,31 +306,31 @@ hrnServerRun(IoRead *const read, const HrnServerProtocol protocol, const unsigne
                 // Only makes since to abort in TLS, otherwise it is just a close
                 ASSERT(protocol == hrnServerProtocolTls);
 
-                ioSessionFree(serverSession);
-                serverSession = NULL;
+                ioSessionFree(serverSessionList[serverSessionIdx]);
+                serverSessionList[serverSessionIdx] = NULL;
 
                 break;
             }
 
             case hrnServerCmdAccept:
             {
-                serverSession = ioServerAccept(socketServer, NULL);
+                serverSessionList[serverSessionIdx] = ioServerAccept(socketServer, NULL);
 
                 // Start TLS if requested
                 if (protocol == hrnServerProtocolTls)
-                    serverSession = ioServerAccept(tlsServer, serverSession);
+                    serverSessionList[serverSessionIdx] = ioServerAccept(tlsServer, serverSessionList[serverSessionIdx]);
 
                 break;
             }
 
             case hrnServerCmdClose:
             {
-                if (serverSession == NULL)
+                if (serverSessionList[serverSessionIdx] == NULL)
                     THROW(AssertError, "session is already closed");
 
-                ioSessionClose(serverSession);
-                ioSessionFree(serverSession);
-                serverSession = NULL;
+                ioSessionClose(serverSessionList[serverSessionIdx]);
+                ioSessionFree(serverSessionList[serverSessionIdx]);
+                serverSessionList[serverSessionIdx] = NULL;
 
                 break;
             }
@@ -335,7 +353,7 @@ hrnServerRun(IoRead *const read, const HrnServerProtocol protocol, const unsigne
 
                     for (size_t size = 1; size <= bufSize(buffer); size++)
                     {
-                        ioReadSmall(ioSessionIoReadP(serverSession), bufferOne);
+                        ioReadSmall(ioSessionIoReadP(serverSessionList[serverSessionIdx]), bufferOne);
 
                         bufCat(buffer, bufferOne);
                         bufUsedZero(bufferOne);
@@ -365,8 +383,12 @@ hrnServerRun(IoRead *const read, const HrnServerProtocol protocol, const unsigne
             }
 
             case hrnServerCmdReply:
-                ioWrite(ioSessionIoWrite(serverSession), BUFSTR(varStr(data)));
-                ioWriteFlush(ioSessionIoWrite(serverSession));
+                ioWrite(ioSessionIoWrite(serverSessionList[serverSessionIdx]), BUFSTR(varStr(data)));
+                ioWriteFlush(ioSessionIoWrite(serverSessionList[serverSessionIdx]));
+                break;
+
+            case hrnServerCmdSession:
+                serverSessionIdx = varUIntForce(data);
                 break;
 
             case hrnServerCmdSleep:
@@ -86,6 +86,10 @@ void hrnServerScriptExpectZ(IoWrite *write, const char *data);
 void hrnServerScriptReply(IoWrite *write, const String *data);
 void hrnServerScriptReplyZ(IoWrite *write, const char *data);
 
+// Switch to the specified session. Session zero is used by default. Switching allows the server to accept and reply on more than
+// one connection at a time, e.g. when the client has concurrent requests.
+void hrnServerScriptSession(IoWrite *write, unsigned int sessionIdx);
+
 // Sleep specified milliseconds
 void hrnServerScriptSleep(IoWrite *write, TimeMSec sleepMs);
 
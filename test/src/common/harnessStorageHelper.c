@@ -220,7 +220,7 @@ hrnStorageReadTestNew(
         if (versionId)
             name = strNewFmt("%s/" HRN_STORAGE_TEST_SECRET "/%s/%s", strZ(strPath(name)), strZ(strBase(name)), strZ(versionId));
 
-        StorageRead *const posix = storageReadPosixNew(storage, name, ignoreMissing, offset, limit);
+        StorageRead *const posix = storageReadPosixNew(storage, name, ignoreMissing, offset, limit, false, 0);
 
         // Copy the interface and update with our functions
         StorageReadInterface interface = *storageReadInterface(posix);
@@ -349,7 +349,7 @@ hrnStorageWriteTestNew(
 
         StorageWrite *const posix = storageWritePosixNew(
             storageDriver(storagePosix), name, modeFile, modePath, user, group, timeModified, createPath, false, false, false,
-            truncate);
+            truncate, false, 0, 0);
 
         // Copy the interface and update with our functions
         StorageWriteInterface interface = *storageWriteInterface(posix);
@@ -365,7 +365,7 @@ hrnStorageWriteTestNew(
             .version = storageWriteIo(
                 storageWritePosixNew(
                     storageDriver(storagePosix), hrnStorageTestVersionFind(storagePosix, name), modeFile, modePath, user, group,
-                    timeModified, createPath, false, false, false, truncate)),
+                    timeModified, createPath, false, false, false, truncate, false, 0, 0)),
         };
     }
     OBJ_NEW_END();
@@ -4,8 +4,10 @@ Test Backup Command
 #include "command/stanza/create.h"
 #include "command/stanza/upgrade.h"
 #include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
+#include "postgres/interface/crc32.h"
 #include "postgres/interface/static.vendor.h"
 #include "storage/helper.h"
 #include "storage/posix/storage.h"
@@ -13,6 +15,7 @@ Test Backup Command
 #include "common/harnessBackup.h"
 #include "common/harnessBlockIncr.h"
 #include "common/harnessConfig.h"
+#include "common/harnessInfo.h"
 #include "common/harnessManifest.h"
 #include "common/harnessPack.h"
 #include "common/harnessPostgres.h"
@@ -21,6 +24,23 @@ Test Backup Command
 #include "common/harnessStorage.h"
 #include "common/harnessTime.h"
 
+/***********************************************************************************************************************************
+Check the block map version the same way as versions that predate block map flags
+***********************************************************************************************************************************/
+static void
+testBlockMapVersionLegacy(const Buffer *const map)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(BUFFER, map);
+    FUNCTION_HARNESS_END();
+
+    CHECK(
+        FormatError, (ioReadVarIntU64(ioBufferReadNewOpen(map)) & (1 << blockMapFlagVersion)) == 0,
+        "block map version must be zero");
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Get a list of all files in the backup and a redacted version of the manifest that can be tested against a static string
 ***********************************************************************************************************************************/
@@ -43,7 +63,7 @@ testBackupValidateFile(
     FUNCTION_HARNESS_END();
 
     String *const result = strNew();
-    ManifestFile file = manifestFileUnpack(manifest, *filePack);
+    ManifestFile file = manifestFileUnpackP(manifest, *filePack);
 
     // Output name and size
     // -------------------------------------------------------------------------------------------------------------
@@ -57,6 +77,9 @@ testBackupValidateFile(
     if (file.sizeOriginal != file.size)
         strCatFmt(result, ", so=%" PRIu64, file.sizeOriginal);
 
+    if (file.compressNone)
+        strCatZ(result, ", cmp=f");
+
     // Validate repo checksum
     // -------------------------------------------------------------------------------------------------------------
     if (file.checksumRepoSha1 != NULL)
@@ -104,30 +127,38 @@ testBackupValidateFile(
         {
             const BlockMapItem *const blockMapItem = blockMapGet(blockMap, blockMapIdx);
             const bool superBlockChange =
-                blockMapItemLast == NULL || blockMapItemLast->reference != blockMapItem->reference ||
-                blockMapItemLast->offset != blockMapItem->offset;
+                blockMapItemLast == NULL || blockMapItemLast->zero || blockMapItem->zero ||
+                blockMapItemLast->reference != blockMapItem->reference || blockMapItemLast->offset != blockMapItem->offset;
 
-            if (superBlockChange && blockMapIdx != 0)
+            if (superBlockChange && blockMapIdx != 0 && !blockMapItemLast->zero)
                 strCatChr(mapLog, '}');
 
             if (!strEmpty(mapLog))
                 strCatChr(mapLog, ',');
 
-            if (superBlockChange)
-                strCatFmt(mapLog, "%u:{", blockMapItem->reference);
+            if (blockMapItem->zero)
+                strCatChr(mapLog, 'z');
+            else
+            {
+                if (superBlockChange)
+                    strCatFmt(mapLog, "%u:{", blockMapItem->reference);
 
-            strCatFmt(mapLog, "%" PRIu64, blockMapItem->block);
+                strCatFmt(mapLog, "%" PRIu64, blockMapItem->block);
+            }
 
             blockMapItemLast = blockMapItem;
         }
 
+        if (!blockMapItemLast->zero)
+            strCatChr(mapLog, '}');
+
         // Check blocks
         Buffer *fileBuffer = bufNew((size_t)file.size);
         bufUsedSet(fileBuffer, bufSize(fileBuffer));
 
         BlockDelta *const blockDelta = blockDeltaNew(
             blockMap, file.blockIncrSize, file.blockIncrChecksumSize, NULL, cipherType, cipherPass,
-            manifestData->backupOptionCompressType);
+            manifestData->backupOptionCompressType, 0);
 
         for (unsigned int readIdx = 0; readIdx < blockDeltaReadSize(blockDelta); readIdx++)
         {
@@ -155,7 +186,13 @@ testBackupValidateFile(
             }
         }
 
-        strCatFmt(result, ", m=%s}", strZ(mapLog));
+        for (unsigned int zeroIdx = 0; zeroIdx < blockDeltaZeroSize(blockDelta); zeroIdx++)
+        {
+            size += file.blockIncrSize;
+            memset(bufPtr(fileBuffer) + blockDeltaZeroGet(blockDelta, zeroIdx), 0, file.blockIncrSize);
+        }
+
+        strCatFmt(result, ", m=%s", strZ(mapLog));
 
         checksum = cryptoHashOne(hashTypeSha1, fileBuffer);
     }
@@ -174,11 +211,10 @@ testBackupValidateFile(
                 cipherBlockNewP(cipherModeDecrypt, cipherType, BUFSTR(cipherPass), .raw = raw));
         }
 
-        if (manifestData->backupOptionCompressType != compressTypeNone)
+        if (manifestFileCompressType(manifest, &file) != compressTypeNone)
         {
             ioFilterGroupAdd(
-                ioReadFilterGroup(storageReadIo(read)),
-                decompressFilterP(manifestData->backupOptionCompressType, .raw = raw));
+                ioReadFilterGroup(storageReadIo(read)), decompressFilterP(manifestFileCompressType(manifest, &file), .raw = raw));
         }
 
         ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cryptoHashNew(hashTypeSha1));
@@ -274,9 +310,11 @@ testBackupValidateList(
     {
         const StorageInfo info = storageItrNext(storageItr);
 
-        // Don't include backup.manifest or copy. We'll test that they are present elsewhere
+        // Don't include backup.manifest, copy, or binary manifest. We'll test that they are present elsewhere. Also skip the block
+        // index since it is not in the manifest.
         if (info.type == storageTypeFile &&
-            (strEqZ(info.name, BACKUP_MANIFEST_FILE) || strEqZ(info.name, BACKUP_MANIFEST_FILE INFO_COPY_EXT)))
+            (strEqZ(info.name, BACKUP_MANIFEST_FILE) || strEqZ(info.name, BACKUP_MANIFEST_FILE INFO_COPY_EXT) ||
+             strEqZ(info.name, BACKUP_MANIFEST_PACK_FILE) || strEqZ(info.name, BLOCK_INDEX_FILE)))
         {
             continue;
         }
@@ -309,7 +347,7 @@ testBackupValidateList(
                     for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
                     {
                         ManifestFilePack **const filePack = lstGet(manifest->pub.fileList, fileIdx);
-                        ManifestFile file = manifestFileUnpack(manifest, *filePack);
+                        ManifestFile file = manifestFileUnpackP(manifest, *filePack);
 
                         // File bundle is part of this backup
                         if (file.bundleId == bundleId && file.reference == NULL)
@@ -343,7 +381,7 @@ testBackupValidateList(
                     // Remove this file from manifest file list to track what has been updated
                     ManifestFilePack **const filePack = *(ManifestFilePack ***)lstGet(fileList, fileIdx);
                     const unsigned int manifestFileIdx = strLstFindIdxP(
-                        manifestFileList, (String *const)*filePack, .required = true);
+                        manifestFileList, manifestFileUnpackP(manifest, *filePack).name, .required = true);
                     strLstRemoveIdx(manifestFileList, manifestFileIdx);
 
                     strCat(
@@ -424,7 +462,7 @@ testBackupValidate(const Storage *const storage, const String *const path, const
         const InfoBackup *const infoBackup = infoBackupLoadFile(
             storageRepo(), INFO_BACKUP_PATH_FILE_STR, param.cipherType == 0 ? cipherTypeNone : param.cipherType,
             param.cipherPass == NULL ? NULL : STR(param.cipherPass));
-        Manifest *manifest = manifestLoadFile(
+        Manifest *manifest = manifestLoadFileP(
             storage, strNewFmt("%s/" BACKUP_MANIFEST_FILE, strZ(path)), param.cipherType == 0 ? cipherTypeNone : param.cipherType,
             param.cipherPass == NULL ? NULL : infoBackupCipherPass(infoBackup));
 
@@ -432,7 +470,7 @@ testBackupValidate(const Storage *const storage, const String *const path, const
         StringList *const manifestFileList = strLstNew();
 
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
-            strLstAdd(manifestFileList, manifestFileUnpack(manifest, manifestFilePackGet(manifest, fileIdx)).name);
+            strLstAdd(manifestFileList, manifestFileUnpackP(manifest, manifestFilePackGet(manifest, fileIdx)).name);
 
         // Validate files on disk against the manifest
         const CipherType cipherType = param.cipherType == 0 ? cipherTypeNone : param.cipherType;
@@ -445,7 +483,7 @@ testBackupValidate(const Storage *const storage, const String *const path, const
         {
             ManifestFilePack **const filePack = manifestFilePackFindInternal(
                 manifest, strLstGet(manifestFileList, manifestFileIdx));
-            const ManifestFile file = manifestFileUnpack(manifest, *filePack);
+            const ManifestFile file = manifestFileUnpackP(manifest, *filePack);
 
             // No need to check zero-length files in bundled backups
             if (manifestData(manifest)->bundle && file.size == 0)
@@ -469,19 +507,22 @@ testBackupValidate(const Storage *const storage, const String *const path, const
                     file.sizeRepo, filePack, cipherType, cipherPass));
         }
 
-        // Make sure both backup.manifest files exist since we skipped them in the callback above
+        // Make sure the backup.manifest files exist since we skipped them in the callback above
         if (!storageExistsP(storage, strNewFmt("%s/" BACKUP_MANIFEST_FILE, strZ(path))))
             THROW(AssertError, BACKUP_MANIFEST_FILE " is missing");
 
         if (!storageExistsP(storage, strNewFmt("%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(path))))
             THROW(AssertError, BACKUP_MANIFEST_FILE INFO_COPY_EXT " is missing");
 
+        if (!storageExistsP(storage, strNewFmt("%s/" BACKUP_MANIFEST_PACK_FILE, strZ(path))))
+            THROW(AssertError, BACKUP_MANIFEST_PACK_FILE " is missing");
+
         // Update manifest to make the output a bit simpler
         // -------------------------------------------------------------------------------------------------------------------------
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
         {
             ManifestFilePack **const filePack = lstGet(manifest->pub.fileList, fileIdx);
-            ManifestFile file = manifestFileUnpack(manifest, *filePack);
+            ManifestFile file = manifestFileUnpackP(manifest, *filePack);
 
             // If compressed or block incremental then set the repo-size to size so it will not be in test output. Even the same
             // compression algorithm can give slightly different results based on the version so repo-size is not deterministic for
@@ -549,6 +590,48 @@ testBackupValidate(const Storage *const storage, const String *const path, const
     FUNCTION_HARNESS_RETURN(STRING, result);
 }
 
+/***********************************************************************************************************************************
+Fill a page and give it a valid header with the specified lsn
+***********************************************************************************************************************************/
+static void
+testPageLsnPut(Buffer *const buffer, const size_t pageSize, const unsigned int pageNo, const uint64_t lsn, const uint8_t fill)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(BUFFER, buffer);
+        FUNCTION_HARNESS_PARAM(SIZE, pageSize);
+        FUNCTION_HARNESS_PARAM(UINT, pageNo);
+        FUNCTION_HARNESS_PARAM(UINT64, lsn);
+        FUNCTION_HARNESS_PARAM(UINT, fill);
+    FUNCTION_HARNESS_END();
+
+    memset(bufPtr(buffer) + pageNo * pageSize, fill, pageSize);
+
+    *(PageHeaderData *)(bufPtr(buffer) + pageNo * pageSize) = (PageHeaderData)
+    {
+        .pd_lsn = {.xlogid = (uint32_t)(lsn >> 32), .xrecoff = (uint32_t)lsn},
+        .pd_lower = (LocationIndex)offsetof(PageHeaderData, pd_linp),
+        .pd_upper = (LocationIndex)pageSize,
+        .pd_special = (LocationIndex)pageSize,
+        .pd_pagesize_version = (uint16_t)(pageSize | 4),
+    };
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Find block index items that are not in the specified bundle
+***********************************************************************************************************************************/
+static bool
+testBlockIndexFindCallback(void *const data, const BlockIndexItem *const item)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM_P(VOID, data);
+        FUNCTION_HARNESS_PARAM_P(VOID, item);
+    FUNCTION_HARNESS_END();
+
+    FUNCTION_HARNESS_RETURN(BOOL, item->blockMapItem.bundleId != *(const uint64_t *)data);
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -728,6 +811,84 @@ testRun(void)
             "2:bool:true, 3:bool:true", "valid on retry");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("CompressAdaptive"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressible input is compressed");
+
+        Buffer *source = bufNew(256);
+        memset(bufPtr(source), 'A', bufSize(source));
+        bufUsedSet(source, bufSize(source));
+
+        Buffer *destination = bufNew(256);
+        IoWrite *write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                compressAdaptiveNewPack(ioFilterParamList(compressAdaptiveNew(compressTypeGz, 1, false, 0)))),
+            "adaptive compress");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_RESULT_STR_Z(
+            hrnPackToStr(ioFilterGroupResultPackP(ioWriteFilterGroup(write), COMPRESS_ADAPTIVE_FILTER_TYPE)), "1:bool:true",
+            "compressed");
+        TEST_RESULT_BOOL(bufUsed(destination) < bufUsed(source), true, "smaller");
+
+        IoRead *read = ioBufferReadNew(destination);
+        ioFilterGroupAdd(ioReadFilterGroup(read), decompressFilterP(compressTypeGz));
+        ioReadOpen(read);
+        TEST_RESULT_BOOL(bufEq(ioReadBuf(read), source), true, "decompress");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("empty input is compressed");
+
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), compressAdaptiveNew(compressTypeGz, 1, true, 0)), "adaptive compress");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_RESULT_STR_Z(
+            hrnPackToStr(ioFilterGroupResultPackP(ioWriteFilterGroup(write), COMPRESS_ADAPTIVE_FILTER_TYPE)), "1:bool:true",
+            "compressed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("incompressible input is passed through");
+
+        ioBufferSizeSet(16);
+
+        uint32_t seed = 0x12345678;
+
+        for (size_t byteIdx = 0; byteIdx < bufSize(source); byteIdx++)
+        {
+            seed = seed * 1103515245 + 12345;
+            bufPtr(source)[byteIdx] = (unsigned char)(seed >> 24);
+        }
+
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), compressAdaptiveNew(compressTypeGz, 1, true, 0)), "adaptive compress");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWrite(write, BUFSTRDEF("END")), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_RESULT_STR_Z(
+            hrnPackToStr(ioFilterGroupResultPackP(ioWriteFilterGroup(write), COMPRESS_ADAPTIVE_FILTER_TYPE)), "1:bool:false",
+            "not compressed");
+
+        bufCat(source, BUFSTRDEF("END"));
+        TEST_RESULT_BOOL(bufEq(destination, source), true, "unmodified");
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("segmentNumber()"))
     {
@@ -855,6 +1016,8 @@ testRun(void)
             "eeee88ffff",                               // checksum
             "compare");
 
+        TEST_RESULT_VOID(testBlockMapVersionLegacy(buffer), "map without flags is readable by older versions");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("read equal block map");
 
@@ -1087,1496 +1250,3960 @@ testRun(void)
             "  super block {max: 2, size: 6}\n"
             "    block {no: 0, offset: 21}\n",
             "check delta");
-    }
 
-    // *****************************************************************************************************************************
-    if (testBegin("BlockIncr"))
-    {
-        TEST_TITLE("block incremental config map");
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("build variable block map");
 
-        TEST_ERROR(
-            backupBlockIncrMapSize(cfgOptRepoBlockSizeMap, 0, STRDEF("0")), OptionInvalidValueError,
-            "'0' is not valid for 'repo1-block-size-map' option");
-        TEST_ERROR(
-            backupBlockIncrMapSize(cfgOptRepoBlockSizeMap, 0, STRDEF("Z")), OptionInvalidValueError,
-            "'Z' is not valid for 'repo1-block-size-map' option");
-        TEST_ERROR(
-            backupBlockIncrMapSize(cfgOptRepoBlockSizeMap, 0, STRDEF("5GiB")), OptionInvalidValueError,
-            "'5GiB' is not valid for 'repo1-block-size-map' option");
-        TEST_ERROR(
-            backupBlockIncrMapChecksumSize(cfgOptRepoBlockChecksumSizeMap, 0, VARSTRDEF("Z")), OptionInvalidValueError,
-            "'Z' is not valid for 'repo1-block-checksum-size-map' option");
-        TEST_ERROR(
-            backupBlockIncrMapChecksumSize(cfgOptRepoBlockChecksumSizeMap, 0, VARSTRDEF("5")), OptionInvalidValueError,
-            "'5' is not valid for 'repo1-block-checksum-size-map' option");
+        TEST_ASSIGN(blockMap, blockMapNew(), "new");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("full backup with zero block");
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 0,
+            .superBlockSize = 16,
+            .offset = 0,
+            .size = 10,
+            .block = 0,
+            .blockOffset = 0,
+            .blockSize = 3,
+            .checksum = {0xee, 0xee, 0x01, 0, 0, 0, 0xff, 0xff},
+        };
 
-        ioBufferSizeSet(2);
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        const Buffer *source = BUFSTRZ("");
-        Buffer *destination = bufNew(256);
-        IoWrite *write = ioBufferWriteNew(destination);
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 0,
+            .superBlockSize = 16,
+            .offset = 0,
+            .size = 10,
+            .block = 1,
+            .blockOffset = 3,
+            .blockSize = 4,
+            .checksum = {0xee, 0xee, 0x02, 0, 0, 0, 0xff, 0xff},
+        };
 
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 6, 0, 0, 0, NULL, NULL, NULL)), "block incr");
-        TEST_RESULT_VOID(ioWriteOpen(write), "open");
-        TEST_RESULT_VOID(ioWrite(write, source), "write");
-        TEST_RESULT_VOID(ioWriteClose(write), "close");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        TEST_RESULT_UINT(pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), 0, "compare");
-        TEST_RESULT_STR_Z(strNewEncode(encodingHex, destination), "", "compare");
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 0,
+            .superBlockSize = 16,
+            .offset = 0,
+            .size = 10,
+            .block = 3,
+            .blockOffset = 9,
+            .blockSize = 2,
+            .checksum = {0xee, 0xee, 0x03, 0, 0, 0, 0xff, 0xff},
+        };
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("full backup with partial block");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        source = BUFSTRZ("12");
-        destination = bufNew(256);
-        write = ioBufferWriteNew(destination);
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 0,
+            .superBlockSize = 16,
+            .offset = 20,
+            .size = 5,
+            .block = 0,
+            .blockOffset = 0,
+            .blockSize = 5,
+            .checksum = {0xee, 0xee, 0x04, 0, 0, 0, 0xff, 0xff},
+        };
 
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, 0, 0, 0, NULL, NULL, NULL)), "block incr");
-        TEST_RESULT_VOID(ioWriteOpen(write), "open");
-        TEST_RESULT_VOID(ioWrite(write, source), "write");
-        TEST_RESULT_VOID(ioWriteClose(write), "close");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        uint64_t mapSize;
-        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
-        TEST_RESULT_UINT(mapSize, 13, "map size");
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 0,
+            .superBlockSize = 16,
+            .offset = 25,
+            .size = 6,
+            .block = 0,
+            .blockOffset = 0,
+            .blockSize = 6,
+            .checksum = {0xee, 0xee, 0x05, 0, 0, 0, 0xff, 0xff},
+        };
 
-        TEST_RESULT_STR_Z(
-            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
-            "3132",                                     // block 0
-            "block list");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        const Buffer *map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .superBlockSize = 16,
+            .offset = 0,
+            .size = 7,
+            .block = 0,
+            .blockOffset = 0,
+            .blockSize = 7,
+            .checksum = {0xee, 0xee, 0x06, 0, 0, 0, 0xff, 0xff},
+        };
 
-        TEST_RESULT_STR_Z(
-            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
-            "read {reference: 0, bundleId: 0, offset: 0, size: 2}\n"
-            "  super block {max: 2, size: 2}\n"
-            "    block {no: 0, offset: 0}\n",
-            "check delta");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("full backup");
+        TEST_TITLE("write variable block map");
 
-        source = BUFSTRZ("ABCXYZ123");
-        destination = bufNew(256);
-        write = ioBufferWriteNew(destination);
+        buffer = bufNew(256);
+        write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockMapWrite(blockMap, write, 4, 8), "save");
+        ioWriteClose(write);
 
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(
-                ioWriteFilterGroup(write),
-                blockIncrNewPack(ioFilterParamList(blockIncrNew(2, 3, 8, 2, 4, 5, NULL, NULL, NULL)))),
-            "block incr");
-        TEST_RESULT_VOID(ioWriteOpen(write), "open");
-        TEST_RESULT_VOID(ioWrite(write, source), "write");
-        TEST_RESULT_VOID(ioWriteClose(write), "close");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, buffer),
+            "03"                                        // Version 1, variable
 
-        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
-        TEST_RESULT_UINT(mapSize, 31, "map size");
+            "00"                                        // reference 0
+            "57"                                        // size 10
+            "08"                                        // super block size 16
+            "02"                                        // block total 2
+            "00"                                        // block offset 0
+            "eeee01000000ffff"                          // checksum
+            "03"                                        // block size 3
+            "eeee02000000ffff"                          // checksum
+            "04"                                        // block size 4
 
-        TEST_RESULT_STR_Z(
-            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
-            "414243"                                      // block 0
-            "58595a"                                      // block 1
-            "313233",                                     // block 2
-            "block list");
+            "06"                                        // reference 0 (continue)
+            "01"                                        // block total 1
+            "01"                                        // block 3
+            "09"                                        // block offset 9
+            "eeee03000000ffff"                          // checksum
+            "02"                                        // block size 2
 
-        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+            "04"                                        // reference 0
+            "0a"                                        // offset 20
+            "4c"                                        // size 5
+            "00"                                        // block total 1
+            "00"                                        // block offset 0
+            "eeee04000000ffff"                          // checksum
+            "05"                                        // block size 5
 
-        TEST_RESULT_STR_Z(
-            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
-            "read {reference: 2, bundleId: 4, offset: 5, size: 9}\n"
-            "  super block {max: 3, size: 3}\n"
-            "    block {no: 0, offset: 0}\n"
-            "  super block {max: 3, size: 3}\n"
-            "    block {no: 0, offset: 3}\n"
-            "  super block {max: 3, size: 3}\n"
-            "    block {no: 0, offset: 6}\n",
-            "check delta");
+            "15"                                        // size 6
+            "00"                                        // block total 1
+            "00"                                        // block offset 0
+            "eeee05000000ffff"                          // checksum
+            "06"                                        // block size 6
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("diff/incr backup");
+            "09"                                        // reference 1
+            "17"                                        // size 7
+            "08"                                        // super block size 16
+            "00"                                        // block total 1
+            "00"                                        // block offset 0
+            "eeee06000000ffff"                          // checksum
+            "07",                                       // block size 7
+            "compare");
 
-        ioBufferSizeSet(3);
+        TEST_ERROR(testBlockMapVersionLegacy(buffer), FormatError, "block map version must be zero");
 
-        source = BUFSTRZ("ACCXYZ123@");
-        destination = bufNew(256);
-        write = ioBufferWriteNew(destination);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read variable block map");
 
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(
-                ioWriteFilterGroup(write), blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, 3, 0, 0, map, NULL, NULL)))),
-            "block incr");
-        TEST_RESULT_VOID(ioWriteOpen(write), "open");
-        TEST_RESULT_VOID(ioWrite(write, source), "write");
-        TEST_RESULT_VOID(ioWriteClose(write), "close");
-
-        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
-        TEST_RESULT_UINT(mapSize, 44, "map size");
+        bufferCompare = bufNew(256);
+        write = ioBufferWriteNewOpen(bufferCompare);
+        TEST_RESULT_VOID(blockMapWrite(blockMapNewRead(ioBufferReadNewOpen(buffer), 4, 8), write, 4, 8), "read and save");
+        ioWriteClose(write);
 
-        TEST_RESULT_STR_Z(
-            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
-            "414343"                                    // block 0
-            "40",                                       // block 3
-            "block list");
+        TEST_RESULT_STR(strNewEncode(encodingHex, bufferCompare), strNewEncode(encodingHex, buffer), "compare");
 
-        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("variable block delta");
 
         TEST_RESULT_STR_Z(
-            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
-            "read {reference: 3, bundleId: 0, offset: 0, size: 4}\n"
-            "  super block {max: 3, size: 3}\n"
-            "    block {no: 0, offset: 0}\n"
-            "  super block {max: 1, size: 1}\n"
-            "    block {no: 0, offset: 9}\n"
-            "read {reference: 2, bundleId: 4, offset: 8, size: 6}\n"
-            "  super block {max: 3, size: 3}\n"
-            "    block {no: 0, offset: 3}\n"
-            "  super block {max: 3, size: 3}\n"
-            "    block {no: 0, offset: 6}\n",
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(buffer), 4, 8), 4, 8),
+            "read {reference: 1, bundleId: 0, offset: 0, size: 7}\n"
+            "  super block {max: 16, size: 7}\n"
+            "    block {no: 0, offset: 20, blockOffset: 0, size: 7}\n"
+            "read {reference: 0, bundleId: 0, offset: 0, size: 10}\n"
+            "  super block {max: 16, size: 10}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 3, blockOffset: 3, size: 4}\n"
+            "    block {no: 3, offset: 7, blockOffset: 9, size: 2}\n"
+            "read {reference: 0, bundleId: 0, offset: 20, size: 11}\n"
+            "  super block {max: 16, size: 5}\n"
+            "    block {no: 0, offset: 9, blockOffset: 0, size: 5}\n"
+            "  super block {max: 16, size: 6}\n"
+            "    block {no: 0, offset: 14, blockOffset: 0, size: 6}\n",
             "check delta");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("diff/incr backup with identical data");
+        TEST_TITLE("build bundle block map");
 
-        ioBufferSizeSet(3);
+        TEST_ASSIGN(blockMap, blockMapNew(), "new");
 
-        source = BUFSTRZ("ACCXYZ123@");
-        destination = bufNew(256);
-        write = ioBufferWriteNew(destination);
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .superBlockSize = 1,
+            .bundleId = 1,
+            .offset = 0,
+            .size = 3,
+            .checksum = {0xee, 0xee, 0x01, 0xff, 0xff},
+        };
 
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(
-                ioWriteFilterGroup(write), blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, 3, 0, 0, map, NULL, NULL)))),
-            "block incr");
-        TEST_RESULT_VOID(ioWriteOpen(write), "open");
-        TEST_RESULT_VOID(ioWrite(write, source), "write");
-        TEST_RESULT_VOID(ioWriteClose(write), "close");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
-        TEST_RESULT_UINT(mapSize, 0, "map size is zero");
-        TEST_RESULT_UINT(bufUsed(destination), 0, "repo size is zero");
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .superBlockSize = 1,
+            .bundleId = 2,
+            .offset = 5,
+            .size = 4,
+            .checksum = {0xee, 0xee, 0x02, 0xff, 0xff},
+        };
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("full backup with larger super block");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        ioBufferSizeSet(2);
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 0,
+            .superBlockSize = 1,
+            .bundleId = 3,
+            .offset = 0,
+            .size = 2,
+            .checksum = {0xee, 0xee, 0x03, 0xff, 0xff},
+        };
 
-        source = BUFSTRZ("ABCXYZ123");
-        destination = bufNew(256);
-        write = ioBufferWriteNew(destination);
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
 
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
-        TEST_RESULT_VOID(
-            ioFilterGroupAdd(
-                ioWriteFilterGroup(write), blockIncrNewPack(ioFilterParamList(blockIncrNew(6, 3, 8, 2, 4, 5, NULL, NULL, NULL)))),
-            "block incr");
-        TEST_RESULT_VOID(ioWriteOpen(write), "open");
-        TEST_RESULT_VOID(ioWrite(write, source), "write");
-        TEST_RESULT_VOID(ioWriteClose(write), "close");
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .superBlockSize = 1,
+            .bundleId = 1,
+            .offset = 3,
+            .size = 6,
+            .checksum = {0xee, 0xee, 0x04, 0xff, 0xff},
+        };
 
-        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
-        TEST_RESULT_UINT(mapSize, 32, "map size");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
+
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .superBlockSize = 1,
+            .bundleId = 2,
+            .offset = 20,
+            .size = 1,
+            .checksum = {0xee, 0xee, 0x05, 0xff, 0xff},
+        };
+
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write bundle block map");
+
+        buffer = bufNew(256);
+        write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockMapWrite(blockMap, write, 1, 5), "save");
+        ioWriteClose(write);
 
         TEST_RESULT_STR_Z(
-            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
-            "414243"                                    // super block 0 / block 0
-            "58595a"                                    // super block 0 / block 1
-            "313233",                                   // block 2
-            "block list");
+            strNewEncode(encodingHex, buffer),
+            "05"                                        // Version 1, bundle
 
-        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+            "08"                                        // reference 1
+            "01"                                        // bundle 1
+            "19"                                        // size 3
+            "eeee01ffff"                                // checksum
+
+            "0c"                                        // reference 1
+            "02"                                        // bundle 2
+            "05"                                        // offset 5
+            "11"                                        // size 4
+            "eeee02ffff"                                // checksum
+
+            "00"                                        // reference 0
+            "03"                                        // bundle 3
+            "19"                                        // size 2
+            "eeee03ffff"                                // checksum
+
+            "08"                                        // reference 1
+            "01"                                        // bundle 1
+            "41"                                        // size 6
+            "eeee04ffff"                                // checksum
+
+            "0d"                                        // reference 1
+            "02"                                        // bundle 2
+            "0b"                                        // offset 20
+            "49"                                        // size 1
+            "eeee05ffff",                               // checksum
+            "compare");
+
+        TEST_ERROR(testBlockMapVersionLegacy(buffer), FormatError, "block map version must be zero");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read bundle block map");
+
+        bufferCompare = bufNew(256);
+        write = ioBufferWriteNewOpen(bufferCompare);
+        TEST_RESULT_VOID(blockMapWrite(blockMapNewRead(ioBufferReadNewOpen(buffer), 1, 5), write, 1, 5), "read and save");
+        ioWriteClose(write);
+
+        TEST_RESULT_STR(strNewEncode(encodingHex, bufferCompare), strNewEncode(encodingHex, buffer), "compare");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle block delta");
 
         TEST_RESULT_STR_Z(
-            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
-            "read {reference: 2, bundleId: 4, offset: 5, size: 9}\n"
-            "  super block {max: 6, size: 6}\n"
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(buffer), 1, 5), 1, 5),
+            "read {reference: 1, bundleId: 2, offset: 5, size: 4}\n"
+            "  super block {max: 1, size: 4}\n"
+            "    block {no: 0, offset: 1}\n"
+            "read {reference: 1, bundleId: 2, offset: 20, size: 1}\n"
+            "  super block {max: 1, size: 1}\n"
+            "    block {no: 0, offset: 4}\n"
+            "read {reference: 1, bundleId: 1, offset: 0, size: 9}\n"
+            "  super block {max: 1, size: 3}\n"
             "    block {no: 0, offset: 0}\n"
-            "    block {no: 1, offset: 3}\n"
-            "  super block {max: 3, size: 3}\n"
-            "    block {no: 0, offset: 6}\n",
+            "  super block {max: 1, size: 6}\n"
+            "    block {no: 0, offset: 3}\n"
+            "read {reference: 0, bundleId: 3, offset: 0, size: 2}\n"
+            "  super block {max: 1, size: 2}\n"
+            "    block {no: 0, offset: 2}\n",
             "check delta");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("new filter from pack");
+        TEST_TITLE("build zero block map");
 
-        TEST_RESULT_VOID(
-            blockIncrNewPack(
-                ioFilterParamList(
-                    blockIncrNew(
-                        3, 3, 8, 2, 4, 5, NULL, compressFilterP(compressTypeGz, 1, .raw = true),
-                        cipherBlockNewP(cipherModeEncrypt, cipherTypeAes256Cbc, BUFSTRDEF(TEST_CIPHER_PASS), .raw = true)))),
-            "block incr pack");
-    }
+        TEST_ASSIGN(blockMap, blockMapNew(), "new");
 
-    // *****************************************************************************************************************************
-    if (testBegin("backupLabelCreate()"))
-    {
-        StringList *argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .superBlockSize = 1,
+            .offset = 0,
+            .size = 3,
+            .checksum = {0xee, 0xee, 0x01, 0xff, 0xff},
+        };
 
-        time_t timestamp = 1575401652;
-        String *backupLabel = backupLabelFormat(backupTypeFull, NULL, timestamp);
-        const String *const olderBackupLabel = backupLabelFormat(backupTypeFull, NULL, timestamp - 3);
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &(BlockMapItem){.zero = true}), "add zero");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &(BlockMapItem){.zero = true}), "add zero");
+
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .superBlockSize = 1,
+            .offset = 3,
+            .size = 2,
+            .checksum = {0xee, 0xee, 0x02, 0xff, 0xff},
+        };
+
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &(BlockMapItem){.zero = true}), "add zero");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("assign label when no history");
+        TEST_TITLE("write zero block map");
 
-        HRN_STORAGE_PATH_CREATE(storageRepoWrite(), STORAGE_REPO_BACKUP "/backup.history/2019");
+        buffer = bufNew(256);
+        write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockMapWrite(blockMap, write, 1, 5), "save");
+        ioWriteClose(write);
 
-        TEST_RESULT_STR(backupLabelCreate(backupTypeFull, NULL, timestamp), backupLabel, "create label");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, buffer),
+            "09"                                        // Version 1, zero runs
+            "02"                                        // zero run total
+            "01"                                        // zero run start 1
+            "01"                                        // zero run size 2
+            "01"                                        // zero run start 4
+            "00"                                        // zero run size 1
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("assign label when history is older");
+            "09"                                        // reference 1
+            "18"                                        // size 3
+            "eeee01ffff"                                // checksum
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(),
-            zNewFmt(
-                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
-                strZ(backupLabelFormat(backupTypeFull, NULL, timestamp - 4))));
+            "09"                                        // size 2
+            "eeee02ffff",                               // checksum
+            "compare");
 
-        TEST_RESULT_STR(backupLabelCreate(backupTypeFull, NULL, timestamp), backupLabel, "create label");
+        TEST_ERROR(testBlockMapVersionLegacy(buffer), FormatError, "block map version must be zero");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("assign label when backup is older");
+        TEST_TITLE("read zero block map");
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(olderBackupLabel)));
+        bufferCompare = bufNew(256);
+        write = ioBufferWriteNewOpen(bufferCompare);
+        TEST_RESULT_VOID(blockMapWrite(blockMapNewRead(ioBufferReadNewOpen(buffer), 1, 5), write, 1, 5), "read and save");
+        ioWriteClose(write);
 
-        TEST_RESULT_STR(backupLabelCreate(backupTypeFull, NULL, timestamp), backupLabel, "create label");
+        TEST_RESULT_STR(strNewEncode(encodingHex, bufferCompare), strNewEncode(encodingHex, buffer), "compare");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (full only)");
+        TEST_TITLE("zero block delta");
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(),
-            zNewFmt(
-                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
-                strZ(backupLabelFormat(backupTypeFull, NULL, timestamp - 1))));
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(buffer), 1, 5), 1, 5),
+            "read {reference: 1, bundleId: 0, offset: 0, size: 5}\n"
+            "  super block {max: 1, size: 3}\n"
+            "    block {no: 0, offset: 0}\n"
+            "  super block {max: 1, size: 2}\n"
+            "    block {no: 0, offset: 3}\n"
+            "zero {offset: 1}\n"
+            "zero {offset: 2}\n"
+            "zero {offset: 4}\n",
+            "check delta");
 
-        TEST_RESULT_STR(
-            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp),
-            backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp),
-            "create label");
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("zero block runs out of order");
 
-        TEST_RESULT_STR(
-            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp),
-            backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp),
-            "create label");
+        TEST_ERROR(
+            blockMapNewRead(ioBufferReadNewOpen(bufNewDecode(encodingHex, STRDEF("090105000119eeee01ffff"))), 1, 5), FormatError,
+            "block map zero runs are out of order");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (diff exists)");
+        TEST_TITLE("flags without version");
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(),
-            zNewFmt(
-                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
-                strZ(backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp - 2))));
-
-        TEST_RESULT_STR(
-            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp),
-            backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp),
-            "create label");
-
-        TEST_RESULT_STR(
-            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp),
-            backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp),
-            "create label");
+        TEST_ERROR(
+            blockMapNewRead(ioBufferReadNewOpen(bufNewDecode(encodingHex, STRDEF("080105000119eeee01ffff"))), 1, 5), FormatError,
+            "block map version must be set for flags");
+    }
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (diff and incr)");
+    // *****************************************************************************************************************************
+    if (testBegin("BlockIndex"))
+    {
+        TEST_TITLE("build block index");
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(),
-            zNewFmt(
-                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
-                strZ(backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp - 1))));
+        BlockIndex *blockIndex = NULL;
+        TEST_ASSIGN(blockIndex, blockIndexNew(), "new");
 
-        TEST_RESULT_STR(
-            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp),
-            backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp),
-            "create label");
+        uint64_t bundleIdSkip = 0;
 
-        TEST_RESULT_STR(
-            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp),
-            backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp),
-            "create label");
+        TEST_RESULT_PTR(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip),
+            NULL, "not found in empty index");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (skew)");
+        BlockIndexItem blockIndexItem =
+        {
+            .blockSize = 8,
+            .blockMapItem =
+            {
+                .reference = 1,
+                .superBlockSize = 16,
+                .bundleId = 2,
+                .offset = 3,
+                .size = 4,
+                .block = 1,
+                .checksum = {0xee, 0x03},
+            },
+        };
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(),
-            zNewFmt(
-                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
-                strZ(backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp + 3))));
+        TEST_RESULT_UINT(blockIndexAdd(blockIndex, &blockIndexItem)->blockSize, 8, "add");
 
-        TEST_ERROR(
-            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp), ClockError,
-            "new backup label '20191203-193409F_20191203-193413D' is not later "
-            "than latest backup label '20191203-193409F_20191203-193415I'\n"
-            "HINT: has the timezone changed?\n"
-            "HINT: is there clock skew?");
+        blockIndexItem = (BlockIndexItem)
+        {
+            .blockSize = 4,
+            .blockMapItem =
+            {
+                .reference = 1,
+                .superBlockSize = 8,
+                .bundleId = 5,
+                .offset = 200,
+                .size = 7,
+                .blockOffset = 2,
+                .blockSize = 3,
+                .checksum = {0xee, 0x01},
+            },
+        };
 
-        TEST_ERROR(
-            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp), ClockError,
-            "new backup label '20191203-193409F_20191203-193413I' is not later "
-            "than latest backup label '20191203-193409F_20191203-193415I'\n"
-            "HINT: has the timezone changed?\n"
-            "HINT: is there clock skew?");
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, &blockIndexItem), "add");
+        TEST_RESULT_VOID(blockIndexSort(blockIndex), "sort");
+        TEST_RESULT_UINT(blockIndexGet(blockIndex, 0)->blockMapItem.bundleId, 5, "get");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("advance time when backup is same");
-
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(backupLabelFormat(backupTypeFull, NULL, timestamp))));
+        TEST_TITLE("find blocks");
 
-        TEST_RESULT_STR_Z(backupLabelCreate(backupTypeFull, NULL, timestamp), "20191203-193413F", "create label");
+        TEST_RESULT_UINT(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip)->blockMapItem.bundleId,
+            2, "found");
+        TEST_RESULT_PTR(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip),
+            NULL, "not found");
+        TEST_RESULT_PTR(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x04, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip),
+            NULL, "not found after last");
+
+        bundleIdSkip = 2;
+
+        TEST_RESULT_PTR(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip),
+            NULL, "skipped by callback");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("error when new label is in the past even with advanced time");
+        TEST_TITLE("write block index");
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(backupLabelFormat(backupTypeFull, NULL, timestamp + 1))));
+        Buffer *buffer = bufNew(256);
+        IoWrite *write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockIndexWrite(blockIndex, write), "save");
+        ioWriteClose(write);
 
-        TEST_ERROR(
-            backupLabelCreate(backupTypeFull, NULL, timestamp), ClockError,
-            "new backup label '20191203-193413F' is not later than latest backup label '20191203-193413F'\n"
-            "HINT: has the timezone changed?\n"
-            "HINT: is there clock skew?");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, buffer),
+            "00"                                        // Version 0
+            "02"                                        // Total 2
+
+            "ee010000000000000000000000000000"          // checksum
+            "09"                                        // block size 4, variable
+            "05"                                        // bundle id 5
+            "c801"                                      // offset 200
+            "07"                                        // size 7
+            "08"                                        // super block size 8
+            "00"                                        // block 0
+            "02"                                        // block offset 2
+            "03"                                        // block size 3
+
+            "ee030000000000000000000000000000"          // checksum
+            "10"                                        // block size 8
+            "02"                                        // bundle id 2
+            "03"                                        // offset 3
+            "04"                                        // size 4
+            "10"                                        // super block size 16
+            "01",                                       // block 1
+            "compare");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("error when new label is in the past even with advanced time (from history)");
+        TEST_TITLE("read block index");
 
-        HRN_STORAGE_PUT_EMPTY(
-            storageRepoWrite(),
-            zNewFmt(
-                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
-                strZ(backupLabelFormat(backupTypeFull, NULL, timestamp + 3600))));
+        TEST_ASSIGN(blockIndex, blockIndexNew(), "new");
+        TEST_RESULT_VOID(blockIndexRead(blockIndex, ioBufferReadNewOpen(buffer), 7), "read");
+        TEST_RESULT_STR_Z(
+            hrnBlockIndexRender(blockIndex),
+            "{checksum: ee010000, blockSize: 4, reference: 7, bundleId: 5, offset: 200, size: 7, superBlockSize: 8, block: 0}\n"
+            "  variable {blockOffset: 2, blockSize: 3}\n"
+            "{checksum: ee030000, blockSize: 8, reference: 7, bundleId: 2, offset: 3, size: 4, superBlockSize: 16, block: 1}\n",
+            "check index");
 
         TEST_ERROR(
-            backupLabelCreate(backupTypeFull, NULL, timestamp), ClockError,
-            "new backup label '20191203-193413F' is not later than latest backup label '20191203-203412F'\n"
-            "HINT: has the timezone changed?\n"
-            "HINT: is there clock skew?");
-    }
+            blockIndexRead(blockIndex, ioBufferReadNewOpen(BUFSTRDEF("\001")), 0), FormatError, "block index version must be zero");
 
-    // *****************************************************************************************************************************
-    if (testBegin("backupInit()"))
-    {
-        // Set log level to detail
-        harnessLogLevelSet(logLevelDetail);
+        TEST_RESULT_VOID(blockIndexFree(blockIndex), "free");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("warn and reset when backup from standby used in offline mode");
+        TEST_TITLE("write map files");
 
-        // Create pg_control
-        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_96);
-
-        StringList *argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptBackupStandby, true);
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        TEST_ASSIGN(blockIndex, blockIndexNew(), "new");
+        TEST_RESULT_VOID(blockIndexRead(blockIndex, ioBufferReadNewOpen(buffer), 1), "read");
+        TEST_RESULT_VOID(blockIndexSort(blockIndex), "sort");
 
-        TEST_RESULT_VOID(
-            backupInit(infoBackupNew(PG_VERSION_96, HRN_PG_SYSTEMID_96, hrnPgCatalogVersion(PG_VERSION_96), NULL)), "backup init");
+        StorageWrite *storageWrite = storageNewWriteP(storageTest, STRDEF("map/1"));
+        ioWriteOpen(storageWriteIo(storageWrite));
+        TEST_RESULT_VOID(blockIndexMapWrite(blockIndex, storageWriteIo(storageWrite)), "write map 1");
+        ioWriteClose(storageWriteIo(storageWrite));
 
-        TEST_RESULT_LOG(
-            "P00   WARN: option backup-standby is enabled but backup is offline - backups will be performed from the primary");
+        blockIndexItem.blockMapItem.bundleId = 6;
+        blockIndexItem.blockMapItem.checksum[1] = 0x03;
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("error when pg_control does not match stanza");
+        TEST_ASSIGN(blockIndex, blockIndexNew(), "new");
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, &blockIndexItem), "add");
 
-        // Create pg_control
-        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_10);
+        storageWrite = storageNewWriteP(storageTest, STRDEF("map/2"));
+        ioWriteOpen(storageWriteIo(storageWrite));
+        TEST_RESULT_VOID(blockIndexMapWrite(blockIndex, storageWriteIo(storageWrite)), "write map 2");
+        ioWriteClose(storageWriteIo(storageWrite));
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("map files");
 
-        TEST_ERROR(
-            backupInit(infoBackupNew(PG_VERSION_11, HRN_PG_SYSTEMID_11, hrnPgCatalogVersion(PG_VERSION_11), NULL)),
-            BackupMismatchError,
-            "PostgreSQL version 10, system-id " HRN_PG_SYSTEMID_10_Z " do not match stanza version 11, system-id"
-            " " HRN_PG_SYSTEMID_11_Z "\n"
-            "HINT: is this the correct stanza?");
-        TEST_ERROR(
-            backupInit(infoBackupNew(PG_VERSION_10, HRN_PG_SYSTEMID_11, hrnPgCatalogVersion(PG_VERSION_10), NULL)),
-            BackupMismatchError,
-            "PostgreSQL version 10, system-id " HRN_PG_SYSTEMID_10_Z " do not match stanza version 10, system-id"
-            " " HRN_PG_SYSTEMID_11_Z "\n"
-            "HINT: is this the correct stanza?");
+        StringList *fileList = strLstNew();
+        strLstAddZ(fileList, TEST_PATH "/map/1");
+        strLstAddZ(fileList, TEST_PATH "/map/missing");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("reset checksum-page when the cluster does not have checksums enabled");
+        TEST_ASSIGN(blockIndex, blockIndexNew(), "new");
+        TEST_RESULT_VOID(blockIndexMapSet(blockIndex, fileList), "map");
+        TEST_RESULT_UINT(blockIndexMapSize(blockIndex), 2, "map size");
+        TEST_RESULT_UINT(blockIndexSize(blockIndex), 0, "index size");
 
-        // Create pg_control
-        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+        bundleIdSkip = 0;
 
-        // Create stanza
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+        TEST_RESULT_UINT(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip)->blockMapItem.reference,
+            1, "found in map");
 
-        cmdStanzaCreate();
-        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+        strLstAddZ(fileList, TEST_PATH "/map/2");
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptChecksumPage, true);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        TEST_RESULT_VOID(blockIndexMapSet(blockIndex, fileList), "map again");
+        TEST_RESULT_UINT(blockIndexMapSize(blockIndex), 3, "map size");
 
-        HRN_PQ_SCRIPT_SET(
-            // Connect to primary
-            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL));
+        bundleIdSkip = 2;
 
-        TEST_RESULT_VOID(
-            dbFree(
-                backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL))->dbPrimary),
-            "backup init");
-        TEST_RESULT_BOOL(cfgOptionBool(cfgOptChecksumPage), false, "check checksum-page");
+        TEST_RESULT_UINT(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip)->blockMapItem.bundleId,
+            6, "found in second map");
 
-        TEST_RESULT_LOG(
-            "P00   WARN: checksum-page option set to true but checksums are not enabled on the cluster, resetting to false");
+        blockIndexItem.blockMapItem.reference = 7;
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("ok if cluster checksums are enabled and checksum-page is any value");
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, &blockIndexItem), "add");
 
-        // Create pg_control with page checksums
-        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95, .pageChecksumVersion = 1);
+        TEST_RESULT_UINT(
+            blockIndexFind(
+                blockIndex, (const uint8_t []){0xee, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, testBlockIndexFindCallback,
+                &bundleIdSkip)->blockMapItem.reference,
+            7, "found in index before maps");
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        fileList = strLstNew();
+        strLstAddZ(fileList, TEST_PATH "/map/2");
 
-        HRN_PQ_SCRIPT_SET(
-            // Connect to primary
-            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL));
+        TEST_RESULT_VOID(blockIndexMapSet(blockIndex, fileList), "unmap");
+        TEST_RESULT_UINT(blockIndexMapSize(blockIndex), 1, "map size");
+        TEST_RESULT_VOID(blockIndexFree(blockIndex), "free");
 
-        TEST_RESULT_VOID(
-            dbFree(
-                backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL))->dbPrimary),
-            "backup init");
-        TEST_RESULT_BOOL(cfgOptionBool(cfgOptChecksumPage), false, "check checksum-page");
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("map errors");
 
-        // Create pg_control without page checksums
-        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+        TEST_ASSIGN(blockIndex, blockIndexNew(), "new");
 
-        HRN_PQ_SCRIPT_SET(
-            // Connect to primary
-            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL));
+        HRN_STORAGE_PUT_Z(storageTest, "map/invalid", "BOGUS");
 
-        TEST_RESULT_VOID(
-            dbFree(
-                backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL))->dbPrimary),
-            "backup init");
-        TEST_RESULT_BOOL(cfgOptionBool(cfgOptChecksumPage), false, "check checksum-page");
-    }
+        fileList = strLstNew();
+        strLstAddZ(fileList, TEST_PATH "/map/invalid");
 
-    // *****************************************************************************************************************************
-    if (testBegin("backupTime()"))
-    {
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("sleep retries and stall error");
+        TEST_ERROR(
+            blockIndexMapSet(blockIndex, fileList), FormatError, "block index '" TEST_PATH "/map/invalid' has invalid size 5");
 
-        // Create pg_control
-        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+        HRN_STORAGE_PUT_EMPTY(storageTest, "map/empty");
 
-        // Create stanza
-        StringList *argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+        fileList = strLstNew();
+        strLstAddZ(fileList, TEST_PATH "/map/empty");
 
-        cmdStanzaCreate();
-        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+        TEST_ERROR(
+            blockIndexMapSet(blockIndex, fileList), FileReadError,
+            "unable to map block index '" TEST_PATH "/map/empty': [22] Invalid argument");
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        fileList = strLstNew();
+        strLstAddZ(fileList, TEST_PATH "/map/1/bogus");
 
-        HRN_PQ_SCRIPT_SET(
-            // Connect to primary
-            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL),
+        TEST_ERROR(
+            blockIndexMapSet(blockIndex, fileList), FileOpenError,
+            "unable to open block index '" TEST_PATH "/map/1/bogus': [20] Not a directory");
 
-            // Advance the time slowly to force retries
-            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392588998),
-            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392588999),
-            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589001),
+        TEST_RESULT_UINT(blockIndexMapSize(blockIndex), 0, "map size");
+        TEST_RESULT_VOID(blockIndexFree(blockIndex), "free");
 
-            // Stall time to force an error
-            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589998),
-            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589997),
-            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589998),
-            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589999));
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("map block index for backup");
 
-        BackupData *backupData = backupInit(
-            infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL));
+        fileList = strLstNew();
+        strLstAddZ(fileList, TEST_PATH "/map/1");
 
-        TEST_RESULT_INT(backupTime(backupData, true), 1575392588, "multiple tries for sleep");
-        TEST_ERROR(backupTime(backupData, true), KernelError, "PostgreSQL clock has not advanced to the next second after 3 tries");
+        const BlockIndex *blockIndexLoad = NULL;
+        TEST_ASSIGN(blockIndexLoad, backupFileBlockIndex(fileList), "map index");
+        TEST_RESULT_UINT(blockIndexMapSize(blockIndexLoad), 2, "map size");
+        TEST_RESULT_PTR(backupFileBlockIndex(fileList), blockIndexLoad, "index is cached");
+        TEST_RESULT_UINT(blockIndexMapSize(backupFileBlockIndex(strLstNew())), 0, "unmap");
 
-        dbFree(backupData->dbPrimary);
+        HRN_STORAGE_PATH_REMOVE(storageTest, "map", .recurse = true);
     }
 
     // *****************************************************************************************************************************
-    if (testBegin("backupResumeFind()"))
+    if (testBegin("BlockIncr"))
     {
-        StringList *argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, "/pg");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
-        hrnCfgArgRawBool(argList, cfgOptCompress, false);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
-
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("cannot resume when manifest and copy are missing");
+        TEST_TITLE("block incremental config map");
 
-        HRN_STORAGE_PATH_CREATE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F");
-
-        TEST_RESULT_PTR(backupResumeFind((Manifest *)1, NULL), NULL, "find resumable backup");
-
-        TEST_RESULT_LOG(
-            "P00   WARN: backup '20191003-105320F' cannot be resumed: partially deleted by prior resume or invalid");
+        TEST_ERROR(
+            backupBlockIncrMapSize(cfgOptRepoBlockSizeMap, 0, STRDEF("0")), OptionInvalidValueError,
+            "'0' is not valid for 'repo1-block-size-map' option");
+        TEST_ERROR(
+            backupBlockIncrMapSize(cfgOptRepoBlockSizeMap, 0, STRDEF("Z")), OptionInvalidValueError,
+            "'Z' is not valid for 'repo1-block-size-map' option");
+        TEST_ERROR(
+            backupBlockIncrMapSize(cfgOptRepoBlockSizeMap, 0, STRDEF("5GiB")), OptionInvalidValueError,
+            "'5GiB' is not valid for 'repo1-block-size-map' option");
+        TEST_ERROR(
+            backupBlockIncrMapChecksumSize(cfgOptRepoBlockChecksumSizeMap, 0, VARSTRDEF("Z")), OptionInvalidValueError,
+            "'Z' is not valid for 'repo1-block-checksum-size-map' option");
+        TEST_ERROR(
+            backupBlockIncrMapChecksumSize(cfgOptRepoBlockChecksumSizeMap, 0, VARSTRDEF("5")), OptionInvalidValueError,
+            "'5' is not valid for 'repo1-block-checksum-size-map' option");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("cannot resume when resume is disabled");
-
-        HRN_STORAGE_PATH_CREATE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F");
-
-        cfgOptionSet(cfgOptResume, cfgSourceParam, BOOL_FALSE_VAR);
-
-        HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT);
+        TEST_TITLE("full backup with zero block");
 
-        TEST_RESULT_PTR(backupResumeFind((Manifest *)1, NULL), NULL, "find resumable backup");
+        ioBufferSizeSet(2);
 
-        TEST_RESULT_LOG("P00   INFO: backup '20191003-105320F' cannot be resumed: resume is disabled");
+        const Buffer *source = BUFSTRZ("");
+        Buffer *destination = bufNew(256);
+        IoWrite *write = ioBufferWriteNew(destination);
 
-        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 6, false, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        cfgOptionSet(cfgOptResume, cfgSourceParam, BOOL_TRUE_VAR);
+        TEST_RESULT_UINT(pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), 0, "compare");
+        TEST_RESULT_STR_Z(strNewEncode(encodingHex, destination), "", "compare");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("cannot resume when error on manifest load");
-
-        Manifest *manifest = NULL;
+        TEST_TITLE("full backup with partial block");
 
-        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
-        {
-            manifest = manifestNewInternal();
-            manifest->pub.data.backupType = backupTypeFull;
-            manifest->pub.data.backrestVersion = STRDEF("BOGUS");
-        }
-        OBJ_NEW_END();
+        source = BUFSTRZ("12");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, "X");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+        uint64_t mapSize;
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 13, "map size");
 
-        TEST_RESULT_LOG(
-            "P00   WARN: backup '20191003-105320F' cannot be resumed: unable to read"
-            " <REPO:BACKUP>/20191003-105320F/backup.manifest.copy");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "3132",                                     // block 0
+            "block list");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("cannot resume when pgBackRest version has changed");
+        const Buffer *map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
 
-        Manifest *manifestResume = NULL;
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 0, bundleId: 0, offset: 0, size: 2}\n"
+            "  super block {max: 2, size: 2}\n"
+            "    block {no: 0, offset: 0}\n",
+            "check delta");
 
-        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
-        {
-            manifestResume = manifestNewInternal();
-            manifestResume->pub.info = infoNew(NULL);
-            manifestResume->pub.data.backupType = backupTypeFull;
-            manifestResume->pub.data.backupLabel = strNewZ("20191003-105320F");
-            manifestResume->pub.data.pgVersion = PG_VERSION_12;
-        }
-        OBJ_NEW_END();
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("full backup");
 
-        HRN_MANIFEST_TARGET_ADD(manifestResume, .name = MANIFEST_TARGET_PGDATA, .path = "/pg");
-        HRN_MANIFEST_PATH_ADD(manifestResume, .name = MANIFEST_TARGET_PGDATA);
-        HRN_MANIFEST_FILE_ADD(manifestResume, .name = "pg_data/" PG_FILE_PGVERSION);
+        source = BUFSTRZ("ABCXYZ123");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        manifestSave(
-            manifestResume,
-            storageWriteIo(
-                storageNewWriteP(
-                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(2, 3, 8, false, 2, 4, 5, NULL, 0, 0, NULL, NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 31, "map size");
 
-        TEST_RESULT_LOG(
-            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
-            " new pgBackRest version 'BOGUS' does not match resumable pgBackRest version '" PROJECT_VERSION "'");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "414243"                                      // block 0
+            "58595a"                                      // block 1
+            "313233",                                     // block 2
+            "block list");
 
-        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
 
-        manifest->pub.data.backrestVersion = STRDEF(PROJECT_VERSION);
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 2, bundleId: 4, offset: 5, size: 9}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 0}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 3}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 6}\n",
+            "check delta");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("cannot resume when backup labels do not match (resumable is null)");
-
-        manifest->pub.data.backupType = backupTypeFull;
-        manifest->pub.data.backupLabelPrior = STRDEF("20191003-105320F");
+        TEST_TITLE("diff/incr backup");
 
-        manifestSave(
-            manifestResume,
-            storageWriteIo(
-                storageNewWriteP(
-                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+        ioBufferSizeSet(3);
 
-        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+        source = BUFSTRZ("ACCXYZ123@");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        TEST_RESULT_LOG(
-            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
-            " new prior backup label '<undef>' does not match resumable prior backup label '20191003-105320F'");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, false, 3, 0, 0, map, 0, 0, NULL, NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 44, "map size");
 
-        manifest->pub.data.backupLabelPrior = NULL;
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "414343"                                    // block 0
+            "40",                                       // block 3
+            "block list");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("cannot resume when backup labels do not match (new is null)");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
 
-        manifest->pub.data.backupType = backupTypeFull;
-        manifestResume->pub.data.backupLabelPrior = STRDEF("20191003-105320F");
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 3, bundleId: 0, offset: 0, size: 4}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 0}\n"
+            "  super block {max: 1, size: 1}\n"
+            "    block {no: 0, offset: 9}\n"
+            "read {reference: 2, bundleId: 4, offset: 8, size: 6}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 3}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 6}\n",
+            "check delta");
 
-        manifestSave(
-            manifestResume,
-            storageWriteIo(
-                storageNewWriteP(
-                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup with identical data");
 
-        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+        ioBufferSizeSet(3);
 
-        TEST_RESULT_LOG(
-            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
-            " new prior backup label '20191003-105320F' does not match resumable prior backup label '<undef>'");
+        source = BUFSTRZ("ACCXYZ123@");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, false, 3, 0, 0, map, 0, 0, NULL, NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        manifestResume->pub.data.backupLabelPrior = NULL;
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 0, "map size is zero");
+        TEST_RESULT_UINT(bufUsed(destination), 0, "repo size is zero");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("cannot resume when compression does not match");
-
-        manifestResume->pub.data.backupOptionCompressType = compressTypeGz;
-
-        manifestSave(
-            manifestResume,
-            storageWriteIo(
-                storageNewWriteP(
-                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+        TEST_TITLE("full backup with larger super block");
 
-        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+        ioBufferSizeSet(2);
 
-        TEST_RESULT_LOG(
-            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
-            " new compression 'none' does not match resumable compression 'gz'");
+        source = BUFSTRZ("ABCXYZ123");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(6, 3, 8, false, 2, 4, 5, NULL, 0, 0, NULL, NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        manifestResume->pub.data.backupOptionCompressType = compressTypeNone;
-    }
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 32, "map size");
 
-    // *****************************************************************************************************************************
-    if (testBegin("backupJobResult()"))
-    {
-        // Set log level to detail
-        harnessLogLevelSet(logLevelDetail);
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "414243"                                    // super block 0 / block 0
+            "58595a"                                    // super block 0 / block 1
+            "313233",                                   // block 2
+            "block list");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("report job error");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
 
-        ProtocolParallelJob *job = protocolParallelJobNew(VARSTRDEF("key"), strIdFromZ("x"), NULL);
-        protocolParallelJobErrorSet(job, errorTypeCode(&AssertError), STRDEF("error message"));
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 2, bundleId: 4, offset: 5, size: 9}\n"
+            "  super block {max: 6, size: 6}\n"
+            "    block {no: 0, offset: 0}\n"
+            "    block {no: 1, offset: 3}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 6}\n",
+            "check delta");
 
-        unsigned int currentPercentComplete = 0;
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("new filter from pack");
 
-        TEST_ERROR(
-            backupJobResult(
-                (Manifest *)1, NULL, storageTest, strLstNew(), job, false, pgPageSize8, 0, NULL, &currentPercentComplete),
-            AssertError, "error message");
+        TEST_RESULT_VOID(
+            blockIncrNewPack(
+                ioFilterParamList(
+                    blockIncrNew(
+                        3, 3, 8, false, 2, 4, 5, NULL, 0, 0, NULL, compressFilterP(compressTypeGz, 1, .raw = true),
+                        cipherBlockNewP(cipherModeEncrypt, cipherTypeAes256Cbc, BUFSTRDEF(TEST_CIPHER_PASS), .raw = true)))),
+            "block incr pack");
+
+        const Buffer *const mapFixed = map;
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("report host/100% progress on noop result");
+        TEST_TITLE("content-defined chunking full backup");
 
-        // Create job that skips file
-        job = protocolParallelJobNew(VARSTRDEF("pg_data/test"), strIdFromZ("x"), NULL);
+        ioBufferSizeSet(5);
 
-        PackWrite *const resultPack = protocolPackNew();
-        pckWriteStrP(resultPack, STRDEF("pg_data/test"));
-        pckWriteU32P(resultPack, backupCopyResultNoOp);
-        // No more fields need to be written since noop will ignore them anyway
-        pckWriteEndP(resultPack);
+        source = BUFSTRZ("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        protocolParallelJobResultSet(job, pckReadNew(pckWriteResult(resultPack)));
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(8, 4, 8, true, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        // Create manifest with file
-        Manifest *manifest = NULL;
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 88, "map size");
 
-        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
-        {
-            manifest = manifestNewInternal();
-            HRN_MANIFEST_FILE_ADD(manifest, .name = "pg_data/test");
-        }
-        OBJ_NEW_END();
+        TEST_RESULT_STR_Z(
+            strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)), "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+            "block list");
 
-        uint64_t sizeProgress = 0;
-        currentPercentComplete = 4567;
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
 
-        lockInit(TEST_PATH_STR, cfgOptionStr(cfgOptExecId));
-        TEST_RESULT_VOID(cmdLockAcquireP(), "acquire backup lock");
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8),
+            "read {reference: 0, bundleId: 0, offset: 0, size: 26}\n"
+            "  super block {max: 11, size: 11}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 1}\n"
+            "    block {no: 1, offset: 1, blockOffset: 1, size: 6}\n"
+            "    block {no: 2, offset: 7, blockOffset: 7, size: 4}\n"
+            "  super block {max: 8, size: 8}\n"
+            "    block {no: 0, offset: 11, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 14, blockOffset: 3, size: 5}\n"
+            "  super block {max: 7, size: 7}\n"
+            "    block {no: 0, offset: 19, blockOffset: 0, size: 5}\n"
+            "    block {no: 1, offset: 24, blockOffset: 5, size: 1}\n"
+            "    block {no: 2, offset: 25, blockOffset: 6, size: 1}\n",
+            "check delta");
 
-        TEST_RESULT_VOID(
-            backupJobResult(
-                manifest, STRDEF("host"), storageTest, strLstNew(), job, false, pgPageSize8, 0, &sizeProgress,
-                &currentPercentComplete),
-            "log noop result");
-        TEST_RESULT_VOID(cmdLockReleaseP(), "release backup lock");
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("content-defined chunking diff/incr backup with inserted data");
 
-        TEST_RESULT_LOG("P00 DETAIL: match file from prior backup host:" TEST_PATH "/test (0B, 100.00%)");
-    }
+        const Buffer *repoList[3] = {destination};
 
-    // Offline tests should only be used to test offline functionality and errors easily tested in offline mode
-    // *****************************************************************************************************************************
-    if (testBegin("cmdBackup() offline"))
-    {
-        // Set log level to detail
-        harnessLogLevelSet(logLevelDetail);
+        source = BUFSTRZ("ABCDEFGHIJK!!LMNOPQRSTUVWXYZ");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        // Replace backup labels since the times are not deterministic
-        hrnLogReplaceAdd("[0-9]{8}-[0-9]{6}F_[0-9]{8}-[0-9]{6}I", NULL, "INCR", true);
-        hrnLogReplaceAdd("[0-9]{8}-[0-9]{6}F_[0-9]{8}-[0-9]{6}D", NULL, "DIFF", true);
-        hrnLogReplaceAdd("[0-9]{8}-[0-9]{6}F", NULL, "FULL", true);
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 1, 0, 0, map, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        // Create stanza
-        StringList *argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 106, "map size");
 
-        // Create pg_control
-        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+        TEST_RESULT_STR_Z(
+            strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)), "!!LMNOPQRSTUVWX", "block list");
 
-        cmdStanzaCreate();
-        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[1] = destination;
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("error when pg appears to be running");
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8),
+            "read {reference: 1, bundleId: 0, offset: 0, size: 15}\n"
+            "  super block {max: 11, size: 11}\n"
+            "    block {no: 0, offset: 11, blockOffset: 0, size: 6}\n"
+            "    block {no: 1, offset: 17, blockOffset: 6, size: 5}\n"
+            "  super block {max: 4, size: 4}\n"
+            "    block {no: 0, offset: 22, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 25, blockOffset: 3, size: 1}\n"
+            "read {reference: 0, bundleId: 0, offset: 0, size: 11}\n"
+            "  super block {max: 11, size: 11}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 1}\n"
+            "    block {no: 1, offset: 1, blockOffset: 1, size: 6}\n"
+            "    block {no: 2, offset: 7, blockOffset: 7, size: 4}\n"
+            "read {reference: 0, bundleId: 0, offset: 19, size: 7}\n"
+            "  super block {max: 7, size: 7}\n"
+            "    block {no: 1, offset: 26, blockOffset: 5, size: 1}\n"
+            "    block {no: 2, offset: 27, blockOffset: 6, size: 1}\n",
+            "check delta");
+        TEST_RESULT_STR(
+            strNewBuf(hrnBlockDeltaRestore(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8, repoList)), strNewBuf(source),
+            "restore");
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("content-defined chunking diff/incr backup with identical data");
 
-        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_POSTMTRPID, "PID");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        TEST_ERROR(
-            hrnCmdBackup(), PgRunningError,
-            "--no-online passed but " PG_FILE_POSTMTRPID " exists - looks like " PG_NAME " is running. Shut down " PG_NAME " and"
-            " try again, or use --force.");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 2, 0, 0, map, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_LOG("P00   WARN: no prior backup exists, incr backup has been changed to full");
+        TEST_RESULT_UINT(pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), 0, "map size");
+        TEST_RESULT_UINT(bufUsed(destination), 0, "repo size is zero");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("offline full backup");
+        TEST_TITLE("content-defined chunking diff/incr backup with moved and repeated data");
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        hrnCfgArgRawBool(argList, cfgOptCompress, false);
-        hrnCfgArgRawBool(argList, cfgOptForce, true);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        source = BUFSTRZ("ABCDEFGHIJKABCDEFGHIJKZ");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.conf", "CONFIGSTUFF");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 2, 0, 0, map, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 84, "map size");
 
-        TEST_RESULT_LOG_FMT(
-            "P00   WARN: no prior backup exists, incr backup has been changed to full\n"
-            "P00   WARN: --no-online passed and " PG_FILE_POSTMTRPID " exists but --force was passed so backup will continue though"
-            " it looks like " PG_NAME " is running and the backup will probably not be consistent\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, 99.87%%) checksum %s\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, 100.00%%) checksum"
-            " e3db315c260e79211b7b52587123b7aa060f30ab\n"
-            "P00   INFO: new backup label = [FULL-1]\n"
-            "P00   INFO: full backup size = 8KB, file total = 2",
-            TEST_64BIT() ?
-                (TEST_BIG_ENDIAN() ? "ead3f998dc6dbc4b444f89cd449dcb81801a21ed" : "6f7fb3cd71dbef602850d05332cdd1c8e4a64121") :
-                "a90290adaf2e8a36d53b0c15d277e23e1b321fdb");
+        TEST_RESULT_STR_Z(strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)), "ABCDEFGHIJK", "block list");
 
-        // Make pg no longer appear to be running
-        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_POSTMTRPID, .errorOnMissing = true);
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[2] = destination;
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8),
+            "read {reference: 2, bundleId: 0, offset: 0, size: 11}\n"
+            "  super block {max: 11, size: 11}\n"
+            "    block {no: 0, offset: 11, blockOffset: 0, size: 1}\n"
+            "    block {no: 1, offset: 12, blockOffset: 1, size: 6}\n"
+            "    block {no: 2, offset: 18, blockOffset: 7, size: 4}\n"
+            "read {reference: 0, bundleId: 0, offset: 0, size: 11}\n"
+            "  super block {max: 11, size: 11}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 1}\n"
+            "    block {no: 1, offset: 1, blockOffset: 1, size: 6}\n"
+            "    block {no: 2, offset: 7, blockOffset: 7, size: 4}\n"
+            "read {reference: 0, bundleId: 0, offset: 19, size: 7}\n"
+            "  super block {max: 7, size: 7}\n"
+            "    block {no: 2, offset: 22, blockOffset: 6, size: 1}\n",
+            "check delta");
+        TEST_RESULT_STR(
+            strNewBuf(hrnBlockDeltaRestore(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8, repoList)), strNewBuf(source),
+            "restore");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("error when no files have changed");
+        TEST_TITLE("prior map with variable size blocks is not used for fixed size blocks");
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        hrnCfgArgRawBool(argList, cfgOptCompress, true);
-        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        TEST_ERROR(hrnCmdBackup(), FileMissingError, "no files have changed since the last backup - this seems unlikely");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, false, 3, 0, 0, map, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_LOG(
-            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
-            "P00   WARN: diff backup cannot alter compress-type option to 'gz', reset to value in [FULL-1]");
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(bufUsed(destination) - mapSize, bufUsed(source), "all blocks stored");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("offline incr backup to test unresumable backup");
-
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        hrnCfgArgRawBool(argList, cfgOptCompress, false);
-        hrnCfgArgRawBool(argList, cfgOptChecksumPage, true);
-        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        TEST_TITLE("prior map with fixed size blocks is not used for content-defined chunking");
 
-        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "VER");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(6, 3, 8, true, 3, 0, 0, mapFixed, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_LOG(
-            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
-            "P00   WARN: incr backup cannot alter 'checksum-page' option to 'true', reset to 'false' from [FULL-1]\n"
-            "P00   INFO: backup '[DIFF-1]' cannot be resumed: resume only valid for full backup\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum c8663c2525f44b6d9c687fbceb4aafc63ed8b451\n"
-            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-1]\n"
-            "P00 DETAIL: reference pg_data/postgresql.conf to [FULL-1]\n"
-            "P00   INFO: new backup label = [INCR-1]\n"
-            "P00   INFO: incr backup size = 3B, file total = 3");
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(bufUsed(destination) - mapSize, bufUsed(source), "all blocks stored");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("offline diff backup to test prior backup must be full");
+        TEST_TITLE("content-defined chunking with repeated data");
 
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        hrnCfgArgRawBool(argList, cfgOptCompress, false);
-        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        Buffer *sourceZero = bufNew(40);
+        memset(bufPtr(sourceZero), 0, bufSize(sourceZero));
+        bufUsedSet(sourceZero, bufSize(sourceZero));
 
-        hrnSleepRemainder();
-        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "VR2");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, sourceZero), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_LOG(
-            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum 6f1894088c578e4f0b9888e8e8a997d93cbbc0c5\n"
-            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-1]\n"
-            "P00 DETAIL: reference pg_data/postgresql.conf to [FULL-1]\n"
-            "P00   INFO: new backup label = [DIFF-2]\n"
-            "P00   INFO: diff backup size = 3B, file total = 3");
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("only repo2 configured");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[0] = destination;
 
-        // Create stanza on a second repo
-        argList = strLstNew();
-        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 2, TEST_PATH "/repo2");
-        hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
-        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
-        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
-        hrnCfgArgRawBool(argList, cfgOptOnline, false);
-        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8),
+            "read {reference: 0, bundleId: 0, offset: 0, size: 40}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 3, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 6, blockOffset: 6, size: 3}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 9, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 12, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 15, blockOffset: 6, size: 3}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 18, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 21, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 24, blockOffset: 6, size: 3}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 27, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 30, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 33, blockOffset: 6, size: 3}\n"
+            "  super block {max: 4, size: 4}\n"
+            "    block {no: 0, offset: 36, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 39, blockOffset: 3, size: 1}\n",
+            "check delta");
 
-        cmdStanzaCreate();
-        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo2");
+        bufUsedSet(sourceZero, 36);
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        // Set log level to warn
-        harnessLogLevelSet(logLevelWarn);
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 1, 0, 0, map, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, sourceZero), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        // With repo2 the only repo configured, ensure it is chosen by confirming diff is changed to full due to no prior backups
-        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 2, "1");
-        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
 
-        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[1] = destination;
 
-        TEST_RESULT_LOG("P00   WARN: no prior backup exists, diff backup has been changed to full");
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8),
+            "read {reference: 0, bundleId: 0, offset: 0, size: 36}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 3, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 6, blockOffset: 6, size: 3}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 9, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 12, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 15, blockOffset: 6, size: 3}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 18, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 21, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 24, blockOffset: 6, size: 3}\n"
+            "  super block {max: 9, size: 9}\n"
+            "    block {no: 0, offset: 27, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 30, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 33, blockOffset: 6, size: 3}\n",
+            "check delta");
+        TEST_RESULT_STR(
+            strNewEncode(encodingHex, hrnBlockDeltaRestore(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8, repoList)),
+            strNewEncode(encodingHex, sourceZero), "restore");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("multi-repo");
+        TEST_TITLE("content-defined chunking with maximum block size");
 
-        // Set log level to detail
-        harnessLogLevelSet(logLevelDetail);
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        // Add repo1 to the configuration
-        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 1, TEST_PATH "/repo");
-        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 1, "1");
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(64, 8, 8, true, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, BUFSTRDEF("aaaaaaaabaabaaabbaaaaaaaabaaaaaaXYZ")), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
 
-        TEST_RESULT_LOG(
-            "P00   INFO: repo option not specified, defaulting to repo1\n"
-            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
-            "P00   WARN: diff backup cannot alter compress-type option to 'gz', reset to value in [FULL-1]\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum 6f1894088c578e4f0b9888e8e8a997d93cbbc0c5\n"
-            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-1]\n"
-            "P00 DETAIL: reference pg_data/postgresql.conf to [FULL-1]\n"
-            "P00   INFO: new backup label = [DIFF-3]\n"
-            "P00   INFO: diff backup size = 3B, file total = 3");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 8, 8), 8, 8),
+            "read {reference: 0, bundleId: 0, offset: 0, size: 35}\n"
+            "  super block {max: 35, size: 35}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 32}\n"
+            "    block {no: 1, offset: 32, blockOffset: 32, size: 3}\n",
+            "check delta");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("multi-repo - specify repo");
+        TEST_TITLE("full backup returns new bundled blocks for the index");
 
-        hrnCfgArgRawZ(argList, cfgOptRepo, "2");
+        ioBufferSizeSet(3);
 
-        HRN_CFG_LOAD(cfgCmdBackup, argList);
+        source = BUFSTRZ("ABCXYZ123");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "VER");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(
+                    ioFilterParamList(blockIncrNew(3, 3, 8, false, 0, 4, 5, NULL, 0, 0, blockIndexNew(), NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        // Modify file postgresql.conf during the backup to demonstrate that percent complete will be updated correctly
-        HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.conf", "CONFIGSTUFF2");
-        HRN_BACKUP_SCRIPT_SET(
-            {.op = hrnBackupScriptOpUpdate, .file = storagePathP(storagePg(), STRDEF("postgresql.conf")),
-             .content = BUFSTRDEF("CONFIG")});
+        PackRead *blockIncrResult = NULL;
+        TEST_ASSIGN(blockIncrResult, ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE), "result");
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
 
-        unsigned int backupCount = strLstSize(storageListP(storageRepoIdx(1), strNewFmt(STORAGE_PATH_BACKUP "/test1")));
+        BlockIndex *blockIndex = blockIndexNew();
+        TEST_RESULT_VOID(blockIndexRead(blockIndex, ioBufferReadNewOpen(pckReadBinP(blockIncrResult)), 0), "read index");
+        TEST_RESULT_VOID(blockIndexSort(blockIndex), "sort index");
+        TEST_RESULT_STR_Z(
+            hrnBlockIndexRender(blockIndex),
+            "{checksum: 0e45f72b, blockSize: 3, reference: 0, bundleId: 4, offset: 11, size: 3, superBlockSize: 3, block: 0}\n"
+            "{checksum: 26251b11, blockSize: 3, reference: 0, bundleId: 4, offset: 8, size: 3, superBlockSize: 3, block: 0}\n"
+            "{checksum: 9e947f00, blockSize: 3, reference: 0, bundleId: 4, offset: 5, size: 3, superBlockSize: 3, block: 0}\n",
+            "check index");
 
-        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
 
-        TEST_RESULT_LOG(
-            "P00   INFO: last backup label = [FULL-2], version = " PROJECT_VERSION "\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (12B->6B, 80.00%) checksum"
-            " 2fb60054b43a25d7a958d3d19bdb1aa7809577a8\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum c8663c2525f44b6d9c687fbceb4aafc63ed8b451\n"
-            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-2]\n"
-            "P00   INFO: new backup label = [DIFF-4]\n"
-            "P00   INFO: diff backup size = 9B, file total = 3");
-        TEST_RESULT_UINT(
-            strLstSize(storageListP(storageRepoIdx(1), strNewFmt(STORAGE_PATH_BACKUP "/test1"))), backupCount + 1,
-            "new backup repo2");
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup with identical data returns no blocks for the index");
 
-        // Cleanup
-        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
-        harnessLogLevelReset();
-    }
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-    // *****************************************************************************************************************************
-    if (testBegin("cmdBackup() online"))
-    {
-        const String *pg1Path = STRDEF(TEST_PATH "/pg1");
-        const String *repoPath = STRDEF(TEST_PATH "/repo");
-        const String *pg2Path = STRDEF(TEST_PATH "/pg2");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 1, 6, 0, map, 0, 0, blockIndex, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        // Set log level to detail
-        harnessLogLevelSet(logLevelDetail);
+        TEST_ASSIGN(blockIncrResult, ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE), "result");
+        TEST_RESULT_UINT(pckReadU64P(blockIncrResult), 0, "map size is zero");
+        TEST_RESULT_PTR(pckReadBinP(blockIncrResult), NULL, "no index");
 
-        // Replace percent complete and backup size since they can cause a lot of churn when files are added/removed
-        hrnLogReplaceAdd(", [0-9]{1,3}.[0-9]{1,2}%\\)", "[0-9].+%", "PCT", false);
-        hrnLogReplaceAdd(" backup size = [0-9.]+[A-Z]+", "[^ ]+$", "SIZE", false);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup finds blocks in the index");
 
-        // Replace checksums since they can differ between architectures (e.g. 32/64 bit)
-        hrnLogReplaceAdd("\\) checksum [a-f0-9]{40}", "[a-f0-9]{40}$", "SHA1", false);
+        source = BUFSTRZ("XYZXYZ123ABC");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 9.5 resume uncompressed full backup");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 1, 6, 0, map, 0, 0, blockIndex, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        time_t backupTimeStart = BACKUP_EPOCH;
+        TEST_ASSIGN(blockIncrResult, ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE), "result");
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
 
-        {
-            // Create stanza
-            StringList *argList = strLstNew();
-            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
-            hrnCfgArgRawBool(argList, cfgOptOnline, false);
-            HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+        TEST_RESULT_STR_Z(
+            strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "XYZ"                                       // block 1 is a repeat of block 0 found in the index
+            "ABC",                                      // block 3 is found in the index before the last block used
+            "block list");
 
-            // Create pg_control
-            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
 
-            cmdStanzaCreate();
-            TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 1, bundleId: 6, offset: 0, size: 6}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 3}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 9}\n"
+            "read {reference: 0, bundleId: 4, offset: 8, size: 6}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 0}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 6}\n",
+            "check delta");
 
-            // Load options
-            argList = strLstNew();
-            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
-            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
-            hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
-            hrnCfgArgRawBool(argList, cfgOptCompress, false);
-            hrnCfgArgRawBool(argList, cfgOptArchiveCheck, false);
-            HRN_CFG_LOAD(cfgCmdBackup, argList);
+        BlockIndex *blockIndexNext = blockIndexNew();
+        TEST_RESULT_VOID(blockIndexRead(blockIndexNext, ioBufferReadNewOpen(pckReadBinP(blockIncrResult)), 1), "read index");
+        TEST_RESULT_STR_Z(
+            hrnBlockIndexRender(blockIndexNext),
+            "{checksum: 26251b11, blockSize: 3, reference: 1, bundleId: 6, offset: 0, size: 3, superBlockSize: 3, block: 0}\n"
+            "{checksum: 9e947f00, blockSize: 3, reference: 1, bundleId: 6, offset: 3, size: 3, superBlockSize: 3, block: 0}\n",
+            "check index");
 
-            // Add files
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.conf", "CONFIGSTUFF", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_95_Z, .timeModified = backupTimeStart);
-            HRN_STORAGE_PATH_CREATE(storagePgWrite(), strZ(pgWalPath(PG_VERSION_95)), .noParentCreate = true);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("blocks in the index with a different block size are not used");
 
-            // Create a backup manifest that looks like a halted backup manifest
-            Manifest *manifestResume = manifestNewBuild(
-                storagePg(), PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false, NULL, NULL, NULL);
+        uint64_t bundleIdSkip = 0;
+        BlockIndexItem blockIndexItem = *blockIndexFind(
+            blockIndex, bufPtrConst(xxHashOne(XX_HASH_SIZE_MAX, BUFSTRDEF("ABC"))), testBlockIndexFindCallback, &bundleIdSkip);
 
-            manifestResume->pub.data.backupType = backupTypeFull;
-            const String *resumeLabel = backupLabelCreate(backupTypeFull, NULL, backupTimeStart);
-            manifestBackupLabelSet(manifestResume, resumeLabel);
+        blockIndex = blockIndexNew();
+        blockIndexItem.blockSize = 6;
+        blockIndexAdd(blockIndex, &blockIndexItem);
 
-            // Copy a file to be resumed that has not changed in the repo
-            HRN_STORAGE_COPY(
-                storagePg(), PG_FILE_PGVERSION, storageRepoWrite(),
-                zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/PG_VERSION", strZ(resumeLabel)));
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-            ManifestFilePack **const filePack = manifestFilePackFindInternal(manifestResume, STRDEF("pg_data/PG_VERSION"));
-            ManifestFile file = manifestFileUnpack(manifestResume, *filePack);
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 1, 0, 0, NULL, 0, 0, blockIndex, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, BUFSTRDEF("ABC")), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-            file.checksumSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("06d06bb31b570b94d7b4325f511f853dbe771c21")));
-            file.checksumRepoSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("06d06bb31b570b94d7b4325f511f853dbe771c21")));
+        TEST_ASSIGN(blockIncrResult, ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE), "result");
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
+        TEST_RESULT_STR_Z(strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)), "ABC", "block list");
+        TEST_RESULT_PTR(pckReadBinP(blockIncrResult), NULL, "no index when not bundled");
 
-            manifestFilePackUpdate(manifestResume, filePack, &file);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("content-defined chunking finds blocks in the index");
 
-            // Save the resume manifest
-            manifestSave(
-                manifestResume,
-                storageWriteIo(
-                    storageNewWriteP(
-                        storageRepoWrite(),
-                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+        ioBufferSizeSet(5);
 
-            // Run backup
-            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart, .noArchiveCheck = true, .noWal = true);
+        source = BUFSTRZ("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 0, 1, 0, NULL, 0, 0, blockIndexNew(), NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-            TEST_RESULT_LOG(
-                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105D944C000000000, lsn = 5d944c0/0\n"
-                "P00   WARN: resumable backup 20191002-070640F of same type exists -- invalid files will be removed then the backup"
-                " will resume\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: checksum resumed file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
-                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105D944C000000000, lsn = 5d944c0/800000\n"
-                "P00   INFO: new backup label = 20191002-070640F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 3");
+        TEST_ASSIGN(blockIncrResult, ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE), "result");
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
 
-            TEST_RESULT_STR_Z(
-                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191002-070640F}\n"
-                "pg_data/PG_VERSION {s=3}\n"
-                "pg_data/global/pg_control {s=8192}\n"
-                "pg_data/pg_xlog/\n"
-                "pg_data/postgresql.conf {s=11}\n"
-                "--------\n"
-                "[backup:target]\n"
-                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
-                "compare file list");
-        }
+        repoList[0] = destination;
+        blockIndex = blockIndexNew();
+        TEST_RESULT_VOID(blockIndexRead(blockIndex, ioBufferReadNewOpen(pckReadBinP(blockIncrResult)), 0), "read index");
+        TEST_RESULT_VOID(blockIndexSort(blockIndex), "sort index");
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online resumed compressed 9.5 full backup");
+        source = BUFSTRZ("ABCDEFGHIJK!!LMNOPQRSTUVWXYZ");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
 
-        // Backup start time
-        backupTimeStart = BACKUP_EPOCH + 100000;
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 1, 2, 0, NULL, 0, 0, blockIndex, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
 
-        {
-            // Load options
-            StringList *argList = strLstNew();
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_STR_Z(
+            strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)), "!!LMNOPQRSTUVWX",
+            "block list");
+
+        repoList[1] = destination;
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+
+        TEST_RESULT_STR(
+            strNewBuf(hrnBlockDeltaRestore(blockMapNewRead(ioBufferReadNewOpen(map), 4, 8), 4, 8, repoList)), strNewBuf(source),
+            "restore");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("variable size blocks in the index are not used for fixed size blocks");
+
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, false, 1, 0, 0, NULL, 0, 0, blockIndex, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, BUFSTRDEF("HIJK")), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_STR_Z(strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)), "HIJK", "block list");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("blocks stored by the current backup are only used by files in other bundles");
+
+        source = BUFSTRZ("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+
+        for (unsigned int bundleId = 0; bundleId <= 2; bundleId++)
+        {
+            destination = bufNew(256);
+            write = ioBufferWriteNew(destination);
+
+            TEST_RESULT_VOID(
+                ioFilterGroupAdd(
+                    ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 0, bundleId, 0, NULL, 0, 0, blockIndex, NULL, NULL)),
+                "block incr");
+            TEST_RESULT_VOID(ioWriteOpen(write), "open");
+            TEST_RESULT_VOID(ioWrite(write, source), "write");
+            TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+            TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+            TEST_RESULT_STR_Z(
+                strNewBuf(BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+                bundleId == 2 ? "" : "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "block list");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("full backup with zero blocks");
+
+        ioBufferSizeSet(2);
+
+        source = BUF("\0\0\0ABC\0\0\0\0\0\0\0\0", 14);
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 0, 4, 0, NULL, 0, 0, blockIndexNew(), NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(blockIncrResult, ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE), "result");
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
+        TEST_RESULT_UINT(mapSize, 28, "map size");
+
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "414243"                                    // block 1
+            "0000",                                     // block 4 (partial zero blocks are stored)
+            "block list");
+
+        blockIndex = blockIndexNew();
+        TEST_RESULT_VOID(blockIndexRead(blockIndex, ioBufferReadNewOpen(pckReadBinP(blockIncrResult)), 0), "read index");
+        TEST_RESULT_VOID(blockIndexSort(blockIndex), "sort index");
+        TEST_RESULT_STR_Z(
+            hrnBlockIndexRender(blockIndex),
+            "{checksum: 4758ddac, blockSize: 3, reference: 0, bundleId: 4, offset: 3, size: 2, superBlockSize: 2, block: 0}\n"
+            "{checksum: 9e947f00, blockSize: 3, reference: 0, bundleId: 4, offset: 0, size: 3, superBlockSize: 3, block: 0}\n",
+            "zero blocks are not indexed");
+
+        const Buffer *const mapZeroPrior = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[0] = destination;
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(mapZeroPrior), 3, 8), 3, 8),
+            "read {reference: 0, bundleId: 4, offset: 0, size: 5}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 3}\n"
+            "  super block {max: 2, size: 2}\n"
+            "    block {no: 0, offset: 12}\n"
+            "zero {offset: 0}\n"
+            "zero {offset: 6}\n"
+            "zero {offset: 9}\n",
+            "check delta");
+        TEST_RESULT_STR(
+            strNewEncode(
+                encodingHex, hrnBlockDeltaRestore(blockMapNewRead(ioBufferReadNewOpen(mapZeroPrior), 3, 8), 3, 8, repoList)),
+            strNewEncode(encodingHex, source), "restore");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup with zero blocks");
+
+        source = BUF("\0\0\0\0\0\0XYZ\0AB\0\0\0\0\0\0", 18);
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 1, 0, 0, mapZeroPrior, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(mapSize, 25, "map size");
+
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "58595a"                                    // block 2
+            "004142",                                   // block 3
+            "block list");
+
+        const Buffer *const mapZero = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[1] = destination;
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(mapZero), 3, 8), 3, 8),
+            "read {reference: 1, bundleId: 0, offset: 0, size: 6}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 6}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 9}\n"
+            "zero {offset: 0}\n"
+            "zero {offset: 3}\n"
+            "zero {offset: 12}\n"
+            "zero {offset: 15}\n",
+            "check delta");
+        TEST_RESULT_STR(
+            strNewEncode(encodingHex, hrnBlockDeltaRestore(blockMapNewRead(ioBufferReadNewOpen(mapZero), 3, 8), 3, 8, repoList)),
+            strNewEncode(encodingHex, source), "restore");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup with identical zero blocks");
+
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 2, 0, 0, mapZero, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_RESULT_UINT(
+            pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), 0, "map size is zero");
+        TEST_RESULT_UINT(bufUsed(destination), 0, "repo size is zero");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("full backup with all zero blocks");
+
+        source = BUF("\0\0\0\0\0\0", 6);
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, false, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        TEST_RESULT_UINT(bufUsed(destination), mapSize, "only the map is stored");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, destination),
+            "19"                                        // flags (version 1, zero runs, all zero)
+            "01"                                        // zero run total
+            "00"                                        // zero run start
+            "01",                                       // zero run size - 1
+            "map");
+
+        TEST_ERROR(testBlockMapVersionLegacy(destination), FormatError, "block map version must be zero");
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(destination), 3, 8), 3, 8),
+            "zero {offset: 0}\n"
+            "zero {offset: 3}\n",
+            "check delta");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("full backup of pages for lsn check");
+
+        #define TEST_PAGE_SIZE                                      256
+        #define TEST_BLOCK_SIZE                                     (TEST_PAGE_SIZE * 2)
+        #define TEST_LSN_PRIOR                                      0x100000000
+
+        ioBufferSizeSet(TEST_BLOCK_SIZE);
+
+        Buffer *sourcePage = bufNew(TEST_BLOCK_SIZE * 11);
+        memset(bufPtr(sourcePage), 0, bufSize(sourcePage));
+        bufUsedSet(sourcePage, bufSize(sourcePage));
+
+        for (unsigned int pageIdx = 0; pageIdx < 18; pageIdx++)
+            testPageLsnPut(sourcePage, TEST_PAGE_SIZE, pageIdx, 0x10 + pageIdx, (uint8_t)(pageIdx + 1));
+
+        // Block 9 is zero and block 10 is not
+        testPageLsnPut(sourcePage, TEST_PAGE_SIZE, 20, 0x10, 21);
+        testPageLsnPut(sourcePage, TEST_PAGE_SIZE, 21, 0x10, 22);
+
+        // Pages that fail the lsn check in blocks 3-8
+        ((PageHeaderData *)(bufPtr(sourcePage) + TEST_PAGE_SIZE * 6))->pd_lsn = (PageXLogRecPtr){0};
+        ((PageHeaderData *)(bufPtr(sourcePage) + TEST_PAGE_SIZE * 8))->pd_pagesize_version = TEST_PAGE_SIZE * 2 | 4;
+        ((PageHeaderData *)(bufPtr(sourcePage) + TEST_PAGE_SIZE * 10))->pd_lower = 8;
+        ((PageHeaderData *)(bufPtr(sourcePage) + TEST_PAGE_SIZE * 12))->pd_upper = 16;
+        ((PageHeaderData *)(bufPtr(sourcePage) + TEST_PAGE_SIZE * 14))->pd_special = TEST_PAGE_SIZE / 2;
+        ((PageHeaderData *)(bufPtr(sourcePage) + TEST_PAGE_SIZE * 16))->pd_upper = TEST_PAGE_SIZE * 2;
+        ((PageHeaderData *)(bufPtr(sourcePage) + TEST_PAGE_SIZE * 16))->pd_special = TEST_PAGE_SIZE * 2;
+
+        destination = bufNew(TEST_BLOCK_SIZE * 16);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNew(TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 8, false, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, sourcePage), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+
+        const Buffer *const mapPage = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[0] = destination;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup skips checksum for pages before prior lsn");
+
+        Buffer *sourcePageIncr = bufNew(TEST_BLOCK_SIZE * 12 + TEST_PAGE_SIZE);
+        bufCat(sourcePageIncr, sourcePage);
+        bufUsedSet(sourcePageIncr, bufSize(sourcePageIncr));
+
+        // Block 1 changes without changing the lsn so the change is not detected (this would not happen in PostgreSQL)
+        memset(bufPtr(sourcePageIncr) + TEST_PAGE_SIZE * 3 + TEST_PAGE_SIZE / 2, 0xFF, TEST_PAGE_SIZE / 2);
+
+        // Block 2 changes and the lsn is updated
+        testPageLsnPut(sourcePageIncr, TEST_PAGE_SIZE, 5, TEST_LSN_PRIOR, 0xFF);
+
+        // Blocks 3-8 change without changing the lsn but the pages cannot be checked
+        for (unsigned int pageIdx = 7; pageIdx < 18; pageIdx += 2)
+            memset(bufPtr(sourcePageIncr) + TEST_PAGE_SIZE * pageIdx + TEST_PAGE_SIZE / 2, 0xFF, TEST_PAGE_SIZE / 2);
+
+        // Block 9 was zero and block 10 is zero
+        testPageLsnPut(sourcePageIncr, TEST_PAGE_SIZE, 18, 0x10, 19);
+        testPageLsnPut(sourcePageIncr, TEST_PAGE_SIZE, 19, 0x10, 20);
+        memset(bufPtr(sourcePageIncr) + TEST_BLOCK_SIZE * 10, 0, TEST_BLOCK_SIZE);
+
+        // Block 11 is new and block 12 is partial
+        testPageLsnPut(sourcePageIncr, TEST_PAGE_SIZE, 22, 0x10, 23);
+        testPageLsnPut(sourcePageIncr, TEST_PAGE_SIZE, 23, 0x10, 24);
+        testPageLsnPut(sourcePageIncr, TEST_PAGE_SIZE, 24, 0x10, 25);
+
+        destination = bufNew(TEST_BLOCK_SIZE * 16);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(
+                    ioFilterParamList(
+                        blockIncrNew(
+                            TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 8, false, 1, 0, 0, mapPage, TEST_LSN_PRIOR, TEST_PAGE_SIZE, NULL,
+                            NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, sourcePageIncr), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+
+        const Buffer *const mapPageIncr = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+        repoList[1] = destination;
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(mapPageIncr), TEST_BLOCK_SIZE, 8), TEST_BLOCK_SIZE, 8),
+            "read {reference: 1, bundleId: 0, offset: 0, size: 4864}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 1024}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 1536}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 2048}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 2560}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 3072}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 3584}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 4096}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 4608}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 5632}\n"
+            "  super block {max: 256, size: 256}\n"
+            "    block {no: 0, offset: 6144}\n"
+            "read {reference: 0, bundleId: 0, offset: 0, size: 1024}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 0}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 512}\n"
+            "zero {offset: 5120}\n",
+            "check delta");
+
+        // The change to block 1 is not restored
+        memcpy(bufPtr(sourcePageIncr) + TEST_BLOCK_SIZE, bufPtrConst(sourcePage) + TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                hrnBlockDeltaRestore(
+                    blockMapNewRead(ioBufferReadNewOpen(mapPageIncr), TEST_BLOCK_SIZE, 8), TEST_BLOCK_SIZE, 8, repoList),
+                sourcePageIncr),
+            true, "restore");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup computes checksum when the index prevents using the prior block");
+
+        Buffer *sourceIndex = bufNew(TEST_BLOCK_SIZE * 2);
+        bufUsedSet(sourceIndex, bufSize(sourceIndex));
+
+        for (unsigned int pageIdx = 0; pageIdx < 4; pageIdx++)
+            testPageLsnPut(sourceIndex, TEST_PAGE_SIZE, pageIdx, pageIdx == 2 ? 0 : 0x10, (uint8_t)(pageIdx + 1));
+
+        destination = bufNew(TEST_BLOCK_SIZE * 4);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNew(TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 8, false, 0, 4, 0, NULL, 0, 0, blockIndexNew(), NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, sourceIndex), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(blockIncrResult, ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE), "result");
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
+
+        blockIndex = blockIndexNew();
+        TEST_RESULT_VOID(blockIndexRead(blockIndex, ioBufferReadNewOpen(pckReadBinP(blockIncrResult)), 0), "read index");
+        TEST_RESULT_VOID(blockIndexSort(blockIndex), "sort index");
+
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+
+        // Block 0 is a copy of block 1 and is found in the index so block 1 cannot use the prior block
+        memcpy(bufPtr(sourceIndex), bufPtrConst(sourceIndex) + TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+        testPageLsnPut(sourceIndex, TEST_PAGE_SIZE, 2, 0x10, 3);
+
+        destination = bufNew(TEST_BLOCK_SIZE * 4);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNew(
+                    TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 8, false, 1, 6, 0, map, TEST_LSN_PRIOR, TEST_PAGE_SIZE, blockIndex, NULL,
+                    NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, sourceIndex), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(
+                blockMapNewRead(
+                    ioBufferReadNewOpen(BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize)),
+                    TEST_BLOCK_SIZE, 8),
+                TEST_BLOCK_SIZE, 8),
+            "read {reference: 1, bundleId: 6, offset: 0, size: 512}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 512}\n"
+            "read {reference: 0, bundleId: 4, offset: 512, size: 512}\n"
+            "  super block {max: 512, size: 512}\n"
+            "    block {no: 0, offset: 0}\n",
+            "check delta");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("lsn check is disabled when blocks are not fixed or pages do not fit");
+
+        IoFilter *filter = NULL;
+
+        TEST_ASSIGN(filter, blockIncrNew(8, 4, 8, true, 1, 0, 0, mapPage, TEST_LSN_PRIOR, TEST_PAGE_SIZE, NULL, NULL, NULL), "cdc");
+        TEST_RESULT_UINT(((BlockIncr *)ioFilterDriver(filter))->blockMapPriorLsn, 0, "lsn check disabled");
+
+        TEST_ASSIGN(
+            filter,
+            blockIncrNew(
+                TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 8, false, 1, 0, 0, NULL, TEST_LSN_PRIOR, TEST_PAGE_SIZE, NULL, NULL, NULL),
+            "no prior map");
+        TEST_RESULT_UINT(((BlockIncr *)ioFilterDriver(filter))->blockMapPriorLsn, 0, "lsn check disabled");
+
+        TEST_ASSIGN(
+            filter,
+            blockIncrNew(TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 8, false, 1, 0, 0, mapPage, TEST_LSN_PRIOR, 384, NULL, NULL, NULL),
+            "page size does not fit");
+        TEST_RESULT_UINT(((BlockIncr *)ioFilterDriver(filter))->blockMapPriorLsn, 0, "lsn check disabled");
+
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8, 4, 8, true, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL)),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, BUFSTRDEF("ABCDEFGH")), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        TEST_ASSIGN(mapSize, pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE)), "map size");
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+
+        TEST_ASSIGN(
+            filter,
+            blockIncrNew(
+                TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 8, false, 1, 0, 0, map, TEST_LSN_PRIOR, TEST_PAGE_SIZE, NULL, NULL, NULL),
+            "prior map is variable");
+        TEST_RESULT_UINT(((BlockIncr *)ioFilterDriver(filter))->blockMapPriorLsn, 0, "lsn check disabled");
+
+        #undef TEST_PAGE_SIZE
+        #undef TEST_BLOCK_SIZE
+        #undef TEST_LSN_PRIOR
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupLabelCreate()"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        time_t timestamp = 1575401652;
+        String *backupLabel = backupLabelFormat(backupTypeFull, NULL, timestamp);
+        const String *const olderBackupLabel = backupLabelFormat(backupTypeFull, NULL, timestamp - 3);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("assign label when no history");
+
+        HRN_STORAGE_PATH_CREATE(storageRepoWrite(), STORAGE_REPO_BACKUP "/backup.history/2019");
+
+        TEST_RESULT_STR(backupLabelCreate(backupTypeFull, NULL, timestamp), backupLabel, "create label");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("assign label when history is older");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            zNewFmt(
+                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
+                strZ(backupLabelFormat(backupTypeFull, NULL, timestamp - 4))));
+
+        TEST_RESULT_STR(backupLabelCreate(backupTypeFull, NULL, timestamp), backupLabel, "create label");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("assign label when backup is older");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(olderBackupLabel)));
+
+        TEST_RESULT_STR(backupLabelCreate(backupTypeFull, NULL, timestamp), backupLabel, "create label");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (full only)");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            zNewFmt(
+                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
+                strZ(backupLabelFormat(backupTypeFull, NULL, timestamp - 1))));
+
+        TEST_RESULT_STR(
+            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp),
+            backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp),
+            "create label");
+
+        TEST_RESULT_STR(
+            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp),
+            backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp),
+            "create label");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (diff exists)");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            zNewFmt(
+                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
+                strZ(backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp - 2))));
+
+        TEST_RESULT_STR(
+            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp),
+            backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp),
+            "create label");
+
+        TEST_RESULT_STR(
+            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp),
+            backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp),
+            "create label");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (diff and incr)");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            zNewFmt(
+                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
+                strZ(backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp - 1))));
+
+        TEST_RESULT_STR(
+            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp),
+            backupLabelFormat(backupTypeDiff, olderBackupLabel, timestamp),
+            "create label");
+
+        TEST_RESULT_STR(
+            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp),
+            backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp),
+            "create label");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("differential and incremental backups read history related to full backup they are created on (skew)");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            zNewFmt(
+                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
+                strZ(backupLabelFormat(backupTypeIncr, olderBackupLabel, timestamp + 3))));
+
+        TEST_ERROR(
+            backupLabelCreate(backupTypeDiff, olderBackupLabel, timestamp), ClockError,
+            "new backup label '20191203-193409F_20191203-193413D' is not later "
+            "than latest backup label '20191203-193409F_20191203-193415I'\n"
+            "HINT: has the timezone changed?\n"
+            "HINT: is there clock skew?");
+
+        TEST_ERROR(
+            backupLabelCreate(backupTypeIncr, olderBackupLabel, timestamp), ClockError,
+            "new backup label '20191203-193409F_20191203-193413I' is not later "
+            "than latest backup label '20191203-193409F_20191203-193415I'\n"
+            "HINT: has the timezone changed?\n"
+            "HINT: is there clock skew?");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("advance time when backup is same");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(backupLabelFormat(backupTypeFull, NULL, timestamp))));
+
+        TEST_RESULT_STR_Z(backupLabelCreate(backupTypeFull, NULL, timestamp), "20191203-193413F", "create label");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when new label is in the past even with advanced time");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(backupLabelFormat(backupTypeFull, NULL, timestamp + 1))));
+
+        TEST_ERROR(
+            backupLabelCreate(backupTypeFull, NULL, timestamp), ClockError,
+            "new backup label '20191203-193413F' is not later than latest backup label '20191203-193413F'\n"
+            "HINT: has the timezone changed?\n"
+            "HINT: is there clock skew?");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when new label is in the past even with advanced time (from history)");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            zNewFmt(
+                STORAGE_REPO_BACKUP "/backup.history/2019/%s.manifest.gz",
+                strZ(backupLabelFormat(backupTypeFull, NULL, timestamp + 3600))));
+
+        TEST_ERROR(
+            backupLabelCreate(backupTypeFull, NULL, timestamp), ClockError,
+            "new backup label '20191203-193413F' is not later than latest backup label '20191203-203412F'\n"
+            "HINT: has the timezone changed?\n"
+            "HINT: is there clock skew?");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupInit()"))
+    {
+        // Set log level to detail
+        harnessLogLevelSet(logLevelDetail);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("warn and reset when backup from standby used in offline mode");
+
+        // Create pg_control
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_96);
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptBackupStandby, true);
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(
+            backupInit(infoBackupNew(PG_VERSION_96, HRN_PG_SYSTEMID_96, hrnPgCatalogVersion(PG_VERSION_96), NULL)), "backup init");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: option backup-standby is enabled but backup is offline - backups will be performed from the primary");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when pg_control does not match stanza");
+
+        // Create pg_control
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_10);
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_ERROR(
+            backupInit(infoBackupNew(PG_VERSION_11, HRN_PG_SYSTEMID_11, hrnPgCatalogVersion(PG_VERSION_11), NULL)),
+            BackupMismatchError,
+            "PostgreSQL version 10, system-id " HRN_PG_SYSTEMID_10_Z " do not match stanza version 11, system-id"
+            " " HRN_PG_SYSTEMID_11_Z "\n"
+            "HINT: is this the correct stanza?");
+        TEST_ERROR(
+            backupInit(infoBackupNew(PG_VERSION_10, HRN_PG_SYSTEMID_11, hrnPgCatalogVersion(PG_VERSION_10), NULL)),
+            BackupMismatchError,
+            "PostgreSQL version 10, system-id " HRN_PG_SYSTEMID_10_Z " do not match stanza version 10, system-id"
+            " " HRN_PG_SYSTEMID_11_Z "\n"
+            "HINT: is this the correct stanza?");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("reset checksum-page when the cluster does not have checksums enabled");
+
+        // Create pg_control
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+
+        // Create stanza
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+
+        cmdStanzaCreate();
+        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptChecksumPage, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_PQ_SCRIPT_SET(
+            // Connect to primary
+            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL));
+
+        TEST_RESULT_VOID(
+            dbFree(
+                backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL))->dbPrimary),
+            "backup init");
+        TEST_RESULT_BOOL(cfgOptionBool(cfgOptChecksumPage), false, "check checksum-page");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: checksum-page option set to true but checksums are not enabled on the cluster, resetting to false");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("ok if cluster checksums are enabled and checksum-page is any value");
+
+        // Create pg_control with page checksums
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95, .pageChecksumVersion = 1);
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_PQ_SCRIPT_SET(
+            // Connect to primary
+            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL));
+
+        TEST_RESULT_VOID(
+            dbFree(
+                backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL))->dbPrimary),
+            "backup init");
+        TEST_RESULT_BOOL(cfgOptionBool(cfgOptChecksumPage), false, "check checksum-page");
+
+        // Create pg_control without page checksums
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+
+        HRN_PQ_SCRIPT_SET(
+            // Connect to primary
+            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL));
+
+        TEST_RESULT_VOID(
+            dbFree(
+                backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL))->dbPrimary),
+            "backup init");
+        TEST_RESULT_BOOL(cfgOptionBool(cfgOptChecksumPage), false, "check checksum-page");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("reset wal-summary when PostgreSQL < 17 or offline");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptWalSummary, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_PQ_SCRIPT_SET(
+            // Connect to primary
+            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL));
+
+        TEST_RESULT_VOID(
+            dbFree(
+                backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL))->dbPrimary),
+            "backup init");
+        TEST_RESULT_BOOL(cfgOptionBool(cfgOptWalSummary), false, "check wal-summary");
+
+        TEST_RESULT_LOG("P00   WARN: wal-summary option requires an online backup of PostgreSQL >= 17, resetting to false");
+
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(
+            backupInit(infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL)), "backup init");
+        TEST_RESULT_BOOL(cfgOptionBool(cfgOptWalSummary), false, "check wal-summary");
+
+        TEST_RESULT_LOG("P00   WARN: wal-summary option requires an online backup of PostgreSQL >= 17, resetting to false");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("wal-summary is allowed on PostgreSQL >= 17");
+
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_17);
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptWalSummary, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_PQ_SCRIPT_SET(
+            // Connect to primary
+            HRN_PQ_SCRIPT_OPEN_GE_96(1, "dbname='postgres' port=5432", PG_VERSION_17, TEST_PATH "/pg1", false, NULL, NULL));
+
+        TEST_RESULT_VOID(
+            dbFree(
+                backupInit(infoBackupNew(PG_VERSION_17, HRN_PG_SYSTEMID_17, hrnPgCatalogVersion(PG_VERSION_17), NULL))->dbPrimary),
+            "backup init");
+        TEST_RESULT_BOOL(cfgOptionBool(cfgOptWalSummary), true, "check wal-summary");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compress-thread is only valid with zst");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        hrnCfgArgRawZ(argList, cfgOptCompressThread, "2");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_ERROR(
+            backupInit(infoBackupNew(PG_VERSION_17, HRN_PG_SYSTEMID_17, hrnPgCatalogVersion(PG_VERSION_17), NULL)),
+            OptionInvalidError, "compress-thread option is only valid when compress-type=zst");
+
+        hrnCfgArgRawZ(argList, cfgOptCompressType, "zst");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(
+            backupInit(infoBackupNew(PG_VERSION_17, HRN_PG_SYSTEMID_17, hrnPgCatalogVersion(PG_VERSION_17), NULL)), "backup init");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupTime()"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("sleep retries and stall error");
+
+        // Create pg_control
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+
+        // Create stanza
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+
+        cmdStanzaCreate();
+        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_PQ_SCRIPT_SET(
+            // Connect to primary
+            HRN_PQ_SCRIPT_OPEN_GE_93(1, "dbname='postgres' port=5432", PG_VERSION_95, TEST_PATH "/pg1", false, NULL, NULL),
+
+            // Advance the time slowly to force retries
+            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392588998),
+            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392588999),
+            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589001),
+
+            // Stall time to force an error
+            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589998),
+            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589997),
+            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589998),
+            HRN_PQ_SCRIPT_TIME_QUERY(1, 1575392589999));
+
+        BackupData *backupData = backupInit(
+            infoBackupNew(PG_VERSION_95, HRN_PG_SYSTEMID_95, hrnPgCatalogVersion(PG_VERSION_95), NULL));
+
+        TEST_RESULT_INT(backupTime(backupData, true), 1575392588, "multiple tries for sleep");
+        TEST_ERROR(backupTime(backupData, true), KernelError, "PostgreSQL clock has not advanced to the next second after 3 tries");
+
+        dbFree(backupData->dbPrimary);
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupResumeFind()"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+        hrnCfgArgRawBool(argList, cfgOptCompress, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when manifest and copy are missing");
+
+        HRN_STORAGE_PATH_CREATE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F");
+
+        TEST_RESULT_PTR(backupResumeFind((Manifest *)1, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: backup '20191003-105320F' cannot be resumed: partially deleted by prior resume or invalid");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when resume is disabled");
+
+        HRN_STORAGE_PATH_CREATE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F");
+
+        cfgOptionSet(cfgOptResume, cfgSourceParam, BOOL_FALSE_VAR);
+
+        HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT);
+
+        TEST_RESULT_PTR(backupResumeFind((Manifest *)1, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG("P00   INFO: backup '20191003-105320F' cannot be resumed: resume is disabled");
+
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+
+        cfgOptionSet(cfgOptResume, cfgSourceParam, BOOL_TRUE_VAR);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when error on manifest load");
+
+        Manifest *manifest = NULL;
+
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifest = manifestNewInternal();
+            manifest->pub.data.backupType = backupTypeFull;
+            manifest->pub.data.backrestVersion = STRDEF("BOGUS");
+        }
+        OBJ_NEW_END();
+
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, "X");
+
+        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: backup '20191003-105320F' cannot be resumed: unable to read"
+            " <REPO:BACKUP>/20191003-105320F/backup.manifest.copy");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when pgBackRest version has changed");
+
+        Manifest *manifestResume = NULL;
+
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifestResume = manifestNewInternal();
+            manifestResume->pub.info = infoNew(NULL);
+            manifestResume->pub.data.backupType = backupTypeFull;
+            manifestResume->pub.data.backupLabel = strNewZ("20191003-105320F");
+            manifestResume->pub.data.pgVersion = PG_VERSION_12;
+        }
+        OBJ_NEW_END();
+
+        HRN_MANIFEST_TARGET_ADD(manifestResume, .name = MANIFEST_TARGET_PGDATA, .path = "/pg");
+        HRN_MANIFEST_PATH_ADD(manifestResume, .name = MANIFEST_TARGET_PGDATA);
+        HRN_MANIFEST_FILE_ADD(manifestResume, .name = "pg_data/" PG_FILE_PGVERSION);
+
+        manifestSave(
+            manifestResume,
+            storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+
+        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
+            " new pgBackRest version 'BOGUS' does not match resumable pgBackRest version '" PROJECT_VERSION "'");
+
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+
+        manifest->pub.data.backrestVersion = STRDEF(PROJECT_VERSION);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when backup labels do not match (resumable is null)");
+
+        manifest->pub.data.backupType = backupTypeFull;
+        manifest->pub.data.backupLabelPrior = STRDEF("20191003-105320F");
+
+        manifestSave(
+            manifestResume,
+            storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+
+        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
+            " new prior backup label '<undef>' does not match resumable prior backup label '20191003-105320F'");
+
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+
+        manifest->pub.data.backupLabelPrior = NULL;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when backup labels do not match (new is null)");
+
+        manifest->pub.data.backupType = backupTypeFull;
+        manifestResume->pub.data.backupLabelPrior = STRDEF("20191003-105320F");
+
+        manifestSave(
+            manifestResume,
+            storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+
+        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
+            " new prior backup label '20191003-105320F' does not match resumable prior backup label '<undef>'");
+
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+
+        manifestResume->pub.data.backupLabelPrior = NULL;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when compression does not match");
+
+        manifestResume->pub.data.backupOptionCompressType = compressTypeGz;
+
+        manifestSave(
+            manifestResume,
+            storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+
+        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: backup '20191003-105320F' cannot be resumed:"
+            " new compression 'none' does not match resumable compression 'gz'");
+
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+
+        manifestResume->pub.data.backupOptionCompressType = compressTypeNone;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cannot resume when journal is invalid");
+
+        manifestSave(
+            manifestResume,
+            storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_JOURNAL_FILE ".00000001", "BOGUS");
+
+        TEST_RESULT_PTR(backupResumeFind(manifest, NULL), NULL, "find resumable backup");
+
+        TEST_RESULT_LOG(
+            "P00   WARN: backup '20191003-105320F' cannot be resumed: unable to replay"
+            " <REPO:BACKUP>/20191003-105320F/backup.manifest journal");
+
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("resume with files updated by the journal");
+
+        manifestSave(
+            manifestResume,
+            storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+
+        StringList *const journal = strLstNew();
+        strLstAddZ(journal, "pg_data/" PG_FILE_PGVERSION);
+
+        ManifestFile file = manifestFileFind(manifestResume, STRDEF("pg_data/" PG_FILE_PGVERSION));
+        file.size = 3;
+        file.sizeRepo = 3;
+        file.checksumSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("06d06bb31b570b94d7b4325f511f853dbe771c21")));
+        file.checksumRepoSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("06d06bb31b570b94d7b4325f511f853dbe771c21")));
+        manifestFileUpdate(manifestResume, &file);
+
+        unsigned int journalSegment = 0;
+
+        TEST_RESULT_VOID(backupManifestJournalWrite(manifestResume, strLstNew(), &journalSegment, NULL), "no files to write");
+        TEST_RESULT_UINT(journalSegment, 0, "no segment written");
+        TEST_RESULT_VOID(backupManifestJournalWrite(manifestResume, journal, &journalSegment, NULL), "write journal segment");
+        TEST_RESULT_UINT(journalSegment, 1, "segment written");
+
+        file.sizeRepo = 23;
+        file.checksumRepoSha1 = NULL;
+        file.compressNone = true;
+        manifestFileUpdate(manifestResume, &file);
+
+        TEST_RESULT_VOID(backupManifestJournalWrite(manifestResume, journal, &journalSegment, NULL), "write journal segment");
+        TEST_RESULT_UINT(journalSegment, 2, "segment written");
+
+        const Manifest *manifestFound = NULL;
+
+        TEST_ASSIGN(manifestFound, backupResumeFind(manifest, NULL), "find resumable backup");
+
+        file = manifestFileFind(manifestFound, STRDEF("pg_data/" PG_FILE_PGVERSION));
+        TEST_RESULT_UINT(file.size, 3, "size");
+        TEST_RESULT_UINT(file.sizeRepo, 23, "repo size from last segment");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE)), "06d06bb31b570b94d7b4325f511f853dbe771c21",
+            "checksum");
+        TEST_RESULT_PTR(file.checksumRepoSha1, NULL, "no repo checksum");
+        TEST_RESULT_BOOL(file.compressNone, true, "compress none");
+
+        TEST_STORAGE_LIST(
+            storageRepo(), STORAGE_REPO_BACKUP "/20191003-105320F",
+            "backup.manifest.copy\n"
+            "backup.manifest.journal.00000001\n"
+            "backup.manifest.journal.00000002\n",
+            .comment = "journal is preserved");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remove journal");
+
+        TEST_RESULT_VOID(backupManifestJournalRemove(manifestResume), "remove journal");
+
+        TEST_STORAGE_LIST(
+            storageRepo(), STORAGE_REPO_BACKUP "/20191003-105320F", "backup.manifest.copy\n", .comment = "journal is removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("resume replays the journal written by an interrupted resume");
+
+        // Journal written by the first backup before it was interrupted
+        journalSegment = 0;
+
+        file.sizeRepo = 33;
+        manifestFileUpdate(manifestResume, &file);
+        TEST_RESULT_VOID(backupManifestJournalWrite(manifestResume, journal, &journalSegment, NULL), "write journal segment");
+
+        file.sizeRepo = 43;
+        manifestFileUpdate(manifestResume, &file);
+        TEST_RESULT_VOID(backupManifestJournalWrite(manifestResume, journal, &journalSegment, NULL), "write journal segment");
+
+        // The resume replays the journal and saves the manifest copy before processing, which removes the journal
+        Manifest *manifestInterrupted = NULL;
+
+        TEST_ASSIGN(
+            manifestInterrupted,
+            manifestLoadFileP(
+                storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE), cipherTypeNone, NULL),
+            "load manifest copy");
+        TEST_RESULT_VOID(backupManifestJournalReplay(manifestInterrupted, NULL), "replay journal");
+        TEST_RESULT_UINT(manifestFileFind(manifestInterrupted, STRDEF("pg_data/" PG_FILE_PGVERSION)).sizeRepo, 43, "repo size");
+
+        TEST_RESULT_VOID(backupManifestSaveCopy(manifestInterrupted, NULL, false), "save manifest copy");
+        TEST_STORAGE_LIST(
+            storageRepo(), STORAGE_REPO_BACKUP "/20191003-105320F", "backup.manifest.copy\n", .comment = "journal is removed");
+
+        // Journal written by the resume before it was also interrupted. Segments are numbered from the start again.
+        journalSegment = 0;
+
+        file = manifestFileFind(manifestInterrupted, STRDEF("pg_data/" PG_FILE_PGVERSION));
+        file.sizeRepo = 53;
+        manifestFileUpdate(manifestInterrupted, &file);
+        TEST_RESULT_VOID(backupManifestJournalWrite(manifestInterrupted, journal, &journalSegment, NULL), "write journal segment");
+
+        file.sizeRepo = 63;
+        file.compressNone = false;
+        manifestFileUpdate(manifestInterrupted, &file);
+        TEST_RESULT_VOID(backupManifestJournalWrite(manifestInterrupted, journal, &journalSegment, NULL), "write journal segment");
+        TEST_RESULT_UINT(journalSegment, 2, "segments written");
+
+        TEST_ASSIGN(manifestFound, backupResumeFind(manifest, NULL), "find resumable backup");
+
+        file = manifestFileFind(manifestFound, STRDEF("pg_data/" PG_FILE_PGVERSION));
+        TEST_RESULT_UINT(file.sizeRepo, 63, "repo size from last segment of the resume");
+        TEST_RESULT_BOOL(file.compressNone, false, "compress none from last segment of the resume");
+
+        TEST_STORAGE_LIST(
+            storageRepo(), STORAGE_REPO_BACKUP "/20191003-105320F",
+            "backup.manifest.copy\n"
+            "backup.manifest.journal.00000001\n"
+            "backup.manifest.journal.00000002\n",
+            .comment = "journal is preserved");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupBlockIncrLsn()"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("lsn for references that are in backup.info with a start lsn");
+
+        InfoBackup *infoBackup = NULL;
+
+        TEST_ASSIGN(
+            infoBackup,
+            infoBackupNewLoad(
+                ioBufferReadNew(
+                    harnessInfoChecksumZ(
+                        "[backup:current]\n"
+                        "20191003-105320F={\"backrest-format\":5,\"backrest-version\":\"2.55.0\","
+                        "\"backup-archive-start\":\"000000010000000000000002\","
+                        "\"backup-archive-stop\":\"000000010000000000000002\",\"backup-info-repo-size\":1,"
+                        "\"backup-info-repo-size-delta\":1,\"backup-info-size\":1,\"backup-info-size-delta\":1,"
+                        "\"backup-lsn-start\":\"285/89000028\",\"backup-lsn-stop\":\"285/89001F88\","
+                        "\"backup-timestamp-start\":1570099920,\"backup-timestamp-stop\":1570099921,\"backup-type\":\"full\","
+                        "\"db-id\":1,\"option-archive-check\":true,\"option-archive-copy\":false,"
+                        "\"option-backup-standby\":false,\"option-checksum-page\":true,\"option-compress\":false,"
+                        "\"option-hardlink\":false,\"option-online\":true}\n"
+                        "20191003-105320F_20191004-144000D={\"backrest-format\":5,\"backrest-version\":\"2.55.0\","
+                        "\"backup-info-repo-size\":1,\"backup-info-repo-size-delta\":1,\"backup-info-size\":1,"
+                        "\"backup-info-size-delta\":1,\"backup-prior\":\"20191003-105320F\","
+                        "\"backup-reference\":[\"20191003-105320F\"],"
+                        "\"backup-timestamp-start\":1570200000,\"backup-timestamp-stop\":1570200001,\"backup-type\":\"diff\","
+                        "\"db-id\":1,\"option-archive-check\":false,\"option-archive-copy\":false,"
+                        "\"option-backup-standby\":false,\"option-checksum-page\":true,\"option-compress\":false,"
+                        "\"option-hardlink\":false,\"option-online\":false}\n"
+                        "\n"
+                        "[db]\n"
+                        "db-catalog-version=201909212\n"
+                        "db-control-version=1201\n"
+                        "db-id=1\n"
+                        "db-system-id=6569239123849665679\n"
+                        "db-version=\"12\"\n"
+                        "\n"
+                        "[db:history]\n"
+                        "1={\"db-catalog-version\":201909212,\"db-control-version\":1201,\"db-system-id\":6569239123849665679,"
+                        "\"db-version\":\"12\"}\n"))),
+            "load backup.info");
+
+        Manifest *manifest = NULL;
+
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifest = manifestNewInternal();
+            manifest->pub.referenceList = strLstNewSplitZ(
+                STRDEF("20191002-000000F,20191003-105320F,20191003-105320F_20191004-144000D"), ",");
+        }
+        OBJ_NEW_END();
+
+        KeyValue *lsnKv = NULL;
+
+        TEST_ASSIGN(lsnKv, backupBlockIncrLsn(infoBackup, manifest), "get lsns");
+        TEST_RESULT_STRLST_Z(strLstNewVarLst(kvKeyList(lsnKv)), "20191003-105320F\n", "check references");
+        TEST_RESULT_UINT(varUInt64(kvGet(lsnKv, VARSTRDEF("20191003-105320F"))), 0x28589000028, "check lsn");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupWalSummary()"))
+    {
+        #define TEST_WAL_SUMMARY_PATH                               "pg_wal/" PG_PATH_WAL_SUMMARY
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        BackupData backupData = {.storagePrimary = storagePg(), .version = PG_VERSION_17, .pageSize = pgPageSize8};
+        Manifest *manifestPrior = NULL;
+
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifestPrior = manifestNewInternal();
+            manifestPrior->pub.data.archiveStart = strNewZ("000000010000000000000001");
+        }
+        OBJ_NEW_END();
+
+        // Summary containing base/1/16386 (magic, entry, terminating entry, crc)
+        Buffer *const summary = bufNew(0);
+        const uint32_t summaryData[] = {0x652b137b, 1663, 1, 16386, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+        bufCatC(summary, (const unsigned char *)summaryData, 0, sizeof(summaryData));
+
+        const uint32_t summaryCrc = crc32cUpdate(CRC32C_INIT, bufPtrConst(summary), bufUsed(summary)) ^ CRC32C_INIT;
+        bufCatC(summary, (const unsigned char *)&summaryCrc, 0, sizeof(summaryCrc));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("summaries are not used");
+
+        TEST_RESULT_PTR(
+            backupWalSummary(&backupData, manifestPrior, STRDEF("0/3000028"), STRDEF("000000010000000000000003")), NULL,
+            "wal-summary disabled");
+
+        hrnCfgArgRawBool(argList, cfgOptWalSummary, true);
+        hrnCfgArgRawBool(argList, cfgOptDelta, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        backupData.storagePrimary = storagePg();
+
+        TEST_RESULT_PTR(
+            backupWalSummary(&backupData, manifestPrior, STRDEF("0/3000028"), STRDEF("000000010000000000000003")), NULL,
+            "delta enabled");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptWalSummary, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        backupData.storagePrimary = storagePg();
+
+        TEST_RESULT_PTR(
+            backupWalSummary(&backupData, manifestPrior, STRDEF("0/3000028"), STRDEF("000000010000000000000003")), NULL,
+            "prior backup offline");
+
+        manifestPrior->pub.data.lsnStart = strNewZ("0/1000028");
+
+        TEST_RESULT_PTR(
+            backupWalSummary(&backupData, manifestPrior, STRDEF("0/3000028"), STRDEF("000000020000000000000003")), NULL,
+            "timeline switch");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("summaries do not cover the range");
+
+        TEST_RESULT_PTR(
+            backupWalSummary(&backupData, manifestPrior, STRDEF("0/3000028"), STRDEF("000000010000000000000003")), NULL,
+            "no summaries");
+        TEST_RESULT_LOG(
+            "P00   WARN: WAL summaries do not cover lsn 0/1000028 to 0/3000028, unable to skip unmodified files\n"
+            "            HINT: is summarize_wal enabled?");
+
+        HRN_STORAGE_PUT(storagePgWrite(), TEST_WAL_SUMMARY_PATH "/0000000100000000010000280000000002000000.summary", summary);
+
+        TEST_RESULT_PTR(
+            backupWalSummary(&backupData, manifestPrior, STRDEF("0/3000028"), STRDEF("000000010000000000000003")), NULL,
+            "summaries end before backup start");
+        TEST_RESULT_LOG(
+            "P00   WARN: WAL summaries do not cover lsn 0/1000028 to 0/3000028, unable to skip unmodified files\n"
+            "            HINT: is summarize_wal enabled?");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("summaries cover the range");
+
+        HRN_STORAGE_PUT(storagePgWrite(), TEST_WAL_SUMMARY_PATH "/0000000100000000020000000000000003000028.summary", summary);
+
+        WalSummary *walSummary = NULL;
+
+        TEST_ASSIGN(
+            walSummary, backupWalSummary(&backupData, manifestPrior, STRDEF("0/3000028"), STRDEF("000000010000000000000003")),
+            "load summaries");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/1/16386")), true, "modified");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/1/16385")), false, "not modified");
+        TEST_RESULT_LOG("P00 DETAIL: loaded 2 WAL summaries covering lsn 0/1000028 to 0/3000028");
+
+        #undef TEST_WAL_SUMMARY_PATH
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupBuildPathList()"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        BackupData backupData = {.storagePrimary = storagePg()};
+        const unsigned int catalogVersion = hrnPgCatalogVersion(PG_VERSION_15);
+        const String *const tablespaceId = pgTablespaceId(PG_VERSION_15, catalogVersion);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("paths are not listed with a single process");
+
+        TEST_RESULT_PTR(
+            backupBuildPathList(&backupData, PG_VERSION_15, catalogVersion, BACKUP_BUILD_PATH_RESULT_MAX), NULL, "no list");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("paths are not listed when backing up from a standby");
+
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        backupData.storagePrimary = storagePg();
+        backupData.storageStandby = storagePg();
+
+        TEST_RESULT_PTR(
+            backupBuildPathList(&backupData, PG_VERSION_15, catalogVersion, BACKUP_BUILD_PATH_RESULT_MAX), NULL, "no list");
+
+        backupData.storageStandby = NULL;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("list database paths with one entry per result so paths are split across results");
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "15");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL);
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_PATH_BASE "/1/1", "1");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_PATH_BASE "/1/" PG_FILE_PGVERSION);
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_PATH_BASE "/16384/16385", "22");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_PATH_BASE "/16384/t1_16386");
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), PG_PATH_BASE "/16387");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_PATH_BASE "/file");
+        HRN_STORAGE_PUT_Z(storageTest, zNewFmt("pg1-tblspc/16400/%s/16384/16401", strZ(tablespaceId)), "333");
+        HRN_STORAGE_PATH_CREATE(storageTest, "pg1-tblspc/16410");
+        HRN_STORAGE_PUT_EMPTY(storageTest, "pg1-tblspc/16430");
+
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), PG_PATH_PGTBLSPC);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_PATH_PGTBLSPC "/file");
+
+        const char *const linkList[][2] =
+        {
+            {"../../pg1-tblspc/16400", "16400"},
+            {"../../pg1-tblspc/16410", "16410"},
+            {"../../pg1-tblspc/16420", "16420"},
+            {"../../pg1-tblspc/16430", "16430"},
+        };
+
+        for (unsigned int linkIdx = 0; linkIdx < LENGTH_OF(linkList); linkIdx++)
+        {
+            THROW_ON_SYS_ERROR(
+                symlink(
+                    linkList[linkIdx][0],
+                    strZ(storagePathP(storagePg(), strNewFmt(PG_PATH_PGTBLSPC "/%s", linkList[linkIdx][1])))) == -1,
+                FileOpenError, "unable to create symlink");
+        }
+
+        List *buildPathList = NULL;
+
+        TEST_ASSIGN(buildPathList, backupBuildPathList(&backupData, PG_VERSION_15, catalogVersion, 1), "list");
+
+        StringList *const pathList = strLstNew();
+
+        for (unsigned int buildPathIdx = 0; buildPathIdx < lstSize(buildPathList); buildPathIdx++)
+        {
+            const ManifestBuildPath *const buildPath = lstGet(buildPathList, buildPathIdx);
+
+            strLstAddFmt(pathList, "%s (%u)", strZ(buildPath->path), storageLstSize(buildPath->list));
+        }
+
+        TEST_RESULT_STR(
+            strLstJoin(pathList, "\n"),
+            strNewFmt(
+                TEST_PATH "/pg1/base/1 (2)\n"
+                TEST_PATH "/pg1/base/16384 (2)\n"
+                TEST_PATH "/pg1/base/16387 (0)\n"
+                TEST_PATH "/pg1/global (1)\n"
+                TEST_PATH "/pg1/pg_tblspc/16400/%s/16384 (1)",
+                strZ(tablespaceId)),
+            "paths");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("skip entries removed after the path was listed");
+
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_PATH_BASE "/16387/16388");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_PATH_BASE "/16387/16389");
+
+        ProtocolClient *const pathListClient = protocolLocalGet(protocolStorageTypePg, 0, 1);
+        PackWrite *pathListParam = protocolPackNew();
+        PackRead *pathListRead = NULL;
+
+        pckWriteStrP(pathListParam, STRDEF(PG_PATH_BASE "/16387"));
+        pckWriteBoolP(pathListParam, false);
+        pckWriteU32P(pathListParam, 1);
+
+        TEST_ASSIGN(
+            pathListRead, protocolClientRequestP(pathListClient, PROTOCOL_COMMAND_BACKUP_PATH_LIST, .param = pathListParam),
+            "list first entry");
+        pckReadArrayBeginP(pathListRead);
+        pckReadObjBeginP(pathListRead);
+        TEST_RESULT_STR_Z(pckReadStrP(pathListRead), "16388", "first entry");
+        pckReadObjEndP(pathListRead);
+        pckReadArrayEndP(pathListRead);
+        TEST_RESULT_BOOL(pckReadBoolP(pathListRead), true, "more entries");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_PATH_BASE "/16387/16389");
+
+        for (unsigned int continueIdx = 0; continueIdx < 2; continueIdx++)
+        {
+            pathListParam = protocolPackNew();
+            pckWriteStrP(pathListParam, STRDEF(PG_PATH_BASE "/16387"));
+            pckWriteBoolP(pathListParam, true);
+            pckWriteU32P(pathListParam, 1);
+
+            TEST_ASSIGN(
+                pathListRead, protocolClientRequestP(pathListClient, PROTOCOL_COMMAND_BACKUP_PATH_LIST, .param = pathListParam),
+                continueIdx == 0 ? "continue listing" : "continue complete path");
+            pckReadArrayBeginP(pathListRead);
+            TEST_RESULT_BOOL(pckReadNext(pathListRead), false, "no entries (removed entry skipped)");
+            pckReadArrayEndP(pathListRead);
+            TEST_RESULT_BOOL(pckReadBoolP(pathListRead), false, "no more entries");
+        }
+
+        protocolHelperFree(pathListClient);
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_PATH_BASE "/16387/16388");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("manifest built from listed paths matches manifest built by iterating paths");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_PATH_PGTBLSPC "/file");
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_PATH_PGTBLSPC "/16410");
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_PATH_PGTBLSPC "/16420");
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_PATH_PGTBLSPC "/16430");
+
+        Buffer *const manifestIterate = bufNew(0);
+        Buffer *const manifestList = bufNew(0);
+
+        TEST_RESULT_VOID(
+            manifestSave(
+                manifestNewBuild(
+                    storagePg(), PG_VERSION_15, catalogVersion, 0, false, false, false, false, NULL, NULL, NULL, NULL),
+                ioBufferWriteNew(manifestIterate)),
+            "build by iterating paths");
+        TEST_RESULT_VOID(
+            manifestSave(
+                manifestNewBuild(
+                    storagePg(), PG_VERSION_15, catalogVersion, 0, false, false, false, false, NULL, NULL, NULL, buildPathList),
+                ioBufferWriteNew(manifestList)),
+            "build from listed paths");
+        TEST_RESULT_STR(strNewBuf(manifestList), strNewBuf(manifestIterate), "manifests match");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when a path cannot be listed");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg-missing");
+        hrnCfgArgKeyRawZ(argList, cfgOptPgPath, 2, TEST_PATH "/pg2");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        backupData.storagePrimary = storagePgIdx(0);
+        backupData.pgIdxPrimary = 1;
+
+        HRN_STORAGE_PUT_EMPTY(storageTest, "pg2/" PG_PATH_GLOBAL);
+
+        TEST_ERROR(
+            backupBuildPathList(&backupData, PG_VERSION_15, catalogVersion, BACKUP_BUILD_PATH_RESULT_MAX), PathOpenError,
+            "raised from local-1 shim protocol: unable to list file info for path '" TEST_PATH "/pg2/global': [20] Not a"
+            " directory");
+
+        // Free local processes that were not freed because of the error
+        protocolFree();
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupJobResult()"))
+    {
+        // Set log level to detail
+        harnessLogLevelSet(logLevelDetail);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("report job error");
+
+        ProtocolParallelJob *job = protocolParallelJobNew(VARSTRDEF("key"), strIdFromZ("x"), NULL);
+        protocolParallelJobErrorSet(job, errorTypeCode(&AssertError), STRDEF("error message"));
+
+        unsigned int currentPercentComplete = 0;
+
+        TEST_ERROR(
+            backupJobResult(
+                (Manifest *)1, NULL, storageTest, strLstNew(), NULL, NULL, job, false, pgPageSize8, 0, NULL,
+                &currentPercentComplete),
+            AssertError, "error message");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("report host/100% progress on noop result");
+
+        // Create job that skips file
+        job = protocolParallelJobNew(VARSTRDEF("pg_data/test"), strIdFromZ("x"), NULL);
+
+        PackWrite *const resultPack = protocolPackNew();
+        pckWriteStrP(resultPack, STRDEF("pg_data/test"));
+        pckWriteU32P(resultPack, backupCopyResultNoOp);
+        // No more fields need to be written since noop will ignore them anyway
+        pckWriteEndP(resultPack);
+
+        protocolParallelJobResultSet(job, pckReadNew(pckWriteResult(resultPack)));
+
+        // Create manifest with file
+        Manifest *manifest = NULL;
+
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifest = manifestNewInternal();
+            HRN_MANIFEST_FILE_ADD(manifest, .name = "pg_data/test");
+        }
+        OBJ_NEW_END();
+
+        uint64_t sizeProgress = 0;
+        currentPercentComplete = 4567;
+
+        lockInit(TEST_PATH_STR, cfgOptionStr(cfgOptExecId));
+        TEST_RESULT_VOID(cmdLockAcquireP(), "acquire backup lock");
+
+        TEST_RESULT_VOID(
+            backupJobResult(
+                manifest, STRDEF("host"), storageTest, strLstNew(), NULL, NULL, job, false, pgPageSize8, 0, &sizeProgress,
+                &currentPercentComplete),
+            "log noop result");
+        TEST_RESULT_VOID(cmdLockReleaseP(), "release backup lock");
+
+        TEST_RESULT_LOG("P00 DETAIL: match file from prior backup host:" TEST_PATH "/test (0B, 100.00%)");
+    }
+
+    // Offline tests should only be used to test offline functionality and errors easily tested in offline mode
+    // *****************************************************************************************************************************
+    if (testBegin("cmdBackup() offline"))
+    {
+        // Set log level to detail
+        harnessLogLevelSet(logLevelDetail);
+
+        // Replace backup labels since the times are not deterministic
+        hrnLogReplaceAdd("[0-9]{8}-[0-9]{6}F_[0-9]{8}-[0-9]{6}I", NULL, "INCR", true);
+        hrnLogReplaceAdd("[0-9]{8}-[0-9]{6}F_[0-9]{8}-[0-9]{6}D", NULL, "DIFF", true);
+        hrnLogReplaceAdd("[0-9]{8}-[0-9]{6}F", NULL, "FULL", true);
+
+        // Create stanza
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+
+        // Create pg_control
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+
+        cmdStanzaCreate();
+        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when pg appears to be running");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_POSTMTRPID, "PID");
+
+        TEST_ERROR(
+            hrnCmdBackup(), PgRunningError,
+            "--no-online passed but " PG_FILE_POSTMTRPID " exists - looks like " PG_NAME " is running. Shut down " PG_NAME " and"
+            " try again, or use --force.");
+
+        TEST_RESULT_LOG("P00   WARN: no prior backup exists, incr backup has been changed to full");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("offline full backup");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        hrnCfgArgRawBool(argList, cfgOptCompress, false);
+        hrnCfgArgRawBool(argList, cfgOptForce, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.conf", "CONFIGSTUFF");
+
+        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+        TEST_RESULT_LOG_FMT(
+            "P00   WARN: no prior backup exists, incr backup has been changed to full\n"
+            "P00   WARN: --no-online passed and " PG_FILE_POSTMTRPID " exists but --force was passed so backup will continue though"
+            " it looks like " PG_NAME " is running and the backup will probably not be consistent\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, 99.87%%) checksum %s\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, 100.00%%) checksum"
+            " e3db315c260e79211b7b52587123b7aa060f30ab\n"
+            "P00   INFO: new backup label = [FULL-1]\n"
+            "P00   INFO: full backup size = 8KB, file total = 2",
+            TEST_64BIT() ?
+                (TEST_BIG_ENDIAN() ? "ead3f998dc6dbc4b444f89cd449dcb81801a21ed" : "6f7fb3cd71dbef602850d05332cdd1c8e4a64121") :
+                "a90290adaf2e8a36d53b0c15d277e23e1b321fdb");
+
+        // Make pg no longer appear to be running
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_POSTMTRPID, .errorOnMissing = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when no files have changed");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        hrnCfgArgRawBool(argList, cfgOptCompress, true);
+        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_ERROR(hrnCmdBackup(), FileMissingError, "no files have changed since the last backup - this seems unlikely");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
+            "P00   WARN: diff backup cannot alter compress-type option to 'gz', reset to value in [FULL-1]");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("offline incr backup to test unresumable backup");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        hrnCfgArgRawBool(argList, cfgOptCompress, false);
+        hrnCfgArgRawBool(argList, cfgOptChecksumPage, true);
+        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "VER");
+
+        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
+            "P00   WARN: incr backup cannot alter 'checksum-page' option to 'true', reset to 'false' from [FULL-1]\n"
+            "P00   INFO: backup '[DIFF-1]' cannot be resumed: resume only valid for full backup\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum c8663c2525f44b6d9c687fbceb4aafc63ed8b451\n"
+            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-1]\n"
+            "P00 DETAIL: reference pg_data/postgresql.conf to [FULL-1]\n"
+            "P00   INFO: new backup label = [INCR-1]\n"
+            "P00   INFO: incr backup size = 3B, file total = 3");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("offline diff backup to test prior backup must be full");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        hrnCfgArgRawBool(argList, cfgOptCompress, false);
+        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        hrnSleepRemainder();
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "VR2");
+
+        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum 6f1894088c578e4f0b9888e8e8a997d93cbbc0c5\n"
+            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-1]\n"
+            "P00 DETAIL: reference pg_data/postgresql.conf to [FULL-1]\n"
+            "P00   INFO: new backup label = [DIFF-2]\n"
+            "P00   INFO: diff backup size = 3B, file total = 3");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("only repo2 configured");
+
+        // Create stanza on a second repo
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 2, TEST_PATH "/repo2");
+        hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+
+        cmdStanzaCreate();
+        TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo2");
+
+        // Set log level to warn
+        harnessLogLevelSet(logLevelWarn);
+
+        // With repo2 the only repo configured, ensure it is chosen by confirming diff is changed to full due to no prior backups
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 2, "1");
+        hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+        TEST_RESULT_LOG("P00   WARN: no prior backup exists, diff backup has been changed to full");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("multi-repo");
+
+        // Set log level to detail
+        harnessLogLevelSet(logLevelDetail);
+
+        // Add repo1 to the configuration
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 1, TEST_PATH "/repo");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 1, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: repo option not specified, defaulting to repo1\n"
+            "P00   INFO: last backup label = [FULL-1], version = " PROJECT_VERSION "\n"
+            "P00   WARN: diff backup cannot alter compress-type option to 'gz', reset to value in [FULL-1]\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum 6f1894088c578e4f0b9888e8e8a997d93cbbc0c5\n"
+            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-1]\n"
+            "P00 DETAIL: reference pg_data/postgresql.conf to [FULL-1]\n"
+            "P00   INFO: new backup label = [DIFF-3]\n"
+            "P00   INFO: diff backup size = 3B, file total = 3");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("multi-repo - specify repo");
+
+        hrnCfgArgRawZ(argList, cfgOptRepo, "2");
+
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "VER");
+
+        // Modify file postgresql.conf during the backup to demonstrate that percent complete will be updated correctly
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.conf", "CONFIGSTUFF2");
+        HRN_BACKUP_SCRIPT_SET(
+            {.op = hrnBackupScriptOpUpdate, .file = storagePathP(storagePg(), STRDEF("postgresql.conf")),
+             .content = BUFSTRDEF("CONFIG")});
+
+        unsigned int backupCount = strLstSize(storageListP(storageRepoIdx(1), strNewFmt(STORAGE_PATH_BACKUP "/test1")));
+
+        TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: last backup label = [FULL-2], version = " PROJECT_VERSION "\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (12B->6B, 80.00%) checksum"
+            " 2fb60054b43a25d7a958d3d19bdb1aa7809577a8\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, 100.00%) checksum c8663c2525f44b6d9c687fbceb4aafc63ed8b451\n"
+            "P00 DETAIL: reference pg_data/global/pg_control to [FULL-2]\n"
+            "P00   INFO: new backup label = [DIFF-4]\n"
+            "P00   INFO: diff backup size = 9B, file total = 3");
+        TEST_RESULT_UINT(
+            strLstSize(storageListP(storageRepoIdx(1), strNewFmt(STORAGE_PATH_BACKUP "/test1"))), backupCount + 1,
+            "new backup repo2");
+
+        // Cleanup
+        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
+        harnessLogLevelReset();
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("cmdBackup() online"))
+    {
+        const String *pg1Path = STRDEF(TEST_PATH "/pg1");
+        const String *repoPath = STRDEF(TEST_PATH "/repo");
+        const String *pg2Path = STRDEF(TEST_PATH "/pg2");
+
+        // Set log level to detail
+        harnessLogLevelSet(logLevelDetail);
+
+        // Replace percent complete and backup size since they can cause a lot of churn when files are added/removed
+        hrnLogReplaceAdd(", [0-9]{1,3}.[0-9]{1,2}%\\)", "[0-9].+%", "PCT", false);
+        hrnLogReplaceAdd(" backup size = [0-9.]+[A-Z]+", "[^ ]+$", "SIZE", false);
+
+        // Replace checksums since they can differ between architectures (e.g. 32/64 bit)
+        hrnLogReplaceAdd("\\) checksum [a-f0-9]{40}", "[a-f0-9]{40}$", "SHA1", false);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 9.5 resume uncompressed full backup");
+
+        time_t backupTimeStart = BACKUP_EPOCH;
+
+        {
+            // Create stanza
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawBool(argList, cfgOptOnline, false);
+            HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+
+            // Create pg_control
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_95);
+
+            cmdStanzaCreate();
+            TEST_RESULT_LOG("P00   INFO: stanza-create for stanza 'test1' on repo1");
+
+            // Load options
+            argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
+            hrnCfgArgRawBool(argList, cfgOptCompress, false);
+            hrnCfgArgRawBool(argList, cfgOptArchiveCheck, false);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Add files
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.conf", "CONFIGSTUFF", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_95_Z, .timeModified = backupTimeStart);
+            HRN_STORAGE_PATH_CREATE(storagePgWrite(), strZ(pgWalPath(PG_VERSION_95)), .noParentCreate = true);
+
+            // Create a backup manifest that looks like a halted backup manifest
+            Manifest *manifestResume = manifestNewBuild(
+                storagePg(), PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false,
+                NULL, NULL, NULL, NULL);
+
+            manifestResume->pub.data.backupType = backupTypeFull;
+            const String *resumeLabel = backupLabelCreate(backupTypeFull, NULL, backupTimeStart);
+            manifestBackupLabelSet(manifestResume, resumeLabel);
+
+            // Copy a file to be resumed that has not changed in the repo
+            HRN_STORAGE_COPY(
+                storagePg(), PG_FILE_PGVERSION, storageRepoWrite(),
+                zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/PG_VERSION", strZ(resumeLabel)));
+
+            // Save the resume manifest
+            manifestSave(
+                manifestResume,
+                storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoWrite(),
+                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+
+            // Write the checksum of the file to be resumed to the journal as if the file was copied after the manifest was saved
+            ManifestFilePack **const filePack = manifestFilePackFindInternal(manifestResume, STRDEF("pg_data/PG_VERSION"));
+            ManifestFile file = manifestFileUnpackP(manifestResume, *filePack);
+
+            file.checksumSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("06d06bb31b570b94d7b4325f511f853dbe771c21")));
+            file.checksumRepoSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("06d06bb31b570b94d7b4325f511f853dbe771c21")));
+
+            manifestFilePackUpdate(manifestResume, filePack, &file);
+
+            StringList *const journal = strLstNew();
+            strLstAddZ(journal, "pg_data/PG_VERSION");
+
+            unsigned int journalSegment = 0;
+
+            backupManifestJournalWrite(manifestResume, journal, &journalSegment, NULL);
+
+            // Run backup
+            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart, .noArchiveCheck = true, .noWal = true);
+
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105D944C000000000, lsn = 5d944c0/0\n"
+                "P00   WARN: resumable backup 20191002-070640F of same type exists -- invalid files will be removed then the backup"
+                " will resume\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: checksum resumed file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105D944C000000000, lsn = 5d944c0/800000\n"
+                "P00   INFO: new backup label = 20191002-070640F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 3");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ".> {d=20191002-070640F}\n"
+                "pg_data/PG_VERSION {s=3}\n"
+                "pg_data/global/pg_control {s=8192}\n"
+                "pg_data/pg_xlog/\n"
+                "pg_data/postgresql.conf {s=11}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online resumed compressed 9.5 full backup");
+
+        // Backup start time
+        backupTimeStart = BACKUP_EPOCH + 100000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
+            hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Create a backup manifest that looks like a halted backup manifest
+            Manifest *manifestResume = manifestNewBuild(
+                storagePg(), PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false,
+                NULL, NULL, NULL, NULL);
+
+            manifestResume->pub.data.backupType = backupTypeFull;
+            manifestResume->pub.data.backupOptionCompressType = compressTypeGz;
+            const String *resumeLabel = backupLabelCreate(backupTypeFull, NULL, backupTimeStart);
+            manifestBackupLabelSet(manifestResume, resumeLabel);
+
+            // File exists in cluster and repo but not in the resume manifest
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "not-in-resume", "TEST", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/not-in-resume.gz", strZ(resumeLabel)));
+
+            // Remove checksum from file so it won't be resumed
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/global/pg_control.gz", strZ(resumeLabel)));
+
+            ManifestFilePack **const filePack = manifestFilePackFindInternal(manifestResume, STRDEF("pg_data/global/pg_control"));
+            ManifestFile file = manifestFileUnpackP(manifestResume, *filePack);
+
+            file.checksumSha1 = NULL;
+
+            manifestFilePackUpdate(manifestResume, filePack, &file);
+
+            // Size does not match between cluster and resume manifest
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "size-mismatch", "TEST", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/size-mismatch.gz", strZ(resumeLabel)));
+            HRN_MANIFEST_FILE_ADD(
+                manifestResume, .name = "pg_data/size-mismatch", .size = 33,
+                .checksumSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+            // Time does not match between cluster and resume manifest
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "time-mismatch", "TEST", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/time-mismatch.gz", strZ(resumeLabel)));
+            HRN_MANIFEST_FILE_ADD(
+                manifestResume, .name = "pg_data/time-mismatch", .size = 4, .timestamp = backupTimeStart - 1,
+                .checksumSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+            // Size is zero in cluster and resume manifest. ??? We'd like to remove this requirement after the migration.
+            HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "zero-size", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_Z(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/zero-size.gz", strZ(resumeLabel)), "ZERO-SIZE");
+            HRN_MANIFEST_FILE_ADD(manifestResume, .name = "pg_data/zero-size", .size = 0, .timestamp = backupTimeStart);
+
+            // Path is not in manifest
+            HRN_STORAGE_PATH_CREATE(storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/bogus_path", strZ(resumeLabel)));
+
+            // File is not in manifest
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/global/bogus.gz", strZ(resumeLabel)));
+
+            // File has incorrect compression type
+            HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/global/bogus", strZ(resumeLabel)));
+
+            // Save the resume manifest
+            manifestSave(
+                manifestResume,
+                storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoWrite(),
+                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+            // Disable storageFeaturePath so paths will not be created before files are copied
+            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeaturePath;
+
+            // Disable storageFeaturePathSync so paths will not be synced
+            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeaturePathSync;
+
+            // Run backup
+            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            // Enable storage features
+            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeaturePath;
+            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeaturePathSync;
+#pragma GCC diagnostic pop
+
+            TEST_RESULT_LOG(
+                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105D95D3000000000, lsn = 5d95d30/0\n"
+                "P00   INFO: check archive for prior segment 0000000105D95D2F000000FF\n"
+                "P00   WARN: resumable backup 20191003-105320F of same type exists -- invalid files will be removed then the backup"
+                " will resume\n"
+                "P00 DETAIL: remove path '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/bogus_path' from resumed"
+                " backup\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/global/bogus' from resumed"
+                " backup (mismatched compression type)\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/global/bogus.gz' from resumed"
+                " backup (missing in manifest)\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/global/pg_control.gz' from"
+                " resumed backup (no checksum in resumed manifest)\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/not-in-resume.gz' from resumed"
+                " backup (missing in resumed manifest)\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/size-mismatch.gz' from resumed"
+                " backup (mismatched size)\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/time-mismatch.gz' from resumed"
+                " backup (mismatched timestamp)\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/zero-size.gz' from resumed"
+                " backup (zero size)\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/time-mismatch (4B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/size-mismatch (4B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/not-in-resume (4B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/zero-size (0B, [PCT])\n"
+                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105D95D3000000000, lsn = 5d95d30/800000\n"
+                "P00   INFO: check archive for segment(s) 0000000105D95D3000000000:0000000105D95D3000000000\n"
+                "P00 DETAIL: copy segment 0000000105D95D3000000000 to backup\n"
+                "P00   INFO: new backup label = 20191003-105320F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 8");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ".> {d=20191003-105320F}\n"
+                "pg_data/PG_VERSION.gz {s=3, ts=-100000}\n"
+                "pg_data/global/pg_control.gz {s=8192}\n"
+                "pg_data/not-in-resume.gz {s=4}\n"
+                "pg_data/pg_xlog/0000000105D95D3000000000.gz {s=16777216, ts=+2}\n"
+                "pg_data/postgresql.conf.gz {s=11, ts=-100000}\n"
+                "pg_data/size-mismatch.gz {s=4}\n"
+                "pg_data/time-mismatch.gz {s=4}\n"
+                "pg_data/zero-size.gz {s=0}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+
+            // Remove test files
+            HRN_STORAGE_REMOVE(storagePgWrite(), "not-in-resume", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "size-mismatch", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "time-mismatch", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "zero-size", .errorOnMissing = true);
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online resumed compressed 9.5 full delta backup");
+
+        backupTimeStart = BACKUP_EPOCH + 200000;
+
+        {
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawBool(argList, cfgOptDelta, true);
+            hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Create a backup manifest that looks like a halted backup manifest
+            Manifest *manifestResume = manifestNewBuild(
+                storagePg(), PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false,
+                NULL, NULL, NULL, NULL);
+
+            manifestResume->pub.data.backupOptionCompressType = compressTypeGz;
+            const String *resumeLabel = backupLabelCreate(backupTypeFull, NULL, backupTimeStart - 100000);
+            manifestBackupLabelSet(manifestResume, resumeLabel);
+            strLstAddZ(manifestResume->pub.referenceList, "BOGUS");
+
+            // Time does not match between cluster and resume manifest (but resume because time is in future so delta enabled). Note
+            // also that the repo file is intentionally corrupt to generate a warning about corruption in the repository.
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "time-mismatch2", "TEST", .timeModified = backupTimeStart + 100);
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/time-mismatch2.gz", strZ(resumeLabel)));
+            HRN_MANIFEST_FILE_ADD(
+                manifestResume, .name = "pg_data/time-mismatch2", .size = 4, .timestamp = backupTimeStart,
+                .checksumSha1 = "984816fd329622876e14907634264e6f332e9fb3");
+
+            // File does not match what is in manifest
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "content-mismatch", "TEST", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/content-mismatch.gz", strZ(resumeLabel)));
+            HRN_MANIFEST_FILE_ADD(
+                manifestResume, .name = "pg_data/content-mismatch", .size = 4, .timestamp = backupTimeStart,
+                .checksumSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+            // Repo size mismatch
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "repo-size-mismatch", "TEST", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/repo-size-mismatch.gz", strZ(resumeLabel)));
+            HRN_MANIFEST_FILE_ADD(
+                manifestResume, .name = "pg_data/repo-size-mismatch", .size = 4, .sizeRepo = 4, .timestamp = backupTimeStart,
+                .checksumSha1 = "984816fd329622876e14907634264e6f332e9fb3",
+                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+            // File that will resumed but removed from pg during the backup (and then the repo)
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "removed-during", "TEST", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_EMPTY(
+                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/removed-during.gz", strZ(resumeLabel)));
+            HRN_MANIFEST_FILE_ADD(
+                manifestResume, .name = "pg_data/removed-during", .size = 4, .timestamp = backupTimeStart,
+                .checksumSha1 = "984816fd329622876e14907634264e6f332e9fb3");
+
+            // Links are always removed on resume
+            THROW_ON_SYS_ERROR(
+                symlink(
+                    "..",
+                    strZ(storagePathP(storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/link", strZ(resumeLabel))))) == -1,
+                FileOpenError, "unable to create symlink");
+
+            // Special files should not be in the repo
+            HRN_SYSTEM_FMT(
+                "mkfifo -m 666 %s",
+                strZ(storagePathP(storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/pipe", strZ(resumeLabel)))));
+
+            // Save the resume manifest with full type
+            manifestResume->pub.data.backupType = backupTypeFull;
+
+            manifestSave(
+                manifestResume,
+                storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoWrite(),
+                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+
+            // Run backup
+            HRN_BACKUP_SCRIPT_SET(
+                {.op = hrnBackupScriptOpRemove, .file = storagePathP(storagePg(), STRDEF("removed-during"))});
+            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            // Check log
+            TEST_RESULT_LOG(
+                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105D9759000000000, lsn = 5d97590/0\n"
+                "P00   INFO: check archive for prior segment 0000000105D9758F000000FF\n"
+                "P00   WARN: resumable backup 20191003-105321F of same type exists -- invalid files will be removed then the backup"
+                " will resume\n"
+                "P00   WARN: remove special file '" TEST_PATH "/repo/backup/test1/20191003-105321F/pg_data/pipe' from resumed"
+                " backup\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/time-mismatch2 (4B, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: resumed backup file pg_data/time-mismatch2 did not have expected checksum"
+                " 984816fd329622876e14907634264e6f332e9fb3. The file was recopied and backup will continue but this may be an issue"
+                " unless the resumed backup path in the repository is known to be corrupted.\n"
+                "            NOTE: this does not indicate a problem with the PostgreSQL page checksums.\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/repo-size-mismatch (4B, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: resumed backup file pg_data/repo-size-mismatch did not have expected checksum"
+                " 984816fd329622876e14907634264e6f332e9fb3. The file was recopied and backup will continue but this may be an issue"
+                " unless the resumed backup path in the repository is known to be corrupted.\n"
+                "            NOTE: this does not indicate a problem with the PostgreSQL page checksums.\n"
+                "P01 DETAIL: skip file removed by database " TEST_PATH "/pg1/removed-during\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/content-mismatch (4B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105D9759000000000, lsn = 5d97590/800000\n"
+                "P00   INFO: check archive for segment(s) 0000000105D9759000000000:0000000105D9759000000000\n"
+                "P00   INFO: new backup label = 20191003-105321F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 6");
+
+            // Check repo directory
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ".> {d=20191003-105321F}\n"
+                "pg_data/PG_VERSION.gz {s=3, ts=-200000}\n"
+                "pg_data/content-mismatch.gz {s=4}\n"
+                "pg_data/global/pg_control.gz {s=8192}\n"
+                "pg_data/pg_xlog/\n"
+                "pg_data/postgresql.conf.gz {s=11, ts=-200000}\n"
+                "pg_data/repo-size-mismatch.gz {s=4}\n"
+                "pg_data/time-mismatch2.gz {s=4, ts=+100}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+
+            // Remove test files
+            HRN_STORAGE_REMOVE(storagePgWrite(), "time-mismatch2", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "content-mismatch", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "repo-size-mismatch", .errorOnMissing = true);
+
+            // Remove main and binary manifests to make this backup look resumable
+            HRN_STORAGE_REMOVE(storageRepoWrite(), "backup/test1/20191003-105321F/backup.manifest");
+            HRN_STORAGE_REMOVE(storageRepoWrite(), "backup/test1/20191003-105321F/backup.manifest.pack");
+
+            // Save the resume manifest with diff type
+            manifestResume->pub.data.backupType = backupTypeDiff;
+
+            manifestSave(
+                manifestResume,
+                storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoWrite(),
+                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+
+            // Back errors on backup type
+            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            // Check log
+            TEST_RESULT_LOG(
+                "P00   WARN: backup '20191003-105321F' missing manifest removed from backup.info\n"
+                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105D9759000000000, lsn = 5d97590/0\n"
+                "P00   INFO: check archive for prior segment 0000000105D9758F000000FF\n"
+                "P00   WARN: backup '20191003-105321F' cannot be resumed: new backup type 'full' does not match resumable backup"
+                " type 'diff'\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105D9759000000000, lsn = 5d97590/800000\n"
+                "P00   INFO: check archive for segment(s) 0000000105D9759000000000:0000000105D9759000000000\n"
+                "P00   INFO: new backup label = 20191004-144000F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 3");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 9.6 backup-standby full backup");
+
+        backupTimeStart = BACKUP_EPOCH + 1200000;
+
+        {
+            // Update pg_control
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_96);
+
+            // Update version
+            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_96_Z, .timeModified = backupTimeStart);
+
+            // Upgrade stanza
+            StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawBool(argList, cfgOptOnline, false);
+            HRN_CFG_LOAD(cfgCmdStanzaUpgrade, argList);
+
+            cmdStanzaUpgrade();
+            TEST_RESULT_LOG("P00   INFO: stanza-upgrade for stanza 'test1' on repo1");
+
+            // Load options
+            argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
+            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
-            hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
+            hrnCfgArgRawBool(argList, cfgOptCompress, false);
+            hrnCfgArgRawBool(argList, cfgOptBackupStandby, true);
+            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
             hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Create a backup manifest that looks like a halted backup manifest
-            Manifest *manifestResume = manifestNewBuild(
-                storagePg(), PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false, NULL, NULL, NULL);
+            // Add pg_control to standby
+            HRN_PG_CONTROL_PUT(storagePgIdxWrite(1), PG_VERSION_96);
 
-            manifestResume->pub.data.backupType = backupTypeFull;
-            manifestResume->pub.data.backupOptionCompressType = compressTypeGz;
-            const String *resumeLabel = backupLabelCreate(backupTypeFull, NULL, backupTimeStart);
-            manifestBackupLabelSet(manifestResume, resumeLabel);
+            // Create file to copy from the standby. This file will be zero-length on the primary and non-zero-length on the standby
+            // but no bytes will be copied.
+            HRN_STORAGE_PUT_EMPTY(storagePgIdxWrite(0), PG_PATH_BASE "/1/1", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_Z(storagePgIdxWrite(1), PG_PATH_BASE "/1/1", "1234");
 
-            // File exists in cluster and repo but not in the resume manifest
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "not-in-resume", "TEST", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/not-in-resume.gz", strZ(resumeLabel)));
+            // Create file to copy from the standby. This file will be smaller on the primary than the standby and have no common
+            // data in the bytes that exist on primary and standby. If the file is copied from the primary instead of the standby
+            // the checksum will change but not the size.
+            HRN_STORAGE_PUT_Z(storagePgIdxWrite(0), PG_PATH_BASE "/1/2", "DA", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_Z(storagePgIdxWrite(1), PG_PATH_BASE "/1/2", "5678");
 
-            // Remove checksum from file so it won't be resumed
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/global/pg_control.gz", strZ(resumeLabel)));
+            // Create file to copy from the standby. This file will be larger on the primary than the standby and have no common
+            // data in the bytes that exist on primary and standby. If the file is copied from the primary instead of the standby
+            // the checksum and size will change.
+            HRN_STORAGE_PUT_Z(storagePgIdxWrite(0), PG_PATH_BASE "/1/3", "TEST", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_Z(storagePgIdxWrite(1), PG_PATH_BASE "/1/3", "ABC");
 
-            ManifestFilePack **const filePack = manifestFilePackFindInternal(manifestResume, STRDEF("pg_data/global/pg_control"));
-            ManifestFile file = manifestFileUnpack(manifestResume, *filePack);
+            // Create a file on the primary that does not exist on the standby to test that the file is removed from the manifest
+            HRN_STORAGE_PUT_Z(storagePgIdxWrite(0), PG_PATH_BASE "/1/0", "DATA", .timeModified = backupTimeStart);
 
-            file.checksumSha1 = NULL;
+            // Set log level to warn because the following test uses multiple processes so the log order will not be deterministic
+            harnessLogLevelSet(logLevelWarn);
 
-            manifestFilePackUpdate(manifestResume, filePack, &file);
+            // Run backup but error on first archive check
+            hrnBackupPqScriptP(
+                PG_VERSION_96, backupTimeStart, .noPriorWal = true, .backupStandby = true, .walCompressType = compressTypeGz,
+                .startFast = true);
+            TEST_ERROR(
+                hrnCmdBackup(), ArchiveTimeoutError,
+                "WAL segment 0000000105DA69BF000000FF was not archived before the 100ms timeout\n"
+                "HINT: check the archive_command to ensure that all options are correct (especially --stanza).\n"
+                "HINT: check the PostgreSQL server log for errors.\n"
+                "HINT: run the 'start' command if the stanza was previously stopped.");
 
-            // Size does not match between cluster and resume manifest
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "size-mismatch", "TEST", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/size-mismatch.gz", strZ(resumeLabel)));
-            HRN_MANIFEST_FILE_ADD(
-                manifestResume, .name = "pg_data/size-mismatch", .size = 33,
-                .checksumSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
-                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+            // Run backup but error on archive check
+            hrnBackupPqScriptP(
+                PG_VERSION_96, backupTimeStart, .noWal = true, .backupStandby = true, .walCompressType = compressTypeGz,
+                .startFast = true);
+            TEST_ERROR(
+                hrnCmdBackup(), ArchiveTimeoutError,
+                "WAL segment 0000000105DA69C000000000 was not archived before the 100ms timeout\n"
+                "HINT: check the archive_command to ensure that all options are correct (especially --stanza).\n"
+                "HINT: check the PostgreSQL server log for errors.\n"
+                "HINT: run the 'start' command if the stanza was previously stopped.");
 
-            // Time does not match between cluster and resume manifest
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "time-mismatch", "TEST", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/time-mismatch.gz", strZ(resumeLabel)));
-            HRN_MANIFEST_FILE_ADD(
-                manifestResume, .name = "pg_data/time-mismatch", .size = 4, .timestamp = backupTimeStart - 1,
-                .checksumSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
-                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+            // Remove halted backup so there's no resume
+            HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191016-042640F", .recurse = true);
 
-            // Size is zero in cluster and resume manifest. ??? We'd like to remove this requirement after the migration.
-            HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "zero-size", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_Z(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/zero-size.gz", strZ(resumeLabel)), "ZERO-SIZE");
-            HRN_MANIFEST_FILE_ADD(manifestResume, .name = "pg_data/zero-size", .size = 0, .timestamp = backupTimeStart);
+            // Set archive.info/copy to an older timestamp so we can be sure it was updated as part of backup
+            time_t archiveInfoOldTimestamp = 967746268;
+            HRN_STORAGE_TIME(storageRepo(), INFO_ARCHIVE_PATH_FILE, archiveInfoOldTimestamp);
+            HRN_STORAGE_TIME(storageRepo(), INFO_ARCHIVE_PATH_FILE_COPY, archiveInfoOldTimestamp);
 
-            // Path is not in manifest
-            HRN_STORAGE_PATH_CREATE(storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/bogus_path", strZ(resumeLabel)));
+            // Get a copy of archive.info
+            const String *archiveInfoContent = strNewBuf(storageGetP(storageNewReadP(storageRepo(), INFO_ARCHIVE_PATH_FILE_STR)));
 
-            // File is not in manifest
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/global/bogus.gz", strZ(resumeLabel)));
+            // Run backup
+            hrnBackupPqScriptP(
+                PG_VERSION_96, backupTimeStart, .backupStandby = true, .walCompressType = compressTypeGz, .startFast = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // File has incorrect compression type
-            HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/global/bogus", strZ(resumeLabel)));
+            // Check archive.info/copy timestamp was updated but contents were not
+            TEST_RESULT_INT_NE(
+                storageInfoP(storageRepo(), INFO_ARCHIVE_PATH_FILE_STR).timeModified, archiveInfoOldTimestamp, "time updated");
+            TEST_STORAGE_GET(storageRepo(), INFO_ARCHIVE_PATH_FILE, strZ(archiveInfoContent));
+            TEST_RESULT_INT_NE(
+                storageInfoP(storageRepo(), INFO_ARCHIVE_PATH_FILE_COPY_STR).timeModified, archiveInfoOldTimestamp, "time updated");
+            TEST_STORAGE_GET(storageRepo(), INFO_ARCHIVE_PATH_FILE_COPY, strZ(archiveInfoContent));
 
-            // Save the resume manifest
-            manifestSave(
-                manifestResume,
-                storageWriteIo(
-                    storageNewWriteP(
-                        storageRepoWrite(),
-                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+            // Set log level back to detail
+            harnessLogLevelSet(logLevelDetail);
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-qual"
-            // Disable storageFeaturePath so paths will not be created before files are copied
-            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeaturePath;
+            TEST_RESULT_LOG(
+                "P00   WARN: no prior backup exists, incr backup has been changed to full");
 
-            // Disable storageFeaturePathSync so paths will not be synced
-            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeaturePathSync;
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ".> {d=20191016-042640F}\n"
+                "pg_data/PG_VERSION {s=3}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
+                "pg_data/base/1/1 {s=0}\n"
+                "pg_data/base/1/2 {s=2}\n"
+                "pg_data/base/1/3 {s=3, so=4}\n"
+                "pg_data/global/pg_control {s=8192}\n"
+                "pg_data/pg_xlog/0000000105DA69C000000000 {s=16777216, ts=+2}\n"
+                "pg_data/postgresql.conf {s=11, ts=-1200000}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
 
-            // Run backup
-            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart);
-            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+            // Remove test files
+            HRN_STORAGE_PATH_REMOVE(storagePgIdxWrite(1), NULL, .recurse = true);
+            HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "base/1", .recurse = true);
+        }
 
-            // Enable storage features
-            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeaturePath;
-            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeaturePathSync;
-#pragma GCC diagnostic pop
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 9.6 backup-standby full backup with block incremental");
 
-            TEST_RESULT_LOG(
-                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105D95D3000000000, lsn = 5d95d30/0\n"
-                "P00   INFO: check archive for prior segment 0000000105D95D2F000000FF\n"
-                "P00   WARN: resumable backup 20191003-105320F of same type exists -- invalid files will be removed then the backup"
-                " will resume\n"
-                "P00 DETAIL: remove path '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/bogus_path' from resumed"
-                " backup\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/global/bogus' from resumed"
-                " backup (mismatched compression type)\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/global/bogus.gz' from resumed"
-                " backup (missing in manifest)\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/global/pg_control.gz' from"
-                " resumed backup (no checksum in resumed manifest)\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/not-in-resume.gz' from resumed"
-                " backup (missing in resumed manifest)\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/size-mismatch.gz' from resumed"
-                " backup (mismatched size)\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/time-mismatch.gz' from resumed"
-                " backup (mismatched timestamp)\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/zero-size.gz' from resumed"
-                " backup (zero size)\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/time-mismatch (4B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/size-mismatch (4B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/not-in-resume (4B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/zero-size (0B, [PCT])\n"
-                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105D95D3000000000, lsn = 5d95d30/800000\n"
-                "P00   INFO: check archive for segment(s) 0000000105D95D3000000000:0000000105D95D3000000000\n"
-                "P00 DETAIL: copy segment 0000000105D95D3000000000 to backup\n"
-                "P00   INFO: new backup label = 20191003-105320F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 8");
+        backupTimeStart = BACKUP_EPOCH + 1600000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
+            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptCompress, false);
+            hrnCfgArgRawBool(argList, cfgOptBackupStandby, true);
+            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Add file that is large enough for block incremental but larger on the primary than the standby. The standby size will
+            // be increased before the next backup.
+            Buffer *relation = bufNew(pgPageSize8 * 5);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            bufUsedSet(relation, bufSize(relation));
+
+            HRN_STORAGE_PUT(storagePgIdxWrite(0), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
+
+            bufUsedSet(relation, bufSize(relation) - pgPageSize8 * 2);
+            HRN_STORAGE_PUT(storagePgIdxWrite(1), PG_PATH_BASE "/1/3", relation);
+
+            // Add file that is large enough for block incremental but larger on the primary than the standby. This tests that file
+            // size is set correctly when a file is referenced to a prior backup but the original size is different.
+            bufUsedSet(relation, bufSize(relation));
+
+            HRN_STORAGE_PUT(storagePgIdxWrite(0), PG_PATH_BASE "/1/4", relation, .timeModified = backupTimeStart);
+
+            bufUsedSet(relation, bufSize(relation) - pgPageSize8);
+            HRN_STORAGE_PUT(storagePgIdxWrite(1), PG_PATH_BASE "/1/4", relation);
+
+            // Set log level to warn because the following test uses multiple processes so the log order will not be deterministic
+            harnessLogLevelSet(logLevelWarn);
+
+            // Run backup
+            hrnBackupPqScriptP(PG_VERSION_96, backupTimeStart, .backupStandby = true, .startFast = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            // Set log level back to detail
+            harnessLogLevelSet(logLevelDetail);
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191003-105320F}\n"
-                "pg_data/PG_VERSION.gz {s=3, ts=-100000}\n"
-                "pg_data/global/pg_control.gz {s=8192}\n"
-                "pg_data/not-in-resume.gz {s=4}\n"
-                "pg_data/pg_xlog/0000000105D95D3000000000.gz {s=16777216, ts=+2}\n"
-                "pg_data/postgresql.conf.gz {s=11, ts=-100000}\n"
-                "pg_data/size-mismatch.gz {s=4}\n"
-                "pg_data/time-mismatch.gz {s=4}\n"
-                "pg_data/zero-size.gz {s=0}\n"
+                ".> {d=20191020-193320F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=3, ts=-400000}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "bundle/1/pg_data/postgresql.conf {s=11, ts=-1600000}\n"
+                "bundle/2/pg_data/base/1/3 {s=24576, so=40960, m=z,z,z}\n"
+                "bundle/2/pg_data/base/1/4 {s=32768, so=40960, m=z,z,z,z}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
-
-            // Remove test files
-            HRN_STORAGE_REMOVE(storagePgWrite(), "not-in-resume", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "size-mismatch", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "time-mismatch", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "zero-size", .errorOnMissing = true);
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online resumed compressed 9.5 full delta backup");
+        TEST_TITLE("online 9.6 backup-standby incr backup with block incremental");
 
-        backupTimeStart = BACKUP_EPOCH + 200000;
+        backupTimeStart = BACKUP_EPOCH + 1700000;
 
         {
+            // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
+            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
-            hrnCfgArgRawBool(argList, cfgOptDelta, true);
-            hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
-            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptCompress, false);
+            hrnCfgArgRawZ(argList, cfgOptBackupStandby, "prefer");
+            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Create a backup manifest that looks like a halted backup manifest
-            Manifest *manifestResume = manifestNewBuild(
-                storagePg(), PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false, NULL, NULL, NULL);
-
-            manifestResume->pub.data.backupOptionCompressType = compressTypeGz;
-            const String *resumeLabel = backupLabelCreate(backupTypeFull, NULL, backupTimeStart - 100000);
-            manifestBackupLabelSet(manifestResume, resumeLabel);
-            strLstAddZ(manifestResume->pub.referenceList, "BOGUS");
-
-            // Time does not match between cluster and resume manifest (but resume because time is in future so delta enabled). Note
-            // also that the repo file is intentionally corrupt to generate a warning about corruption in the repository.
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "time-mismatch2", "TEST", .timeModified = backupTimeStart + 100);
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/time-mismatch2.gz", strZ(resumeLabel)));
-            HRN_MANIFEST_FILE_ADD(
-                manifestResume, .name = "pg_data/time-mismatch2", .size = 4, .timestamp = backupTimeStart,
-                .checksumSha1 = "984816fd329622876e14907634264e6f332e9fb3");
-
-            // File does not match what is in manifest
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "content-mismatch", "TEST", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/content-mismatch.gz", strZ(resumeLabel)));
-            HRN_MANIFEST_FILE_ADD(
-                manifestResume, .name = "pg_data/content-mismatch", .size = 4, .timestamp = backupTimeStart,
-                .checksumSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
-                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
-
-            // Repo size mismatch
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "repo-size-mismatch", "TEST", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/repo-size-mismatch.gz", strZ(resumeLabel)));
-            HRN_MANIFEST_FILE_ADD(
-                manifestResume, .name = "pg_data/repo-size-mismatch", .size = 4, .sizeRepo = 4, .timestamp = backupTimeStart,
-                .checksumSha1 = "984816fd329622876e14907634264e6f332e9fb3",
-                .checksumRepoSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
-
-            // File that will resumed but removed from pg during the backup (and then the repo)
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "removed-during", "TEST", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_EMPTY(
-                storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/removed-during.gz", strZ(resumeLabel)));
-            HRN_MANIFEST_FILE_ADD(
-                manifestResume, .name = "pg_data/removed-during", .size = 4, .timestamp = backupTimeStart,
-                .checksumSha1 = "984816fd329622876e14907634264e6f332e9fb3");
-
-            // Links are always removed on resume
-            THROW_ON_SYS_ERROR(
-                symlink(
-                    "..",
-                    strZ(storagePathP(storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/link", strZ(resumeLabel))))) == -1,
-                FileOpenError, "unable to create symlink");
-
-            // Special files should not be in the repo
-            HRN_SYSTEM_FMT(
-                "mkfifo -m 666 %s",
-                strZ(storagePathP(storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/pipe", strZ(resumeLabel)))));
+            // Increase size of file on standby. This demonstrates that copy is using the larger file from the primary as the basis
+            // for how far to read.
+            Buffer *relation = bufNew(pgPageSize8 * 4);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            bufUsedSet(relation, bufSize(relation));
 
-            // Save the resume manifest with full type
-            manifestResume->pub.data.backupType = backupTypeFull;
+            HRN_STORAGE_PUT(storagePgIdxWrite(1), PG_PATH_BASE "/1/3", relation);
 
-            manifestSave(
-                manifestResume,
-                storageWriteIo(
-                    storageNewWriteP(
-                        storageRepoWrite(),
-                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+            // Set log level to warn because the following test uses multiple processes so the log order will not be deterministic
+            harnessLogLevelSet(logLevelWarn);
 
             // Run backup
-            HRN_BACKUP_SCRIPT_SET(
-                {.op = hrnBackupScriptOpRemove, .file = storagePathP(storagePg(), STRDEF("removed-during"))});
-            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart);
+            hrnBackupPqScriptP(PG_VERSION_96, backupTimeStart, .backupStandby = true, .startFast = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // Check log
-            TEST_RESULT_LOG(
-                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105D9759000000000, lsn = 5d97590/0\n"
-                "P00   INFO: check archive for prior segment 0000000105D9758F000000FF\n"
-                "P00   WARN: resumable backup 20191003-105321F of same type exists -- invalid files will be removed then the backup"
-                " will resume\n"
-                "P00   WARN: remove special file '" TEST_PATH "/repo/backup/test1/20191003-105321F/pg_data/pipe' from resumed"
-                " backup\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/time-mismatch2 (4B, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: resumed backup file pg_data/time-mismatch2 did not have expected checksum"
-                " 984816fd329622876e14907634264e6f332e9fb3. The file was recopied and backup will continue but this may be an issue"
-                " unless the resumed backup path in the repository is known to be corrupted.\n"
-                "            NOTE: this does not indicate a problem with the PostgreSQL page checksums.\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/repo-size-mismatch (4B, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: resumed backup file pg_data/repo-size-mismatch did not have expected checksum"
-                " 984816fd329622876e14907634264e6f332e9fb3. The file was recopied and backup will continue but this may be an issue"
-                " unless the resumed backup path in the repository is known to be corrupted.\n"
-                "            NOTE: this does not indicate a problem with the PostgreSQL page checksums.\n"
-                "P01 DETAIL: skip file removed by database " TEST_PATH "/pg1/removed-during\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/content-mismatch (4B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
-                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105D9759000000000, lsn = 5d97590/800000\n"
-                "P00   INFO: check archive for segment(s) 0000000105D9759000000000:0000000105D9759000000000\n"
-                "P00   INFO: new backup label = 20191003-105321F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 6");
+            // Set log level back to detail
+            harnessLogLevelSet(logLevelDetail);
 
-            // Check repo directory
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191003-105321F}\n"
-                "pg_data/PG_VERSION.gz {s=3, ts=-200000}\n"
-                "pg_data/content-mismatch.gz {s=4}\n"
-                "pg_data/global/pg_control.gz {s=8192}\n"
-                "pg_data/pg_xlog/\n"
-                "pg_data/postgresql.conf.gz {s=11, ts=-200000}\n"
-                "pg_data/repo-size-mismatch.gz {s=4}\n"
-                "pg_data/time-mismatch2.gz {s=4, ts=+100}\n"
+                ".> {d=20191020-193320F_20191021-232000I}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "bundle/2/pg_data/base/1/3 {s=32768, so=40960, m=z,z,z,z, ts=-100000}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
+                "20191020-193320F/bundle/1/pg_data/PG_VERSION {s=3, ts=-500000}\n"
+                "20191020-193320F/bundle/2/pg_data/base/1/4 {s=32768, so=40960, m=z,z,z,z, ts=-100000}\n"
+                "20191020-193320F/bundle/1/pg_data/postgresql.conf {s=11, ts=-1700000}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
+        }
 
-            // Remove test files
-            HRN_STORAGE_REMOVE(storagePgWrite(), "time-mismatch2", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "content-mismatch", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "repo-size-mismatch", .errorOnMissing = true);
-
-            // Remove main manifest to make this backup look resumable
-            HRN_STORAGE_REMOVE(storageRepoWrite(), "backup/test1/20191003-105321F/backup.manifest");
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 9.6 backup-standby (prefer) incr backup with block incremental");
 
-            // Save the resume manifest with diff type
-            manifestResume->pub.data.backupType = backupTypeDiff;
+        backupTimeStart = BACKUP_EPOCH + 1800000;
 
-            manifestSave(
-                manifestResume,
-                storageWriteIo(
-                    storageNewWriteP(
-                        storageRepoWrite(),
-                        strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(resumeLabel)))));
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
+            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
+            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptCompress, false);
+            hrnCfgArgRawZ(argList, cfgOptBackupStandby, "prefer");
+            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Back errors on backup type
-            hrnBackupPqScriptP(PG_VERSION_95, backupTimeStart);
+            // Run backup
+            hrnBackupPqScriptP(
+                PG_VERSION_96, backupTimeStart, .backupStandby = true, .backupStandbyError = true, .startFast = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // Check log
             TEST_RESULT_LOG(
-                "P00   WARN: backup '20191003-105321F' missing manifest removed from backup.info\n"
-                "P00   INFO: execute exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105D9759000000000, lsn = 5d97590/0\n"
-                "P00   INFO: check archive for prior segment 0000000105D9758F000000FF\n"
-                "P00   WARN: backup '20191003-105321F' cannot be resumed: new backup type 'full' does not match resumable backup"
-                " type 'diff'\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (3B, [PCT]) checksum [SHA1]\n"
-                "P00   INFO: execute exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105D9759000000000, lsn = 5d97590/800000\n"
-                "P00   INFO: check archive for segment(s) 0000000105D9759000000000:0000000105D9759000000000\n"
-                "P00   INFO: new backup label = 20191004-144000F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 3");
+                "P00   WARN: unable to check pg2: [DbConnectError] unable to connect to 'dbname='postgres' port=5433': error\n"
+                "P00   WARN: unable to find a standby to perform the backup, using primary instead\n"
+                "P00   INFO: last backup label = 20191020-193320F_20191021-232000I, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the requested immediate checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DAFC3000000000, lsn = 5dafc30/0\n"
+                "P00   INFO: check archive for prior segment 0000000105DAFC2F000000FF\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 (bundle 1/0, 40KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (bundle 1/4, 40KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/8, 8KB, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191020-193320F\n"
+                "P00 DETAIL: reference pg_data/postgresql.conf to 20191020-193320F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DAFC3000000000, lsn = 5dafc30/800000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DAFC3000000000:0000000105DAFC3000000000\n"
+                "P00   INFO: new backup label = 20191020-193320F_20191023-030640I\n"
+                "P00   INFO: incr backup size = [SIZE], file total = 6");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ".> {d=20191020-193320F_20191023-030640I}\n"
+                "bundle/1/pg_data/base/1/3 {s=40960, m=z,z,z,z,z, ts=-200000}\n"
+                "bundle/1/pg_data/base/1/4 {s=40960, m=z,z,z,z,z, ts=-200000}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
+                "20191020-193320F/bundle/1/pg_data/PG_VERSION {s=3, ts=-600000}\n"
+                "20191020-193320F/bundle/1/pg_data/postgresql.conf {s=11, ts=-1800000}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 9.6 backup-standby full backup");
+        TEST_TITLE("online 11 full backup with tablespaces and page checksums");
 
-        backupTimeStart = BACKUP_EPOCH + 1200000;
+        backupTimeStart = BACKUP_EPOCH + 2200000;
 
         {
             // Update pg_control
-            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_96);
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .pageChecksumVersion = 1, .walSegmentSize = 1024 * 1024);
 
             // Update version
-            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_96_Z, .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_11_Z, .timeModified = backupTimeStart);
+
+            // Update wal path
+            HRN_STORAGE_PATH_REMOVE(storagePgWrite(), strZ(pgWalPath(PG_VERSION_95)));
+            HRN_STORAGE_PATH_CREATE(storagePgWrite(), strZ(pgWalPath(PG_VERSION_11)), .noParentCreate = true);
 
             // Upgrade stanza
             StringList *argList = strLstNew();
@@ -2593,231 +5220,454 @@ testRun(void)
             argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
-            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawBool(argList, cfgOptCompress, false);
-            hrnCfgArgRawBool(argList, cfgOptBackupStandby, true);
-            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            hrnCfgArgRawZ(argList, cfgOptManifestSaveThreshold, "1");
             hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Add pg_control to standby
-            HRN_PG_CONTROL_PUT(storagePgIdxWrite(1), PG_VERSION_96);
+            // Move pg1-path and put a link in its place. This tests that backup works when pg1-path is a symlink yet should be
+            // completely invisible in the manifest and logging.
+            HRN_SYSTEM_FMT("mv %s %s-data", strZ(pg1Path), strZ(pg1Path));
+            HRN_SYSTEM_FMT("ln -s %s-data %s ", strZ(pg1Path), strZ(pg1Path));
 
-            // Create file to copy from the standby. This file will be zero-length on the primary and non-zero-length on the standby
-            // but no bytes will be copied.
-            HRN_STORAGE_PUT_EMPTY(storagePgIdxWrite(0), PG_PATH_BASE "/1/1", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_Z(storagePgIdxWrite(1), PG_PATH_BASE "/1/1", "1234");
+            // Zeroed file which passes page checksums
+            Buffer *relation = bufNew(pgPageSize8 * 2);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            bufUsedSet(relation, bufSize(relation));
 
-            // Create file to copy from the standby. This file will be smaller on the primary than the standby and have no common
-            // data in the bytes that exist on primary and standby. If the file is copied from the primary instead of the standby
-            // the checksum will change but not the size.
-            HRN_STORAGE_PUT_Z(storagePgIdxWrite(0), PG_PATH_BASE "/1/2", "DA", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_Z(storagePgIdxWrite(1), PG_PATH_BASE "/1/2", "5678");
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0};
 
-            // Create file to copy from the standby. This file will be larger on the primary than the standby and have no common
-            // data in the bytes that exist on primary and standby. If the file is copied from the primary instead of the standby
-            // the checksum and size will change.
-            HRN_STORAGE_PUT_Z(storagePgIdxWrite(0), PG_PATH_BASE "/1/3", "TEST", .timeModified = backupTimeStart);
-            HRN_STORAGE_PUT_Z(storagePgIdxWrite(1), PG_PATH_BASE "/1/3", "ABC");
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/1", relation, .timeModified = backupTimeStart);
 
-            // Create a file on the primary that does not exist on the standby to test that the file is removed from the manifest
-            HRN_STORAGE_PUT_Z(storagePgIdxWrite(0), PG_PATH_BASE "/1/0", "DATA", .timeModified = backupTimeStart);
+            // File which will fail on alignment
+            relation = bufNew(pgPageSize8 + 512);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            bufUsedSet(relation, bufSize(relation));
 
-            // Set log level to warn because the following test uses multiple processes so the log order will not be deterministic
-            harnessLogLevelSet(logLevelWarn);
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0xFE};
+            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)))->pd_checksum = pgPageChecksum(
+                bufPtr(relation) + (pgPageSize8 * 0x00), 0, pgPageSize8);
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0xFF};
 
-            // Run backup but error on first archive check
-            hrnBackupPqScriptP(
-                PG_VERSION_96, backupTimeStart, .noPriorWal = true, .backupStandby = true, .walCompressType = compressTypeGz,
-                .startFast = true);
-            TEST_ERROR(
-                hrnCmdBackup(), ArchiveTimeoutError,
-                "WAL segment 0000000105DA69BF000000FF was not archived before the 100ms timeout\n"
-                "HINT: check the archive_command to ensure that all options are correct (especially --stanza).\n"
-                "HINT: check the PostgreSQL server log for errors.\n"
-                "HINT: run the 'start' command if the stanza was previously stopped.");
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/2", relation, .timeModified = backupTimeStart);
 
-            // Run backup but error on archive check
-            hrnBackupPqScriptP(
-                PG_VERSION_96, backupTimeStart, .noWal = true, .backupStandby = true, .walCompressType = compressTypeGz,
-                .startFast = true);
+            // File with bad page checksums
+            relation = bufNew(pgPageSize8 * 5);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0xFF};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0x00};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)) = (PageHeaderData){.pd_upper = 0xFE};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x03)) = (PageHeaderData){.pd_upper = 0xEF};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x04)) = (PageHeaderData){.pd_upper = 0x00};
+            (bufPtr(relation) + (pgPageSize8 * 0x04))[pgPageSize8 - 1] = 0xFF;
+            bufUsedSet(relation, bufSize(relation));
+
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
+
+            // File with bad page checksum
+            relation = bufNew(pgPageSize8 * 3);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0x00};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0x08};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)) = (PageHeaderData){.pd_upper = 0xFF};
+            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)))->pd_checksum = pgPageChecksum(
+                bufPtr(relation) + (pgPageSize8 * 0x02), 2, pgPageSize8);
+            bufUsedSet(relation, bufSize(relation));
+
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/4", relation, .timeModified = backupTimeStart);
+
+            // Add a tablespace
+            HRN_STORAGE_PATH_CREATE(storagePgWrite(), PG_PATH_PGTBLSPC);
+            THROW_ON_SYS_ERROR(
+                symlink("../../pg1-tblspc/32768", strZ(storagePathP(storagePg(), STRDEF(PG_PATH_PGTBLSPC "/32768")))) == -1,
+                FileOpenError, "unable to create symlink");
+
+            HRN_STORAGE_PUT_EMPTY(
+                storageTest,
+                zNewFmt("pg1-tblspc/32768/%s/1/5", strZ(pgTablespaceId(PG_VERSION_11, hrnPgCatalogVersion(PG_VERSION_11)))),
+                .timeModified = backupTimeStart);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+            // Disable storageFeatureSymLink so tablespace (and latest) symlinks will not be created
+            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeatureSymLink;
+
+            // Disable storageFeatureHardLink so hardlinks will not be created
+            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeatureHardLink;
+
+            // Run backup
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 3, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            // Reset storage features
+            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeatureSymLink;
+            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeatureHardLink;
+#pragma GCC diagnostic pop
+
+            TEST_RESULT_LOG(
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DB5DE000000000, lsn = 5db5de0/0\n"
+                "P00   INFO: check archive for segment 0000000105DB5DE000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (40KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: invalid page checksums found in file " TEST_PATH "/pg1/base/1/3 at pages 0, 2-4\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 (24KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: invalid page checksum found in file " TEST_PATH "/pg1/base/1/4 at page 1\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/1 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (8.5KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: page misalignment in file " TEST_PATH "/pg1/base/1/2: file size 8704 is not divisible by page size"
+                " 8192\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/pg_tblspc/32768/PG_11_201809051/1/5 (0B, [PCT])\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DB5DE000000002, lsn = 5db5de0/280000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00 DETAIL: wrote 'tablespace_map' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DB5DE000000000:0000000105DB5DE000000002\n"
+                "P00 DETAIL: copy segment 0000000105DB5DE000000000 to backup\n"
+                "P00 DETAIL: copy segment 0000000105DB5DE000000001 to backup\n"
+                "P00 DETAIL: copy segment 0000000105DB5DE000000002 to backup\n"
+                "P00   INFO: new backup label = 20191027-181320F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 13");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/20191027-181320F")),
+                "pg_data/PG_VERSION.gz {s=2}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/base/1/1.gz {s=16384, ckp=t}\n"
+                "pg_data/base/1/2.gz {s=8704, ckp=t}\n"
+                "pg_data/base/1/3.gz {s=40960, ckp=[0,[2,4]]}\n"
+                "pg_data/base/1/4.gz {s=24576, ckp=[1]}\n"
+                "pg_data/global/pg_control.gz {s=8192}\n"
+                "pg_data/pg_tblspc/\n"
+                "pg_data/pg_wal/0000000105DB5DE000000000.gz {s=1048576, ts=+2}\n"
+                "pg_data/pg_wal/0000000105DB5DE000000001.gz {s=1048576, ts=+2}\n"
+                "pg_data/pg_wal/0000000105DB5DE000000002.gz {s=1048576, ts=+2}\n"
+                "pg_data/postgresql.conf.gz {s=11, ts=-2200000}\n"
+                "pg_data/tablespace_map.gz {s=19, ts=+2}\n"
+                "pg_tblspc/32768/PG_11_201809051/1/5.gz {s=0, ckp=t}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n"
+                "pg_tblspc/32768={\"path\":\"../../pg1-tblspc/32768\",\"tablespace-id\":\"32768\""
+                ",\"tablespace-name\":\"tblspc32768\",\"type\":\"link\"}\n",
+                "compare file list");
+
+            // Remove test files
+            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/2", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/3", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/4", .errorOnMissing = true);
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when pg_control not present");
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Preserve prior timestamp on pg_control
+            hrnBackupPqScriptP(PG_VERSION_11, BACKUP_EPOCH + 2300000, .errorAfterStart = true);
+            HRN_PG_CONTROL_TIME(storagePg(), backupTimeStart);
+
+            // Run backup
             TEST_ERROR(
-                hrnCmdBackup(), ArchiveTimeoutError,
-                "WAL segment 0000000105DA69C000000000 was not archived before the 100ms timeout\n"
-                "HINT: check the archive_command to ensure that all options are correct (especially --stanza).\n"
-                "HINT: check the PostgreSQL server log for errors.\n"
-                "HINT: run the 'start' command if the stanza was previously stopped.");
+                hrnCmdBackup(), FileMissingError,
+                "pg_control must be present in all online backups\n"
+                "HINT: is something wrong with the clock or filesystem timestamps?");
 
-            // Remove halted backup so there's no resume
-            HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191016-042640F", .recurse = true);
+            // Check log
+            TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191027-181320F, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DB764000000000, lsn = 5db7640/0\n"
+                "P00   INFO: check archive for prior segment 0000000105DB763F00000FFF");
+
+            // Remove partial backup so it won't be resumed (since it errored before any checksums were written)
+            HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191027-181320F_20191028-220000I", .recurse = true);
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 incr backup with tablespaces");
+
+        backupTimeStart = BACKUP_EPOCH + 2400000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 1, "/repo-bogus");
+            hrnCfgArgKeyRaw(argList, cfgOptRepoPath, 2, repoPath);
+            hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 2, "1");
+            hrnCfgArgKeyRawBool(argList, cfgOptRepoHardlink, 2, true);
+            hrnCfgArgRawZ(argList, cfgOptRepo, "2");
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawBool(argList, cfgOptDelta, true);
+            hrnCfgArgRawBool(argList, cfgOptPageHeaderCheck, false);
+            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // File with bad page checksum and header errors that will be ignored
+            Buffer *relation = bufNew(pgPageSize8 * 4);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0xFF};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0x00};
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)) = (PageHeaderData){.pd_upper = 0x00};
+            (bufPtr(relation) + (pgPageSize8 * 0x02))[pgPageSize8 - 1] = 0xFF;
+            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)))->pd_checksum = pgPageChecksum(
+                bufPtr(relation) + (pgPageSize8 * 0x02), 2, pgPageSize8);
+            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x03)) = (PageHeaderData){.pd_upper = 0x00};
+            (bufPtr(relation) + (pgPageSize8 * 0x03))[pgPageSize8 - 1] = 0xEE;
+            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x03)))->pd_checksum = 1;
+            bufUsedSet(relation, bufSize(relation));
 
-            // Set archive.info/copy to an older timestamp so we can be sure it was updated as part of backup
-            time_t archiveInfoOldTimestamp = 967746268;
-            HRN_STORAGE_TIME(storageRepo(), INFO_ARCHIVE_PATH_FILE, archiveInfoOldTimestamp);
-            HRN_STORAGE_TIME(storageRepo(), INFO_ARCHIVE_PATH_FILE_COPY, archiveInfoOldTimestamp);
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
 
-            // Get a copy of archive.info
-            const String *archiveInfoContent = strNewBuf(storageGetP(storageNewReadP(storageRepo(), INFO_ARCHIVE_PATH_FILE_STR)));
+            // File will be truncated during backup to show that actual file size is copied no matter what original size is. This
+            // will also cause an alignment error.
+            Buffer *relationAfter = bufNew(pgPageSize8 + 15);
+            memset(bufPtr(relationAfter), 0, bufSize(relationAfter));
+            bufUsedSet(relationAfter, bufSize(relationAfter));
 
-            // Run backup
-            hrnBackupPqScriptP(
-                PG_VERSION_96, backupTimeStart, .backupStandby = true, .walCompressType = compressTypeGz, .startFast = true);
+            // Run backup. Make sure that the timeline selected converts to hexadecimal that can't be interpreted as decimal.
+            HRN_BACKUP_SCRIPT_SET(
+                {.op = hrnBackupScriptOpUpdate, .file = storagePathP(storagePg(), STRDEF(PG_PATH_BASE "/1/1")),
+                 .time = backupTimeStart, .content = relationAfter});
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .timeline = 0x2C, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // Check archive.info/copy timestamp was updated but contents were not
-            TEST_RESULT_INT_NE(
-                storageInfoP(storageRepo(), INFO_ARCHIVE_PATH_FILE_STR).timeModified, archiveInfoOldTimestamp, "time updated");
-            TEST_STORAGE_GET(storageRepo(), INFO_ARCHIVE_PATH_FILE, strZ(archiveInfoContent));
-            TEST_RESULT_INT_NE(
-                storageInfoP(storageRepo(), INFO_ARCHIVE_PATH_FILE_COPY_STR).timeModified, archiveInfoOldTimestamp, "time updated");
-            TEST_STORAGE_GET(storageRepo(), INFO_ARCHIVE_PATH_FILE_COPY, strZ(archiveInfoContent));
-
-            // Set log level back to detail
-            harnessLogLevelSet(logLevelDetail);
-
             TEST_RESULT_LOG(
-                "P00   WARN: no prior backup exists, incr backup has been changed to full");
+                "P00   INFO: last backup label = 20191027-181320F, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000002C05DB8EB000000000, lsn = 5db8eb0/0\n"
+                "P00   INFO: check archive for segment 0000002C05DB8EB000000000\n"
+                "P00   WARN: a timeline switch has occurred since the 20191027-181320F backup, enabling delta checksum\n"
+                "            HINT: this is normal after restoring from backup or promoting a standby.\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (32KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: invalid page checksums found in file " TEST_PATH "/pg1/base/1/3 at pages 0, 3\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/1 (16KB->8KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: page misalignment in file " TEST_PATH "/pg1/base/1/1: file size 8207 is not divisible by page size"
+                " 8192\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: hardlink pg_data/PG_VERSION to 20191027-181320F\n"
+                "P00 DETAIL: hardlink pg_data/postgresql.conf to 20191027-181320F\n"
+                "P00 DETAIL: hardlink pg_tblspc/32768/PG_11_201809051/1/5 to 20191027-181320F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000002C05DB8EB000000001, lsn = 5db8eb0/180000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00 DETAIL: wrote 'tablespace_map' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000002C05DB8EB000000000:0000002C05DB8EB000000001\n"
+                "P00   INFO: new backup label = 20191027-181320F_20191030-014640I\n"
+                "P00   INFO: incr backup size = [SIZE], file total = 8");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191016-042640F}\n"
-                "pg_data/PG_VERSION {s=3}\n"
-                "pg_data/backup_label {s=17, ts=+2}\n"
-                "pg_data/base/1/1 {s=0}\n"
-                "pg_data/base/1/2 {s=2}\n"
-                "pg_data/base/1/3 {s=3, so=4}\n"
-                "pg_data/global/pg_control {s=8192}\n"
-                "pg_data/pg_xlog/0000000105DA69C000000000 {s=16777216, ts=+2}\n"
-                "pg_data/postgresql.conf {s=11, ts=-1200000}\n"
+                ".> {d=20191027-181320F_20191030-014640I}\n"
+                "pg_data/PG_VERSION.gz {s=2, ts=-200000}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/base/1/1.gz {s=8207, so=16384, ts=-200000, ckp=t}\n"
+                "pg_data/base/1/3.gz {s=32768, ckp=[0,3]}\n"
+                "pg_data/global/pg_control.gz {s=8192}\n"
+                "pg_data/pg_tblspc/32768> {d=../../pg_tblspc/32768}\n"
+                "pg_data/pg_wal/\n"
+                "pg_data/postgresql.conf.gz {s=11, ts=-2400000}\n"
+                "pg_data/tablespace_map.gz {s=19, ts=+2}\n"
+                "pg_tblspc/32768/PG_11_201809051/1/5.gz {s=0, ts=-200000, ckp=t}\n"
                 "--------\n"
                 "[backup:target]\n"
-                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n"
+                "pg_tblspc/32768={\"path\":\"../../pg1-tblspc/32768\",\"tablespace-id\":\"32768\""
+                ",\"tablespace-name\":\"tblspc32768\",\"type\":\"link\"}\n",
                 "compare file list");
 
             // Remove test files
-            HRN_STORAGE_PATH_REMOVE(storagePgIdxWrite(1), NULL, .recurse = true);
-            HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "base/1", .recurse = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/3", .errorOnMissing = true);
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 9.6 backup-standby full backup with block incremental");
+        TEST_TITLE("online 11 full backup with tablespaces, bundles, annotations and unexpected pg_control/pg_catalog version");
 
-        backupTimeStart = BACKUP_EPOCH + 1600000;
+        backupTimeStart = BACKUP_EPOCH + 2400000;
 
         {
             // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
-            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
             hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawZ(argList, cfgOptManifestSaveThreshold, "1");
+            hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
+            hrnCfgArgRawZ(argList, cfgOptBufferSize, "16K");
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
-            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
-            hrnCfgArgRawBool(argList, cfgOptCompress, false);
-            hrnCfgArgRawBool(argList, cfgOptBackupStandby, true);
-            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
+            hrnCfgArgRawBool(argList, cfgOptResume, false);
+            hrnCfgArgRawZ(argList, cfgOptAnnotation, "extra key=this is an annotation");
+            hrnCfgArgRawZ(argList, cfgOptAnnotation, "source=this is another annotation");
+            hrnCfgArgRawZ(argList, cfgOptPgVersionForce, "11");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Add file that is large enough for block incremental but larger on the primary than the standby. The standby size will
-            // be increased before the next backup.
-            Buffer *relation = bufNew(pgPageSize8 * 5);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            bufUsedSet(relation, bufSize(relation));
+            // Create pg_control with unexpected catalog and control version
+            HRN_PG_CONTROL_OVERRIDE_VERSION_PUT(
+                storagePgWrite(), PG_VERSION_11, 1501, .catalogVersion = 202211110, .pageChecksumVersion = 1,
+                .walSegmentSize = 1024 * 1024);
 
-            HRN_STORAGE_PUT(storagePgIdxWrite(0), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
+            // Set to a smaller values than the defaults allow
+            cfgOptionSet(cfgOptRepoBundleSize, cfgSourceParam, VARINT64(pgPageSize8));
+            cfgOptionSet(cfgOptRepoBundleLimit, cfgSourceParam, VARINT64(pgPageSize8));
 
-            bufUsedSet(relation, bufSize(relation) - pgPageSize8 * 2);
-            HRN_STORAGE_PUT(storagePgIdxWrite(1), PG_PATH_BASE "/1/3", relation);
+            // Zero-length file to be stored
+            HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "zero", .timeModified = backupTimeStart);
 
-            // Add file that is large enough for block incremental but larger on the primary than the standby. This tests that file
-            // size is set correctly when a file is referenced to a prior backup but the original size is different.
+            // Zeroed file which passes page checksums
+            Buffer *relation = bufNew(pgPageSize8 * 3);
+            memset(bufPtr(relation), 0, bufSize(relation));
             bufUsedSet(relation, bufSize(relation));
 
-            HRN_STORAGE_PUT(storagePgIdxWrite(0), PG_PATH_BASE "/1/4", relation, .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/2", relation, .timeModified = backupTimeStart);
 
-            bufUsedSet(relation, bufSize(relation) - pgPageSize8);
-            HRN_STORAGE_PUT(storagePgIdxWrite(1), PG_PATH_BASE "/1/4", relation);
+            // Old files
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.auto.conf", "CONFIGSTUFF2", .timeModified = 1500000000);
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "stuff.conf", "CONFIGSTUFF3", .timeModified = 1500000000);
 
-            // Set log level to warn because the following test uses multiple processes so the log order will not be deterministic
-            harnessLogLevelSet(logLevelWarn);
+            // File that will get skipped while bundling smaller files and end up a bundle by itself
+            Buffer *bigish = bufNew(pgPageSize8 - 1);
+            memset(bufPtr(bigish), 0, bufSize(bigish));
+            bufUsedSet(bigish, bufSize(bigish));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "bigish.dat", bigish, .timeModified = 1500000001);
 
             // Run backup
-            hrnBackupPqScriptP(PG_VERSION_96, backupTimeStart, .backupStandby = true, .startFast = true);
+            hrnBackupPqScriptP(
+                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .pgVersionForce = STRDEF("11"),
+                .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // Set log level back to detail
-            harnessLogLevelSet(logLevelDetail);
+            TEST_RESULT_LOG(
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DB8EB000000000, lsn = 5db8eb0/0\n"
+                "P00   INFO: check archive for segment 0000000105DB8EB000000000\n"
+                "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/zero\n"
+                "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/pg_tblspc/32768/PG_11_201809051/1/5\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/1 (8KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: page misalignment in file " TEST_PATH "/pg1/base/1/1: file size 8207 is not divisible by page size"
+                " 8192\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/stuff.conf (bundle 1/0, 12B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.auto.conf (bundle 1/32, 12B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (bundle 1/64, 11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/95, 2B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/bigish.dat (bundle 2/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 3/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DB8EB000000001, lsn = 5db8eb0/180000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00 DETAIL: wrote 'tablespace_map' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DB8EB000000000:0000000105DB8EB000000001\n"
+                "P00 DETAIL: copy segment 0000000105DB8EB000000000 to backup\n"
+                "P00 DETAIL: copy segment 0000000105DB8EB000000001 to backup\n"
+                "P00   INFO: new backup label = 20191030-014640F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 14");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191020-193320F}\n"
-                "bundle/1/pg_data/PG_VERSION {s=3, ts=-400000}\n"
-                "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "bundle/1/pg_data/postgresql.conf {s=11, ts=-1600000}\n"
-                "bundle/2/pg_data/base/1/3 {s=24576, so=40960, m=0:{0,1,2}}\n"
-                "bundle/2/pg_data/base/1/4 {s=32768, so=40960, m=0:{0,1,2,3}}\n"
-                "pg_data/backup_label {s=17, ts=+2}\n"
+                ".> {d=20191030-014640F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, ts=-200000}\n"
+                "bundle/1/pg_data/postgresql.auto.conf {s=12, ts=-72400000}\n"
+                "bundle/1/pg_data/postgresql.conf {s=11, ts=-2400000}\n"
+                "bundle/1/pg_data/stuff.conf {s=12, ts=-72400000}\n"
+                "bundle/2/pg_data/bigish.dat {s=8191, ts=-72399999}\n"
+                "bundle/3/pg_data/global/pg_control {s=8192}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/base/1/1.gz {s=8207, ckp=t}\n"
+                "pg_data/base/1/2.gz {s=24576, ckp=t}\n"
+                "pg_data/pg_wal/0000000105DB8EB000000000.gz {s=1048576, ts=+2}\n"
+                "pg_data/pg_wal/0000000105DB8EB000000001.gz {s=1048576, ts=+2}\n"
+                "pg_data/tablespace_map.gz {s=19, ts=+2}\n"
                 "--------\n"
                 "[backup:target]\n"
-                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n"
+                "pg_tblspc/32768={\"path\":\"../../pg1-tblspc/32768\",\"tablespace-id\":\"32768\""
+                ",\"tablespace-name\":\"tblspc32768\",\"type\":\"link\"}\n"
+                "\n"
+                "[metadata]\n"
+                "annotation={\"extra key\":\"this is an annotation\",\"source\":\"this is another annotation\"}\n",
                 "compare file list");
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 9.6 backup-standby incr backup with block incremental");
+        TEST_TITLE("online 11 diff backup with bundles");
 
-        backupTimeStart = BACKUP_EPOCH + 1700000;
+        backupTimeStart = BACKUP_EPOCH + 2600000;
 
         {
+            // Remove old pg data
+            HRN_STORAGE_PATH_REMOVE(storageTest, "pg1-data", .recurse = true);
+            HRN_STORAGE_PATH_REMOVE(storageTest, "pg1-tblspc", .recurse = true);
+            HRN_STORAGE_REMOVE(storageTest, "pg1");
+
+            // Update pg_control
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .walSegmentSize = 2 * 1024 * 1024);
+
+            // Update version
+            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_11_Z, .timeModified = backupTimeStart);
+
             // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
-            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
-            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
-            hrnCfgArgRawBool(argList, cfgOptCompress, false);
-            hrnCfgArgRawZ(argList, cfgOptBackupStandby, "prefer");
-            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
+            hrnCfgArgRawBool(argList, cfgOptDelta, true);
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Increase size of file on standby. This demonstrates that copy is using the larger file from the primary as the basis
-            // for how far to read.
-            Buffer *relation = bufNew(pgPageSize8 * 4);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            bufUsedSet(relation, bufSize(relation));
-
-            HRN_STORAGE_PUT(storagePgIdxWrite(1), PG_PATH_BASE "/1/3", relation);
-
-            // Set log level to warn because the following test uses multiple processes so the log order will not be deterministic
-            harnessLogLevelSet(logLevelWarn);
+            // Zero-length file to be stored
+            HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "zero", .timeModified = backupTimeStart);
 
             // Run backup
-            hrnBackupPqScriptP(PG_VERSION_96, backupTimeStart, .backupStandby = true, .startFast = true);
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // Set log level back to detail
-            harnessLogLevelSet(logLevelDetail);
+            TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191030-014640F, version = " PROJECT_VERSION "\n"
+                "P00   WARN: diff backup cannot alter 'checksum-page' option to 'false', reset to 'true' from 20191030-014640F\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DBBF8000000000, lsn = 5dbbf80/0\n"
+                "P00   INFO: check archive for segment 0000000105DBBF8000000000\n"
+                "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/zero\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191030-014640F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DBBF8000000001, lsn = 5dbbf80/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DBBF8000000000:0000000105DBBF8000000001\n"
+                "P00   INFO: new backup label = 20191030-014640F_20191101-092000D\n"
+                "P00   INFO: diff backup size = [SIZE], file total = 4");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191020-193320F_20191021-232000I}\n"
+                ".> {d=20191030-014640F_20191101-092000D}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "bundle/2/pg_data/base/1/3 {s=32768, so=40960, m=0:{0,1,2},1:{0}, ts=-100000}\n"
-                "pg_data/backup_label {s=17, ts=+2}\n"
-                "20191020-193320F/bundle/1/pg_data/PG_VERSION {s=3, ts=-500000}\n"
-                "20191020-193320F/bundle/2/pg_data/base/1/4 {s=32768, so=40960, m=0:{0,1,2,3}, ts=-100000}\n"
-                "20191020-193320F/bundle/1/pg_data/postgresql.conf {s=11, ts=-1700000}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "20191030-014640F/bundle/1/pg_data/PG_VERSION {s=2}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -2825,60 +5675,106 @@ testRun(void)
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 9.6 backup-standby (prefer) incr backup with block incremental");
+        TEST_TITLE("online 11 full backup with block incr");
 
-        backupTimeStart = BACKUP_EPOCH + 1800000;
+        backupTimeStart = BACKUP_EPOCH + 2800000;
+
+        // Block sizes for testing
+        #define BLOCK_MIN_SIZE                                      8192
+        #define BLOCK_MIN_FILE_SIZE                                 16384
+        #define BLOCK_MID_SIZE                                      16384
+        #define BLOCK_MID_FILE_SIZE                                 131072
+        #define BLOCK_MAX_SIZE                                      65536
+        #define BLOCK_MAX_FILE_SIZE                                 1507328
 
         {
+            // Remove old pg data
+            HRN_STORAGE_PATH_REMOVE(storageTest, "pg1", .recurse = true);
+
+            // Update pg_control
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .pageChecksumVersion = 0, .walSegmentSize = 2 * 1024 * 1024);
+
+            // Update version
+            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_11_Z, .timeModified = backupTimeStart);
+
             // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 1, pg1Path);
-            hrnCfgArgKeyRaw(argList, cfgOptPgPath, 2, pg2Path);
-            hrnCfgArgKeyRawZ(argList, cfgOptPgPort, 2, "5433");
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
+            hrnCfgArgRawBool(argList, cfgOptResume, false);
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
-            hrnCfgArgRawBool(argList, cfgOptCompress, false);
-            hrnCfgArgRawZ(argList, cfgOptBackupStandby, "prefer");
-            hrnCfgArgRawBool(argList, cfgOptStartFast, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "b=" STRINGIFY(BLOCK_MAX_SIZE) "b");
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Run backup
+            // File that uses block incr and will grow
+            Buffer *file = bufNew(BLOCK_MIN_SIZE * 3);
+            memset(bufPtr(file), 0, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-grow", file, .timeModified = backupTimeStart);
+
+            // File that uses block incr and will not be resumed
+            file = bufNew(BLOCK_MIN_SIZE * 3);
+            memset(bufPtr(file), 0, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-no-resume", file, .timeModified = backupTimeStart);
+
+            // Error when pg_control is missing after backup start
+            HRN_BACKUP_SCRIPT_SET(
+                {.op = hrnBackupScriptOpRemove, .file = storagePathP(storagePg(), STRDEF("global/pg_control"))});
             hrnBackupPqScriptP(
-                PG_VERSION_96, backupTimeStart, .backupStandby = true, .backupStandbyError = true, .startFast = true);
+                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true,
+                .errorAfterCopyStart = true);
+            TEST_ERROR(
+                hrnCmdBackup(), FileMissingError,
+                "raised from local-1 shim protocol: unable to open missing file '" TEST_PATH "/pg1/global/pg_control' for read");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DBF06000000000, lsn = 5dbf060/0\n"
+                "P00   INFO: check archive for segment 0000000105DBF06000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-no-resume (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (24KB, [PCT]) checksum [SHA1]");
+
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .pageChecksumVersion = 0, .walSegmentSize = 2 * 1024 * 1024);
+
+            // Run backup
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
             TEST_RESULT_LOG(
-                "P00   WARN: unable to check pg2: [DbConnectError] unable to connect to 'dbname='postgres' port=5433': error\n"
-                "P00   WARN: unable to find a standby to perform the backup, using primary instead\n"
-                "P00   INFO: last backup label = 20191020-193320F_20191021-232000I, version = " PROJECT_VERSION "\n"
-                "P00   INFO: execute non-exclusive backup start: backup begins after the requested immediate checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DAFC3000000000, lsn = 5dafc30/0\n"
-                "P00   INFO: check archive for prior segment 0000000105DAFC2F000000FF\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 (bundle 1/0, 40KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (bundle 1/8234, 40KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/16476, 8KB, [PCT]) checksum [SHA1]\n"
-                "P00 DETAIL: reference pg_data/PG_VERSION to 20191020-193320F\n"
-                "P00 DETAIL: reference pg_data/postgresql.conf to 20191020-193320F\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DBF06000000000, lsn = 5dbf060/0\n"
+                "P00   INFO: check archive for segment 0000000105DBF06000000000\n"
+                "P00   INFO: backup '20191103-165320F' cannot be resumed: partially deleted by prior resume or invalid\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-no-resume (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/8192, 2B, [PCT]) checksum [SHA1]\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105DAFC3000000000, lsn = 5dafc30/800000\n"
+                "P00   INFO: backup stop archive = 0000000105DBF06000000001, lsn = 5dbf060/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000000105DAFC3000000000:0000000105DAFC3000000000\n"
-                "P00   INFO: new backup label = 20191020-193320F_20191023-030640I\n"
-                "P00   INFO: incr backup size = [SIZE], file total = 6");
+                "P00   INFO: check archive for segment(s) 0000000105DBF06000000000:0000000105DBF06000000001\n"
+                "P00   INFO: new backup label = 20191103-165320F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 5");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191020-193320F_20191023-030640I}\n"
-                "bundle/1/pg_data/base/1/3 {s=40960, m=0:{0,1,2},1:{0},2:{0}, ts=-200000}\n"
-                "bundle/1/pg_data/base/1/4 {s=40960, m=0:{0,1,2,3},2:{0}, ts=-200000}\n"
+                ".> {d=20191103-165320F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
                 "pg_data/backup_label {s=17, ts=+2}\n"
-                "20191020-193320F/bundle/1/pg_data/PG_VERSION {s=3, ts=-600000}\n"
-                "20191020-193320F/bundle/1/pg_data/postgresql.conf {s=11, ts=-1800000}\n"
+                "pg_data/block-incr-grow.pgbi {s=24576, m=z,z,z}\n"
+                "pg_data/block-incr-no-resume.pgbi {s=24576, m=z,z,z}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -2886,319 +5782,353 @@ testRun(void)
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 11 full backup with tablespaces and page checksums");
+        TEST_TITLE("online 11 full backup with block incr resume");
 
-        backupTimeStart = BACKUP_EPOCH + 2200000;
+        backupTimeStart = BACKUP_EPOCH + 2900000;
 
         {
-            // Update pg_control
-            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .pageChecksumVersion = 1, .walSegmentSize = 1024 * 1024);
-
-            // Update version
-            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_11_Z, .timeModified = backupTimeStart);
-
-            // Update wal path
-            HRN_STORAGE_PATH_REMOVE(storagePgWrite(), strZ(pgWalPath(PG_VERSION_95)));
-            HRN_STORAGE_PATH_CREATE(storagePgWrite(), strZ(pgWalPath(PG_VERSION_11)), .noParentCreate = true);
-
-            // Upgrade stanza
-            StringList *argList = strLstNew();
-            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
-            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
-            hrnCfgArgRawBool(argList, cfgOptOnline, false);
-            HRN_CFG_LOAD(cfgCmdStanzaUpgrade, argList);
-
-            cmdStanzaUpgrade();
-            TEST_RESULT_LOG("P00   INFO: stanza-upgrade for stanza 'test1' on repo1");
-
             // Load options
-            argList = strLstNew();
+            StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
             hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
-            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
-            hrnCfgArgRawZ(argList, cfgOptManifestSaveThreshold, "1");
-            hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "b=" STRINGIFY(BLOCK_MAX_SIZE) "b");
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Move pg1-path and put a link in its place. This tests that backup works when pg1-path is a symlink yet should be
-            // completely invisible in the manifest and logging.
-            HRN_SYSTEM_FMT("mv %s %s-data", strZ(pg1Path), strZ(pg1Path));
-            HRN_SYSTEM_FMT("ln -s %s-data %s ", strZ(pg1Path), strZ(pg1Path));
-
-            // Zeroed file which passes page checksums
-            Buffer *relation = bufNew(pgPageSize8 * 2);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            bufUsedSet(relation, bufSize(relation));
+            // Make this backup look resumable
+            HRN_STORAGE_REMOVE(storageTest, "repo/backup/test1/20191103-165320F/backup.manifest");
+            HRN_STORAGE_REMOVE(storageTest, "repo/backup/test1/20191103-165320F/backup.manifest.pack");
 
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0};
+            // Corrupt file that uses block incr and will not be resumed
+            Buffer *file = bufNew(BLOCK_MIN_SIZE * 3);
+            memset(bufPtr(file), 99, bufSize(file));
+            bufUsedSet(file, bufSize(file));
 
-            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/1", relation, .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT(storageRepoWrite(), "backup/test1/20191103-165320F/pg_data/block-incr-no-resume.pgbi", file);
 
-            // File which will fail on alignment
-            relation = bufNew(pgPageSize8 + 512);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            bufUsedSet(relation, bufSize(relation));
+            // File that shrinks below the limit where it would get block incremental if it were new
+            file = bufNew(BLOCK_MIN_FILE_SIZE + 1);
+            memset(bufPtr(file), 55, bufSize(file));
+            bufUsedSet(file, bufSize(file));
 
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0xFE};
-            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)))->pd_checksum = pgPageChecksum(
-                bufPtr(relation) + (pgPageSize8 * 0x00), 0, pgPageSize8);
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0xFF};
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink", file, .timeModified = backupTimeStart);
 
-            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/2", relation, .timeModified = backupTimeStart);
+            // File that shrinks to the size of a single block
+            file = bufNew(BLOCK_MIN_FILE_SIZE);
+            memset(bufPtr(file), 44, bufSize(file));
+            bufUsedSet(file, bufSize(file));
 
-            // File with bad page checksums
-            relation = bufNew(pgPageSize8 * 5);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0xFF};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0x00};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)) = (PageHeaderData){.pd_upper = 0xFE};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x03)) = (PageHeaderData){.pd_upper = 0xEF};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x04)) = (PageHeaderData){.pd_upper = 0x00};
-            (bufPtr(relation) + (pgPageSize8 * 0x04))[pgPageSize8 - 1] = 0xFF;
-            bufUsedSet(relation, bufSize(relation));
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-block", file, .timeModified = backupTimeStart);
 
-            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
+            // File that shrinks below the size of a single block
+            file = bufNew(BLOCK_MIN_FILE_SIZE);
+            memset(bufPtr(file), 43, bufSize(file));
+            bufUsedSet(file, bufSize(file));
 
-            // File with bad page checksum
-            relation = bufNew(pgPageSize8 * 3);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0x00};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0x08};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)) = (PageHeaderData){.pd_upper = 0xFF};
-            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)))->pd_checksum = pgPageChecksum(
-                bufPtr(relation) + (pgPageSize8 * 0x02), 2, pgPageSize8);
-            bufUsedSet(relation, bufSize(relation));
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-below", file, .timeModified = backupTimeStart);
 
-            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/4", relation, .timeModified = backupTimeStart);
+            // Block incremental file that remains the same between backups
+            file = bufNew(BLOCK_MIN_FILE_SIZE);
+            memset(bufPtr(file), 33, bufSize(file));
+            bufUsedSet(file, bufSize(file));
 
-            // Add a tablespace
-            HRN_STORAGE_PATH_CREATE(storagePgWrite(), PG_PATH_PGTBLSPC);
-            THROW_ON_SYS_ERROR(
-                symlink("../../pg1-tblspc/32768", strZ(storagePathP(storagePg(), STRDEF(PG_PATH_PGTBLSPC "/32768")))) == -1,
-                FileOpenError, "unable to create symlink");
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-same", file, .timeModified = backupTimeStart);
 
-            HRN_STORAGE_PUT_EMPTY(
-                storageTest,
-                zNewFmt("pg1-tblspc/32768/%s/1/5", strZ(pgTablespaceId(PG_VERSION_11, hrnPgCatalogVersion(PG_VERSION_11)))),
-                .timeModified = backupTimeStart);
+            // Normal file that remains the same between backups
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "normal-same", "SAME", .timeModified = backupTimeStart);
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-qual"
-            // Disable storageFeatureSymLink so tablespace (and latest) symlinks will not be created
-            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeatureSymLink;
+            // File that grows above the limit
+            file = bufNew(BLOCK_MIN_FILE_SIZE - 1);
+            memset(bufPtr(file), 77, bufSize(file));
+            bufUsedSet(file, bufSize(file));
 
-            // Disable storageFeatureHardLink so hardlinks will not be created
-            ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeatureHardLink;
+            HRN_STORAGE_PUT(storagePgWrite(), "grow-to-block-incr", file, .timeModified = backupTimeStart);
 
             // Run backup
-            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 3, .walSwitch = true);
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // Reset storage features
-            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeatureSymLink;
-            ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeatureHardLink;
-#pragma GCC diagnostic pop
-
             TEST_RESULT_LOG(
-                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DB5DE000000000, lsn = 5db5de0/0\n"
-                "P00   INFO: check archive for segment 0000000105DB5DE000000000\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (40KB, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: invalid page checksums found in file " TEST_PATH "/pg1/base/1/3 at pages 0, 2-4\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 (24KB, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: invalid page checksum found in file " TEST_PATH "/pg1/base/1/4 at page 1\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/1 (16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (8.5KB, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: page misalignment in file " TEST_PATH "/pg1/base/1/2: file size 8704 is not divisible by page size"
-                " 8192\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/pg_tblspc/32768/PG_11_201809051/1/5 (0B, [PCT])\n"
+                "P00   WARN: backup '20191103-165320F' missing manifest removed from backup.info\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DC08C000000000, lsn = 5dc08c0/0\n"
+                "P00   INFO: check archive for segment 0000000105DC08C000000000\n"
+                "P00   WARN: resumable backup 20191103-165320F of same type exists -- invalid files will be removed then the backup"
+                " will resume\n"
+                "P00 DETAIL: remove path '" TEST_PATH "/repo/backup/test1/20191103-165320F/bundle' from resumed backup\n"
+                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191103-165320F/pg_data/backup_label' from resumed"
+                " backup (missing in manifest)\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-no-resume (24KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: resumed backup file pg_data/block-incr-no-resume did not have expected checksum"
+                " ebdd38b69cd5b9f2d00d273c981e16960fbbb4f7. The file was recopied and backup will continue but this may be an issue"
+                " unless the resumed backup path in the repository is known to be corrupted.\n"
+                "            NOTE: this does not indicate a problem with the PostgreSQL page checksums.\n"
+                "P01 DETAIL: checksum resumed file " TEST_PATH "/pg1/block-incr-grow (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/0, 2B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/normal-same (bundle 1/2, 4B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/grow-to-block-incr (bundle 1/6, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/16389, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-block (bundle 1/24581, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-below (bundle 1/40987, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink (bundle 1/57393, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-same (bundle 1/73807, 16KB, [PCT]) checksum [SHA1]\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105DB5DE000000002, lsn = 5db5de0/280000\n"
+                "P00   INFO: backup stop archive = 0000000105DC08C000000001, lsn = 5dc08c0/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00 DETAIL: wrote 'tablespace_map' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000000105DB5DE000000000:0000000105DB5DE000000002\n"
-                "P00 DETAIL: copy segment 0000000105DB5DE000000000 to backup\n"
-                "P00 DETAIL: copy segment 0000000105DB5DE000000001 to backup\n"
-                "P00 DETAIL: copy segment 0000000105DB5DE000000002 to backup\n"
-                "P00   INFO: new backup label = 20191027-181320F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 13");
+                "P00   INFO: check archive for segment(s) 0000000105DC08C000000000:0000000105DC08C000000001\n"
+                "P00   INFO: new backup label = 20191103-165320F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 11");
 
             TEST_RESULT_STR_Z(
-                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/20191027-181320F")),
-                "pg_data/PG_VERSION.gz {s=2}\n"
-                "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "pg_data/base/1/1.gz {s=16384, ckp=t}\n"
-                "pg_data/base/1/2.gz {s=8704, ckp=t}\n"
-                "pg_data/base/1/3.gz {s=40960, ckp=[0,[2,4]]}\n"
-                "pg_data/base/1/4.gz {s=24576, ckp=[1]}\n"
-                "pg_data/global/pg_control.gz {s=8192}\n"
-                "pg_data/pg_tblspc/\n"
-                "pg_data/pg_wal/0000000105DB5DE000000000.gz {s=1048576, ts=+2}\n"
-                "pg_data/pg_wal/0000000105DB5DE000000001.gz {s=1048576, ts=+2}\n"
-                "pg_data/pg_wal/0000000105DB5DE000000002.gz {s=1048576, ts=+2}\n"
-                "pg_data/postgresql.conf.gz {s=11, ts=-2200000}\n"
-                "pg_data/tablespace_map.gz {s=19, ts=+2}\n"
-                "pg_tblspc/32768/PG_11_201809051/1/5.gz {s=0, ckp=t}\n"
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ".> {d=20191103-165320F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, ts=-100000}\n"
+                "bundle/1/pg_data/block-incr-same {s=16384, m=0:{0,1}}\n"
+                "bundle/1/pg_data/block-incr-shrink {s=16385, m=0:{0,1,2}}\n"
+                "bundle/1/pg_data/block-incr-shrink-below {s=16384, m=0:{0,1}}\n"
+                "bundle/1/pg_data/block-incr-shrink-block {s=16384, m=0:{0,1}}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "bundle/1/pg_data/grow-to-block-incr {s=16383}\n"
+                "bundle/1/pg_data/normal-same {s=4}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
+                "pg_data/block-incr-grow.pgbi {s=24576, m=z,z,z, ts=-100000}\n"
+                "pg_data/block-incr-no-resume.pgbi {s=24576, m=z,z,z, ts=-100000}\n"
                 "--------\n"
                 "[backup:target]\n"
-                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n"
-                "pg_tblspc/32768={\"path\":\"../../pg1-tblspc/32768\",\"tablespace-id\":\"32768\""
-                ",\"tablespace-name\":\"tblspc32768\",\"type\":\"link\"}\n",
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
 
-            // Remove test files
-            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/2", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/3", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/4", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-no-resume");
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("error when pg_control not present");
+        TEST_TITLE("online 11 diff backup with block incr");
+
+        backupTimeStart = BACKUP_EPOCH + 3000000;
 
         {
+            // Load the previous manifest and null out the checksum-page option to be sure it gets set to false in this backup
+            const String *manifestPriorFile = STRDEF(STORAGE_REPO_BACKUP "/20191103-165320F/" BACKUP_MANIFEST_FILE);
+            Manifest *manifestPrior = manifestNewLoad(storageReadIo(storageNewReadP(storageRepo(), manifestPriorFile)));
+            manifestPrior->pub.data.backupOptionChecksumPage = NULL;
+            manifestSave(manifestPrior, storageWriteIo(storageNewWriteP(storageRepoWrite(), manifestPriorFile)));
+            HRN_STORAGE_REMOVE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191103-165320F/" BACKUP_MANIFEST_PACK_FILE);
+
             // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
-            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "=" STRINGIFY(BLOCK_MAX_SIZE));
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeSuper, "1MiB");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Preserve prior timestamp on pg_control
-            hrnBackupPqScriptP(PG_VERSION_11, BACKUP_EPOCH + 2300000, .errorAfterStart = true);
-            HRN_PG_CONTROL_TIME(storagePg(), backupTimeStart);
+            // Grow file size to check block incr delta. This is large enough that it would get a new block size if it were a new
+            // file rather than a delta. Also split the first super block.
+            Buffer *file = bufNew(BLOCK_MID_FILE_SIZE);
+            memset(bufPtr(file), 0, bufSize(file));
+            memset(bufPtr(file) + BLOCK_MIN_SIZE, 1, BLOCK_MIN_SIZE);
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-grow", file, .timeModified = backupTimeStart);
+
+            // File that gets a larger block size and multiple super blocks
+            file = bufNew(BLOCK_MAX_FILE_SIZE);
+            memset(bufPtr(file), 0, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-larger", file, .timeModified = backupTimeStart);
+
+            // File with data that gets a larger block size and multiple super blocks (zero blocks above are not stored)
+            file = bufNew(BLOCK_MAX_FILE_SIZE);
+            memset(bufPtr(file), 1, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-larger-data", file, .timeModified = backupTimeStart);
+
+            // Shrink file below the limit where it would get block incremental if it were new
+            file = bufNew(BLOCK_MIN_FILE_SIZE - 1);
+            memset(bufPtr(file), 55, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink", file, .timeModified = backupTimeStart);
+
+            // Shrink file to the size of a single block
+            file = bufNew(BLOCK_MIN_SIZE);
+            memset(bufPtr(file), 44, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-block", file, .timeModified = backupTimeStart);
+
+            // Shrinks file below the size of a single block
+            file = bufNew(8);
+            memset(bufPtr(file), 44, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-below", file, .timeModified = backupTimeStart);
+
+            // Update timestamps without changing contents of the files
+            HRN_STORAGE_TIME(storagePgWrite(), "block-incr-same", backupTimeStart);
+            HRN_STORAGE_TIME(storagePgWrite(), "normal-same", backupTimeStart);
+
+            // Grow file above the limit
+            file = bufNew(BLOCK_MIN_FILE_SIZE + 1);
+            memset(bufPtr(file), 77, bufSize(file));
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "grow-to-block-incr", file, .timeModified = backupTimeStart);
+
+            // File that gets truncated to zero during the backup
+            HRN_STORAGE_PUT(storagePgWrite(), "truncate-to-zero", BUFSTRDEF("DATA"), .timeModified = backupTimeStart);
 
             // Run backup
-            TEST_ERROR(
-                hrnCmdBackup(), FileMissingError,
-                "pg_control must be present in all online backups\n"
-                "HINT: is something wrong with the clock or filesystem timestamps?");
+            HRN_BACKUP_SCRIPT_SET(
+                {.op = hrnBackupScriptOpUpdate, .file = storagePathP(storagePg(), STRDEF("truncate-to-zero")),
+                 .time = backupTimeStart + 1});
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
-            // Check log
             TEST_RESULT_LOG(
-                "P00   INFO: last backup label = 20191027-181320F, version = " PROJECT_VERSION "\n"
+                "P00   INFO: last backup label = 20191103-165320F, version = " PROJECT_VERSION "\n"
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DB764000000000, lsn = 5db7640/0\n"
-                "P00   INFO: check archive for prior segment 0000000105DB763F00000FFF");
+                "P00   INFO: backup start archive = 0000000105DC213000000000, lsn = 5dc2130/0\n"
+                "P00   INFO: check archive for segment 0000000105DC213000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-larger-data (1.4MB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-larger (1.4MB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (128KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: store truncated file " TEST_PATH "/pg1/truncate-to-zero (4B->0B, [PCT])\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/normal-same (4B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/grow-to-block-incr (bundle 1/0, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/16411, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-block (bundle 1/24603, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-below (bundle 1/24620, 8B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink (bundle 1/24628, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/block-incr-same (16KB, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191103-165320F\n"
+                "P00 DETAIL: reference pg_data/block-incr-same to 20191103-165320F\n"
+                "P00 DETAIL: reference pg_data/normal-same to 20191103-165320F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DC213000000001, lsn = 5dc2130/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DC213000000000:0000000105DC213000000001\n"
+                "P00   INFO: new backup label = 20191103-165320F_20191106-002640D\n"
+                "P00   INFO: diff backup size = [SIZE], file total = 13");
 
-            // Remove partial backup so it won't be resumed (since it errored before any checksums were written)
-            HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191027-181320F_20191028-220000I", .recurse = true);
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ".> {d=20191103-165320F_20191106-002640D}\n"
+                "bundle/1/pg_data/block-incr-shrink {s=16383, m=0:{0},1:{0}}\n"
+                "bundle/1/pg_data/block-incr-shrink-below {s=8}\n"
+                "bundle/1/pg_data/block-incr-shrink-block {s=8192, m=0:{0}}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "bundle/1/pg_data/grow-to-block-incr {s=16385, m=1:{0,1,2}}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
+                "pg_data/block-incr-grow.pgbi {s=131072, m=z,1:{0},z,z,z,z,z,z,z,z,z,z,z,z,z,z}\n"
+                "pg_data/block-incr-larger-data.pgbi {s=1507328, m=1:{0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15},1:{0,1,2,3,4,5,6}}\n"
+                "pg_data/block-incr-larger.pgbi {s=1507328, m=z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z,z}\n"
+                "20191103-165320F/bundle/1/pg_data/PG_VERSION {s=2, ts=-200000}\n"
+                "20191103-165320F/bundle/1/pg_data/block-incr-same {s=16384, m=0:{0,1}}\n"
+                "20191103-165320F/bundle/1/pg_data/normal-same {s=4}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-grow");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-larger");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-larger-data");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-same");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-shrink");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-shrink-below");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-shrink-block");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "grow-to-block-incr");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "normal-same");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "truncate-to-zero");
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 11 incr backup with tablespaces");
+        TEST_TITLE("online 11 full backup with block incr dedup");
 
-        backupTimeStart = BACKUP_EPOCH + 2400000;
+        backupTimeStart = BACKUP_EPOCH + 3050000;
 
         {
             // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
-            hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 1, "/repo-bogus");
-            hrnCfgArgKeyRaw(argList, cfgOptRepoPath, 2, repoPath);
-            hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 2, "1");
-            hrnCfgArgKeyRawBool(argList, cfgOptRepoHardlink, 2, true);
-            hrnCfgArgRawZ(argList, cfgOptRepo, "2");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
-            hrnCfgArgRawBool(argList, cfgOptDelta, true);
-            hrnCfgArgRawBool(argList, cfgOptPageHeaderCheck, false);
-            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockDedup, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // File with bad page checksum and header errors that will be ignored
-            Buffer *relation = bufNew(pgPageSize8 * 4);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x00)) = (PageHeaderData){.pd_upper = 0xFF};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x01)) = (PageHeaderData){.pd_upper = 0x00};
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)) = (PageHeaderData){.pd_upper = 0x00};
-            (bufPtr(relation) + (pgPageSize8 * 0x02))[pgPageSize8 - 1] = 0xFF;
-            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x02)))->pd_checksum = pgPageChecksum(
-                bufPtr(relation) + (pgPageSize8 * 0x02), 2, pgPageSize8);
-            *(PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x03)) = (PageHeaderData){.pd_upper = 0x00};
-            (bufPtr(relation) + (pgPageSize8 * 0x03))[pgPageSize8 - 1] = 0xEE;
-            ((PageHeaderData *)(bufPtr(relation) + (pgPageSize8 * 0x03)))->pd_checksum = 1;
-            bufUsedSet(relation, bufSize(relation));
-
-            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
-
-            // File will be truncated during backup to show that actual file size is copied no matter what original size is. This
-            // will also cause an alignment error.
-            Buffer *relationAfter = bufNew(pgPageSize8 + 15);
-            memset(bufPtr(relationAfter), 0, bufSize(relationAfter));
-            bufUsedSet(relationAfter, bufSize(relationAfter));
-
-            // Run backup. Make sure that the timeline selected converts to hexadecimal that can't be interpreted as decimal.
-            HRN_BACKUP_SCRIPT_SET(
-                {.op = hrnBackupScriptOpUpdate, .file = storagePathP(storagePg(), STRDEF(PG_PATH_BASE "/1/1")),
-                 .time = backupTimeStart, .content = relationAfter});
-            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .timeline = 0x2C, .walTotal = 2, .walSwitch = true);
+            // Bundled block incremental file with blocks that will be added to the block index
+            Buffer *file = bufNew(BLOCK_MIN_FILE_SIZE);
+            memset(bufPtr(file), 0x11, BLOCK_MIN_SIZE);
+            memset(bufPtr(file) + BLOCK_MIN_SIZE, 0x22, BLOCK_MIN_SIZE);
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-dedup", file, .timeModified = backupTimeStart);
+
+            // Run backup
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
             TEST_RESULT_LOG(
-                "P00   INFO: last backup label = 20191027-181320F, version = " PROJECT_VERSION "\n"
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000002C05DB8EB000000000, lsn = 5db8eb0/0\n"
-                "P00   INFO: check archive for segment 0000002C05DB8EB000000000\n"
-                "P00   WARN: a timeline switch has occurred since the 20191027-181320F backup, enabling delta checksum\n"
-                "            HINT: this is normal after restoring from backup or promoting a standby.\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (32KB, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: invalid page checksums found in file " TEST_PATH "/pg1/base/1/3 at pages 0, 3\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/1 (16KB->8KB, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: page misalignment in file " TEST_PATH "/pg1/base/1/1: file size 8207 is not divisible by page size"
-                " 8192\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
-                "P00 DETAIL: hardlink pg_data/PG_VERSION to 20191027-181320F\n"
-                "P00 DETAIL: hardlink pg_data/postgresql.conf to 20191027-181320F\n"
-                "P00 DETAIL: hardlink pg_tblspc/32768/PG_11_201809051/1/5 to 20191027-181320F\n"
+                "P00   INFO: backup start archive = 0000000105DC2D6000000000, lsn = 5dc2d60/0\n"
+                "P00   INFO: check archive for segment 0000000105DC2D6000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/0, 2B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/2, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup (bundle 1/8194, 16KB, [PCT]) checksum [SHA1]\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000002C05DB8EB000000001, lsn = 5db8eb0/180000\n"
+                "P00   INFO: backup stop archive = 0000000105DC2D6000000001, lsn = 5dc2d60/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00 DETAIL: wrote 'tablespace_map' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000002C05DB8EB000000000:0000002C05DB8EB000000001\n"
-                "P00   INFO: new backup label = 20191027-181320F_20191030-014640I\n"
-                "P00   INFO: incr backup size = [SIZE], file total = 8");
+                "P00   INFO: check archive for segment(s) 0000000105DC2D6000000000:0000000105DC2D6000000001\n"
+                "P00   INFO: new backup label = 20191106-142000F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 4");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191027-181320F_20191030-014640I}\n"
-                "pg_data/PG_VERSION.gz {s=2, ts=-200000}\n"
-                "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "pg_data/base/1/1.gz {s=8207, so=16384, ts=-200000, ckp=t}\n"
-                "pg_data/base/1/3.gz {s=32768, ckp=[0,3]}\n"
-                "pg_data/global/pg_control.gz {s=8192}\n"
-                "pg_data/pg_tblspc/32768> {d=../../pg_tblspc/32768}\n"
-                "pg_data/pg_wal/\n"
-                "pg_data/postgresql.conf.gz {s=11, ts=-2400000}\n"
-                "pg_data/tablespace_map.gz {s=19, ts=+2}\n"
-                "pg_tblspc/32768/PG_11_201809051/1/5.gz {s=0, ts=-200000, ckp=t}\n"
+                ".> {d=20191106-142000F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, ts=-250000}\n"
+                "bundle/1/pg_data/block-dedup {s=16384, m=0:{0,1}}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
                 "--------\n"
                 "[backup:target]\n"
-                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n"
-                "pg_tblspc/32768={\"path\":\"../../pg1-tblspc/32768\",\"tablespace-id\":\"32768\""
-                ",\"tablespace-name\":\"tblspc32768\",\"type\":\"link\"}\n",
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
 
-            // Remove test files
-            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/3", .errorOnMissing = true);
+            TEST_RESULT_BOOL(
+                storageExistsP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest/" BLOCK_INDEX_FILE)), true, "block index exists");
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 11 full backup with tablespaces, bundles, annotations and unexpected pg_control/pg_catalog version");
+        TEST_TITLE("online 11 diff backup with block incr dedup finds blocks in prior backup");
 
-        backupTimeStart = BACKUP_EPOCH + 2400000;
+        backupTimeStart = BACKUP_EPOCH + 3100000;
 
         {
             // Load options
@@ -3207,191 +6137,168 @@ testRun(void)
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
-            hrnCfgArgRawZ(argList, cfgOptManifestSaveThreshold, "1");
-            hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
-            hrnCfgArgRawZ(argList, cfgOptBufferSize, "16K");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
-            hrnCfgArgRawBool(argList, cfgOptResume, false);
-            hrnCfgArgRawZ(argList, cfgOptAnnotation, "extra key=this is an annotation");
-            hrnCfgArgRawZ(argList, cfgOptAnnotation, "source=this is another annotation");
-            hrnCfgArgRawZ(argList, cfgOptPgVersionForce, "11");
+            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockDedup, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Create pg_control with unexpected catalog and control version
-            HRN_PG_CONTROL_OVERRIDE_VERSION_PUT(
-                storagePgWrite(), PG_VERSION_11, 1501, .catalogVersion = 202211110, .pageChecksumVersion = 1,
-                .walSegmentSize = 1024 * 1024);
-
-            // Set to a smaller values than the defaults allow
-            cfgOptionSet(cfgOptRepoBundleSize, cfgSourceParam, VARINT64(pgPageSize8));
-            cfgOptionSet(cfgOptRepoBundleLimit, cfgSourceParam, VARINT64(pgPageSize8));
-
-            // Zero-length file to be stored
-            HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "zero", .timeModified = backupTimeStart);
-
-            // Zeroed file which passes page checksums
-            Buffer *relation = bufNew(pgPageSize8 * 3);
-            memset(bufPtr(relation), 0, bufSize(relation));
-            bufUsedSet(relation, bufSize(relation));
-
-            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/2", relation, .timeModified = backupTimeStart);
-
-            // Old files
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "postgresql.auto.conf", "CONFIGSTUFF2", .timeModified = 1500000000);
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "stuff.conf", "CONFIGSTUFF3", .timeModified = 1500000000);
-
-            // File that will get skipped while bundling smaller files and end up a bundle by itself
-            Buffer *bigish = bufNew(pgPageSize8 - 1);
-            memset(bufPtr(bigish), 0, bufSize(bigish));
-            bufUsedSet(bigish, bufSize(bigish));
+            // Non-bundled block incremental file with blocks found in the block index
+            Buffer *file = bufNew(BLOCK_MIN_SIZE * 3);
+            memset(bufPtr(file), 0x11, BLOCK_MIN_SIZE);
+            memset(bufPtr(file) + BLOCK_MIN_SIZE, 0x22, BLOCK_MIN_SIZE);
+            memset(bufPtr(file) + BLOCK_MIN_SIZE * 2, 0x33, BLOCK_MIN_SIZE);
+            bufUsedSet(file, bufSize(file));
 
-            HRN_STORAGE_PUT(storagePgWrite(), "bigish.dat", bigish, .timeModified = 1500000001);
+            HRN_STORAGE_PUT(storagePgWrite(), "block-dedup-large", file, .timeModified = backupTimeStart);
+            HRN_STORAGE_TIME(storagePgWrite(), "block-dedup", backupTimeStart);
 
             // Run backup
-            hrnBackupPqScriptP(
-                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .pgVersionForce = STRDEF("11"),
-                .walSwitch = true);
+            hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
             TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191106-142000F, version = " PROJECT_VERSION "\n"
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DB8EB000000000, lsn = 5db8eb0/0\n"
-                "P00   INFO: check archive for segment 0000000105DB8EB000000000\n"
-                "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/zero\n"
-                "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/pg_tblspc/32768/PG_11_201809051/1/5\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (24KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/1 (8KB, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: page misalignment in file " TEST_PATH "/pg1/base/1/1: file size 8207 is not divisible by page size"
-                " 8192\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/stuff.conf (bundle 1/0, 12B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.auto.conf (bundle 1/32, 12B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (bundle 1/64, 11B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/95, 2B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/bigish.dat (bundle 2/0, 8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 3/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: backup start archive = 0000000105DC399000000000, lsn = 5dc3990/0\n"
+                "P00   INFO: check archive for segment 0000000105DC399000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-large (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/block-dedup (16KB, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191106-142000F\n"
+                "P00 DETAIL: reference pg_data/block-dedup to 20191106-142000F\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105DB8EB000000001, lsn = 5db8eb0/180000\n"
+                "P00   INFO: backup stop archive = 0000000105DC399000000001, lsn = 5dc3990/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00 DETAIL: wrote 'tablespace_map' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000000105DB8EB000000000:0000000105DB8EB000000001\n"
-                "P00 DETAIL: copy segment 0000000105DB8EB000000000 to backup\n"
-                "P00 DETAIL: copy segment 0000000105DB8EB000000001 to backup\n"
-                "P00   INFO: new backup label = 20191030-014640F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 14");
+                "P00   INFO: check archive for segment(s) 0000000105DC399000000000:0000000105DC399000000001\n"
+                "P00   INFO: new backup label = 20191106-142000F_20191107-041320D\n"
+                "P00   INFO: diff backup size = [SIZE], file total = 5");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191030-014640F}\n"
-                "bundle/1/pg_data/PG_VERSION {s=2, ts=-200000}\n"
-                "bundle/1/pg_data/postgresql.auto.conf {s=12, ts=-72400000}\n"
-                "bundle/1/pg_data/postgresql.conf {s=11, ts=-2400000}\n"
-                "bundle/1/pg_data/stuff.conf {s=12, ts=-72400000}\n"
-                "bundle/2/pg_data/bigish.dat {s=8191, ts=-72399999}\n"
-                "bundle/3/pg_data/global/pg_control {s=8192}\n"
-                "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "pg_data/base/1/1.gz {s=8207, ckp=t}\n"
-                "pg_data/base/1/2.gz {s=24576, ckp=t}\n"
-                "pg_data/pg_wal/0000000105DB8EB000000000.gz {s=1048576, ts=+2}\n"
-                "pg_data/pg_wal/0000000105DB8EB000000001.gz {s=1048576, ts=+2}\n"
-                "pg_data/tablespace_map.gz {s=19, ts=+2}\n"
+                ".> {d=20191106-142000F_20191107-041320D}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
+                "pg_data/block-dedup-large.pgbi {s=24576, m=0:{0,1},1:{0}}\n"
+                "20191106-142000F/bundle/1/pg_data/PG_VERSION {s=2, ts=-300000}\n"
+                "20191106-142000F/bundle/1/pg_data/block-dedup {s=16384, m=0:{0,1}}\n"
                 "--------\n"
                 "[backup:target]\n"
-                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n"
-                "pg_tblspc/32768={\"path\":\"../../pg1-tblspc/32768\",\"tablespace-id\":\"32768\""
-                ",\"tablespace-name\":\"tblspc32768\",\"type\":\"link\"}\n"
-                "\n"
-                "[metadata]\n"
-                "annotation={\"extra key\":\"this is an annotation\",\"source\":\"this is another annotation\"}\n",
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
+
+            TEST_RESULT_BOOL(
+                storageExistsP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest/" BLOCK_INDEX_FILE)), false,
+                "no new blocks for block index");
+
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-dedup");
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-dedup-large");
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 11 diff backup with bundles");
+        TEST_TITLE("online 11 full backup with block incr dedup finds blocks stored by the current backup");
 
-        backupTimeStart = BACKUP_EPOCH + 2600000;
+        backupTimeStart = BACKUP_EPOCH + 3130000;
 
         {
-            // Remove old pg data
-            HRN_STORAGE_PATH_REMOVE(storageTest, "pg1-data", .recurse = true);
-            HRN_STORAGE_PATH_REMOVE(storageTest, "pg1-tblspc", .recurse = true);
-            HRN_STORAGE_REMOVE(storageTest, "pg1");
-
-            // Update pg_control
-            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .walSegmentSize = 2 * 1024 * 1024);
-
-            // Update version
-            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_11_Z, .timeModified = backupTimeStart);
-
             // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
-            hrnCfgArgRawBool(argList, cfgOptDelta, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockDedup, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Zero-length file to be stored
-            HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "zero", .timeModified = backupTimeStart);
+            // Set bundle size so each block incremental file is in a separate bundle
+            cfgOptionSet(cfgOptRepoBundleSize, cfgSourceParam, VARINT64(BLOCK_MIN_FILE_SIZE));
+
+            // Files are bundled oldest first. Blocks stored by a job are shared with local processes when the job after next is
+            // created, so the blocks of each of the first, second, and fourth files are found in the file two after it. Files with
+            // new blocks are shared in map files that are merged when the new map file is at least as large.
+            Buffer *file = bufNew(BLOCK_MIN_FILE_SIZE);
+            bufUsedSet(file, bufSize(file));
+
+            for (unsigned int fileIdx = 0; fileIdx < 6; fileIdx++)
+            {
+                const uint8_t fill = (const uint8_t []){0x11, 0x44, 0x11, 0x66, 0x44, 0x66}[fileIdx];
+
+                memset(bufPtr(file), fill, BLOCK_MIN_SIZE);
+                memset(bufPtr(file) + BLOCK_MIN_SIZE, fill + 0x11, BLOCK_MIN_SIZE);
+
+                HRN_STORAGE_PUT(
+                    storagePgWrite(), zNewFmt("block-dedup-%u", fileIdx + 1), file, .timeModified = backupTimeStart - 6 + fileIdx);
+            }
 
             // Run backup
             hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
             TEST_RESULT_LOG(
-                "P00   INFO: last backup label = 20191030-014640F, version = " PROJECT_VERSION "\n"
-                "P00   WARN: diff backup cannot alter 'checksum-page' option to 'false', reset to 'true' from 20191030-014640F\n"
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DBBF8000000000, lsn = 5dbbf80/0\n"
-                "P00   INFO: check archive for segment 0000000105DBBF8000000000\n"
-                "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/zero\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
-                "P00 DETAIL: reference pg_data/PG_VERSION to 20191030-014640F\n"
+                "P00   INFO: backup start archive = 0000000105DC40F000000000, lsn = 5dc40f0/0\n"
+                "P00   INFO: check archive for segment 0000000105DC40F000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/0, 2B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/2, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-1 (bundle 2/0, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-2 (bundle 3/0, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-3 (bundle 4/0, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-4 (bundle 5/0, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-5 (bundle 6/0, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-6 (bundle 7/0, 16KB, [PCT]) checksum [SHA1]\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105DBBF8000000001, lsn = 5dbbf80/300000\n"
+                "P00   INFO: backup stop archive = 0000000105DC40F000000001, lsn = 5dc40f0/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000000105DBBF8000000000:0000000105DBBF8000000001\n"
-                "P00   INFO: new backup label = 20191030-014640F_20191101-092000D\n"
-                "P00   INFO: diff backup size = [SIZE], file total = 4");
+                "P00   INFO: check archive for segment(s) 0000000105DC40F000000000:0000000105DC40F000000001\n"
+                "P00   INFO: new backup label = 20191107-123320F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 9");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191030-014640F_20191101-092000D}\n"
+                ".> {d=20191107-123320F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, ts=-330000}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "20191030-014640F/bundle/1/pg_data/PG_VERSION {s=2}\n"
+                "bundle/2/pg_data/block-dedup-1 {s=16384, m=0:{0,1}, ts=-6}\n"
+                "bundle/3/pg_data/block-dedup-2 {s=16384, m=0:{0,1}, ts=-5}\n"
+                "bundle/4/pg_data/block-dedup-3 {s=16384, m=0:{0,1}, ts=-4}\n"
+                "bundle/5/pg_data/block-dedup-4 {s=16384, m=0:{0,1}, ts=-3}\n"
+                "bundle/6/pg_data/block-dedup-5 {s=16384, m=0:{0,1}, ts=-2}\n"
+                "bundle/7/pg_data/block-dedup-6 {s=16384, m=0:{0,1}, ts=-1}\n"
+                "pg_data/backup_label {s=17, ts=+2}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
-        }
 
-        // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 11 full backup with block incr");
+            // Bundles with blocks found in a prior bundle only contain the block map
+            TEST_RESULT_UINT(storageInfoP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest/bundle/2")).size, 16403, "blocks");
+            TEST_RESULT_UINT(storageInfoP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest/bundle/4")).size, 19, "block map only");
+            TEST_RESULT_UINT(storageInfoP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest/bundle/6")).size, 19, "block map only");
+            TEST_RESULT_UINT(storageInfoP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest/bundle/7")).size, 19, "block map only");
 
-        backupTimeStart = BACKUP_EPOCH + 2800000;
+            TEST_RESULT_BOOL(
+                storagePathExistsP(storageTest, STRDEF("lock/test1-backup-block")), false, "block index map files removed");
 
-        // Block sizes for testing
-        #define BLOCK_MIN_SIZE                                      8192
-        #define BLOCK_MIN_FILE_SIZE                                 16384
-        #define BLOCK_MID_SIZE                                      16384
-        #define BLOCK_MID_FILE_SIZE                                 131072
-        #define BLOCK_MAX_SIZE                                      65536
-        #define BLOCK_MAX_FILE_SIZE                                 1507328
+            for (unsigned int fileIdx = 0; fileIdx < 6; fileIdx++)
+                HRN_STORAGE_REMOVE(storagePgWrite(), zNewFmt("block-dedup-%u", fileIdx + 1));
+        }
 
-        {
-            // Remove old pg data
-            HRN_STORAGE_PATH_REMOVE(storageTest, "pg1", .recurse = true);
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 full backup with block incr lsn");
 
-            // Update pg_control
-            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .pageChecksumVersion = 0, .walSegmentSize = 2 * 1024 * 1024);
+        backupTimeStart = BACKUP_EPOCH + 3160000;
 
-            // Update version
-            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_11_Z, .timeModified = backupTimeStart);
+        {
+            // Checksums are enabled so hint bit updates are WAL-logged and page lsns can be trusted
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .pageChecksumVersion = 1, .walSegmentSize = 2 * 1024 * 1024);
 
             // Load options
             StringList *argList = strLstNew();
@@ -3401,47 +6308,31 @@ testRun(void)
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
             hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
             hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
-            hrnCfgArgRawBool(argList, cfgOptResume, false);
+            hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
-            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
-            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "b=" STRINGIFY(BLOCK_MAX_SIZE) "b");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockLsn, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
-            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // File that uses block incr and will grow
-            Buffer *file = bufNew(BLOCK_MIN_SIZE * 3);
-            memset(bufPtr(file), 0, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-grow", file, .timeModified = backupTimeStart);
+            // Relation file with valid page headers
+            Buffer *relation = bufNew(BLOCK_MIN_FILE_SIZE);
+            bufUsedSet(relation, bufSize(relation));
 
-            // File that uses block incr and will not be resumed
-            file = bufNew(BLOCK_MIN_SIZE * 3);
-            memset(bufPtr(file), 0, bufSize(file));
-            bufUsedSet(file, bufSize(file));
+            testPageLsnPut(relation, BLOCK_MIN_SIZE, 0, 0x10, 0x11);
+            testPageLsnPut(relation, BLOCK_MIN_SIZE, 1, 0x10, 0x22);
 
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-no-resume", file, .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
 
-            // Error when pg_control is missing after backup start
-            HRN_BACKUP_SCRIPT_SET(
-                {.op = hrnBackupScriptOpRemove, .file = storagePathP(storagePg(), STRDEF("global/pg_control"))});
-            hrnBackupPqScriptP(
-                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true,
-                .errorAfterCopyStart = true);
-            TEST_ERROR(
-                hrnCmdBackup(), FileMissingError,
-                "raised from local-1 shim protocol: unable to open missing file '" TEST_PATH "/pg1/global/pg_control' for read");
+            // Visibility map with valid page headers
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3_vm", relation, .timeModified = backupTimeStart);
 
-            TEST_RESULT_LOG(
-                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DBF06000000000, lsn = 5dbf060/0\n"
-                "P00   INFO: check archive for segment 0000000105DBF06000000000\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-no-resume (24KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (24KB, [PCT]) checksum [SHA1]");
+            // Non-relation file that is not checked
+            Buffer *file = bufNew(BLOCK_MIN_FILE_SIZE);
+            memcpy(bufPtr(file), bufPtrConst(relation), bufUsed(relation));
+            bufUsedSet(file, bufSize(file));
 
-            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .pageChecksumVersion = 0, .walSegmentSize = 2 * 1024 * 1024);
+            HRN_STORAGE_PUT(storagePgWrite(), "block-lsn", file, .timeModified = backupTimeStart);
 
             // Run backup
             hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
@@ -3449,28 +6340,29 @@ testRun(void)
 
             TEST_RESULT_LOG(
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DBF06000000000, lsn = 5dbf060/0\n"
-                "P00   INFO: check archive for segment 0000000105DBF06000000000\n"
-                "P00   INFO: backup '20191103-165320F' cannot be resumed: partially deleted by prior resume or invalid\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-no-resume (24KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (24KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/8192, 2B, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: backup start archive = 0000000105DC484000000000, lsn = 5dc4840/0\n"
+                "P00   INFO: check archive for segment 0000000105DC484000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/0, 2B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/2, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-lsn (bundle 1/8194, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3_vm (bundle 1/24599, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (bundle 1/41005, 16KB, [PCT]) checksum [SHA1]\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105DBF06000000001, lsn = 5dbf060/300000\n"
+                "P00   INFO: backup stop archive = 0000000105DC484000000001, lsn = 5dc4840/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000000105DBF06000000000:0000000105DBF06000000001\n"
-                "P00   INFO: new backup label = 20191103-165320F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 5");
+                "P00   INFO: check archive for segment(s) 0000000105DC484000000000:0000000105DC484000000001\n"
+                "P00   INFO: new backup label = 20191107-205320F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 6");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191103-165320F}\n"
-                "bundle/1/pg_data/PG_VERSION {s=2}\n"
+                ".> {d=20191107-205320F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, ts=-360000}\n"
+                "bundle/1/pg_data/base/1/3 {s=16384, m=0:{0,1}}\n"
+                "bundle/1/pg_data/base/1/3_vm {s=16384, m=0:{0,1}}\n"
+                "bundle/1/pg_data/block-lsn {s=16384, m=0:{0,1}}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
                 "pg_data/backup_label {s=17, ts=+2}\n"
-                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}}\n"
-                "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -3478,143 +6370,95 @@ testRun(void)
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 11 full backup with block incr resume");
+        TEST_TITLE("online 11 diff backup with block incr lsn");
 
-        backupTimeStart = BACKUP_EPOCH + 2900000;
+        backupTimeStart = BACKUP_EPOCH + 3170000;
 
         {
+            // Checksums are disabled but wal_log_hints is enabled so page lsns can still be trusted
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .walLogHints = true, .walSegmentSize = 2 * 1024 * 1024);
+
             // Load options
             StringList *argList = strLstNew();
             hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
             hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
+            hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
-            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
-            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "b=" STRINGIFY(BLOCK_MAX_SIZE) "b");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockLsn, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
-            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Make this backup look resumable
-            HRN_STORAGE_REMOVE(storageTest, "repo/backup/test1/20191103-165320F/backup.manifest");
-
-            // Corrupt file that uses block incr and will not be resumed
-            Buffer *file = bufNew(BLOCK_MIN_SIZE * 3);
-            memset(bufPtr(file), 99, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storageRepoWrite(), "backup/test1/20191103-165320F/pg_data/block-incr-no-resume.pgbi", file);
-
-            // File that shrinks below the limit where it would get block incremental if it were new
-            file = bufNew(BLOCK_MIN_FILE_SIZE + 1);
-            memset(bufPtr(file), 55, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink", file, .timeModified = backupTimeStart);
-
-            // File that shrinks to the size of a single block
-            file = bufNew(BLOCK_MIN_FILE_SIZE);
-            memset(bufPtr(file), 44, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-block", file, .timeModified = backupTimeStart);
-
-            // File that shrinks below the size of a single block
-            file = bufNew(BLOCK_MIN_FILE_SIZE);
-            memset(bufPtr(file), 43, bufSize(file));
-            bufUsedSet(file, bufSize(file));
+            // Page 0 of the relation is unchanged and page 1 has an lsn after the start of the prior backup
+            Buffer *relation = bufNew(BLOCK_MIN_FILE_SIZE);
+            bufUsedSet(relation, bufSize(relation));
 
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-below", file, .timeModified = backupTimeStart);
+            testPageLsnPut(relation, BLOCK_MIN_SIZE, 0, 0x10, 0x11);
+            testPageLsnPut(relation, BLOCK_MIN_SIZE, 1, 0x7FFFFFFF00000000, 0x33);
 
-            // Block incremental file that remains the same between backups
-            file = bufNew(BLOCK_MIN_FILE_SIZE);
-            memset(bufPtr(file), 33, bufSize(file));
-            bufUsedSet(file, bufSize(file));
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
 
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-same", file, .timeModified = backupTimeStart);
+            // Page 0 of the visibility map changes without changing the lsn, as happens when visibilitymap_clear() clears bits, so
+            // the visibility map must not be lsn checked
+            Buffer *const visibilityMap = bufNew(BLOCK_MIN_FILE_SIZE);
+            bufUsedSet(visibilityMap, bufSize(visibilityMap));
 
-            // Normal file that remains the same between backups
-            HRN_STORAGE_PUT_Z(storagePgWrite(), "normal-same", "SAME", .timeModified = backupTimeStart);
+            testPageLsnPut(visibilityMap, BLOCK_MIN_SIZE, 0, 0x10, 0x44);
+            testPageLsnPut(visibilityMap, BLOCK_MIN_SIZE, 1, 0x10, 0x22);
 
-            // File that grows above the limit
-            file = bufNew(BLOCK_MIN_FILE_SIZE - 1);
-            memset(bufPtr(file), 77, bufSize(file));
-            bufUsedSet(file, bufSize(file));
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3_vm", visibilityMap, .timeModified = backupTimeStart);
 
-            HRN_STORAGE_PUT(storagePgWrite(), "grow-to-block-incr", file, .timeModified = backupTimeStart);
+            // The non-relation file changes so it is hashed
+            HRN_STORAGE_PUT(storagePgWrite(), "block-lsn", relation, .timeModified = backupTimeStart);
 
             // Run backup
             hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
             TEST_RESULT_LOG(
-                "P00   WARN: backup '20191103-165320F' missing manifest removed from backup.info\n"
+                "P00   INFO: last backup label = 20191107-205320F, version = " PROJECT_VERSION "\n"
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DC08C000000000, lsn = 5dc08c0/0\n"
-                "P00   INFO: check archive for segment 0000000105DC08C000000000\n"
-                "P00   WARN: resumable backup 20191103-165320F of same type exists -- invalid files will be removed then the backup"
-                " will resume\n"
-                "P00 DETAIL: remove path '" TEST_PATH "/repo/backup/test1/20191103-165320F/bundle' from resumed backup\n"
-                "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191103-165320F/pg_data/backup_label' from resumed"
-                " backup (missing in manifest)\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-no-resume (24KB, [PCT]) checksum [SHA1]\n"
-                "P00   WARN: resumed backup file pg_data/block-incr-no-resume did not have expected checksum"
-                " ebdd38b69cd5b9f2d00d273c981e16960fbbb4f7. The file was recopied and backup will continue but this may be an issue"
-                " unless the resumed backup path in the repository is known to be corrupted.\n"
-                "            NOTE: this does not indicate a problem with the PostgreSQL page checksums.\n"
-                "P01 DETAIL: checksum resumed file " TEST_PATH "/pg1/block-incr-grow (24KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/0, 2B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/normal-same (bundle 1/2, 4B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/grow-to-block-incr (bundle 1/6, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/16389, 8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-block (bundle 1/24581, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-below (bundle 1/40987, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink (bundle 1/57393, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-same (bundle 1/73807, 16KB, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: backup start archive = 0000000105DC4AB000000000, lsn = 5dc4ab0/0\n"
+                "P00   INFO: check archive for segment 0000000105DC4AB000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-lsn (bundle 1/8192, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3_vm (bundle 1/16413, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (bundle 1/24637, 16KB, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191107-205320F\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105DC08C000000001, lsn = 5dc08c0/300000\n"
+                "P00   INFO: backup stop archive = 0000000105DC4AB000000001, lsn = 5dc4ab0/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000000105DC08C000000000:0000000105DC08C000000001\n"
-                "P00   INFO: new backup label = 20191103-165320F\n"
-                "P00   INFO: full backup size = [SIZE], file total = 11");
+                "P00   INFO: check archive for segment(s) 0000000105DC4AB000000000:0000000105DC4AB000000001\n"
+                "P00   INFO: new backup label = 20191107-205320F_20191107-234000D\n"
+                "P00   INFO: diff backup size = [SIZE], file total = 6");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191103-165320F}\n"
-                "bundle/1/pg_data/PG_VERSION {s=2, ts=-100000}\n"
-                "bundle/1/pg_data/block-incr-same {s=16384, m=0:{0,1}}\n"
-                "bundle/1/pg_data/block-incr-shrink {s=16385, m=0:{0,1,2}}\n"
-                "bundle/1/pg_data/block-incr-shrink-below {s=16384, m=0:{0,1}}\n"
-                "bundle/1/pg_data/block-incr-shrink-block {s=16384, m=0:{0,1}}\n"
+                ".> {d=20191107-205320F_20191107-234000D}\n"
+                "bundle/1/pg_data/base/1/3 {s=16384, m=0:{0},1:{0}}\n"
+                "bundle/1/pg_data/base/1/3_vm {s=16384, m=1:{0},0:{1}}\n"
+                "bundle/1/pg_data/block-lsn {s=16384, m=0:{0},1:{0}}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "bundle/1/pg_data/grow-to-block-incr {s=16383}\n"
-                "bundle/1/pg_data/normal-same {s=4}\n"
                 "pg_data/backup_label {s=17, ts=+2}\n"
-                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}, ts=-100000}\n"
-                "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}, ts=-100000}\n"
+                "20191107-205320F/bundle/1/pg_data/PG_VERSION {s=2, ts=-370000}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
-
-            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-no-resume");
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("online 11 diff backup with block incr");
+        TEST_TITLE("online 11 incr backup with block incr lsn when hint bits are not WAL-logged");
 
-        backupTimeStart = BACKUP_EPOCH + 3000000;
+        backupTimeStart = BACKUP_EPOCH + 3180000;
 
         {
-            // Load the previous manifest and null out the checksum-page option to be sure it gets set to false in this backup
-            const String *manifestPriorFile = STRDEF(STORAGE_REPO_BACKUP "/20191103-165320F/" BACKUP_MANIFEST_FILE);
-            Manifest *manifestPrior = manifestNewLoad(storageReadIo(storageNewReadP(storageRepo(), manifestPriorFile)));
-            manifestPrior->pub.data.backupOptionChecksumPage = NULL;
-            manifestSave(manifestPrior, storageWriteIo(storageNewWriteP(storageRepoWrite(), manifestPriorFile)));
+            // Neither checksums nor wal_log_hints are enabled so hint bit updates do not change the page lsn
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .walSegmentSize = 2 * 1024 * 1024);
 
             // Load options
             StringList *argList = strLstNew();
@@ -3622,128 +6466,65 @@ testRun(void)
             hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
             hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
             hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
-            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
             hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
+            hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
-            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "23kB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
-            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "=" STRINGIFY(BLOCK_MAX_SIZE));
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockLsn, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
-            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
-            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeSuper, "1MiB");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
-            // Grow file size to check block incr delta. This is large enough that it would get a new block size if it were a new
-            // file rather than a delta. Also split the first super block.
-            Buffer *file = bufNew(BLOCK_MID_FILE_SIZE);
-            memset(bufPtr(file), 0, bufSize(file));
-            memset(bufPtr(file) + BLOCK_MIN_SIZE, 1, BLOCK_MIN_SIZE);
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-grow", file, .timeModified = backupTimeStart);
-
-            // File that gets a larger block size and multiple super blocks
-            file = bufNew(BLOCK_MAX_FILE_SIZE);
-            memset(bufPtr(file), 0, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-larger", file, .timeModified = backupTimeStart);
-
-            // Shrink file below the limit where it would get block incremental if it were new
-            file = bufNew(BLOCK_MIN_FILE_SIZE - 1);
-            memset(bufPtr(file), 55, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink", file, .timeModified = backupTimeStart);
-
-            // Shrink file to the size of a single block
-            file = bufNew(BLOCK_MIN_SIZE);
-            memset(bufPtr(file), 44, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-block", file, .timeModified = backupTimeStart);
-
-            // Shrinks file below the size of a single block
-            file = bufNew(8);
-            memset(bufPtr(file), 44, bufSize(file));
-            bufUsedSet(file, bufSize(file));
-
-            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-shrink-below", file, .timeModified = backupTimeStart);
-
-            // Update timestamps without changing contents of the files
-            HRN_STORAGE_TIME(storagePgWrite(), "block-incr-same", backupTimeStart);
-            HRN_STORAGE_TIME(storagePgWrite(), "normal-same", backupTimeStart);
-
-            // Grow file above the limit
-            file = bufNew(BLOCK_MIN_FILE_SIZE + 1);
-            memset(bufPtr(file), 77, bufSize(file));
-            bufUsedSet(file, bufSize(file));
+            // Page 0 of the relation has a hint bit set without changing the lsn. The changed page must be stored or the backup will
+            // not match the manifest checksum when the file is rebuilt from the block map during validation.
+            Buffer *relation = bufNew(BLOCK_MIN_FILE_SIZE);
+            bufUsedSet(relation, bufSize(relation));
 
-            HRN_STORAGE_PUT(storagePgWrite(), "grow-to-block-incr", file, .timeModified = backupTimeStart);
+            testPageLsnPut(relation, BLOCK_MIN_SIZE, 0, 0x10, 0x11);
+            testPageLsnPut(relation, BLOCK_MIN_SIZE, 1, 0x7FFFFFFF00000000, 0x33);
+            bufPtr(relation)[BLOCK_MIN_SIZE / 2] = 0x13;
 
-            // File that gets truncated to zero during the backup
-            HRN_STORAGE_PUT(storagePgWrite(), "truncate-to-zero", BUFSTRDEF("DATA"), .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
 
             // Run backup
-            HRN_BACKUP_SCRIPT_SET(
-                {.op = hrnBackupScriptOpUpdate, .file = storagePathP(storagePg(), STRDEF("truncate-to-zero")),
-                 .time = backupTimeStart + 1});
             hrnBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2, .walSwitch = true);
             TEST_RESULT_VOID(hrnCmdBackup(), "backup");
 
             TEST_RESULT_LOG(
-                "P00   INFO: last backup label = 20191103-165320F, version = " PROJECT_VERSION "\n"
+                "P00   WARN: repo1-block-lsn option requires checksums or wal_log_hints to be enabled on the cluster, resetting to"
+                " false\n"
+                "P00   INFO: last backup label = 20191107-205320F_20191107-234000D, version = " PROJECT_VERSION "\n"
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
-                "P00   INFO: backup start archive = 0000000105DC213000000000, lsn = 5dc2130/0\n"
-                "P00   INFO: check archive for segment 0000000105DC213000000000\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-larger (1.4MB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (128KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: store truncated file " TEST_PATH "/pg1/truncate-to-zero (4B->0B, [PCT])\n"
-                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/normal-same (4B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/grow-to-block-incr (bundle 1/0, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/16411, 8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-block (bundle 1/24603, 8KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink-below (bundle 1/24620, 8B, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-shrink (bundle 1/24628, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/block-incr-same (16KB, [PCT]) checksum [SHA1]\n"
-                "P00 DETAIL: reference pg_data/PG_VERSION to 20191103-165320F\n"
-                "P00 DETAIL: reference pg_data/block-incr-same to 20191103-165320F\n"
-                "P00 DETAIL: reference pg_data/normal-same to 20191103-165320F\n"
+                "P00   INFO: backup start archive = 0000000105DC4D2000000000, lsn = 5dc4d20/0\n"
+                "P00   INFO: check archive for segment 0000000105DC4D2000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (bundle 1/8192, 16KB, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191107-205320F\n"
+                "P00 DETAIL: reference pg_data/base/1/3_vm to 20191107-205320F_20191107-234000D\n"
+                "P00 DETAIL: reference pg_data/block-lsn to 20191107-205320F_20191107-234000D\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
-                "P00   INFO: backup stop archive = 0000000105DC213000000001, lsn = 5dc2130/300000\n"
+                "P00   INFO: backup stop archive = 0000000105DC4D2000000001, lsn = 5dc4d20/300000\n"
                 "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
-                "P00   INFO: check archive for segment(s) 0000000105DC213000000000:0000000105DC213000000001\n"
-                "P00   INFO: new backup label = 20191103-165320F_20191106-002640D\n"
-                "P00   INFO: diff backup size = [SIZE], file total = 12");
+                "P00   INFO: check archive for segment(s) 0000000105DC4D2000000000:0000000105DC4D2000000001\n"
+                "P00   INFO: new backup label = 20191107-205320F_20191108-022640I\n"
+                "P00   INFO: incr backup size = [SIZE], file total = 6");
 
             TEST_RESULT_STR_Z(
                 testBackupValidateP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
-                ".> {d=20191103-165320F_20191106-002640D}\n"
-                "bundle/1/pg_data/block-incr-shrink {s=16383, m=0:{0},1:{0}}\n"
-                "bundle/1/pg_data/block-incr-shrink-below {s=8}\n"
-                "bundle/1/pg_data/block-incr-shrink-block {s=8192, m=0:{0}}\n"
+                ".> {d=20191107-205320F_20191108-022640I}\n"
+                "bundle/1/pg_data/base/1/3 {s=16384, m=2:{0},1:{0}}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "bundle/1/pg_data/grow-to-block-incr {s=16385, m=1:{0,1,2}}\n"
                 "pg_data/backup_label {s=17, ts=+2}\n"
-                "pg_data/block-incr-grow.pgbi {s=131072, m=0:{0},1:{0},0:{2},1:{1,2,3,4,5,6,7,8,9,10,11,12,13}}\n"
-                "pg_data/block-incr-larger.pgbi {s=1507328, m=1:{0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15},1:{0,1,2,3,4,5,6}}\n"
-                "20191103-165320F/bundle/1/pg_data/PG_VERSION {s=2, ts=-200000}\n"
-                "20191103-165320F/bundle/1/pg_data/block-incr-same {s=16384, m=0:{0,1}}\n"
-                "20191103-165320F/bundle/1/pg_data/normal-same {s=4}\n"
+                "20191107-205320F/bundle/1/pg_data/PG_VERSION {s=2, ts=-380000}\n"
+                "20191107-205320F_20191107-234000D/bundle/1/pg_data/base/1/3_vm {s=16384, m=1:{0},0:{1}, ts=-10000}\n"
+                "20191107-205320F_20191107-234000D/bundle/1/pg_data/block-lsn {s=16384, m=0:{0},1:{0}, ts=-10000}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
 
-            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-grow");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-larger");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-same");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-shrink");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-shrink-below");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "block-incr-shrink-block");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "grow-to-block-incr");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "normal-same");
-            HRN_STORAGE_REMOVE(storagePgWrite(), "truncate-to-zero");
+            HRN_STORAGE_PATH_REMOVE(storagePgWrite(), PG_PATH_BASE, .recurse = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "block-lsn");
         }
 
         // It is better to put as few tests here as possible because cmp/enc makes tests more expensive (especially with valgrind)
@@ -3829,8 +6610,8 @@ testRun(void)
                 "bundle/1/pg_data/PG_VERSION {s=2, ts=-400000}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
                 "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}}\n"
-                "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}}\n"
+                "pg_data/block-incr-grow.pgbi {s=24576, m=z,z,z}\n"
+                "pg_data/block-incr-no-resume.pgbi {s=24576, m=z,z,z}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -3864,6 +6645,7 @@ testRun(void)
 
             // Make this backup look resumable
             HRN_STORAGE_REMOVE(storageTest, "repo/backup/test1/20191108-080000F/backup.manifest");
+            HRN_STORAGE_REMOVE(storageTest, "repo/backup/test1/20191108-080000F/backup.manifest.pack");
 
             // File that will later have a timestamp far enough in the past to make the block size zero
             Buffer *file = bufNew((size_t)(BLOCK_MIN_FILE_SIZE));
@@ -3915,9 +6697,9 @@ testRun(void)
                 "bundle/1/pg_data/PG_VERSION {s=2, ts=-500000}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
                 "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}, ts=-100000}\n"
+                "pg_data/block-incr-grow.pgbi {s=24576, m=z,z,z, ts=-100000}\n"
                 "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}, ts=-100000}\n"
-                "pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}}\n"
+                "pg_data/block-incr-wayback.pgbi {s=16384, m=z,z}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -3943,6 +6725,7 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "4MiB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockDedup, true);
             hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
             hrnCfgArgRawZ(argList, cfgOptRepoBlockAgeMap, "1=2");
             hrnCfgArgRawZ(argList, cfgOptRepoBlockAgeMap, "2=0");
@@ -3993,9 +6776,9 @@ testRun(void)
                 "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (bundle 1/0, 48KB, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/block-incr-wayback (16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-to-zero (bundle 1/128, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-multiplier (bundle 1/184, 32KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/312, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-to-zero (bundle 1/80, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-multiplier (bundle 1/136, 32KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/160, 8KB, [PCT]) checksum [SHA1]\n"
                 "P00 DETAIL: reference pg_data/PG_VERSION to 20191108-080000F\n"
                 "P00 DETAIL: reference pg_data/block-incr-wayback to 20191108-080000F\n"
                 "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
@@ -4010,17 +6793,20 @@ testRun(void)
                     storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
                     .cipherPass = TEST_CIPHER_PASS),
                 ".> {d=20191108-080000F_20191110-153320D}\n"
-                "bundle/1/pg_data/block-age-multiplier {s=32768, m=1:{0,1}, ts=-86400}\n"
+                "bundle/1/pg_data/block-age-multiplier {s=32768, m=z,z, ts=-86400}\n"
                 "bundle/1/pg_data/block-age-to-zero {s=16384, ts=-172800}\n"
-                "bundle/1/pg_data/block-incr-grow {s=49152, m=0:{0,1},1:{0,1,2,3}, ts=-200000}\n"
+                "bundle/1/pg_data/block-incr-grow {s=49152, m=z,z,1:{0},z,z,z, ts=-200000}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
                 "pg_data/backup_label.gz {s=17, ts=+2}\n"
                 "20191108-080000F/bundle/1/pg_data/PG_VERSION {s=2, ts=-600000}\n"
-                "20191108-080000F/pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}, ts=-172800}\n"
+                "20191108-080000F/pg_data/block-incr-wayback.pgbi {s=16384, m=z,z, ts=-172800}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
+
+            TEST_RESULT_BOOL(
+                storageExistsP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest/" BLOCK_INDEX_FILE)), true, "block index exists");
         }
 
         // Ensure that disabling bundling does not break the backup. In particular this ensures the bundleRaw setting is preserved.
@@ -4050,7 +6836,8 @@ testRun(void)
 
             TEST_RESULT_LOG(
                 "P00   INFO: last backup label = 20191108-080000F_20191110-153320D, version = " PROJECT_VERSION "\n"
-                "P00   WARN: incr backup cannot alter compress-type option to 'bz2', reset to value in 20191108-080000F_20191110-153320D\n"
+                "P00   WARN: incr backup cannot alter compress-type option to 'bz2', reset to value in"
+                " 20191108-080000F_20191110-153320D\n"
                 "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
                 "P00   INFO: backup start archive = 0000000105DC8F1000000000, lsn = 5dc8f10/0\n"
                 "P00   INFO: check archive for prior segment 0000000105DC8F0F000007FF\n"
@@ -4075,10 +6862,10 @@ testRun(void)
                 "pg_data/backup_label.gz {s=17, ts=+2}\n"
                 "pg_data/global/pg_control.gz {s=8192}\n"
                 "20191108-080000F/bundle/1/pg_data/PG_VERSION {s=2, ts=-650000}\n"
-                "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-age-multiplier {s=32768, m=1:{0,1}, ts=-136400}\n"
+                "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-age-multiplier {s=32768, m=z,z, ts=-136400}\n"
                 "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-age-to-zero {s=16384, ts=-222800}\n"
-                "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-incr-grow {s=49152, m=0:{0,1},1:{0,1,2,3}, ts=-250000}\n"
-                "20191108-080000F/pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}, ts=-222800}\n"
+                "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-incr-grow {s=49152, m=z,z,1:{0},z,z,z, ts=-250000}\n"
+                "20191108-080000F/pg_data/block-incr-wayback.pgbi {s=16384, m=z,z, ts=-222800}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -4112,6 +6899,7 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "8KiB");
             hrnCfgArgRawZ(argList, cfgOptCompressType, "none");
+            hrnCfgArgRawBool(argList, cfgOptCompressAdaptive, true);
             hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
             hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
             HRN_CFG_LOAD(cfgCmdBackup, argList);
@@ -4172,6 +6960,120 @@ testRun(void)
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
         }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 full backup with bundles and adaptive compression");
+
+        backupTimeStart = BACKUP_EPOCH + 3600000;
+
+        {
+            // Remove old pg data
+            HRN_STORAGE_PATH_REMOVE(storageTest, "pg1", .recurse = true);
+
+            // Update pg_control
+            HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_11, .walSegmentSize = 2 * 1024 * 1024);
+
+            // Update version
+            HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, PG_VERSION_11_Z, .timeModified = backupTimeStart);
+
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "32KiB");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, "24576=8192");
+            hrnCfgArgRawBool(argList, cfgOptCompressAdaptive, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
+            hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Compressible file
+            Buffer *const compressible = bufNew(pgPageSize8 * 2);
+            memset(bufPtr(compressible), 0, bufSize(compressible));
+            bufUsedSet(compressible, bufSize(compressible));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "compressible.dat", compressible, .timeModified = backupTimeStart);
+
+            // Incompressible file
+            Buffer *const incompressible = bufNew(pgPageSize8 * 3);
+            uint32_t seed = 0x12345678;
+
+            for (size_t byteIdx = 0; byteIdx < bufSize(incompressible); byteIdx++)
+            {
+                seed = seed * 1103515245 + 12345;
+                bufPtr(incompressible)[byteIdx] = (unsigned char)(seed >> 24);
+            }
+
+            bufUsedSet(incompressible, pgPageSize8 * 2);
+
+            HRN_STORAGE_PUT(storagePgWrite(), "incompressible.dat", incompressible, .timeModified = backupTimeStart);
+
+            // Incompressible file stored with block incremental is compressed anyway
+            bufUsedSet(incompressible, pgPageSize8 * 3);
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr.dat", incompressible, .timeModified = backupTimeStart);
+
+            // File too large to bundle does not use adaptive compression
+            Buffer *const large = bufNew(pgPageSize8 * 5);
+            memset(bufPtr(large), 0, bufSize(large));
+            bufUsedSet(large, bufSize(large));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "large.dat", large, .timeModified = backupTimeStart);
+
+            // Files removed and truncated during the backup
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "removed.dat", "REMOVED", .timeModified = backupTimeStart);
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "truncated.dat", "TRUNCATED", .timeModified = backupTimeStart);
+
+            // Run backup
+            HRN_BACKUP_SCRIPT_SET(
+                {.op = hrnBackupScriptOpRemove, .file = storagePathP(storagePg(), STRDEF("removed.dat"))},
+                {.op = hrnBackupScriptOpUpdate, .file = storagePathP(storagePg(), STRDEF("truncated.dat")),
+                 .time = backupTimeStart, .content = BUFSTRDEF("")});
+            hrnBackupPqScriptP(
+                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .cipherType = cipherTypeAes256Cbc,
+                .cipherPass = TEST_CIPHER_PASS, .walTotal = 2, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DCB3B000000000, lsn = 5dcb3b0/0\n"
+                "P00   INFO: check archive for segment 0000000105DCB3B000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/large.dat (40KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: store truncated file " TEST_PATH "/pg1/truncated.dat (9B->0B, [PCT])\n"
+                "P01 DETAIL: skip file removed by database " TEST_PATH "/pg1/removed.dat\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/incompressible.dat (bundle 1/0, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/16408, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/compressible.dat (bundle 1/16512, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr.dat (bundle 1/16568, 24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/41208, 2B, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DCB3B000000001, lsn = 5dcb3b0/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DCB3B000000000:0000000105DCB3B000000001\n"
+                "P00   INFO: new backup label = 20191112-230640F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 8");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(
+                    storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
+                    .cipherPass = TEST_CIPHER_PASS),
+                ".> {d=20191112-230640F}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, cmp=f}\n"
+                "bundle/1/pg_data/block-incr.dat {s=24576, m=0:{0,1,2}}\n"
+                "bundle/1/pg_data/compressible.dat {s=16384}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "bundle/1/pg_data/incompressible.dat {s=16384, cmp=f}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/large.dat.pgbi {s=40960, m=z,z,z,z,z}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+        }
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -224,6 +224,8 @@ testRun(void)
             "\n"
             "Command Options:\n"
             "\n"
+            "  --allocate                          allocation of restored files\n"
+            "                                      [default=normal]\n"
             "  --archive-mode                      preserve or disable archiving on restored\n"
             "                                      cluster [default=preserve]\n"
             "  --db-exclude                        restore excluding the specified databases\n"
@@ -233,6 +235,8 @@ testRun(void)
             "  --link-all                          restore all symlinks [default=n]\n"
             "  --link-map                          modify the destination of a symlink\n"
             "                                      [current=/link1=/dest1, /link2=/dest2]\n"
+            "  --read-gap-max                      largest gap in a repository file to read\n"
+            "                                      through [default=1MiB]\n"
             "  --recovery-option                   set an option in postgresql.auto.conf or\n"
             "                                      recovery.conf\n"
             "  --set                               backup set to restore [default=latest]\n"
@@ -269,14 +273,20 @@ testRun(void)
             "  --lock-path                         path where lock files are stored\n"
             "                                      [default=/tmp/pgbackrest]\n"
             "  --neutral-umask                     use a neutral umask [default=y]\n"
+            "  --page-cache-drop                   drop PostgreSQL files from the page cache\n"
+            "                                      after they are read [default=n]\n"
             "  --process-max                       max processes to use for\n"
             "                                      compress/transfer [default=1]\n"
             "  --protocol-timeout                  protocol timeout [default=31m]\n"
+            "  --read-ahead                        buffers to read ahead from Posix storage\n"
+            "                                      [default=0]\n"
             "  --sck-keep-alive                    keep-alive enable [default=y]\n"
             "  --stanza                            defines the stanza\n"
             "  --tcp-keep-alive-count              keep-alive count\n"
             "  --tcp-keep-alive-idle               keep-alive idle time\n"
             "  --tcp-keep-alive-interval           keep-alive interval time\n"
+            "  --write-queue                       writes to queue on Posix storage\n"
+            "                                      [default=0]\n"
             "\n"
             "Log Options:\n"
             "\n"
@@ -357,9 +367,13 @@ testRun(void)
             "  --repo-sftp-public-key-file         SFTP public key file\n"
             "  --repo-storage-ca-file              repository storage CA file\n"
             "  --repo-storage-ca-path              repository storage CA path\n"
+            "  --repo-storage-download-chunk-max   maximum concurrent chunk downloads per\n"
+            "                                      file\n"
+            "  --repo-storage-download-chunk-size  repository storage download chunk size\n"
             "  --repo-storage-host                 repository storage host\n"
             "  --repo-storage-port                 repository storage port\n"
             "  --repo-storage-tag                  repository storage tag(s)\n"
+            "  --repo-storage-upload-chunk-max     maximum concurrent chunk uploads per file\n"
             "  --repo-storage-upload-chunk-size    repository storage upload chunk size\n"
             "                                      [default=4194304]\n"
             "  --repo-storage-verify-tls           repository storage certificate verify\n"
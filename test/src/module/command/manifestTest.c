@@ -133,7 +133,7 @@ testRun(void)
             TEST_RESULT_VOID(hrnCmdBackup(), "backup repo1");
 
             // Munge the pg_control checksum since it will vary by architecture
-            Manifest *manifest = manifestLoadFile(
+            Manifest *manifest = manifestLoadFileP(
                 storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/20191002-070640F_20191003-105320D/" BACKUP_MANIFEST_FILE),
                 cipherTypeNone, NULL);
 
@@ -147,6 +147,12 @@ testRun(void)
                     storageNewWriteP(
                         storageRepoWrite(),
                         STRDEF(STORAGE_REPO_BACKUP "/20191002-070640F_20191003-105320D/" BACKUP_MANIFEST_FILE))));
+            manifestSavePack(
+                manifest,
+                storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoWrite(),
+                        STRDEF(STORAGE_REPO_BACKUP "/20191002-070640F_20191003-105320D/" BACKUP_MANIFEST_PACK_FILE))));
 
             // Backup to repo2
             hrnCfgArgRawZ(argList, cfgOptRepo, "2");
@@ -179,13 +185,12 @@ testRun(void)
                 "\n"
                 "file list:\n"
                 "  - pg_data/base/1/2\n"
-                "      size: 64KB, repo 64.1KB\n"
+                "      size: 64KB, repo 4B\n"
                 "      checksum: 1adc95bebe9eea8c112d40cd04ab7a8d75c4f961\n"
                 "      bundle: 1\n"
-                "      block: size 8KB, map size 58B, checksum size 6B\n"
+                "      block: size 8KB, map size 4B, checksum size 6B\n"
                 "      block delta:\n"
-                "        reference: 20191002-070640F/bundle/1, read: 1/64KB, superBlock: 2/64KB, block: 8/64KB\n"
-                "        total read: 1/64KB, superBlock: 2/64KB, block: 8/64KB\n",
+                "        total read: 0/0B, superBlock: 0/0B, block: 0/0B\n",
                 "repo 1 text");
 
             hrnCfgArgRawZ(argList, cfgOptOutput, "json");
@@ -218,7 +223,7 @@ testRun(void)
                             "\"size\":65536,"
                             "\"checksum\":\"1adc95bebe9eea8c112d40cd04ab7a8d75c4f961\","
                             "\"repo\":{"
-                                "\"size\":65594"
+                                "\"size\":4"
                             "},"
                             "\"bundle\":{"
                                 "\"id\":1,"
@@ -227,23 +232,8 @@ testRun(void)
                             "\"block\":{"
                                 "\"size\":8192,"
                                 "\"map\":{"
-                                    "\"size\":58,"
-                                    "\"delta\":["
-                                        "{"
-                                            "\"reference\":0,"
-                                            "\"read\":{"
-                                                "\"total\":1,"
-                                                "\"size\":65536"
-                                            "},"
-                                            "\"superBlock\":{"
-                                                "\"total\":2,"
-                                                "\"size\":65536"
-                                            "},"
-                                            "\"block\":{"
-                                                "\"total\":8"
-                                            "}"
-                                        "}"
-                                    "]"
+                                    "\"size\":4,"
+                                    "\"delta\":[]"
                                 "},"
                                 "\"checksum\":{"
                                     "\"size\":6"
@@ -274,10 +264,10 @@ testRun(void)
                 "\n"
                 "file list:\n"
                 "  - pg_data/base/1/2\n"
-                "      size: 96KB, repo 64.1KB\n"
+                "      size: 96KB, repo 32KB\n"
                 "      checksum: d4976e362696a43fb09e7d4e780d7d9352a2ec2e\n"
                 "      bundle: 1\n"
-                "      block: size 8KB, map size 99B, checksum size 6B\n"
+                "      block: size 8KB, map size 38B, checksum size 6B\n"
                 "\n"
                 "  - pg_data/base/PG_VERSION\n"
                 "      reference: 20191002-070640F\n"
@@ -379,10 +369,10 @@ testRun(void)
                 "\n"
                 "file list:\n"
                 "  - pg_data/base/1/2\n"
-                "      size: 96KB, repo 64.1KB\n"
+                "      size: 96KB, repo 32KB\n"
                 "      checksum: d4976e362696a43fb09e7d4e780d7d9352a2ec2e\n"
                 "      bundle: 1\n"
-                "      block: size 8KB, map size 99B, checksum size 6B\n"
+                "      block: size 8KB, map size 38B, checksum size 6B\n"
                 "\n"
                 "  - pg_data/global/pg_control\n"
                 "      size: 8KB, repo 8KB\n"
@@ -420,7 +410,7 @@ testRun(void)
                             "\"size\":98304,"
                             "\"checksum\":\"d4976e362696a43fb09e7d4e780d7d9352a2ec2e\","
                             "\"repo\":{"
-                                "\"size\":65635"
+                                "\"size\":32806"
                             "},"
                             "\"bundle\":{"
                                 "\"id\":1,"
@@ -429,7 +419,7 @@ testRun(void)
                             "\"block\":{"
                                 "\"size\":8192,"
                                 "\"map\":{"
-                                    "\"size\":99"
+                                    "\"size\":38"
                                 "},"
                                 "\"checksum\":{"
                                     "\"size\":6"
@@ -473,14 +463,13 @@ testRun(void)
                 "\n"
                 "file list:\n"
                 "  - pg_data/base/1/2\n"
-                "      size: 96KB, repo 64.1KB\n"
+                "      size: 96KB, repo 32KB\n"
                 "      checksum: d4976e362696a43fb09e7d4e780d7d9352a2ec2e\n"
                 "      bundle: 1\n"
-                "      block: size 8KB, map size 99B, checksum size 6B\n"
+                "      block: size 8KB, map size 38B, checksum size 6B\n"
                 "      block delta:\n"
-                "        reference: 20191002-070640F/bundle/1, read: 1/64KB, superBlock: 2/64KB, block: 4/32KB\n"
-                "        reference: 20191002-070640F_20191003-105320D/bundle/1, read: 1/64KB, superBlock: 1/64KB, block: 8/64KB\n"
-                "        total read: 2/128KB, superBlock: 3/128KB, block: 12/96KB\n",
+                "        reference: 20191002-070640F_20191003-105320D/bundle/1, read: 1/32KB, superBlock: 1/32KB, block: 4/32KB\n"
+                "        total read: 1/32KB, superBlock: 1/32KB, block: 4/32KB\n",
                 "repo 1 text");
 
             // ---------------------------------------------------------------------------------------------------------------------
@@ -503,10 +492,10 @@ testRun(void)
                 "\n"
                 "file list:\n"
                 "  - pg_data/base/1/2\n"
-                "      size: 96KB, repo 64.1KB\n"
+                "      size: 96KB, repo 32.1KB\n"
                 "      checksum: d4976e362696a43fb09e7d4e780d7d9352a2ec2e\n"
                 "      bundle: 1\n"
-                "      block: size 8KB, map size 104B, checksum size 6B\n"
+                "      block: size 8KB, map size 56B, checksum size 6B\n"
                 "      block delta: file is up-to-date\n",
                 "repo 2 test");
 
@@ -541,7 +530,7 @@ testRun(void)
                             "\"size\":98304,"
                             "\"checksum\":\"d4976e362696a43fb09e7d4e780d7d9352a2ec2e\","
                             "\"repo\":{"
-                                "\"size\":65664"
+                                "\"size\":32848"
                             "},"
                             "\"bundle\":{"
                                 "\"id\":1,"
@@ -550,7 +539,7 @@ testRun(void)
                             "\"block\":{"
                                 "\"size\":8192,"
                                 "\"map\":{"
-                                    "\"size\":104,"
+                                    "\"size\":56,"
                                     "\"delta\":null"
                                 "},"
                                 "\"checksum\":{"
@@ -388,6 +388,13 @@ testRun(void)
             "[backrest]\n"
             "backrest-checksum=\"31706010d1aa7e850191b4de9e76dc1ed13fb855\"\n");
 
+        // The text manifest cannot be loaded with a small buffer
+        Buffer *const manifestPackBuffer = bufNew(0);
+
+        ioBufferSizeSet(oldBufferSize);
+        manifestSavePack(manifestNewLoad(ioBufferReadNew(manifestFileBuffer)), ioBufferWriteNew(manifestPackBuffer));
+        ioBufferSizeSet(8);
+
         const Buffer *backupLabelBuffer = BUFSTRDEF("BACKUP-LABEL");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -530,6 +537,18 @@ testRun(void)
 
         TEST_RESULT_VOID(storagePutProcess(ioBufferReadNew(manifestFileBuffer)), "put");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("put encrypted backup.manifest.pack");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawStrId(argList, cfgOptRepoCipherType, cipherTypeAes256Cbc);
+        hrnCfgArgRawZ(argList, cfgOptCipherPass, "custom");
+        strLstAddZ(argList, STORAGE_PATH_BACKUP "/test/latest/" BACKUP_MANIFEST_PACK_FILE);
+        HRN_CFG_LOAD(cfgCmdRepoPut, argList);
+
+        TEST_RESULT_VOID(storagePutProcess(ioBufferReadNew(manifestPackBuffer)), "put");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("put encrypted backup.history manifest");
 
@@ -788,6 +807,19 @@ testRun(void)
         TEST_RESULT_INT(storageGetProcess(ioBufferWriteNew(writeBuffer)), 0, "get");
         TEST_RESULT_BOOL(bufEq(writeBuffer, manifestFileBuffer), true, "get matches put");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("get encrypted backup.manifest.pack");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawStrId(argList, cfgOptRepoCipherType, cipherTypeAes256Cbc);
+        strLstAddZ(argList, STORAGE_PATH_BACKUP "/test/latest/" BACKUP_MANIFEST_PACK_FILE);
+        HRN_CFG_LOAD(cfgCmdRepoGet, argList);
+
+        writeBuffer = bufNew(0);
+        TEST_RESULT_INT(storageGetProcess(ioBufferWriteNew(writeBuffer)), 0, "get");
+        TEST_RESULT_BOOL(bufEq(writeBuffer, manifestPackBuffer), true, "get matches put");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("get encrypted backup.history manifest");
 
@@ -222,7 +222,8 @@ testRun(void)
         IoWrite *write = ioBufferWriteNew(destination);
 
         ioFilterGroupAdd(
-            ioWriteFilterGroup(write), blockIncrNew(6, 3, 5, 0, 0, 0, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
+            ioWriteFilterGroup(write),
+            blockIncrNew(6, 3, 5, false, 0, 0, 0, NULL, 0, 0, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
         ioWriteOpen(write);
         ioWrite(write, source);
         ioWriteClose(write);
@@ -233,7 +234,7 @@ testRun(void)
             ioBufferReadNewOpen(BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize)), 3, 5);
 
         // Perform block delta
-        BlockDelta *blockDelta = blockDeltaNew(blockMap, 3, 5, NULL, cipherTypeNone, NULL, compressTypeGz);
+        BlockDelta *blockDelta = blockDeltaNew(blockMap, 3, 5, NULL, cipherTypeNone, NULL, compressTypeGz, 0);
         const BlockDeltaRead *blockDeltaRead = blockDeltaReadGet(blockDelta, 0);
         IoRead *read = ioBufferReadNewOpen(destination);
 
@@ -262,6 +263,143 @@ testRun(void)
             "    block {no: 0, offset: 6}\n"
             "    block {no: 1, offset: 9}\n",
             "check delta");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("variable size blocks are skipped when not required");
+
+        // Write full block incremental with content-defined chunking
+        Buffer *const repoFull = bufNew(256);
+        Buffer *const repoIncr = bufNew(256);
+        const Buffer *const repoList[2] = {repoFull, repoIncr};
+        write = ioBufferWriteNew(repoFull);
+
+        ioFilterGroupAdd(
+            ioWriteFilterGroup(write),
+            blockIncrNew(16, 3, 8, true, 0, 0, 0, NULL, 0, 0, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
+        ioWriteOpen(write);
+        ioWrite(write, BUFSTRDEF("ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+        ioWriteClose(write);
+
+        mapSize = pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE));
+        const Buffer *map = BUF(bufPtr(repoFull) + (bufUsed(repoFull) - (size_t)mapSize), (size_t)mapSize);
+
+        // Write incremental that only requires some blocks from the full
+        write = ioBufferWriteNew(repoIncr);
+
+        ioFilterGroupAdd(
+            ioWriteFilterGroup(write),
+            blockIncrNew(16, 3, 8, true, 1, 0, 0, map, 0, 0, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
+        ioWriteOpen(write);
+        ioWrite(write, BUFSTRDEF("AB!!!!!!!!FGHIJKLMNO!!!!!!!!!!!!UVWXYZ"));
+        ioWriteClose(write);
+
+        mapSize = pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE));
+        map = BUF(bufPtr(repoIncr) + (bufUsed(repoIncr) - (size_t)mapSize), (size_t)mapSize);
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 1, bundleId: 0, offset: 0, size: 28}\n"
+            "  super block {max: 18, size: 14}\n"
+            "    block {no: 0, offset: 1, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 4, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 7, blockOffset: 6, size: 3}\n"
+            "    block {no: 3, offset: 19, blockOffset: 9, size: 3}\n"
+            "    block {no: 4, offset: 22, blockOffset: 12, size: 3}\n"
+            "    block {no: 5, offset: 25, blockOffset: 15, size: 3}\n"
+            "  super block {max: 6, size: 14}\n"
+            "    block {no: 0, offset: 28, blockOffset: 0, size: 3}\n"
+            "    block {no: 1, offset: 31, blockOffset: 3, size: 3}\n"
+            "read {reference: 0, bundleId: 0, offset: 0, size: 42}\n"
+            "  super block {max: 19, size: 27}\n"
+            "    block {no: 0, offset: 0, blockOffset: 0, size: 1}\n"
+            "    block {no: 3, offset: 10, blockOffset: 5, size: 3}\n"
+            "    block {no: 4, offset: 13, blockOffset: 8, size: 3}\n"
+            "    block {no: 5, offset: 16, blockOffset: 11, size: 3}\n"
+            "  super block {max: 7, size: 15}\n"
+            "    block {no: 1, offset: 34, blockOffset: 3, size: 3}\n"
+            "    block {no: 2, offset: 37, blockOffset: 6, size: 1}\n",
+            "check delta");
+
+        // Perform block delta and restore the blocks
+        blockDelta = blockDeltaNew(
+            blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8, NULL, cipherTypeNone, NULL, compressTypeGz, 0);
+        String *const restore = strNew();
+
+        for (unsigned int readIdx = 0; readIdx < blockDeltaReadSize(blockDelta); readIdx++)
+        {
+            blockDeltaRead = blockDeltaReadGet(blockDelta, readIdx);
+            read = ioBufferReadNewOpen(repoList[blockDeltaRead->reference]);
+            const BlockDeltaWrite *deltaWrite = blockDeltaNext(blockDelta, blockDeltaRead, read);
+
+            while (deltaWrite != NULL)
+            {
+                strCatFmt(restore, "%" PRIu64 ":%s ", deltaWrite->offset, strZ(strNewBuf(deltaWrite->block)));
+                deltaWrite = blockDeltaNext(blockDelta, blockDeltaRead, read);
+            }
+        }
+
+        TEST_RESULT_STR_Z(
+            restore, "1:B!! 4:!!! 7:!!! 19:O!! 22:!!! 25:!!! 28:!!! 31:!UV 0:A 10:FGH 13:IJK 16:LMN 34:WXY 37:Z ",
+            "restore blocks");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("super blocks separated by a gap are read with one read");
+
+        // Write block incremental with three super blocks
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        ioFilterGroupAdd(
+            ioWriteFilterGroup(write),
+            blockIncrNew(6, 3, 5, false, 0, 0, 0, NULL, 0, 0, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
+        ioWriteOpen(write);
+        ioWrite(write, BUFSTRDEF("123456789ABCDEFGHI"));
+        ioWriteClose(write);
+
+        mapSize = pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE));
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+
+        // Block checksums for a file where only the blocks in the middle super block are unchanged
+        write = ioBufferWriteNew(bufNew(0));
+        ioFilterGroupAdd(ioWriteFilterGroup(write), blockChecksumNew(3, 5));
+        ioWriteOpen(write);
+        ioWrite(write, BUFSTRDEF("XXXXXX789ABCXXXXXX"));
+        ioWriteClose(write);
+
+        const Buffer *const blockChecksum = pckReadBinP(
+            ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_CHECKSUM_FILTER_TYPE));
+
+        TEST_RESULT_UINT(
+            blockDeltaReadSize(
+                blockDeltaNew(
+                    blockMapNewRead(ioBufferReadNewOpen(map), 3, 5), 3, 5, blockChecksum, cipherTypeNone, NULL, compressTypeGz, 0)),
+            2, "two reads without gap");
+
+        blockDelta = blockDeltaNew(
+            blockMapNewRead(ioBufferReadNewOpen(map), 3, 5), 3, 5, blockChecksum, cipherTypeNone, NULL, compressTypeGz, 64);
+
+        TEST_RESULT_UINT(blockDeltaReadSize(blockDelta), 1, "one read with gap");
+
+        blockDeltaRead = blockDeltaReadGet(blockDelta, 0);
+        TEST_RESULT_UINT(blockDeltaRead->offset, 0, "read offset");
+        TEST_RESULT_UINT(blockDeltaRead->size, bufUsed(destination) - mapSize, "read size");
+        TEST_RESULT_UINT(lstSize(blockDeltaRead->superBlockList), 2, "super blocks");
+        TEST_RESULT_UINT(
+            ((const BlockDeltaSuperBlock *)lstGet(blockDeltaRead->superBlockList, 1))->gap,
+            ((const BlockDeltaSuperBlock *)lstGet(blockDeltaRead->superBlockList, 0))->size, "gap");
+
+        read = ioBufferReadNewOpen(destination);
+        strTrunc(restore);
+
+        const BlockDeltaWrite *deltaWrite = blockDeltaNext(blockDelta, blockDeltaRead, read);
+
+        while (deltaWrite != NULL)
+        {
+            strCatFmt(restore, "%" PRIu64 ":%s ", deltaWrite->offset, strZ(strNewBuf(deltaWrite->block)));
+            deltaWrite = blockDeltaNext(blockDelta, blockDeltaRead, read);
+        }
+
+        TEST_RESULT_STR_Z(restore, "0:123 3:456 12:DEF 15:GHI ", "restore blocks");
     }
 
     // *****************************************************************************************************************************
@@ -308,10 +446,112 @@ testRun(void)
         TEST_ERROR(
             restoreFile(
                 strNewFmt(STORAGE_REPO_BACKUP "/%s/%s.gz", strZ(repoFileReferenceFull), strZ(repoFile1)), repoIdx, compressTypeGz,
-                0, false, false, false, STRDEF("badpass"), NULL, fileList),
+                0, false, false, false, CFGOPTVAL_ALLOCATE_NORMAL, cfgOptionUInt64(cfgOptReadGapMax), STRDEF("badpass"), NULL,
+                fileList),
             ChecksumError,
             "error restoring 'normal': actual checksum 'd1cd8a7d11daa26814b93eb604e1d49ab4b43770' does not match expected checksum"
             " 'ffffffffffffffffffffffffffffffffffffffff'");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundled files with gaps");
+
+        // Bundle with a gap that will be discarded (zeroed file) and a gap that is too large to discard
+        Buffer *const bundle = bufNew(32);
+        memset(bufPtr(bundle), 'X', 32);
+        memcpy(bufPtr(bundle), "aaabbbccc", 9);
+        memcpy(bufPtr(bundle) + 29, "ddd", 3);
+        bufUsedSet(bundle, 32);
+
+        HRN_STORAGE_PUT(storageRepoWrite(), STORAGE_REPO_BACKUP "/20190509F/bundle/1", bundle);
+
+        fileList = lstNewP(sizeof(RestoreFile));
+
+        lstAdd(
+            fileList,
+            &(RestoreFile){
+                .name = STRDEF("bundle-a"), .checksum = cryptoHashOne(hashTypeSha1, BUFSTRDEF("aaa")), .size = 3, .mode = 0600,
+                .offset = 0, .limit = VARUINT64(3)});
+        lstAdd(
+            fileList,
+            &(RestoreFile){
+                .name = STRDEF("bundle-b"), .checksum = cryptoHashOne(hashTypeSha1, BUFSTRDEF("bbb")), .size = 3, .mode = 0600,
+                .zero = true, .offset = 3, .limit = VARUINT64(3)});
+        lstAdd(
+            fileList,
+            &(RestoreFile){
+                .name = STRDEF("bundle-c"), .checksum = cryptoHashOne(hashTypeSha1, BUFSTRDEF("ccc")), .size = 3, .mode = 0600,
+                .offset = 6, .limit = VARUINT64(3)});
+        lstAdd(
+            fileList,
+            &(RestoreFile){
+                .name = STRDEF("bundle-d"), .checksum = cryptoHashOne(hashTypeSha1, BUFSTRDEF("ddd")), .size = 3, .mode = 0600,
+                .offset = 29, .limit = VARUINT64(3)});
+
+        List *result = NULL;
+
+        TEST_ASSIGN(
+            result,
+            restoreFile(
+                STRDEF(STORAGE_REPO_BACKUP "/20190509F/bundle/1"), repoIdx, compressTypeNone, 0, false, false, false,
+                CFGOPTVAL_ALLOCATE_NORMAL, 16, NULL, NULL, fileList),
+            "restore bundle");
+        TEST_RESULT_UINT(((RestoreFileResult *)lstGet(result, 0))->result, restoreResultCopy, "check a result");
+        TEST_RESULT_UINT(((RestoreFileResult *)lstGet(result, 1))->result, restoreResultZero, "check b result");
+        TEST_RESULT_UINT(((RestoreFileResult *)lstGet(result, 2))->result, restoreResultCopy, "check c result");
+        TEST_RESULT_UINT(((RestoreFileResult *)lstGet(result, 3))->result, restoreResultCopy, "check d result");
+        TEST_STORAGE_GET(storagePgWrite(), "bundle-a", "aaa", .remove = true);
+        TEST_RESULT_UINT(storageInfoP(storagePg(), STRDEF("bundle-b")).size, 3, "check b size");
+        HRN_STORAGE_REMOVE(storagePgWrite(), "bundle-b");
+        TEST_STORAGE_GET(storagePgWrite(), "bundle-c", "ccc", .remove = true);
+        TEST_STORAGE_GET(storagePgWrite(), "bundle-d", "ddd", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundled file stored without compression in a compressed backup");
+
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20190509F/bundle/2", "eee");
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        lstAdd(
+            fileList,
+            &(RestoreFile){
+                .name = STRDEF("bundle-e"), .checksum = cryptoHashOne(hashTypeSha1, BUFSTRDEF("eee")), .size = 3, .mode = 0600,
+                .offset = 0, .limit = VARUINT64(3), .compressNone = true});
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                STRDEF(STORAGE_REPO_BACKUP "/20190509F/bundle/2"), repoIdx, compressTypeGz, 0, false, false, true,
+                CFGOPTVAL_ALLOCATE_NORMAL, cfgOptionUInt64(cfgOptReadGapMax), NULL, NULL, fileList),
+            "restore bundle");
+        TEST_STORAGE_GET(storagePgWrite(), "bundle-e", "eee", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("sparse and preallocated files");
+
+        Buffer *const sparse = bufNew(16384);
+        memset(bufPtr(sparse), 0, bufSize(sparse));
+        memcpy(bufPtr(sparse) + 8192, "data", 4);
+        bufUsedSet(sparse, bufSize(sparse));
+
+        HRN_STORAGE_PUT(storageRepoWrite(), STORAGE_REPO_BACKUP "/20190509F/pg_data/sparse", sparse);
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        lstAdd(
+            fileList,
+            &(RestoreFile){.name = STRDEF("sparse"), .checksum = cryptoHashOne(hashTypeSha1, sparse), .size = 16384, .mode = 0600});
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                STRDEF(STORAGE_REPO_BACKUP "/20190509F/pg_data/sparse"), repoIdx, compressTypeNone, 0, false, false, false,
+                CFGOPTVAL_ALLOCATE_SPARSE, cfgOptionUInt64(cfgOptReadGapMax), NULL, NULL, fileList),
+            "restore sparse");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storagePg(), STRDEF("sparse"))), sparse), true, "check sparse");
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                STRDEF(STORAGE_REPO_BACKUP "/20190509F/pg_data/sparse"), repoIdx, compressTypeNone, 0, false, false, false,
+                CFGOPTVAL_ALLOCATE_FULL, cfgOptionUInt64(cfgOptReadGapMax), NULL, NULL, fileList),
+            "restore preallocated");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storagePg(), STRDEF("sparse"))), sparse), true, "check preallocated");
     }
 
     // *****************************************************************************************************************************
@@ -2252,7 +2492,7 @@ testRun(void)
                 storageNewWriteP(storageRepoIdxWrite(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE))));
 
         // Read the manifest, set a cipher passphrase and store it to the encrypted repo
-        Manifest *manifestEncrypted = manifestLoadFile(
+        Manifest *manifestEncrypted = manifestLoadFileP(
             storageRepoIdxWrite(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE), cipherTypeNone, NULL);
         manifestCipherSubPassSet(manifestEncrypted, STRDEF(TEST_CIPHER_PASS_ARCHIVE));
 
@@ -2792,7 +3032,7 @@ testRun(void)
             bufUsedSet(fileBuffer, bufSize(fileBuffer));
 
             IoWrite *write = storageWriteIo(storageNewWriteP(storageRepoWrite(), STRDEF(TEST_REPO_PATH "base/1/bi-no-ref.pgbi")));
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, 3, 0, 0, NULL, NULL, NULL));
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, false, 3, 0, 0, NULL, 0, 0, NULL, NULL, NULL));
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioSizeNew());
 
             ioWriteOpen(write);
@@ -2814,7 +3054,7 @@ testRun(void)
 
             Buffer *fileUnusedMap = bufNew(0);
             write = ioBufferWriteNew(fileUnusedMap);
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, 0, 0, 0, NULL, NULL, NULL));
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, false, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL));
 
             ioWriteOpen(write);
             ioWrite(write, fileUnused);
@@ -2833,8 +3073,9 @@ testRun(void)
             ioFilterGroupAdd(
                 ioWriteFilterGroup(write),
                 blockIncrNew(
-                    8192, 8192, 11, 3, 0, 0,
-                    BUF(bufPtr(fileUnusedMap) + bufUsed(fileUnusedMap) - fileUnusedMapSize, fileUnusedMapSize), NULL, NULL));
+                    8192, 8192, 11, false, 3, 0, 0,
+                    BUF(bufPtr(fileUnusedMap) + bufUsed(fileUnusedMap) - fileUnusedMapSize, fileUnusedMapSize), 0, 0, NULL, NULL,
+                    NULL));
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioSizeNew());
 
             ioWriteOpen(write);
@@ -3306,6 +3547,7 @@ testRun(void)
         hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
         hrnCfgArgRaw(argList, cfgOptPgPath, pgPath);
         hrnCfgArgRawZ(argList, cfgOptSpoolPath, TEST_PATH "/spool");
+        hrnCfgArgRawZ(argList, cfgOptAllocate, "sparse");
 
         // Configure a bogus repo1 and restore from repo2 to ensure that restore correctly uses the selected repo
         hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 1, "/bogus");
@@ -3329,6 +3571,9 @@ testRun(void)
             "postgresql.auto.conf\n",
             .level = storageInfoLevelType);
 
+        // Zero blocks are not stored in the repository and are left as holes so make sure the file was extended to full size
+        TEST_RESULT_UINT(storageInfoP(storagePg(), STRDEF(PG_PATH_BASE "/1/2")).size, 256 * 1024, "check zero block file size");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("delta restore with block incr");
 
@@ -3339,6 +3584,7 @@ testRun(void)
         hrnCfgArgRaw(argList, cfgOptPgPath, pgPath);
         hrnCfgArgRawZ(argList, cfgOptSpoolPath, TEST_PATH "/spool");
         hrnCfgArgRawBool(argList, cfgOptDelta, true);
+        hrnCfgArgRawZ(argList, cfgOptAllocate, "sparse");
         hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
         hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
         HRN_CFG_LOAD(cfgCmdRestore, argList);
@@ -3395,6 +3641,18 @@ testRun(void)
         // Check that file was restored to full size with a partial write
         TEST_RESULT_LOG_EMPTY_OR_CONTAINS(", bi 128KB/256KB, ");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("delta restore with block incr and normal allocation");
+
+        HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/2", relation);
+
+        strLstRemove(argList, STRDEF("--allocate=sparse"));
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        TEST_RESULT_VOID(cmdRestore(), "restore");
+        TEST_RESULT_LOG_EMPTY_OR_CONTAINS(", bi 128KB/256KB, ");
+        TEST_RESULT_UINT(storageInfoP(storagePg(), STRDEF(PG_PATH_BASE "/1/2")).size, 256 * 1024, "check zero block file size");
+
         hrnStorageHelperRepoShimSet(true);
     }
 
@@ -1549,7 +1549,8 @@ testRun(void)
             TEST_MANIFEST_DB
             "\n"
             "[target:file]\n"
-            "pg_data/validfile={\"bni\":1,\"bno\":3,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
+            "pg_data/validfile={\"bni\":1,\"bno\":3,\"checksum\":\"%s\",\"cmp\":false,\"size\":%u"
+            ",\"timestamp\":1565282114}\n"
             "pg_data/zerofile={\"size\":0,\"timestamp\":1565282114}\n"
             "pg_data/biind={\"bi\":1,\"bim\":3,\"checksum\":\"9865d483bc5a94f2e30056fc256ed3066af54d04\",\"size\":4"
             ",\"timestamp\":1565282114}\n"
@@ -2301,8 +2302,8 @@ testRun(void)
             "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/postgresql.auto.conf\n"
             "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (bundle 1/0, 2B, 0.00%) checksum [SHA1]\n"
             "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/44 (bundle 1/10, 16KB, 5.71%) checksum [SHA1]\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (bundle 1/68, 256KB, 97.14%) checksum [SHA1]\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/544, 8KB, 100.00%) checksum [SHA1]\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (bundle 1/14, 256KB, 97.14%) checksum [SHA1]\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/18, 8KB, 100.00%) checksum [SHA1]\n"
             "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
             "P00   INFO: backup stop archive = 0000000105D944C000000000, lsn = 5d944c0/800000\n"
             "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
@@ -2338,7 +2339,7 @@ testRun(void)
             "P00   INFO: check archive for prior segment 0000000105D95D2F000000FF\n"
             "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/postgresql.auto.conf\n"
             "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (bundle 1/0, 256KB, 96.97%) checksum [SHA1]\n"
-            "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/237, 8KB, 100.00%) checksum [SHA1]\n"
+            "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/46, 8KB, 100.00%) checksum [SHA1]\n"
             "P00 DETAIL: reference pg_data/PG_VERSION to 20191002-070640F\n"
             "P00 DETAIL: reference pg_data/base/1/44 to 20191002-070640F\n"
             "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
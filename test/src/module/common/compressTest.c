@@ -294,7 +294,7 @@ testRun(void)
 
         char buffer[STACK_TRACE_PARAM_MAX];
 
-        Bz2Compress *compress = (Bz2Compress *)ioFilterDriver(bz2CompressNew(1, false));
+        Bz2Compress *compress = (Bz2Compress *)ioFilterDriver(bz2CompressNew(1, false, 0));
 
         compress->stream.avail_in = 999;
 
@@ -334,7 +334,7 @@ testRun(void)
 
         char buffer[STACK_TRACE_PARAM_MAX];
 
-        Lz4Compress *compress = (Lz4Compress *)ioFilterDriver(lz4CompressNew(7, false));
+        Lz4Compress *compress = (Lz4Compress *)ioFilterDriver(lz4CompressNew(7, false, 0));
 
         compress->inputSame = true;
         compress->flushing = true;
@@ -372,19 +372,57 @@ testRun(void)
         TEST_RESULT_INT(compressLevelMin(compressTypeZst), -7, "level default");
         TEST_RESULT_INT(compressLevelMax(compressTypeZst), 22, "level default");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compress with threads");
+
+        // Data must be large enough to be split into multiple jobs
+        Buffer *const decompressed = bufNew(16 * 1024 * 1024);
+
+        for (size_t chrIdx = 0; chrIdx < bufSize(decompressed); chrIdx++)
+            *(bufPtr(decompressed) + chrIdx) = (uint8_t)((chrIdx / 7) % 251);
+
+        bufUsedSet(decompressed, bufSize(decompressed));
+
+        Buffer *compressed = NULL;
+
+        TEST_ASSIGN(
+            compressed, testCompress(compressFilterP(compressTypeZst, 1, .thread = 4), decompressed, 65536, 8192),
+            "compress with threads");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(decompressFilterP(compressTypeZst), compressed, 65536, 65536)), true,
+            "decompress");
+
+        // Input larger than a job with room for all the output so calls return before the input is consumed or the output is full
+        TEST_ASSIGN(
+            compressed,
+            testCompress(
+                compressFilterP(compressTypeZst, 1, .thread = 2), decompressed, bufSize(decompressed), bufSize(decompressed)),
+            "compress with threads and large buffers");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(decompressFilterP(compressTypeZst), compressed, 65536, 65536)), true,
+            "decompress");
+
+        // The library may be built without thread support
+        const unsigned int threadMax = (unsigned int)ZSTD_cParam_getBounds(ZSTD_c_nbWorkers).upperBound;
+
+        TEST_RESULT_UINT(
+            ((ZstCompress *)ioFilterDriver(zstCompressNew(1, false, 2)))->thread, threadMax < 2 ? threadMax : 2, "threads set");
+        TEST_RESULT_BOOL(
+            ((ZstCompress *)ioFilterDriver(zstCompressNew(1, false, 999999)))->thread < 999999, true, "threads limited");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("zstDecompressToLog() and zstCompressToLog()");
 
         char buffer[STACK_TRACE_PARAM_MAX];
 
-        ZstCompress *compress = (ZstCompress *)ioFilterDriver(zstCompressNew(14, false));
+        ZstCompress *compress = (ZstCompress *)ioFilterDriver(zstCompressNew(14, false, 0));
 
         compress->inputSame = true;
         compress->inputOffset = 49;
         compress->flushing = true;
 
         TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(compress, zstCompressToLog, buffer, sizeof(buffer)), "zstCompressToLog");
-        TEST_RESULT_Z(buffer, "{level: 14, inputSame: true, inputOffset: 49, flushing: true}", "check log");
+        TEST_RESULT_Z(buffer, "{level: 14, thread: 0, inputSame: true, inputOffset: 49, flushing: true}", "check log");
 
         ZstDecompress *decompress = (ZstDecompress *)ioFilterDriver(zstDecompressNew(false));
 
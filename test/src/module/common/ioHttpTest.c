@@ -18,6 +18,45 @@ HTTP user agent header
 #define TEST_USER_AGENT                                                                                                            \
     HTTP_HEADER_USER_AGENT ":" PROJECT_NAME "/" PROJECT_VERSION "\r\n"
 
+/***********************************************************************************************************************************
+Read-ahead callbacks
+***********************************************************************************************************************************/
+static HttpRequest *
+testReadAheadRequest(void *const driver, const uint64_t offset, const uint64_t size)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM_P(VOID, driver);
+        FUNCTION_HARNESS_PARAM(UINT64, offset);
+        FUNCTION_HARNESS_PARAM(UINT64, size);
+    FUNCTION_HARNESS_END();
+
+    HttpRequest *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        result = httpRequestMove(
+            httpRequestNewP(
+                driver, HTTP_VERB_GET_STR, STRDEF("/"), .header = httpHeaderPutRange(httpHeaderNew(NULL), offset, VARUINT64(size))),
+            memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_HARNESS_RETURN(HTTP_REQUEST, result);
+}
+
+static HttpResponse *
+testReadAheadResponse(void *const driver, HttpRequest *const request)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM_P(VOID, driver);
+        FUNCTION_HARNESS_PARAM(HTTP_REQUEST, request);
+    FUNCTION_HARNESS_END();
+
+    (void)driver;
+
+    FUNCTION_HARNESS_RETURN(HTTP_RESPONSE, httpRequestResponse(request, false));
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -828,6 +867,7 @@ testRun(void)
                     FUNCTION_LOG_OBJECT_FORMAT(httpResponseHeader(response), httpHeaderToLog, logBuf, sizeof(logBuf)),
                     "httpHeaderToLog");
                 TEST_RESULT_Z(logBuf, "{transfer-encoding: 'chunked'}", "check response headers");
+                TEST_RESULT_UINT(httpResponseContentSize(response), 0, "content size is not known");
 
                 Buffer *buffer = bufNew(35);
 
@@ -979,5 +1019,263 @@ testRun(void)
         TEST_RESULT_PTR_NE(statToJson(), NULL, "check");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("HttpReadAhead"))
+    {
+        HRN_FORK_BEGIN()
+        {
+            const unsigned int testPort = hrnServerPortNext();
+
+            HRN_FORK_CHILD_BEGIN(.prefix = "test server", .timeout = 5000)
+            {
+                // Start HTTP test server
+                TEST_RESULT_VOID(hrnServerRunP(HRN_FORK_CHILD_READ(), hrnServerProtocolSocket, testPort), "http server");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                IoWrite *http = hrnServerScriptBegin(HRN_FORK_PARENT_WRITE(0));
+                HttpClient *client = NULL;
+                HttpResponse *response = NULL;
+                HttpReadAhead *readAhead = NULL;
+                Buffer *buffer = NULL;
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("read in ranges when the size is known");
+
+                TEST_ASSIGN(client, httpClientNew(sckClientNew(hrnServerHost(), testPort, 5000, 5000), 5000), "new client");
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET / HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=0-3\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\ncontent-length:4\r\n\r\n0123");
+
+                // The second range is requested on a new connection while the first range is being read
+                hrnServerScriptSession(http, 1);
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET / HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-7\r\n\r\n");
+
+                // The third range is requested on the first connection once the first range has been read
+                hrnServerScriptSession(http, 0);
+                hrnServerScriptExpectZ(http, "GET / HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=8-9\r\n\r\n");
+
+                hrnServerScriptSession(http, 1);
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\ncontent-length:4\r\n\r\n4567");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptSession(http, 0);
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\ncontent-length:2\r\n\r\n89");
+                hrnServerScriptClose(http);
+
+                TEST_ASSIGN(response, testReadAheadResponse(NULL, testReadAheadRequest(client, 0, 4)), "first range");
+                TEST_ASSIGN(
+                    readAhead,
+                    httpReadAheadNewP(
+                        response, 0, 10, 4, 2, .driver = client, .request = testReadAheadRequest,
+                        .response = testReadAheadResponse),
+                    "new read-ahead");
+                TEST_RESULT_BOOL(httpReadAheadEof(readAhead), false, "not eof");
+
+                buffer = bufNew(16);
+                TEST_RESULT_UINT(httpReadAhead(readAhead, buffer), 10, "read");
+                TEST_RESULT_STR_Z(strNewBuf(buffer), "0123456789", "check content");
+                TEST_RESULT_BOOL(httpReadAheadEof(readAhead), true, "eof");
+                TEST_RESULT_UINT(httpReadAhead(readAhead, buffer), 0, "read at eof");
+
+                TEST_RESULT_VOID(httpReadAheadFree(readAhead), "free");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("read in ranges when the first response contains the entire object");
+
+                TEST_ASSIGN(client, httpClientNew(sckClientNew(hrnServerHost(), testPort, 5000, 5000), 5000), "new client");
+
+                #define TEST_RANGE_40                                       "0123456789012345678901234567890123456789"
+                #define TEST_RANGE_20                                       "01234567890123456789"
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET / HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(
+                    http, "HTTP/1.1 200 OK\r\ncontent-length:100\r\n\r\n" TEST_RANGE_40 TEST_RANGE_40 TEST_RANGE_20);
+
+                hrnServerScriptSession(http, 1);
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET / HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=40-79\r\n\r\n");
+
+                hrnServerScriptSession(http, 2);
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET / HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=80-99\r\n\r\n");
+
+                hrnServerScriptSession(http, 1);
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\ncontent-length:40\r\n\r\n" TEST_RANGE_40);
+                hrnServerScriptClose(http);
+
+                hrnServerScriptSession(http, 2);
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\ncontent-length:20\r\n\r\n" TEST_RANGE_20);
+                hrnServerScriptClose(http);
+
+                // The rest of the first response is discarded and the connection closed since the content was not read completely
+                hrnServerScriptSession(http, 0);
+                hrnServerScriptClose(http);
+
+                // Use a buffer size smaller than the content so the first response is not read completely
+                const size_t bufferSize = ioBufferSize();
+                ioBufferSizeSet(64);
+
+                TEST_ASSIGN(
+                    response, httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/")), false),
+                    "first response");
+                TEST_RESULT_UINT(httpResponseContentSize(response), 100, "content size");
+                TEST_ASSIGN(
+                    readAhead,
+                    httpReadAheadNewP(
+                        response, 0, 100, 40, 3, .driver = client, .request = testReadAheadRequest,
+                        .response = testReadAheadResponse),
+                    "new read-ahead");
+
+                buffer = bufNew(7);
+                String *content = strNew();
+
+                do
+                {
+                    bufUsedZero(buffer);
+                    httpReadAhead(readAhead, buffer);
+                    strCat(content, strNewBuf(buffer));
+                }
+                while (!httpReadAheadEof(readAhead));
+
+                TEST_RESULT_STR_Z(content, TEST_RANGE_40 TEST_RANGE_40 TEST_RANGE_20, "check content");
+                TEST_RESULT_VOID(httpReadAheadFree(readAhead), "free");
+
+                ioBufferSizeSet(bufferSize);
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error on short range");
+
+                TEST_ASSIGN(client, httpClientNew(sckClientNew(hrnServerHost(), testPort, 5000, 5000), 5000), "new client");
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET / HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=0-3\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\n\r\n01");
+                hrnServerScriptClose(http);
+
+                TEST_ASSIGN(response, testReadAheadResponse(NULL, testReadAheadRequest(client, 0, 4)), "first range");
+                TEST_ASSIGN(
+                    readAhead,
+                    httpReadAheadNewP(
+                        response, 0, 4, 4, 2, .driver = client, .request = testReadAheadRequest,
+                        .response = testReadAheadResponse),
+                    "new read-ahead");
+                TEST_ERROR(httpReadAhead(readAhead, bufNew(16)), FormatError, "unexpected eof in range response");
+
+                TEST_RESULT_VOID(httpReadAheadFree(readAhead), "free");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("end server process");
+
+                hrnServerScriptEnd(http);
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("httpClientShared()"))
+    {
+        HRN_FORK_BEGIN()
+        {
+            const unsigned int testPort = hrnServerPortNext();
+
+            HRN_FORK_CHILD_BEGIN(.prefix = "test server", .timeout = 5000)
+            {
+                TEST_RESULT_VOID(hrnServerRunP(HRN_FORK_CHILD_READ(), hrnServerProtocolSocket, testPort), "http server");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                IoWrite *http = hrnServerScriptBegin(HRN_FORK_PARENT_WRITE(0));
+                HttpClient *client = NULL;
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("no shared clients to close");
+
+                TEST_RESULT_VOID(httpClientSharedClose(), "close");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get shared client");
+
+                TEST_ASSIGN(
+                    client, httpClientSharedP(STRDEF("key"), sckClientNew(hrnServerHost(), testPort, 5000, 5000), 500),
+                    "new client");
+                TEST_RESULT_PTR(
+                    httpClientSharedP(STRDEF("key"), sckClientNew(hrnServerHost(), testPort, 5000, 5000), 500, .sessionMax = 1),
+                    client, "same client");
+                TEST_RESULT_PTR(
+                    httpClientSharedP(STRDEF("key"), sckClientNew(hrnServerHost(), testPort, 5000, 5000), 500, .sessionMax = 1),
+                    client, "same client");
+                TEST_RESULT_BOOL(
+                    httpClientSharedP(STRDEF("key2"), sckClientNew(hrnServerHost(), testPort, 5000, 5000), 500) == client, false,
+                    "different client");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("session over the maximum is closed");
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /1 HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+
+                hrnServerScriptSession(http, 1);
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /2 HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:1\r\n\r\n2");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptSession(http, 0);
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:1\r\n\r\n1");
+
+                HttpRequest *request1 = httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/1"));
+                HttpRequest *request2 = httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/2"));
+
+                TEST_RESULT_STR_Z(strNewBuf(httpResponseContent(httpRequestResponse(request1, true))), "1", "response 1");
+                TEST_RESULT_STR_Z(strNewBuf(httpResponseContent(httpRequestResponse(request2, true))), "2", "response 2");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("session is reused");
+
+                hrnServerScriptExpectZ(http, "GET /3 HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:1\r\n\r\n3");
+                hrnServerScriptClose(http);
+
+                request1 = httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/3"));
+                TEST_RESULT_STR_Z(strNewBuf(httpResponseContent(httpRequestResponse(request1, true))), "3", "response 3");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("idle session is closed");
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /4 HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:1\r\n\r\n4");
+                hrnServerScriptClose(http);
+
+                sleepMSec(600);
+
+                request1 = httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/4"));
+                TEST_RESULT_STR_Z(strNewBuf(httpResponseContent(httpRequestResponse(request1, true))), "4", "response 4");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("close shared sessions");
+
+                TEST_RESULT_VOID(httpClientSharedClose(), "close");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("end server process");
+
+                hrnServerScriptEnd(http);
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
@@ -75,6 +75,7 @@ Test filter that counts total bytes
 typedef struct IoTestFilterSize
 {
     size_t size;
+    size_t inputMax;                                                // Largest input buffer seen
 } IoTestFilterSize;
 
 static void
@@ -93,6 +94,9 @@ ioTestFilterSizeProcess(THIS_VOID, const Buffer *buffer)
 
     this->size += bufUsed(buffer);
 
+    if (bufUsed(buffer) > this->inputMax)
+        this->inputMax = bufUsed(buffer);
+
     FUNCTION_LOG_RETURN_VOID();
 }
 
@@ -535,6 +539,84 @@ testRun(void)
         TEST_RESULT_UINT(
             pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(bufferRead), SIZE_FILTER_TYPE)), 20, "check length");
 
+        // Process consecutive input filters in chunks
+        // -------------------------------------------------------------------------------------------------------------------------
+        ioBufferSizeSet(200 * 1024);
+
+        Buffer *const chunkBuffer = bufNew(220003);
+        memset(bufPtr(chunkBuffer), 'X', bufSize(chunkBuffer));
+        bufUsedSet(chunkBuffer, bufSize(chunkBuffer));
+
+        IoFilter *const size2Filter = ioTestFilterSizeNew(STRID5("size2", 0x1c2e9330));
+        IoFilter *const size3Filter = ioTestFilterSizeNew(STRID6("size3", 0x1f15a2531));
+
+        bufferRead = ioBufferReadNew(chunkBuffer);
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), ioSizeNew());
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), size2Filter);
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), ioTestFilterMultiplyNew(STRID5("single", 0xac3b9330), 1, 0, 'Y'));
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), size3Filter);
+
+        TEST_RESULT_BOOL(ioReadDrain(bufferRead), true, "drain read io");
+        TEST_RESULT_UINT(
+            pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(bufferRead), SIZE_FILTER_TYPE)), 220003, "check length");
+        TEST_RESULT_UINT(
+            pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(bufferRead), STRID5("size2", 0x1c2e9330))), 220003,
+            "check length");
+        TEST_RESULT_UINT(((IoTestFilterSize *)((IoFilterPub *)size2Filter)->driver)->inputMax, 64 * 1024, "check chunk size");
+        TEST_RESULT_UINT(
+            pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(bufferRead), STRID6("size3", 0x1f15a2531))), 220003,
+            "check length");
+        TEST_RESULT_UINT(
+            ((IoTestFilterSize *)((IoFilterPub *)size3Filter)->driver)->inputMax, 200 * 1024, "single filter is not chunked");
+
+        // Read directly into the output buffer when the filter group is pass-through
+        // -------------------------------------------------------------------------------------------------------------------------
+        ioBufferSizeSet(4);
+
+        bufferRead = ioBufferReadNew(BUFSTRDEF("0123456789"));
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), ioSizeNew());
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), ioTestFilterSizeNew(STRID5("size2", 0x1c2e9330)));
+
+        TEST_RESULT_BOOL(ioReadOpen(bufferRead), true, "open");
+        TEST_RESULT_BOOL(ioFilterGroupPassThrough(ioReadFilterGroup(bufferRead)), true, "filter group is pass-through");
+
+        Buffer *const passBuffer = bufNew(4);
+
+        TEST_RESULT_UINT(ioRead(bufferRead, passBuffer), 4, "read into empty buffer");
+        TEST_RESULT_STR_Z(strNewBuf(passBuffer), "0123", "check buffer");
+        TEST_RESULT_UINT(bufUsed(((IoRead *)bufferRead)->input), 0, "input buffer not used");
+
+        bufUsedZero(passBuffer);
+        bufLimitSet(passBuffer, 3);
+
+        TEST_RESULT_UINT(ioRead(bufferRead, passBuffer), 3, "read into limited buffer");
+        TEST_RESULT_STR_Z(strNewBuf(passBuffer), "456", "check buffer");
+
+        bufLimitClear(passBuffer);
+
+        TEST_RESULT_UINT(ioRead(bufferRead, passBuffer), 1, "read into partial buffer");
+        TEST_RESULT_STR_Z(strNewBuf(passBuffer), "4567", "check buffer");
+
+        bufUsedZero(passBuffer);
+
+        TEST_RESULT_UINT(ioRead(bufferRead, passBuffer), 2, "read remaining");
+        TEST_RESULT_STR_Z(strNewBuf(passBuffer), "89", "check buffer");
+        TEST_RESULT_BOOL(ioReadEof(bufferRead), true, "eof");
+        TEST_RESULT_VOID(ioReadClose(bufferRead), "close");
+        TEST_RESULT_UINT(
+            pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(bufferRead), SIZE_FILTER_TYPE)), 10, "check length");
+        TEST_RESULT_UINT(
+            pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(bufferRead), STRID5("size2", 0x1c2e9330))), 10, "check length");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        bufferRead = ioBufferReadNew(BUFSTRDEF("0123456789"));
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), ioTestFilterMultiplyNew(STRID5("single", 0xac3b9330), 1, 0, 'Y'));
+        ioFilterGroupAdd(ioReadFilterGroup(bufferRead), ioSizeNew());
+
+        TEST_RESULT_BOOL(ioReadOpen(bufferRead), true, "open");
+        TEST_RESULT_BOOL(ioFilterGroupPassThrough(ioReadFilterGroup(bufferRead)), false, "filter group is not pass-through");
+        TEST_RESULT_STR_Z(strNewBuf(ioReadBuf(bufferRead)), "0123456789", "read");
+
         // Cannot open file
         TEST_ASSIGN(
             read, ioReadNewP(strNewZ("998"), .close = testIoReadClose, .open = testIoReadOpen, .read = testIoRead),
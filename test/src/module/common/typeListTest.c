@@ -160,6 +160,7 @@ testRun(void)
         value = 2;
         lstAdd(list, &value);
 
+        TEST_RESULT_UINT(lstSortOrder(list), sortOrderNone, "add resets sort order");
         TEST_RESULT_PTR(lstSort(list, sortOrderNone), list, "list sort none");
 
         TEST_RESULT_INT(*(int *)lstGet(list, 0), 3, "sort value 0");
@@ -175,6 +176,7 @@ testRun(void)
         TEST_RESULT_INT(*(int *)lstGet(list, 3), 5, "sort value 3");
 
         TEST_RESULT_PTR(lstSort(list, sortOrderDesc), list, "list sort desc");
+        TEST_RESULT_UINT(lstSortOrder(list), sortOrderDesc, "sort order desc");
 
         TEST_RESULT_INT(*(int *)lstGet(list, 0), 5, "sort value 0");
         TEST_RESULT_INT(*(int *)lstGet(list, 1), 3, "sort value 1");
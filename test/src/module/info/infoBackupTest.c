@@ -940,6 +940,14 @@ testRun(void)
             "\"backup-type\":\"full\",\"db-id\":2,\"option-archive-check\":true,\"option-archive-copy\":false,"
             "\"option-backup-standby\":true,\"option-checksum-page\":true,\"option-compress\":true,\"option-hardlink\":false,"
             "\"option-online\":true}\n"
+            "20200318-153815F_20200318-160000I={\"backrest-format\":5,\"backrest-version\":\"2.25dev\","
+            "\"backup-archive-start\":\"000000010000000000000044\",\"backup-archive-stop\":\"000000010000000000000044\","
+            "\"backup-info-repo-size\":3768733,\"backup-info-repo-size-delta\":433,\"backup-info-size\":31558514,"
+            "\"backup-info-size-delta\":8459,\"backup-prior\":\"20200318-153815F\","
+            "\"backup-reference\":[\"20200317-181625F_20200317-182239D\",\"20200318-153815F\"],"
+            "\"backup-timestamp-start\":1584547200,\"backup-timestamp-stop\":1584547203,\"backup-type\":\"incr\",\"db-id\":2,"
+            "\"option-archive-check\":true,\"option-archive-copy\":false,\"option-backup-standby\":true,"
+            "\"option-checksum-page\":true,\"option-compress\":true,\"option-hardlink\":false,\"option-online\":true}\n"
             "\n"
             "[db]\n"
             "db-catalog-version=201510051\n"
@@ -964,7 +972,8 @@ testRun(void)
         TEST_RESULT_STRLST_Z(
             dependencyList,
             "20200317-181625F\n20200317-181625F_20200317-182239D\n20200317-181625F_20200317-182300D\n"
-            "20200317-181625F_20200317-182324I\n20200317-181625F_20200317-182340I\n20200317-181625F_20200317-182340D\n",
+            "20200317-181625F_20200317-182324I\n20200317-181625F_20200317-182340I\n20200317-181625F_20200317-182340D\n"
+            "20200318-153815F_20200318-160000I\n",
             "all dependents");
 
         TEST_ASSIGN(dependencyList, infoBackupDataDependentList(infoBackup, STRDEF("20200317-181416F")), "full");
@@ -979,5 +988,11 @@ testRun(void)
         TEST_ASSIGN(dependencyList, infoBackupDataDependentList(infoBackup, STRDEF("20200317-181625F_20200317-182324I")), "incr");
         TEST_RESULT_STRLST_Z(
             dependencyList, "20200317-181625F_20200317-182324I\n20200317-181625F_20200317-182340I\n", "all dependents");
+
+        TEST_ASSIGN(
+            dependencyList, infoBackupDataDependentList(infoBackup, STRDEF("20200317-181625F_20200317-182239D")), "referenced diff");
+        TEST_RESULT_STRLST_Z(
+            dependencyList, "20200317-181625F_20200317-182239D\n20200318-153815F_20200318-160000I\n",
+            "dependent by reference only");
     }
 }
@@ -6,6 +6,7 @@ Test Backup Manifest Handler
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
 #include "info/infoBackup.h"
+#include "postgres/interface/crc32.h"
 #include "storage/posix/storage.h"
 
 #include "common/harnessInfo.h"
@@ -32,6 +33,7 @@ testRun(void)
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_RESULT_UINT(sizeof(ManifestLoadFound), TEST_64BIT() ? 1 : 1, "check size of ManifestLoadFound");
         TEST_RESULT_UINT(sizeof(ManifestPath), TEST_64BIT() ? 32 : 16, "check size of ManifestPath");
+        TEST_RESULT_UINT(sizeof(ManifestFilePack), TEST_64BIT() ? 8 : 4, "check size of ManifestFilePack");
     }
 
     // *****************************************************************************************************************************
@@ -289,7 +291,7 @@ testRun(void)
         TEST_ERROR(
             manifestNewBuild(
                 storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false, NULL, exclusionList,
-                pckWriteResult(tablespaceList)),
+                pckWriteResult(tablespaceList), NULL),
             AssertError,
             "tablespace with oid 1 not found in tablespace map\n"
             "HINT: was a tablespace created or dropped during the backup?");
@@ -314,7 +316,7 @@ testRun(void)
             manifest,
             manifestNewBuild(
                 storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false, NULL, NULL,
-                pckWriteResult(tablespaceList)),
+                pckWriteResult(tablespaceList), NULL),
             "build manifest");
         TEST_RESULT_VOID(manifestBackupLabelSet(manifest, STRDEF("20190818-084502F")), "backup label set");
 
@@ -410,7 +412,7 @@ testRun(void)
         TEST_ASSIGN(
             manifest,
             manifestNewBuild(
-                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, true, false, false, false, NULL, NULL, NULL, NULL),
             "build manifest");
 
         contentSave = bufNew(0);
@@ -483,7 +485,8 @@ testRun(void)
 
         TEST_ERROR(
             manifestNewBuild(
-                storagePg, PG_VERSION_96, hrnPgCatalogVersion(PG_VERSION_96), 0, false, false, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_96, hrnPgCatalogVersion(PG_VERSION_96), 0, false, false, false, false,
+                NULL, NULL, NULL, NULL),
             LinkDestinationError,
             "link 'pg_xlog/wal' (" TEST_PATH "/wal) destination is the same directory as link 'pg_xlog' (" TEST_PATH "/wal)");
 
@@ -539,7 +542,7 @@ testRun(void)
         TEST_ASSIGN(
             manifest,
             manifestNewBuild(
-                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, true, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, true, false, false, NULL, NULL, NULL, NULL),
             "build manifest");
 
         contentSave = bufNew(0);
@@ -634,7 +637,8 @@ testRun(void)
         // Tablespace link errors when correct version not found
         TEST_ERROR(
             manifestNewBuild(
-                storagePg, PG_VERSION_12, hrnPgCatalogVersion(PG_VERSION_12), 0, false, false, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_12, hrnPgCatalogVersion(PG_VERSION_12), 0, false, false, false, false,
+                NULL, NULL, NULL, NULL),
             FileOpenError, "unable to get info for missing path/file '" TEST_PATH "/pg/pg_tblspc/1/PG_12_201909212'");
 
         // Remove the link inside pg/pg_tblspc
@@ -653,7 +657,7 @@ testRun(void)
         TEST_ASSIGN(
             manifest,
             manifestNewBuild(
-                storagePg, PG_VERSION_12, hrnPgCatalogVersion(PG_VERSION_12), 0, true, false, true, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_12, hrnPgCatalogVersion(PG_VERSION_12), 0, true, false, true, false, NULL, NULL, NULL, NULL),
             "build manifest");
 
         contentSave = bufNew(0);
@@ -777,7 +781,7 @@ testRun(void)
             manifest,
             manifestNewBuild(
                 storagePg, PG_VERSION_13, hrnPgCatalogVersion(PG_VERSION_13), 1570000000, false, false, true, true,
-                &manifestBuildBlockIncrMap, NULL, NULL),
+                &manifestBuildBlockIncrMap, NULL, NULL, NULL),
             "build manifest");
 
         contentSave = bufNew(0);
@@ -852,7 +856,8 @@ testRun(void)
 
         TEST_ERROR(
             manifestNewBuild(
-                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false,
+                NULL, NULL, NULL, NULL),
             LinkDestinationError, "link 'link' destination '" TEST_PATH "/pg/base' is in PGDATA");
 
         THROW_ON_SYS_ERROR(unlink(TEST_PATH "/pg/link") == -1, FileRemoveError, "unable to remove symlink");
@@ -864,7 +869,8 @@ testRun(void)
 
         TEST_ERROR(
             manifestNewBuild(
-                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false,
+                NULL, NULL, NULL, NULL),
             LinkExpectedError, "'pg_data/pg_tblspc/somedir' is not a symlink - pg_tblspc should contain only symlinks");
 
         HRN_STORAGE_PATH_REMOVE(storagePgWrite, MANIFEST_TARGET_PGTBLSPC "/somedir");
@@ -876,11 +882,41 @@ testRun(void)
 
         TEST_ERROR(
             manifestNewBuild(
-                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false,
+                NULL, NULL, NULL, NULL),
             LinkExpectedError, "'pg_data/pg_tblspc/somefile' is not a symlink - pg_tblspc should contain only symlinks");
 
         TEST_STORAGE_EXISTS(storagePgWrite, MANIFEST_TARGET_PGTBLSPC "/somefile", .remove = true);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("path contents listed before the build are used instead of iterating the path");
+
+        HRN_STORAGE_PUT_Z(storagePgWrite, PG_PATH_BASE "/99/1", "1");
+
+        StorageList *const storageList = storageLstNew(storageInfoLevelDetail);
+        storageLstAdd(
+            storageList,
+            &(StorageInfo){
+                .name = STRDEF("2"), .exists = true, .level = storageInfoLevelDetail, .type = storageTypeFile, .size = 3,
+                .mode = 0600});
+
+        List *const buildPathList = lstNewP(sizeof(ManifestBuildPath), .comparator = lstComparatorStr);
+        lstAdd(buildPathList, &(ManifestBuildPath){.path = STRDEF(TEST_PATH "/pg/" PG_PATH_BASE "/99"), .list = storageList});
+
+        TEST_ASSIGN(
+            manifest,
+            manifestNewBuild(
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false, NULL, NULL, NULL,
+                buildPathList),
+            "build manifest");
+        TEST_RESULT_BOOL(
+            manifestFileExists(manifest, STRDEF(MANIFEST_TARGET_PGDATA "/" PG_PATH_BASE "/99/2")), true, "listed file exists");
+        TEST_RESULT_BOOL(
+            manifestFileExists(manifest, STRDEF(MANIFEST_TARGET_PGDATA "/" PG_PATH_BASE "/99/1")), false, "unlisted file missing");
+        TEST_RESULT_PTR(((ManifestBuildPath *)lstGet(buildPathList, 0))->list, NULL, "path contents freed");
+
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite, PG_PATH_BASE "/99", .recurse = true);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("error on link that points to nothing");
 
@@ -888,7 +924,7 @@ testRun(void)
 
         TEST_ERROR(
             manifestNewBuild(
-                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, true, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, true, false, false, NULL, NULL, NULL, NULL),
             FileOpenError, "unable to get info for missing path/file '" TEST_PATH "/pg/link-to-link'");
 
         THROW_ON_SYS_ERROR(unlink(TEST_PATH "/pg/link-to-link") == -1, FileRemoveError, "unable to remove symlink");
@@ -904,7 +940,8 @@ testRun(void)
 
         TEST_ERROR(
             manifestNewBuild(
-                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false, NULL, NULL, NULL),
+                storagePg, PG_VERSION_95, hrnPgCatalogVersion(PG_VERSION_95), 0, false, false, false, false,
+                NULL, NULL, NULL, NULL),
             LinkDestinationError, "link '" TEST_PATH "/pg/linktolink' cannot reference another link '" TEST_PATH "/linktest'");
 
         #undef TEST_MANIFEST_HEADER
@@ -1067,7 +1104,7 @@ testRun(void)
         }
         OBJ_NEW_END();
 
-        TEST_RESULT_VOID(manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, NULL), "incremental manifest");
+        TEST_RESULT_VOID(manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, NULL, NULL), "incremental manifest");
 
         Buffer *contentSave = bufNew(0);
         TEST_RESULT_VOID(manifestSave(manifest, ioBufferWriteNew(contentSave)), "save manifest");
@@ -1129,7 +1166,7 @@ testRun(void)
             manifestPrior, .name = MANIFEST_TARGET_PGDATA "/FILE0-normal", .size = 0, .sizeRepo = 0, .timestamp = 1482182860,
             .group = "test", .user = "test", .checksumSha1 = HASH_TYPE_SHA1_ZERO);
 
-        TEST_RESULT_VOID(manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, NULL), "incremental manifest");
+        TEST_RESULT_VOID(manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, NULL, NULL), "incremental manifest");
 
         contentSave = bufNew(0);
         TEST_RESULT_VOID(manifestSave(manifest, ioBufferWriteNew(contentSave)), "save manifest");
@@ -1183,7 +1220,7 @@ testRun(void)
             .checksumPage = true, .checksumPageError = true,
             .checksumPageErrorList = jsonFromVar(varNewVarLst(checksumPageErrorList)));
 
-        TEST_RESULT_VOID(manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, NULL), "incremental manifest");
+        TEST_RESULT_VOID(manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, NULL, NULL), "incremental manifest");
 
         TEST_RESULT_LOG(
             "P00   WARN: file 'FILE1' has timestamp earlier than prior backup (prior 1482182860, current 1482182859), enabling"
@@ -1231,7 +1268,7 @@ testRun(void)
             .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
 
         TEST_RESULT_VOID(
-            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000040000000400000004")),
+            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000040000000400000004"), NULL),
             "incremental manifest");
 
         TEST_RESULT_LOG(
@@ -1271,7 +1308,8 @@ testRun(void)
         manifest->pub.data.backupOptionDelta = BOOL_FALSE_VAR;
 
         TEST_RESULT_VOID(
-            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000040000000400000004")), "incremental manifest");
+            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000040000000400000004"), NULL),
+            "incremental manifest");
 
         TEST_RESULT_LOG(
             "P00   WARN: a timeline switch has occurred since the 20190101-010101F backup, enabling delta checksum\n"
@@ -1296,7 +1334,8 @@ testRun(void)
             .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
 
         TEST_RESULT_VOID(
-            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000030000000300000003")), "incremental manifest");
+            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000030000000300000003"), NULL),
+            "incremental manifest");
 
         TEST_RESULT_LOG("P00   WARN: the online option has changed since the 20190101-010101F backup, enabling delta checksum");
 
@@ -1363,7 +1402,8 @@ testRun(void)
             .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
 
         TEST_RESULT_VOID(
-            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000030000000300000003")), "incremental manifest");
+            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000030000000300000003"), NULL),
+            "incremental manifest");
 
         contentSave = bufNew(0);
         TEST_RESULT_VOID(manifestSave(manifest, ioBufferWriteNew(contentSave)), "save manifest");
@@ -1393,6 +1433,84 @@ testRun(void)
                     TEST_MANIFEST_PATH_DEFAULT)),
             "check manifest");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("relation files unmodified according to WAL summary are not copied");
+
+        lstClear(manifest->pub.fileList);
+        lstClear(manifestPrior->pub.fileList);
+
+        // Summary containing base/1/16386 (magic, entry, terminating entry, crc)
+        Buffer *const summary = bufNew(0);
+        const uint32_t summaryData[] = {0x652b137b, 1663, 1, 16386, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+        bufCatC(summary, (const unsigned char *)summaryData, 0, sizeof(summaryData));
+
+        const uint32_t summaryCrc = crc32cUpdate(CRC32C_INIT, bufPtrConst(summary), bufUsed(summary)) ^ CRC32C_INIT;
+        bufCatC(summary, (const unsigned char *)&summaryCrc, 0, sizeof(summaryCrc));
+
+        WalSummary *const walSummary = walSummaryNew(pgPageSize8);
+        walSummaryRead(walSummary, ioBufferReadNew(summary));
+
+        // Not modified
+        HRN_MANIFEST_FILE_ADD(
+            manifest, .name = MANIFEST_TARGET_PGDATA "/base/1/16385", .copy = true, .size = 8192, .sizeRepo = 8192,
+            .timestamp = 1482182861, .group = "test", .user = "test");
+        HRN_MANIFEST_FILE_ADD(
+            manifestPrior, .name = MANIFEST_TARGET_PGDATA "/base/1/16385", .size = 8192, .sizeRepo = 8192,
+            .timestamp = 1482182860, .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
+
+        // Modified
+        HRN_MANIFEST_FILE_ADD(
+            manifest, .name = MANIFEST_TARGET_PGDATA "/base/1/16386", .copy = true, .size = 8192, .sizeRepo = 8192,
+            .timestamp = 1482182861, .group = "test", .user = "test");
+        HRN_MANIFEST_FILE_ADD(
+            manifestPrior, .name = MANIFEST_TARGET_PGDATA "/base/1/16386", .size = 8192, .sizeRepo = 8192,
+            .timestamp = 1482182860, .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
+
+        // Not modified but size changed
+        HRN_MANIFEST_FILE_ADD(
+            manifest, .name = MANIFEST_TARGET_PGDATA "/base/1/16387", .copy = true, .size = 16384, .sizeRepo = 16384,
+            .timestamp = 1482182861, .group = "test", .user = "test");
+        HRN_MANIFEST_FILE_ADD(
+            manifestPrior, .name = MANIFEST_TARGET_PGDATA "/base/1/16387", .size = 8192, .sizeRepo = 8192,
+            .timestamp = 1482182860, .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
+
+        // Not a relation file
+        HRN_MANIFEST_FILE_ADD(
+            manifest, .name = MANIFEST_TARGET_PGDATA "/postgresql.auto.conf", .copy = true, .size = 4, .sizeRepo = 4,
+            .timestamp = 1482182861, .group = "test", .user = "test");
+        HRN_MANIFEST_FILE_ADD(
+            manifestPrior, .name = MANIFEST_TARGET_PGDATA "/postgresql.auto.conf", .size = 4, .sizeRepo = 4,
+            .timestamp = 1482182860, .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
+
+        // Not modified in a tablespace
+        HRN_MANIFEST_FILE_ADD(
+            manifest, .name = MANIFEST_TARGET_PGTBLSPC "/16400/PG_9.6_201608131/1/16388", .copy = true, .size = 8192,
+            .sizeRepo = 8192, .timestamp = 1482182861, .group = "test", .user = "test");
+        HRN_MANIFEST_FILE_ADD(
+            manifestPrior, .name = MANIFEST_TARGET_PGTBLSPC "/16400/PG_9.6_201608131/1/16388", .size = 8192, .sizeRepo = 8192,
+            .timestamp = 1482182860, .checksumSha1 = "ddddddddddbbbbbbbbbbccccccccccaaaaaaaaaa");
+
+        // New file that sorts after all prior files
+        HRN_MANIFEST_FILE_ADD(
+            manifest, .name = MANIFEST_TARGET_PGTBLSPC "/16400/PG_9.6_201608131/1/16389", .copy = true, .size = 8192,
+            .sizeRepo = 8192, .timestamp = 1482182861, .group = "test", .user = "test");
+
+        TEST_RESULT_VOID(
+            manifestBuildIncr(manifest, manifestPrior, backupTypeIncr, STRDEF("000000030000000300000003"), walSummary),
+            "incremental manifest");
+
+        TEST_RESULT_BOOL(manifestFileFind(manifest, STRDEF("pg_data/base/1/16385")).copy, false, "not modified");
+        TEST_RESULT_STR_Z(
+            manifestFileFind(manifest, STRDEF("pg_data/base/1/16385")).reference, "20190101-010101F", "reference prior");
+        TEST_RESULT_BOOL(manifestFileFind(manifest, STRDEF("pg_data/base/1/16386")).copy, true, "modified");
+        TEST_RESULT_BOOL(manifestFileFind(manifest, STRDEF("pg_data/base/1/16387")).copy, true, "size changed");
+        TEST_RESULT_BOOL(manifestFileFind(manifest, STRDEF("pg_data/postgresql.auto.conf")).copy, true, "not a relation");
+        TEST_RESULT_BOOL(
+            manifestFileFind(manifest, STRDEF("pg_tblspc/16400/PG_9.6_201608131/1/16388")).copy, false, "tablespace not modified");
+        TEST_RESULT_PTR(
+            manifestFileFind(manifest, STRDEF("pg_tblspc/16400/PG_9.6_201608131/1/16389")).reference, NULL, "new not referenced");
+
         #undef TEST_MANIFEST_HEADER_PRE
         #undef TEST_MANIFEST_HEADER_MID
         #undef TEST_MANIFEST_HEADER_POST
@@ -1485,6 +1603,38 @@ testRun(void)
         TEST_RESULT_VOID(manifestSave(manifest, ioBufferWriteNew(contentSave)), "save manifest");
         TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentLoad), "check save");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest - minimal features");
+
+        Buffer *contentPack = bufNew(0);
+        Manifest *manifestPack = NULL;
+
+        TEST_RESULT_VOID(manifestSavePack(manifest, ioBufferWriteNew(contentPack)), "save binary manifest");
+        TEST_ASSIGN(manifestPack, manifestNewLoadPack(ioBufferReadNew(contentPack), 0), "load binary manifest");
+
+        contentSave = bufNew(0);
+        TEST_RESULT_VOID(manifestSave(manifestPack, ioBufferWriteNew(contentSave)), "save manifest");
+        TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentLoad), "check save");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest - multiple file chunks");
+
+        for (unsigned int fileIdx = 0; fileIdx < 4096; fileIdx++)
+        {
+            HRN_MANIFEST_FILE_ADD(
+                manifestPack, .name = zNewFmt("pg_data/base/1/%u", fileIdx), .size = fileIdx, .timestamp = 1565282114,
+                .user = "user1", .group = "group2");
+        }
+
+        contentPack = bufNew(0);
+
+        TEST_RESULT_VOID(manifestSavePack(manifestPack, ioBufferWriteNew(contentPack)), "save binary manifest");
+        TEST_ASSIGN(manifestPack, manifestNewLoadPack(ioBufferReadNew(contentPack), 0), "load binary manifest");
+        TEST_RESULT_UINT(manifestFileTotal(manifestPack), 4097, "check file total");
+        TEST_RESULT_UINT(manifestFileFind(manifestPack, STRDEF("pg_data/base/1/4095")).size, 4095, "check last file in chunk");
+        TEST_RESULT_STR_Z(manifestFileFind(manifestPack, STRDEF("pg_data/base/1/4095")).user, "user1", "check default user");
+        TEST_RESULT_STR_Z(manifestFileFind(manifestPack, STRDEF("pg_data/base/1/4095")).group, "group2", "check group");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("manifest - all features");
 
@@ -1565,7 +1715,7 @@ testRun(void)
                 ",\"checksum-page\":false,\"checksum-page-error\":[1],\"repo-size\":4096,\"size\":8192,\"szo\":16384"             \
                 ",\"timestamp\":1565282114}\n"                                                                                     \
             "pg_data/base/16384/PG_VERSION={\"bni\":1,\"bno\":1,\"checksum\":\"184473f470864e067ee3a22e64b47b0a1c356f29\""         \
-                ",\"group\":\"group2\",\"size\":4,\"timestamp\":1565282115,\"user\":false}\n"                                      \
+                ",\"cmp\":false,\"group\":\"group2\",\"size\":4,\"timestamp\":1565282115,\"user\":false}\n"                        \
             "pg_data/base/32768/33000={\"bi\":4,\"bim\":99,\"checksum\":\"7a16d165e4775f7c92e8cdf60c0af57313f0bf90\""              \
                 ",\"checksum-page\":true,\"reference\":\"20190818-084502F\",\"size\":1073741824,\"timestamp\":1565282116}\n"       \
             "pg_data/base/32768/33000.32767={\"bi\":3,\"bic\":16,\"bim\":96"                                                       \
@@ -1846,10 +1996,49 @@ testRun(void)
             manifestFileFind(manifest, STRDEF("pg_data/special-@#!$^&*()_+~`{}[]\\:;")).name,
             "pg_data/special-@#!$^&*()_+~`{}[]\\:;", "find special file");
         TEST_RESULT_BOOL(manifestFileExists(manifest, STRDEF("bogus")), false, "manifest file does not exist");
+        TEST_RESULT_BOOL(manifestFileExists(manifest, STRDEF("pg_data/bogus/bogus")), false, "manifest file path does not exist");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file names split into path and leaf sort as full names");
+
+        Manifest *manifestName = NULL;
+
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifestName = manifestNewInternal();
+        }
+        OBJ_NEW_END();
+
+        HRN_MANIFEST_FILE_ADD(manifestName, .name = "pg_data/base/1/2");
+        HRN_MANIFEST_FILE_ADD(manifestName, .name = "zzz");
+        HRN_MANIFEST_FILE_ADD(manifestName, .name = "pg_data/base/1.5");
+        HRN_MANIFEST_FILE_ADD(manifestName, .name = "pg_data");
+        HRN_MANIFEST_FILE_ADD(manifestName, .name = "pg_data/base-x");
+        HRN_MANIFEST_FILE_ADD(manifestName, .name = "pg_data/base/1/1");
+
+        TEST_RESULT_STR_Z(manifestFileFind(manifestName, STRDEF("pg_data/base-x")).name, "pg_data/base-x", "find file unsorted");
+        TEST_RESULT_BOOL(manifestFileExists(manifestName, STRDEF("pg_data/bogus")), false, "file does not exist unsorted");
+
+        TEST_RESULT_VOID(lstSort(manifestName->pub.fileList, sortOrderAsc), "sort files");
+
+        StringList *const fileNameList = strLstNew();
+
+        for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifestName); fileIdx++)
+            strLstAdd(fileNameList, manifestFile(manifestName, fileIdx).name);
+
+        TEST_RESULT_STRLST_Z(
+            fileNameList, "pg_data\npg_data/base-x\npg_data/base/1.5\npg_data/base/1/1\npg_data/base/1/2\nzzz\n", "file order");
+        TEST_RESULT_STR_Z(manifestFileNameGet(manifestName, 0), "pg_data", "file name without path");
+        TEST_RESULT_STR_Z(manifestFileNameGet(manifestName, 3), "pg_data/base/1/1", "file name with path");
+        TEST_RESULT_UINT(lstSize(manifestName->filePathList), 3, "paths are shared");
+        TEST_RESULT_STR_Z(manifestFileFind(manifestName, STRDEF("zzz")).name, "zzz", "find file without path");
+        TEST_RESULT_STR_Z(manifestFileFind(manifestName, STRDEF("pg_data/base/1/2")).name, "pg_data/base/1/2", "find file");
+
+        manifestFree(manifestName);
 
         // Munge the sha1 checksum to be blank
         ManifestFilePack **const fileMungePack = manifestFilePackFindInternal(manifest, STRDEF("pg_data/postgresql.conf"));
-        ManifestFile fileMunge = manifestFileUnpack(manifest, *fileMungePack);
+        ManifestFile fileMunge = manifestFileUnpackP(manifest, *fileMungePack);
         fileMunge.checksumSha1 = NULL;
         manifestFilePackUpdate(manifest, fileMungePack, &fileMunge);
 
@@ -1929,6 +2118,60 @@ testRun(void)
 
         TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentCompare), "check save");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest");
+
+        contentPack = bufNew(0);
+
+        TEST_RESULT_VOID(manifestSavePack(manifest, ioBufferWriteNew(contentPack)), "save binary manifest");
+        TEST_ASSIGN(manifestPack, manifestNewLoadPack(ioBufferReadNew(contentPack), 0), "load binary manifest");
+
+        contentSave = bufNew(0);
+        TEST_RESULT_VOID(manifestSave(manifestPack, ioBufferWriteNew(contentSave)), "save manifest");
+        TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentCompare), "check save");
+
+        TEST_ASSIGN(
+            manifestPack, manifestNewLoadPack(ioBufferReadNew(contentPack), manifestSectionList), "load binary manifest sections");
+        TEST_RESULT_STR_Z(manifestData(manifestPack)->backupLabel, "20190818-084502F_20190820-084502D", "check data");
+        TEST_RESULT_UINT(manifestTargetTotal(manifestPack), manifestTargetTotal(manifest), "check targets");
+        TEST_RESULT_UINT(manifestDbTotal(manifestPack), 0, "no dbs");
+        TEST_RESULT_UINT(manifestFileTotal(manifestPack), 0, "no files");
+        TEST_RESULT_UINT(manifestLinkTotal(manifestPack), 0, "no links");
+        TEST_RESULT_UINT(manifestPathTotal(manifestPack), 0, "no paths");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest errors");
+
+        PackWrite *packWrite = pckWriteNewP();
+        pckWriteU32P(packWrite, 2);
+        pckWriteEndP(packWrite);
+
+        TEST_ERROR(
+            manifestNewLoadPack(ioBufferReadNew(pckToBuf(pckWriteResult(packWrite))), 0), FormatError,
+            "expected binary manifest format 1 but found 2");
+
+        packWrite = pckWriteNewP();
+        pckWriteU32P(packWrite, 1);
+        pckWriteEndP(packWrite);
+
+        TEST_ERROR(
+            manifestNewLoadPack(ioBufferReadNew(pckToBuf(pckWriteResult(packWrite))), 0), FormatError,
+            "binary manifest section 'data' is missing");
+
+        PackWrite *packSection = pckWriteNewP();
+        pckWriteStrP(packSection, STRDEF("bogus"));
+        pckWriteEndP(packSection);
+
+        packWrite = pckWriteNewP();
+        pckWriteU32P(packWrite, 1);
+        pckWritePackP(packWrite, pckWriteResult(packSection));
+        pckWriteU32P(packWrite, 0, .defaultWrite = true);
+        pckWriteEndP(packWrite);
+
+        TEST_ERROR(
+            manifestNewLoadPack(ioBufferReadNew(pckToBuf(pckWriteResult(packWrite))), 0), ChecksumError,
+            "binary manifest section 'data' checksum 0x02337044 does not match expected 0x00000000");
+
         TEST_RESULT_VOID(manifestFileRemove(manifest, STRDEF("pg_data/PG_VERSION")), "remove file");
         TEST_ERROR(
             manifestFileRemove(manifest, STRDEF("pg_data/PG_VERSION")), AssertError,
@@ -1961,7 +2204,7 @@ testRun(void)
         Manifest *manifest = NULL;
 
         TEST_ERROR(
-            manifestLoadFile(storageTest, BACKUP_MANIFEST_FILE_STR, cipherTypeNone, NULL), FileMissingError,
+            manifestLoadFileP(storageTest, BACKUP_MANIFEST_FILE_STR, cipherTypeNone, NULL), FileMissingError,
             "unable to load backup manifest file '" TEST_PATH "/backup.manifest' or '" TEST_PATH "/backup.manifest.copy':\n"
             "FileMissingError: unable to open missing file '" TEST_PATH "/backup.manifest' for read\n"
             "FileMissingError: unable to open missing file '" TEST_PATH "/backup.manifest.copy' for read");
@@ -2025,16 +2268,55 @@ testRun(void)
             "user=\"user1\"\n"
 
         HRN_INFO_PUT(storageTest, BACKUP_MANIFEST_FILE INFO_COPY_EXT, TEST_MANIFEST_CONTENT, .comment = "write manifest copy");
-        TEST_ASSIGN(manifest, manifestLoadFile(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load copy");
+        TEST_ASSIGN(manifest, manifestLoadFileP(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load copy");
         TEST_RESULT_UINT(manifestData(manifest)->pgSystemId, 1000000000000000094, "check file loaded");
         TEST_RESULT_STR_Z(manifestData(manifest)->backrestVersion, PROJECT_VERSION, "check backrest version");
 
         HRN_STORAGE_REMOVE(storageTest, BACKUP_MANIFEST_FILE INFO_COPY_EXT, .errorOnMissing = true);
 
         HRN_INFO_PUT(storageTest, BACKUP_MANIFEST_FILE, TEST_MANIFEST_CONTENT, .comment = "write main manifest");
-        TEST_ASSIGN(manifest, manifestLoadFile(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load main");
+        TEST_ASSIGN(manifest, manifestLoadFileP(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load main");
         TEST_RESULT_UINT(manifestData(manifest)->pgSystemId, 1000000000000000094, "check file loaded");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("load binary manifest");
+
+        manifestCipherSubPassSet(manifest, STRDEF("packpass"));
+        manifestSavePack(manifest, storageWriteIo(storageNewWriteP(storageTest, STRDEF(BACKUP_MANIFEST_PACK_FILE))));
+
+        TEST_ASSIGN(manifest, manifestLoadFileP(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load binary");
+        TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), "packpass", "check binary manifest loaded");
+        TEST_RESULT_UINT(manifestFileTotal(manifest), 1, "check files");
+        TEST_RESULT_BOOL(manifestData(manifest)->backupOptionDelta == NULL, true, "check null option");
+
+        TEST_ASSIGN(
+            manifest,
+            manifestLoadFileP(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL, .skip = manifestSectionFile),
+            "load binary without files");
+        TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), "packpass", "check binary manifest loaded");
+        TEST_RESULT_UINT(manifestFileTotal(manifest), 0, "check files");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest ignored when text manifest is missing");
+
+        HRN_STORAGE_REMOVE(storageTest, BACKUP_MANIFEST_FILE, .errorOnMissing = true);
+        HRN_INFO_PUT(storageTest, BACKUP_MANIFEST_FILE INFO_COPY_EXT, TEST_MANIFEST_CONTENT, .comment = "write manifest copy");
+
+        TEST_ASSIGN(manifest, manifestLoadFileP(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load copy");
+        TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), NULL, "check text manifest loaded");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("invalid binary manifest");
+
+        HRN_INFO_PUT(storageTest, BACKUP_MANIFEST_FILE, TEST_MANIFEST_CONTENT, .comment = "write main manifest");
+        HRN_STORAGE_PUT_Z(storageTest, BACKUP_MANIFEST_PACK_FILE, "BOGUS", .comment = "write invalid binary manifest");
+
+        TEST_ASSIGN(manifest, manifestLoadFileP(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load main");
+        TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), NULL, "check text manifest loaded");
+        TEST_RESULT_LOG(
+            "P00   WARN: unable to load binary manifest '" TEST_PATH "/backup.manifest.pack', loading text manifest instead:"
+            " [FormatError] expected binary manifest format 1 but found 0");
+
         TEST_RESULT_VOID(manifestFree(manifest), "free manifest");
         TEST_RESULT_VOID(manifestFree(NULL), "free null manifest");
     }
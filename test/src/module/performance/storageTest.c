@@ -7,6 +7,11 @@ Generally speaking, the starting values should be high enough to "blow up" in te
 problems without taking very long if everything is running smoothly. These starting values can then be scaled up for profiling and
 stress testing as needed.
 ***********************************************************************************************************************************/
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "common/harnessConfig.h"
 #include "common/harnessFork.h"
 #include "common/harnessStorage.h"
@@ -21,6 +26,7 @@ stress testing as needed.
 #include "common/io/filter/filter.h"
 #include "common/io/filter/sink.h"
 #include "common/io/io.h"
+#include "common/io/read.intern.h"
 #include "common/type/object.h"
 #include "protocol/client.h"
 #include "protocol/server.h"
@@ -110,6 +116,133 @@ testIoRateNew(uint64_t bytesPerSec)
     return ioFilterNewP(STRID5("test-io-rate", 0x2d032dbd3ba4cb40), this, NULL, .in = testIoRateProcess);
 }
 
+/***********************************************************************************************************************************
+Test driver to count bytes read into the IoRead input buffer. These bytes must be copied again to reach the caller's buffer.
+***********************************************************************************************************************************/
+typedef struct TestIoCopy
+{
+    IoRead *source;                                                 // Source to read from
+    IoRead *read;                                                   // IoRead object that owns this driver
+    uint64_t byteTotal;                                             // Total bytes read
+    uint64_t byteCopy;                                              // Bytes read into the input buffer
+} TestIoCopy;
+
+static size_t
+testIoCopyRead(THIS_VOID, Buffer *const buffer, const bool block)
+{
+    THIS(TestIoCopy);
+    (void)block;
+
+    const size_t result = ioRead(this->source, buffer);
+
+    this->byteTotal += result;
+
+    if (buffer == this->read->input)
+        this->byteCopy += result;
+
+    return result;
+}
+
+static bool
+testIoCopyEof(THIS_VOID)
+{
+    THIS(TestIoCopy);
+
+    return ioReadEof(this->source);
+}
+
+static IoRead *
+testIoCopyNew(const Buffer *const input)
+{
+    OBJ_NEW_BEGIN(TestIoCopy, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (TestIoCopy)
+        {
+            .source = ioBufferReadNewOpen(input),
+        };
+    }
+    OBJ_NEW_END();
+
+    IoRead *const result = ioReadNewP(this, .eof = testIoCopyEof, .read = testIoCopyRead);
+    this->read = result;
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Make every other MiB of a file resident in the page cache and evict the rest, simulating a file that is partly in the working set
+
+posix_fadvise() is only advice but it is reliable for clean pages on Linux, which is where the performance tests are run.
+***********************************************************************************************************************************/
+static void
+testPageCachePartial(const String *const file, const uint64_t blockTotal)
+{
+    const int fd = open(strZ(file), O_RDONLY);
+    ASSERT(fd != -1);
+
+    ASSERT(posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+
+    Buffer *const block = bufNew(1024 * 1024);
+
+    for (uint64_t blockIdx = 0; blockIdx < blockTotal; blockIdx += 2)
+        ASSERT(pread(fd, bufPtr(block), bufSize(block), (off_t)(blockIdx * bufSize(block))) == (ssize_t)bufSize(block));
+
+    bufFree(block);
+    close(fd);
+}
+
+/***********************************************************************************************************************************
+List of a file's pages that are resident in the page cache (one byte per page, low bit set when resident)
+***********************************************************************************************************************************/
+static Buffer *
+testPageCacheResident(const String *const file)
+{
+    const int fd = open(strZ(file), O_RDONLY);
+    ASSERT(fd != -1);
+
+    struct stat statFile;
+    ASSERT(fstat(fd, &statFile) == 0);
+    ASSERT(statFile.st_size > 0);
+
+    void *const map = mmap(NULL, (size_t)statFile.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ASSERT(map != MAP_FAILED);
+
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    Buffer *const result = bufNew(((size_t)statFile.st_size + pageSize - 1) / pageSize);
+    ASSERT(mincore(map, (size_t)statFile.st_size, (void *)bufPtr(result)) == 0);
+    bufUsedSet(result, bufSize(result));
+
+    munmap(map, (size_t)statFile.st_size);
+    close(fd);
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Percentage of pages resident after a read out of the pages that were (or were not) resident before the read
+***********************************************************************************************************************************/
+static unsigned int
+testPageCacheResidentPct(const Buffer *const residentBefore, const Buffer *const residentAfter, const bool resident)
+{
+    ASSERT(bufUsed(residentBefore) == bufUsed(residentAfter));
+
+    size_t pageTotal = 0;
+    size_t residentTotal = 0;
+
+    for (size_t pageIdx = 0; pageIdx < bufUsed(residentBefore); pageIdx++)
+    {
+        if ((bufPtrConst(residentBefore)[pageIdx] & 1) == resident)
+        {
+            pageTotal++;
+            residentTotal += bufPtrConst(residentAfter)[pageIdx] & 1;
+        }
+    }
+
+    ASSERT(pageTotal > 0);
+
+    return (unsigned int)(residentTotal * 100 / pageTotal);
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -252,7 +385,7 @@ testRun(void)
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioSinkNew());                                                              \
             ioWriteOpen(write);                                                                                                    \
                                                                                                                                    \
-            IoRead *read = ioBufferReadNew(input);                                                                                 \
+            IoRead *read = testIoCopyNew(input);                                                                                   \
             if (rateIn != 0)                                                                                                       \
                 ioFilterGroupAdd(ioReadFilterGroup(read), testIoRateNew(rateIn * 1000 * 1000));                                    \
             ioReadOpen(read);                                                                                                      \
@@ -264,7 +397,9 @@ testRun(void)
             ioReadClose(read);                                                                                                     \
             ioWriteClose(write);                                                                                                   \
                                                                                                                                    \
-            addTo += timeMSec() - benchMarkBegin;
+            addTo += timeMSec() - benchMarkBegin;                                                                                  \
+            byteTotal += ((TestIoCopy *)ioReadDriver(read))->byteTotal;                                                            \
+            byteCopy += ((TestIoCopy *)ioReadDriver(read))->byteCopy;
 
         // Start totals to 1ms just in case something takes 0ms to run
         uint64_t copyTotal = 1;
@@ -274,6 +409,10 @@ testRun(void)
         uint64_t gzip6Total = 1;
         uint64_t lz41Total = 1;
 
+        // Bytes read and bytes copied into the read input buffer
+        uint64_t byteTotal = 0;
+        uint64_t byteCopy = 0;
+
         for (unsigned int idx = 0; idx < iteration; idx++)
         {
             // -------------------------------------------------------------------------------------------------------------------------
@@ -325,7 +464,7 @@ testRun(void)
             MEM_CONTEXT_TEMP_BEGIN()
             {
                 BENCHMARK_BEGIN();
-                BENCHMARK_FILTER_ADD(gzCompressNew(6, false));
+                BENCHMARK_FILTER_ADD(gzCompressNew(6, false, 0));
                 BENCHMARK_END(gzip6Total);
             }
             MEM_CONTEXT_TEMP_END();
@@ -336,7 +475,7 @@ testRun(void)
             MEM_CONTEXT_TEMP_BEGIN()
             {
                 BENCHMARK_BEGIN();
-                BENCHMARK_FILTER_ADD(lz4CompressNew(1, false));
+                BENCHMARK_FILTER_ADD(lz4CompressNew(1, false, 0));
                 BENCHMARK_END(lz41Total);
             }
             MEM_CONTEXT_TEMP_END();
@@ -356,6 +495,74 @@ testRun(void)
         TEST_RESULT("sha256", sha256Total);
         TEST_RESULT("gzip -6", gzip6Total);
         TEST_RESULT("lz4 -1", lz41Total);
+
+        TEST_LOG_FMT("bytes copied per byte processed: %.2f", (double)byteCopy / (double)byteTotal);
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("benchmark page cache drop"))
+    {
+        // 4MB buffers are the current default
+        ioBufferSizeSet(4 * 1024 * 1024);
+
+        ASSERT(TEST_SCALE <= 1024 * 1024);
+        const uint64_t blockTotal = (uint64_t)16 * TEST_SCALE;
+
+        // Build the file from the sample pages. The write is synced so the pages are clean and can be dropped from the cache.
+        const Buffer *const block = storageGetP(
+            storageNewReadP(storagePosixNewP(HRN_PATH_REPO_STR), STRDEF("test/data/filecopy.table.bin")));
+        ASSERT(bufUsed(block) == 1024 * 1024);
+
+        const Storage *const storageTest = storagePosixNewP(TEST_PATH_STR, .write = true);
+        StorageWrite *const write = storageNewWriteP(storageTest, STRDEF("table"));
+        ioWriteOpen(storageWriteIo(write));
+
+        for (uint64_t blockIdx = 0; blockIdx < blockTotal; blockIdx++)
+            ioWrite(storageWriteIo(write), block);
+
+        ioWriteClose(storageWriteIo(write));
+
+        const String *const file = storagePathP(storageTest, STRDEF("table"));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("read %" PRIu64 "MiB with half the pages resident with and without page cache drop", blockTotal);
+
+        for (unsigned int pageCacheDrop = 0; pageCacheDrop <= 1; pageCacheDrop++)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                // Make half the file resident so the effect of the read on pages that were and were not resident can be reported
+                testPageCachePartial(file, blockTotal);
+                const Buffer *const residentBefore = testPageCacheResident(file);
+
+                const Storage *const storage = storagePosixNewP(TEST_PATH_STR, .pageCacheDrop = pageCacheDrop);
+
+                IoRead *const read = storageReadIo(storageNewReadP(storage, STRDEF("table")));
+                ioReadOpen(read);
+
+                IoWrite *const sink = ioBufferWriteNew(bufNew(0));
+                ioFilterGroupAdd(ioWriteFilterGroup(sink), ioSinkNew());
+                ioWriteOpen(sink);
+
+                const uint64_t timeBegin = timeMSec();
+
+                ioCopyP(read, sink);
+                ioReadClose(read);
+                ioWriteClose(sink);
+
+                // Start time at 1ms just in case something takes 0ms to run
+                const uint64_t timeTotal = timeMSec() - timeBegin + 1;
+                const Buffer *const residentAfter = testPageCacheResident(file);
+
+                TEST_LOG_FMT(
+                    "page cache drop %s: time %" PRIu64 "ms, throughput %" PRIu64 "MB/s, resident after read %u%% (previously"
+                    " resident), %u%% (previously not resident)",
+                    cvtBoolToConstZ(pageCacheDrop), timeTotal, blockTotal * 1024 * 1024 * 1000 / timeTotal / 1000000,
+                    testPageCacheResidentPct(residentBefore, residentAfter, true),
+                    testPageCacheResidentPct(residentBefore, residentAfter, false));
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
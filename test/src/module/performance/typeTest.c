@@ -233,7 +233,8 @@ testRun(void)
     }
 
     // Build/load/save a larger manifest to test performance and memory usage. The default sizing is for a "typical" large cluster
-    // but this can be scaled to test larger cluster sizes.
+    // but this can be scaled to test larger cluster sizes, e.g. --scale=10 for 1M files and --scale=100 for 10M files. The incremental
+    // build merges two manifests of this size so --scale=100 requires about 2GB of memory.
     // *****************************************************************************************************************************
     if (testBegin("manifestNewBuild()/manifestNewLoad()/manifestSave()"))
     {
@@ -271,13 +272,17 @@ testRun(void)
         MEM_CONTEXT_BEGIN(testContext)
         {
             TEST_ASSIGN(
-                manifest, manifestNewBuild(storagePg, PG_VERSION_15, 999999999, 0, false, false, false, false, NULL, NULL, NULL),
+                manifest,
+                manifestNewBuild(storagePg, PG_VERSION_15, 999999999, 0, false, false, false, false, NULL, NULL, NULL, NULL),
                 "build files");
         }
         MEM_CONTEXT_END();
 
         TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
-        // TEST_LOG_FMT("memory used %zu", memContextSize(testContext));
+#ifdef DEBUG
+        TEST_LOG_FMT(
+            "memory used %zu (%zu per file)", memContextSize(testContext), memContextSize(testContext) / driver->fileTotal);
+#endif
 
         TEST_RESULT_UINT(manifestFileTotal(manifest), driver->fileTotal, "   check file total");
 
@@ -307,7 +312,13 @@ testRun(void)
         MEM_CONTEXT_END();
 
         TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
-        // TEST_LOG_FMT("memory used %zu", memContextSize(testContext));
+
+        // Free the saved manifest so two manifests fit in memory for the incremental build at 10M files
+        bufFree(contentSave);
+#ifdef DEBUG
+        TEST_LOG_FMT(
+            "memory used %zu (%zu per file)", memContextSize(testContext), memContextSize(testContext) / driver->fileTotal);
+#endif
 
         TEST_RESULT_UINT(manifestFileTotal(manifest), driver->fileTotal, "   check file total");
 
@@ -318,11 +329,49 @@ testRun(void)
 
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
         {
-            const ManifestFile file = manifestFile(manifest, fileIdx);
-            ASSERT(strEq(file.name, manifestFileFind(manifest, file.name).name));
+            const String *const fileName = manifestFileNameGet(manifest, fileIdx);
+            CHECK(AssertError, strEq(fileName, manifestFileFind(manifest, fileName).name), "file not found");
+        }
+
+        TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("build incremental");
+
+        // Make the loaded manifest a prior backup that every file in a new build can reference
+        manifestBackupLabelSet(manifest, STRDEF("20191002-070640F"));
+
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        {
+            for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+            {
+                ManifestFile file = manifestFile(manifest, fileIdx);
+                file.checksumSha1 = bufPtrConst(HASH_TYPE_SHA1_ZERO_BUF);
+                manifestFileUpdate(manifest, &file);
+
+                MEM_CONTEXT_TEMP_RESET(1000);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        Manifest *manifestIncr = NULL;
+
+        MEM_CONTEXT_BEGIN(testContext)
+        {
+            manifestIncr = manifestNewBuild(
+                storagePg, PG_VERSION_15, 999999999, 0, false, false, false, false, NULL, NULL, NULL, NULL);
+            manifestBuildValidate(manifestIncr, false, 1570000000, compressTypeNone);
         }
+        MEM_CONTEXT_END();
+
+        timeBegin = timeMSec();
+
+        TEST_RESULT_VOID(manifestBuildIncr(manifestIncr, manifest, backupTypeIncr, NULL, NULL), "build incremental");
 
         TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
+
+        TEST_RESULT_STR_Z(
+            manifestFile(manifestIncr, manifestFileTotal(manifestIncr) - 1).reference, "20191002-070640F", "   check reference");
     }
 
     // Make sure statistics collector performs well
@@ -373,5 +422,57 @@ testRun(void)
         TEST_RESULT_UINT(strLstSize(storageListP(storageFd, NULL)), fdBefore, "socket was freed");
     }
 
+    // Compare the performance of the page checksum kernels
+    // *****************************************************************************************************************************
+    if (testBegin("pgPageChecksum()"))
+    {
+        ASSERT(TEST_SCALE <= 1000000);
+
+        // Build a 1MiB buffer of pseudo-random pages
+        #define TEST_PAGE_TOTAL 128
+        uint8_t *const pageList = memNew(TEST_PAGE_TOTAL * pgPageSize8);
+        uint32_t seed = 1;
+
+        for (unsigned int byteIdx = 0; byteIdx < TEST_PAGE_TOTAL * pgPageSize8; byteIdx++)
+        {
+            seed = seed * 1103515245 + 12345;
+            pageList[byteIdx] = (uint8_t)(seed >> 16);
+        }
+
+        const uint64_t runTotal = (uint64_t)TEST_SCALE * 100;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("checksum %" PRIu64 "MiB of 8KiB pages", runTotal * TEST_PAGE_TOTAL * pgPageSize8 / 1024 / 1024);
+
+        #define TEST_PAGE_CHECKSUM_KERNEL(name, kernel)                                                                            \
+            do                                                                                                                     \
+            {                                                                                                                      \
+                uint32_t result = 0;                                                                                               \
+                const TimeMSec timeBegin = timeMSec();                                                                             \
+                                                                                                                                   \
+                for (uint64_t runIdx = 0; runIdx < runTotal; runIdx++)                                                             \
+                    for (unsigned int pageIdx = 0; pageIdx < TEST_PAGE_TOTAL; pageIdx++)                                           \
+                        result += kernel(pageList + pageIdx * pgPageSize8, pgPageSize8);                                           \
+                                                                                                                                   \
+                /* Start time at 1ms just in case something takes 0ms to run */                                                    \
+                const TimeMSec timeTotal = timeMSec() - timeBegin + 1;                                                             \
+                                                                                                                                   \
+                TEST_LOG_FMT(                                                                                                      \
+                    "%s kernel: time %" PRIu64 "ms, throughput %" PRIu64 "MB/s, result %08x", name, timeTotal,                     \
+                    runTotal * TEST_PAGE_TOTAL * pgPageSize8 * 1000 / timeTotal / 1000000, result);                                \
+            }                                                                                                                      \
+            while (0)
+
+        TEST_PAGE_CHECKSUM_KERNEL("scalar", pgPageChecksumScalar);
+
+#ifdef HAVE_CPU_X86_SIMD
+        if (__builtin_cpu_supports("sse4.1"))
+            TEST_PAGE_CHECKSUM_KERNEL("sse4.1", pgPageChecksumSse41);
+
+        if (__builtin_cpu_supports("avx2"))
+            TEST_PAGE_CHECKSUM_KERNEL("avx2", pgPageChecksumAvx2);
+#endif
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
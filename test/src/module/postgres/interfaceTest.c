@@ -441,9 +441,166 @@ testRun(void)
             TEST_ERROR(
                 pgPageChecksum(page, 0, sizeof(page)), FormatError,
                 "page size is 65536 but only 1024, 2048, 4096, 8192, 16384, and 32768 are supported");
+            TEST_ERROR(
+                pgPageChecksumScalar(page, sizeof(page)), FormatError,
+                "page size is 65536 but only 1024, 2048, 4096, 8192, 16384, and 32768 are supported");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("slicing tables match the lookup table");
+
+        for (unsigned int idx = 0; idx < 256; idx++)
+        {
+            uint32_t value = crc32c_lookup[idx];
+
+            for (unsigned int tableIdx = 0; tableIdx < LENGTH_OF(crc32cSliceTable); tableIdx++)
+            {
+                value = crc32c_lookup[value & 0xFF] ^ (value >> 8);
+
+                if (crc32cSliceTable[tableIdx][idx] != value)
+                {
+                    THROW_FMT(
+                        AssertError, "slicing table %u entry %u is 0x%08x but expected 0x%08x", tableIdx, idx,
+                        crc32cSliceTable[tableIdx][idx], value);
+                }
+            }
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("select kernel");
+
+        TEST_RESULT_BOOL(pgPageChecksumKernelSelect(false, false) == pgPageChecksumScalar, true, "scalar");
+
+#ifdef HAVE_CPU_X86_SIMD
+        TEST_RESULT_BOOL(pgPageChecksumKernelSelect(false, true) == pgPageChecksumSse41, true, "sse4.1");
+        TEST_RESULT_BOOL(pgPageChecksumKernelSelect(true, true) == pgPageChecksumAvx2, true, "avx2");
+#endif
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("kernels calculate the same checksum");
+        {
+            // Fill page with pseudo-random data
+            uint8_t page[pgPageSize32];
+            uint32_t seed = 1;
+
+            for (unsigned int pageIdx = 0; pageIdx < sizeof(page); pageIdx++)
+            {
+                seed = seed * 1103515245 + 12345;
+                page[pageIdx] = (uint8_t)(seed >> 16);
+            }
+
+            // The checksum is calculated with pd_checksum set to zero
+            ((PageHeaderData *)page)->pd_checksum = 0;
+
+            const PgPageSize pageSizeList[] = {pgPageSize1, pgPageSize2, pgPageSize4, pgPageSize8, pgPageSize16, pgPageSize32};
+
+            for (unsigned int pageSizeIdx = 0; pageSizeIdx < LENGTH_OF(pageSizeList); pageSizeIdx++)
+            {
+                const PgPageSize pageSize = pageSizeList[pageSizeIdx];
+                const uint32_t expected = pgPageChecksumScalar(page, pageSize);
+
+                TEST_RESULT_UINT(
+                    pgPageChecksum(page, 0, pageSize), expected % 65535 + 1, zNewFmt("%u page with selected kernel", pageSize));
+
+#ifdef HAVE_CPU_X86_SIMD
+                if (__builtin_cpu_supports("sse4.1"))
+                {
+                    TEST_RESULT_UINT(
+                        pgPageChecksumSse41(page, pageSize), expected, zNewFmt("%u page with sse4.1 kernel", pageSize));
+                }
+
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    TEST_RESULT_UINT(
+                        pgPageChecksumAvx2(page, pageSize), expected, zNewFmt("%u page with avx2 kernel", pageSize));
+                }
+#endif
+            }
         }
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("crc32cOne() and crc32cUpdate()"))
+    {
+        TEST_TITLE("check value");
+
+        TEST_RESULT_UINT(crc32cOne((const uint8_t *)"123456789", 9), 0xE3069283, "crc32c");
+        TEST_RESULT_UINT(crc32cOne((const uint8_t *)"", 0), 0, "crc32c empty");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("slicing tables match the lookup table");
+
+        for (unsigned int idx = 0; idx < 256; idx++)
+        {
+            uint32_t value = crc32c_lookup[idx];
+
+            for (unsigned int tableIdx = 0; tableIdx < LENGTH_OF(crc32cSliceTable); tableIdx++)
+            {
+                value = crc32c_lookup[value & 0xFF] ^ (value >> 8);
+
+                if (crc32cSliceTable[tableIdx][idx] != value)
+                {
+                    THROW_FMT(
+                        AssertError, "slicing table %u entry %u is 0x%08x but expected 0x%08x", tableIdx, idx,
+                        crc32cSliceTable[tableIdx][idx], value);
+                }
+            }
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("select kernel");
+
+        TEST_RESULT_BOOL(crc32cKernelSelect(false) == crc32cSlice8, true, "slicing-by-8");
+
+#ifdef HAVE_CPU_X86_CRC32C
+        TEST_RESULT_BOOL(crc32cKernelSelect(true) == crc32cSse42, true, "sse4.2");
+#endif
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("kernels calculate the same crc");
+        {
+            // Fill data with pseudo-random bytes
+            uint8_t data[1024];
+            uint32_t seed = 1;
+
+            for (unsigned int dataIdx = 0; dataIdx < sizeof(data); dataIdx++)
+            {
+                seed = seed * 1103515245 + 12345;
+                data[dataIdx] = (uint8_t)(seed >> 16);
+            }
+
+            // Check all alignments and sizes that do not fill a complete eight byte block
+            for (unsigned int offset = 0; offset < 8; offset++)
+            {
+                for (unsigned int size = 0; size < 24; size++)
+                {
+                    const uint32_t expected = crc32cByte(CRC32C_INIT, data + offset, size);
+
+                    if (crc32cSlice8(CRC32C_INIT, data + offset, size) != expected)
+                        THROW_FMT(AssertError, "slicing-by-8 mismatch at offset %u, size %u", offset, size);
+
+#ifdef HAVE_CPU_X86_CRC32C
+                    if (__builtin_cpu_supports("sse4.2") && crc32cSse42(CRC32C_INIT, data + offset, size) != expected)
+                        THROW_FMT(AssertError, "sse4.2 mismatch at offset %u, size %u", offset, size);
+#endif
+                }
+            }
+
+            // Check a larger size
+            const uint32_t expected = crc32cByte(CRC32C_INIT, data + 1, sizeof(data) - 1);
+
+            TEST_RESULT_UINT(crc32cSlice8(CRC32C_INIT, data + 1, sizeof(data) - 1), expected, "slicing-by-8");
+
+#ifdef HAVE_CPU_X86_CRC32C
+            if (__builtin_cpu_supports("sse4.2"))
+                TEST_RESULT_UINT(crc32cSse42(CRC32C_INIT, data + 1, sizeof(data) - 1), expected, "sse4.2");
+#endif
+
+            TEST_RESULT_UINT(crc32cUpdate(CRC32C_INIT, data + 1, sizeof(data) - 1), expected, "selected kernel");
+        }
+
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("pgWalFromBuffer() and pgWalFromFile()"))
     {
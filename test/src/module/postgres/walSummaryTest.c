@@ -0,0 +1,283 @@
+/***********************************************************************************************************************************
+Test PostgreSQL WAL Summary
+***********************************************************************************************************************************/
+#include "common/io/bufferRead.h"
+
+/***********************************************************************************************************************************
+Build a WAL summary. Each entry gets one chunk per chunkTotal with chunkSize entries in each chunk. The entries are taken from
+chunkData or are 0 to chunkSize - 1 when chunkData is NULL.
+***********************************************************************************************************************************/
+static Buffer *
+testWalSummary(
+    const WalSummaryEntry *const entryList, const unsigned int entryTotal, const uint16_t chunkSize,
+    const uint16_t *const chunkData)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM_P(VOID, entryList);
+        FUNCTION_HARNESS_PARAM(UINT, entryTotal);
+        FUNCTION_HARNESS_PARAM(UINT, chunkSize);
+        FUNCTION_HARNESS_PARAM_P(VOID, chunkData);
+    FUNCTION_HARNESS_END();
+
+    Buffer *const result = bufNew(0);
+    const uint32_t magic = WAL_SUMMARY_MAGIC;
+
+    bufCatC(result, (const unsigned char *)&magic, 0, sizeof(magic));
+
+    for (unsigned int entryIdx = 0; entryIdx <= entryTotal; entryIdx++)
+    {
+        // Add the terminating entry after the last entry
+        const WalSummaryEntry entry = entryIdx == entryTotal ? (WalSummaryEntry){0} : entryList[entryIdx];
+
+        bufCatC(result, (const unsigned char *)&entry, 0, sizeof(entry));
+
+        for (uint32_t chunkIdx = 0; chunkIdx < entry.chunkTotal; chunkIdx++)
+            bufCatC(result, (const unsigned char *)&chunkSize, 0, sizeof(chunkSize));
+
+        for (uint32_t chunkIdx = 0; chunkIdx < entry.chunkTotal; chunkIdx++)
+        {
+            for (uint16_t chunkEntryIdx = 0; chunkEntryIdx < chunkSize; chunkEntryIdx++)
+            {
+                const uint16_t chunkEntry = chunkData == NULL ? chunkEntryIdx : chunkData[chunkEntryIdx];
+                bufCatC(result, (const unsigned char *)&chunkEntry, 0, sizeof(chunkEntry));
+            }
+        }
+    }
+
+    const uint32_t crc = crc32cUpdate(CRC32C_INIT, bufPtrConst(result), bufUsed(result)) ^ CRC32C_INIT;
+
+    bufCatC(result, (const unsigned char *)&crc, 0, sizeof(crc));
+
+    FUNCTION_HARNESS_RETURN(BUFFER, result);
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("walSummaryFileList()"))
+    {
+        TEST_TITLE("empty list");
+
+        TEST_RESULT_STRLST_Z(walSummaryFileList(strLstNew(), 1, 0x1000000, 0x1000000), NULL, "empty range");
+        TEST_RESULT_PTR(walSummaryFileList(strLstNew(), 1, 0x1000000, 0x2000000), NULL, "range not covered");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("range covered");
+
+        StringList *const fileList = strLstNew();
+        strLstAddZ(fileList, "0000000100000000010000280000000001800000.summary");
+        strLstAddZ(fileList, "0000000100000000018000000000000002000028.summary");
+        strLstAddZ(fileList, "0000000100000000010000280000000001400000.summary");
+        strLstAddZ(fileList, "0000000200000000018000000000000003000000.summary");
+        strLstAddZ(fileList, "0000000100000000020000280000000003000000.summary");
+
+        TEST_RESULT_STRLST_Z(
+            walSummaryFileList(fileList, 1, 0x1000028, 0x2000000),
+            "0000000100000000010000280000000001800000.summary\n0000000100000000018000000000000002000028.summary\n",
+            "range covered by two files");
+        TEST_RESULT_STRLST_Z(
+            walSummaryFileList(fileList, 1, 0x1400000, 0x2800000),
+            "0000000100000000010000280000000001800000.summary\n0000000100000000018000000000000002000028.summary\n"
+            "0000000100000000020000280000000003000000.summary\n",
+            "range covered by overlapping files");
+        TEST_RESULT_STRLST_Z(
+            walSummaryFileList(fileList, 2, 0x1800000, 0x2000000), "0000000200000000018000000000000003000000.summary\n",
+            "range covered on timeline 2");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("range not covered");
+
+        TEST_RESULT_PTR(walSummaryFileList(fileList, 1, 0x1000000, 0x2000000), NULL, "start not covered");
+        TEST_RESULT_PTR(walSummaryFileList(fileList, 1, 0x1000028, 0x3000001), NULL, "end not covered");
+        TEST_RESULT_PTR(walSummaryFileList(fileList, 2, 0x1000028, 0x2000000), NULL, "not covered on timeline 2");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("walSummaryRead()"))
+    {
+        TEST_TITLE("invalid magic");
+
+        WalSummary *walSummary = NULL;
+
+        TEST_ASSIGN(walSummary, walSummaryNew(pgPageSize8), "new");
+
+        Buffer *buffer = testWalSummary(NULL, 0, 0, NULL);
+        *(uint32_t *)bufPtr(buffer) = 0;
+
+        TEST_ERROR(walSummaryRead(walSummary, ioBufferReadNew(buffer)), FormatError, "WAL summary magic 0x00000000 is invalid");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("unexpected eof");
+
+        buffer = testWalSummary(NULL, 0, 0, NULL);
+        bufUsedSet(buffer, bufUsed(buffer) - 1);
+
+        TEST_ERROR(walSummaryRead(walSummary, ioBufferReadNew(buffer)), FormatError, "unexpected eof in WAL summary");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("invalid crc");
+
+        buffer = testWalSummary(NULL, 0, 0, NULL);
+        *(uint32_t *)(bufPtr(buffer) + bufUsed(buffer) - sizeof(uint32_t)) = 0;
+
+        TEST_ERROR(
+            walSummaryRead(walSummary, ioBufferReadNew(buffer)), FormatError,
+            "WAL summary crc 0x00000000 does not match expected 0x4b1671b8");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("invalid chunk size");
+
+        buffer = testWalSummary(
+            (const WalSummaryEntry []){{.spcOid = 1663, .dbOid = 1, .relNumber = 1, .chunkTotal = 1}}, 1,
+            WAL_SUMMARY_CHUNK_ENTRY_MAX + 1, NULL);
+
+        TEST_ERROR(walSummaryRead(walSummary, ioBufferReadNew(buffer)), FormatError, "WAL summary chunk size 4097 is invalid");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read summaries");
+
+        // With 8KiB pages each segment spans two chunks, so chunks 0-1 are in segment 0 and chunk 2 is in segment 1
+        TEST_ASSIGN(walSummary, walSummaryNew(pgPageSize8), "new");
+        TEST_RESULT_VOID(
+            walSummaryRead(
+                walSummary,
+                ioBufferReadNew(
+                    testWalSummary(
+                        (const WalSummaryEntry [])
+                        {
+                            {.spcOid = 1663, .dbOid = 16384, .relNumber = 16385, .limitBlock = 300000, .chunkTotal = 3},
+                            {.spcOid = 1664, .relNumber = 1262, .forkNum = 2, .limitBlock = 262144},
+                        },
+                        2, 3, NULL))),
+            "read summary");
+
+        // Bitmap chunks where the first word has no blocks set
+        TEST_RESULT_VOID(
+            walSummaryRead(
+                walSummary,
+                ioBufferReadNew(
+                    testWalSummary(
+                        (const WalSummaryEntry [])
+                        {
+                            {.spcOid = 16400, .dbOid = 16384, .relNumber = 16401, .limitBlock = 0xFFFFFFFF, .chunkTotal = 1},
+                            {.spcOid = 1663, .dbOid = 16384, .relNumber = 16385, .limitBlock = 0xFFFFFFFF, .chunkTotal = 1},
+                            {.spcOid = 1664, .relNumber = 1262, .forkNum = 2, .limitBlock = 131072},
+                        },
+                        3, WAL_SUMMARY_CHUNK_ENTRY_MAX, NULL))),
+            "read summary");
+
+        // Empty chunk
+        TEST_RESULT_VOID(
+            walSummaryRead(
+                walSummary,
+                ioBufferReadNew(
+                    testWalSummary(
+                        (const WalSummaryEntry []){{.spcOid = 1663, .dbOid = 1, .relNumber = 1259, .chunkTotal = 1}}, 1, 0,
+                        NULL))),
+            "read summary");
+
+        TEST_RESULT_UINT(lstSize(walSummary->forkList), 4, "fork total");
+        TEST_RESULT_UINT(
+            ((WalSummaryFork *)lstFind(
+                walSummary->forkList, &(WalSummaryRelation){.spcOid = 1663, .dbOid = 16384, .relNumber = 16385}))->segmentLimit,
+            2, "lowest segment limit");
+        TEST_RESULT_UINT(
+            ((WalSummaryFork *)lstFind(
+                walSummary->forkList, &(WalSummaryRelation){.spcOid = 1664, .relNumber = 1262, .forkNum = 2}))->segmentLimit,
+            1, "lowest segment limit");
+        TEST_RESULT_UINT(
+            ((WalSummaryFork *)lstFind(
+                walSummary->forkList, &(WalSummaryRelation){.spcOid = 16400, .dbOid = 16384, .relNumber = 16401}))->segmentLimit,
+            UINT32_MAX, "no segment limit");
+        TEST_RESULT_UINT(lstSize(walSummary->segmentList), 3, "segment total");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("free");
+
+        TEST_RESULT_VOID(walSummaryFree(walSummary), "free");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("walSummaryModified()"))
+    {
+        WalSummary *walSummary = NULL;
+
+        TEST_ASSIGN(walSummary, walSummaryNew(pgPageSize8), "new");
+        TEST_RESULT_VOID(
+            walSummaryRead(
+                walSummary,
+                ioBufferReadNew(
+                    testWalSummary(
+                        (const WalSummaryEntry [])
+                        {
+                            {.spcOid = 1663, .dbOid = 16384, .relNumber = 16385, .limitBlock = 0xFFFFFFFF, .chunkTotal = 1},
+                            {.spcOid = 1663, .dbOid = 16384, .relNumber = 16386, .forkNum = 2},
+                            {.spcOid = 1664, .relNumber = 1262, .limitBlock = 262144},
+                            {.spcOid = 16400, .dbOid = 16384, .relNumber = 16401},
+                        },
+                        4, 1, NULL))),
+            "read summary");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("modified relation segments");
+
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16385")), true, "main fork block modified");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16386_vm")), true, "vm fork created");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16386_vm.1")), true, "vm fork created segment");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("global/1262.2")), true, "global truncated");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("global/1262.3")), true, "global after truncated");
+        TEST_RESULT_BOOL(
+            walSummaryModified(walSummary, STRDEF("pg_tblspc/16400/PG_17_202406281/16384/16401")), true, "tablespace");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("unmodified relation segments");
+
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16385.1")), false, "main fork segment");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16385_vm")), false, "vm fork");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16386")), false, "main fork");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16386.2")), false, "main fork segment");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/1/16385")), false, "other database");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("global/1262.1")), false, "global before truncated");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("global/1260")), false, "global");
+        TEST_RESULT_BOOL(
+            walSummaryModified(walSummary, STRDEF("pg_tblspc/16400/PG_17_202406281/16384/16385")), false, "tablespace");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("files that are always modified");
+
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16387_fsm")), true, "fsm fork");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16387_init")), true, "init fork");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/PG_VERSION")), true, "not a relation");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("global/pg_control")), true, "pg_control");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("postgresql.conf")), true, "not in a database");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("chunk spans segments with 32KiB pages");
+
+        TEST_ASSIGN(walSummary, walSummaryNew(pgPageSize32), "new");
+        TEST_RESULT_VOID(
+            walSummaryRead(
+                walSummary,
+                ioBufferReadNew(
+                    testWalSummary(
+                        (const WalSummaryEntry [])
+                        {
+                            {.spcOid = 1663, .dbOid = 16384, .relNumber = 16385, .limitBlock = 0xFFFFFFFF, .chunkTotal = 1},
+                        },
+                        1, 4, (const uint16_t []){40000, 0, 32767, 32768}))),
+            "read summary");
+
+        TEST_RESULT_UINT(lstSize(walSummary->segmentList), 2, "segment total");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16385")), true, "segment 0");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16385.1")), true, "segment 1");
+        TEST_RESULT_BOOL(walSummaryModified(walSummary, STRDEF("base/16384/16385.2")), false, "segment 2");
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
@@ -32,6 +32,7 @@ typedef struct TestRequestParam
     VAR_PARAM_HEADER;
     const char *content;
     const char *blobType;
+    const char *ifMatch;
     const char *range;
     const char *tag;
 } TestRequestParam;
@@ -87,6 +88,10 @@ testRequest(IoWrite *write, const char *verb, const char *path, TestRequestParam
     // Add host
     strCatFmt(request, "host:%s\r\n", strZ(hrnServerHost()));
 
+    // Add if-match
+    if (param.ifMatch != NULL)
+        strCatFmt(request, "if-match:%s\r\n", param.ifMatch);
+
     // Add range
     if (param.range != NULL)
         strCatFmt(request, "range:bytes=%s\r\n", param.range);
@@ -209,6 +214,9 @@ testRun(void)
         TEST_RESULT_STR_Z(((StorageAzure *)storageDriver(storage))->host, TEST_ACCOUNT ".blob.core.windows.net", "check host");
         TEST_RESULT_STR_Z(((StorageAzure *)storageDriver(storage))->pathPrefix, "/" TEST_CONTAINER, "check path prefix");
         TEST_RESULT_UINT(((StorageAzure *)storageDriver(storage))->blockSize, 4 * 1024 * 1024, "check block size");
+        TEST_RESULT_UINT(((StorageAzure *)storageDriver(storage))->blockMax, 1, "check block max");
+        TEST_RESULT_UINT(((StorageAzure *)storageDriver(storage))->rangeSize, 16 * 1024 * 1024, "check range size");
+        TEST_RESULT_UINT(((StorageAzure *)storageDriver(storage))->rangeMax, 1, "check range max");
         TEST_RESULT_BOOL(storageFeature(storage, storageFeaturePath), false, "check path feature");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -398,8 +406,8 @@ testRun(void)
             (StorageAzure *)storageDriver(
                 storageAzureNew(
                     STRDEF("/repo"), false, 0, NULL, TEST_CONTAINER_STR, TEST_ACCOUNT_STR, storageAzureKeyTypeShared,
-                    TEST_KEY_SHARED_STR, 16, NULL, STRDEF("blob.core.windows.net"), storageAzureUriStyleHost, 443, 1000, true, NULL,
-                    NULL)),
+                    TEST_KEY_SHARED_STR, 16, 1, 16, 1, NULL, STRDEF("blob.core.windows.net"), storageAzureUriStyleHost, 443, 1000,
+                    true, NULL, NULL)),
             "new azure storage - shared key");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -415,6 +423,21 @@ testRun(void)
             ", x-ms-version: '2021-06-08', authorization: 'SharedKey account:2HRoJbu+G0rqwMjG+6gsb8WWkVo9rJNrDywsrnkmQAE='}",
             "check headers");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("auth with if-match");
+
+        header = httpHeaderAdd(httpHeaderNew(NULL), HTTP_HEADER_CONTENT_LENGTH_STR, ZERO_STR);
+        httpHeaderAdd(header, HTTP_HEADER_IF_MATCH_STR, STRDEF("\"E1\""));
+
+        TEST_RESULT_VOID(storageAzureAuth(storage, HTTP_VERB_GET_STR, STRDEF("/path"), NULL, dateTime, header), "auth");
+        TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(header, httpHeaderToLog, logBuf, sizeof(logBuf)), "httpHeaderToLog");
+        TEST_RESULT_Z(
+            logBuf,
+            "{content-length: '0', if-match: '\"E1\"', host: 'account.blob.core.windows.net'"
+            ", date: 'Sun, 21 Jun 2020 12:46:19 GMT', x-ms-version: '2021-06-08'"
+            ", authorization: 'SharedKey account:T4GwtzJlveLJ2vlByIsXd/jdhTYjaOUH/MQ9vMnCvbs='}",
+            "check headers");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("auth with md5 and query");
 
@@ -440,7 +463,8 @@ testRun(void)
             (StorageAzure *)storageDriver(
                 storageAzureNew(
                     STRDEF("/repo"), false, 0, NULL, TEST_CONTAINER_STR, TEST_ACCOUNT_STR, storageAzureKeyTypeSas, TEST_KEY_SAS_STR,
-                    16, NULL, STRDEF("blob.core.usgovcloudapi.net"), storageAzureUriStyleHost, 443, 1000, true, NULL, NULL)),
+                    16, 1, 16, 1, NULL, STRDEF("blob.core.usgovcloudapi.net"), storageAzureUriStyleHost, 443, 1000, true, NULL,
+                    NULL)),
             "new azure storage - sas key");
 
         query = httpQueryAdd(httpQueryNewP(), STRDEF("a"), STRDEF("b"));
@@ -535,6 +559,118 @@ testRun(void)
                 TEST_RESULT_STR_Z(
                     strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file0.txt")))), "", "get zero-length file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file in ranges");
+
+                driver->rangeSize = 8;
+                driver->rangeMax = 2;
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "0-7");
+                testResponseP(service, .code = 206, .content = "this is ");
+
+                // The second range is requested on a new connection while the first range is being read
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "8-15");
+
+                // The third range is requested on the first connection once the first range has been read
+                hrnServerScriptSession(service, 0);
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "16-20");
+
+                hrnServerScriptSession(service, 1);
+                testResponseP(service, .code = 206, .content = "a sample");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptSession(service, 0);
+                testResponseP(service, .code = 206, .content = " file");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(21)))),
+                    "this is a sample file", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file smaller than a range");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt");
+                testResponseP(service, .content = "this");
+
+                TEST_RESULT_STR_Z(strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt")))), "this", "get file");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "0-3");
+                testResponseP(service, .code = 206, .content = "this");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(4)))), "this",
+                    "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file in ranges pinned to the etag of the first response");
+
+                driver->rangeSize = 4;
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "0-3");
+                testResponseP(service, .code = 206, .header = "etag:\"E1\"", .content = "this");
+
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "4-6", .ifMatch = "\"E1\"");
+                testResponseP(service, .code = 206, .content = " is");
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(7)))), "this is",
+                    "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error when file changes between ranges");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "0-3");
+                testResponseP(service, .code = 206, .header = "etag:\"E1\"", .content = "this");
+
+                hrnServerScriptSession(service, 1);
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "4-6", .ifMatch = "\"E1\"");
+                testResponseP(service, .code = 412, .content = "");
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_ERROR(
+                    storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(7))), FileReadError,
+                    "unable to read file '/file.txt' because it changed during read");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error on range request");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "0-3");
+                testResponseP(service, .code = 206, .content = "this");
+
+                hrnServerScriptSession(service, 1);
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "4-6");
+                testResponseP(service, .code = 403, .header = "connection:close", .content = "");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_ERROR_FMT(
+                    storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(7))), ProtocolError,
+                    "HTTP request failed with 403 (Forbidden):\n"
+                    "*** Path/Query ***:\n"
+                    "GET /account/container/file.txt\n"
+                    "*** Request Headers ***:\n"
+                    "authorization: <redacted>\n"
+                    "content-length: 0\n"
+                    "date: <redacted>\n"
+                    "host: %s\n"
+                    "range: bytes=4-6\n"
+                    "x-ms-version: 2021-06-08\n"
+                    "*** Response Headers ***:\n"
+                    "connection: close\n"
+                    "content-length: 0",
+                    strZ(hrnServerHost()));
+
+                driver->rangeSize = 16 * 1024 * 1024;
+                driver->rangeMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("non-404 error");
 
@@ -896,6 +1032,55 @@ testRun(void)
                     "test3.txt\n",
                     .level = storageInfoLevelExists, .noRecurse = true, .expression = "^test(1|3)");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("write file in chunks with concurrent block uploads");
+
+                driver->blockMax = 2;
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000000&comp=block", .content = "1234567890123456");
+
+                // The second block is sent on a new connection while the first block is still in flight
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000001&comp=block", .content = "7890123456789012");
+
+                // The third block waits for the first block to complete and then reuses its connection
+                hrnServerScriptSession(service, 0);
+                testResponseP(service);
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000002&comp=block", .content = "3456");
+
+                hrnServerScriptSession(service, 1);
+                testResponseP(service);
+
+                hrnServerScriptSession(service, 0);
+                testResponseP(service);
+
+                hrnServerScriptSession(service, 1);
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?comp=blocklist",
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<BlockList>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000000</Uncommitted>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000001</Uncommitted>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000002</Uncommitted>"
+                        "</BlockList>\n");
+                testResponseP(service);
+
+                hrnServerScriptClose(service);
+                hrnServerScriptSession(service, 0);
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
+                TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("123456789012345678901234567890123456")), "write");
+
+                driver->blockMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("switch to SAS auth");
 
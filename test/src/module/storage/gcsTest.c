@@ -241,6 +241,8 @@ testRun(void)
         TEST_RESULT_STR(((StorageGcs *)storageDriver(storage))->bucket, TEST_BUCKET_STR, "check bucket");
         TEST_RESULT_STR_Z(((StorageGcs *)storageDriver(storage))->endpoint, "storage.googleapis.com", "check endpoint");
         TEST_RESULT_UINT(((StorageGcs *)storageDriver(storage))->chunkSize, 4 * 1024 * 1024, "check chunk size");
+        TEST_RESULT_UINT(((StorageGcs *)storageDriver(storage))->rangeSize, 16 * 1024 * 1024, "check range size");
+        TEST_RESULT_UINT(((StorageGcs *)storageDriver(storage))->rangeMax, 1, "check range max");
         TEST_RESULT_STR(((StorageGcs *)storageDriver(storage))->token, TEST_TOKEN_STR, "check token");
         TEST_RESULT_BOOL(storageFeature(storage, storageFeaturePath), false, "check path feature");
     }
@@ -260,7 +262,7 @@ testRun(void)
             (StorageGcs *)storageDriver(
                 storageGcsNew(
                     STRDEF("/repo"), false, 0, NULL, TEST_BUCKET_STR, storageGcsKeyTypeService, TEST_KEY_FILE_STR, TEST_CHUNK_SIZE,
-                    NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL, NULL)),
+                    TEST_CHUNK_SIZE, 1, NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL, NULL)),
             "read-only gcs storage - service key");
         TEST_RESULT_STR_Z(httpUrlHost(storage->authUrl), "test.com", "check host");
         TEST_RESULT_STR_Z(httpUrlPath(storage->authUrl), "/token", "check path");
@@ -285,7 +287,7 @@ testRun(void)
             (StorageGcs *)storageDriver(
                 storageGcsNew(
                     STRDEF("/repo"), true, 0, NULL, TEST_BUCKET_STR, storageGcsKeyTypeService, TEST_KEY_FILE_STR, TEST_CHUNK_SIZE,
-                    NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL, NULL)),
+                    TEST_CHUNK_SIZE, 1, NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL, NULL)),
             "read/write gcs storage - service key");
 
         TEST_RESULT_STR_Z(
@@ -445,6 +447,118 @@ testRun(void)
                     strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
                     "this is a sample file", "get file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file in ranges");
+
+                ((StorageGcs *)storageDriver(storage))->rangeSize = 8;
+                ((StorageGcs *)storageDriver(storage))->rangeMax = 2;
+
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "0-7");
+                testResponseP(service, .code = 206, .content = "this is ");
+
+                // The second range is requested on a new connection while the first range is being read
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "8-15");
+
+                // The third range is requested on the first connection once the first range has been read
+                hrnServerScriptSession(service, 0);
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "16-20");
+
+                hrnServerScriptSession(service, 1);
+                testResponseP(service, .code = 206, .content = "a sample");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptSession(service, 0);
+                testResponseP(service, .code = 206, .content = " file");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(21)))),
+                    "this is a sample file", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file smaller than a range");
+
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media");
+                testResponseP(service, .content = "this");
+
+                TEST_RESULT_STR_Z(strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt")))), "this", "get file");
+
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "0-3");
+                testResponseP(service, .code = 206, .content = "this");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(4)))), "this",
+                    "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file in ranges pinned to the generation of the first response");
+
+                ((StorageGcs *)storageDriver(storage))->rangeSize = 4;
+
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "0-3");
+                testResponseP(service, .code = 206, .header = "x-goog-generation:1234", .content = "this");
+
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+                testRequestP(
+                    service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media&ifGenerationMatch=1234", .range = "4-6");
+                testResponseP(service, .code = 206, .content = " is");
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(7)))), "this is",
+                    "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error when file changes between ranges");
+
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "0-3");
+                testResponseP(service, .code = 206, .header = "x-goog-generation:1234", .content = "this");
+
+                hrnServerScriptSession(service, 1);
+                testRequestP(
+                    service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media&ifGenerationMatch=1234", .range = "4-6");
+                testResponseP(service, .code = 412, .content = "");
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_ERROR(
+                    storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(7))), FileReadError,
+                    "unable to read file '/file.txt' because it changed during read");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error on range request");
+
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "0-3");
+                testResponseP(service, .code = 206, .content = "this");
+
+                hrnServerScriptSession(service, 1);
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "4-6");
+                testResponseP(service, .code = 403, .header = "connection:close", .content = "");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_ERROR_FMT(
+                    storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(7))), ProtocolError,
+                    "HTTP request failed with 403 (Forbidden):\n"
+                    "*** Path/Query ***:\n"
+                    "GET /storage/v1/b/bucket/o/file.txt?alt=media\n"
+                    "*** Request Headers ***:\n"
+                    "authorization: <redacted>\n"
+                    "content-length: 0\n"
+                    "host: %s\n"
+                    "range: bytes=4-6\n"
+                    "*** Response Headers ***:\n"
+                    "connection: close\n"
+                    "content-length: 0",
+                    strZ(hrnServerHost()));
+
+                ((StorageGcs *)storageDriver(storage))->rangeSize = 16 * 1024 * 1024;
+                ((StorageGcs *)storageDriver(storage))->rangeMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("switch to auto auth");
 
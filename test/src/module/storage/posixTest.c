@@ -1029,6 +1029,50 @@ testRun(void)
         TEST_RESULT_VOID(storageWritePosixClose(ioWriteDriver(storageWriteIo(file))), "close file again");
         TEST_RESULT_INT(storageInfoP(storageTest, strPath(fileName)).mode, 0700, "check path mode");
         TEST_RESULT_INT(storageInfoP(storageTest, fileName).mode, 0600, "check file mode");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write file - sparse");
+
+        // Data followed by zeroes that span file system blocks, a block that begins with a zero but contains data, and zeroes at
+        // the end of the file
+        Buffer *const sparse = bufNew(4 + 12284 + 4 + 5000);
+        memset(bufPtr(sparse), 0, bufSize(sparse));
+        memcpy(bufPtr(sparse), "data", 4);
+        memcpy(bufPtr(sparse) + 4 + 12284 + 1, "end", 3);
+        bufUsedSet(sparse, bufSize(sparse));
+
+        fileName = STRDEF(TEST_PATH "/sub2/sparse");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageTest, fileName, .noAtomic = true, .sparse = true), "new write file (sparse)");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+        TEST_RESULT_VOID(storageWritePosix(ioWriteDriver(storageWriteIo(file)), BUF(bufPtr(sparse), 4)), "write data");
+        TEST_RESULT_VOID(
+            storageWritePosix(ioWriteDriver(storageWriteIo(file)), BUF(bufPtr(sparse) + 4, bufUsed(sparse) - 4)),
+            "write zeroes and data");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close file");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageTest, fileName)), sparse), true, "check file contents");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write file - preallocate");
+
+        fileName = STRDEF(TEST_PATH "/sub2/preallocate");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageTest, fileName, .preallocate = 8192), "new write file (preallocate)");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+        TEST_RESULT_UINT(
+            storageInfoP(storageTest, strNewFmt("%s." STORAGE_FILE_TEMP_EXT, strZ(fileName))).size, 8192, "check temp size");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(file), BUFSTRDEF("TESTDATA")), "write data");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close file");
+        TEST_RESULT_UINT(storageInfoP(storageTest, fileName).size, 8192, "check size");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write file - preallocate error");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageTest, fileName, .preallocate = UINT64_MAX), "new write file (preallocate)");
+        TEST_ERROR_FMT(
+            ioWriteOpen(storageWriteIo(file)), FileWriteError,
+            "unable to preallocate %" PRIu64 " bytes for '%s." STORAGE_FILE_TEMP_EXT "': [22] Invalid argument", UINT64_MAX,
+            strZ(fileName));
     }
 
     // *****************************************************************************************************************************
@@ -1129,6 +1173,226 @@ testRun(void)
             storageGetP(storageNewReadP(storageTest, STRDEF(TEST_PATH "/test.txt"), .offset = 4, .limit = VARUINT64(4))), "get");
         TEST_RESULT_UINT(bufSize(buffer), 4, "check size");
         TEST_RESULT_BOOL(memcmp(bufPtrConst(buffer), "FILE", bufSize(buffer)) == 0, true, "check content");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read offset bytes and drop from page cache");
+
+        const Storage *const storagePageCacheDrop = storagePosixNewP(TEST_PATH_STR, .pageCacheDrop = true);
+
+        TEST_ASSIGN(buffer, storageGetP(storageNewReadP(storagePageCacheDrop, STRDEF("test.txt"), .offset = 4)), "get");
+        TEST_RESULT_UINT(bufSize(buffer), 5, "check size");
+        TEST_RESULT_BOOL(memcmp(bufPtrConst(buffer), "FILE\n", bufSize(buffer)) == 0, true, "check content");
+
+        HRN_STORAGE_PUT_EMPTY(storageTest, TEST_PATH "/empty.txt");
+
+        TEST_ASSIGN(buffer, storageGetP(storageNewReadP(storagePageCacheDrop, STRDEF("empty.txt"))), "get empty");
+        TEST_RESULT_UINT(bufSize(buffer), 0, "check size");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("drop only pages that were not resident before read");
+
+        const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        Buffer *const pageBuffer = bufNew(pageSize * 4 + 1);
+
+        memset(bufPtr(pageBuffer), 'X', bufSize(pageBuffer));
+        bufUsedSet(pageBuffer, bufSize(pageBuffer));
+
+        HRN_STORAGE_PUT(storageTest, TEST_PATH "/page.bin", pageBuffer);
+
+        StorageRead *read;
+        StorageReadPosix *driver;
+
+        TEST_ASSIGN(buffer, storageGetP(storageNewReadP(storagePageCacheDrop, STRDEF("page.bin"))), "get");
+        TEST_RESULT_UINT(bufSize(buffer), bufSize(pageBuffer), "check size");
+
+        TEST_ASSIGN(read, storageNewReadP(storagePageCacheDrop, STRDEF("page.bin")), "new read");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        driver = ioReadDriver(storageReadIo(read));
+        TEST_RESULT_UINT(driver->residentTotal, 5, "check resident total");
+        TEST_RESULT_BOOL(
+            memcmp(driver->residentList, (const unsigned char []){1, 1, 1, 1, 1}, driver->residentTotal) == 0, true,
+            "resident pages were not dropped");
+
+        memcpy(driver->residentList, (const unsigned char []){0, 1, 0, 0, 1}, driver->residentTotal);
+
+        Buffer *const readBuffer = bufNew(pageSize * 2);
+        ioBufferSizeSet(pageSize * 2);
+
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 2, "check resident drop");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 4, "check resident drop");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), 1, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 5, "check resident drop");
+        TEST_RESULT_BOOL(ioReadEof(storageReadIo(read)), true, "eof");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("check residency a window at a time");
+
+        TEST_ASSIGN(read, storageNewReadP(storagePageCacheDrop, STRDEF("page.bin")), "new read");
+        driver = ioReadDriver(storageReadIo(read));
+        driver->residentWindow = 2;
+
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        TEST_RESULT_UINT(driver->residentTotal, 4, "check resident total");
+
+        memcpy(driver->residentList, (const unsigned char []){0, 1, 0, 1}, driver->residentTotal);
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read");
+        TEST_RESULT_UINT(driver->residentBegin, pageSize * 2, "check resident begin");
+        TEST_RESULT_UINT(driver->residentTotal, 3, "check resident total");
+        TEST_RESULT_UINT(driver->residentDrop, 0, "check resident drop");
+        TEST_RESULT_BOOL(
+            memcmp(driver->residentList, (const unsigned char []){0, 1}, 2) == 0, true, "second window moved to first");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read");
+        TEST_RESULT_UINT(driver->residentBegin, pageSize * 2, "check resident begin");
+        TEST_RESULT_UINT(driver->residentDrop, 2, "check resident drop");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), 1, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 3, "check resident drop");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        TEST_ASSIGN(read, storageNewReadP(storagePageCacheDrop, STRDEF("page.bin")), "new read");
+        driver = ioReadDriver(storageReadIo(read));
+        driver->residentWindow = 1;
+
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        TEST_RESULT_UINT(driver->residentTotal, 2, "check resident total");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read more than a window");
+        TEST_RESULT_UINT(driver->residentBegin, pageSize * 2, "check resident begin");
+        TEST_RESULT_UINT(driver->residentTotal, 2, "check resident total");
+        TEST_RESULT_UINT(driver->residentDrop, 0, "check resident drop");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read to last window");
+        TEST_RESULT_UINT(driver->residentBegin, pageSize * 4, "check resident begin");
+        TEST_RESULT_UINT(driver->residentTotal, 1, "check resident total");
+        TEST_RESULT_UINT(driver->residentDrop, 0, "check resident drop");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), 1, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 1, "check resident drop");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("drop pages with limit");
+
+        TEST_ASSIGN(
+            read, storageNewReadP(storagePageCacheDrop, STRDEF("page.bin"), .offset = pageSize / 2, .limit = VARUINT64(pageSize)),
+            "new read");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        driver = ioReadDriver(storageReadIo(read));
+        TEST_RESULT_UINT(driver->residentTotal, 2, "check resident total");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 2, "check resident drop");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        TEST_ASSIGN(read, storageNewReadP(storagePageCacheDrop, STRDEF("page.bin"), .limit = VARUINT64(pageSize * 2)), "new read");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        driver = ioReadDriver(storageReadIo(read));
+        TEST_RESULT_UINT(driver->residentTotal, 2, "check resident total");
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 2, "check resident drop");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        TEST_ASSIGN(
+            read, storageNewReadP(storagePageCacheDrop, STRDEF("page.bin"), .limit = VARUINT64(pageSize * 8)), "new read");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        TEST_RESULT_UINT(((StorageReadPosix *)ioReadDriver(storageReadIo(read)))->residentTotal, 5, "check resident total");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("drop pages when file grows after open");
+
+        HRN_STORAGE_PUT(storageTest, TEST_PATH "/page.bin", BUF(bufPtr(pageBuffer), pageSize));
+
+        TEST_ASSIGN(read, storageNewReadP(storagePageCacheDrop, STRDEF("page.bin")), "new read");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        driver = ioReadDriver(storageReadIo(read));
+        TEST_RESULT_UINT(driver->residentTotal, 1, "check resident total");
+
+        const int fd = open(TEST_PATH "/page.bin", O_WRONLY | O_APPEND);
+        TEST_RESULT_INT(write(fd, bufPtr(pageBuffer), pageSize), (int)pageSize, "grow file");
+        close(fd);
+
+        bufUsedZero(readBuffer);
+        TEST_RESULT_UINT(ioRead(storageReadIo(read), readBuffer), pageSize * 2, "read");
+        TEST_RESULT_UINT(driver->residentDrop, 1, "check resident drop");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        ioBufferSizeSet(2);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read offset/limited bytes with read ahead");
+
+        const Storage *const storageReadAhead = storagePosixNewP(TEST_PATH_STR, .readAhead = 2);
+
+        TEST_ASSIGN(
+            buffer, storageGetP(storageNewReadP(storageReadAhead, STRDEF("test.txt"), .offset = 1, .limit = VARUINT64(6))), "get");
+        TEST_RESULT_UINT(bufSize(buffer), 6, "check size");
+        TEST_RESULT_BOOL(memcmp(bufPtrConst(buffer), "ESTFIL", bufSize(buffer)) == 0, true, "check content");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read ahead advised across multiple buffers");
+
+        Buffer *const readAheadBuffer = bufNew(2);
+
+        TEST_ASSIGN(read, storageNewReadP(storageReadAhead, STRDEF("test.txt")), "new read");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        driver = ioReadDriver(storageReadIo(read));
+
+        TEST_RESULT_UINT(storageReadPosix(driver, readAheadBuffer, false), 2, "read");
+        TEST_RESULT_UINT(driver->readAheadCurrent, 6, "read ahead two buffers");
+
+        bufUsedZero(readAheadBuffer);
+        TEST_RESULT_UINT(storageReadPosix(driver, readAheadBuffer, false), 2, "read");
+        TEST_RESULT_UINT(driver->readAheadCurrent, 8, "read ahead one more buffer");
+
+        bufUsedZero(readAheadBuffer);
+        TEST_RESULT_UINT(storageReadPosix(driver, readAheadBuffer, false), 2, "read");
+        TEST_RESULT_UINT(driver->readAheadCurrent, 10, "read ahead one more buffer");
+
+        bufUsedZero(readAheadBuffer);
+        TEST_RESULT_UINT(storageReadPosix(driver, readAheadBuffer, false), 2, "read");
+        TEST_RESULT_UINT(driver->readAheadCurrent, 12, "read ahead one more buffer");
+
+        bufUsedZero(readAheadBuffer);
+        TEST_RESULT_UINT(storageReadPosix(driver, readAheadBuffer, false), 1, "read");
+        TEST_RESULT_UINT(driver->readAheadCurrent, 14, "read ahead one more buffer");
+        TEST_RESULT_BOOL(driver->eof, true, "eof");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read ahead limited");
+
+        TEST_ASSIGN(read, storageNewReadP(storageReadAhead, STRDEF("test.txt"), .offset = 1, .limit = VARUINT64(6)), "new read");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open");
+        driver = ioReadDriver(storageReadIo(read));
+
+        bufUsedZero(readAheadBuffer);
+        TEST_RESULT_UINT(storageReadPosix(driver, readAheadBuffer, false), 2, "read");
+        TEST_RESULT_UINT(driver->readAheadCurrent, 6, "read ahead up to limit");
+
+        bufUsedZero(readAheadBuffer);
+        TEST_RESULT_UINT(storageReadPosix(driver, readAheadBuffer, false), 2, "read");
+        TEST_RESULT_UINT(driver->readAheadCurrent, 6, "no read ahead past limit");
+        TEST_RESULT_BOOL(memcmp(bufPtrConst(readAheadBuffer), "TF", 2) == 0, true, "check content");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close");
     }
 
     // *****************************************************************************************************************************
@@ -1339,6 +1603,15 @@ testRun(void)
         TEST_ERROR_FMT(
             storageWritePosix(ioWriteDriver(storageWriteIo(file)), buffer), FileWriteError,
             "unable to write '%s.pgbackrest.tmp': [9] Bad file descriptor", strZ(fileName));
+
+        ((StorageWritePosix *)ioWriteDriver(storageWriteIo(file)))->sparse = true;
+
+        TEST_ERROR_FMT(
+            storageWritePosix(ioWriteDriver(storageWriteIo(file)), buffer), FileWriteError,
+            "unable to write '%s.pgbackrest.tmp': [9] Bad file descriptor", strZ(fileName));
+
+        ((StorageWritePosix *)ioWriteDriver(storageWriteIo(file)))->sparse = false;
+
         TEST_ERROR_FMT(
             storageWritePosixClose(ioWriteDriver(storageWriteIo(file))), FileSyncError,
             STORAGE_ERROR_WRITE_SYNC ": [9] Bad file descriptor", strZ(fileTmp));
@@ -1435,6 +1708,144 @@ testRun(void)
         TEST_STORAGE_GET(storageTest, "no-truncate", "ABC");
         TEST_RESULT_UINT(storageInfoP(storageTest, STRDEF("no-truncate")).mode, 0600, "check mode");
         TEST_RESULT_INT(storageInfoP(storageTest, STRDEF("no-truncate")).timeModified, 77777, "check time");
+
+#ifdef HAVE_IO_URING
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write queue");
+
+        TEST_RESULT_PTR(storageWritePosixQueueNew(1, UINT32_MAX), NULL, "required features are missing");
+
+        const Storage *const storageQueue = storagePosixNewP(TEST_PATH_STR, .write = true, .writeQueue = 2);
+
+        TEST_ASSIGN(file, storageNewWriteP(storageQueue, STRDEF("queue")), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+
+        StorageWritePosix *driver = ioWriteDriver(storageWriteIo(file));
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("AAA")), "write");
+        TEST_RESULT_PTR(driver->queue, NULL, "queue not created for first write");
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("BBB")), "write");
+        TEST_RESULT_BOOL(driver->queue != NULL, true, "queue created");
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("CCC")), "write");
+        TEST_RESULT_UINT(driver->queue->slotFreeTotal, 0, "all slots in use");
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("DDD")), "write");
+        TEST_RESULT_UINT(driver->queue->slotFreeTotal, 1, "slots freed");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close file");
+        TEST_RESULT_PTR(driver->queue, NULL, "queue freed");
+
+        TEST_STORAGE_GET(storageTest, "queue", "AAABBBCCCDDD", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write queue without file sync");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageQueue, STRDEF("queue"), .noSyncFile = true), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+
+        driver = ioWriteDriver(storageWriteIo(file));
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("AAA")), "write");
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("BBB")), "write");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close file");
+
+        TEST_STORAGE_GET(storageTest, "queue", "AAABBB", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write queue falls back to synchronous writes when io_uring is not available");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageQueue, STRDEF("queue")), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+
+        driver = ioWriteDriver(storageWriteIo(file));
+        driver->writeQueue = 100000;
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("AAA")), "write");
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("BBB")), "write");
+        TEST_RESULT_PTR(driver->queue, NULL, "queue not created");
+        TEST_RESULT_UINT(driver->writeQueue, 0, "write queue disabled");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close file");
+
+        TEST_STORAGE_GET(storageTest, "queue", "AAABBB", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write queue finishes failed write synchronously");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageQueue, STRDEF("queue"), .noAtomic = true), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+
+        driver = ioWriteDriver(storageWriteIo(file));
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("AAA")), "write");
+
+        // Switch to a read-only file descriptor so the queued write fails and then switch back so the synchronous write succeeds
+        const int fdRetry = driver->fd;
+        driver->fd = open(TEST_PATH "/queue", O_RDONLY);
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("BBB")), "write");
+        TEST_RESULT_VOID(storageWritePosixQueueEnter(driver->queue, 0, 1, driver->nameTmp), "wait for write");
+
+        close(driver->fd);
+        driver->fd = fdRetry;
+
+        TEST_RESULT_VOID(storageWritePosixQueueComplete(driver->queue, driver->fd, driver->nameTmp), "complete write");
+        TEST_RESULT_UINT(driver->queue->slotFreeTotal, 2, "slots freed");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close file");
+
+        TEST_STORAGE_GET(storageTest, "queue", "AAABBB");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write queue error");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageQueue, STRDEF("queue"), .noAtomic = true), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+
+        driver = ioWriteDriver(storageWriteIo(file));
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("AAA")), "write");
+
+        // Switch to a read-only file descriptor so the queued write fails
+        const int fd = driver->fd;
+        driver->fd = open(TEST_PATH "/queue", O_RDONLY);
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("BBB")), "write");
+        TEST_ERROR(
+            ioWriteClose(storageWriteIo(file)), FileWriteError, "unable to write '" TEST_PATH "/queue': [9] Bad file descriptor");
+
+        close(driver->fd);
+        driver->fd = fd;
+
+        TEST_RESULT_VOID(storageWriteFree(file), "free file with sync still in flight");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write queue sync error");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageQueue, STRDEF("queue"), .noAtomic = true), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open file");
+
+        driver = ioWriteDriver(storageWriteIo(file));
+
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("AAA")), "write");
+        TEST_RESULT_VOID(storageWritePosix(driver, BUFSTRDEF("BBB")), "write");
+        TEST_RESULT_VOID(storageWritePosixQueueEnter(driver->queue, 0, 1, driver->nameTmp), "wait for write");
+        TEST_RESULT_VOID(storageWritePosixQueueComplete(driver->queue, driver->fd, driver->nameTmp), "complete write");
+
+        // Switch to a pipe so the queued sync fails
+        const int fdSync = driver->fd;
+        int pipeFd[2];
+        TEST_RESULT_INT(pipe(pipeFd), 0, "create pipe");
+
+        driver->fd = pipeFd[0];
+
+        TEST_ERROR_FMT(
+            ioWriteClose(storageWriteIo(file)), FileSyncError, STORAGE_ERROR_WRITE_SYNC ": [22] Invalid argument",
+            TEST_PATH "/queue");
+
+        driver->fd = fdSync;
+        close(pipeFd[0]);
+        close(pipeFd[1]);
+
+        TEST_RESULT_VOID(storageWriteFree(file), "free file");
+        TEST_STORAGE_GET(storageTest, "queue", "AAABBB", .remove = true);
+#endif // HAVE_IO_URING
     }
 
     // *****************************************************************************************************************************
@@ -1622,6 +2033,41 @@ testRun(void)
 
         TEST_RESULT_STR_Z(storage->path, TEST_PATH "/db", "check pg write storage path");
         TEST_RESULT_BOOL(storage->write, true, "check pg write storage write");
+        TEST_RESULT_BOOL(((StoragePosix *)storageDriver(storage))->pageCacheDrop, false, "check pg storage page cache drop");
+        TEST_RESULT_UINT(((StoragePosix *)storageDriver(storage))->readAhead, 0, "check pg storage read ahead");
+        TEST_RESULT_UINT(((StoragePosix *)storageDriver(storage))->writeQueue, 0, "check pg storage write queue");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("storagePg() and storageRepo() - page cache drop and read ahead");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/db");
+        hrnCfgArgRawBool(argList, cfgOptPageCacheDrop, true);
+        hrnCfgArgRawZ(argList, cfgOptReadAhead, "4");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_ASSIGN(storage, storagePgGet(0, false), "new pg storage");
+        TEST_RESULT_BOOL(((StoragePosix *)storageDriver(storage))->pageCacheDrop, true, "check pg storage page cache drop");
+        TEST_RESULT_UINT(((StoragePosix *)storageDriver(storage))->readAhead, 4, "check pg storage read ahead");
+
+        TEST_ASSIGN(storage, storageRepoGet(0, false), "new repo storage");
+        TEST_RESULT_UINT(((StoragePosix *)storageDriver(storage))->readAhead, 4, "check repo storage read ahead");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("storagePgWrite() - write queue");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/db");
+        hrnCfgArgRawZ(argList, cfgOptWriteQueue, "8");
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        TEST_ASSIGN(storage, storagePgGet(0, true), "new pg write storage");
+        TEST_RESULT_UINT(((StoragePosix *)storageDriver(storage))->writeQueue, 8, "check pg storage write queue");
 
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("storageSpool - helper fails because stanza is required");
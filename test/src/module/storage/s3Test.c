@@ -28,6 +28,7 @@ typedef struct TestRequestParam
     const char *accessKey;
     const char *securityToken;
     const char *range;
+    const char *ifMatch;
     const char *kms;
     const char *sseC;
     const char *ttl;
@@ -73,6 +74,9 @@ testRequest(IoWrite *write, Storage *s3, const char *verb, const char *path, Tes
 
         strCatZ(request, "host;");
 
+        if (param.ifMatch != NULL)
+            strCatZ(request, "if-match;");
+
         if (param.range != NULL)
             strCatZ(request, "range;");
 
@@ -122,6 +126,10 @@ testRequest(IoWrite *write, Storage *s3, const char *verb, const char *path, Tes
     else
         strCatFmt(request, "host:%s\r\n", strZ(hrnServerHost()));
 
+    // Add if-match
+    if (param.ifMatch != NULL)
+        strCatFmt(request, "if-match:%s\r\n", param.ifMatch);
+
     // Add range
     if (param.range != NULL)
         strCatFmt(request, "range:bytes=%s\r\n", param.range);
@@ -457,6 +465,9 @@ testRun(void)
                 TEST_RESULT_STR(s3->path, path, "check path");
                 TEST_RESULT_BOOL(storageFeature(s3, storageFeaturePath), false, "check path feature");
                 TEST_RESULT_UINT(driver->partSize, 5 * 1024 * 1024, "check part size");
+                TEST_RESULT_UINT(driver->partMax, 1, "check part max");
+                TEST_RESULT_UINT(driver->rangeSize, 16 * 1024 * 1024, "check range size");
+                TEST_RESULT_UINT(driver->rangeMax, 1, "check range max");
 
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("coverage for noop functions");
@@ -500,6 +511,134 @@ testRun(void)
 
                 TEST_RESULT_STR_Z(strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file0.txt")))), "", "get zero-length file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file with offset and limit in ranges");
+
+                driver->rangeSize = 4;
+                driver->rangeMax = 2;
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "1-4");
+                testResponseP(service, .code = 206, .content = "1234");
+
+                // The second range is requested on a new connection while the first range is being read
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "5-8");
+
+                // The third range is requested on the first connection once the first range has been read
+                hrnServerScriptSession(service, 0);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "9-10");
+
+                hrnServerScriptSession(service, 1);
+                testResponseP(service, .code = 206, .content = "5678");
+
+                hrnServerScriptSession(service, 0);
+                testResponseP(service, .code = 206, .content = "9A");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(10)))),
+                    "123456789A", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file in ranges when size is not known");
+
+                // The file is requested on the connection that was returned first
+                hrnServerScriptSession(service, 1);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt");
+                testResponseP(service, .content = "0123456789");
+
+                hrnServerScriptSession(service, 0);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "4-7");
+
+                // The first response is small enough to be read completely so the connection is reused for the last range
+                hrnServerScriptSession(service, 1);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "8-9");
+
+                hrnServerScriptSession(service, 0);
+                testResponseP(service, .code = 206, .content = "4567");
+
+                hrnServerScriptSession(service, 1);
+                testResponseP(service, .code = 206, .content = "89");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_RESULT_STR_Z(strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt")))), "0123456789", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file smaller than a range");
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "0-1");
+                testResponseP(service, .code = 206, .content = "01");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .limit = VARUINT64(2)))), "01", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file in ranges pinned to the etag of the first response");
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "0-3");
+                testResponseP(service, .code = 206, .header = "etag:\"E1\"", .content = "0123");
+
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "4-5", .ifMatch = "\"E1\"");
+                testResponseP(service, .code = 206, .content = "45");
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .limit = VARUINT64(6)))), "012345", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error when file changes between ranges");
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "0-3");
+                testResponseP(service, .code = 206, .header = "etag:\"E1\"", .content = "0123");
+
+                hrnServerScriptSession(service, 1);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "4-5", .ifMatch = "\"E1\"");
+                testResponseP(service, .code = 412, .content = "");
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_ERROR(
+                    storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .limit = VARUINT64(6))), FileReadError,
+                    "unable to read file '/file.txt' because it changed during read");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error on range request");
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "0-3");
+                testResponseP(service, .code = 206, .content = "0123");
+
+                hrnServerScriptSession(service, 1);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "4-5");
+                testResponseP(service, .code = 403, .header = "connection:close", .content = "");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptSession(service, 0);
+
+                TEST_ERROR(
+                    storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .limit = VARUINT64(6))), ProtocolError,
+                    "HTTP request failed with 403:\n"
+                    "*** Path/Query ***:\n"
+                    "GET /file.txt\n"
+                    "*** Request Headers ***:\n"
+                    "authorization: <redacted>\n"
+                    "content-length: 0\n"
+                    "host: bucket." S3_TEST_HOST "\n"
+                    "range: bytes=4-5\n"
+                    "x-amz-content-sha256: e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\n"
+                    "x-amz-date: <redacted>\n"
+                    "x-amz-security-token: <redacted>\n"
+                    "*** Response Headers ***:\n"
+                    "connection: close\n"
+                    "content-length: 0");
+
+                driver->rangeSize = 16 * 1024 * 1024;
+                driver->rangeMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("switch to temp credentials");
 
@@ -934,6 +1073,74 @@ testRun(void)
 
                 TEST_RESULT_BOOL(storageInfoP(s3, NULL, .ignoreMissing = true).exists, false, "info for /");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("write file in chunks with concurrent part uploads");
+
+                driver->partMax = 2;
+
+                testRequestP(service, s3, HTTP_VERB_POST, "/file.txt?uploads=", .kms = "kmskey1", .sseC = "rA1P");
+                testResponseP(
+                    service,
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<InitiateMultipartUploadResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+                        "<Bucket>bucket</Bucket>"
+                        "<Key>file.txt</Key>"
+                        "<UploadId>CC01</UploadId>"
+                        "</InitiateMultipartUploadResult>");
+
+                testRequestP(
+                    service, s3, HTTP_VERB_PUT, "/file.txt?partNumber=1&uploadId=CC01", .content = "1234567890123456",
+                    .sseC = "rA1P");
+
+                // The second part is sent on a new connection while the first part is still in flight
+                hrnServerScriptSession(service, 1);
+                hrnServerScriptAccept(service);
+
+                testRequestP(
+                    service, s3, HTTP_VERB_PUT, "/file.txt?partNumber=2&uploadId=CC01", .content = "7890123456789012",
+                    .sseC = "rA1P");
+
+                // The third part waits for the first part to complete and then reuses its connection
+                hrnServerScriptSession(service, 0);
+                testResponseP(service, .header = "etag:CC011");
+
+                testRequestP(
+                    service, s3, HTTP_VERB_PUT, "/file.txt?partNumber=3&uploadId=CC01", .content = "3456789012345678",
+                    .sseC = "rA1P");
+
+                // Responses are processed in the order the parts were sent
+                hrnServerScriptSession(service, 1);
+                testResponseP(service, .header = "etag:CC012");
+
+                hrnServerScriptSession(service, 0);
+                testResponseP(service, .header = "etag:CC013");
+
+                hrnServerScriptSession(service, 1);
+
+                testRequestP(
+                    service, s3, HTTP_VERB_POST, "/file.txt?uploadId=CC01",
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<CompleteMultipartUpload>"
+                        "<Part><PartNumber>1</PartNumber><ETag>CC011</ETag></Part>"
+                        "<Part><PartNumber>2</PartNumber><ETag>CC012</ETag></Part>"
+                        "<Part><PartNumber>3</PartNumber><ETag>CC013</ETag></Part>"
+                        "</CompleteMultipartUpload>\n");
+                testResponseP(
+                    service,
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<CompleteMultipartUploadResult><ETag>XXX</ETag></CompleteMultipartUploadResult>");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptSession(service, 0);
+
+                TEST_ASSIGN(write, storageNewWriteP(s3, STRDEF("file.txt")), "new write");
+                TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("123456789012345678901234567890123456789012345678")), "write");
+
+                driver->partMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("switch to service credentials");
 